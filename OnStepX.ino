@@ -52,11 +52,34 @@ NVS nv;
 #include "src/Validate.h"
 #include "src/lib/sense/Sense.h"
 #include "src/lib/tasks/OnTask.h"
+#include "src/lib/memory/Memory.h"
+#include "src/lib/boot/BootTime.h"
+#include "src/lib/watchdog/Watchdog.h"
 
 #include "src/telescope/Telescope.h"
 extern Telescope telescope;
 
 #include "src/plugins/Plugins.config.h"
+#include "src/plugins/PluginLoad.h"
+
+// tasks a plugin adds while it starts (and any they add later) are accounted to it
+#ifndef PLUGIN_TASK_BUDGET
+  #define PLUGIN_TASK_BUDGET 2000
+#endif
+#if PLUGIN_TASK_BUDGET != OFF && (PLUGIN_TASK_BUDGET < 100 || PLUGIN_TASK_BUDGET > 100000)
+  #error "Configuration (Plugins.config.h): Setting PLUGIN_TASK_BUDGET unknown, use OFF or 100 to 100000 (us)"
+#endif
+#ifdef TASKS_BUDGET_ENABLE
+  #if PLUGIN_TASK_BUDGET == OFF
+    #define PLUGIN_LOAD_BEGIN(n, plugin) pluginLoad.begin(n, STR(plugin), 0)
+  #else
+    #define PLUGIN_LOAD_BEGIN(n, plugin) pluginLoad.begin(n, STR(plugin), PLUGIN_TASK_BUDGET)
+  #endif
+  #define PLUGIN_LOAD_END() pluginLoad.end()
+#else
+  #define PLUGIN_LOAD_BEGIN(n, plugin)
+  #define PLUGIN_LOAD_END()
+#endif
 
 #if DEBUG == PROFILER
   extern void profiler();
@@ -71,10 +94,14 @@ void sensesPoll() {
 }
 
 void setup() {
+  // mark the unused stack before anything runs so the high-water can be found later
+  memory.init();
+
   #if DEBUG != OFF
     SERIAL_DEBUG.begin(SERIAL_DEBUG_BAUD);
     delay(2000);
   #endif
+  bootTime.mark("Startup");
 
   // say hello
   VLF("");
@@ -90,6 +117,7 @@ void setup() {
     nv.initError = true;
   }
   delay(2000);
+  bootTime.mark("HAL");
 
   // start system service task
   VF("MSG: Setup, start system service task (rate 10ms priority 7)... ");
@@ -108,41 +136,85 @@ void setup() {
 
   // start command channel tasks
   commandChannelInit();
+  bootTime.mark("Commands");
 
   tasks.yield(2000);
+  bootTime.mark("Settle");
 
   // start any plugins
   #if PLUGIN1 != OFF
+    PLUGIN_LOAD_BEGIN(1, PLUGIN1);
     PLUGIN1.init();
+    PLUGIN_LOAD_END();
   #endif
   #if PLUGIN2 != OFF
+    PLUGIN_LOAD_BEGIN(2, PLUGIN2);
     PLUGIN2.init();
+    PLUGIN_LOAD_END();
   #endif
   #if PLUGIN3 != OFF
+    PLUGIN_LOAD_BEGIN(3, PLUGIN3);
     PLUGIN3.init();
+    PLUGIN_LOAD_END();
   #endif
   #if PLUGIN4 != OFF
+    PLUGIN_LOAD_BEGIN(4, PLUGIN4);
     PLUGIN4.init();
+    PLUGIN_LOAD_END();
   #endif
   #if PLUGIN5 != OFF
+    PLUGIN_LOAD_BEGIN(5, PLUGIN5);
     PLUGIN5.init();
+    PLUGIN_LOAD_END();
   #endif
   #if PLUGIN6 != OFF
+    PLUGIN_LOAD_BEGIN(6, PLUGIN6);
     PLUGIN6.init();
+    PLUGIN_LOAD_END();
   #endif
   #if PLUGIN7 != OFF
+    PLUGIN_LOAD_BEGIN(7, PLUGIN7);
     PLUGIN7.init();
+    PLUGIN_LOAD_END();
   #endif
   #if PLUGIN8 != OFF
+    PLUGIN_LOAD_BEGIN(8, PLUGIN8);
     PLUGIN8.init();
+    PLUGIN_LOAD_END();
+  #endif
+
+  bootTime.mark("Plugins");
+  bootTime.report();
+
+  // the axes checked their own hot path placement as they started
+  IRAM_HOT_CHECK("Task::poll", &Task::poll);
+  IRAM_HOT_CHECK("Tasks::yield", static_cast<void (Tasks::*)()>(&Tasks::yield));
+  IRAM_HOT_CHECK("Tasks::setPeriodSubMicros", &Tasks::setPeriodSubMicros);
+  IRAM_HOT_CHECK("Tasks::setPeriodRatioSubMicros", &Tasks::setPeriodRatioSubMicros);
+  IRAM_HOT_CHECK("Tasks::micros64", &Tasks::micros64);
+
+  VF("MSG: Setup, RAM static "); V(memory.getStaticBytes()); VF(" heap used "); V(memory.getHeapUsed());
+  VF(" free "); V(memory.getHeapFree()); VF(" largest free "); VL(memory.getHeapLargestFree());
+
+  // from here on debug messages are buffered and printed in the background
+  #if DEBUG != OFF && DEBUG != PROFILER && DEBUG_DEFERRED != OFF
+    debugLogStart();
   #endif
 
   // start task manager debug events
   #if DEBUG == PROFILER
     tasks.add(142, 0, true, 7, profiler, "Profilr");
   #endif
+
+  // from here on a stall of loop() or of any task with a heartbeat resets the MCU
+  #ifdef WATCHDOG_PRESENT
+    watchdog.enable(WATCHDOG_SECONDS);
+  #endif
 }
 
 void loop() {
   tasks.yield();
+  #ifdef WATCHDOG_PRESENT
+    watchdog.reset();
+  #endif
 }
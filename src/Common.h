@@ -21,6 +21,35 @@
   #define NV_PEC_BUFFER_BASE      (NV_LAST+1) // bytes: ?   , ? + (PEC_BUFFER_SIZE_LIMIT - 1)
 #endif
 
+#if AXIS1_PEC == ON
+  #define NV_HORIZON_MASK_BASE    (NV_PEC_BUFFER_BASE + PEC_BUFFER_SIZE_LIMIT)
+#else
+  #define NV_HORIZON_MASK_BASE    NV_PEC_BUFFER_BASE
+#endif
+#if HORIZON_MASK != OFF
+  #define NV_HORIZON_MASK_SIZE    (360/HORIZON_MASK) // bytes: 360 or 180, one per azimuth bin
+#else
+  #define NV_HORIZON_MASK_SIZE    0
+#endif
+#define NV_FOCUSER_TCF_BASE     (NV_HORIZON_MASK_BASE + NV_HORIZON_MASK_SIZE) // bytes: 50*6, 300 when FOCUSER_TCF_TABLE is ON
+#if FOCUSER_TCF_TABLE == ON
+  #define NV_FOCUSER_TCF_SIZE     300
+#else
+  #define NV_FOCUSER_TCF_SIZE     0
+#endif
+#define NV_ALIGN_SLOTS_BASE     (NV_FOCUSER_TCF_BASE + NV_FOCUSER_TCF_SIZE) // bytes: 1 + 40*n, selected slot then name and model for each
+#if ALIGN_MODEL_SLOTS != OFF
+  #define NV_ALIGN_SLOTS_SIZE     (1 + 40*ALIGN_MODEL_SLOTS)
+#else
+  #define NV_ALIGN_SLOTS_SIZE     0
+#endif
+#define NV_MOUNT_JOURNAL_BASE   (NV_ALIGN_SLOTS_BASE + NV_ALIGN_SLOTS_SIZE) // bytes: 27*8, 216 when MOUNT_JOURNAL is on
+#if MOUNT_JOURNAL != OFF
+  #define NV_MOUNT_JOURNAL_SIZE   216
+#else
+  #define NV_MOUNT_JOURNAL_SIZE   0
+#endif
+
 #include "HAL/HAL.h"
 #include "lib/Macros.h"
 #include "pinmaps/Models.h"
@@ -19,6 +19,36 @@
 #ifndef DEBUG_ECHO_COMMANDS
 #define DEBUG_ECHO_COMMANDS           OFF
 #endif
+#ifndef DEBUG_DEFERRED
+#define DEBUG_DEFERRED                OFF                         // OFF or n records (power of 2) logged to RAM and printed by a low priority task
+#endif
+#ifndef DEBUG_PROBE1_PIN
+#define DEBUG_PROBE1_PIN              OFF                         // OFF or n, pin driven HIGH while task DEBUG_PROBE1_TASK runs
+#endif
+#ifndef DEBUG_PROBE1_TASK
+#define DEBUG_PROBE1_TASK             "Motor_1"                   // task name, the step ISR for Axis n is "Motor_n"
+#endif
+#ifndef DEBUG_PROBE2_PIN
+#define DEBUG_PROBE2_PIN              OFF                         // OFF or n, pin driven HIGH while task DEBUG_PROBE2_TASK runs
+#endif
+#ifndef DEBUG_PROBE2_TASK
+#define DEBUG_PROBE2_TASK             "MntTrk"                    // task name, mount tracking
+#endif
+#ifndef DEBUG_PROBE3_PIN
+#define DEBUG_PROBE3_PIN              OFF                         // OFF or n, pin driven HIGH while task DEBUG_PROBE3_TASK runs
+#endif
+#ifndef DEBUG_PROBE3_TASK
+#define DEBUG_PROBE3_TASK             "MtGuide"                   // task name, guiding (gotos are "MntGoto")
+#endif
+#ifndef DEBUG_PROBE4_PIN
+#define DEBUG_PROBE4_PIN              OFF                         // OFF or n, pin driven HIGH while task DEBUG_PROBE4_TASK runs
+#endif
+#ifndef DEBUG_PROBE4_TASK
+#define DEBUG_PROBE4_TASK             "CmdA"                      // task name, command channels are "CmdA" to "CmdD"
+#endif
+#if DEBUG_PROBE1_PIN != OFF || DEBUG_PROBE2_PIN != OFF || DEBUG_PROBE3_PIN != OFF || DEBUG_PROBE4_PIN != OFF
+  #define TASKS_PROBE_ENABLE
+#endif
 #ifndef SERIAL_DEBUG
 #define SERIAL_DEBUG                  Serial
 #endif
@@ -26,6 +56,22 @@
 #define SERIAL_DEBUG_BAUD             9600
 #endif
 
+// hot path placement
+#ifndef HOT_PATH_IRAM
+#define HOT_PATH_IRAM                 OFF                         // ON pins the axis monitors, step timing, and scheduler in IRAM (ESP32)
+#endif
+
+// watchdog
+#ifndef WATCHDOG
+#define WATCHDOG                      OFF                         // ON to reset the MCU if loop() or a critical task stalls
+#endif
+#ifndef WATCHDOG_SECONDS
+#define WATCHDOG_SECONDS              8                           // n=2..30 seconds, time from a stall to the MCU reset
+#endif
+#ifndef WATCHDOG_HEARTBEAT_MS
+#define WATCHDOG_HEARTBEAT_MS         2000                        // n=100..10000 ms, an axis, limits, or goto task not run this long has starved
+#endif
+
 // serial ports
 #ifndef SERIAL_A_BAUD_DEFAULT
 #define SERIAL_A_BAUD_DEFAULT         9600
@@ -42,6 +88,15 @@
 #ifndef SERIAL_GPS_BAUD
 #define SERIAL_GPS_BAUD               OFF
 #endif
+#ifndef SERIAL_POLL_BUDGET
+#define SERIAL_POLL_BUDGET            500                         // in us, time a command channel may spend reading and answering per poll
+#endif
+#ifndef SERIAL_BACKLOG_PRIORITY
+#define SERIAL_BACKLOG_PRIORITY       OFF                         // n=0..4 task priority of a command channel while it has commands waiting
+#endif
+#ifndef SERIAL_EXPEDITE_PRIORITY
+#define SERIAL_EXPEDITE_PRIORITY      OFF                         // n=0..4 task priority of a command channel holding a guide, stop or sync command
+#endif
 
 // ESP32 virtual serial bluetooth command channel
 #ifndef SERIAL_BT_MODE
@@ -50,6 +105,12 @@
 #ifndef SERIAL_BT_NAME
 #define SERIAL_BT_NAME                "OnStep"                    // Bluetooth name of command channel
 #endif
+#ifndef SERIAL_BT_THROUGHPUT
+#define SERIAL_BT_THROUGHPUT          OFF                         // ON for bulk reads and one write of all replies per poll
+#endif
+#ifndef SERIAL_BT_STATUS_STREAM
+#define SERIAL_BT_STATUS_STREAM       OFF                         // n=100..60000 ms, subscribe the BT channel to status frames at startup (see :SXPS,n#)
+#endif
 
 // ESP32 virtual serial IP command channels
 #ifndef SERIAL_IP_MODE
@@ -58,6 +119,18 @@
 #ifndef SERIAL_SERVER
 #define SERIAL_SERVER                 BOTH                        // STANDARD (port 9999) or PERSISTENT (ports 9996 to 9998)
 #endif
+#ifndef SERIAL_WEBSOCKET
+#define SERIAL_WEBSOCKET              OFF                         // ON for a WebSocket command channel (with the status stream) for browser apps
+#endif
+#ifndef SERIAL_WEBSOCKET_PORT
+#define SERIAL_WEBSOCKET_PORT         81                          // WebSocket command channel port
+#endif
+#ifndef ALPACA
+#define ALPACA                        OFF                         // ON for the ASCOM Alpaca device API (Telescope, Focuser, Rotator) with discovery
+#endif
+#ifndef ALPACA_PORT
+#define ALPACA_PORT                   11111                       // ASCOM Alpaca device API port
+#endif
 
 // translate Config.h IP settings into low level library settings
 #if SERIAL_IP_MODE == ETHERNET_W5500
@@ -124,6 +197,16 @@
 #define TIME_IP_ADDR                  {129,6,15,28}               // for NTP if enabled we often use an address like
 #endif                                                            // time-a-g.nist.gov at 129,6,15,28 or 129,6,15,29, 129,6,15,30, etc.
 
+#ifndef TELEMETRY_RATE
+#define TELEMETRY_RATE                OFF                         // n=1..20 UDP mount telemetry packets per second (needs SERIAL_IP_MODE)
+#endif
+#ifndef TELEMETRY_IP_ADDR
+#define TELEMETRY_IP_ADDR             {255,255,255,255}           // telemetry destination, a unicast, broadcast, or multicast IP Address
+#endif
+#ifndef TELEMETRY_PORT
+#define TELEMETRY_PORT                9995                        // telemetry destination UDP port
+#endif
+
 // sensors
 #ifndef WEATHER
 #define WEATHER                       OFF
@@ -192,6 +275,9 @@
 #ifndef AXIS1_SYNC_THRESHOLD
 #define AXIS1_SYNC_THRESHOLD          OFF                         // sync threshold in counts (required for absolute encoders) or OFF
 #endif
+#ifndef AXIS1_ENCODER_ABSOLUTE
+#define AXIS1_ENCODER_ABSOLUTE        OFF                         // ON sets the step/dir axis position from its absolute encoder at boot
+#endif
 #ifndef AXIS1_SENSE_HOME
 #define AXIS1_SENSE_HOME              OFF                         // HIGH or LOW state when clockwise of home position, seen from front
 #endif
@@ -225,6 +311,9 @@
   #ifndef AXIS1_STEP_STATE
   #define AXIS1_STEP_STATE              HIGH                      // default signal transition state for a step
   #endif
+  #ifndef AXIS1_STEP_RMT
+  #define AXIS1_STEP_RMT                OFF                       // ON to send slewing step pulses from the ESP32 RMT peripheral
+  #endif
   #ifndef AXIS1_M2_ON_STATE
   #define AXIS1_M2_ON_STATE             HIGH                      // default ON state for M2
   #endif
@@ -255,6 +344,39 @@
   #ifndef AXIS1_DRIVER_STATUS
   #define AXIS1_DRIVER_STATUS           OFF                       // driver status reporting (ON for TMC SPI or HIGH/LOW for fault pin)
   #endif
+  #ifndef AXIS1_DRIVER_STALL
+  #define AXIS1_DRIVER_STALL            OFF                       // TMC StallGuard threshold (SGT or TMC2209 SGTHRS)
+  #endif
+  #ifndef AXIS1_DRIVER_DECAY_FAST
+  #define AXIS1_DRIVER_DECAY_FAST       OFF                       // OFF for DECAY_GOTO, TMC mode above FAST_RATE
+  #endif
+  #ifndef AXIS1_DRIVER_IFAST
+  #define AXIS1_DRIVER_IFAST            OFF                       // in mA, OFF for IGOTO, TMC current above FAST_RATE
+  #endif
+  #ifndef AXIS1_DRIVER_FAST_RATE
+  #define AXIS1_DRIVER_FAST_RATE        OFF                       // in steps/s, OFF disables the TMC high speed band
+  #endif
+  #ifndef AXIS1_DRIVER_ITRACK
+  #define AXIS1_DRIVER_ITRACK           OFF                       // in mA, OFF for IRUN, TMC current while tracking
+  #endif
+  #ifndef AXIS1_ENCODER
+  #define AXIS1_ENCODER                 OFF                       // axis encoder for tracking correction: AB, CW_CCW, PULSE_DIR, SERIAL_BRIDGE, or OFF
+  #endif
+  #ifndef AXIS1_ENCODER_ORIGIN
+  #define AXIS1_ENCODER_ORIGIN          0                         // +/- offset so encoder count is 0 at home (for absolute encoders)
+  #endif
+  #ifndef AXIS1_ENCODER_REVERSE
+  #define AXIS1_ENCODER_REVERSE         OFF                       // reverse count direction of encoder
+  #endif
+  #ifndef AXIS1_ENCODER_RATIO
+  #define AXIS1_ENCODER_RATIO           1.0                       // motor steps per axis encoder count
+  #endif
+  #ifndef AXIS1_ENCODER_TRIM_LIMIT
+  #define AXIS1_ENCODER_TRIM_LIMIT      5.0                       // tracking correction rate limit, in % of the tracking rate
+  #endif
+  #ifndef AXIS1_ENCODER_TRIM_TIME
+  #define AXIS1_ENCODER_TRIM_TIME       2.0                       // tracking correction time constant, in seconds
+  #endif
 #endif
 #if AXIS1_DRIVER_MODEL >= SERVO_DRIVER_FIRST && AXIS1_DRIVER_MODEL <= SERVO_DRIVER_LAST
   #define AXIS1_SERVO_PRESENT
@@ -278,9 +400,18 @@
   #ifndef AXIS1_SERVO_VELOCITY_FACTOR
   #define AXIS1_SERVO_VELOCITY_FACTOR   frequency*0               // converts frequency (counts per second) to velocity (in steps per second or DC motor PWM ADU range)
   #endif
+  #ifndef AXIS1_SERVO_ACCEL_FACTOR
+  #define AXIS1_SERVO_ACCEL_FACTOR      0.0                       // converts commanded acceleration (counts per second per second) to velocity feedforward, 0.0 disables
+  #endif
   #ifndef AXIS1_SERVO_ACCELERATION
   #define AXIS1_SERVO_ACCELERATION      20                        // acceleration, in %/s for DC, in steps/s/s for SERVO_TMC2209
   #endif
+  #ifndef AXIS1_SERVO_CURRENT_SCALE
+  #define AXIS1_SERVO_CURRENT_SCALE     3300                      // in mA, current sensed when the ADC reads full range
+  #endif
+  #ifndef AXIS1_SERVO_CURRENT_LIMIT
+  #define AXIS1_SERVO_CURRENT_LIMIT     OFF                       // in mA, DC motor power folds back above this current, OFF disables
+  #endif
   #ifndef AXIS1_SERVO_FEEDBACK
   #define AXIS1_SERVO_FEEDBACK          FB_PID                    // type of feedback: FB_PID
   #endif
@@ -316,6 +447,58 @@
   #ifndef AXIS1_ENCODER_REVERSE
   #define AXIS1_ENCODER_REVERSE         OFF                       // reverse count direction of encoder
   #endif
+
+  #ifndef AXIS1_MOTOR_ENCODER
+  #define AXIS1_MOTOR_ENCODER           OFF                       // motor shaft encoder for dual loop control: AB_ESP32, AB_STM32, AB_TEENSY4, or OFF
+  #endif
+  #ifndef AXIS1_MOTOR_ENCODER_A_PIN
+  #define AXIS1_MOTOR_ENCODER_A_PIN     OFF                       // motor shaft encoder A pin
+  #endif
+  #ifndef AXIS1_MOTOR_ENCODER_B_PIN
+  #define AXIS1_MOTOR_ENCODER_B_PIN     OFF                       // motor shaft encoder B pin
+  #endif
+  #ifndef AXIS1_MOTOR_ENCODER_REVERSE
+  #define AXIS1_MOTOR_ENCODER_REVERSE   OFF                       // reverse count direction of the motor shaft encoder relative to the axis encoder
+  #endif
+  #ifndef AXIS1_MOTOR_ENCODER_RATIO
+  #define AXIS1_MOTOR_ENCODER_RATIO     1.0                       // motor shaft encoder counts per axis encoder count
+  #endif
+  #ifndef AXIS1_VELOCITY_PID_P
+  #define AXIS1_VELOCITY_PID_P          0.1                       // velocity loop P = proportional, on counts per second error
+  #endif
+  #ifndef AXIS1_VELOCITY_PID_I
+  #define AXIS1_VELOCITY_PID_I          1.0                       // velocity loop I = integral
+  #endif
+  #ifndef AXIS1_VELOCITY_PID_D
+  #define AXIS1_VELOCITY_PID_D          0.0                       // velocity loop D = derivative
+  #endif
+  #ifndef AXIS1_POSITION_LOOP_LIMIT
+  #define AXIS1_POSITION_LOOP_LIMIT     1000.0                    // position loop velocity correction limit, in axis encoder counts per second
+  #endif
+#endif
+#if AXIS1_DRIVER_MODEL >= TMC_RAMP_DRIVER_FIRST && AXIS1_DRIVER_MODEL <= TMC_RAMP_DRIVER_LAST
+  #define AXIS1_TMC_RAMP_PRESENT
+  #ifndef AXIS1_DRIVER_MICROSTEPS
+  #define AXIS1_DRIVER_MICROSTEPS       OFF                       // microstep mode, used for slews too
+  #endif
+  #ifndef AXIS1_DRIVER_DECAY
+  #define AXIS1_DRIVER_DECAY            OFF                       // OFF for default, TMC STEALTHCHOP
+  #endif
+  #ifndef AXIS1_DRIVER_DECAY_GOTO
+  #define AXIS1_DRIVER_DECAY_GOTO       OFF                       // OFF for default, TMC SPREADCYCLE
+  #endif
+  #ifndef AXIS1_DRIVER_IHOLD
+  #define AXIS1_DRIVER_IHOLD            OFF                       // in mA
+  #endif
+  #ifndef AXIS1_DRIVER_IRUN
+  #define AXIS1_DRIVER_IRUN             OFF                       // in mA
+  #endif
+  #ifndef AXIS1_DRIVER_IGOTO
+  #define AXIS1_DRIVER_IGOTO            OFF                       // in mA
+  #endif
+  #ifndef AXIS1_DRIVER_STATUS
+  #define AXIS1_DRIVER_STATUS           OFF                       // driver status reporting (ON for TMC SPI or HIGH/LOW for fault pin)
+  #endif
 #endif
 #if AXIS1_DRIVER_MODEL >= ODRIVE_DRIVER_FIRST && AXIS1_DRIVER_MODEL <= ODRIVE_DRIVER_LAST
   #define AXIS1_ODRIVE_PRESENT
@@ -357,6 +540,9 @@
 #ifndef AXIS2_SYNC_THRESHOLD
 #define AXIS2_SYNC_THRESHOLD          OFF
 #endif
+#ifndef AXIS2_ENCODER_ABSOLUTE
+#define AXIS2_ENCODER_ABSOLUTE        OFF                         // ON sets the step/dir axis position from its absolute encoder at boot
+#endif
 #ifndef AXIS2_SENSE_HOME
 #define AXIS2_SENSE_HOME              OFF                         // HIGH or LOW state when clockwise of home position, seen from above
 #endif
@@ -390,6 +576,9 @@
   #ifndef AXIS2_STEP_STATE
   #define AXIS2_STEP_STATE              HIGH
   #endif
+  #ifndef AXIS2_STEP_RMT
+  #define AXIS2_STEP_RMT                OFF
+  #endif
   #ifndef AXIS2_M2_ON_STATE
   #define AXIS2_M2_ON_STATE             HIGH
   #endif
@@ -420,6 +609,39 @@
   #ifndef AXIS2_DRIVER_STATUS
   #define AXIS2_DRIVER_STATUS           OFF
   #endif
+  #ifndef AXIS2_DRIVER_STALL
+  #define AXIS2_DRIVER_STALL            OFF                       // TMC StallGuard threshold (SGT or TMC2209 SGTHRS)
+  #endif
+  #ifndef AXIS2_DRIVER_DECAY_FAST
+  #define AXIS2_DRIVER_DECAY_FAST       OFF                       // OFF for DECAY_GOTO, TMC mode above FAST_RATE
+  #endif
+  #ifndef AXIS2_DRIVER_IFAST
+  #define AXIS2_DRIVER_IFAST            OFF                       // in mA, OFF for IGOTO, TMC current above FAST_RATE
+  #endif
+  #ifndef AXIS2_DRIVER_FAST_RATE
+  #define AXIS2_DRIVER_FAST_RATE        OFF                       // in steps/s, OFF disables the TMC high speed band
+  #endif
+  #ifndef AXIS2_DRIVER_ITRACK
+  #define AXIS2_DRIVER_ITRACK           OFF                       // in mA, OFF for IRUN, TMC current while tracking
+  #endif
+  #ifndef AXIS2_ENCODER
+  #define AXIS2_ENCODER                 OFF                       // axis encoder for tracking correction: AB, CW_CCW, PULSE_DIR, SERIAL_BRIDGE, or OFF
+  #endif
+  #ifndef AXIS2_ENCODER_ORIGIN
+  #define AXIS2_ENCODER_ORIGIN          0                         // +/- offset so encoder count is 0 at home (for absolute encoders)
+  #endif
+  #ifndef AXIS2_ENCODER_REVERSE
+  #define AXIS2_ENCODER_REVERSE         OFF                       // reverse count direction of encoder
+  #endif
+  #ifndef AXIS2_ENCODER_RATIO
+  #define AXIS2_ENCODER_RATIO           1.0                       // motor steps per axis encoder count
+  #endif
+  #ifndef AXIS2_ENCODER_TRIM_LIMIT
+  #define AXIS2_ENCODER_TRIM_LIMIT      5.0                       // tracking correction rate limit, in % of the tracking rate
+  #endif
+  #ifndef AXIS2_ENCODER_TRIM_TIME
+  #define AXIS2_ENCODER_TRIM_TIME       2.0                       // tracking correction time constant, in seconds
+  #endif
 #endif
 #if AXIS2_DRIVER_MODEL >= SERVO_DRIVER_FIRST && AXIS2_DRIVER_MODEL <= SERVO_DRIVER_LAST
   #define AXIS2_SERVO_PRESENT
@@ -443,9 +665,18 @@
   #ifndef AXIS2_SERVO_VELOCITY_FACTOR
   #define AXIS2_SERVO_VELOCITY_FACTOR   frequency*0
   #endif
+  #ifndef AXIS2_SERVO_ACCEL_FACTOR
+  #define AXIS2_SERVO_ACCEL_FACTOR      0.0
+  #endif
   #ifndef AXIS2_SERVO_ACCELERATION
   #define AXIS2_SERVO_ACCELERATION      20
   #endif
+  #ifndef AXIS2_SERVO_CURRENT_SCALE
+  #define AXIS2_SERVO_CURRENT_SCALE     3300
+  #endif
+  #ifndef AXIS2_SERVO_CURRENT_LIMIT
+  #define AXIS2_SERVO_CURRENT_LIMIT     OFF
+  #endif
   #ifndef AXIS2_SERVO_FEEDBACK
   #define AXIS2_SERVO_FEEDBACK          FB_PID
   #endif
@@ -481,6 +712,58 @@
   #ifndef AXIS2_ENCODER_REVERSE
   #define AXIS2_ENCODER_REVERSE         OFF
   #endif
+
+  #ifndef AXIS2_MOTOR_ENCODER
+  #define AXIS2_MOTOR_ENCODER           OFF                       // motor shaft encoder for dual loop control: AB_ESP32, AB_STM32, AB_TEENSY4, or OFF
+  #endif
+  #ifndef AXIS2_MOTOR_ENCODER_A_PIN
+  #define AXIS2_MOTOR_ENCODER_A_PIN     OFF                       // motor shaft encoder A pin
+  #endif
+  #ifndef AXIS2_MOTOR_ENCODER_B_PIN
+  #define AXIS2_MOTOR_ENCODER_B_PIN     OFF                       // motor shaft encoder B pin
+  #endif
+  #ifndef AXIS2_MOTOR_ENCODER_REVERSE
+  #define AXIS2_MOTOR_ENCODER_REVERSE   OFF                       // reverse count direction of the motor shaft encoder relative to the axis encoder
+  #endif
+  #ifndef AXIS2_MOTOR_ENCODER_RATIO
+  #define AXIS2_MOTOR_ENCODER_RATIO     1.0                       // motor shaft encoder counts per axis encoder count
+  #endif
+  #ifndef AXIS2_VELOCITY_PID_P
+  #define AXIS2_VELOCITY_PID_P          0.1                       // velocity loop P = proportional, on counts per second error
+  #endif
+  #ifndef AXIS2_VELOCITY_PID_I
+  #define AXIS2_VELOCITY_PID_I          1.0                       // velocity loop I = integral
+  #endif
+  #ifndef AXIS2_VELOCITY_PID_D
+  #define AXIS2_VELOCITY_PID_D          0.0                       // velocity loop D = derivative
+  #endif
+  #ifndef AXIS2_POSITION_LOOP_LIMIT
+  #define AXIS2_POSITION_LOOP_LIMIT     1000.0                    // position loop velocity correction limit, in axis encoder counts per second
+  #endif
+#endif
+#if AXIS2_DRIVER_MODEL >= TMC_RAMP_DRIVER_FIRST && AXIS2_DRIVER_MODEL <= TMC_RAMP_DRIVER_LAST
+  #define AXIS2_TMC_RAMP_PRESENT
+  #ifndef AXIS2_DRIVER_MICROSTEPS
+  #define AXIS2_DRIVER_MICROSTEPS       OFF                       // microstep mode, used for slews too
+  #endif
+  #ifndef AXIS2_DRIVER_DECAY
+  #define AXIS2_DRIVER_DECAY            OFF                       // OFF for default, TMC STEALTHCHOP
+  #endif
+  #ifndef AXIS2_DRIVER_DECAY_GOTO
+  #define AXIS2_DRIVER_DECAY_GOTO       OFF                       // OFF for default, TMC SPREADCYCLE
+  #endif
+  #ifndef AXIS2_DRIVER_IHOLD
+  #define AXIS2_DRIVER_IHOLD            OFF                       // in mA
+  #endif
+  #ifndef AXIS2_DRIVER_IRUN
+  #define AXIS2_DRIVER_IRUN             OFF                       // in mA
+  #endif
+  #ifndef AXIS2_DRIVER_IGOTO
+  #define AXIS2_DRIVER_IGOTO            OFF                       // in mA
+  #endif
+  #ifndef AXIS2_DRIVER_STATUS
+  #define AXIS2_DRIVER_STATUS           OFF                       // driver status reporting (ON for TMC SPI or HIGH/LOW for fault pin)
+  #endif
 #endif
 #if AXIS2_DRIVER_MODEL >= ODRIVE_DRIVER_FIRST && AXIS2_DRIVER_MODEL <= ODRIVE_DRIVER_LAST
   #define AXIS2_ODRIVE_PRESENT
@@ -612,6 +895,12 @@
 #ifndef TIME_LOCATION_PPS_SENSE
 #define TIME_LOCATION_PPS_SENSE       OFF
 #endif
+#ifndef TIME_LOCATION_RTC_ALIGN
+#define TIME_LOCATION_RTC_ALIGN       OFF                         // ON sets the time again at the RTC's next seconds edge (DS3231/DS3234/SD3031)
+#endif
+#ifndef SIDEREAL_CLOCK_COUNTER
+#define SIDEREAL_CLOCK_COUNTER        OFF                         // ON works out LAST from the microsecond counter, frees the clock h/w timer
+#endif
 
 // limits
 #ifndef LIMIT_SENSE
@@ -640,6 +929,9 @@
 #ifndef ST4_HAND_CONTROL_FOCUSER
 #define ST4_HAND_CONTROL_FOCUSER      OFF
 #endif
+#ifndef ST4_INTERRUPT
+#define ST4_INTERRUPT                 OFF                         // ON senses the guide inputs by pin change interrupt
+#endif
 
 // park
 #ifndef PARK_SENSE
@@ -664,6 +956,35 @@
 #define PARK_STRICT                   OFF
 #endif
 
+#ifndef PARK_LOW_POWER
+#define PARK_LOW_POWER                OFF                         // n=10..3600 seconds parked and idle before drivers are disabled and tasks slowed
+#endif
+
+// position journal
+#ifndef MOUNT_JOURNAL
+#define MOUNT_JOURNAL                 OFF                         // n=1..10 times a second the axis positions are journaled to FRAM NV, resumed after a power loss
+#endif
+
+// dome
+#ifndef DOME_SLAVING
+#define DOME_SLAVING                  OFF                         // ON reports the dome azimuth for the position and goto target (see :GXDZ#)
+#endif
+#ifndef DOME_RADIUS
+#define DOME_RADIUS                   1500.0F                     // in mm
+#endif
+#ifndef DOME_PIER_OFFSET_N
+#define DOME_PIER_OFFSET_N            0.0F                        // in mm, mount axes intersection north (+) or south (-) of the dome center
+#endif
+#ifndef DOME_PIER_OFFSET_E
+#define DOME_PIER_OFFSET_E            0.0F                        // in mm, mount axes intersection east (+) or west (-) of the dome center
+#endif
+#ifndef DOME_PIER_OFFSET_UP
+#define DOME_PIER_OFFSET_UP           0.0F                        // in mm, mount axes intersection above (+) or below (-) the dome center
+#endif
+#ifndef DOME_GEM_OFFSET
+#define DOME_GEM_OFFSET               0.0F                        // in mm, polar axis to optical axis along the Dec axis (GEM only)
+#endif
+
 // pec
 #ifndef PEC_STEPS_PER_WORM_ROTATION
 #define PEC_STEPS_PER_WORM_ROTATION   0
@@ -671,6 +992,24 @@
 #ifndef PEC_BUFFER_SIZE_LIMIT
 #define PEC_BUFFER_SIZE_LIMIT         720                         // fixed PEC buffer maximum size
 #endif
+#ifndef PEC_SLOT_MS
+#define PEC_SLOT_MS                   1000                        // in ms (sidereal), duration of each PEC buffer slot
+#endif
+#ifndef PEC_INTERPOLATE
+#define PEC_INTERPOLATE               OFF                         // OFF steps the PEC rate once per slot, LINEAR or CUBIC smooth it
+#endif
+#ifndef PEC_HARMONICS
+#define PEC_HARMONICS                 OFF                         // OFF records a PEC table, or n (1 to 12) fits n worm harmonics instead
+#endif
+#ifndef PEC_GEAR_HARMONIC
+#define PEC_GEAR_HARMONIC             OFF                         // OFF or n, adds a term for a gear that turns n times per worm rotation
+#endif
+#ifndef PEC_ADAPTIVE
+#define PEC_ADAPTIVE                  OFF                         // OFF or n, while playing n% of the guiding still needed goes into the PEC data
+#endif
+#ifndef PEC_ENCODER
+#define PEC_ENCODER                   OFF                         // OFF or n, records from the Axis1 encoder averaged over n worm rotations
+#endif
 #ifndef PEC_SENSE
 #define PEC_SENSE                     OFF
 #endif
@@ -688,6 +1027,30 @@
 #ifndef GUIDE_SEPARATE_PULSE_RATE
 #define GUIDE_SEPARATE_PULSE_RATE     ON                          // normally always enabled
 #endif
+#ifndef GUIDE_PULSE_PRECISE
+#define GUIDE_PULSE_PRECISE           OFF                         // ON times pulses in microseconds and corrects overruns
+#endif
+#ifndef GUIDE_PULSE_BLEND
+#define GUIDE_PULSE_BLEND             OFF                         // ON adds overlapping pulses together into one correction
+#endif
+#ifndef MOUNT_LOG
+#define MOUNT_LOG                     OFF                         // n=16..4096 guide pulse, PEC, and tracking rate records kept in RAM
+#endif
+#ifndef MOUNT_CAPTURE
+#define MOUNT_CAPTURE                 OFF                         // n=4..256 timestamped position captures queued, :SXMC# or the pin
+#endif
+#ifndef MOUNT_CAPTURE_PIN
+#define MOUNT_CAPTURE_PIN             OFF                         // n, input (camera flash sync or intervalometer) that triggers a capture
+#endif
+#ifndef MOUNT_CAPTURE_SENSE
+#define MOUNT_CAPTURE_SENSE           HIGH                        // edge to capture on, LOW, HIGH, or BOTH
+#endif
+#ifndef MOUNT_CAPTURE_INIT
+#define MOUNT_CAPTURE_INIT            INPUT_PULLUP
+#endif
+#ifndef GUIDE_PULSE_POLL_US
+#define GUIDE_PULSE_POLL_US           1000                        // in microseconds, guide monitor rate during a precise pulse
+#endif
 
 // tracking
 #ifndef TRACK_AUTOSTART
@@ -702,11 +1065,35 @@
 #ifndef TRACK_BACKLASH_RATE
 #define TRACK_BACKLASH_RATE           25
 #endif
+#ifndef TRACK_COMPENSATION_PERIOD
+#define TRACK_COMPENSATION_PERIOD     1000                        // in ms, how often the compensated tracking rates are updated
+#endif
+#ifndef TRACK_KEYHOLE
+#define TRACK_KEYHOLE                 OFF                         // ON for alt-az mounts to plan the azimuth flip of passes near the zenith
+#endif
+#ifndef TRACK_KEYHOLE_RATE
+#define TRACK_KEYHOLE_RATE            120.0F                      // in x sidereal, fastest azimuth rate used for the flip
+#endif
+#ifndef TRACK_KEYHOLE_ACCEL
+#define TRACK_KEYHOLE_ACCEL           2.0F                        // in x sidereal per second, azimuth acceleration used for the flip
+#endif
 
 // slewing
 #ifndef GOTO_FEATURE
 #define GOTO_FEATURE                  ON                          // OFF disables goto functionality
 #endif
+#ifndef EPHEMERIS
+#define EPHEMERIS                     OFF                         // ON for Sun, Moon, and planet gotos (:LP[n]#) and tracking (:TP[n]#)
+#endif
+#ifndef TRAJECTORY
+#define TRAJECTORY                    OFF                         // ON to follow a path uploaded as timestamped samples or from TLE (:TJ...#)
+#endif
+#ifndef LIBRARY_APPARENT
+#define LIBRARY_APPARENT              OFF                         // ON for library objects at J2000, corrected to the apparent place for goto
+#endif
+#ifndef LIBRARY_FLASH
+#define LIBRARY_FLASH                 OFF                         // ON for read-only catalogs prebuilt into the "catalog" flash partition (ESP32)
+#endif
 #ifndef SLEW_RATE_BASE_DESIRED
 #define SLEW_RATE_BASE_DESIRED        1.0                         // *desired* maximum slew rate, actual slew rate depends on many factors
 #endif
@@ -722,6 +1109,12 @@
 #ifndef SLEW_RAPID_STOP_DIST
 #define SLEW_RAPID_STOP_DIST          2.0                         // distance in degrees for emergency stop
 #endif
+#ifndef AXIS1_JERK_TIME
+#define AXIS1_JERK_TIME               0.0                         // in seconds, to reach full acceleration (S-curve) or 0 to disable
+#endif
+#ifndef AXIS2_JERK_TIME
+#define AXIS2_JERK_TIME               0.0
+#endif
 #ifndef GOTO_OFFSET
 #define GOTO_OFFSET                   0.25                        // distance in degrees for goto target unidirectional approach, 0.0 disables
 #endif
@@ -734,6 +1127,27 @@
 #ifndef GOTO_REFINE_STAGES
 #define GOTO_REFINE_STAGES           1                            // number of times to perform the goto refinement stage
 #endif
+#ifndef GOTO_COORDINATED
+#define GOTO_COORDINATED              OFF                         // ON scales the rate/acceleration of the shorter axis move so
+#endif                                                            // both axes arrive at the target at the same time
+#ifndef GOTO_QUEUE
+#define GOTO_QUEUE                    OFF                         // OFF or n, 2 to 64 target goto queue run back to back (:MQ[...]#)
+#endif
+#ifndef GOTO_PREDICTIVE
+#define GOTO_PREDICTIVE               OFF                         // ON aims the goto where the target will be on arrival, with
+#endif                                                            // GOTO_OFFSET 0.0 the refine stage is then skipped
+#ifndef GOTO_WAYPOINT_BLEND
+#define GOTO_WAYPOINT_BLEND           OFF                         // ON passes through meridian flip waypoints without stopping
+#endif                                                            // when both axes carry on in the same direction
+#ifndef GOTO_AXIS_RATES
+#define GOTO_AXIS_RATES               OFF                         // ON limits the rate/acceleration of each axis by its own step
+#endif                                                            // rate, so the faster axis isn't held back by the slower one
+#ifndef GOTO_PARK_HOME_FAST
+#define GOTO_PARK_HOME_FAST           OFF                         // ON park/home in one slew at the highest rate allowed, with no
+#endif                                                            // settle or refine stage
+#ifndef GOTO_PARK_HOME_APPROACH
+#define GOTO_PARK_HOME_APPROACH       0.0                         // distance in degrees for a final low speed approach from one
+#endif                                                            // direction when GOTO_PARK_HOME_FAST is ON, 0.0 disables
 
 // meridian flip, pier side
 #ifndef MFLIP_SKIP_HOME
@@ -761,6 +1175,14 @@
 #define PIER_SIDE_PREFERRED_MEMORY    OFF
 #endif
 
+// limits
+#ifndef HORIZON_MASK
+#define HORIZON_MASK                  OFF                         // OFF or 1 or 2, horizon mask by azimuth in bins of this many
+#endif                                                            // degrees (kept in NV, set with :SXH[n],[sDD]#)
+#ifndef LIMIT_MERIDIAN_STEPS
+#define LIMIT_MERIDIAN_STEPS          OFF                         // ON has Axis1 check the meridian limit as a step count during
+#endif                                                            // slews (at the axis poll rate instead of the 10Hz limits poll)
+
 // align
 #ifndef ALIGN_MAX_STARS
 #define ALIGN_MAX_STARS               AUTO                        // max num align stars, AUTO for HAL specified default
@@ -770,10 +1192,26 @@
 #define ALIGN_AUTO_HOME               OFF                         // uses home switches to find home before starting the align
 #endif
 
+#ifndef ALIGN_LEAST_SQUARES
+#define ALIGN_LEAST_SQUARES           ON                          // fits the pointing model by least squares, OFF for the grid search alone
+#endif
+
+#ifndef ALIGN_REFINE
+#define ALIGN_REFINE                  OFF                         // ON for syncs after an align to add a star and refine the pointing model
+#endif
+
 #ifndef ALIGN_MODEL_MEMORY
 #define ALIGN_MODEL_MEMORY            OFF                         // restores any pointing model saved in NV at startup
 #endif
 
+#ifndef ALIGN_MODEL_SLOTS
+#define ALIGN_MODEL_SLOTS             OFF                         // n=2 to 8 named pointing model slots in NV, the last selected is restored at startup
+#endif
+
+#ifndef ALIGN_POINTS_MAX
+#define ALIGN_POINTS_MAX              OFF                         // n=10 to 250 points imported in bulk (binary protocol) for a large pointing model
+#endif
+
 #define HIGH_SPEED_ALIGN
 
 // -----------------------------------------------------------------------------------
@@ -802,6 +1240,12 @@
 #ifndef AXIS3_ACCELERATION_TIME
 #define AXIS3_ACCELERATION_TIME       2.0                         // in seconds, to selected rate
 #endif
+#ifndef AXIS3_JERK_TIME
+#define AXIS3_JERK_TIME               0.0                         // in seconds, to reach full acceleration (S-curve) or 0 to disable
+#endif
+#ifndef AXIS3_SETTLE_TIME
+#define AXIS3_SETTLE_TIME             0                           // in ms, after a move stops before it's reported settled
+#endif
 #ifndef AXIS3_RAPID_STOP_TIME
 #define AXIS3_RAPID_STOP_TIME         1.0                         // in seconds, to stop
 #endif
@@ -850,6 +1294,9 @@
   #ifndef AXIS3_STEP_STATE
   #define AXIS3_STEP_STATE              HIGH
   #endif
+  #ifndef AXIS3_STEP_RMT
+  #define AXIS3_STEP_RMT                OFF
+  #endif
   #ifndef AXIS3_M2_ON_STATE
   #define AXIS3_M2_ON_STATE             HIGH
   #endif
@@ -880,6 +1327,21 @@
   #ifndef AXIS3_DRIVER_STATUS
   #define AXIS3_DRIVER_STATUS           OFF
   #endif
+  #ifndef AXIS3_DRIVER_STALL
+  #define AXIS3_DRIVER_STALL            OFF
+  #endif
+  #ifndef AXIS3_DRIVER_DECAY_FAST
+  #define AXIS3_DRIVER_DECAY_FAST       OFF
+  #endif
+  #ifndef AXIS3_DRIVER_IFAST
+  #define AXIS3_DRIVER_IFAST            OFF
+  #endif
+  #ifndef AXIS3_DRIVER_FAST_RATE
+  #define AXIS3_DRIVER_FAST_RATE        OFF
+  #endif
+  #ifndef AXIS3_DRIVER_ITRACK
+  #define AXIS3_DRIVER_ITRACK           OFF
+  #endif
 #endif
 #if AXIS3_DRIVER_MODEL >= SERVO_DRIVER_FIRST
   #define AXIS3_SERVO_PRESENT
@@ -901,6 +1363,12 @@
   #ifndef AXIS3_SERVO_ACCELERATION
   #define AXIS3_SERVO_ACCELERATION      20
   #endif
+  #ifndef AXIS3_SERVO_CURRENT_SCALE
+  #define AXIS3_SERVO_CURRENT_SCALE     3300
+  #endif
+  #ifndef AXIS3_SERVO_CURRENT_LIMIT
+  #define AXIS3_SERVO_CURRENT_LIMIT     OFF
+  #endif
   #ifndef AXIS3_SERVO_FEEDBACK
   #define AXIS3_SERVO_FEEDBACK          FB_PID
   #endif
@@ -959,6 +1427,15 @@
 #ifndef FOCUSER_BUTTON_MOVE_RATE
 #define FOCUSER_BUTTON_MOVE_RATE      0                           // focuser button move rate, 0 uses last set or specify fixed rate in um/sec
 #endif
+#ifndef FOCUSER_TCF_TABLE
+#define FOCUSER_TCF_TABLE             OFF                         // ON for TCF by temperature/offset table and per-filter offsets
+#endif
+#ifndef FOCUSER_TCF_RATE
+#define FOCUSER_TCF_RATE              1.0                         // in um/s, with FOCUSER_TCF_TABLE fastest the TCF offset follows
+#endif
+#ifndef FOCUSER_SWEEP
+#define FOCUSER_SWEEP                 OFF                         // ON for on-device V-curve autofocus sweeps (:FV commands)
+#endif
 
 // -----------------------------------------------------------------------------------
 // focuser settings, FOCUSER1
@@ -989,6 +1466,12 @@
 #ifndef AXIS4_ACCELERATION_TIME
 #define AXIS4_ACCELERATION_TIME       2.0                         // in seconds, to selected rate
 #endif
+#ifndef AXIS4_JERK_TIME
+#define AXIS4_JERK_TIME               0.0                         // in seconds, to reach full acceleration (S-curve) or 0 to disable
+#endif
+#ifndef AXIS4_SETTLE_TIME
+#define AXIS4_SETTLE_TIME             0                           // in ms, after a move stops before it's reported settled
+#endif
 #ifndef AXIS4_RAPID_STOP_TIME
 #define AXIS4_RAPID_STOP_TIME         1.0                         // in seconds, to stop
 #endif
@@ -1037,6 +1520,9 @@
   #ifndef AXIS4_STEP_STATE
   #define AXIS4_STEP_STATE              HIGH
   #endif
+  #ifndef AXIS4_STEP_RMT
+  #define AXIS4_STEP_RMT                OFF
+  #endif
   #ifndef AXIS4_M2_ON_STATE
   #define AXIS4_M2_ON_STATE             HIGH
   #endif
@@ -1067,6 +1553,21 @@
   #ifndef AXIS4_DRIVER_STATUS
   #define AXIS4_DRIVER_STATUS           OFF
   #endif
+  #ifndef AXIS4_DRIVER_STALL
+  #define AXIS4_DRIVER_STALL            OFF
+  #endif
+  #ifndef AXIS4_DRIVER_DECAY_FAST
+  #define AXIS4_DRIVER_DECAY_FAST       OFF
+  #endif
+  #ifndef AXIS4_DRIVER_IFAST
+  #define AXIS4_DRIVER_IFAST            OFF
+  #endif
+  #ifndef AXIS4_DRIVER_FAST_RATE
+  #define AXIS4_DRIVER_FAST_RATE        OFF
+  #endif
+  #ifndef AXIS4_DRIVER_ITRACK
+  #define AXIS4_DRIVER_ITRACK           OFF
+  #endif
 #endif
 #if AXIS4_DRIVER_MODEL >= SERVO_DRIVER_FIRST
   #define AXIS4_SERVO_PRESENT
@@ -1088,6 +1589,12 @@
   #ifndef AXIS4_SERVO_ACCELERATION
   #define AXIS4_SERVO_ACCELERATION      20
   #endif
+  #ifndef AXIS4_SERVO_CURRENT_SCALE
+  #define AXIS4_SERVO_CURRENT_SCALE     3300
+  #endif
+  #ifndef AXIS4_SERVO_CURRENT_LIMIT
+  #define AXIS4_SERVO_CURRENT_LIMIT     OFF
+  #endif
   #ifndef AXIS4_SERVO_FEEDBACK
   #define AXIS4_SERVO_FEEDBACK          FB_PID
   #endif
@@ -1153,6 +1660,12 @@
 #ifndef AXIS5_ACCELERATION_TIME
 #define AXIS5_ACCELERATION_TIME       2.0
 #endif
+#ifndef AXIS5_JERK_TIME
+#define AXIS5_JERK_TIME               0.0
+#endif
+#ifndef AXIS5_SETTLE_TIME
+#define AXIS5_SETTLE_TIME             0
+#endif
 #ifndef AXIS5_RAPID_STOP_TIME
 #define AXIS5_RAPID_STOP_TIME         1.0
 #endif
@@ -1201,6 +1714,9 @@
   #ifndef AXIS5_STEP_STATE
   #define AXIS5_STEP_STATE              HIGH
   #endif
+  #ifndef AXIS5_STEP_RMT
+  #define AXIS5_STEP_RMT                OFF
+  #endif
   #ifndef AXIS5_M2_ON_STATE
   #define AXIS5_M2_ON_STATE             HIGH
   #endif
@@ -1231,6 +1747,21 @@
   #ifndef AXIS5_DRIVER_STATUS
   #define AXIS5_DRIVER_STATUS           OFF
   #endif
+  #ifndef AXIS5_DRIVER_STALL
+  #define AXIS5_DRIVER_STALL            OFF
+  #endif
+  #ifndef AXIS5_DRIVER_DECAY_FAST
+  #define AXIS5_DRIVER_DECAY_FAST       OFF
+  #endif
+  #ifndef AXIS5_DRIVER_IFAST
+  #define AXIS5_DRIVER_IFAST            OFF
+  #endif
+  #ifndef AXIS5_DRIVER_FAST_RATE
+  #define AXIS5_DRIVER_FAST_RATE        OFF
+  #endif
+  #ifndef AXIS5_DRIVER_ITRACK
+  #define AXIS5_DRIVER_ITRACK           OFF
+  #endif
 #endif
 #if AXIS5_DRIVER_MODEL >= SERVO_DRIVER_FIRST
   #define AXIS5_SERVO_PRESENT
@@ -1250,6 +1781,12 @@
   #ifndef AXIS5_SERVO_ACCELERATION
   #define AXIS5_SERVO_ACCELERATION      20
   #endif
+  #ifndef AXIS5_SERVO_CURRENT_SCALE
+  #define AXIS5_SERVO_CURRENT_SCALE     3300
+  #endif
+  #ifndef AXIS5_SERVO_CURRENT_LIMIT
+  #define AXIS5_SERVO_CURRENT_LIMIT     OFF
+  #endif
   #ifndef AXIS5_SERVO_FEEDBACK
   #define AXIS5_SERVO_FEEDBACK          FB_PID
   #endif
@@ -1315,6 +1852,12 @@
 #ifndef AXIS6_ACCELERATION_TIME
 #define AXIS6_ACCELERATION_TIME       2.0
 #endif
+#ifndef AXIS6_JERK_TIME
+#define AXIS6_JERK_TIME               0.0
+#endif
+#ifndef AXIS6_SETTLE_TIME
+#define AXIS6_SETTLE_TIME             0
+#endif
 #ifndef AXIS6_RAPID_STOP_TIME
 #define AXIS6_RAPID_STOP_TIME         1.0
 #endif
@@ -1363,6 +1906,9 @@
   #ifndef AXIS6_STEP_STATE
   #define AXIS6_STEP_STATE              HIGH
   #endif
+  #ifndef AXIS6_STEP_RMT
+  #define AXIS6_STEP_RMT                OFF
+  #endif
   #ifndef AXIS6_M2_ON_STATE
   #define AXIS6_M2_ON_STATE             HIGH
   #endif
@@ -1393,6 +1939,21 @@
   #ifndef AXIS6_DRIVER_STATUS
   #define AXIS6_DRIVER_STATUS           OFF
   #endif
+  #ifndef AXIS6_DRIVER_STALL
+  #define AXIS6_DRIVER_STALL            OFF
+  #endif
+  #ifndef AXIS6_DRIVER_DECAY_FAST
+  #define AXIS6_DRIVER_DECAY_FAST       OFF
+  #endif
+  #ifndef AXIS6_DRIVER_IFAST
+  #define AXIS6_DRIVER_IFAST            OFF
+  #endif
+  #ifndef AXIS6_DRIVER_FAST_RATE
+  #define AXIS6_DRIVER_FAST_RATE        OFF
+  #endif
+  #ifndef AXIS6_DRIVER_ITRACK
+  #define AXIS6_DRIVER_ITRACK           OFF
+  #endif
 #endif
 #if AXIS6_DRIVER_MODEL >= SERVO_DRIVER_FIRST
   #define AXIS6_SERVO_PRESENT
@@ -1412,6 +1973,12 @@
   #ifndef AXIS6_SERVO_ACCELERATION
   #define AXIS6_SERVO_ACCELERATION      20
   #endif
+  #ifndef AXIS6_SERVO_CURRENT_SCALE
+  #define AXIS6_SERVO_CURRENT_SCALE     3300
+  #endif
+  #ifndef AXIS6_SERVO_CURRENT_LIMIT
+  #define AXIS6_SERVO_CURRENT_LIMIT     OFF
+  #endif
   #ifndef AXIS6_SERVO_FEEDBACK
   #define AXIS6_SERVO_FEEDBACK          FB_PID
   #endif
@@ -1477,6 +2044,12 @@
 #ifndef AXIS7_ACCELERATION_TIME
 #define AXIS7_ACCELERATION_TIME       2.0
 #endif
+#ifndef AXIS7_JERK_TIME
+#define AXIS7_JERK_TIME               0.0
+#endif
+#ifndef AXIS7_SETTLE_TIME
+#define AXIS7_SETTLE_TIME             0
+#endif
 #ifndef AXIS7_RAPID_STOP_TIME
 #define AXIS7_RAPID_STOP_TIME         1.0
 #endif
@@ -1525,6 +2098,9 @@
   #ifndef AXIS7_STEP_STATE
   #define AXIS7_STEP_STATE              HIGH
   #endif
+  #ifndef AXIS7_STEP_RMT
+  #define AXIS7_STEP_RMT                OFF
+  #endif
   #ifndef AXIS7_M2_ON_STATE
   #define AXIS7_M2_ON_STATE             HIGH
   #endif
@@ -1555,6 +2131,21 @@
   #ifndef AXIS7_DRIVER_STATUS
   #define AXIS7_DRIVER_STATUS           OFF
   #endif
+  #ifndef AXIS7_DRIVER_STALL
+  #define AXIS7_DRIVER_STALL            OFF
+  #endif
+  #ifndef AXIS7_DRIVER_DECAY_FAST
+  #define AXIS7_DRIVER_DECAY_FAST       OFF
+  #endif
+  #ifndef AXIS7_DRIVER_IFAST
+  #define AXIS7_DRIVER_IFAST            OFF
+  #endif
+  #ifndef AXIS7_DRIVER_FAST_RATE
+  #define AXIS7_DRIVER_FAST_RATE        OFF
+  #endif
+  #ifndef AXIS7_DRIVER_ITRACK
+  #define AXIS7_DRIVER_ITRACK           OFF
+  #endif
 #endif
 #if AXIS7_DRIVER_MODEL >= SERVO_DRIVER_FIRST
   #define AXIS7_SERVO_PRESENT
@@ -1574,6 +2165,12 @@
   #ifndef AXIS7_SERVO_ACCELERATION
   #define AXIS7_SERVO_ACCELERATION      20
   #endif
+  #ifndef AXIS7_SERVO_CURRENT_SCALE
+  #define AXIS7_SERVO_CURRENT_SCALE     3300
+  #endif
+  #ifndef AXIS7_SERVO_CURRENT_LIMIT
+  #define AXIS7_SERVO_CURRENT_LIMIT     OFF
+  #endif
   #ifndef AXIS7_SERVO_FEEDBACK
   #define AXIS7_SERVO_FEEDBACK          FB_PID
   #endif
@@ -1639,6 +2236,12 @@
 #ifndef AXIS8_ACCELERATION_TIME
 #define AXIS8_ACCELERATION_TIME       2.0
 #endif
+#ifndef AXIS8_JERK_TIME
+#define AXIS8_JERK_TIME               0.0
+#endif
+#ifndef AXIS8_SETTLE_TIME
+#define AXIS8_SETTLE_TIME             0
+#endif
 #ifndef AXIS8_RAPID_STOP_TIME
 #define AXIS8_RAPID_STOP_TIME         1.0
 #endif
@@ -1687,6 +2290,9 @@
   #ifndef AXIS8_STEP_STATE
   #define AXIS8_STEP_STATE              HIGH
   #endif
+  #ifndef AXIS8_STEP_RMT
+  #define AXIS8_STEP_RMT                OFF
+  #endif
   #ifndef AXIS8_M2_ON_STATE
   #define AXIS8_M2_ON_STATE             HIGH
   #endif
@@ -1717,6 +2323,21 @@
   #ifndef AXIS8_DRIVER_STATUS
   #define AXIS8_DRIVER_STATUS           OFF
   #endif
+  #ifndef AXIS8_DRIVER_STALL
+  #define AXIS8_DRIVER_STALL            OFF
+  #endif
+  #ifndef AXIS8_DRIVER_DECAY_FAST
+  #define AXIS8_DRIVER_DECAY_FAST       OFF
+  #endif
+  #ifndef AXIS8_DRIVER_IFAST
+  #define AXIS8_DRIVER_IFAST            OFF
+  #endif
+  #ifndef AXIS8_DRIVER_FAST_RATE
+  #define AXIS8_DRIVER_FAST_RATE        OFF
+  #endif
+  #ifndef AXIS8_DRIVER_ITRACK
+  #define AXIS8_DRIVER_ITRACK           OFF
+  #endif
 #endif
 #if AXIS8_DRIVER_MODEL >= SERVO_DRIVER_FIRST
   #define AXIS8_SERVO_PRESENT
@@ -1736,6 +2357,12 @@
   #ifndef AXIS8_SERVO_ACCELERATION
   #define AXIS8_SERVO_ACCELERATION      20
   #endif
+  #ifndef AXIS8_SERVO_CURRENT_SCALE
+  #define AXIS8_SERVO_CURRENT_SCALE     3300
+  #endif
+  #ifndef AXIS8_SERVO_CURRENT_LIMIT
+  #define AXIS8_SERVO_CURRENT_LIMIT     OFF
+  #endif
   #ifndef AXIS8_SERVO_FEEDBACK
   #define AXIS8_SERVO_FEEDBACK          FB_PID
   #endif
@@ -1801,6 +2428,12 @@
 #ifndef AXIS9_ACCELERATION_TIME
 #define AXIS9_ACCELERATION_TIME       2.0
 #endif
+#ifndef AXIS9_JERK_TIME
+#define AXIS9_JERK_TIME               0.0
+#endif
+#ifndef AXIS9_SETTLE_TIME
+#define AXIS9_SETTLE_TIME             0
+#endif
 #ifndef AXIS9_RAPID_STOP_TIME
 #define AXIS9_RAPID_STOP_TIME         1.0
 #endif
@@ -1849,6 +2482,9 @@
   #ifndef AXIS9_STEP_STATE
   #define AXIS9_STEP_STATE              HIGH
   #endif
+  #ifndef AXIS9_STEP_RMT
+  #define AXIS9_STEP_RMT                OFF
+  #endif
   #ifndef AXIS9_M2_ON_STATE
   #define AXIS9_M2_ON_STATE             HIGH
   #endif
@@ -1879,6 +2515,21 @@
   #ifndef AXIS9_DRIVER_STATUS
   #define AXIS9_DRIVER_STATUS           OFF
   #endif
+  #ifndef AXIS9_DRIVER_STALL
+  #define AXIS9_DRIVER_STALL            OFF
+  #endif
+  #ifndef AXIS9_DRIVER_DECAY_FAST
+  #define AXIS9_DRIVER_DECAY_FAST       OFF
+  #endif
+  #ifndef AXIS9_DRIVER_IFAST
+  #define AXIS9_DRIVER_IFAST            OFF
+  #endif
+  #ifndef AXIS9_DRIVER_FAST_RATE
+  #define AXIS9_DRIVER_FAST_RATE        OFF
+  #endif
+  #ifndef AXIS9_DRIVER_ITRACK
+  #define AXIS9_DRIVER_ITRACK           OFF
+  #endif
 #endif
 #if AXIS9_DRIVER_MODEL >= SERVO_DRIVER_FIRST
   #define AXIS9_SERVO_PRESENT
@@ -1898,6 +2549,12 @@
   #ifndef AXIS9_SERVO_ACCELERATION
   #define AXIS9_SERVO_ACCELERATION      20
   #endif
+  #ifndef AXIS9_SERVO_CURRENT_SCALE
+  #define AXIS9_SERVO_CURRENT_SCALE     3300
+  #endif
+  #ifndef AXIS9_SERVO_CURRENT_LIMIT
+  #define AXIS9_SERVO_CURRENT_LIMIT     OFF
+  #endif
   #ifndef AXIS9_SERVO_FEEDBACK
   #define AXIS9_SERVO_FEEDBACK          FB_PID
   #endif
@@ -1957,6 +2614,16 @@
   #define STEP_DIR_MOTOR_PRESENT
 #endif
 
+#if (defined(AXIS1_STEP_DIR_PRESENT) && AXIS1_ENCODER != OFF) || (defined(AXIS2_STEP_DIR_PRESENT) && AXIS2_ENCODER != OFF)
+  #define STEP_DIR_ENCODER_PRESENT
+#endif
+
+#if AXIS1_STEP_RMT == ON || AXIS2_STEP_RMT == ON || AXIS3_STEP_RMT == ON || \
+    AXIS4_STEP_RMT == ON || AXIS5_STEP_RMT == ON || AXIS6_STEP_RMT == ON || \
+    AXIS7_STEP_RMT == ON || AXIS8_STEP_RMT == ON || AXIS9_STEP_RMT == ON
+  #define STEP_DIR_RMT_PRESENT
+#endif
+
 #if defined(AXIS1_SERVO_PRESENT) || defined(AXIS2_SERVO_PRESENT) || defined(AXIS3_SERVO_PRESENT) || \
     defined(AXIS4_SERVO_PRESENT) || defined(AXIS5_SERVO_PRESENT) || defined(AXIS6_SERVO_PRESENT) || \
     defined(AXIS7_SERVO_PRESENT) || defined(AXIS8_SERVO_PRESENT) || defined(AXIS9_SERVO_PRESENT)
@@ -1967,6 +2634,10 @@
     defined(AXIS4_SERVO_DC) || defined(AXIS5_SERVO_DC) || defined(AXIS6_SERVO_DC) || \
     defined(AXIS7_SERVO_DC) || defined(AXIS8_SERVO_DC) || defined(AXIS9_SERVO_DC)
   #define SERVO_DC_PRESENT
+
+  #ifndef SERVO_DC_PWM_FREQUENCY
+  #define SERVO_DC_PWM_FREQUENCY        OFF                       // in Hz, OFF for platform default or 20000 (etc.) for quiet hardware PWM
+  #endif
 #endif
 
 #if defined(AXIS1_SERVO_TMC2209) || defined(AXIS2_SERVO_TMC2209) || defined(AXIS3_SERVO_TMC2209) || \
@@ -1979,6 +2650,10 @@
   #define SERVO_TMC5160_PRESENT
 #endif
 
+#if defined(AXIS1_TMC_RAMP_PRESENT) || defined(AXIS2_TMC_RAMP_PRESENT)
+  #define TMC_RAMP_MOTOR_PRESENT
+#endif
+
 #if defined(AXIS1_ODRIVE_PRESENT) || defined(AXIS2_ODRIVE_PRESENT)
   #define ODRIVE_MOTOR_PRESENT
 
@@ -1994,6 +2669,18 @@
   #ifndef ODRIVE_UPDATE_MS
   #define ODRIVE_UPDATE_MS              100                       // 10 HZ update rate
   #endif
+  #ifndef ODRIVE_STEPLESS
+  #define ODRIVE_STEPLESS               OFF                       // ON computes setpoints from the Axis rate, no step timer
+  #endif
+  #ifndef ODRIVE_CAN_CYCLIC
+  #define ODRIVE_CAN_CYCLIC             OFF                       // ON streams position+velocity setpoints and reads encoder estimates
+  #endif
+  #ifndef ODRIVE_CYCLIC_MS
+  #define ODRIVE_CYCLIC_MS              10                        // 100 HZ setpoint rate, match the ODrive encoder_rate_ms
+  #endif
+  #ifndef ODRIVE_FOLLOWING_LIMIT
+  #define ODRIVE_FOLLOWING_LIMIT        OFF                       // in arc seconds, encoder following error that faults the axis
+  #endif
   #ifndef ODRIVE_SWAP_AXES
   #define ODRIVE_SWAP_AXES              ON                        // ODrive axis 0 = OnStep Axis2 = DEC or ALT
   #endif                                                          // ODrive axis 1 = OnStep Axis1 = RA or AZM
@@ -2010,7 +2697,7 @@
                                                                   // or 1/0.7583 = 1.32 arc-min/tick;  1.32*60 sec = 79.2 arc sec per encoder tick
 #endif
 
-#if defined(SERVO_MOTOR_PRESENT) || defined(STEP_DIR_MOTOR_PRESENT) || defined(ODRIVE_MOTOR_PRESENT)
+#if defined(SERVO_MOTOR_PRESENT) || defined(STEP_DIR_MOTOR_PRESENT) || defined(ODRIVE_MOTOR_PRESENT) || defined(TMC_RAMP_MOTOR_PRESENT)
   #define MOTOR_PRESENT
 #endif
 
@@ -99,6 +99,12 @@
 #define MODEL_DUAL                  4      // pointing model compensated tracking both axes
 #define COMPENSATED_TRACKING_LAST   4
 
+// PEC INTERPOLATION
+#define PEC_INTERPOLATE_FIRST       1
+#define LINEAR                      1      // straight line between the slot centers
+#define CUBIC                       2      // smooth curve through the neighboring slots (Catmull-Rom)
+#define PEC_INTERPOLATE_LAST        2
+
 // TEMPERATURE sensing devices
 #define TEMPERATURE_FIRST           1
 #define DS1820     0x2800000000000000      // DS18B20 1-wire temperature sensors for focusing and dew heaters
@@ -129,12 +135,34 @@
 // task manager
 #define TASKS_MAX                   48     // up to 48 tasks
 #define TASKS_SKIP_MISSED                  // just skip missed tasks if too late
+//#define TASKS_READY_QUEUE                // keep due tasks in a ready queue instead of polling them all at each yield()
+#define TASKS_LOAD_METER                   // measure processor load, see :GXFA# command
+//#define TASKS_IDLE_WAIT                  // idle the processor between tasks, requires TASKS_READY_QUEUE
+#ifndef __AVR__
+  #define TASKS_STATISTICS_ENABLE          // keep per task lateness/runtime statistics, see :GXT[N|S|L|R]nn# commands
+  #define TASKS_BUDGET_ENABLE              // keep plugin task runtime and budget overruns, see :GXTPn# command
+#endif
 #ifdef ESP32
   #define TASKS_HWTIMERS             4     // up to 4 hardware timers
 #else
   #define TASKS_HWTIMERS             3
 #endif
 
+// command channels
+#ifndef __AVR__
+  #define COMMAND_STATISTICS_ENABLE        // keep per channel command counts, bytes, and timing, see :GXC[S|H]c# commands
+#endif
+//#define COMMAND_TRACE 256                // record the last n commands from all channels for replay with the original timing, see :SXJ[C|P],n# commands
+
+// coordinate pipeline timing
+//#define MOUNT_BENCHMARK                  // time Transform, GeoAlign, Convert, Mount::poll() and Axis::poll(), see :GXB[n]# command
+
+// scripted motion checks
+//#define MOUNT_SCENARIO                   // track, goto, and guide scenarios that report pointing error and step jitter, see :SXZS,n# and :GXZ[n]#
+
+// step ISR timing
+//#define STEP_DIR_BENCHMARK               // step ISR cycle counts, entry latency, and max step rate self-test, see :GXP[n]# command
+
 // default start of axis class hardware timers
 #define AXIS_HARDWARE_TIMER_BASE    2      // in the OnStepX timer#1 is the sidereal clock
 
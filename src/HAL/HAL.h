@@ -109,6 +109,18 @@
   #define ICACHE_RAM_ATTR
 #endif
 
+// large, infrequently used data, placed in slower RAM where the platform has a choice (not zeroed at startup)
+#ifndef HAL_BULK_DATA
+  #define HAL_BULK_DATA
+#endif
+
+// motion hot path and scheduler, normally left to the linker (flash on ESP32) unless HOT_PATH_IRAM is ON
+#if defined(ESP32) && HOT_PATH_IRAM == ON
+  #define IRAM_HOT IRAM_ATTR
+#else
+  #define IRAM_HOT
+#endif
+
 #ifndef FPSTR
   #define FPSTR
 #endif
@@ -166,6 +178,8 @@
   #endif
   #include "../lib/nv/NV_MB85RC.h"
   #define HAL_NV_INIT() nv.init(E2END + 1, NV_CACHED, 0, false, &HAL_Wire, NV_ADDRESS)
+#elif NV_DRIVER == NV_JOURNAL && !defined(ESP32)
+  #error "Configuration (Config.h): NV_DRIVER NV_JOURNAL is only supported on the ESP32."
 #endif
 
 // Non-volatile storage
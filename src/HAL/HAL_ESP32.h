@@ -3,10 +3,16 @@
 
 // This is for fast processors with hardware FP
 #define HAL_FAST_PROCESSOR
+// The FPU is single precision only so coordinate transforms are done in float
+#define HAL_SINGLE_PRECISION_FPU
 
 // Base rate for critical task timing
 #define HAL_FRACTIONAL_SEC 100.0F
 
+// Free running 64 bit microsecond counter (for SIDEREAL_CLOCK_COUNTER)
+#include <esp_timer.h>
+#define HAL_MICROS64() ((uint64_t)esp_timer_get_time())
+
 // Analog read and write
 #ifndef ANALOG_READ_RANGE
   #define ANALOG_READ_RANGE 4095
@@ -39,6 +45,11 @@
   #define NV_ENDURANCE NVE_LOW
   #include "../lib/nv/NV_ESP.h"
   #define HAL_NV_INIT() nv.init(E2END + 1, false, 5000, false)
+#elif NV_DRIVER == NV_JOURNAL
+  #define E2END 4095
+  #define NV_ENDURANCE NVE_MID
+  #include "../lib/nv/NV_ESP_Journal.h"
+  #define HAL_NV_INIT() nv.init(E2END + 1, true, 5000, false)
 #endif
 
 //--------------------------------------------------------------------------------------------------
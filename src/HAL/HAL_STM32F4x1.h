@@ -5,6 +5,8 @@
 #define __ARM_STM32__
 
 #define HAL_FAST_PROCESSOR
+// The FPU is single precision only so coordinate transforms are done in float
+#define HAL_SINGLE_PRECISION_FPU
 
 // Base rate for critical task timing
 #define HAL_FRACTIONAL_SEC 200.0F
@@ -39,6 +39,8 @@
   #define HAL_PULSE_WIDTH 400  // in ns, estimated
 #endif
 #define HAL_FAST_PROCESSOR
+// The FPU is single precision only so coordinate transforms are done in float
+#define HAL_SINGLE_PRECISION_FPU
 
 // New symbol for the default I2C port -------------------------------------------------------------
 #include <Wire.h>
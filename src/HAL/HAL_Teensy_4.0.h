@@ -30,6 +30,14 @@
 #define HAL_FAST_PROCESSOR
 #define HAL_VFAST_PROCESSOR
 
+// Memory layout -----------------------------------------------------------------------------------
+// code runs from ITCM and static data (ISR state, axes, motors, the align model) is in single cycle DTCM, the
+// heap (NV cache, PEC buffer) is in cached OCRAM along with the bulk buffers placed by HAL_BULK_DATA, nothing
+// here uses DMA so there is no cache maintenance to do, #define HAL_BULK_DATA empty to keep them in DTCM
+#ifndef HAL_BULK_DATA
+  #define HAL_BULK_DATA DMAMEM
+#endif
+
 // New symbol for the default I2C port -------------------------------------------------------------
 #include <Wire.h>
 #define HAL_Wire Wire
@@ -22,6 +22,44 @@
 #endif
 
 // GENERAL ---------------------------------------
+#if DEBUG_DEFERRED != OFF
+  #if DEBUG == OFF || DEBUG == PROFILER
+    #error "Configuration (Config.h): Setting DEBUG_DEFERRED requires DEBUG ON, VERBOSE, or REMOTE"
+  #endif
+  #if DEBUG_DEFERRED < 16 || DEBUG_DEFERRED > 4096 || (DEBUG_DEFERRED & (DEBUG_DEFERRED - 1)) != 0
+    #error "Configuration (Config.h): Setting DEBUG_DEFERRED unknown, use OFF or a power of 2 from 16 to 4096"
+  #endif
+#endif
+
+#if HOT_PATH_IRAM != OFF && HOT_PATH_IRAM != ON
+  #error "Configuration (Config.h): Setting HOT_PATH_IRAM unknown, use OFF or ON"
+#endif
+#if HOT_PATH_IRAM == ON && !defined(ESP32)
+  #error "Configuration (Config.h): Setting HOT_PATH_IRAM ON is supported on ESP32 only"
+#endif
+
+#if WATCHDOG != OFF && WATCHDOG != ON
+  #error "Configuration (Config.h): Setting WATCHDOG unknown, use OFF or ON"
+#endif
+#if WATCHDOG_SECONDS < 2 || WATCHDOG_SECONDS > 30
+  #error "Configuration (Config.h): Setting WATCHDOG_SECONDS unknown, use 2 to 30 (seconds)"
+#endif
+#if WATCHDOG_HEARTBEAT_MS < 100 || WATCHDOG_HEARTBEAT_MS > 10000
+  #error "Configuration (Config.h): Setting WATCHDOG_HEARTBEAT_MS unknown, use 100 to 10000 (ms)"
+#endif
+#if DEBUG_PROBE1_PIN != OFF && (DEBUG_PROBE1_PIN < 0 || DEBUG_PROBE1_PIN > 255)
+  #error "Configuration (Config.h): Setting DEBUG_PROBE1_PIN unknown, use OFF or a pin 0 to 255 (direct MCU pins only)"
+#endif
+#if DEBUG_PROBE2_PIN != OFF && (DEBUG_PROBE2_PIN < 0 || DEBUG_PROBE2_PIN > 255)
+  #error "Configuration (Config.h): Setting DEBUG_PROBE2_PIN unknown, use OFF or a pin 0 to 255 (direct MCU pins only)"
+#endif
+#if DEBUG_PROBE3_PIN != OFF && (DEBUG_PROBE3_PIN < 0 || DEBUG_PROBE3_PIN > 255)
+  #error "Configuration (Config.h): Setting DEBUG_PROBE3_PIN unknown, use OFF or a pin 0 to 255 (direct MCU pins only)"
+#endif
+#if DEBUG_PROBE4_PIN != OFF && (DEBUG_PROBE4_PIN < 0 || DEBUG_PROBE4_PIN > 255)
+  #error "Configuration (Config.h): Setting DEBUG_PROBE4_PIN unknown, use OFF or a pin 0 to 255 (direct MCU pins only)"
+#endif
+
 #if defined(STEP_DIR_TMC_UART_PRESENT) && (!defined(SERIAL_TMC) || !defined(SERIAL_TMC_BAUD))
   #error "Configuration (Config.h): This PINMAP doesn't support TMC UART mode drivers"
 #endif
@@ -73,6 +111,50 @@
   #warning "Configuration (Config.h): Setting SERIAL_E_BAUD_DEFAULT unknown, use OFF, 9600, 19200, 38400, 57600, 115200, 230400, of 460800 (baud.)"
 #endif
 
+#if SERIAL_POLL_BUDGET < 100 || SERIAL_POLL_BUDGET > 10000
+  #error "Configuration (Config.h): Setting SERIAL_POLL_BUDGET unknown, use 100 to 10000 (microseconds.)"
+#endif
+
+#if SERIAL_BACKLOG_PRIORITY != OFF && (SERIAL_BACKLOG_PRIORITY < 0 || SERIAL_BACKLOG_PRIORITY > 4)
+  #error "Configuration (Config.h): Setting SERIAL_BACKLOG_PRIORITY unknown, use OFF or 0 to 4."
+#endif
+
+#if SERIAL_EXPEDITE_PRIORITY != OFF && (SERIAL_EXPEDITE_PRIORITY < 0 || SERIAL_EXPEDITE_PRIORITY > 4)
+  #error "Configuration (Config.h): Setting SERIAL_EXPEDITE_PRIORITY unknown, use OFF or 0 to 4."
+#endif
+
+#if SERIAL_BT_THROUGHPUT != OFF && SERIAL_BT_THROUGHPUT != ON
+  #error "Configuration (Config.h): Setting SERIAL_BT_THROUGHPUT unknown, use OFF or ON."
+#endif
+
+#if SERIAL_BT_STATUS_STREAM != OFF && (SERIAL_BT_STATUS_STREAM < 100 || SERIAL_BT_STATUS_STREAM > 60000)
+  #error "Configuration (Config.h): Setting SERIAL_BT_STATUS_STREAM unknown, use OFF or 100 to 60000 (milliseconds.)"
+#endif
+
+#if SERIAL_WEBSOCKET != OFF && SERIAL_WEBSOCKET != ON
+  #error "Configuration (Config.h): Setting SERIAL_WEBSOCKET unknown, use OFF or ON."
+#endif
+
+#if SERIAL_WEBSOCKET == ON && SERIAL_IP_MODE == OFF
+  #error "Configuration (Config.h): Setting SERIAL_WEBSOCKET requires a SERIAL_IP_MODE (WiFi or Ethernet) interface."
+#endif
+
+#if ALPACA != OFF && ALPACA != ON
+  #error "Configuration (Config.h): Setting ALPACA unknown, use OFF or ON."
+#endif
+
+#if ALPACA == ON && SERIAL_IP_MODE == OFF
+  #error "Configuration (Config.h): Setting ALPACA requires a SERIAL_IP_MODE (WiFi or Ethernet) interface."
+#endif
+
+#if TELEMETRY_RATE != OFF && (TELEMETRY_RATE < 1 || TELEMETRY_RATE > 20)
+  #error "Configuration (Config.h): Setting TELEMETRY_RATE unknown, use OFF or 1 to 20 (packets per second.)"
+#endif
+
+#if TELEMETRY_RATE != OFF && SERIAL_IP_MODE == OFF
+  #error "Configuration (Config.h): Setting TELEMETRY_RATE requires a SERIAL_IP_MODE (WiFi or Ethernet) interface."
+#endif
+
 #if STATUS_LED != OFF && STATUS_LED != ON
   #error "Configuration (Config.h): Setting STATUS_LED unknown, use OFF or ON."
 #endif
@@ -97,6 +179,10 @@
   #error "Configuration (Config.h): Setting STEP_WAVE_FORM SQUARE is required for the Teensy4.0 and 4.1"
 #endif
 
+#if defined(STEP_DIR_RMT_PRESENT) && !defined(ESP32)
+  #error "Configuration (Config.h): Setting AXISn_STEP_RMT ON is only supported on the ESP32"
+#endif
+
 // MOUNT -----------------------------------------
 
 #if (AXIS1_DRIVER_MODEL != OFF && AXIS2_DRIVER_MODEL == OFF) || \
@@ -108,7 +194,8 @@
 #if AXIS1_DRIVER_MODEL != OFF && \
     (AXIS1_DRIVER_MODEL < STEP_DIR_DRIVER_FIRST || AXIS1_DRIVER_MODEL > STEP_DIR_DRIVER_LAST) && \
     (AXIS1_DRIVER_MODEL < SERVO_DRIVER_FIRST || AXIS1_DRIVER_MODEL > SERVO_DRIVER_LAST) && \
-    (AXIS1_DRIVER_MODEL < ODRIVE_DRIVER_FIRST || AXIS1_DRIVER_MODEL > ODRIVE_DRIVER_LAST)
+    (AXIS1_DRIVER_MODEL < ODRIVE_DRIVER_FIRST || AXIS1_DRIVER_MODEL > ODRIVE_DRIVER_LAST) && \
+    (AXIS1_DRIVER_MODEL < TMC_RAMP_DRIVER_FIRST || AXIS1_DRIVER_MODEL > TMC_RAMP_DRIVER_LAST)
   #error "Configuration (Config.h): Setting AXIS1_DRIVER_MODEL unknown, use OFF or a valid DRIVER (from Constants.h)"
 #endif
 
@@ -116,6 +203,10 @@
   #error "Configuration (Config.h): Setting AXIS1_DRIVER_STATUS unknown, use OFF or a valid driver status."
 #endif
 
+#if defined(AXIS1_DRIVER_STALL) && AXIS1_DRIVER_STALL != OFF && AXIS1_DRIVER_STATUS != ON
+  #error "Configuration (Config.h): Setting AXIS1_DRIVER_STALL requires AXIS1_DRIVER_STATUS ON."
+#endif
+
 #ifdef AXIS1_STEP_DIR_PRESENT
   #if AXIS1_DRIVER_MICROSTEPS != OFF && (AXIS1_DRIVER_MICROSTEPS < 1 || AXIS1_DRIVER_MICROSTEPS > 256)
     #error "Configuration (Config.h): Setting AXIS1_DRIVER_MICROSTEPS unknown, use OFF or a valid microstep setting (range 1 to 256x and supported by your driver/design.)"
@@ -151,12 +242,48 @@
   #if AXIS1_DRIVER_IGOTO != OFF && (AXIS1_DRIVER_IGOTO < 0 || AXIS1_DRIVER_IGOTO > 3000)
     #error "Configuration (Config.h): Setting AXIS1_DRIVER_IGOTO unknown, use OFF or a value 0 to 3000 (mA.)"
   #endif
+  #if AXIS1_DRIVER_IFAST != OFF && (AXIS1_DRIVER_IFAST < 0 || AXIS1_DRIVER_IFAST > 3000)
+    #error "Configuration (Config.h): Setting AXIS1_DRIVER_IFAST unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS1_DRIVER_ITRACK != OFF && (AXIS1_DRIVER_ITRACK < 0 || AXIS1_DRIVER_ITRACK > 3000)
+    #error "Configuration (Config.h): Setting AXIS1_DRIVER_ITRACK unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS1_DRIVER_DECAY_FAST != OFF && (AXIS1_DRIVER_DECAY_FAST < DRIVER_DECAY_MODE_FIRST || AXIS1_DRIVER_DECAY_FAST > DRIVER_DECAY_MODE_LAST)
+    #error "Configuration (Config.h): Setting AXIS1_DRIVER_DECAY_FAST unknown, use a valid DRIVER DECAY MODE (from Constants.h)"
+  #endif
+  #if AXIS1_DRIVER_FAST_RATE != OFF && AXIS1_DRIVER_FAST_RATE <= 0
+    #error "Configuration (Config.h): Setting AXIS1_DRIVER_FAST_RATE unknown, use OFF or a rate > 0 (steps/s.)"
+  #endif
+  #if AXIS1_ENCODER != OFF && (AXIS1_ENCODER < ENC_FIRST || AXIS1_ENCODER > ENC_LAST || AXIS1_ENCODER == PULSE_ONLY)
+    #error "Configuration (Config.h): Setting AXIS1_ENCODER unknown, use OFF or a valid SERVO ENCODER (from Constants.h) other than PULSE_ONLY"
+  #endif
+  #if AXIS1_ENCODER_ABSOLUTE != OFF && AXIS1_ENCODER_ABSOLUTE != ON
+    #error "Configuration (Config.h): Setting AXIS1_ENCODER_ABSOLUTE unknown, use OFF or ON."
+  #endif
+  #if AXIS1_ENCODER_ABSOLUTE == ON && AXIS1_ENCODER != AS37_H39B_B && AXIS1_ENCODER != SERIAL_BRIDGE
+    #error "Configuration (Config.h): Setting AXIS1_ENCODER_ABSOLUTE requires an absolute AXIS1_ENCODER, AS37_H39B_B or SERIAL_BRIDGE"
+  #endif
 #endif
 
 #ifdef AXIS1_SERVO_PRESENT
+  #if AXIS1_ENCODER_ABSOLUTE == ON
+    #error "Configuration (Config.h): Setting AXIS1_ENCODER_ABSOLUTE is for step/dir axes, servo absolute encoders use AXIS1_SYNC_THRESHOLD"
+  #endif
   #if AXIS1_ENCODER < ENC_FIRST || AXIS1_ENCODER > ENC_LAST
     #error "Configuration (Config.h): Setting AXIS1_ENCODER unknown, use a valid SERVO ENCODER (from Constants.h)"
   #endif
+  #if AXIS1_MOTOR_ENCODER != OFF && AXIS1_MOTOR_ENCODER != AB_ESP32 && AXIS1_MOTOR_ENCODER != AB_STM32 && AXIS1_MOTOR_ENCODER != AB_TEENSY4
+    #error "Configuration (Config.h): Setting AXIS1_MOTOR_ENCODER unknown, use OFF or a hardware decoded AB_ESP32, AB_STM32, or AB_TEENSY4 encoder"
+  #endif
+  #if AXIS1_SERVO_CURRENT_LIMIT != OFF && AXIS1_SERVO_CURRENT_LIMIT <= 0
+    #error "Configuration (Config.h): Setting AXIS1_SERVO_CURRENT_LIMIT unknown, use OFF or a value > 0 (mA.)"
+  #endif
+  #if AXIS1_SERVO_CURRENT_LIMIT != OFF && AXIS1_SERVO_CURRENT_PIN == OFF
+    #error "Configuration (Config.h): Setting AXIS1_SERVO_CURRENT_LIMIT requires an AXIS1_SERVO_CURRENT_PIN"
+  #endif
+  #if AXIS1_SERVO_CURRENT_SCALE <= 0
+    #error "Configuration (Config.h): Setting AXIS1_SERVO_CURRENT_SCALE unknown, use a value > 0 (mA.)"
+  #endif
 #endif
 
 #if AXIS1_SYNC_THRESHOLD != OFF && AXIS2_SYNC_THRESHOLD == OFF
@@ -195,11 +322,42 @@
   #error "Configuration (Config.h): Setting AXIS1_SENSE_LIMIT_MAX unknown, use OFF or HIGH/LOW and HYST() and/or THLD() as described in comments."
 #endif
 
+#ifdef SERVO_DC_PRESENT
+  #if SERVO_DC_PWM_FREQUENCY != OFF && (SERVO_DC_PWM_FREQUENCY < 100 || SERVO_DC_PWM_FREQUENCY > 100000)
+    #error "Configuration (Config.h): Setting SERVO_DC_PWM_FREQUENCY unknown, use OFF or a value 100 to 100000 (Hz.)"
+  #endif
+  #if SERVO_DC_PWM_FREQUENCY != OFF && !defined(ESP32) && !defined(TEENSYDUINO) && !defined(ARDUINO_ARCH_STM32)
+    #error "Configuration (Config.h): Setting SERVO_DC_PWM_FREQUENCY is only supported on ESP32, Teensy, and STM32 processors."
+  #endif
+#endif
+
+#ifdef ODRIVE_MOTOR_PRESENT
+  #if ODRIVE_COMM_MODE != OD_UART && ODRIVE_COMM_MODE != OD_CAN
+    #error "Configuration (Config.h): Setting ODRIVE_COMM_MODE unknown, use OD_UART or OD_CAN."
+  #endif
+  #if ODRIVE_STEPLESS != OFF && ODRIVE_STEPLESS != ON
+    #error "Configuration (Config.h): Setting ODRIVE_STEPLESS unknown, use OFF or ON."
+  #endif
+  #if ODRIVE_CAN_CYCLIC != OFF && ODRIVE_CAN_CYCLIC != ON
+    #error "Configuration (Config.h): Setting ODRIVE_CAN_CYCLIC unknown, use OFF or ON."
+  #endif
+  #if ODRIVE_CAN_CYCLIC == ON && ODRIVE_COMM_MODE != OD_CAN
+    #error "Configuration (Config.h): Setting ODRIVE_CAN_CYCLIC ON requires ODRIVE_COMM_MODE OD_CAN."
+  #endif
+  #if ODRIVE_CYCLIC_MS < 1 || ODRIVE_CYCLIC_MS > 1000
+    #error "Configuration (Config.h): Setting ODRIVE_CYCLIC_MS unknown, use a value 1 to 1000 (ms.)"
+  #endif
+  #if ODRIVE_FOLLOWING_LIMIT != OFF && ODRIVE_FOLLOWING_LIMIT <= 0
+    #error "Configuration (Config.h): Setting ODRIVE_FOLLOWING_LIMIT unknown, use OFF or a value > 0 (arc seconds.)"
+  #endif
+#endif
+
 // AXIS2 DEC/ALT
 #if AXIS2_DRIVER_MODEL != OFF && \
     (AXIS2_DRIVER_MODEL < STEP_DIR_DRIVER_FIRST || AXIS2_DRIVER_MODEL > STEP_DIR_DRIVER_LAST) && \
     (AXIS2_DRIVER_MODEL < SERVO_DRIVER_FIRST || AXIS2_DRIVER_MODEL > SERVO_DRIVER_LAST) && \
-    (AXIS2_DRIVER_MODEL < ODRIVE_DRIVER_FIRST || AXIS2_DRIVER_MODEL > ODRIVE_DRIVER_LAST)
+    (AXIS2_DRIVER_MODEL < ODRIVE_DRIVER_FIRST || AXIS2_DRIVER_MODEL > ODRIVE_DRIVER_LAST) && \
+    (AXIS2_DRIVER_MODEL < TMC_RAMP_DRIVER_FIRST || AXIS2_DRIVER_MODEL > TMC_RAMP_DRIVER_LAST)
   #error "Configuration (Config.h): Setting AXIS2_DRIVER_MODEL unknown, use a valid DRIVER (from Constants.h)"
 #endif
 
@@ -207,6 +365,10 @@
   #error "Configuration (Config.h): Setting AXIS2_DRIVER_STATUS unknown, use OFF or a valid driver status."
 #endif
 
+#if defined(AXIS2_DRIVER_STALL) && AXIS2_DRIVER_STALL != OFF && AXIS2_DRIVER_STATUS != ON
+  #error "Configuration (Config.h): Setting AXIS2_DRIVER_STALL requires AXIS2_DRIVER_STATUS ON."
+#endif
+
 #ifdef AXIS2_STEP_DIR_PRESENT
   #if AXIS2_DRIVER_MICROSTEPS != OFF && (AXIS2_DRIVER_MICROSTEPS < 1 || AXIS2_DRIVER_MICROSTEPS > 256)
     #error "Configuration (Config.h): Setting AXIS2_DRIVER_MICROSTEPS unknown, use OFF or a valid microstep setting (range 1 to 256x and supported by your driver/design.)"
@@ -242,12 +404,48 @@
   #if AXIS2_DRIVER_IGOTO != OFF && (AXIS2_DRIVER_IGOTO < 0 || AXIS2_DRIVER_IGOTO > 3000)
     #error "Configuration (Config.h): Setting AXIS2_DRIVER_IGOTO unknown, use OFF or a value 0 to 3000 (mA.)"
   #endif
+  #if AXIS2_DRIVER_IFAST != OFF && (AXIS2_DRIVER_IFAST < 0 || AXIS2_DRIVER_IFAST > 3000)
+    #error "Configuration (Config.h): Setting AXIS2_DRIVER_IFAST unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS2_DRIVER_ITRACK != OFF && (AXIS2_DRIVER_ITRACK < 0 || AXIS2_DRIVER_ITRACK > 3000)
+    #error "Configuration (Config.h): Setting AXIS2_DRIVER_ITRACK unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS2_DRIVER_DECAY_FAST != OFF && (AXIS2_DRIVER_DECAY_FAST < DRIVER_DECAY_MODE_FIRST || AXIS2_DRIVER_DECAY_FAST > DRIVER_DECAY_MODE_LAST)
+    #error "Configuration (Config.h): Setting AXIS2_DRIVER_DECAY_FAST unknown, use a valid DRIVER DECAY MODE (from Constants.h)"
+  #endif
+  #if AXIS2_DRIVER_FAST_RATE != OFF && AXIS2_DRIVER_FAST_RATE <= 0
+    #error "Configuration (Config.h): Setting AXIS2_DRIVER_FAST_RATE unknown, use OFF or a rate > 0 (steps/s.)"
+  #endif
+  #if AXIS2_ENCODER != OFF && (AXIS2_ENCODER < ENC_FIRST || AXIS2_ENCODER > ENC_LAST || AXIS2_ENCODER == PULSE_ONLY)
+    #error "Configuration (Config.h): Setting AXIS2_ENCODER unknown, use OFF or a valid SERVO ENCODER (from Constants.h) other than PULSE_ONLY"
+  #endif
+  #if AXIS2_ENCODER_ABSOLUTE != OFF && AXIS2_ENCODER_ABSOLUTE != ON
+    #error "Configuration (Config.h): Setting AXIS2_ENCODER_ABSOLUTE unknown, use OFF or ON."
+  #endif
+  #if AXIS2_ENCODER_ABSOLUTE == ON && AXIS2_ENCODER != AS37_H39B_B && AXIS2_ENCODER != SERIAL_BRIDGE
+    #error "Configuration (Config.h): Setting AXIS2_ENCODER_ABSOLUTE requires an absolute AXIS2_ENCODER, AS37_H39B_B or SERIAL_BRIDGE"
+  #endif
 #endif
 
 #ifdef AXIS2_SERVO_PRESENT
+  #if AXIS2_ENCODER_ABSOLUTE == ON
+    #error "Configuration (Config.h): Setting AXIS2_ENCODER_ABSOLUTE is for step/dir axes, servo absolute encoders use AXIS2_SYNC_THRESHOLD"
+  #endif
   #if AXIS2_ENCODER < ENC_FIRST || AXIS2_ENCODER > ENC_LAST
     #error "Configuration (Config.h): Setting AXIS2_ENCODER unknown, use a valid SERVO ENCODER (from Constants.h)"
   #endif
+  #if AXIS2_MOTOR_ENCODER != OFF && AXIS2_MOTOR_ENCODER != AB_ESP32 && AXIS2_MOTOR_ENCODER != AB_STM32 && AXIS2_MOTOR_ENCODER != AB_TEENSY4
+    #error "Configuration (Config.h): Setting AXIS2_MOTOR_ENCODER unknown, use OFF or a hardware decoded AB_ESP32, AB_STM32, or AB_TEENSY4 encoder"
+  #endif
+  #if AXIS2_SERVO_CURRENT_LIMIT != OFF && AXIS2_SERVO_CURRENT_LIMIT <= 0
+    #error "Configuration (Config.h): Setting AXIS2_SERVO_CURRENT_LIMIT unknown, use OFF or a value > 0 (mA.)"
+  #endif
+  #if AXIS2_SERVO_CURRENT_LIMIT != OFF && AXIS2_SERVO_CURRENT_PIN == OFF
+    #error "Configuration (Config.h): Setting AXIS2_SERVO_CURRENT_LIMIT requires an AXIS2_SERVO_CURRENT_PIN"
+  #endif
+  #if AXIS2_SERVO_CURRENT_SCALE <= 0
+    #error "Configuration (Config.h): Setting AXIS2_SERVO_CURRENT_SCALE unknown, use a value > 0 (mA.)"
+  #endif
 #endif
 
 #if AXIS2_SYNC_THRESHOLD != OFF && AXIS1_SYNC_THRESHOLD == OFF
@@ -307,6 +505,30 @@
   #error "Configuration (Config.h): Setting ALIGN_MAX_STARS unknown, use AUTO or a value from 1 to 9."
 #endif
 
+#if ALIGN_LEAST_SQUARES != ON && ALIGN_LEAST_SQUARES != OFF
+  #error "Configuration (Config.h): Setting ALIGN_LEAST_SQUARES unknown, use OFF or ON."
+#endif
+
+#if ALIGN_REFINE != ON && ALIGN_REFINE != OFF
+  #error "Configuration (Config.h): Setting ALIGN_REFINE unknown, use OFF or ON."
+#endif
+
+#if ALIGN_REFINE == ON && ALIGN_LEAST_SQUARES != ON
+  #error "Configuration (Config.h): Setting ALIGN_REFINE requires ALIGN_LEAST_SQUARES ON."
+#endif
+
+#if ALIGN_MODEL_SLOTS != OFF && (ALIGN_MODEL_SLOTS < 2 || ALIGN_MODEL_SLOTS > 8)
+  #error "Configuration (Config.h): Setting ALIGN_MODEL_SLOTS unknown, use OFF or a value from 2 to 8."
+#endif
+
+#if ALIGN_POINTS_MAX != OFF && (ALIGN_POINTS_MAX < 10 || ALIGN_POINTS_MAX > 250)
+  #error "Configuration (Config.h): Setting ALIGN_POINTS_MAX unknown, use OFF or a value from 10 to 250."
+#endif
+
+#if ALIGN_POINTS_MAX != OFF && ALIGN_LEAST_SQUARES != ON
+  #error "Configuration (Config.h): Setting ALIGN_POINTS_MAX requires ALIGN_LEAST_SQUARES ON."
+#endif
+
 // TIME AND LOCATION
 #if TIME_LOCATION_SOURCE < TLS_FIRST && TIME_LOCATION_SOURCE > TLS_LAST
   #error "Configuration (Config.h): Setting TIME_LOCATION_SOURCE unknown, use OFF or valid TIME LOCATION SOURCE (from Constants.h)"
@@ -319,6 +541,18 @@
   #error "Configuration (Config.h): Setting TIME_LOCATION_PPS_SENSE unknown, use OFF or LOW or HIGH or BOTH."
 #endif
 
+#if TIME_LOCATION_RTC_ALIGN != OFF && TIME_LOCATION_RTC_ALIGN != ON
+  #error "Configuration (Config.h): Setting TIME_LOCATION_RTC_ALIGN unknown, use OFF or ON."
+#endif
+
+#if TIME_LOCATION_RTC_ALIGN == ON && TIME_LOCATION_SOURCE != DS3231 && TIME_LOCATION_SOURCE != DS3234 && TIME_LOCATION_SOURCE != SD3031
+  #error "Configuration (Config.h): Setting TIME_LOCATION_RTC_ALIGN requires TIME_LOCATION_SOURCE DS3231, DS3234, or SD3031."
+#endif
+
+#if SIDEREAL_CLOCK_COUNTER != OFF && SIDEREAL_CLOCK_COUNTER != ON
+  #error "Configuration (Config.h): Setting SIDEREAL_CLOCK_COUNTER unknown, use OFF or ON."
+#endif
+
 // USER FEEDBACK
 #if STATUS_MOUNT_LED != ON && STATUS_MOUNT_LED != OFF
   #error "Configuration (Config.h): Setting STATUS_MOUNT_LED unknown, use OFF or ON."
@@ -349,6 +583,14 @@
   #error "Configuration (Config.h): Setting ST4_HAND_CONTROL_FOCUSER unknown, use OFF or ON."
 #endif
 
+#if ST4_INTERRUPT != ON && ST4_INTERRUPT != OFF
+  #error "Configuration (Config.h): Setting ST4_INTERRUPT unknown, use OFF or ON."
+#endif
+
+#if ST4_INTERRUPT == ON && ST4_HAND_CONTROL == ON
+  #error "Configuration (Config.h): Setting ST4_INTERRUPT ON isn't supported with ST4_HAND_CONTROL ON, hand control needs the polled inputs."
+#endif
+
 // GUIDING
 #if GUIDE_TIME_LIMIT < 0 || GUIDE_TIME_LIMIT > 120
   #error "Configuration (Config.h): Setting GUIDE_TIME_LIMIT unknown, use the value 0 to disable or 1 to 120 (seconds.)"
@@ -362,6 +604,34 @@
   #error "Configuration (Config.h): Setting GUIDE_SEPARATE_PULSE_RATE unknown, use OFF or ON."
 #endif
 
+#if GUIDE_PULSE_PRECISE != ON && GUIDE_PULSE_PRECISE != OFF
+  #error "Configuration (Config.h): Setting GUIDE_PULSE_PRECISE unknown, use OFF or ON."
+#endif
+
+#if GUIDE_PULSE_BLEND != ON && GUIDE_PULSE_BLEND != OFF
+  #error "Configuration (Config.h): Setting GUIDE_PULSE_BLEND unknown, use OFF or ON."
+#endif
+
+#if MOUNT_LOG != OFF && (MOUNT_LOG < 16 || MOUNT_LOG > 4096)
+  #error "Configuration (Config.h): Setting MOUNT_LOG unknown, use OFF or 16 to 4096 (records.)"
+#endif
+
+#if MOUNT_CAPTURE != OFF && (MOUNT_CAPTURE < 4 || MOUNT_CAPTURE > 256)
+  #error "Configuration (Config.h): Setting MOUNT_CAPTURE unknown, use OFF or 4 to 256 (captures.)"
+#endif
+
+#if MOUNT_CAPTURE_SENSE != LOW && MOUNT_CAPTURE_SENSE != HIGH && MOUNT_CAPTURE_SENSE != BOTH
+  #error "Configuration (Config.h): Setting MOUNT_CAPTURE_SENSE unknown, use LOW or HIGH or BOTH."
+#endif
+
+#if MOUNT_CAPTURE == OFF && MOUNT_CAPTURE_PIN != OFF
+  #error "Configuration (Config.h): Setting MOUNT_CAPTURE_PIN requires MOUNT_CAPTURE be enabled."
+#endif
+
+#if GUIDE_PULSE_POLL_US < 100 || GUIDE_PULSE_POLL_US > 10000
+  #error "Configuration (Config.h): Setting GUIDE_PULSE_POLL_US unknown, use 100 to 10000 (microseconds.)"
+#endif
+
 // SENSORS
 #if (LIMIT_SENSE) != OFF && (LIMIT_SENSE) < 0
   #error "Configuration (Config.h): Setting LIMIT_SENSE unknown, use OFF or HIGH/LOW and HYST() and/or THLD() as described in comments."
@@ -380,11 +650,59 @@
   #error "Configuration (Config.h): Setting PEC_BUFFER_SIZE_LIMIT unknown, use the value 0 to disable or 1 to 30000 (seconds.)"
 #endif
 
+#if PEC_SLOT_MS < 100 || PEC_SLOT_MS > 1000
+  #error "Configuration (Config.h): Setting PEC_SLOT_MS unknown, use a value from 100 to 1000 (milliseconds.)"
+#endif
+
+#if PEC_INTERPOLATE != OFF && (PEC_INTERPOLATE < PEC_INTERPOLATE_FIRST || PEC_INTERPOLATE > PEC_INTERPOLATE_LAST)
+  #error "Configuration (Config.h): Setting PEC_INTERPOLATE unknown, use OFF or LINEAR or CUBIC."
+#endif
+
+#if PEC_HARMONICS != OFF && (PEC_HARMONICS < 1 || PEC_HARMONICS > 12)
+  #error "Configuration (Config.h): Setting PEC_HARMONICS unknown, use OFF or a value from 1 to 12 (harmonics.)"
+#endif
+
+#if PEC_GEAR_HARMONIC != OFF && (PEC_HARMONICS == OFF || PEC_GEAR_HARMONIC <= PEC_HARMONICS || PEC_GEAR_HARMONIC > 255)
+  #error "Configuration (Config.h): Setting PEC_GEAR_HARMONIC unknown, use OFF or a value above PEC_HARMONICS up to 255 (and enable PEC_HARMONICS.)"
+#endif
+
+#if PEC_ADAPTIVE != OFF && (PEC_ADAPTIVE < 1 || PEC_ADAPTIVE > 100)
+  #error "Configuration (Config.h): Setting PEC_ADAPTIVE unknown, use OFF or a value from 1 to 100 (percent.)"
+#endif
+
+#if PEC_ENCODER != OFF && (PEC_ENCODER < 1 || PEC_ENCODER > 20)
+  #error "Configuration (Config.h): Setting PEC_ENCODER unknown, use OFF or a value from 1 to 20 (worm rotations.)"
+#endif
+
+#if PEC_ENCODER != OFF && (!defined(AXIS1_STEP_DIR_PRESENT) || AXIS1_ENCODER == OFF)
+  #error "Configuration (Config.h): Setting PEC_ENCODER requires a step/dir Axis1 with an AXIS1_ENCODER."
+#endif
+
 // SLEWING BEHAVIOUR
 #if GOTO_FEATURE != ON && GOTO_FEATURE != OFF
   #error "Configuration (Config.h): Setting GOTO_FEATURE unknown, use OFF or ON."
 #endif
 
+#if EPHEMERIS != ON && EPHEMERIS != OFF
+  #error "Configuration (Config.h): Setting EPHEMERIS unknown, use OFF or ON."
+#endif
+
+#if TRAJECTORY != ON && TRAJECTORY != OFF
+  #error "Configuration (Config.h): Setting TRAJECTORY unknown, use OFF or ON."
+#endif
+
+#if LIBRARY_APPARENT != ON && LIBRARY_APPARENT != OFF
+  #error "Configuration (Config.h): Setting LIBRARY_APPARENT unknown, use OFF or ON."
+#endif
+
+#if LIBRARY_FLASH != ON && LIBRARY_FLASH != OFF
+  #error "Configuration (Config.h): Setting LIBRARY_FLASH unknown, use OFF or ON."
+#endif
+
+#if LIBRARY_FLASH == ON && !defined(ESP32)
+  #error "Configuration (Config.h): Setting LIBRARY_FLASH ON is only supported on the ESP32."
+#endif
+
 #if SLEW_RATE_MEMORY != ON && SLEW_RATE_MEMORY != OFF
   #error "Configuration (Config.h): Setting SLEW_RATE_MEMORY unknown, use OFF or ON."
 #endif
@@ -406,6 +724,14 @@
   #error "Configuration (Config.h): Setting TRACK_BACKLASH_RATE unknown, use a value between 2 and 100 (x Sidereal.)"
 #endif
 
+#if TRACK_COMPENSATION_PERIOD < 100 || TRACK_COMPENSATION_PERIOD > 10000
+  #error "Configuration (Config.h): Setting TRACK_COMPENSATION_PERIOD unknown, use a value between 100 and 10000 (ms.)"
+#endif
+
+#if TRACK_KEYHOLE != OFF && TRACK_KEYHOLE != ON
+  #error "Configuration (Config.h): Setting TRACK_KEYHOLE unknown, use OFF or ON."
+#endif
+
 // GOTO_FEATURE CHECKS
 #if GOTO_FEATURE == OFF && TRACK_BACKLASH_RATE > 20
   #error "Configuration (Config.h): Setting TRACK_BACKLASH_RATE must be <= 20 when GOTO_FEATURE is OFF."
@@ -420,6 +746,34 @@
 #endif
 
 // PIER SIDE BEHAVIOUR
+#if GOTO_QUEUE != OFF && (GOTO_QUEUE < 2 || GOTO_QUEUE > 64)
+  #error "Configuration (Config.h): Setting GOTO_QUEUE unknown, use OFF or 2 to 64."
+#endif
+
+#if GOTO_PREDICTIVE != ON && GOTO_PREDICTIVE != OFF
+  #error "Configuration (Config.h): Setting GOTO_PREDICTIVE unknown, use OFF or ON."
+#endif
+
+#if GOTO_WAYPOINT_BLEND != ON && GOTO_WAYPOINT_BLEND != OFF
+  #error "Configuration (Config.h): Setting GOTO_WAYPOINT_BLEND unknown, use OFF or ON."
+#endif
+
+#if GOTO_AXIS_RATES != ON && GOTO_AXIS_RATES != OFF
+  #error "Configuration (Config.h): Setting GOTO_AXIS_RATES unknown, use OFF or ON."
+#endif
+
+#if GOTO_PARK_HOME_FAST != ON && GOTO_PARK_HOME_FAST != OFF
+  #error "Configuration (Config.h): Setting GOTO_PARK_HOME_FAST unknown, use OFF or ON."
+#endif
+
+#if HORIZON_MASK != OFF && HORIZON_MASK != 1 && HORIZON_MASK != 2
+  #error "Configuration (Config.h): Setting HORIZON_MASK unknown, use OFF or 1 or 2 (degrees.)"
+#endif
+
+#if LIMIT_MERIDIAN_STEPS != ON && LIMIT_MERIDIAN_STEPS != OFF
+  #error "Configuration (Config.h): Setting LIMIT_MERIDIAN_STEPS unknown, use OFF or ON."
+#endif
+
 #if MFLIP_SKIP_HOME != ON && MFLIP_SKIP_HOME != OFF
   #error "Configuration (Config.h): Setting MFLIP_SKIP_HOME unknown, use OFF or ON."
 #endif
@@ -457,6 +811,24 @@
   #error "Configuration (Config.h): Setting PARK_STRICT unknown, use OFF or ON."
 #endif
 
+#if PARK_LOW_POWER != OFF && (PARK_LOW_POWER < 10 || PARK_LOW_POWER > 3600)
+  #error "Configuration (Config.h): Setting PARK_LOW_POWER unknown, use OFF or a value from 10 to 3600."
+#endif
+
+// POSITION JOURNAL
+#if MOUNT_JOURNAL != OFF && (MOUNT_JOURNAL < 1 || MOUNT_JOURNAL > 10)
+  #error "Configuration (Config.h): Setting MOUNT_JOURNAL unknown, use OFF or a value from 1 to 10."
+#endif
+
+#if MOUNT_JOURNAL != OFF && NV_DRIVER != NV_MB85RC64 && NV_DRIVER != NV_MB85RC256
+  #error "Configuration (Config.h): Setting MOUNT_JOURNAL requires an FRAM NV_DRIVER, use NV_MB85RC64 or NV_MB85RC256."
+#endif
+
+// DOME SLAVING
+#if DOME_SLAVING != ON && DOME_SLAVING != OFF
+  #error "Configuration (Config.h): Setting DOME_SLAVING unknown, use OFF or ON."
+#endif
+
 // ROTATOR ---------------------------------------
 
 // AXIS3 ROTATOR
@@ -470,6 +842,14 @@
   #error "Configuration (Config.h): Setting AXIS3_DRIVER_STATUS unknown, use OFF or valid driver status."
 #endif
 
+#if defined(AXIS3_DRIVER_STALL) && AXIS3_DRIVER_STALL != OFF && AXIS3_DRIVER_STATUS != ON
+  #error "Configuration (Config.h): Setting AXIS3_DRIVER_STALL requires AXIS3_DRIVER_STATUS ON."
+#endif
+
+#if (AXIS3_SENSE_HOME) == STALL && (!defined(AXIS3_DRIVER_STALL) || AXIS3_DRIVER_STALL == OFF)
+  #error "Configuration (Config.h): Setting AXIS3_SENSE_HOME STALL requires a TMC driver with AXIS3_DRIVER_STALL set."
+#endif
+
 #ifdef AXIS3_STEP_DIR_PRESENT
   #if AXIS3_DRIVER_MICROSTEPS != OFF && (AXIS3_DRIVER_MICROSTEPS < 1 || AXIS3_DRIVER_MICROSTEPS > 256)
     #error "Configuration (Config.h): Setting AXIS3_DRIVER_MICROSTEPS unknown, use OFF or a valid microstep setting (range 1 to 256x and supported by your driver/design.)"
@@ -505,6 +885,18 @@
   #if AXIS3_DRIVER_IGOTO != OFF && (AXIS3_DRIVER_IGOTO < 0 || AXIS3_DRIVER_IGOTO > 3000)
     #error "Configuration (Config.h): Setting AXIS3_DRIVER_IGOTO unknown, use OFF or a value 0 to 3000 (mA.)"
   #endif
+  #if AXIS3_DRIVER_IFAST != OFF && (AXIS3_DRIVER_IFAST < 0 || AXIS3_DRIVER_IFAST > 3000)
+    #error "Configuration (Config.h): Setting AXIS3_DRIVER_IFAST unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS3_DRIVER_ITRACK != OFF && (AXIS3_DRIVER_ITRACK < 0 || AXIS3_DRIVER_ITRACK > 3000)
+    #error "Configuration (Config.h): Setting AXIS3_DRIVER_ITRACK unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS3_DRIVER_DECAY_FAST != OFF && (AXIS3_DRIVER_DECAY_FAST < DRIVER_DECAY_MODE_FIRST || AXIS3_DRIVER_DECAY_FAST > DRIVER_DECAY_MODE_LAST)
+    #error "Configuration (Config.h): Setting AXIS3_DRIVER_DECAY_FAST unknown, use a valid DRIVER DECAY MODE (from Constants.h)"
+  #endif
+  #if AXIS3_DRIVER_FAST_RATE != OFF && AXIS3_DRIVER_FAST_RATE <= 0
+    #error "Configuration (Config.h): Setting AXIS3_DRIVER_FAST_RATE unknown, use OFF or a rate > 0 (steps/s.)"
+  #endif
   #if (AXIS3_DRIVER_IRUN > 1000 || AXIS3_DRIVER_IHOLD > 1000 || AXIS3_DRIVER_IGOTO > 1000)
     #warning "Configuration (Config.h): Setting AXIS3_DRIVER_IHOLD or _IRUN or _IGOTO > 1000 (mA) this Axis on many boards is not designed to operate at high current"
   #endif
@@ -514,6 +906,15 @@
   #if AXIS3_ENCODER != OFF && (AXIS3_ENCODER < ENC_FIRST || AXIS3_ENCODER > ENC_LAST)
     #error "Configuration (Config.h): Setting AXIS3_ENCODER unknown, use a valid SERVO ENCODER (from Constants.h)"
   #endif
+  #if AXIS3_SERVO_CURRENT_LIMIT != OFF && AXIS3_SERVO_CURRENT_LIMIT <= 0
+    #error "Configuration (Config.h): Setting AXIS3_SERVO_CURRENT_LIMIT unknown, use OFF or a value > 0 (mA.)"
+  #endif
+  #if AXIS3_SERVO_CURRENT_LIMIT != OFF && AXIS3_SERVO_CURRENT_PIN == OFF
+    #error "Configuration (Config.h): Setting AXIS3_SERVO_CURRENT_LIMIT requires an AXIS3_SERVO_CURRENT_PIN"
+  #endif
+  #if AXIS3_SERVO_CURRENT_SCALE <= 0
+    #error "Configuration (Config.h): Setting AXIS3_SERVO_CURRENT_SCALE unknown, use a value > 0 (mA.)"
+  #endif
 #endif
 
 #if AXIS3_REVERSE != ON && AXIS3_REVERSE != OFF
@@ -532,8 +933,8 @@
   #error "Configuration (Config.h): Setting AXIS3_LIMIT_MAX unknown, use value in the range 0 to 360."
 #endif
 
-#if (AXIS3_SENSE_HOME) != OFF && (AXIS3_SENSE_HOME) < 0
-  #error "Configuration (Config.h): Setting AXIS3_SENSE_HOME unknown, use OFF or HIGH/LOW and HYST() and/or THLD() as described in comments."
+#if (AXIS3_SENSE_HOME) != OFF && (AXIS3_SENSE_HOME) != STALL && (AXIS3_SENSE_HOME) < 0
+  #error "Configuration (Config.h): Setting AXIS3_SENSE_HOME unknown, use OFF, STALL, or HIGH/LOW and HYST() and/or THLD() as described in comments."
 #endif
 
 #if (AXIS3_SENSE_LIMIT_MIN) != OFF && (AXIS3_SENSE_LIMIT_MIN) < 0
@@ -565,6 +966,14 @@
   #error "Configuration (Config.h): Setting AXIS4_DRIVER_STATUS unknown, use OFF or valid driver status."
 #endif
 
+#if defined(AXIS4_DRIVER_STALL) && AXIS4_DRIVER_STALL != OFF && AXIS4_DRIVER_STATUS != ON
+  #error "Configuration (Config.h): Setting AXIS4_DRIVER_STALL requires AXIS4_DRIVER_STATUS ON."
+#endif
+
+#if (AXIS4_SENSE_HOME) == STALL && (!defined(AXIS4_DRIVER_STALL) || AXIS4_DRIVER_STALL == OFF)
+  #error "Configuration (Config.h): Setting AXIS4_SENSE_HOME STALL requires a TMC driver with AXIS4_DRIVER_STALL set."
+#endif
+
 #if AXIS4_REVERSE != ON && AXIS4_REVERSE != OFF
   #error "Configuration (Config.h): Setting AXIS4_REVERSE unknown, use OFF or ON."
 #endif
@@ -581,8 +990,8 @@
   #error "Configuration (Config.h): Setting AXIS4_LIMIT_MAX unknown, use value in the range AXIS4_LIMIT_MIN to 500 (mm.)"
 #endif
 
-#if (AXIS4_SENSE_HOME) != OFF && (AXIS4_SENSE_HOME) < 0
-  #error "Configuration (Config.h): Setting AXIS4_SENSE_HOME unknown, use OFF or HIGH/LOW and HYST() and/or THLD() as described in comments."
+#if (AXIS4_SENSE_HOME) != OFF && (AXIS4_SENSE_HOME) != STALL && (AXIS4_SENSE_HOME) < 0
+  #error "Configuration (Config.h): Setting AXIS4_SENSE_HOME unknown, use OFF, STALL, or HIGH/LOW and HYST() and/or THLD() as described in comments."
 #endif
 
 #if AXIS4_SENSE_LIMIT_MIN != OFF && AXIS4_SENSE_LIMIT_MIN < 0
@@ -628,6 +1037,18 @@
   #if AXIS4_DRIVER_IGOTO != OFF && (AXIS4_DRIVER_IGOTO < 0 || AXIS4_DRIVER_IGOTO > 3000)
     #error "Configuration (Config.h): Setting AXIS4_DRIVER_IGOTO unknown, use OFF or a value 0 to 3000 (mA.)"
   #endif
+  #if AXIS4_DRIVER_IFAST != OFF && (AXIS4_DRIVER_IFAST < 0 || AXIS4_DRIVER_IFAST > 3000)
+    #error "Configuration (Config.h): Setting AXIS4_DRIVER_IFAST unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS4_DRIVER_ITRACK != OFF && (AXIS4_DRIVER_ITRACK < 0 || AXIS4_DRIVER_ITRACK > 3000)
+    #error "Configuration (Config.h): Setting AXIS4_DRIVER_ITRACK unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS4_DRIVER_DECAY_FAST != OFF && (AXIS4_DRIVER_DECAY_FAST < DRIVER_DECAY_MODE_FIRST || AXIS4_DRIVER_DECAY_FAST > DRIVER_DECAY_MODE_LAST)
+    #error "Configuration (Config.h): Setting AXIS4_DRIVER_DECAY_FAST unknown, use a valid DRIVER DECAY MODE (from Constants.h)"
+  #endif
+  #if AXIS4_DRIVER_FAST_RATE != OFF && AXIS4_DRIVER_FAST_RATE <= 0
+    #error "Configuration (Config.h): Setting AXIS4_DRIVER_FAST_RATE unknown, use OFF or a rate > 0 (steps/s.)"
+  #endif
   #if (AXIS4_DRIVER_IRUN > 1000 || AXIS4_DRIVER_IHOLD > 1000 || AXIS4_DRIVER_IGOTO > 1000)
     #warning "Configuration (Config.h): Setting AXIS4_DRIVER_IHOLD or _IRUN or _IGOTO > 1000 (mA) this Axis on many boards is not designed to operate at high current"
   #endif
@@ -637,6 +1058,15 @@
   #if AXIS4_ENCODER < ENC_FIRST || AXIS4_ENCODER > ENC_LAST
     #error "Configuration (Config.h): Setting AXIS4_ENCODER unknown, use a valid SERVO ENCODER (from Constants.h)"
   #endif
+  #if AXIS4_SERVO_CURRENT_LIMIT != OFF && AXIS4_SERVO_CURRENT_LIMIT <= 0
+    #error "Configuration (Config.h): Setting AXIS4_SERVO_CURRENT_LIMIT unknown, use OFF or a value > 0 (mA.)"
+  #endif
+  #if AXIS4_SERVO_CURRENT_LIMIT != OFF && AXIS4_SERVO_CURRENT_PIN == OFF
+    #error "Configuration (Config.h): Setting AXIS4_SERVO_CURRENT_LIMIT requires an AXIS4_SERVO_CURRENT_PIN"
+  #endif
+  #if AXIS4_SERVO_CURRENT_SCALE <= 0
+    #error "Configuration (Config.h): Setting AXIS4_SERVO_CURRENT_SCALE unknown, use a value > 0 (mA.)"
+  #endif
 #endif
 
 // AXIS5 FOCUSER
@@ -658,6 +1088,14 @@
   #error "Configuration (Config.h): Setting AXIS5_DRIVER_STATUS unknown, use OFF or valid driver status."
 #endif
 
+#if defined(AXIS5_DRIVER_STALL) && AXIS5_DRIVER_STALL != OFF && AXIS5_DRIVER_STATUS != ON
+  #error "Configuration (Config.h): Setting AXIS5_DRIVER_STALL requires AXIS5_DRIVER_STATUS ON."
+#endif
+
+#if (AXIS5_SENSE_HOME) == STALL && (!defined(AXIS5_DRIVER_STALL) || AXIS5_DRIVER_STALL == OFF)
+  #error "Configuration (Config.h): Setting AXIS5_SENSE_HOME STALL requires a TMC driver with AXIS5_DRIVER_STALL set."
+#endif
+
 #if AXIS5_REVERSE != ON && AXIS5_REVERSE != OFF
   #error "Configuration (Config.h): Setting AXIS5_REVERSE unknown, use OFF or ON."
 #endif
@@ -674,8 +1112,8 @@
   #error "Configuration (Config.h): Setting AXIS5_LIMIT_MAX unknown, use value in the range AXIS5_LIMIT_MIN to 500 (mm.)"
 #endif
 
-#if (AXIS5_SENSE_HOME) != OFF && (AXIS5_SENSE_HOME) < 0
-  #error "Configuration (Config.h): Setting AXIS5_SENSE_HOME unknown, use OFF or HIGH/LOW and HYST() and/or THLD() as described in comments."
+#if (AXIS5_SENSE_HOME) != OFF && (AXIS5_SENSE_HOME) != STALL && (AXIS5_SENSE_HOME) < 0
+  #error "Configuration (Config.h): Setting AXIS5_SENSE_HOME unknown, use OFF, STALL, or HIGH/LOW and HYST() and/or THLD() as described in comments."
 #endif
 
 #if (AXIS5_SENSE_LIMIT_MIN) != OFF && (AXIS5_SENSE_LIMIT_MIN) < 0
@@ -721,6 +1159,18 @@
   #if AXIS5_DRIVER_IGOTO != OFF && (AXIS5_DRIVER_IGOTO < 0 || AXIS5_DRIVER_IGOTO > 3000)
     #error "Configuration (Config.h): Setting AXIS5_DRIVER_IGOTO unknown, use OFF or a value 0 to 3000 (mA.)"
   #endif
+  #if AXIS5_DRIVER_IFAST != OFF && (AXIS5_DRIVER_IFAST < 0 || AXIS5_DRIVER_IFAST > 3000)
+    #error "Configuration (Config.h): Setting AXIS5_DRIVER_IFAST unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS5_DRIVER_ITRACK != OFF && (AXIS5_DRIVER_ITRACK < 0 || AXIS5_DRIVER_ITRACK > 3000)
+    #error "Configuration (Config.h): Setting AXIS5_DRIVER_ITRACK unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS5_DRIVER_DECAY_FAST != OFF && (AXIS5_DRIVER_DECAY_FAST < DRIVER_DECAY_MODE_FIRST || AXIS5_DRIVER_DECAY_FAST > DRIVER_DECAY_MODE_LAST)
+    #error "Configuration (Config.h): Setting AXIS5_DRIVER_DECAY_FAST unknown, use a valid DRIVER DECAY MODE (from Constants.h)"
+  #endif
+  #if AXIS5_DRIVER_FAST_RATE != OFF && AXIS5_DRIVER_FAST_RATE <= 0
+    #error "Configuration (Config.h): Setting AXIS5_DRIVER_FAST_RATE unknown, use OFF or a rate > 0 (steps/s.)"
+  #endif
   #if (AXIS5_DRIVER_IRUN > 1000 || AXIS5_DRIVER_IHOLD > 1000 || AXIS5_DRIVER_IGOTO > 1000)
     #warning "Configuration (Config.h): Setting AXIS5_DRIVER_IHOLD or _IRUN or _IGOTO > 1000 (mA) this Axis on many boards is not designed to operate at high current"
   #endif
@@ -730,6 +1180,15 @@
   #if AXIS5_ENCODER < ENC_FIRST || AXIS5_ENCODER > ENC_LAST
     #error "Configuration (Config.h): Setting AXIS5_ENCODER unknown, use a valid SERVO ENCODER (from Constants.h)"
   #endif
+  #if AXIS5_SERVO_CURRENT_LIMIT != OFF && AXIS5_SERVO_CURRENT_LIMIT <= 0
+    #error "Configuration (Config.h): Setting AXIS5_SERVO_CURRENT_LIMIT unknown, use OFF or a value > 0 (mA.)"
+  #endif
+  #if AXIS5_SERVO_CURRENT_LIMIT != OFF && AXIS5_SERVO_CURRENT_PIN == OFF
+    #error "Configuration (Config.h): Setting AXIS5_SERVO_CURRENT_LIMIT requires an AXIS5_SERVO_CURRENT_PIN"
+  #endif
+  #if AXIS5_SERVO_CURRENT_SCALE <= 0
+    #error "Configuration (Config.h): Setting AXIS5_SERVO_CURRENT_SCALE unknown, use a value > 0 (mA.)"
+  #endif
 #endif
 
 // AXIS6 FOCUSER
@@ -751,6 +1210,14 @@
   #error "Configuration (Config.h): Setting AXIS6_DRIVER_STATUS unknown, use OFF or valid driver status."
 #endif
 
+#if defined(AXIS6_DRIVER_STALL) && AXIS6_DRIVER_STALL != OFF && AXIS6_DRIVER_STATUS != ON
+  #error "Configuration (Config.h): Setting AXIS6_DRIVER_STALL requires AXIS6_DRIVER_STATUS ON."
+#endif
+
+#if (AXIS6_SENSE_HOME) == STALL && (!defined(AXIS6_DRIVER_STALL) || AXIS6_DRIVER_STALL == OFF)
+  #error "Configuration (Config.h): Setting AXIS6_SENSE_HOME STALL requires a TMC driver with AXIS6_DRIVER_STALL set."
+#endif
+
 #if AXIS6_REVERSE != ON && AXIS6_REVERSE != OFF
   #error "Configuration (Config.h): Setting AXIS6_REVERSE unknown, use OFF or ON."
 #endif
@@ -767,8 +1234,8 @@
   #error "Configuration (Config.h): Setting AXIS6_LIMIT_MAX unknown, use value in the range AXIS6_LIMIT_MIN to 500 (mm.)"
 #endif
 
-#if (AXIS6_SENSE_HOME) != OFF && (AXIS6_SENSE_HOME) < 0
-  #error "Configuration (Config.h): Setting AXIS6_SENSE_HOME unknown, use OFF or HIGH/LOW and HYST() and/or THLD() as described in comments."
+#if (AXIS6_SENSE_HOME) != OFF && (AXIS6_SENSE_HOME) != STALL && (AXIS6_SENSE_HOME) < 0
+  #error "Configuration (Config.h): Setting AXIS6_SENSE_HOME unknown, use OFF, STALL, or HIGH/LOW and HYST() and/or THLD() as described in comments."
 #endif
 
 #if (AXIS6_SENSE_LIMIT_MIN) != OFF && (AXIS6_SENSE_LIMIT_MIN) < 0
@@ -814,12 +1281,33 @@
   #if AXIS6_DRIVER_IGOTO != OFF && (AXIS6_DRIVER_IGOTO < 0 || AXIS6_DRIVER_IGOTO > 3000)
     #error "Configuration (Config.h): Setting AXIS6_DRIVER_IGOTO unknown, use OFF or a value 0 to 3000 (mA.)"
   #endif
+  #if AXIS6_DRIVER_IFAST != OFF && (AXIS6_DRIVER_IFAST < 0 || AXIS6_DRIVER_IFAST > 3000)
+    #error "Configuration (Config.h): Setting AXIS6_DRIVER_IFAST unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS6_DRIVER_ITRACK != OFF && (AXIS6_DRIVER_ITRACK < 0 || AXIS6_DRIVER_ITRACK > 3000)
+    #error "Configuration (Config.h): Setting AXIS6_DRIVER_ITRACK unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS6_DRIVER_DECAY_FAST != OFF && (AXIS6_DRIVER_DECAY_FAST < DRIVER_DECAY_MODE_FIRST || AXIS6_DRIVER_DECAY_FAST > DRIVER_DECAY_MODE_LAST)
+    #error "Configuration (Config.h): Setting AXIS6_DRIVER_DECAY_FAST unknown, use a valid DRIVER DECAY MODE (from Constants.h)"
+  #endif
+  #if AXIS6_DRIVER_FAST_RATE != OFF && AXIS6_DRIVER_FAST_RATE <= 0
+    #error "Configuration (Config.h): Setting AXIS6_DRIVER_FAST_RATE unknown, use OFF or a rate > 0 (steps/s.)"
+  #endif
 #endif
 
 #ifdef AXIS6_SERVO_PRESENT
   #if AXIS6_ENCODER < ENC_FIRST || AXIS6_ENCODER > ENC_LAST
     #error "Configuration (Config.h): Setting AXIS6_ENCODER unknown, use a valid SERVO ENCODER (from Constants.h)"
   #endif
+  #if AXIS6_SERVO_CURRENT_LIMIT != OFF && AXIS6_SERVO_CURRENT_LIMIT <= 0
+    #error "Configuration (Config.h): Setting AXIS6_SERVO_CURRENT_LIMIT unknown, use OFF or a value > 0 (mA.)"
+  #endif
+  #if AXIS6_SERVO_CURRENT_LIMIT != OFF && AXIS6_SERVO_CURRENT_PIN == OFF
+    #error "Configuration (Config.h): Setting AXIS6_SERVO_CURRENT_LIMIT requires an AXIS6_SERVO_CURRENT_PIN"
+  #endif
+  #if AXIS6_SERVO_CURRENT_SCALE <= 0
+    #error "Configuration (Config.h): Setting AXIS6_SERVO_CURRENT_SCALE unknown, use a value > 0 (mA.)"
+  #endif
 #endif
 
 // AXIS7 FOCUSER
@@ -841,6 +1329,14 @@
   #error "Configuration (Config.h): Setting AXIS7_DRIVER_STATUS unknown, use OFF or valid driver status."
 #endif
 
+#if defined(AXIS7_DRIVER_STALL) && AXIS7_DRIVER_STALL != OFF && AXIS7_DRIVER_STATUS != ON
+  #error "Configuration (Config.h): Setting AXIS7_DRIVER_STALL requires AXIS7_DRIVER_STATUS ON."
+#endif
+
+#if (AXIS7_SENSE_HOME) == STALL && (!defined(AXIS7_DRIVER_STALL) || AXIS7_DRIVER_STALL == OFF)
+  #error "Configuration (Config.h): Setting AXIS7_SENSE_HOME STALL requires a TMC driver with AXIS7_DRIVER_STALL set."
+#endif
+
 #if AXIS7_REVERSE != ON && AXIS7_REVERSE != OFF
   #error "Configuration (Config.h): Setting AXIS7_REVERSE unknown, use OFF or ON."
 #endif
@@ -857,8 +1353,8 @@
   #error "Configuration (Config.h): Setting AXIS7_LIMIT_MAX unknown, use value in the range AXIS7_LIMIT_MIN to 500 (mm.)"
 #endif
 
-#if (AXIS7_SENSE_HOME) != OFF && (AXIS7_SENSE_HOME) < 0
-  #error "Configuration (Config.h): Setting AXIS7_SENSE_HOME unknown, use OFF or HIGH/LOW and HYST() and/or THLD() as described in comments."
+#if (AXIS7_SENSE_HOME) != OFF && (AXIS7_SENSE_HOME) != STALL && (AXIS7_SENSE_HOME) < 0
+  #error "Configuration (Config.h): Setting AXIS7_SENSE_HOME unknown, use OFF, STALL, or HIGH/LOW and HYST() and/or THLD() as described in comments."
 #endif
 
 #if (AXIS7_SENSE_LIMIT_MIN) != OFF && (AXIS7_SENSE_LIMIT_MIN) < 0
@@ -904,12 +1400,33 @@
   #if AXIS7_DRIVER_IGOTO != OFF && (AXIS7_DRIVER_IGOTO < 0 || AXIS7_DRIVER_IGOTO > 3000)
     #error "Configuration (Config.h): Setting AXIS7_DRIVER_IGOTO unknown, use OFF or a value 0 to 3000 (mA.)"
   #endif
+  #if AXIS7_DRIVER_IFAST != OFF && (AXIS7_DRIVER_IFAST < 0 || AXIS7_DRIVER_IFAST > 3000)
+    #error "Configuration (Config.h): Setting AXIS7_DRIVER_IFAST unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS7_DRIVER_ITRACK != OFF && (AXIS7_DRIVER_ITRACK < 0 || AXIS7_DRIVER_ITRACK > 3000)
+    #error "Configuration (Config.h): Setting AXIS7_DRIVER_ITRACK unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS7_DRIVER_DECAY_FAST != OFF && (AXIS7_DRIVER_DECAY_FAST < DRIVER_DECAY_MODE_FIRST || AXIS7_DRIVER_DECAY_FAST > DRIVER_DECAY_MODE_LAST)
+    #error "Configuration (Config.h): Setting AXIS7_DRIVER_DECAY_FAST unknown, use a valid DRIVER DECAY MODE (from Constants.h)"
+  #endif
+  #if AXIS7_DRIVER_FAST_RATE != OFF && AXIS7_DRIVER_FAST_RATE <= 0
+    #error "Configuration (Config.h): Setting AXIS7_DRIVER_FAST_RATE unknown, use OFF or a rate > 0 (steps/s.)"
+  #endif
 #endif
 
 #ifdef AXIS7_SERVO_PRESENT
   #if AXIS7_ENCODER < ENC_FIRST || AXIS7_ENCODER > ENC_LAST
     #error "Configuration (Config.h): Setting AXIS7_ENCODER unknown, use a valid SERVO ENCODER (from Constants.h)"
   #endif
+  #if AXIS7_SERVO_CURRENT_LIMIT != OFF && AXIS7_SERVO_CURRENT_LIMIT <= 0
+    #error "Configuration (Config.h): Setting AXIS7_SERVO_CURRENT_LIMIT unknown, use OFF or a value > 0 (mA.)"
+  #endif
+  #if AXIS7_SERVO_CURRENT_LIMIT != OFF && AXIS7_SERVO_CURRENT_PIN == OFF
+    #error "Configuration (Config.h): Setting AXIS7_SERVO_CURRENT_LIMIT requires an AXIS7_SERVO_CURRENT_PIN"
+  #endif
+  #if AXIS7_SERVO_CURRENT_SCALE <= 0
+    #error "Configuration (Config.h): Setting AXIS7_SERVO_CURRENT_SCALE unknown, use a value > 0 (mA.)"
+  #endif
 #endif
 
 // AXIS8 FOCUSER
@@ -931,6 +1448,14 @@
   #error "Configuration (Config.h): Setting AXIS8_DRIVER_STATUS unknown, use OFF or valid driver status."
 #endif
 
+#if defined(AXIS8_DRIVER_STALL) && AXIS8_DRIVER_STALL != OFF && AXIS8_DRIVER_STATUS != ON
+  #error "Configuration (Config.h): Setting AXIS8_DRIVER_STALL requires AXIS8_DRIVER_STATUS ON."
+#endif
+
+#if (AXIS8_SENSE_HOME) == STALL && (!defined(AXIS8_DRIVER_STALL) || AXIS8_DRIVER_STALL == OFF)
+  #error "Configuration (Config.h): Setting AXIS8_SENSE_HOME STALL requires a TMC driver with AXIS8_DRIVER_STALL set."
+#endif
+
 #if AXIS8_REVERSE != ON && AXIS8_REVERSE != OFF
   #error "Configuration (Config.h): Setting AXIS8_REVERSE unknown, use OFF or ON."
 #endif
@@ -947,8 +1472,8 @@
   #error "Configuration (Config.h): Setting AXIS8_LIMIT_MAX unknown, use value in the range AXIS8_LIMIT_MIN to 500 (mm.)"
 #endif
 
-#if (AXIS8_SENSE_HOME) != OFF && (AXIS8_SENSE_HOME) < 0
-  #error "Configuration (Config.h): Setting AXIS8_SENSE_HOME unknown, use OFF or HIGH/LOW and HYST() and/or THLD() as described in comments."
+#if (AXIS8_SENSE_HOME) != OFF && (AXIS8_SENSE_HOME) != STALL && (AXIS8_SENSE_HOME) < 0
+  #error "Configuration (Config.h): Setting AXIS8_SENSE_HOME unknown, use OFF, STALL, or HIGH/LOW and HYST() and/or THLD() as described in comments."
 #endif
 
 #if (AXIS8_SENSE_LIMIT_MIN) != OFF && (AXIS8_SENSE_LIMIT_MIN) < 0
@@ -994,12 +1519,33 @@
   #if AXIS8_DRIVER_IGOTO != OFF && (AXIS8_DRIVER_IGOTO < 0 || AXIS8_DRIVER_IGOTO > 3000)
     #error "Configuration (Config.h): Setting AXIS8_DRIVER_IGOTO unknown, use OFF or a value 0 to 3000 (mA.)"
   #endif
+  #if AXIS8_DRIVER_IFAST != OFF && (AXIS8_DRIVER_IFAST < 0 || AXIS8_DRIVER_IFAST > 3000)
+    #error "Configuration (Config.h): Setting AXIS8_DRIVER_IFAST unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS8_DRIVER_ITRACK != OFF && (AXIS8_DRIVER_ITRACK < 0 || AXIS8_DRIVER_ITRACK > 3000)
+    #error "Configuration (Config.h): Setting AXIS8_DRIVER_ITRACK unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS8_DRIVER_DECAY_FAST != OFF && (AXIS8_DRIVER_DECAY_FAST < DRIVER_DECAY_MODE_FIRST || AXIS8_DRIVER_DECAY_FAST > DRIVER_DECAY_MODE_LAST)
+    #error "Configuration (Config.h): Setting AXIS8_DRIVER_DECAY_FAST unknown, use a valid DRIVER DECAY MODE (from Constants.h)"
+  #endif
+  #if AXIS8_DRIVER_FAST_RATE != OFF && AXIS8_DRIVER_FAST_RATE <= 0
+    #error "Configuration (Config.h): Setting AXIS8_DRIVER_FAST_RATE unknown, use OFF or a rate > 0 (steps/s.)"
+  #endif
 #endif
 
 #ifdef AXIS8_SERVO_PRESENT
   #if AXIS8_ENCODER < ENC_FIRST || AXIS8_ENCODER > ENC_LAST
     #error "Configuration (Config.h): Setting AXIS8_ENCODER unknown, use a valid SERVO ENCODER (from Constants.h)"
   #endif
+  #if AXIS8_SERVO_CURRENT_LIMIT != OFF && AXIS8_SERVO_CURRENT_LIMIT <= 0
+    #error "Configuration (Config.h): Setting AXIS8_SERVO_CURRENT_LIMIT unknown, use OFF or a value > 0 (mA.)"
+  #endif
+  #if AXIS8_SERVO_CURRENT_LIMIT != OFF && AXIS8_SERVO_CURRENT_PIN == OFF
+    #error "Configuration (Config.h): Setting AXIS8_SERVO_CURRENT_LIMIT requires an AXIS8_SERVO_CURRENT_PIN"
+  #endif
+  #if AXIS8_SERVO_CURRENT_SCALE <= 0
+    #error "Configuration (Config.h): Setting AXIS8_SERVO_CURRENT_SCALE unknown, use a value > 0 (mA.)"
+  #endif
 #endif
 
 // AXIS9 FOCUSER
@@ -1021,6 +1567,14 @@
   #error "Configuration (Config.h): Setting AXIS9_DRIVER_STATUS unknown, use OFF or valid driver status."
 #endif
 
+#if defined(AXIS9_DRIVER_STALL) && AXIS9_DRIVER_STALL != OFF && AXIS9_DRIVER_STATUS != ON
+  #error "Configuration (Config.h): Setting AXIS9_DRIVER_STALL requires AXIS9_DRIVER_STATUS ON."
+#endif
+
+#if (AXIS9_SENSE_HOME) == STALL && (!defined(AXIS9_DRIVER_STALL) || AXIS9_DRIVER_STALL == OFF)
+  #error "Configuration (Config.h): Setting AXIS9_SENSE_HOME STALL requires a TMC driver with AXIS9_DRIVER_STALL set."
+#endif
+
 #if AXIS9_REVERSE != ON && AXIS9_REVERSE != OFF
   #error "Configuration (Config.h): Setting AXIS9_REVERSE unknown, use OFF or ON."
 #endif
@@ -1037,8 +1591,8 @@
   #error "Configuration (Config.h): Setting AXIS9_LIMIT_MAX unknown, use value in the range AXIS9_LIMIT_MIN to 500 (mm.)"
 #endif
 
-#if (AXIS9_SENSE_HOME) != OFF && (AXIS9_SENSE_HOME) < 0
-  #error "Configuration (Config.h): Setting AXIS9_SENSE_HOME unknown, use OFF or HIGH/LOW and HYST() and/or THLD() as described in comments."
+#if (AXIS9_SENSE_HOME) != OFF && (AXIS9_SENSE_HOME) != STALL && (AXIS9_SENSE_HOME) < 0
+  #error "Configuration (Config.h): Setting AXIS9_SENSE_HOME unknown, use OFF, STALL, or HIGH/LOW and HYST() and/or THLD() as described in comments."
 #endif
 
 #if (AXIS9_SENSE_LIMIT_MIN) != OFF && (AXIS9_SENSE_LIMIT_MIN) < 0
@@ -1084,12 +1638,33 @@
   #if AXIS9_DRIVER_IGOTO != OFF && (AXIS9_DRIVER_IGOTO < 0 || AXIS9_DRIVER_IGOTO > 3000)
     #error "Configuration (Config.h): Setting AXIS9_DRIVER_IGOTO unknown, use OFF or a value 0 to 3000 (mA.)"
   #endif
+  #if AXIS9_DRIVER_IFAST != OFF && (AXIS9_DRIVER_IFAST < 0 || AXIS9_DRIVER_IFAST > 3000)
+    #error "Configuration (Config.h): Setting AXIS9_DRIVER_IFAST unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS9_DRIVER_ITRACK != OFF && (AXIS9_DRIVER_ITRACK < 0 || AXIS9_DRIVER_ITRACK > 3000)
+    #error "Configuration (Config.h): Setting AXIS9_DRIVER_ITRACK unknown, use OFF or a value 0 to 3000 (mA.)"
+  #endif
+  #if AXIS9_DRIVER_DECAY_FAST != OFF && (AXIS9_DRIVER_DECAY_FAST < DRIVER_DECAY_MODE_FIRST || AXIS9_DRIVER_DECAY_FAST > DRIVER_DECAY_MODE_LAST)
+    #error "Configuration (Config.h): Setting AXIS9_DRIVER_DECAY_FAST unknown, use a valid DRIVER DECAY MODE (from Constants.h)"
+  #endif
+  #if AXIS9_DRIVER_FAST_RATE != OFF && AXIS9_DRIVER_FAST_RATE <= 0
+    #error "Configuration (Config.h): Setting AXIS9_DRIVER_FAST_RATE unknown, use OFF or a rate > 0 (steps/s.)"
+  #endif
 #endif
 
 #ifdef AXIS9_SERVO_PRESENT
   #if AXIS9_ENCODER < ENC_FIRST || AXIS9_ENCODER > ENC_LAST
     #error "Configuration (Config.h): Setting AXIS9_ENCODER unknown, use a valid SERVO ENCODER (from Constants.h)"
   #endif
+  #if AXIS9_SERVO_CURRENT_LIMIT != OFF && AXIS9_SERVO_CURRENT_LIMIT <= 0
+    #error "Configuration (Config.h): Setting AXIS9_SERVO_CURRENT_LIMIT unknown, use OFF or a value > 0 (mA.)"
+  #endif
+  #if AXIS9_SERVO_CURRENT_LIMIT != OFF && AXIS9_SERVO_CURRENT_PIN == OFF
+    #error "Configuration (Config.h): Setting AXIS9_SERVO_CURRENT_LIMIT requires an AXIS9_SERVO_CURRENT_PIN"
+  #endif
+  #if AXIS9_SERVO_CURRENT_SCALE <= 0
+    #error "Configuration (Config.h): Setting AXIS9_SERVO_CURRENT_SCALE unknown, use a value > 0 (mA.)"
+  #endif
 #endif
 
 // GENERAL TEMPERATURE ---------------------------
@@ -1105,6 +1680,14 @@
   #error "Configuration (Config.h): Setting FOCUSER_TEMPERATURE unknown, use OFF or TEMPERATURE device (from Constants.h)"
 #endif
 
+#if FOCUSER_TCF_TABLE != OFF && FOCUSER_TCF_TABLE != ON
+  #error "Configuration (Config.h): Setting FOCUSER_TCF_TABLE unknown, use OFF or ON."
+#endif
+
+#if FOCUSER_SWEEP != OFF && FOCUSER_SWEEP != ON
+  #error "Configuration (Config.h): Setting FOCUSER_SWEEP unknown, use OFF or ON."
+#endif
+
 // AUXILIARY FEATURE -----------------------------
 
 #if FEATURE1_PURPOSE != OFF && (FEATURE1_PURPOSE < AUX_FEATURE_PURPOSE_FIRST || FEATURE1_PURPOSE > AUX_FEATURE_PURPOSE_LAST)
@@ -25,6 +25,8 @@
 #define PERSISTENT                  -20
 #define ERRORS_ONLY                 -21
 #define KALMAN                      -22
+#define ALPHA_BETA                  -23
+#define STALL                       -24    // sense by driver StallGuard, no switch
 #define INVALID                     -127
 
 // driver (step/dir interface, usually for stepper motors)
@@ -75,6 +77,11 @@
 #define ODRIVE                      200    // First generation ODrive (axis 1 and 2 only)
 #define ODRIVE_DRIVER_LAST          200
 
+// motion controller driver (the driver's own ramp generator moves the motor)
+#define TMC_RAMP_DRIVER_FIRST       300
+#define TMC5160_RAMP                300    // TMC5160 SPI in positioning mode, SD_MODE tied low (axis 1 and 2 only)
+#define TMC_RAMP_DRIVER_LAST        300
+
 // servo encoder (must match Encoder library)
 #define ENC_FIRST                   1
 #define AB                          1      // AB quadrature encoder
@@ -85,7 +92,9 @@
 #define AS37_H39B_B                 6      // Broadcom AS37-H39B-B BISS-C interface encoder
 #define JTW_24BIT                   7      // JTW Trident BISS-C interface 24bit encoder
 #define SERIAL_BRIDGE               8      // serial bridge to encoders
-#define ENC_LAST                    8
+#define AB_STM32                    9      // AB quadrature encoder (using STM32 hardware timer encoder mode)
+#define AB_TEENSY4                  10     // AB quadrature encoder (using Teensy 4 hardware quadrature decoder)
+#define ENC_LAST                    10
 
 // servo feedback (must match Encoder library)
 #define SERVO_FEEDBACK_FIRST        1
@@ -96,6 +105,11 @@
 #define ODRIVER                     -10    // general purpose flag for a ODRIVE driver motor
 #define SERVO                       -11    // general purpose flag for a SERVO driver motor
 #define STEP_DIR                    -12    // general purpose flag for a STEP_DIR driver motor
+#define TMC_RAMP                    -13    // general purpose flag for a TMC_RAMP driver motor
+
+// odrive communication modes
+#define OD_UART                     1      // ASCII protocol over a serial port
+#define OD_CAN                      2      // CAN simple protocol
 
 // NV/EEPROM
 #define NV_KEY_VALUE                111111111UL
@@ -110,6 +124,7 @@
 #define NV_AT24C32                  6  // 4KB I2C EEPROM AT DEFAULT ADDRESS 0x57 (ZS-01 module for instance)
 #define NV_MB85RC64                 7  // 8KB I2C FRAM AT DEFAULT ADDRESS 0x50
 #define NV_MB85RC256                8  // 32KB I2C FRAM AT DEFAULT ADDRESS 0x50
+#define NV_JOURNAL                  9  // 4KB journal in a flash data partition, wear leveled (ESP32)
 
 #define NVE_LOW                     0   // low (< 100K writes)
 #define NVE_MID                     1   // mid (~ 100K writes)
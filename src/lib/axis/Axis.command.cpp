@@ -56,7 +56,7 @@ bool Axis::command(char *reply, char *command, char *parameter, bool *supressFra
     } else
 
     #ifdef SERVO_MOTOR_PRESENT
-      // :GXS[n]#   Get axis servo delta (in counts) and velocity
+      // :GXS[n]#   Get axis servo delta (in counts), velocity (in %), and encoder velocity (in counts/s)
       //            Returns: Values
       if (parameter[0] == 'S') {
         int index = parameter[1] - '1';
@@ -66,7 +66,60 @@ bool Axis::command(char *reply, char *command, char *parameter, bool *supressFra
 
         char temp[20];
         sprintF(temp, "%0.3f", ((ServoMotor*)motor)->velocityPercent);
-        sprintf(reply, "%ld,%s", ((ServoMotor*)motor)->delta, temp);
+        char temp1[20];
+        sprintF(temp1, "%0.1f", ((ServoMotor*)motor)->encoderVelocity);
+        sprintf(reply, "%ld,%s,%s", ((ServoMotor*)motor)->delta, temp, temp1);
+        *numericReply = false;
+      } else
+    #endif
+
+    #if defined(SERVO_MOTOR_PRESENT) && SERVO_TRACE != OFF
+      // :GXK[n]#   Get servo trace capture status for axis [n]
+      //            Returns: s,n where s is 0 idle, 1 armed, 2 triggered, 3 done and n is the sample count
+      if (parameter[0] == 'K') {
+        int index = parameter[1] - '1';
+        if (index > 8) { *commandError = CE_PARAM_RANGE; return true; }
+        if (index + 1 != axisNumber) return false; // command wasn't processed
+        if (motor->driverType != SERVO || ((ServoMotor*)motor)->trace == NULL) { *commandError = CE_CMD_UNKNOWN; return true; }
+
+        ServoTrace *trace = ((ServoMotor*)motor)->trace;
+        sprintf(reply, "%d,%u", (int)trace->state, (unsigned int)trace->getCount());
+        *numericReply = false;
+      } else
+    #endif
+
+    #ifdef SERVO_MOTOR_PRESENT
+      // :GXO[n]#   Get axis servo autotune status
+      //            Returns: s,Ku,Tu where s is 0 idle, 1 running, 2 done, 3 saved, 4 failed
+      if (parameter[0] == 'O') {
+        int index = parameter[1] - '1';
+        if (index > 8) { *commandError = CE_PARAM_RANGE; return true; }
+        if (index + 1 != axisNumber) return false; // command wasn't processed
+        if (motor->driverType != SERVO) { *commandError = CE_CMD_UNKNOWN; return true; } // not a servo
+
+        Autotune *autotune = &((ServoMotor*)motor)->autotune;
+        char ku[20]; sprintF(ku, "%0.5f", autotune->ultimateGain);
+        char tu[20]; sprintF(tu, "%0.4f", autotune->ultimatePeriod);
+        sprintf(reply, "%d,%s,%s", (int)autotune->state, ku, tu);
+        *numericReply = false;
+      } else
+    #endif
+
+    #if defined(STEP_DIR_MOTOR_PRESENT) && defined(STEP_DIR_BENCHMARK)
+      // :GXP[n]#   Get step ISR benchmark for axis [n], runs the ISRs at max rate without motion
+      //            Returns: move cycles,moveFF cycles,max cycles in operation,max latency cycles,steps/s#
+      if (parameter[0] == 'P') {
+        int index = parameter[1] - '1';
+        if (index > 8) { *commandError = CE_PARAM_RANGE; return true; }
+        if (index + 1 != axisNumber) return false; // command wasn't processed
+        if (motor->driverType != STEP_DIR) { *commandError = CE_CMD_UNKNOWN; return true; }
+        if (autoRate != AR_NONE) { *commandError = CE_SLEW_IN_MOTION; return true; }
+
+        uint32_t cyclesMove, cyclesFast, cyclesLive, latencyLive;
+        float stepRate;
+        ((StepDirMotor*)motor)->benchmark(&cyclesMove, &cyclesFast, &cyclesLive, &latencyLive, &stepRate);
+        sprintf(reply, "%lu,%lu,%lu,%lu,", (unsigned long)cyclesMove, (unsigned long)cyclesFast, (unsigned long)cyclesLive, (unsigned long)latencyLive);
+        sprintF(&reply[strlen(reply)], "%0.0f", stepRate);
         *numericReply = false;
       } else
     #endif
@@ -92,6 +145,65 @@ bool Axis::command(char *reply, char *command, char *parameter, bool *supressFra
     } else return false;
   } else
 
+  #ifdef SERVO_MOTOR_PRESENT
+    #if SERVO_TRACE != OFF
+      // :GXK[n],[iii]#  Get servo trace samples iii and iii+1 (0 is the oldest) for axis [n], the capture must be done
+      //            Returns: time(8),set(8),in(8),out(4),velocity(4) hex for each sample
+      if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'K' && parameter[2] == ',') {
+        int index = parameter[1] - '1';
+        if (index > 8) { *commandError = CE_PARAM_RANGE; return true; }
+        if (index + 1 != axisNumber) return false; // command wasn't processed
+        if (motor->driverType != SERVO || ((ServoMotor*)motor)->trace == NULL) { *commandError = CE_CMD_UNKNOWN; return true; }
+
+        char *conv_end;
+        long i = strtol(&parameter[3], &conv_end, 10);
+        if (&parameter[3] == conv_end || i < 0 || i > 65535) { *commandError = CE_PARAM_FORM; return true; }
+        if (!((ServoMotor*)motor)->trace->getSamples(i, reply)) { *commandError = CE_PARAM_RANGE; return true; }
+        *numericReply = false;
+      } else
+    #endif
+
+    // :SXS[n],T#  Start a relay feedback autotune of servo axis [n], the PID gains are saved to NV when done
+    // :SXS[n],X#  Stop the autotune of servo axis [n]
+    // :SXS[n],R[c]#  Arm the servo trace capture of axis [n] with trigger [c], N (now), G (slew/goto start), S (safety stop)
+    // :SXS[n],RE[nnn]#  Arm the servo trace capture of axis [n] to trigger at a position error above [nnn] counts
+    //            Return: 0 failure, 1 success
+    if (command[0] == 'S' && command[1] == 'X' && parameter[0] == 'S' && parameter[2] == ',') {
+      int index = parameter[1] - '1';
+      if (index > 8) { *commandError = CE_PARAM_RANGE; return true; }
+      if (index + 1 != axisNumber) return false; // command wasn't processed
+      if (motor->driverType != SERVO) { *commandError = CE_CMD_UNKNOWN; return true; }
+
+      if (parameter[3] == 'T' && parameter[4] == 0) {
+        if (motor->getParameterTypeCode() != 'P') { *commandError = CE_CMD_UNKNOWN; return true; }
+        // the gains are saved with the run time axis settings
+        uint16_t axesToRevert = nv.readUI(NV_AXIS_SETTINGS_REVERT);
+        if (!(axesToRevert & 1) || (axesToRevert & (1 << axisNumber))) { *commandError = CE_0; return true; }
+        if (autoRate != AR_NONE) { *commandError = CE_SLEW_IN_MOTION; return true; }
+        if (!((ServoMotor*)motor)->autotuneStart()) *commandError = CE_0;
+      } else
+      if (parameter[3] == 'X' && parameter[4] == 0) {
+        ((ServoMotor*)motor)->autotuneAbort();
+      } else
+      #if SERVO_TRACE != OFF
+        if (parameter[3] == 'R') {
+          ServoTrace *trace = ((ServoMotor*)motor)->trace;
+          if (trace == NULL) { *commandError = CE_CMD_UNKNOWN; return true; }
+          if (parameter[4] == 'N' && parameter[5] == 0) trace->arm(TT_NOW); else
+          if (parameter[4] == 'G' && parameter[5] == 0) trace->arm(TT_SLEW); else
+          if (parameter[4] == 'S' && parameter[5] == 0) trace->arm(TT_STALL); else
+          if (parameter[4] == 'E') {
+            char *conv_end;
+            long threshold = strtol(&parameter[5], &conv_end, 10);
+            if (&parameter[5] == conv_end || threshold < 1) { *commandError = CE_PARAM_FORM; return true; }
+            trace->arm(TT_ERROR, threshold);
+          } else *commandError = CE_PARAM_FORM;
+        } else
+      #endif
+      *commandError = CE_PARAM_FORM;
+    } else
+  #endif
+
   // :SXA[n]#   Set axis/driver configuration
   if (command[0] == 'S' && command[1] == 'X' && parameter[0] == 'A' && parameter[2] == ',') {
     uint16_t axesToRevert = nv.readUI(NV_AXIS_SETTINGS_REVERT);
@@ -229,4 +341,33 @@ bool Axis::validateAxisSettings(int axisNum, AxisStoredSettings a) {
   return true;
 }
 
+#ifdef SERVO_MOTOR_PRESENT
+  // watch a servo autotune experiment and save the resulting PID gains to NV
+  void Axis::autotunePoll() {
+    Autotune *autotune = &((ServoMotor*)motor)->autotune;
+
+    if (autotune->state == AT_RUNNING && autoRate != AR_NONE) {
+      V(axisPrefix); VLF("autotune stopped, axis in motion");
+      autotune->abort();
+    }
+
+    if (autotune->state != AT_DONE) return;
+
+    V(axisPrefix); VF("autotune Ku="); V(autotune->ultimateGain); VF(", Tu="); V(autotune->ultimatePeriod); VLF("s");
+
+    AxisStoredSettings thisAxis;
+    nv.readBytes(NV_AXIS_SETTINGS_BASE + (axisNumber - 1)*AxisStoredSettingsSize, &thisAxis, sizeof(AxisStoredSettings));
+    if (autotune->getParameters(&thisAxis.param1, &thisAxis.param2, &thisAxis.param3, &thisAxis.param4, &thisAxis.param5, &thisAxis.param6) &&
+        validateAxisSettings(axisNumber, thisAxis)) {
+      nv.updateBytes(NV_AXIS_SETTINGS_BASE + (axisNumber - 1)*AxisStoredSettingsSize, &thisAxis, sizeof(AxisStoredSettings));
+      motor->setParameters(thisAxis.param1, thisAxis.param2, thisAxis.param3, thisAxis.param4, thisAxis.param5, thisAxis.param6);
+      autotune->state = AT_STORED;
+      V(axisPrefix); VLF("autotune PID gains saved");
+    } else {
+      autotune->state = AT_FAILED;
+      V(axisPrefix); VLF("autotune PID gains rejected");
+    }
+  }
+#endif
+
 #endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include "../tasks/OnTask.h"
 #include "../sense/Sense.h"
+#include "../memory/Memory.h"
 
 #ifdef MOTOR_PRESENT
 
@@ -19,6 +20,20 @@ IRAM_ATTR void axisWrapper7() { axisWrapper[6]->poll(); }
 IRAM_ATTR void axisWrapper8() { axisWrapper[7]->poll(); }
 IRAM_ATTR void axisWrapper9() { axisWrapper[8]->poll(); }
 
+#if AXIS_HOME_LATCH == ON
+  IRAM_ATTR void homeLatchWrapper1() { axisWrapper[0]->homeLatch(); }
+  IRAM_ATTR void homeLatchWrapper2() { axisWrapper[1]->homeLatch(); }
+  IRAM_ATTR void homeLatchWrapper3() { axisWrapper[2]->homeLatch(); }
+  IRAM_ATTR void homeLatchWrapper4() { axisWrapper[3]->homeLatch(); }
+  IRAM_ATTR void homeLatchWrapper5() { axisWrapper[4]->homeLatch(); }
+  IRAM_ATTR void homeLatchWrapper6() { axisWrapper[5]->homeLatch(); }
+  IRAM_ATTR void homeLatchWrapper7() { axisWrapper[6]->homeLatch(); }
+  IRAM_ATTR void homeLatchWrapper8() { axisWrapper[7]->homeLatch(); }
+  IRAM_ATTR void homeLatchWrapper9() { axisWrapper[8]->homeLatch(); }
+  void (*homeLatchWrapper[9])() = { homeLatchWrapper1, homeLatchWrapper2, homeLatchWrapper3, homeLatchWrapper4, homeLatchWrapper5,
+                                    homeLatchWrapper6, homeLatchWrapper7, homeLatchWrapper8, homeLatchWrapper9 };
+#endif
+
 // constructor
 Axis::Axis(uint8_t axisNumber, const AxisPins *pins, const AxisSettings *settings, const AxisMeasure axisMeasure, float targetTolerance) {
   axisPrefix[9] = '0' + axisNumber;
@@ -100,6 +115,12 @@ bool Axis::init(Motor *motor) {
   homeSenseHandle = sense.add(pins->home, pins->axisSense.homeInit, pins->axisSense.homeTrigger);
   minSenseHandle = sense.add(pins->min, pins->axisSense.minMaxInit, pins->axisSense.minTrigger);
   maxSenseHandle = sense.add(pins->max, pins->axisSense.minMaxInit, pins->axisSense.maxTrigger);
+
+  #if AXIS_HOME_LATCH == ON
+    // only a digital sense on an MCU pin can interrupt, others home with the usual three passes
+    homeLatchAvailable = sense.onEdge(homeSenseHandle, homeLatchWrapper[axisNumber - 1]);
+    if (homeLatchAvailable) { V(axisPrefix); VLF("home sense edge latch enabled"); }
+  #endif
   #if LIMIT_SENSE_STRICT != ON
     commonMinMaxSense = pins->min != OFF && pins->min == pins->max;
   #endif
@@ -114,7 +135,6 @@ bool Axis::init(Motor *motor) {
 
   // start monitor
   V(axisPrefix); VF("start monitor task (rate "); V(FRACTIONAL_SEC_US); VF("us priority 1)... ");
-  uint8_t taskHandle = 0;
   char taskName[] = "Ax_Mtr";
   taskName[2] = axisNumber + '0';
   taskHandle = tasks.add(0, 0, true, 1, callback, taskName);
@@ -122,6 +142,20 @@ bool Axis::init(Motor *motor) {
   if (taskHandle) { VLF("success"); } else { VLF("FAILED!"); }
   motor->monitorHandle = taskHandle;
 
+  // the step/dir motor ISR needs nothing from the monitor between rate changes, other motors may close loops here
+  #ifndef GPIO_DIRECTION_PINS
+    pollAdaptive = motor->driverType == STEP_DIR && FRACTIONAL_SEC_IDLE < FRACTIONAL_SEC;
+  #endif
+
+  #ifdef WATCHDOG_PRESENT
+    heartbeatHandle = watchdog.heartbeatRegister(taskName);
+  #endif
+
+  IRAM_HOT_CHECK(taskName, callback);
+  IRAM_HOT_CHECK("Axis::poll", &Axis::poll);
+  IRAM_HOT_CHECK("Axis::setFrequency", &Axis::setFrequency);
+  IRAM_HOT_CHECK("Axis::jerkLimitedFrequency", &Axis::jerkLimitedFrequency);
+
   return true;
 }
 
@@ -172,6 +206,30 @@ CommandError Axis::resetPositionSteps(long value) {
   return CE_NONE;
 }
 
+// set the motor position from an absolute encoder that counts 0 at the instrument coordinate already set
+bool Axis::restoreAbsolutePosition(Encoder *encoder, bool reverse, float stepsPerCount, unsigned long timeoutMs) {
+  if (encoder == NULL) return false;
+
+  int32_t count = INT32_MAX;
+  unsigned long startTime = millis();
+  while (true) {
+    if (encoder->ready && !encoder->error) count = encoder->read();
+    if (count != INT32_MAX && !encoder->error) break;
+    if ((long)(millis() - startTime) > (long)timeoutMs) { V(axisPrefix); VLF("absolute encoder timed out"); return false; }
+    tasks.yieldMicros(1000);
+  }
+  if (reverse) count = -count;
+
+  // keep the index so the instrument coordinate moves by the encoder offset from home
+  long steps = lround(count*stepsPerCount);
+  long homeSteps = motor->getInstrumentCoordinateSteps() - motor->getMotorPositionSteps();
+  motor->resetPositionSteps(steps);
+  motor->setInstrumentCoordinateSteps(homeSteps + steps);
+
+  V(axisPrefix); VF("absolute encoder position restored, motor at "); V(steps); VLF(" steps");
+  return true;
+}
+
 // get motor position, in "measure" units
 double Axis::getMotorPosition() {
   return motor->getMotorPositionSteps()/settings.stepsPerMeasure;
@@ -273,7 +331,7 @@ double Axis::getTargetDistance() {
 }
 
 // distance to origin or target, whichever is closer, in "measures" (degrees, microns, etc.)
-double Axis::getOriginOrTargetDistance() {
+IRAM_HOT double Axis::getOriginOrTargetDistance() {
   return motor->getOriginOrTargetDistanceSteps()/settings.stepsPerMeasure;
 }
 
@@ -308,6 +366,14 @@ void Axis::setSlewAccelerationTimeAbort(float seconds) {
   if (autoRate == AR_NONE) abortAccelTime = seconds;
 }
 
+// set jerk limit as the time in seconds to reach full acceleration (for autoGoto and autoSlew)
+void Axis::setSlewJerkTime(float seconds) {
+  if (autoRate == AR_NONE) {
+    if (seconds < 0.0F) seconds = 0.0F;
+    slewJerkTime = seconds;
+  }
+}
+
 // auto goto to destination target coordinate
 // \param frequency: optional frequency of slew in "measures" (radians, microns, etc.) per second
 CommandError Axis::autoGoto(float frequency) {
@@ -324,8 +390,18 @@ CommandError Axis::autoGoto(float frequency) {
   motor->markOriginCoordinateSteps();
   motor->setSynchronized(false);
   motor->setSlewing(true);
+  motor->setAccelerationSteps(slewAccelRateFs*FRACTIONAL_SEC*settings.stepsPerMeasure, abortAccelRateFs*FRACTIONAL_SEC*settings.stepsPerMeasure);
+  rampOffload = motor->autoGoto(slewFreq*settings.stepsPerMeasure);
   autoRate = AR_RATE_BY_DISTANCE;
   rampFreq = 0.0F;
+  slewAccelFs = 0.0F;
+  brakeStage = BRAKE_NONE;
+  eventSettlePending = false;
+  event(AE_SLEW_START);
+  pollWake();
+  #if AXIS_RAMP_TABLE == ON
+    if (slewJerkTime == 0.0F) buildRampTable();
+  #endif
 
   #if DEBUG == VERBOSE
     if (unitsRadians) V(radToDeg(slewFreq)); else V(slewFreq);
@@ -337,6 +413,21 @@ CommandError Axis::autoGoto(float frequency) {
   return CE_NONE;
 }
 
+// returns true if an autoGoto has come close enough to its target to be slowing down
+bool Axis::autoGotoBraking() {
+  if (autoRate != AR_RATE_BY_DISTANCE) return false;
+  float accel = slewAccelRateFs*FRACTIONAL_SEC;
+  if (accel <= 0.0F) return true;
+  return getTargetDistance() <= (freq*freq)/(2.0F*accel);
+}
+
+// moves the target of an autoGoto in progress, in "measures" (radians, microns, etc.), without stopping
+void Axis::autoGotoRetarget(double value) {
+  setTargetCoordinate(value);
+  brakeStage = BRAKE_NONE;
+  V(axisPrefix); VLF("autoGoto target moved");
+}
+
 // auto slew
 // \param direction: direction of motion, DIR_FORWARD or DIR_REVERSE
 // \param frequency: optional frequency of slew in "measures" (radians, microns, etc.) per second
@@ -353,6 +444,10 @@ CommandError Axis::autoSlew(Direction direction, float frequency) {
   if (autoRate == AR_NONE) {
     motor->setSynchronized(true);
     motor->setSlewing(true);
+    motor->setAccelerationSteps(slewAccelRateFs*FRACTIONAL_SEC*settings.stepsPerMeasure, abortAccelRateFs*FRACTIONAL_SEC*settings.stepsPerMeasure);
+    slewAccelFs = 0.0F;
+    eventSettlePending = false;
+    event(AE_SLEW_START);
     V(axisPrefix); VF("autoSlew start ");
   } else { VF("autoSlew resum "); }
 
@@ -363,6 +458,7 @@ CommandError Axis::autoSlew(Direction direction, float frequency) {
     autoRate = AR_RATE_BY_TIME_REVERSE;
     VF("rev@ ");
   }
+  pollWake();
 
   #if DEBUG == VERBOSE
     if (unitsRadians) {
@@ -390,9 +486,19 @@ CommandError Axis::autoSlewHome(unsigned long timeout) {
 
   if (pins->axisSense.homeTrigger != OFF) {
     motor->setSynchronized(true);
-    if (homingStage == HOME_NONE) homingStage = HOME_FAST;
+    if (homingStage == HOME_NONE) {
+      // sensorless homing is a single pass that ends at the stall
+      homingStage = hasHomeStall() ? HOME_FINE : HOME_FAST;
+      eventSettlePending = false;
+      event(AE_SLEW_START);
+      #if AXIS_HOME_LATCH == ON
+        homeLatched = false;
+        homeLatchArmed = homeLatchAvailable;
+      #endif
+    }
     if (autoRate == AR_NONE) {
       motor->setSlewing(true);
+      slewAccelFs = 0.0F;
       V(axisPrefix); VF("autoSlewHome ");
       switch (homingStage) {
         case HOME_FAST: VF("fast "); break;
@@ -401,13 +507,14 @@ CommandError Axis::autoSlewHome(unsigned long timeout) {
         default: break;
       }
     }
-    if (sense.isOn(homeSenseHandle)) {
+    if (!hasHomeStall() && sense.isOn(homeSenseHandle)) {
       VF("fwd@ ");
       autoRate = AR_RATE_BY_TIME_FORWARD;
     } else {
       VF("rev@ ");
       autoRate = AR_RATE_BY_TIME_REVERSE;
     }
+    pollWake();
 
     // automatically set timeout if not specified
     if (timeout == 0) timeout = (pins->axisSense.homeDistLimit/slewFreq)*1.2F*1000.0F;
@@ -428,6 +535,7 @@ CommandError Axis::autoSlewHome(unsigned long timeout) {
 void Axis::autoSlewStop() {
   if (autoRate <= AR_RATE_BY_TIME_END) return;
 
+  rampOffload = false;
   motor->setSynchronized(true);
 
   V(axisPrefix); VLF("slew stopping");
@@ -439,6 +547,7 @@ void Axis::autoSlewStop() {
 void Axis::autoSlewAbort() {
   if (autoRate <= AR_RATE_BY_TIME_ABORT) return;
 
+  rampOffload = false;
   motor->setSynchronized(true);
 
   V(axisPrefix); VLF("slew aborting");
@@ -447,16 +556,39 @@ void Axis::autoSlewAbort() {
   poll();
 }
 
+#if AXIS_HOME_LATCH == ON
+// records the step count at the home sense edge while homing, called from the pin change ISR
+IRAM_ATTR void Axis::homeLatch() {
+  if (!homeLatchArmed) return;
+  homeLatchSteps = motor->getInstrumentCoordinateStepsISR();
+  homeLatched = true;
+}
+#endif
+
 // checks if slew is active on this axis
 bool Axis::isSlewing() {
   return autoRate != AR_NONE;  
 }
 
+// set the time in milliseconds the axis has to be stopped at its target before it's settled
+void Axis::setSettleTime(unsigned long milliseconds) {
+  settleTime = milliseconds;
+}
+
+// checks if the axis has been stopped at its target for the settle time
+bool Axis::isSettled() {
+  return autoRate == AR_NONE && atTarget() && (long)(millis() - motionTime) >= (long)settleTime;
+}
+
 // monitor movement
-void Axis::poll() {
+IRAM_HOT void Axis::poll() {
   // make sure we're ready
   if (axisNumber == 0) return;
 
+  #ifdef WATCHDOG_PRESENT
+    watchdog.heartbeat(heartbeatHandle);
+  #endif
+
   // let the user know if the associated senses change state
   #if DEBUG == VERBOSE
     if (sense.changed(homeSenseHandle)) {
@@ -480,9 +612,26 @@ void Axis::poll() {
 
   // stop homing as we pass by the switch or times out
   if (homingStage != HOME_NONE && (autoRate == AR_RATE_BY_TIME_FORWARD || autoRate == AR_RATE_BY_TIME_REVERSE)) {
-    if (autoRate == AR_RATE_BY_TIME_FORWARD && !sense.isOn(homeSenseHandle)) autoSlewStop();
-    if (autoRate == AR_RATE_BY_TIME_REVERSE && sense.isOn(homeSenseHandle)) autoSlewStop();
-    if ((long)(millis() - homeTimeoutTime) > 0) {
+    if (hasHomeStall()) {
+      // StallGuard readings are meaningless until the motor is up to speed
+      if (fabs(freq) >= slewFreq/2.0F && motorStalled()) {
+        V(axisPrefix); VLF("autoSlewHome stall detected, at home");
+        motor->setSlewing(false);
+        autoRate = AR_NONE;
+        homingStage = HOME_NONE;
+        freq = 0.0F;
+        eventSettlePending = true;
+        event(AE_SLEW_STOP);
+      }
+    } else {
+      #if AXIS_HOME_LATCH == ON
+        // any switch bounce is over once the sense settles, so the last edge latched is the one wanted
+        if (autoRate == AR_RATE_BY_TIME_FORWARD ? !sense.isOn(homeSenseHandle) : sense.isOn(homeSenseHandle)) homeLatchArmed = false;
+      #endif
+      if (autoRate == AR_RATE_BY_TIME_FORWARD && !sense.isOn(homeSenseHandle)) autoSlewStop();
+      if (autoRate == AR_RATE_BY_TIME_REVERSE && sense.isOn(homeSenseHandle)) autoSlewStop();
+    }
+    if (homingStage != HOME_NONE && (long)(millis() - homeTimeoutTime) > 0) {
       V(axisPrefix); VLF("autoSlewHome timed out");
       autoSlewAbort();
     }
@@ -495,11 +644,19 @@ void Axis::poll() {
     if (autoRate != AR_RATE_BY_TIME_ABORT) {
       if (motionError(motor->getDirection())) {
         V(axisPrefix); VLF("motion error");
+        faultEvent();
         autoSlewAbort();
         return;
       }
       if (motorFault()) {
         V(axisPrefix); VLF("motor fault");
+        faultEvent();
+        autoSlewAbort();
+        return;
+      }
+      if (homingStage == HOME_NONE && fabs(freq) >= slewFreq/2.0F && motorStalled()) {
+        V(axisPrefix); VLF("motor stall");
+        faultEvent();
         autoSlewAbort();
         return;
       }
@@ -507,43 +664,66 @@ void Axis::poll() {
     if (autoRate == AR_RATE_BY_DISTANCE) {
       if (commonMinMaxSensed) {
         V(axisPrefix); VLF("commonMinMaxSensed");
+        faultEvent();
         autoSlewAbort();
         return;
       }
       if (atTarget()) {
         motor->setSlewing(false);
         autoRate = AR_NONE;
+        rampOffload = false;
         freq = 0.0F;
         motor->setSynchronized(true);
+        if (homingStage == HOME_RETURN) homingStage = HOME_NONE;
+        eventSettlePending = true;
+        event(AE_TARGET_REACHED);
         V(axisPrefix); VLF("slew stopped");
+      } else
+      if (rampOffload) {
+        // the motor's ramp generator is doing the goto, follow along at the rate it reports
+        freq = getFrequency();
+        if (motor->getDirection() == DIR_REVERSE) freq = -freq;
       } else {
-        freq = sqrtf(2.0F*(slewAccelRateFs*FRACTIONAL_SEC)*getOriginOrTargetDistance());
-        if (freq < backlashFreq) freq = backlashFreq;
-        if (freq > slewFreq) freq = slewFreq;
-        if (motor->getTargetDistanceSteps() < 0) freq = -freq;
+        if (slewJerkTime > 0.0F) freq = jerkLimitedGotoFrequency(); else {
+          #if AXIS_RAMP_TABLE == ON
+            freq = rampTableFrequency();
+          #else
+            freq = sqrtf(2.0F*(slewAccelRateFs*FRACTIONAL_SEC)*getOriginOrTargetDistance());
+            if (freq < backlashFreq) freq = backlashFreq;
+            if (freq > slewFreq) freq = slewFreq;
+            if (motor->getTargetDistanceSteps() < 0) freq = -freq;
+          #endif
+        }
         rampFreq = freq;
       }
     } else
     if (autoRate == AR_RATE_BY_TIME_FORWARD) {
-      freq += slewAccelRateFs;
+      if (slewJerkTime > 0.0F) freq = jerkLimitedFrequency(freq, slewFreq); else freq += slewAccelRateFs;
       if (freq > slewFreq) freq = slewFreq;
     } else
     if (autoRate == AR_RATE_BY_TIME_REVERSE) {
-      freq -= slewAccelRateFs;
+      if (slewJerkTime > 0.0F) freq = jerkLimitedFrequency(freq, -slewFreq); else freq -= slewAccelRateFs;
       if (freq < -slewFreq) freq = -slewFreq;
     } else
     if (autoRate == AR_RATE_BY_TIME_END) {
       if (commonMinMaxSensed) {
         V(axisPrefix); VLF("commonMinMaxSensed");
+        faultEvent();
         autoSlewAbort();
         return;
       }
 
-      if (freq > slewAccelRateFs) freq -= slewAccelRateFs; else if (freq < -slewAccelRateFs) freq += slewAccelRateFs; else freq = 0.0F;
+      if (slewJerkTime > 0.0F) freq = jerkLimitedFrequency(freq, 0.0F); else {
+        if (freq > slewAccelRateFs) freq -= slewAccelRateFs; else if (freq < -slewAccelRateFs) freq += slewAccelRateFs; else freq = 0.0F;
+      }
       if (fabs(freq) <= slewAccelRateFs) {
         motor->setSlewing(false);
         autoRate = AR_NONE;
         freq = 0.0F;
+        #if AXIS_HOME_LATCH == ON
+          homeLatchArmed = false;
+          if (homingStage == HOME_FAST && homeLatched) homingStage = HOME_RETURN; else
+        #endif
         if (homingStage == HOME_FAST) homingStage = HOME_SLOW; else 
         if (homingStage == HOME_SLOW) {
           if (!sense.isOn(homeSenseHandle)) homingStage = HOME_FINE; else {
@@ -552,12 +732,30 @@ void Axis::poll() {
           }
         } else
         if (homingStage == HOME_FINE) homingStage = HOME_NONE;
+        #if AXIS_HOME_LATCH == ON
+          if (homingStage == HOME_RETURN) {
+            // the fast pass saw the edge, go back to where it was
+            V(axisPrefix); VLF("autoSlewHome returning to the latched home sense edge");
+            motor->setTargetCoordinateSteps(homeLatchSteps);
+            motor->markOriginCoordinateSteps();
+            motor->setSynchronized(false);
+            motor->setSlewing(true);
+            autoRate = AR_RATE_BY_DISTANCE;
+            rampFreq = 0.0F;
+            brakeStage = BRAKE_NONE;
+            #if AXIS_RAMP_TABLE == ON
+              if (slewJerkTime == 0.0F) buildRampTable();
+            #endif
+          } else
+        #endif
         if (homingStage != HOME_NONE) {
           float f = fabs(slewFreq)/6.0F;
           if (f < 0.0003F) f = 0.0003F;
           setFrequencySlew(f);
           autoSlewHome(SLEW_HOME_REFINE_TIME_LIMIT * 1000);
         } else {
+          eventSettlePending = true;
+          event(AE_SLEW_STOP);
           V(axisPrefix); VLF("slew stopped");
         }
       }
@@ -568,12 +766,13 @@ void Axis::poll() {
         motor->setSlewing(false);
         autoRate = AR_NONE;
         freq = 0.0F;
+        event(AE_ABORTED);
         V(axisPrefix); VLF("slew aborted");
       }
     } else freq = 0.0F;
   } else {
     freq = 0.0F;
-    if (commonMinMaxSensed || motionError(DIR_BOTH) || motorFault()) baseFreq = 0.0F;
+    if (commonMinMaxSensed || motionError(DIR_BOTH) || motorFault()) { baseFreq = 0.0F; faultEvent(); } else eventFaulted = false;
   }
   Y;
 
@@ -582,14 +781,164 @@ void Axis::poll() {
   // keep associated motor updated
   motor->poll();
 
+  #ifdef SERVO_MOTOR_PRESENT
+    if (motor->driverType == SERVO) autotunePoll();
+  #endif
+
   // respond to the motor disabling itself
   if (autoRate != AR_NONE && !motor->enabled) {
     autoRate = AR_NONE;
     freq = 0.0F;
+    event(AE_ABORTED);
     V(axisPrefix); VLF("motion stopped, motor disabled!");
   }
+
+  // full polling frequency while slewing or in backlash, the idle frequency while stopped or tracking at a constant rate
+  if (pollAdaptive) {
+    bool idle = autoRate == AR_NONE && !motor->inBacklash;
+    if (idle != pollIdle) {
+      pollIdle = idle;
+      tasks.setPeriodMicros(taskHandle, idle ? FRACTIONAL_SEC_IDLE_US : FRACTIONAL_SEC_US);
+    }
+  }
+
+  // the settle time starts over whenever the axis moves or leaves its target
+  if (autoRate != AR_NONE || !atTarget()) motionTime = millis();
+
+  if (eventSettlePending && isSettled()) { eventSettlePending = false; event(AE_SETTLED); }
+  if (eventPending) eventDispatch();
+}
+
+// call back on motion events for any axis
+bool Axis::onEvent(AxisEventCallback callback) {
+  if (eventCallbackCount >= AXIS_EVENT_CALLBACKS_MAX) { DLF("ERR: Axis, too many motion event callbacks"); return false; }
+  eventCallback[eventCallbackCount++] = callback;
+  return true;
+}
+
+// pass the recorded motion events along to the callbacks
+void Axis::eventDispatch() {
+  uint8_t pending = eventPending;
+  eventPending = 0;
+  for (uint8_t e = AE_SLEW_START; e <= AE_SETTLED; e++) {
+    if (!(pending & (1 << e))) continue;
+    for (uint8_t i = 0; i < eventCallbackCount; i++) eventCallback[i](this, (AxisEvent)e);
+  }
+}
+
+AxisEventCallback Axis::eventCallback[AXIS_EVENT_CALLBACKS_MAX];
+uint8_t Axis::eventCallbackCount = 0;
+
+// moves frequency toward the target frequency with the acceleration changing at no more than the jerk limit
+IRAM_HOT float Axis::jerkLimitedFrequency(float frequency, float target) {
+  float jerkFs = slewAccelRateFs/(slewJerkTime*FRACTIONAL_SEC);
+  float delta = target - frequency;
+
+  // acceleration that reaches the target frequency just as it ramps down to zero
+  float accelTarget = sqrtf(2.0F*jerkFs*fabs(delta));
+  if (accelTarget > slewAccelRateFs) accelTarget = slewAccelRateFs;
+  if (delta < 0.0F) accelTarget = -accelTarget;
+
+  if (slewAccelFs < accelTarget - jerkFs) slewAccelFs += jerkFs; else
+  if (slewAccelFs > accelTarget + jerkFs) slewAccelFs -= jerkFs; else slewAccelFs = accelTarget;
+
+  // don't overshoot the target frequency
+  if ((delta >= 0.0F && slewAccelFs > delta) || (delta <= 0.0F && slewAccelFs < delta)) slewAccelFs = delta;
+
+  return frequency + slewAccelFs;
+}
+
+// S-curve autoGoto frequency in "measures" (degrees, microns, etc.) per second
+float Axis::jerkLimitedGotoFrequency() {
+  float distance = getTargetDistance();
+  float sign = motor->getTargetDistanceSteps() < 0 ? -1.0F : 1.0F;
+
+  // work with the magnitude of the frequency and acceleration
+  float frequency = freq*sign;
+  float lastFrequency = frequency;
+  slewAccelFs *= sign;
+
+  float accel = slewAccelRateFs*FRACTIONAL_SEC;
+  float jerk = accel/slewJerkTime;
+
+  // stopping profile frequency and acceleration at this distance, constant deceleration then ramp down to zero
+  float curveFrequency, curveAccelFs;
+  float rampDistance = accel*slewJerkTime*slewJerkTime/6.0F;
+  if (distance <= rampDistance) {
+    curveFrequency = (jerk/2.0F)*powf(6.0F*distance/jerk, 2.0F/3.0F);
+    curveAccelFs = distance > 0.0F ? -((2.0F/3.0F)*curveFrequency*curveFrequency/distance)/FRACTIONAL_SEC : 0.0F;
+  } else {
+    float rampFrequency = accel*slewJerkTime/2.0F;
+    curveFrequency = sqrtf(rampFrequency*rampFrequency + 2.0F*accel*(distance - rampDistance));
+    curveAccelFs = -slewAccelRateFs;
+  }
+
+  // start ramping in the deceleration once within stopping distance, after finishing any acceleration in progress
+  if (brakeStage == BRAKE_NONE) {
+    float a0 = slewAccelFs*FRACTIONAL_SEC;
+    float peakFrequency = frequency;
+    float stopDistance = frequency/FRACTIONAL_SEC;
+    if (a0 > 0.0F) {
+      float t = a0/jerk;
+      peakFrequency += a0*t/2.0F;
+      stopDistance += (frequency + a0*t/3.0F)*t;
+    }
+    stopDistance += peakFrequency*peakFrequency/(2.0F*accel) + peakFrequency*accel*slewJerkTime/2.0F;
+    if (distance <= stopDistance) brakeStage = BRAKE_RAMP;
+  }
+  if (brakeStage == BRAKE_RAMP && (slewAccelFs <= -slewAccelRateFs*0.999F || frequency >= curveFrequency)) brakeStage = BRAKE_CURVE;
+
+  if (brakeStage == BRAKE_CURVE) {
+    // follow the stopping profile, correcting any error over about 0.1 seconds
+    float jerkFs = slewAccelRateFs/(slewJerkTime*FRACTIONAL_SEC);
+    float accelTarget = curveAccelFs + (curveFrequency - frequency)/(0.1F*FRACTIONAL_SEC);
+    if (accelTarget < -slewAccelRateFs*1.5F) accelTarget = -slewAccelRateFs*1.5F;
+    if (slewAccelFs < accelTarget - jerkFs) slewAccelFs += jerkFs; else
+    if (slewAccelFs > accelTarget + jerkFs) slewAccelFs -= jerkFs; else slewAccelFs = accelTarget;
+    frequency += slewAccelFs;
+  } else frequency = jerkLimitedFrequency(frequency, brakeStage == BRAKE_NONE ? slewFreq : 0.0F);
+
+  // never faster than the constant acceleration profile allows
+  float maxFrequency = sqrtf(2.0F*accel*distance);
+  if (frequency > maxFrequency) frequency = maxFrequency;
+  if (frequency < backlashFreq) frequency = backlashFreq;
+  if (frequency > slewFreq) frequency = slewFreq;
+
+  slewAccelFs = (frequency - lastFrequency)*sign;
+  return frequency*sign;
+}
+
+#if AXIS_RAMP_TABLE == ON
+// builds the autoGoto ramp table for the current slew rate and acceleration
+void Axis::buildRampTable() {
+  // rate step i is reached at distance (i*rampStep)^2/(2*accel) from the origin or target
+  float accel = slewAccelRateFs*FRACTIONAL_SEC;
+  rampStep = slewFreq/AXIS_RAMP_TABLE_SIZE;
+  for (int i = 0; i <= AXIS_RAMP_TABLE_SIZE; i++) {
+    float frequency = rampStep*i;
+    float steps = accel > 0.0F ? ceilf(((frequency*frequency)/(2.0F*accel))*settings.stepsPerMeasure) : 2.0E9F;
+    if (i == 0) steps = 0.0F; else if (steps > 2.0E9F) steps = 2.0E9F;
+    rampTable[i] = lroundf(steps);
+  }
+  rampIndex = 0;
 }
 
+// autoGoto frequency from the ramp table in "measures" (degrees, microns, etc.) per second
+float Axis::rampTableFrequency() {
+  long distance = motor->getOriginOrTargetDistanceSteps();
+
+  // the distance changes smoothly so this usually takes one compare
+  while (rampIndex < AXIS_RAMP_TABLE_SIZE && distance >= rampTable[rampIndex + 1]) rampIndex++;
+  while (rampIndex > 0 && distance < rampTable[rampIndex]) rampIndex--;
+
+  float frequency = rampStep*rampIndex;
+  if (frequency < backlashFreq) frequency = backlashFreq;
+  if (frequency > slewFreq) frequency = slewFreq;
+  if (motor->getTargetDistanceSteps() < 0) frequency = -frequency;
+  return frequency;
+}
+#endif
+
 // set minimum slew frequency in "measures" (radians, microns, etc.) per second
 void Axis::setFrequencyMin(float frequency) {
   minFreq = frequency;
@@ -602,9 +951,23 @@ void Axis::setFrequencyMax(float frequency) {
 
 // frequency for base movement in "measures" (radians, microns, etc.) per second
 void Axis::setFrequencyBase(float frequency) {
+  if (frequency == baseFreq) return;
+
+  // apply rate changes right away so guide pulses, etc. aren't held to the idle polling frequency
+  if (pollIdle) {
+    if ((frequency < 0.0F && baseFreq > 0.0F) || (frequency > 0.0F && baseFreq < 0.0F)) pollWake(); else tasks.immediate(taskHandle);
+  }
   baseFreq = frequency;
 }
 
+// back to the full polling frequency, starting now
+void Axis::pollWake() {
+  if (!pollIdle) return;
+  pollIdle = false;
+  tasks.setPeriodMicros(taskHandle, FRACTIONAL_SEC_US);
+  tasks.immediate(taskHandle);
+}
+
 // frequency for slews in "measures" (radians, microns, etc.) per second
 void Axis::setFrequencySlew(float frequency) {
   if (minFreq != 0.0F && frequency < minFreq) frequency = minFreq;
@@ -617,7 +980,7 @@ void Axis::setFrequencySlew(float frequency) {
 }
 
 // set frequency in "measures" (degrees, microns, etc.) per second (0 stops motion)
-void Axis::setFrequency(float frequency) {
+IRAM_HOT void Axis::setFrequency(float frequency) {
   if (powerDownStandstill && frequency == 0.0F && baseFreq == 0.0F) {
     if (!poweredDown) {
       if (!powerDownOverride || (long)(millis() - powerDownOverrideEnds) > 0) {
@@ -683,6 +1046,7 @@ bool Axis::motionError(Direction direction) {
 
   if (direction == DIR_FORWARD || direction == DIR_BOTH) {
     result = getInstrumentCoordinateSteps() > lroundf(0.9F*INT32_MAX) ||
+             (limitsCheck && direction == DIR_FORWARD && getInstrumentCoordinateSteps() > limitMaxSteps) ||
              (limitsCheck && homingStage == HOME_NONE && getInstrumentCoordinate() > settings.limits.max) ||
              (!commonMinMaxSense && errors.maxLimitSensed);
     if (result == true && result != lastErrorResult) { V(axisPrefix); VLF("motion error forward limit"); }
@@ -690,6 +1054,7 @@ bool Axis::motionError(Direction direction) {
 
   if (direction == DIR_REVERSE || direction == DIR_BOTH) {
     result = getInstrumentCoordinateSteps() < lroundf(0.9F*INT32_MIN) ||
+             (limitsCheck && direction == DIR_REVERSE && getInstrumentCoordinateSteps() < limitMinSteps) ||
              (limitsCheck && homingStage == HOME_NONE && getInstrumentCoordinate() < settings.limits.min) ||
              (!commonMinMaxSense && errors.minLimitSensed);
     if (result == true && result != lastErrorResult) { V(axisPrefix); VLF("motion error reverse limit"); }
@@ -25,6 +25,12 @@
 #endif
 #define FRACTIONAL_SEC_US           (lround(1000000.0F/FRACTIONAL_SEC))
 
+// polling frequency for step/dir axes while stopped or tracking at a constant rate, FRACTIONAL_SEC to disable
+#ifndef FRACTIONAL_SEC_IDLE
+#define FRACTIONAL_SEC_IDLE         10.0F
+#endif
+#define FRACTIONAL_SEC_IDLE_US      (lround(1000000.0F/FRACTIONAL_SEC_IDLE))
+
 // time limit in seconds for slew home refine phases
 #ifndef SLEW_HOME_REFINE_TIME_LIMIT
 #define SLEW_HOME_REFINE_TIME_LIMIT 120
@@ -35,11 +41,37 @@
 #define LIMIT_SENSE_STRICT          OFF
 #endif
 
+// ON uses a ramp table built at autoGoto start, stepped through by distance in steps (constant acceleration only)
+#ifndef AXIS_RAMP_TABLE
+#define AXIS_RAMP_TABLE             OFF
+#endif
+#ifndef AXIS_RAMP_TABLE_SIZE
+#define AXIS_RAMP_TABLE_SIZE        32     // number of rate steps from zero to the slew rate
+#endif
+
+// OFF takes up backlash at a constant rate, or 2 to 4 ramps the takeup up to this multiple of the backlash rate and back
+#ifndef AXIS_BACKLASH_RAMP
+#define AXIS_BACKLASH_RAMP          OFF
+#endif
+
+// ON latches the step count on the home sense edge (pin change interrupt) so homing is one fast pass and a return to it
+#ifndef AXIS_HOME_LATCH
+#define AXIS_HOME_LATCH             OFF
+#endif
+
+// number of motion event callbacks that can be registered, shared by all axes
+#ifndef AXIS_EVENT_CALLBACKS_MAX
+#define AXIS_EVENT_CALLBACKS_MAX    6
+#endif
+
 #include "../../libApp/commands/ProcessCmds.h"
+#include "../watchdog/Watchdog.h"
+#include "../encoder/Encoder.h"
 #include "motor/Motor.h"
 #include "motor/stepDir/StepDir.h"
 #include "motor/servo/Servo.h"
 #include "motor/oDrive/ODrive.h"
+#include "motor/tmcRamp/TmcRamp.h"
 
 // helpers for step/dir and servo parameters
 #define subdivisions param1
@@ -98,9 +130,17 @@ typedef struct AxisErrors {
 } AxisErrors;
 
 enum AutoRate: uint8_t {AR_NONE, AR_RATE_BY_TIME_ABORT, AR_RATE_BY_TIME_END, AR_RATE_BY_DISTANCE, AR_RATE_BY_TIME_FORWARD, AR_RATE_BY_TIME_REVERSE};
-enum HomingStage: uint8_t {HOME_NONE, HOME_FINE, HOME_SLOW, HOME_FAST};
+enum HomingStage: uint8_t {HOME_NONE, HOME_FINE, HOME_SLOW, HOME_FAST, HOME_RETURN};
+enum BrakeStage: uint8_t {BRAKE_NONE, BRAKE_RAMP, BRAKE_CURVE};
 enum AxisMeasure: uint8_t {AXIS_MEASURE_UNKNOWN, AXIS_MEASURE_MICRONS, AXIS_MEASURE_DEGREES, AXIS_MEASURE_RADIANS};
 
+// motion events, in the order they're passed along when more than one happens in a single poll
+enum AxisEvent: uint8_t {AE_SLEW_START, AE_FAULT, AE_ABORTED, AE_SLEW_STOP, AE_TARGET_REACHED, AE_SETTLED};
+
+// callback for motion events, made from the axis monitor task once the axis state is up to date
+class Axis;
+typedef void (*AxisEventCallback)(Axis *axis, AxisEvent event);
+
 class Axis {
   public:
     // constructor
@@ -139,6 +179,11 @@ class Axis {
     // resets target position to the motor position
     inline void resetTargetToMotorPosition() { motor->resetTargetToMotorPosition(); }
 
+    // set the motor position from an absolute encoder that counts 0 at the instrument coordinate already set
+    // (home,) stepsPerCount is motor steps per encoder count, waits up to timeoutMs for a good encoder reading
+    // returns false if there was none and the position is unchanged
+    bool restoreAbsolutePosition(Encoder *encoder, bool reverse, float stepsPerCount, unsigned long timeoutMs = 2000);
+
     // get motor position, in "measure" units
     double getMotorPosition();
 
@@ -168,6 +213,12 @@ class Axis {
     // get instrument coordinate, in steps
     inline long getInstrumentCoordinateSteps() { return motor->getInstrumentCoordinateSteps(); }
 
+    // get instrument coordinate, in steps, for use inside an ISR
+    inline long getInstrumentCoordinateStepsISR() { return motor->getInstrumentCoordinateStepsISR(); }
+
+    // convert an instrument coordinate in steps to "measures" (radians, microns, etc.)
+    inline double stepsToInstrumentCoordinate(long steps) { return wrap(steps/settings.stepsPerMeasure); }
+
     // set instrument coordinate park, in "measures" (radians, microns, etc.)
     // with backlash disabled this indexes to the nearest position where the motor wouldn't cog
     void setInstrumentCoordinatePark(double value);
@@ -206,6 +257,9 @@ class Axis {
     // get backlash amount in "measures" (radians, microns, etc.)
     float getBacklash();
 
+    // take up backlash toward the direction of the next move, only while stopped (DIR_NONE cancels)
+    inline void setBacklashPreload(Direction direction) { motor->setBacklashPreload(direction); }
+
     // get frequency in "measures" (degrees, microns, etc.) per second
     float getFrequency();
 
@@ -251,10 +305,21 @@ class Axis {
     // set acceleration for emergency stop movement in seconds (for autoSlewStop)
     void setSlewAccelerationTimeAbort(float seconds);
 
+    // set jerk limit as the time in seconds to reach full acceleration (for autoGoto and autoSlew)
+    // use 0 to disable (constant acceleration)
+    void setSlewJerkTime(float seconds);
+
     // auto goto to destination target coordinate
     // \param frequency: optional frequency of slew in "measures" (radians, microns, etc.) per second
     CommandError autoGoto(float frequency = NAN);
 
+    // returns true if an autoGoto has come close enough to its target to be slowing down
+    bool autoGotoBraking();
+
+    // moves the target of an autoGoto in progress, in "measures" (radians, microns, etc.), without stopping
+    // the new target should be further along in the direction of travel
+    void autoGotoRetarget(double value);
+
     // auto slew
     // \param direction: direction of motion, DIR_FORWARD or DIR_REVERSE
     // \param frequency: optional frequency of slew in "measures" (radians, microns, etc.) per second
@@ -269,6 +334,14 @@ class Axis {
     // check if a home sensor is available
     inline bool hasHomeSense() { return pins->axisSense.homeTrigger != OFF; }
 
+    // check if homing is sensorless, against the reverse hard stop using the driver's stall detection
+    inline bool hasHomeStall() { return pins->axisSense.homeTrigger == STALL; }
+
+    #if AXIS_HOME_LATCH == ON
+      // records the step count at the first home sense edge after homing starts, called from the pin change ISR
+      void homeLatch();
+    #endif
+
     // stops, with deacceleration by time
     void autoSlewStop();
 
@@ -278,6 +351,18 @@ class Axis {
     // checks if slew is active on this axis
     bool isSlewing();
 
+    // set the time in milliseconds the axis has to be stopped at its target before it's settled
+    void setSettleTime(unsigned long milliseconds);
+
+    // checks if the axis has been stopped at its target for the settle time
+    bool isSettled();
+
+    // call back on motion events for any axis, returns false if there are too many callbacks
+    static bool onEvent(AxisEventCallback callback);
+
+    // the axis number, 1 to 9
+    inline uint8_t getAxisNumber() { return axisNumber; }
+
     // returns 1 if departing origin or -1 if approaching target
     inline int getRampDirection() { return motor->getRampDirection(); }
 
@@ -290,12 +375,24 @@ class Axis {
     // report fault status of motor driver, if available
     inline bool motorFault() { return motor->getDriverStatus().fault; };
 
+    // report stall status of motor driver, if available
+    inline bool motorStalled() { return motor->getDriverStatus().stalled; };
+
+    // set what the axis is doing so the motor driver can pick its current
+    inline void setCurrentProfile(CurrentProfile profile) { motor->setCurrentProfile(profile); }
+
     // get associated motor driver status
     DriverStatus getStatus();
 
     // enable/disable numeric position range limits (doesn't apply to limit switches)
     void setMotionLimitsCheck(bool state);
 
+    // extra instrument coordinate range limits in steps, checked while slewing (INT32_MIN/INT32_MAX for none)
+    inline void setMotionLimitsSteps(long min, long max) { limitMinSteps = min; limitMaxSteps = max; }
+
+    // instrument coordinate in steps, for value in "measures" (radians, microns, etc.) nearest the current position
+    inline long instrumentCoordinateToSteps(double value) { return lround(unwrapNearest(value)*settings.stepsPerMeasure); }
+
     // checks for an error that would disallow motion in a given direction or DIR_BOTH for any motion
     bool motionError(Direction direction);
 
@@ -308,6 +405,11 @@ class Axis {
     // calibrate the motor driver if required
     void calibrateDriver() { motor->calibrateDriver(); }
 
+    // calibrate the motor driver in two steps so the standstill time can overlap with other axes
+    // returns true if the driver must be held at standstill for MOTOR_CALIBRATE_DRIVER_MS
+    bool calibrateDriverStart() { return motor->calibrateDriverStart(); }
+    void calibrateDriverFinish() { motor->calibrateDriverFinish(); }
+
     // monitor movement
     void poll();
 
@@ -325,9 +427,35 @@ class Axis {
     // sets driver power on/off
     void powered(bool value);
 
+    // back to the full polling frequency, starting now
+    void pollWake();
+
+    // record a motion event, passed along at the end of the next poll
+    inline void event(AxisEvent event) { eventPending |= 1 << event; }
+
+    // record a fault, once until the axis is stopped without one
+    inline void faultEvent() { if (!eventFaulted) { eventFaulted = true; event(AE_FAULT); } }
+
+    // pass the recorded motion events along to the callbacks
+    void eventDispatch();
+
     // distance to origin or target, whichever is closer, in "measures" (degrees, microns, etc.)
     double getOriginOrTargetDistance();
 
+    // moves frequency toward the target frequency with the acceleration changing at no more than the jerk limit
+    float jerkLimitedFrequency(float frequency, float target);
+
+    // S-curve autoGoto frequency in "measures" (degrees, microns, etc.) per second
+    float jerkLimitedGotoFrequency();
+
+    #if AXIS_RAMP_TABLE == ON
+      // builds the autoGoto ramp table for the current slew rate and acceleration
+      void buildRampTable();
+
+      // autoGoto frequency from the ramp table in "measures" (degrees, microns, etc.) per second
+      float rampTableFrequency();
+    #endif
+
     // returns true if traveling through backlash
     bool inBacklash();
 
@@ -344,6 +472,11 @@ class Axis {
     bool decodeAxisSettings(char *s, AxisStoredSettings &a);
 
     bool validateAxisSettings(int axisNum, AxisStoredSettings a);
+
+    #ifdef SERVO_MOTOR_PRESENT
+      // watch a servo autotune experiment and save the resulting PID gains to NV
+      void autotunePoll();
+    #endif
     
     AxisErrors errors;
     bool lastErrorResult = false;
@@ -355,6 +488,8 @@ class Axis {
 
     bool enabled = false;        // enable/disable logical state (disabled is powered down)
     bool limitsCheck = true;     // enable/disable numeric position range limits (doesn't apply to limit switches)
+    volatile long limitMinSteps = INT32_MIN; // extra range limits in steps
+    volatile long limitMaxSteps = INT32_MAX;
 
     uint8_t homeSenseHandle = 0; // home sensor handle
     uint8_t minSenseHandle = 0;  // min sensor handle
@@ -397,12 +532,47 @@ class Axis {
     float abortAccelRateFs;            // abort slew rate in measures per second per frac-sec
     float slewAccelTime = NAN;         // auto slew acceleration time in seconds
     float abortAccelTime = NAN;        // abort slew acceleration time in seconds
+    float slewJerkTime = 0.0F;         // auto slew time in seconds to reach full acceleration (0 disables)
+    float slewAccelFs = 0.0F;          // current auto slew acceleration in measures per second per frac-sec
+    BrakeStage brakeStage = BRAKE_NONE; // autoGoto S-curve deceleration stage
+    bool rampOffload = false;          // the motor's own ramp generator has the autoGoto
+
+    unsigned long settleTime = 0;      // in ms, stopped at the target this long before settled
+    unsigned long motionTime = 0;      // in ms, last time the axis was moving or off target
+
+    #if AXIS_RAMP_TABLE == ON
+      long rampTable[AXIS_RAMP_TABLE_SIZE + 1]; // distance in steps to reach each rate step
+      uint8_t rampIndex = 0;           // current rate step
+      float rampStep = 0.0F;           // rate step size in measures per second
+    #endif
 
     HomingStage homingStage = HOME_NONE;
+    #if AXIS_HOME_LATCH == ON
+      bool homeLatchAvailable = false;      // the home sense is a digital pin with an interrupt
+      volatile bool homeLatchArmed = false; // waiting for the home sense edge
+      volatile bool homeLatched = false;    // the edge was seen, at homeLatchSteps
+      volatile long homeLatchSteps = 0;
+    #endif
+
+    // monitor task, polled at FRACTIONAL_SEC_IDLE while nothing needs the full rate
+    uint8_t taskHandle = 0;
+    bool pollAdaptive = false;
+    bool pollIdle = false;
+
+    // motion events
+    uint8_t eventPending = 0;          // bit set for each AxisEvent waiting to be passed along
+    bool eventFaulted = false;         // an AE_FAULT was passed along and hasn't cleared
+    bool eventSettlePending = false;   // AE_SETTLED follows once isSettled()
+    static AxisEventCallback eventCallback[AXIS_EVENT_CALLBACKS_MAX];
+    static uint8_t eventCallbackCount;
 
     const AxisPins *pins;
 
     void (*volatile callback)() = NULL;
+
+    #ifdef WATCHDOG_PRESENT
+      uint8_t heartbeatHandle = 0;
+    #endif
 };
 
 #endif
@@ -13,4 +13,10 @@ typedef struct DriverStatus {
   bool overTemperature;
   bool standstill;
   bool fault;
+  bool stalled;       // StallGuard load threshold reached, only valid while moving
+  uint16_t sgResult;  // StallGuard load measurement, 0 if unavailable
+  uint8_t csActual;   // actual motor current scale, 0 if unavailable
 } DriverStatus;
+
+// what the axis is doing, TMC drivers can run a lower current while it's only tracking
+enum CurrentProfile: uint8_t {CP_IDLE, CP_TRACKING, CP_GUIDING, CP_SLEWING};
@@ -44,18 +44,16 @@ void Motor::resetTargetToMotorPosition() {
 
 // get motor position in steps (including backlash)
 long Motor::getMotorPositionSteps() {
-  noInterrupts();
-  long steps = motorSteps + backlashSteps;
-  interrupts();
-  return steps;
+  long steps;
+  uint16_t backlash;
+  isrSnapshot(motorSteps, backlashSteps, &steps, &backlash);
+  return steps + backlash;
 }
 
 // get instrument coordinate, in steps
 long Motor::getInstrumentCoordinateSteps() {
-  noInterrupts();
-  long steps = motorSteps + indexSteps;
-  interrupts();
-  return steps;
+  // only motorSteps changes in the ISR
+  return motorSteps + indexSteps;
 }
 
 // set instrument coordinate, in steps
@@ -79,10 +77,8 @@ void Motor::setInstrumentCoordinateParkSteps(long value, int modulo) {
 
 // get target coordinate (with index), in steps
 long Motor::getTargetCoordinateSteps() {
-  noInterrupts();
-  long steps = targetSteps + indexSteps;
-  interrupts();
-  return steps;
+  // only targetSteps changes in the ISR
+  return targetSteps + indexSteps;
 }
 
 // set target coordinate (with index), in steps
@@ -108,10 +104,7 @@ void Motor::setTargetCoordinateParkSteps(long value, int modulo) {
 
 // get backlash amount in steps
 long Motor::getBacklashSteps() {
-  noInterrupts();
-  uint16_t backlash = backlashAmountSteps;
-  interrupts();
-  return backlash;
+  return backlashAmountSteps;
 }
 
 // set backlash amount in steps
@@ -123,24 +116,19 @@ void Motor::setBacklashSteps(long value) {
 
 // mark origin coordinate for autoGoto as current location
 void Motor::markOriginCoordinateSteps() {
-  noInterrupts();
   originSteps = motorSteps;
-  interrupts();
 }
 
 // distance to target in steps (+/-)
 long Motor::getTargetDistanceSteps() {
-  noInterrupts();
-  long dist = targetSteps - motorSteps;
-  interrupts();
-  return dist;
+  long steps, target;
+  isrSnapshot(motorSteps, targetSteps, &steps, &target);
+  return target - steps;
 }
 
 // distance to origin or target, whichever is closer, in steps
 long Motor::getOriginOrTargetDistanceSteps() {
-  noInterrupts();
   long steps = motorSteps;
-  interrupts();
   long distanceOrigin = labs(originSteps - steps);
   long distanceTarget = labs(targetSteps - steps);
   if (distanceOrigin < distanceTarget) return distanceOrigin; else return distanceTarget;
@@ -148,9 +136,7 @@ long Motor::getOriginOrTargetDistanceSteps() {
 
 // returns 1 if distance to origin is closer else -1 if target is closer
 int Motor::getRampDirection() {
-  noInterrupts();
   long steps = motorSteps;
-  interrupts();
   long distanceOrigin = labs(originSteps - steps);
   long distanceTarget = labs(targetSteps - steps);
   if (distanceOrigin < distanceTarget) return 1; else return -1;
@@ -179,6 +165,26 @@ void Motor::disableBacklash() {
   interrupts();
 }
 
+// frequency in steps per second to use while in backlash given the commanded frequency
+float Motor::backlashRampFrequency(float frequency) {
+  #if AXIS_BACKLASH_RAMP != OFF
+    uint16_t amount, position;
+    isrSnapshot(backlashAmountSteps, backlashSteps, &amount, &position);
+    if (amount < 4) return backlashFrequency;
+
+    // ramp up from the commanded rate (within the backlash rate and peak) to the peak a quarter of the way in and back down at the end
+    long distance = position < amount - position ? position : amount - position;
+    float base = fabs(frequency) > backlashFrequency ? fabs(frequency) : backlashFrequency;
+    float peak = backlashFrequency*AXIS_BACKLASH_RAMP;
+    if (peak <= base) return peak;
+    float rampFrequency = sqrtf(base*base + (peak*peak - base*base)*(distance*4.0F/amount));
+    return rampFrequency < peak ? rampFrequency : peak;
+  #else
+    UNUSED(frequency);
+    return backlashFrequency;
+  #endif
+}
+
 void Motor::enableBacklash() {
   noInterrupts();
   backlashSteps = backlashStepsStore;
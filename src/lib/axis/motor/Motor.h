@@ -10,6 +10,16 @@
 
 enum Direction: uint8_t {DIR_NONE, DIR_FORWARD, DIR_REVERSE, DIR_BOTH};
 
+// time in ms a driver is held at standstill for TMC stealthChop automatic current calibration
+#define MOTOR_CALIBRATE_DRIVER_MS 1000
+
+// copies a pair of counts the motor ISR's update without masking interrupts, aligned loads of 32 bits or less
+// are atomic on all supported platforms so a lone count is simply read, for a pair the first is read again
+// after the second and both are taken again if a step came in between
+template <typename A, typename B> inline void isrSnapshot(volatile A &a, volatile B &b, A *x, B *y) {
+  do { *x = a; *y = b; } while (*x != a);
+}
+
 class Motor {
   public:
     // sets up the motor identification
@@ -54,6 +64,9 @@ class Motor {
     // get instrument coordinate, in steps
     virtual long getInstrumentCoordinateSteps();
 
+    // get instrument coordinate, in steps, for use inside an ISR
+    inline long getInstrumentCoordinateStepsISR() { return motorSteps + indexSteps; }
+
     // set instrument coordinate, in steps
     virtual void setInstrumentCoordinateSteps(long value);
 
@@ -98,9 +111,19 @@ class Motor {
     // set backlash frequency in steps per second
     virtual void setBacklashFrequencySteps(float frequency);
 
+    // take up backlash toward the direction of the next move while stopped, DIR_NONE cancels
+    virtual void setBacklashPreload(Direction direction) { UNUSED(direction); }
+
     // get tracking mode steps per slewing mode step
     virtual int getStepsPerStepSlewing();
 
+    // set the slew and emergency stop acceleration in steps per second per second, for motors that ramp on their own
+    virtual void setAccelerationSteps(float acceleration, float accelerationAbort) { UNUSED(acceleration); UNUSED(accelerationAbort); }
+
+    // hand the autoGoto to the target over to the motor's own ramp generator, at frequency in steps per second
+    // returns false if the motor has none, the Axis ramps the frequency itself then
+    virtual bool autoGoto(float frequency) { UNUSED(frequency); return false; }
+
     // get synchronized state (automatic movement of target at setFrequencySteps() rate)
     inline bool getSynchronized() { return synchronized; }
 
@@ -123,11 +146,21 @@ class Motor {
     // set slewing state (hint that we are about to slew or are done slewing)
     virtual void setSlewing(bool state);
 
+    // set what the axis is doing so the driver can pick its current
+    virtual void setCurrentProfile(CurrentProfile profile) { UNUSED(profile); }
+
     // calibrate the motor if required
     virtual void calibrate(float value) { UNUSED(value); }
 
+    // start calibrating the motor driver, true if it must then be held at standstill for
+    // MOTOR_CALIBRATE_DRIVER_MS before calibrateDriverFinish(), other drivers can calibrate meanwhile
+    virtual bool calibrateDriverStart() { return false; }
+
+    // finish calibrating the motor driver
+    virtual void calibrateDriverFinish() {}
+
     // calibrate the motor driver if required
-    virtual void calibrateDriver() {}
+    void calibrateDriver() { if (calibrateDriverStart()) delay(MOTOR_CALIBRATE_DRIVER_MS); calibrateDriverFinish(); }
 
     // monitor and respond to motor state as required
     virtual void poll() {}
@@ -146,6 +179,9 @@ class Motor {
     // enable backlash compensation, to work properly this must be proceeded by a disable call
     void enableBacklash();
 
+    // frequency in steps per second to use while in backlash given the commanded frequency
+    float backlashRampFrequency(float frequency);
+
     volatile uint8_t axisNumber = 0;           // axis number for this motor (1 to 9 in OnStepX)
     char axisPrefix[16];                       // prefix for debug messages
 
@@ -161,6 +197,7 @@ class Motor {
     uint16_t backlashStepsStore;               // temporary storage for the position in backlash
     volatile uint16_t backlashAmountSteps = 0; // the amount of backlash travel
     uint16_t backlashAmountStepsStore;         // temporary storage for the amount of backlash travel
+    volatile int8_t backlashPreloadDir = 0;    // direction (+/-) to take up backlash while stopped or 0
 
     long originSteps = 0;                      // start position for an autoGoto()
     volatile long targetSteps = 0;             // where we want the motor
@@ -9,9 +9,8 @@
 
 #include "../../../tasks/OnTask.h"
 
-ODriveMotor *odriveMotorInstance[2];
-IRAM_ATTR void moveODriveMotorAxis1() { odriveMotorInstance[0]->move(); }
-IRAM_ATTR void moveODriveMotorAxis2() { odriveMotorInstance[1]->move(); }
+// the motor task passes the motor object to its callback
+IRAM_ATTR void moveODriveMotor(void *motor) { ((ODriveMotor*)motor)->move(); }
 
 // ODrive servo motor driver object pointer
 #if ODRIVE_COMM_MODE == OD_UART
@@ -20,6 +19,28 @@ IRAM_ATTR void moveODriveMotorAxis2() { odriveMotorInstance[1]->move(); }
   ODriveTeensyCAN *_oDriveDriver;
 #endif
 
+#if ODRIVE_COMM_MODE == OD_CAN && ODRIVE_CAN_CYCLIC == ON
+  // CAN simple protocol, the arbitration id is node_id << 5 | cmd_id
+  #define ODRIVE_CMD_ENCODER_ESTIMATES 0x009
+
+  // the encoder estimate broadcasts are read straight off the bus, one reader for both axes
+  FlexCAN_T4<ODRIVE_CAN_BUS, RX_SIZE_256, TX_SIZE_16> oDriveCanRx;
+  ODriveMotor *oDriveMotor[2] = { NULL, NULL };
+
+  void oDriveCanRead() {
+    CAN_message_t msg;
+    while (oDriveCanRx.read(msg)) {
+      if ((msg.id & 0x1F) != ODRIVE_CMD_ENCODER_ESTIMATES || msg.len < 8) continue;
+      uint32_t node = msg.id >> 5;
+      if (node > 1 || oDriveMotor[node] == NULL) continue;
+      float position, velocity;
+      memcpy(&position, &msg.buf[0], 4);
+      memcpy(&velocity, &msg.buf[4], 4);
+      oDriveMotor[node]->encoderEstimate(position, velocity);
+    }
+  }
+#endif
+
 // constructor
 ODriveMotor::ODriveMotor(uint8_t axisNumber, const ODriveDriverSettings *Settings, bool useFastHardwareTimers) {
   if (axisNumber < 1 || axisNumber > 2) return;
@@ -44,13 +65,6 @@ ODriveMotor::ODriveMotor(uint8_t axisNumber, const ODriveDriverSettings *Setting
       _oDriveDriver = new ODriveTeensyCAN(250000);
     #endif
   }
-
-  // attach the function pointers to the callbacks
-  odriveMotorInstance[this->axisNumber - 1] = this;
-  switch (this->axisNumber) {
-    case 1: callback = moveODriveMotorAxis1; break;
-    case 2: callback = moveODriveMotorAxis2; break;
-  }
 }
 
 bool ODriveMotor::init() {
@@ -72,19 +86,30 @@ bool ODriveMotor::init() {
 
   enable(false);
 
-  // start the motor timer
-  V(axisPrefix);
-  VF("start task to move motor... ");
-  char timerName[] = "Target_";
-  timerName[6] = '0' + axisNumber;
-  taskHandle = tasks.add(0, 0, true, 0, callback, timerName);
-  if (taskHandle) {
-    V("success");
-    if (useFastHardwareTimers && !tasks.requestHardwareTimer(taskHandle, 0)) { VLF(" (no hardware timer!)"); } else { VLF(""); }
-  } else {
-    VLF("FAILED!");
-    return false;
-  }
+  #if ODRIVE_COMM_MODE == OD_CAN && ODRIVE_CAN_CYCLIC == ON
+    V(axisPrefix); VF("CAN cyclic setpoints every "); V(ODRIVE_CYCLIC_MS); VLF("ms, reading encoder estimates");
+    oDriveMotor[axisNumber - 1] = this;
+  #endif
+
+  #if ODRIVE_STEPLESS == ON
+    // the setpoints come straight from the Axis rate, no motor timer needed
+    V(axisPrefix); VLF("stepless setpoints, no motor task");
+    lastAdvanceTime = micros();
+  #else
+    // start the motor timer
+    V(axisPrefix);
+    VF("start task to move motor... ");
+    char timerName[] = "Target_";
+    timerName[6] = '0' + axisNumber;
+    taskHandle = tasks.add(0, 0, true, 0, moveODriveMotor, this, timerName);
+    if (taskHandle) {
+      V("success");
+      if (useFastHardwareTimers && !tasks.requestHardwareTimer(taskHandle, 0)) { VLF(" (no hardware timer!)"); } else { VLF(""); }
+    } else {
+      VLF("FAILED!");
+      return false;
+    }
+  #endif
 
   return true;
 }
@@ -178,6 +203,11 @@ void ODriveMotor::resetPositionSteps(long value) {
   #if ODRIVE_COMM_MODE == OD_UART
     oPosition = _oDriveDriver->GetPosition(axisNumber - 1)*TWO_PI*stepsPerMeasure; // axis1/2 are in steps per radian
   #elif ODRIVE_COMM_MODE == OD_CAN
+    #if ODRIVE_CAN_CYCLIC == ON
+      // the latest broadcast estimate saves a blocking request
+      oDriveCanRead();
+      if (encoderValid) oPosition = getEncoderCount(); else
+    #endif
     oPosition = _oDriveDriver->GetPosition(axisNumber - 1)*TWO_PI*stepsPerMeasure; // axis1/2 are in steps per radian
   #endif
 
@@ -204,7 +234,19 @@ void ODriveMotor::setFrequencySteps(float frequency) {
 
   // if in backlash override the frequency
   if (inBacklash)
-    frequency = backlashFrequency;
+    frequency = backlashRampFrequency(frequency);
+
+  #if ODRIVE_STEPLESS == ON
+    // no stepping, just remember the rate for advance()
+    lastFrequency = frequency;
+    currentFrequency = frequency;
+    lastPeriod = frequency > 0.0F ? 1 : 0;
+    noInterrupts();
+    step = dir;
+    absStep = 1;
+    interrupts();
+    return;
+  #endif
 
   if (frequency != currentFrequency) {
     lastFrequency = frequency;
@@ -243,7 +285,11 @@ void ODriveMotor::setFrequencySteps(float frequency) {
 
 float ODriveMotor::getFrequencySteps() {
   if (lastPeriod == 0) return 0;
-  return (16000000.0F / lastPeriod) * absStep;
+  #if ODRIVE_STEPLESS == ON
+    return currentFrequency;
+  #else
+    return (16000000.0F / lastPeriod) * absStep;
+  #endif
 }
 
 // set slewing state (hint that we are about to slew or are done slewing)
@@ -253,23 +299,141 @@ void ODriveMotor::setSlewing(bool state) {
 
 // updates PID and sets odrive position
 void ODriveMotor::poll() {
-  if ((long)(millis() - lastSetPositionTime) < ODRIVE_UPDATE_MS) return;
+  #if ODRIVE_STEPLESS == ON
+    advance();
+  #endif
+
+  #if ODRIVE_COMM_MODE == OD_CAN && ODRIVE_CAN_CYCLIC == ON
+    oDriveCanRead();
+    if ((long)(millis() - lastSetPositionTime) < ODRIVE_CYCLIC_MS) return;
+  #else
+    if ((long)(millis() - lastSetPositionTime) < ODRIVE_UPDATE_MS) return;
+  #endif
   lastSetPositionTime = millis();
 
-  noInterrupts();
+  long target;
+  uint16_t backlash;
   #if ODRIVE_SLEW_DIRECT == ON
-    long target = targetSteps + backlashSteps;
+    isrSnapshot(targetSteps, backlashSteps, &target, &backlash);
   #else
-    long target = motorSteps + backlashSteps;
+    isrSnapshot(motorSteps, backlashSteps, &target, &backlash);
   #endif
-  interrupts();
+  target += backlash;
   #if ODRIVE_COMM_MODE == OD_UART
-    setPosition(axisNumber -1, target/(TWO_PI*stepsPerMeasure));
+    #if ODRIVE_STEPLESS == ON
+      setPosition(axisNumber -1, target/(TWO_PI*stepsPerMeasure), getVelocityFeedforward());
+    #else
+      setPosition(axisNumber -1, target/(TWO_PI*stepsPerMeasure));
+    #endif
   #elif ODRIVE_COMM_MODE == OD_CAN
-    _oDriveDriver->SetPosition(axisNumber -1, target/(TWO_PI*stepsPerMeasure));
+    #if ODRIVE_CAN_CYCLIC == ON || ODRIVE_STEPLESS == ON
+      _oDriveDriver->SetPosition(axisNumber -1, target/(TWO_PI*stepsPerMeasure), getVelocityFeedforward());
+    #else
+      _oDriveDriver->SetPosition(axisNumber -1, target/(TWO_PI*stepsPerMeasure));
+    #endif
+    #if ODRIVE_CAN_CYCLIC == ON
+      checkFollowingError(target);
+    #endif
+  #endif
+}
+
+// velocity feedforward for the current setpoint in turns per second
+float ODriveMotor::getVelocityFeedforward() {
+  // with the velocity feedforward the ODrive moves smoothly between setpoints instead of chasing each one
+  float velocity = 0.0F;
+  #if ODRIVE_SLEW_DIRECT == OFF
+    noInterrupts();
+    int s = step;
+    bool moving = !inBacklash && (synchronized || motorSteps != targetSteps);
+    interrupts();
+    if (moving && s != 0) velocity = getFrequencySteps()/(TWO_PI*stepsPerMeasure);
+    if (s < 0) velocity = -velocity;
   #endif
+  return velocity;
 }
 
+#if ODRIVE_STEPLESS == ON
+// moves the target and motor position at the setFrequencySteps() rate since the last call
+void ODriveMotor::advance() {
+  unsigned long now = micros();
+  float seconds = (now - lastAdvanceTime)/1000000.0F;
+  lastAdvanceTime = now;
+
+  fractionalSteps += currentFrequency*seconds;
+  long count = (long)fractionalSteps;
+  if (count <= 0) return;
+  fractionalSteps -= count;
+
+  noInterrupts();
+  // the target moves at the rate when synchronized, just like the step ISR
+  if (synchronized && !inBacklash) targetSteps += step*count;
+
+  // take up any backlash first then move the motor toward the target
+  if (motorSteps > targetSteps) {
+    if (backlashSteps > 0) {
+      long b = backlashSteps < count ? backlashSteps : count;
+      backlashSteps -= b;
+      count -= b;
+      inBacklash = backlashSteps > 0;
+    }
+    if (count > 0) {
+      long d = motorSteps - targetSteps;
+      motorSteps -= d < count ? d : count;
+      inBacklash = false;
+    }
+  } else
+  if (motorSteps < targetSteps || inBacklash) {
+    if (backlashSteps < backlashAmountSteps) {
+      long b = backlashAmountSteps - backlashSteps;
+      if (b > count) b = count;
+      backlashSteps += b;
+      count -= b;
+      inBacklash = backlashSteps < backlashAmountSteps;
+    }
+    if (count > 0) {
+      long d = targetSteps - motorSteps;
+      if (d > 0) motorSteps += d < count ? d : count;
+      inBacklash = false;
+    }
+  }
+  interrupts();
+}
+#endif
+
+#if ODRIVE_COMM_MODE == OD_CAN && ODRIVE_CAN_CYCLIC == ON
+// accept an encoder estimate message, position in turns and velocity in turns per second
+void ODriveMotor::encoderEstimate(float position, float velocity) {
+  encoderTurns = position;
+  encoderVelocity = velocity;
+  encoderTime = millis();
+  encoderValid = true;
+}
+
+// checks the encoder estimate against the setpoint, faults the axis if it's stale or too far off
+void ODriveMotor::checkFollowingError(long target) {
+  #if ODRIVE_FOLLOWING_LIMIT != OFF
+    static const float limit = degToRadF(ODRIVE_FOLLOWING_LIMIT/3600.0F);
+    status.active = true;
+    bool fault = false;
+    if (enabled) {
+      if (!encoderValid || (long)(millis() - encoderTime) > ODRIVE_CYCLIC_MS*10) {
+        if (!status.fault) { V(axisPrefix); VLF("encoder estimates lost"); }
+        fault = true;
+      } else {
+        float error = (getEncoderCount() - target)/stepsPerMeasure;
+        if (fabs(error) > limit) {
+          if (!status.fault) { V(axisPrefix); VF("following error "); V(radToDeg(error)*3600.0F); VLF(" arc-sec exceeds limit"); }
+          fault = true;
+        }
+      }
+    }
+    status.fault = fault;
+  #else
+    UNUSED(target);
+  #endif
+}
+#endif
+
 // sets dir as required and moves coord toward target at setFrequencySteps() rate
 IRAM_ATTR void ODriveMotor::move() {
   if (synchronized && !inBacklash) targetSteps += step;
@@ -49,6 +49,31 @@
   #define ODRIVE_SYNC_LIMIT  OFF
 #endif
 
+// odrive stepless mode OFF or ON, position and velocity feedforward setpoints are computed from the Axis
+// rate each poll instead of stepping the position in a timer ISR (frees the hardware timer)
+#ifndef ODRIVE_STEPLESS
+  #define ODRIVE_STEPLESS    OFF
+#endif
+
+// odrive CAN cyclic mode OFF or ON, streams position and velocity feedforward setpoints every ODRIVE_CYCLIC_MS
+// and reads back the encoder estimates the ODrive broadcasts (set axis.config.can.encoder_rate_ms to match)
+#ifndef ODRIVE_CAN_CYCLIC
+  #define ODRIVE_CAN_CYCLIC  OFF
+#endif
+#ifndef ODRIVE_CYCLIC_MS
+  #define ODRIVE_CYCLIC_MS   10
+#endif
+
+// odrive CAN bus the encoder estimates are read from, must be the one the ODrive library uses
+#ifndef ODRIVE_CAN_BUS
+  #define ODRIVE_CAN_BUS     CAN1
+#endif
+
+// odrive following error limit OFF or in arc-seconds, cyclic mode only
+#ifndef ODRIVE_FOLLOWING_LIMIT
+  #define ODRIVE_FOLLOWING_LIMIT OFF
+#endif
+
 #if ODRIVE_COMM_MODE == OD_UART
   #include <ODriveArduino.h> // https://github.com/odriverobotics/ODrive/tree/master/Arduino/ODriveArduino 
   // ODrive servo motor serial driver
@@ -115,6 +140,14 @@ class ODriveMotor : public Motor {
     // sets dir as required and moves coord toward target at setFrequencySteps() rate
     void move();
 
+    #if ODRIVE_COMM_MODE == OD_CAN && ODRIVE_CAN_CYCLIC == ON
+      // return the encoder estimate in steps
+      int32_t getEncoderCount() { return lround(encoderTurns*TWO_PI*stepsPerMeasure); }
+
+      // accept an encoder estimate message, position in turns and velocity in turns per second
+      void encoderEstimate(float position, float velocity);
+    #endif
+
   private:
 
 //  float o_position0 = 0;
@@ -130,6 +163,27 @@ class ODriveMotor : public Motor {
       command[2] = '0' + motor_number;
       ODRIVE_SERIAL.print(command);
     }
+
+    // special command to send high resolution position with velocity and torque feedforward to odrive
+    void setPosition(int motor_number, float position, float velocity) {
+      char command[48];
+      sprintF(command, "p n %1.8f ", position);
+      command[2] = '0' + motor_number;
+      ODRIVE_SERIAL.print(command);
+      sprintF(command, "%1.6f 0\n", velocity);
+      ODRIVE_SERIAL.print(command);
+    }
+    #endif
+
+    // velocity feedforward for the current setpoint in turns per second
+    float getVelocityFeedforward();
+
+    #if ODRIVE_STEPLESS == ON
+      // moves the target and motor position at the setFrequencySteps() rate since the last call
+      void advance();
+
+      unsigned long lastAdvanceTime = 0;
+      float fractionalSteps = 0.0F;
     #endif
 
     unsigned long lastSetPositionTime = 0;
@@ -146,12 +200,20 @@ class ODriveMotor : public Motor {
 
     volatile int absStep = 1;           // absolute step size (unsigned)
 
-    void (*callback)() = NULL;
-
     bool useFastHardwareTimers = true;
 
     bool isSlewing = false;
 
+    #if ODRIVE_COMM_MODE == OD_CAN && ODRIVE_CAN_CYCLIC == ON
+      // checks the encoder estimate against the setpoint, faults the axis if it's stale or too far off
+      void checkFollowingError(long target);
+
+      volatile float encoderTurns = 0.0F;
+      volatile float encoderVelocity = 0.0F;
+      volatile unsigned long encoderTime = 0;
+      bool encoderValid = false;
+    #endif
+
     DriverStatus status = { false, {false, false}, {false, false}, false, false, false, false };
     float stepsPerMeasure = 0.0F;
 };
@@ -0,0 +1,61 @@
+// -----------------------------------------------------------------------------------
+// axis servo motor encoder alpha-beta filter (fixed point)
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+// position and velocity are held with FractionBits of sub-count resolution and the gains are Q16,
+// so an update is two multiplies, a few adds, and shifts with no floating point
+template <uint8_t FractionBits = 16>
+class AlphaBetaFilter {
+  public:
+    // set the position (alpha) and velocity (beta) gains, each in the range 0 to 1
+    void setGains(float alpha, float beta) {
+      this->alpha = toQ16(alpha);
+      this->beta = toQ16(beta);
+      primed = false;
+    }
+
+    // start over from the next measurement
+    inline void reset() { primed = false; }
+
+    // update with a new measurement (in counts) and return the filtered value (in counts)
+    inline long update(long counts) {
+      int64_t measured = (int64_t)counts << FractionBits;
+      int64_t predicted = position + velocity;
+      int64_t residual = measured - predicted;
+
+      // start over on the first measurement or on a jump too large to track
+      if (!primed || residual > RESIDUAL_LIMIT || residual < -RESIDUAL_LIMIT) {
+        position = measured;
+        velocity = 0;
+        primed = true;
+        return counts;
+      }
+
+      position = predicted + ((residual*alpha) >> 16);
+      velocity += (residual*beta) >> 16;
+      return (long)((position + HALF) >> FractionBits);
+    }
+
+    // velocity estimate in counts per update
+    inline float getVelocity() { return (float)velocity*(1.0F/(float)ONE); }
+
+  private:
+    static int32_t toQ16(float gain) {
+      if (!(gain > 0.0F)) return 0;
+      if (gain >= 1.0F) return 65536L;
+      return lroundf(gain*65536.0F);
+    }
+
+    static const int64_t ONE = (int64_t)1 << FractionBits;
+    static const int64_t HALF = (int64_t)1 << (FractionBits - 1);
+    static const int64_t RESIDUAL_LIMIT = (int64_t)1 << (FractionBits + 24);
+
+    int32_t alpha = 0;
+    int32_t beta = 0;
+    int64_t position = 0;
+    int64_t velocity = 0;
+    bool primed = false;
+};
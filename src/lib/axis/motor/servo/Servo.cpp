@@ -8,16 +8,13 @@
 #include "../../../tasks/OnTask.h"
 #include "../Motor.h"
 
-ServoMotor *servoMotorInstance[9];
-IRAM_ATTR void moveServoMotorAxis1() { servoMotorInstance[0]->move(); }
-IRAM_ATTR void moveServoMotorAxis2() { servoMotorInstance[1]->move(); }
-IRAM_ATTR void moveServoMotorAxis3() { servoMotorInstance[2]->move(); }
-IRAM_ATTR void moveServoMotorAxis4() { servoMotorInstance[3]->move(); }
-IRAM_ATTR void moveServoMotorAxis5() { servoMotorInstance[4]->move(); }
-IRAM_ATTR void moveServoMotorAxis6() { servoMotorInstance[5]->move(); }
-IRAM_ATTR void moveServoMotorAxis7() { servoMotorInstance[6]->move(); }
-IRAM_ATTR void moveServoMotorAxis8() { servoMotorInstance[7]->move(); }
-IRAM_ATTR void moveServoMotorAxis9() { servoMotorInstance[8]->move(); }
+// the motion task passes the motor object to its callback
+IRAM_ATTR void moveServoMotor(void *motor) { ((ServoMotor*)motor)->move(); }
+
+#if SERVO_CONTROL_RATE != OFF
+  // the control task passes the motor object to its callback
+  void controlServoMotor(void *motor) { ((ServoMotor*)motor)->controlLoop(); }
+#endif
 
 // constructor
 ServoMotor::ServoMotor(uint8_t axisNumber, ServoDriver *Driver, Encoder *encoder, uint32_t encoderOrigin, bool encoderReverse, Feedback *feedback, ServoControl *control, long syncThreshold, bool useFastHardwareTimers) {
@@ -41,27 +38,37 @@ ServoMotor::ServoMotor(uint8_t axisNumber, ServoDriver *Driver, Encoder *encoder
   encoder->setOrigin(encoderOrigin);
   this->encoderReverse = encoderReverse;
   this->encoderReverseDefault = encoderReverse;
+  encoderFilterInit();
 
   feedback->getDefaultParameters(&default_param1, &default_param2, &default_param3, &default_param4, &default_param5, &default_param6);
 
-  // attach the function pointers to the callbacks
-  servoMotorInstance[axisNumber - 1] = this;
-  switch (axisNumber) {
-    case 1: callback = moveServoMotorAxis1; break;
-    case 2: callback = moveServoMotorAxis2; break;
-    case 3: callback = moveServoMotorAxis3; break;
-    case 4: callback = moveServoMotorAxis4; break;
-    case 5: callback = moveServoMotorAxis5; break;
-    case 6: callback = moveServoMotorAxis6; break;
-    case 7: callback = moveServoMotorAxis7; break;
-    case 8: callback = moveServoMotorAxis8; break;
-    case 9: callback = moveServoMotorAxis9; break;
-  }
-
   // get the feedback control loop ready
   feedback->init(axisNumber, control, driver->getMotorControlRange());
 }
 
+// dual loop control, the motor shaft encoder closes an inner velocity loop under the position loop
+void ServoMotor::setMotorEncoder(Encoder *motorEncoder, bool motorEncoderReverse, float motorEncoderRatio, Feedback *velocityFeedback, ServoControl *velocityControl, float positionLimit) {
+  if (motorEncoderRatio <= 0.0F) { V(axisPrefix); VLF("motor encoder ratio invalid, dual loop control disabled"); return; }
+
+  this->motorEncoderReverse = motorEncoderReverse;
+  this->motorEncoderRatio = motorEncoderRatio;
+  this->velocityFeedback = velocityFeedback;
+  this->velocityControl = velocityControl;
+
+  motorEncoder->init();
+
+  // the velocity loop drives the motor, velocity error is in counts per second
+  velocityFeedback->init(axisNumber, velocityControl, driver->getMotorControlRange());
+
+  // the position loop now outputs a velocity correction in counts per second and runs slower
+  feedback->setControlRange(positionLimit);
+  feedback->setSampleTime(PID_SAMPLE_TIME_US*SERVO_POSITION_LOOP_DIVIDER);
+
+  this->motorEncoder = motorEncoder;
+
+  V(axisPrefix); VF("dual loop control, motor encoder ratio "); VL(motorEncoderRatio);
+}
+
 bool ServoMotor::init() {
   if (axisNumber < 1 || axisNumber > 9) return false;
 
@@ -73,7 +80,7 @@ bool ServoMotor::init() {
   VF("start task to track motion... ");
   char timerName[] = "Servo_";
   timerName[5] = '0' + axisNumber;
-  taskHandle = tasks.add(0, 0, true, 0, callback, timerName);
+  taskHandle = tasks.add(0, 0, true, 0, moveServoMotor, this, timerName);
   if (taskHandle) {
     VF("success");
     if (useFastHardwareTimers) {
@@ -89,12 +96,45 @@ bool ServoMotor::init() {
     return false;
   }
 
+  #if SERVO_TRACE != OFF
+    if (axisNumber == SERVO_TRACE) {
+      V(axisPrefix); VF("allocating trace buffer for "); V(SERVO_TRACE_SIZE); VLF(" samples");
+      trace = new ServoTrace;
+    }
+  #endif
+
+  #if SERVO_CONTROL_RATE != OFF
+    // start the control loop timer
+    V(axisPrefix);
+    VF("start task for control loop at "); V(SERVO_CONTROL_RATE); VF(" Hz... ");
+    char controlName[] = "SvoCt_";
+    controlName[5] = '0' + axisNumber;
+    controlHandle = tasks.add(0, 0, true, 0, controlServoMotor, this, controlName);
+    if (controlHandle) {
+      VF("success");
+      tasks.setPeriodMicros(controlHandle, lround(1000000.0F/SERVO_CONTROL_RATE));
+      // floating point isn't allowed in ESP32 ISRs so it stays a (priority 0) task there
+      #ifndef ESP32
+        if (useFastHardwareTimers && !tasks.requestHardwareTimer(controlHandle, 0)) { VF(" (no hardware timer!)"); }
+      #endif
+      VLF("");
+    } else {
+      VLF("FAILED!");
+      return false;
+    }
+  #endif
+
   return true;
 }
 
 // set driver reverse state
 void ServoMotor::setReverse(int8_t state) {
-  feedback->setControlDirection(state);
+  if (motorEncoder != NULL) {
+    // the position loop works in counts so only the velocity loop follows the motor direction
+    feedback->setControlDirection(OFF);
+    velocityFeedback->setControlDirection(state);
+  } else feedback->setControlDirection(state);
+  controlDirection = state;
   if (state == ON) encoderReverse = encoderReverseDefault; else encoderReverse = !encoderReverseDefault; 
 }
 
@@ -110,6 +150,7 @@ bool ServoMotor::validateParameters(float param1, float param2, float param3, fl
 
 // sets motor enable on/off (if possible)
 void ServoMotor::enable(bool state) {
+  if (!state) autotune.abort();
   driver->enable(state);
   enabled = state;
 }
@@ -160,20 +201,25 @@ void ServoMotor::setInstrumentCoordinateSteps(long value) {
 // distance to target in steps (+/-)
 long ServoMotor::getTargetDistanceSteps() {
   long encoderCounts = encoderRead();
-  noInterrupts();
-  long dist = targetSteps - encoderCounts;
-  interrupts();
-  return dist;
+  return targetSteps - encoderCounts;
 }
 
 // set frequency (+/-) in steps per second negative frequencies move reverse in direction (0 stops motion)
 void ServoMotor::setFrequencySteps(float frequency) {
+  // commanded acceleration from the change in requested frequency, the axis updates this at a fixed rate
+  unsigned long now = micros();
+  float acceleration = 0.0F;
+  unsigned long elapsed = now - lastFrequencyTime;
+  if (elapsed > 0 && elapsed < 100000UL) acceleration = ((frequency - lastFrequency)*1000000.0F)/elapsed;
+  lastFrequency = frequency;
+  lastFrequencyTime = now;
+
   // negative frequency, convert to positive and reverse the direction
   int dir = 0;
   if (frequency > 0.0F) dir = 1; else if (frequency < 0.0F) { frequency = -frequency; dir = -1; }
 
   // if in backlash override the frequency
-  if (inBacklash) frequency = backlashFrequency;
+  if (inBacklash) { frequency = backlashFrequency; acceleration = 0.0F; }
 
   if (frequency != currentFrequency) {
     // compensate for performace limitations by taking larger steps as needed
@@ -213,6 +259,10 @@ void ServoMotor::setFrequencySteps(float frequency) {
   step = dir * stepSize;
   absStep = abs(step);
   interrupts();
+
+  // velocity estimate is sign reversed relative to frequency, acceleration follows
+  if (lastPeriod == 0) acceleration = 0.0F;
+  feedback->setFeedforward(velocityEstimate, -acceleration);
 }
 
 float ServoMotor::getFrequencySteps() {
@@ -223,10 +273,13 @@ float ServoMotor::getFrequencySteps() {
 // set slewing state (hint that we are about to slew or are done slewing)
 void ServoMotor::setSlewing(bool state) {
   slewing = state;
+  #if SERVO_TRACE != OFF
+    if (state && trace != NULL) trace->trigger(TT_SLEW);
+  #endif
 }
 
-// updates PID and sets servo motor power/direction
-void ServoMotor::poll() {
+// reads the encoder, updates PID, and sets servo motor power/direction
+void ServoMotor::controlLoop() {
   long encoderCounts = encoderRead();
 
   long encoderCountsOrig = encoderCounts;
@@ -243,25 +296,84 @@ void ServoMotor::poll() {
     }
   }
 
-  long motorCounts = 0;
-
-  noInterrupts();
-  motorCounts = motorSteps;
-  interrupts();
+  long motorCounts = motorSteps;
 
   encoderCounts = encoderApplyFilter(encoderCounts - motorCounts) + motorCounts;
 
   control->set = motorCounts;
   control->in = encoderCounts;
-  if (enabled) feedback->poll();
 
-  float velocity = velocityEstimate + control->out;
+  float velocity;
+  if (autotune.state == AT_RUNNING) {
+    // relay feedback replaces the PID while autotuning
+    long error = motorCounts - encoderCounts;
+    if (controlDirection == ON) error = -error;
+    velocity = feedback->getFeedforward() + autotune.update(error);
+  } else if (motorEncoder != NULL) {
+    // the position loop sets the velocity the velocity loop holds, both PIDs pace themselves to their own sample time
+    motorEncoder->readLatched();
+    float motorVelocity = motorEncoder->getVelocity()/motorEncoderRatio;
+    if (motorEncoderReverse != encoderReverse) motorVelocity = -motorVelocity;
+    if (enabled) feedback->poll();
+    velocityControl->set = lastFrequency + control->out;
+    velocityControl->in = motorVelocity;
+    if (enabled) velocityFeedback->poll();
+    velocity = feedback->getFeedforward() + velocityControl->out;
+  } else {
+    if (enabled) feedback->poll();
+    velocity = feedback->getFeedforward() + control->out;
+  }
   if (!enabled) velocity = 0.0F;
 
   delta = motorCounts - encoderCounts;
   velocityPercent = (driver->setMotorVelocity(velocity)/driver->getMotorControlRange()) * 100.0F;
   if (driver->getMotorDirection() == DIR_FORWARD) control->directionHint = 1; else control->directionHint = -1;
 
+  controlEncoderCounts = encoderCounts;
+  controlEncoderCountsOrig = encoderCountsOrig;
+
+  #if SERVO_TRACE != OFF
+    if (trace != NULL) trace->record(motorCounts, encoderCounts, (control->out/driver->getMotorControlRange())*100.0F, velocityPercent);
+  #endif
+}
+
+// start a relay feedback autotune experiment
+bool ServoMotor::autotuneStart() {
+  if (!enabled || autotune.state == AT_RUNNING) return false;
+
+  float relay = SERVO_AUTOTUNE_RELAY;
+  if (relay < 1.0F) relay = 1.0F;
+  if (relay > 30.0F) relay = 30.0F;
+
+  V(axisPrefix); VF("autotune started with relay at "); V(relay); VLF("%");
+  autotune.start(driver->getMotorControlRange()*relay/100.0F);
+  return true;
+}
+
+// servo motor safety checks and parameter switching, also runs the control loop if not at a fixed rate
+void ServoMotor::poll() {
+  #if SERVO_CONTROL_RATE == OFF
+    controlLoop();
+  #endif
+
+  // the control ISR updates both encoder counts together, the step ISR the motor count
+  long encoderCounts, encoderCountsOrig, motorCounts;
+  do {
+    isrSnapshot(controlEncoderCounts, controlEncoderCountsOrig, &encoderCounts, &encoderCountsOrig);
+    motorCounts = motorSteps;
+  } while (encoderCounts != controlEncoderCounts);
+
+  // velocity from the encoder's own estimate unless the alpha-beta filter provides it
+  if (!encoderFilterAlphaBeta) encoderVelocity = encoderReverse ? -encoder->getVelocity() : encoder->getVelocity();
+
+  // the PID restarts from a clean state once an autotune experiment has ended
+  bool autotuneRunning = autotune.state == AT_RUNNING;
+  if (autotuneWasRunning && !autotuneRunning) {
+    feedback->reset();
+    if (motorEncoder != NULL) velocityFeedback->reset();
+  }
+  autotuneWasRunning = autotuneRunning;
+
   if (feedback->useVariableParameters) {
     feedback->variableParameters(fabs(velocityPercent));
   } else {
@@ -284,6 +396,9 @@ void ServoMotor::poll() {
         D(axisPrefix);
         D("stall detected!"); D(" control->in = "); D(control->in); D(", control->set = "); D(control->set);
         D(", control->out = "); D(control->out); D(", velocity % = "); DL(velocityPercent);
+        #if SERVO_TRACE != OFF
+          if (trace != NULL) trace->trigger(TT_STALL);
+        #endif
         enable(false);
       }
 
@@ -291,6 +406,9 @@ void ServoMotor::poll() {
       if (labs(encoderCounts - lastEncoderCounts) > lastTargetDistance && abs(velocityPercent) >= 90) {
         D(axisPrefix);
         DL("runaway detected, > 90% power while moving away from the target!");
+        #if SERVO_TRACE != OFF
+          if (trace != NULL) trace->trigger(TT_STALL);
+        #endif
         enable(false);
       }
       lastTargetDistance = labs(encoderCounts - lastEncoderCounts);
@@ -299,6 +417,9 @@ void ServoMotor::poll() {
       if (wasBelow33 && wasAbove33) {
         D(axisPrefix);
         DL("oscillation detected, below -33% and above 33% power in a 2 second period!");
+        #if SERVO_TRACE != OFF
+          if (trace != NULL) trace->trigger(TT_STALL);
+        #endif
         enable(false);
       }
     #endif
@@ -335,6 +456,7 @@ void ServoMotor::poll() {
   #endif
 
   UNUSED(encoderCountsOrig);
+  UNUSED(motorCounts);
 }
 
 // sets dir as required and moves coord toward target at setFrequencySteps() rate
@@ -378,7 +500,7 @@ IRAM_ATTR void ServoMotor::move() {
 }
 
 int32_t ServoMotor::encoderRead() {
-  int32_t encoderCounts = encoder->read();
+  int32_t encoderCounts = encoder->readLatched().count;
 
 
   if (encoderReverse) encoderCounts = -encoderCounts;
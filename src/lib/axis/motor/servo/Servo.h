@@ -12,18 +12,45 @@
 #include "../../../encoder/pulseOnly/PulseOnly.h"
 #include "../../../encoder/quadrature/Quadrature.h"
 #include "../../../encoder/quadratureEsp32/QuadratureEsp32.h"
+#include "../../../encoder/quadratureStm32/QuadratureStm32.h"
+#include "../../../encoder/quadratureTeensy4/QuadratureTeensy4.h"
 #include "../../../encoder/serialBridge/SerialBridge.h"
 
 #include "dc/Dc.h"
 #include "tmc2209/Tmc2209.h"
 #include "tmc5160/Tmc5160.h"
 
+// rate in Hz for the encoder read, filter, PID, and motor velocity control loop or OFF to run it from the axis poll
+// uses a hardware timer if one is free, so the encoder and driver must be safe to use from an ISR (DC, quadrature, etc.)
+#ifndef SERVO_CONTROL_RATE
+  #define SERVO_CONTROL_RATE OFF
+#endif
+
 #include "feedback/Pid/Pid.h"
+#include "AlphaBetaFilter.h"
+class SimpleKalmanFilter;
+#include "ServoTrace.h"
+#include "feedback/Autotune.h"
+
+// rate in Hz that the encoder filter is updated at, for its velocity estimate
+#if SERVO_CONTROL_RATE != OFF
+  #define SERVO_FILTER_RATE SERVO_CONTROL_RATE
+#else
+  #ifndef FRACTIONAL_SEC
+    #define FRACTIONAL_SEC 100.0F
+  #endif
+  #define SERVO_FILTER_RATE FRACTIONAL_SEC
+#endif
 
 #ifndef SERVO_SLEW_DIRECT
   #define SERVO_SLEW_DIRECT OFF
 #endif
 
+// control loop passes per position loop update when dual loop control (motor and axis encoders) is in use
+#ifndef SERVO_POSITION_LOOP_DIVIDER
+  #define SERVO_POSITION_LOOP_DIVIDER 4
+#endif
+
 #ifndef SERVO_SLEWING_TO_TRACKING_DELAY
   #define SERVO_SLEWING_TO_TRACKING_DELAY 3000 // in milliseconds
 #endif
@@ -33,6 +60,11 @@ class ServoMotor : public Motor {
     // constructor
     ServoMotor(uint8_t axisNumber, ServoDriver *Driver, Encoder *encoder, uint32_t encoderOrigin, bool encoderReverse, Feedback *feedback, ServoControl *control, long syncThreshold, bool useFastHardwareTimers = true);
 
+    // dual loop control, call before init(), the motor shaft encoder closes an inner velocity loop under
+    // the (slower) position loop on the axis encoder, motorEncoderRatio is motor encoder counts per axis encoder count
+    // and positionLimit is the largest velocity correction the position loop can ask for in counts per second
+    void setMotorEncoder(Encoder *motorEncoder, bool motorEncoderReverse, float motorEncoderRatio, Feedback *velocityFeedback, ServoControl *velocityControl, float positionLimit);
+
     // sets up the servo motor
     bool init();
 
@@ -81,14 +113,24 @@ class ServoMotor : public Motor {
     // get encoder count
     int32_t getEncoderCount() { return encoder->count; }
 
-    // updates PID and sets servo motor power/direction
+    // reads the encoder, updates PID, and sets servo motor power/direction
+    void controlLoop();
+
+    // servo motor safety checks and parameter switching, also runs the control loop if not at a fixed rate
     void poll();
 
+    // start a relay feedback autotune experiment, the motor must be enabled and at rest
+    bool autotuneStart();
+
+    // stop any autotune experiment in progress
+    inline void autotuneAbort() { autotune.abort(); }
+
     // sets dir as required and moves coord toward target at setFrequencySteps() rate
     void move();
     
     // calibrate the motor driver
-    void calibrateDriver() { driver->calibrateDriver(); }
+    bool calibrateDriverStart() { return driver->calibrateDriverStart(); }
+    void calibrateDriverFinish() { driver->calibrateDriverFinish(); }
 
     int32_t encoderRead();
 
@@ -98,16 +140,34 @@ class ServoMotor : public Motor {
     // servo encoder
     Encoder *encoder;
 
+    // motor shaft encoder for dual loop control or NULL
+    Encoder *motorEncoder = NULL;
+
+    // relay feedback autotune
+    Autotune autotune;
+
+    #if SERVO_TRACE != OFF
+      // trace capture buffer, only present on the SERVO_TRACE axis
+      ServoTrace *trace = NULL;
+    #endif
+
     float velocityPercent = 0.0F;
     long delta = 0;
+    float encoderVelocity = 0.0F;       // encoder velocity estimate in counts per second
 
   private:
     float velocityEstimate = 0.0F;
     float velocityOverride = 0.0F;
 
+    void encoderFilterInit();
     long encoderApplyFilter(long encoderCounts);
 
+    AlphaBetaFilter<> encoderFilter;
+    bool encoderFilterAlphaBeta = false;
+    SimpleKalmanFilter *encoderFilterKalman = NULL;
+
     uint8_t servoMonitorHandle = 0;
+    uint8_t controlHandle = 0;
     uint8_t taskHandle = 0;
     float maxFrequency = HAL_FRACTIONAL_SEC; // fastest timer rate
 
@@ -116,10 +176,15 @@ class ServoMotor : public Motor {
     volatile bool takeStep = false;     // should we take a step
 
     float currentFrequency = 0.0F;      // last frequency set 
-    float lastFrequency = 0.0F;         // last frequency requested
+    float lastFrequency = 0.0F;         // last frequency requested (+/-)
+    unsigned long lastFrequencyTime = 0; // time of the last frequency request (in microseconds)
     unsigned long lastPeriod = 0;       // last timer period (in sub-micros)
     long syncThreshold = OFF;           // sync threshold in counts (for absolute encoders) or OFF
+    int8_t controlDirection = OFF;      // feedback control direction, ON for reverse action
+    bool autotuneWasRunning = false;    // autotune state at the last poll
 
+    volatile long controlEncoderCounts = 0;     // filtered encoder position from the last control loop pass
+    volatile long controlEncoderCountsOrig = 0; // unfiltered encoder position from the last control loop pass
     long lastEncoderCounts = 0;         // the last encoder position for stall check
     unsigned long lastCheckTime = 0;    // time since the last encoder position was checked
     unsigned long startTime = 0;        // time at start of servo polling
@@ -128,11 +193,14 @@ class ServoMotor : public Motor {
     volatile int absStep = 1;           // absolute step size (unsigned)
     volatile long originIndexSteps = 0; // for absolute motor position to axis position at coordinate origin
 
-    void (*callback)() = NULL;
-
     Feedback *feedback;
     ServoControl *control;
 
+    Feedback *velocityFeedback = NULL;  // dual loop velocity feedback
+    ServoControl *velocityControl = NULL;
+    float motorEncoderRatio = 1.0F;     // motor encoder counts per axis encoder count
+    bool motorEncoderReverse = false;
+
     bool useFastHardwareTimers = true;
     bool slewing = false;
     bool motorStepsInitDone = false;
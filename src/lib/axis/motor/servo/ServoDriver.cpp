@@ -9,6 +9,7 @@
 #define SERVO_DRIVER_MODEL_COUNT 3
 
 #include "../Motor.h"
+#include "../../../counters/Counters.h"
 
 #if DEBUG != OFF
   const char* SERVO_DRIVER_NAME[SERVO_DRIVER_MODEL_COUNT] =
@@ -20,6 +21,8 @@
 #endif
 
 void ServoDriver::init() {
+  faultCounter = counters.add("DrvFlt");
+
   #if DEBUG == VERBOSE
     VF("MSG: ServoDriver"); V(axisNumber); VF(", init model "); VL(SERVO_DRIVER_NAME[model - SERVO_DRIVER_FIRST]);
     VF("MSG: ServoDriver"); V(axisNumber); VF(", en=");
@@ -36,6 +39,9 @@ void ServoDriver::init() {
 
 // update status info. for driver
 void ServoDriver::updateStatus() {
+  if (status.fault && !faultLast) counters.increment(faultCounter);
+  faultLast = status.fault;
+
   #if DEBUG == VERBOSE
     if ((status.outputA.shortToGround     != lastStatus.outputA.shortToGround) ||
         (status.outputA.openLoad          != lastStatus.outputA.openLoad) ||
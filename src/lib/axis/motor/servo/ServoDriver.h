@@ -71,8 +71,11 @@ class ServoDriver {
     // this is a required method for the Axis class
     DriverStatus getStatus() { return status; }
    
-    // calibrate the motor if required
-    virtual void calibrateDriver() {}
+    // start calibrating the motor driver, true if it must be held at standstill before calibrateDriverFinish()
+    virtual bool calibrateDriverStart() { return false; }
+
+    // finish calibrating the motor driver
+    virtual void calibrateDriverFinish() {}
 
     // return the velocity estimate factor
     virtual float getVelocityEstimate(float frequency) {
@@ -99,6 +102,10 @@ class ServoDriver {
     #endif
     unsigned long timeLastStatusUpdate = 0;
 
+    // health counter shared by all drivers, counts each time a fault is first seen
+    uint8_t faultCounter = 0;
+    bool faultLast = false;
+
     int16_t model = OFF;
     int16_t statusMode = OFF;
 
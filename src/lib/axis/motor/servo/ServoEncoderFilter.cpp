@@ -33,90 +33,166 @@
   #define AXIS9_SERVO_FLTR OFF
 #endif
 
+// ALPHA_BETA filter position (alpha) and velocity (beta) gains, 0 to 1
+#ifndef AXIS1_SERVO_FLTR_ALPHA
+  #define AXIS1_SERVO_FLTR_ALPHA 0.5
+#endif
+#ifndef AXIS1_SERVO_FLTR_BETA
+  #define AXIS1_SERVO_FLTR_BETA 0.15
+#endif
+#ifndef AXIS2_SERVO_FLTR_ALPHA
+  #define AXIS2_SERVO_FLTR_ALPHA 0.5
+#endif
+#ifndef AXIS2_SERVO_FLTR_BETA
+  #define AXIS2_SERVO_FLTR_BETA 0.15
+#endif
+#ifndef AXIS3_SERVO_FLTR_ALPHA
+  #define AXIS3_SERVO_FLTR_ALPHA 0.5
+#endif
+#ifndef AXIS3_SERVO_FLTR_BETA
+  #define AXIS3_SERVO_FLTR_BETA 0.15
+#endif
+#ifndef AXIS4_SERVO_FLTR_ALPHA
+  #define AXIS4_SERVO_FLTR_ALPHA 0.5
+#endif
+#ifndef AXIS4_SERVO_FLTR_BETA
+  #define AXIS4_SERVO_FLTR_BETA 0.15
+#endif
+#ifndef AXIS5_SERVO_FLTR_ALPHA
+  #define AXIS5_SERVO_FLTR_ALPHA 0.5
+#endif
+#ifndef AXIS5_SERVO_FLTR_BETA
+  #define AXIS5_SERVO_FLTR_BETA 0.15
+#endif
+#ifndef AXIS6_SERVO_FLTR_ALPHA
+  #define AXIS6_SERVO_FLTR_ALPHA 0.5
+#endif
+#ifndef AXIS6_SERVO_FLTR_BETA
+  #define AXIS6_SERVO_FLTR_BETA 0.15
+#endif
+#ifndef AXIS7_SERVO_FLTR_ALPHA
+  #define AXIS7_SERVO_FLTR_ALPHA 0.5
+#endif
+#ifndef AXIS7_SERVO_FLTR_BETA
+  #define AXIS7_SERVO_FLTR_BETA 0.15
+#endif
+#ifndef AXIS8_SERVO_FLTR_ALPHA
+  #define AXIS8_SERVO_FLTR_ALPHA 0.5
+#endif
+#ifndef AXIS8_SERVO_FLTR_BETA
+  #define AXIS8_SERVO_FLTR_BETA 0.15
+#endif
+#ifndef AXIS9_SERVO_FLTR_ALPHA
+  #define AXIS9_SERVO_FLTR_ALPHA 0.5
+#endif
+#ifndef AXIS9_SERVO_FLTR_BETA
+  #define AXIS9_SERVO_FLTR_BETA 0.15
+#endif
+
 #if AXIS1_SERVO_FLTR == KALMAN || AXIS2_SERVO_FLTR == KALMAN || AXIS3_SERVO_FLTR == KALMAN || \
     AXIS4_SERVO_FLTR == KALMAN || AXIS5_SERVO_FLTR == KALMAN || AXIS6_SERVO_FLTR == KALMAN || \
     AXIS7_SERVO_FLTR == KALMAN || AXIS8_SERVO_FLTR == KALMAN || AXIS9_SERVO_FLTR == KALMAN
   #include <SimpleKalmanFilter.h> // https://github.com/denyssene/SimpleKalmanFilter
+  #define SERVO_FLTR_KALMAN_PRESENT
 #endif
 
 #if AXIS1_SERVO_FLTR == KALMAN
   SimpleKalmanFilter axis1EncoderKalmanFilter(AXIS1_SERVO_FLTR_MEAS_U, AXIS1_SERVO_FLTR_MEAS_U, AXIS1_SERVO_FLTR_VARIANCE);
+  #define AXIS1_SERVO_FLTR_KALMAN &axis1EncoderKalmanFilter
+#else
+  #define AXIS1_SERVO_FLTR_KALMAN NULL
 #endif
 #if AXIS2_SERVO_FLTR == KALMAN
   SimpleKalmanFilter axis2EncoderKalmanFilter(AXIS2_SERVO_FLTR_MEAS_U, AXIS2_SERVO_FLTR_MEAS_U, AXIS2_SERVO_FLTR_VARIANCE);
+  #define AXIS2_SERVO_FLTR_KALMAN &axis2EncoderKalmanFilter
+#else
+  #define AXIS2_SERVO_FLTR_KALMAN NULL
 #endif
 #if AXIS3_SERVO_FLTR == KALMAN
   SimpleKalmanFilter axis3EncoderKalmanFilter(AXIS3_SERVO_FLTR_MEAS_U, AXIS3_SERVO_FLTR_MEAS_U, AXIS3_SERVO_FLTR_VARIANCE);
+  #define AXIS3_SERVO_FLTR_KALMAN &axis3EncoderKalmanFilter
+#else
+  #define AXIS3_SERVO_FLTR_KALMAN NULL
 #endif
 #if AXIS4_SERVO_FLTR == KALMAN
   SimpleKalmanFilter axis4EncoderKalmanFilter(AXIS4_SERVO_FLTR_MEAS_U, AXIS4_SERVO_FLTR_MEAS_U, AXIS4_SERVO_FLTR_VARIANCE);
+  #define AXIS4_SERVO_FLTR_KALMAN &axis4EncoderKalmanFilter
+#else
+  #define AXIS4_SERVO_FLTR_KALMAN NULL
 #endif
 #if AXIS5_SERVO_FLTR == KALMAN
   SimpleKalmanFilter axis5EncoderKalmanFilter(AXIS5_SERVO_FLTR_MEAS_U, AXIS5_SERVO_FLTR_MEAS_U, AXIS5_SERVO_FLTR_VARIANCE);
+  #define AXIS5_SERVO_FLTR_KALMAN &axis5EncoderKalmanFilter
+#else
+  #define AXIS5_SERVO_FLTR_KALMAN NULL
 #endif
 #if AXIS6_SERVO_FLTR == KALMAN
   SimpleKalmanFilter axis6EncoderKalmanFilter(AXIS6_SERVO_FLTR_MEAS_U, AXIS6_SERVO_FLTR_MEAS_U, AXIS6_SERVO_FLTR_VARIANCE);
+  #define AXIS6_SERVO_FLTR_KALMAN &axis6EncoderKalmanFilter
+#else
+  #define AXIS6_SERVO_FLTR_KALMAN NULL
 #endif
 #if AXIS7_SERVO_FLTR == KALMAN
   SimpleKalmanFilter axis7EncoderKalmanFilter(AXIS7_SERVO_FLTR_MEAS_U, AXIS7_SERVO_FLTR_MEAS_U, AXIS7_SERVO_FLTR_VARIANCE);
+  #define AXIS7_SERVO_FLTR_KALMAN &axis7EncoderKalmanFilter
+#else
+  #define AXIS7_SERVO_FLTR_KALMAN NULL
 #endif
 #if AXIS8_SERVO_FLTR == KALMAN
   SimpleKalmanFilter axis8EncoderKalmanFilter(AXIS8_SERVO_FLTR_MEAS_U, AXIS8_SERVO_FLTR_MEAS_U, AXIS8_SERVO_FLTR_VARIANCE);
+  #define AXIS8_SERVO_FLTR_KALMAN &axis8EncoderKalmanFilter
+#else
+  #define AXIS8_SERVO_FLTR_KALMAN NULL
 #endif
 #if AXIS9_SERVO_FLTR == KALMAN
   SimpleKalmanFilter axis9EncoderKalmanFilter(AXIS9_SERVO_FLTR_MEAS_U, AXIS9_SERVO_FLTR_MEAS_U, AXIS9_SERVO_FLTR_VARIANCE);
+  #define AXIS9_SERVO_FLTR_KALMAN &axis9EncoderKalmanFilter
+#else
+  #define AXIS9_SERVO_FLTR_KALMAN NULL
 #endif
 
+// the filter settings for each axis, resolved at compile time so the filter code needs no per-axis branches
+typedef struct ServoFilterConfig {
+  int16_t type;
+  float alpha;
+  float beta;
+  SimpleKalmanFilter *kalman;
+} ServoFilterConfig;
+
+static const ServoFilterConfig servoFilterConfig[9] = {
+  {AXIS1_SERVO_FLTR, AXIS1_SERVO_FLTR_ALPHA, AXIS1_SERVO_FLTR_BETA, AXIS1_SERVO_FLTR_KALMAN},
+  {AXIS2_SERVO_FLTR, AXIS2_SERVO_FLTR_ALPHA, AXIS2_SERVO_FLTR_BETA, AXIS2_SERVO_FLTR_KALMAN},
+  {AXIS3_SERVO_FLTR, AXIS3_SERVO_FLTR_ALPHA, AXIS3_SERVO_FLTR_BETA, AXIS3_SERVO_FLTR_KALMAN},
+  {AXIS4_SERVO_FLTR, AXIS4_SERVO_FLTR_ALPHA, AXIS4_SERVO_FLTR_BETA, AXIS4_SERVO_FLTR_KALMAN},
+  {AXIS5_SERVO_FLTR, AXIS5_SERVO_FLTR_ALPHA, AXIS5_SERVO_FLTR_BETA, AXIS5_SERVO_FLTR_KALMAN},
+  {AXIS6_SERVO_FLTR, AXIS6_SERVO_FLTR_ALPHA, AXIS6_SERVO_FLTR_BETA, AXIS6_SERVO_FLTR_KALMAN},
+  {AXIS7_SERVO_FLTR, AXIS7_SERVO_FLTR_ALPHA, AXIS7_SERVO_FLTR_BETA, AXIS7_SERVO_FLTR_KALMAN},
+  {AXIS8_SERVO_FLTR, AXIS8_SERVO_FLTR_ALPHA, AXIS8_SERVO_FLTR_BETA, AXIS8_SERVO_FLTR_KALMAN},
+  {AXIS9_SERVO_FLTR, AXIS9_SERVO_FLTR_ALPHA, AXIS9_SERVO_FLTR_BETA, AXIS9_SERVO_FLTR_KALMAN}
+};
+
+void ServoMotor::encoderFilterInit() {
+  const ServoFilterConfig *config = &servoFilterConfig[axisNumber - 1];
+  if (config->type == ALPHA_BETA) {
+    encoderFilter.setGains(config->alpha, config->beta);
+    encoderFilterAlphaBeta = true;
+  }
+  if (config->type == KALMAN) encoderFilterKalman = config->kalman;
+}
+
 long ServoMotor::encoderApplyFilter(long encoderCounts) {
 
   // apply Kalaman filter if enabled
-  switch (axisNumber) {
-    case 1:
-      #if AXIS1_SERVO_FLTR == KALMAN
-        encoderCounts = round(axis1EncoderKalmanFilter.updateEstimate(encoderCounts));
-      #endif
-    break;
-    case 2:
-      #if AXIS2_SERVO_FLTR == KALMAN
-        encoderCounts = round(axis2EncoderKalmanFilter.updateEstimate(encoderCounts));
-      #endif
-    break;
-    case 3:
-      #if AXIS3_SERVO_FLTR == KALMAN
-        encoderCounts = round(axis3EncoderKalmanFilter.updateEstimate(encoderCounts));
-      #endif
-    break;
-    case 4:
-      #if AXIS4_SERVO_FLTR == KALMAN
-        encoderCounts = round(axis4EncoderKalmanFilter.updateEstimate(encoderCounts));
-      #endif
-    break;
-    case 5:
-      #if AXIS5_SERVO_FLTR == KALMAN
-        encoderCounts = round(axis5EncoderKalmanFilter.updateEstimate(encoderCounts));
-      #endif
-    break;
-    case 6:
-      #if AXIS6_SERVO_FLTR == KALMAN
-        encoderCounts = round(axis6EncoderKalmanFilter.updateEstimate(encoderCounts));
-      #endif
-    break;
-    case 7:
-      #if AXIS7_SERVO_FLTR == KALMAN
-        encoderCounts = round(axis7EncoderKalmanFilter.updateEstimate(encoderCounts));
-      #endif
-    break;
-    case 8:
-      #if AXIS8_SERVO_FLTR == KALMAN
-        encoderCounts = round(axis8EncoderKalmanFilter.updateEstimate(encoderCounts));
-      #endif
-    break;
-    case 9:
-      #if AXIS9_SERVO_FLTR == KALMAN
-        encoderCounts = round(axis9EncoderKalmanFilter.updateEstimate(encoderCounts));
-      #endif
-    break;
+  #ifdef SERVO_FLTR_KALMAN_PRESENT
+    if (encoderFilterKalman != NULL) encoderCounts = round(encoderFilterKalman->updateEstimate(encoderCounts));
+  #endif
+
+  // apply alpha-beta filter if enabled, the filter sees the position error so add back the commanded rate for velocity
+  if (encoderFilterAlphaBeta) {
+    encoderCounts = encoderFilter.update(encoderCounts);
+    encoderVelocity = encoderFilter.getVelocity()*SERVO_FILTER_RATE + lastFrequency;
   }
+
   return encoderCounts;
 }
 
@@ -0,0 +1,41 @@
+// -----------------------------------------------------------------------------------
+// axis servo motor trace capture
+
+#include "ServoTrace.h"
+
+#if defined(SERVO_MOTOR_PRESENT) && SERVO_TRACE != OFF
+
+// start recording and wait for the trigger
+void ServoTrace::arm(TraceTrigger source, long threshold) {
+  noInterrupts();
+  state = TS_IDLE;
+  head = 0;
+  count = 0;
+  triggerSource = source;
+  this->threshold = threshold;
+  state = TS_ARMED;
+  interrupts();
+
+  if (source == TT_NOW) trigger(TT_NOW);
+}
+
+// format two samples starting at index, each is time, set, in, out, velocity as fixed width hex
+bool ServoTrace::getSamples(uint16_t index, char *reply) {
+  if (state != TS_DONE || index >= count) return false;
+
+  reply[0] = 0;
+  for (uint16_t i = index; i < index + 2 && i < count; i++) {
+    ServoTraceSample *sample = &buffer[(head + SERVO_TRACE_SIZE - count + i) % SERVO_TRACE_SIZE];
+    char s[34];
+    sprintf(s, "%08lX%08lX%08lX%04X%04X",
+      (unsigned long)sample->time,
+      (unsigned long)(uint32_t)sample->set,
+      (unsigned long)(uint32_t)sample->in,
+      (unsigned int)(uint16_t)sample->out,
+      (unsigned int)(uint16_t)sample->velocity);
+    strcat(reply, s);
+  }
+  return true;
+}
+
+#endif
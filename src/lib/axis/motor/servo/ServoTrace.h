@@ -0,0 +1,83 @@
+// -----------------------------------------------------------------------------------
+// axis servo motor trace capture
+#pragma once
+#include "../../../../Common.h"
+
+#ifdef SERVO_MOTOR_PRESENT
+
+// axis number (1 to 9) to keep a trace capture buffer for or OFF
+#ifndef SERVO_TRACE
+  #define SERVO_TRACE OFF
+#endif
+#ifndef SERVO_TRACE_SIZE
+  #define SERVO_TRACE_SIZE 256 // samples, 16 bytes each, 1/4 of them are before the trigger
+#endif
+
+#if SERVO_TRACE != OFF
+
+enum TraceTrigger: uint8_t {TT_NONE, TT_NOW, TT_SLEW, TT_STALL, TT_ERROR};
+enum TraceState: uint8_t {TS_IDLE, TS_ARMED, TS_TRIGGERED, TS_DONE};
+
+#pragma pack(1)
+typedef struct ServoTraceSample {
+  uint32_t time;     // in microseconds
+  int32_t set;       // motor position in counts
+  int32_t in;        // encoder position in counts
+  int16_t out;       // control output in 0.01% of the control range
+  int16_t velocity;  // motor velocity in 0.01% of the control range
+} ServoTraceSample;
+#pragma pack()
+
+class ServoTrace {
+  public:
+    // start recording and wait for the trigger, threshold is the position error (in counts) for TT_ERROR
+    void arm(TraceTrigger source, long threshold = 0);
+
+    // trigger the capture if armed for this source
+    inline void trigger(TraceTrigger source) {
+      if (state == TS_ARMED && source == triggerSource) {
+        remaining = SERVO_TRACE_SIZE - SERVO_TRACE_SIZE/4;
+        state = TS_TRIGGERED;
+      }
+    }
+
+    // record one sample, called from the servo control loop
+    inline void record(long set, long in, float outPercent, float velocityPercent) {
+      if (state != TS_ARMED && state != TS_TRIGGERED) return;
+
+      ServoTraceSample *sample = &buffer[head];
+      sample->time = micros();
+      sample->set = set;
+      sample->in = in;
+      sample->out = lroundf(outPercent*100.0F);
+      sample->velocity = lroundf(velocityPercent*100.0F);
+      if (++head >= SERVO_TRACE_SIZE) head = 0;
+      if (count < SERVO_TRACE_SIZE) count++;
+
+      if (state == TS_ARMED) {
+        if (triggerSource == TT_ERROR && labs(set - in) > threshold) trigger(TT_ERROR);
+      } else {
+        if (--remaining == 0) state = TS_DONE;
+      }
+    }
+
+    // get the number of samples recorded
+    inline uint16_t getCount() { return count; }
+
+    // format two samples starting at index (0 is the oldest) as hex for readout, only once the capture is done
+    bool getSamples(uint16_t index, char *reply);
+
+    volatile TraceState state = TS_IDLE;
+
+  private:
+    ServoTraceSample buffer[SERVO_TRACE_SIZE];
+    volatile uint16_t head = 0;
+    volatile uint16_t count = 0;
+    volatile uint16_t remaining = 0;
+    TraceTrigger triggerSource = TT_NONE;
+    long threshold = 0;
+};
+
+#endif
+
+#endif
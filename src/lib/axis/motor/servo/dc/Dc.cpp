@@ -30,6 +30,26 @@
   #define analogWritePin38(x) _pwm38_period = x
 #endif
 
+#if defined(ESP32) && SERVO_DC_PWM_FREQUENCY != OFF
+  // LEDC channels 0 to 7 are used here, analogWrite() allocates its channels from the top down
+  #define SERVO_DC_LEDC_CHANNELS 8
+  int16_t servoDcLedcChannel = 0;
+
+  // attach a pin to hardware PWM, returns the handle for ledcWrite() or OFF if unavailable
+  int16_t servoDcLedcAttach(int16_t pin, int bits) {
+    if (pin == OFF) return OFF;
+    #if defined(ESP_ARDUINO_VERSION) && ESP_ARDUINO_VERSION >= 196608 // version 3.0.0
+      if (!ledcAttach(pin, SERVO_DC_PWM_FREQUENCY, bits)) return OFF;
+      return pin;
+    #else
+      if (servoDcLedcChannel >= SERVO_DC_LEDC_CHANNELS) return OFF;
+      if (ledcSetup(servoDcLedcChannel, SERVO_DC_PWM_FREQUENCY, bits) == 0) return OFF;
+      ledcAttachPin(pin, servoDcLedcChannel);
+      return servoDcLedcChannel++;
+    #endif
+  }
+#endif
+
 ServoDc::ServoDc(uint8_t axisNumber, const ServoDcPins *Pins, const ServoDcSettings *Settings) {
   this->axisNumber = axisNumber;
 
@@ -44,6 +64,14 @@ ServoDc::ServoDc(uint8_t axisNumber, const ServoDcPins *Pins, const ServoDcSetti
   velocityMax = (Settings->velocityMax/100.0F)*ANALOG_WRITE_RANGE;
   acceleration = (Settings->acceleration/100.0F)*velocityMax;
   accelerationFs = acceleration/FRACTIONAL_SEC;
+
+  // power folds back at a rate of 25% per update for each 100% overcurrent
+  if (Settings->currentLimit != OFF && Pins->current != OFF) {
+    currentSense = true;
+    milliAmpsPerCount = Settings->currentScale/(float)ANALOG_READ_RANGE;
+    currentGain = (velocityMax/Settings->currentLimit)*0.25F;
+  }
+  powerLimit = velocityMax;
 }
 
 void ServoDc::init() {
@@ -80,14 +108,12 @@ void ServoDc::init() {
     }
   #endif
 
-  // set fastest PWM speed for Teensy processors
-  #ifdef ANALOG_WRITE_PWM_FREQUENCY
-    VF("MSG: Servo"); V(axisNumber); VF(", setting control pins analog frequency "); VL(ANALOG_WRITE_PWM_FREQUENCY);
-    #ifndef analogWritePin38
-      analogWriteFrequency(Pins->in1, ANALOG_WRITE_PWM_FREQUENCY);
-    #endif
-    analogWriteFrequency(Pins->in2, ANALOG_WRITE_PWM_FREQUENCY);
-  #endif
+  pwmInit();
+
+  if (currentSense) {
+    VF("MSG: ServoDriver"); V(axisNumber); VF(", current sense pin="); V(Pins->current);
+    VF(" limit "); V(Settings->currentLimit); VLF("mA");
+  }
 
   // set fault pin mode
   if (statusMode == ON) statusMode = LOW;
@@ -99,6 +125,55 @@ void ServoDc::init() {
   #endif
 }
 
+// set up the PWM frequency and resolution for the control pins
+void ServoDc::pwmInit() {
+  #if SERVO_DC_PWM_FREQUENCY != OFF
+    VF("MSG: ServoDriver"); V(axisNumber); VF(", setting control pins PWM frequency "); V(SERVO_DC_PWM_FREQUENCY); VLF("Hz");
+    #if defined(ESP32)
+      // dedicated LEDC channels at the highest resolution the 80MHz clock allows at this frequency
+      int bits = 16;
+      while (bits > 8 && (80000000UL >> bits) < SERVO_DC_PWM_FREQUENCY) bits--;
+      pwmScale = ((1UL << bits) - 1)/(float)ANALOG_WRITE_RANGE;
+      if (model == SERVO_EE) pwmChannel1 = servoDcLedcAttach(Pins->in1, bits);
+      pwmChannel2 = servoDcLedcAttach(Pins->in2, bits);
+      if ((model == SERVO_EE && pwmChannel1 == OFF) || pwmChannel2 == OFF) {
+        DF("WRN: ServoDriver"); D(axisNumber); DLF(", no LEDC channel available, falling back to analogWrite()");
+      } else {
+        VF("MSG: ServoDriver"); V(axisNumber); VF(", LEDC resolution "); V(bits); VLF(" bits");
+      }
+    #elif defined(TEENSYDUINO)
+      if (model == SERVO_EE && Pins->in1 != OFF) analogWriteFrequency(Pins->in1, SERVO_DC_PWM_FREQUENCY);
+      #ifdef analogWritePin38
+        if (model != SERVO_PE || Pins->in2 != 38)
+      #endif
+      if (Pins->in2 != OFF) analogWriteFrequency(Pins->in2, SERVO_DC_PWM_FREQUENCY);
+    #elif defined(ARDUINO_ARCH_STM32)
+      // the STM32 core frequency is global and applies to timers as analogWrite() starts them
+      analogWriteFrequency(SERVO_DC_PWM_FREQUENCY);
+    #endif
+  #elif defined(ANALOG_WRITE_PWM_FREQUENCY)
+    // set fastest PWM speed for Teensy processors
+    VF("MSG: Servo"); V(axisNumber); VF(", setting control pins analog frequency "); VL(ANALOG_WRITE_PWM_FREQUENCY);
+    #ifndef analogWritePin38
+      analogWriteFrequency(Pins->in1, ANALOG_WRITE_PWM_FREQUENCY);
+    #endif
+    analogWriteFrequency(Pins->in2, ANALOG_WRITE_PWM_FREQUENCY);
+  #endif
+}
+
+// write power (0 to ANALOG_WRITE_RANGE) to a control pin
+void ServoDc::pwmWrite(int16_t pin, float power) {
+  #ifdef analogWritePin38
+    if (model == SERVO_PE && pin == 38) { analogWritePin38(round(power)); return; }
+  #endif
+  #if defined(ESP32) && SERVO_DC_PWM_FREQUENCY != OFF
+    int16_t channel = OFF;
+    if (pin == Pins->in1) channel = pwmChannel1; else if (pin == Pins->in2) channel = pwmChannel2;
+    if (channel != OFF) { ledcWrite(channel, lround(power*pwmScale)); return; }
+  #endif
+  analogWrite(pin, round(power));
+}
+
 // enable or disable the driver using the enable pin or other method
 void ServoDc::enable(bool state) {
   int32_t power = 0;
@@ -110,16 +185,13 @@ void ServoDc::enable(bool state) {
 
     if (!enabled) {
       if (model == SERVO_EE) {
-        if (Pins->inState1 == HIGH) analogWrite(Pins->in1, round(velocityMax)); else analogWrite(Pins->in1, 0);
-        if (Pins->inState2 == HIGH) analogWrite(Pins->in2, round(velocityMax)); else analogWrite(Pins->in2, 0);
+        if (Pins->inState1 == HIGH) pwmWrite(Pins->in1, velocityMax); else pwmWrite(Pins->in1, 0);
+        if (Pins->inState2 == HIGH) pwmWrite(Pins->in2, velocityMax); else pwmWrite(Pins->in2, 0);
       } else
       if (model == SERVO_PE) {
         digitalWriteF(Pins->in1, Pins->inState1);
         if (Pins->inState2 == HIGH) power = velocityMax; else power = 0; 
-        #ifdef analogWritePin38
-          if (Pins->in2 == 38) analogWritePin38(round(power)); else
-        #endif
-        analogWrite(Pins->in2, round(power));
+        pwmWrite(Pins->in2, power);
       }
     }
   } else {
@@ -146,6 +218,17 @@ float ServoDc::setMotorVelocity(float velocity) {
     currentVelocity -= accelerationFs;
     if (currentVelocity < velocity) currentVelocity = velocity;
   }
+
+  // inner current loop, folds back the power limit while the sensed motor current is above the limit
+  if (currentSense) {
+    float milliAmps = analogRead(Pins->current)*milliAmpsPerCount;
+    currentFiltered += (milliAmps - currentFiltered)*0.5F;
+    powerLimit += (Settings->currentLimit - currentFiltered)*currentGain;
+    if (powerLimit > velocityMax) powerLimit = velocityMax; else
+    if (powerLimit < 0.0F) powerLimit = 0.0F;
+    if (currentVelocity > powerLimit) currentVelocity = powerLimit; else
+    if (currentVelocity < -powerLimit) currentVelocity = -powerLimit;
+  }
   if (currentVelocity >= 0) motorDirection = DIR_FORWARD; else motorDirection = DIR_REVERSE;
 
   pwmUpdate(fabs(currentVelocity));
@@ -158,17 +241,17 @@ void ServoDc::pwmUpdate(float power) {
 
   if (model == SERVO_EE) {
     if (motorDirection == DIR_FORWARD) {
-      if (Pins->inState1 == HIGH) analogWrite(Pins->in1, round(velocityMax)); else analogWrite(Pins->in1, 0);
+      if (Pins->inState1 == HIGH) pwmWrite(Pins->in1, velocityMax); else pwmWrite(Pins->in1, 0);
       if (Pins->inState2 == HIGH) power = velocityMax - power;
-      analogWrite(Pins->in2, round(power));
+      pwmWrite(Pins->in2, power);
     } else
     if (motorDirection == DIR_REVERSE) {
       if (Pins->inState1 == HIGH) power = velocityMax - power;
-      analogWrite(Pins->in1, round(power));
-      if (Pins->inState2 == HIGH) analogWrite(Pins->in2, round(velocityMax)); else analogWrite(Pins->in2, 0);
+      pwmWrite(Pins->in1, power);
+      if (Pins->inState2 == HIGH) pwmWrite(Pins->in2, velocityMax); else pwmWrite(Pins->in2, 0);
     } else {
-      if (Pins->inState1 == HIGH) analogWrite(Pins->in1, round(velocityMax)); else analogWrite(Pins->in1, 0);
-      if (Pins->inState2 == HIGH) analogWrite(Pins->in2, round(velocityMax)); else analogWrite(Pins->in2, 0);
+      if (Pins->inState1 == HIGH) pwmWrite(Pins->in1, velocityMax); else pwmWrite(Pins->in1, 0);
+      if (Pins->inState2 == HIGH) pwmWrite(Pins->in2, velocityMax); else pwmWrite(Pins->in2, 0);
     }
   } else
   if (model == SERVO_PE) {
@@ -183,10 +266,7 @@ void ServoDc::pwmUpdate(float power) {
       digitalWriteF(Pins->in1, Pins->inState1);
       if (Pins->inState2 == HIGH) power = velocityMax; else power = 0;
     }
-    #ifdef analogWritePin38
-      if (Pins->in2 == 38) analogWritePin38(round(power)); else
-    #endif
-    analogWrite(Pins->in2, round(power));
+    pwmWrite(Pins->in2, power);
   }
 }
 
@@ -21,6 +21,7 @@ typedef struct ServoDcPins {
   int16_t enable;
   uint8_t enabledState;
   int16_t fault;
+  int16_t current;
 } ServoDcPins;
 
 typedef struct ServoDcSettings {
@@ -28,6 +29,8 @@ typedef struct ServoDcSettings {
   int8_t  status;
   int32_t velocityMax;   // in % of max power
   int32_t acceleration;  // in %/second/second
+  int32_t currentScale;  // in mA for a full range ADC reading
+  int32_t currentLimit;  // in mA, OFF disables
 } ServoDcSettings;
 
 class ServoDc : public ServoDriver {
@@ -50,6 +53,12 @@ class ServoDc : public ServoDriver {
     const ServoDcSettings *Settings;
 
   private:
+    // set up the PWM frequency and resolution for the control pins
+    void pwmInit();
+
+    // write power (0 to ANALOG_WRITE_RANGE) to a control pin
+    void pwmWrite(int16_t pin, float power);
+
     // motor control update
     void pwmUpdate(float power);
 
@@ -58,6 +67,18 @@ class ServoDc : public ServoDriver {
     float currentVelocity = 0.0F;
     float acceleration;
     float accelerationFs;
+
+    // hardware PWM channels for in1 and in2, if allocated
+    int16_t pwmChannel1 = OFF;
+    int16_t pwmChannel2 = OFF;
+    float pwmScale = 1.0F;
+
+    // current sense
+    bool currentSense = false;
+    float milliAmpsPerCount = 0.0F;
+    float currentFiltered = 0.0F;
+    float currentGain = 0.0F;
+    float powerLimit = 0.0F;
 };
 
 #endif
@@ -0,0 +1,88 @@
+// -----------------------------------------------------------------------------------
+// servo motor feedback, relay autotune
+
+#include "Autotune.h"
+
+#ifdef SERVO_MOTOR_PRESENT
+
+// start the relay feedback experiment
+void Autotune::start(float relay) {
+  this->relay = relay;
+  output = 1;
+  cycles = 0;
+  measured = 0;
+  errorMin = 0;
+  errorMax = 0;
+  amplitudeSum = 0.0F;
+  periodSum = 0.0F;
+  ultimateGain = 0.0F;
+  ultimatePeriod = 0.0F;
+  startTime = micros();
+  cycleStartTime = startTime;
+  state = AT_RUNNING;
+}
+
+// stop any experiment in progress
+void Autotune::abort() {
+  if (state == AT_RUNNING) state = AT_IDLE;
+}
+
+// relay output for this control loop pass
+float Autotune::update(long error) {
+  if (state != AT_RUNNING) return 0.0F;
+
+  unsigned long now = micros();
+  if (labs(error) > SERVO_AUTOTUNE_MAX_ERROR || now - startTime > SERVO_AUTOTUNE_TIMEOUT*1000UL) {
+    state = AT_FAILED;
+    return 0.0F;
+  }
+
+  if (error > errorMax) errorMax = error;
+  if (error < errorMin) errorMin = error;
+
+  // a cycle completes each time the relay switches to positive output
+  if (output < 0 && error > SERVO_AUTOTUNE_HYSTERESIS) {
+    output = 1;
+    if (cycles > 2) {
+      periodSum += (now - cycleStartTime)/1000000.0F;
+      amplitudeSum += (errorMax - errorMin)/2.0F;
+      measured++;
+    }
+    if (cycles < 255) cycles++;
+    cycleStartTime = now;
+    errorMin = error;
+    errorMax = error;
+
+    if (measured >= SERVO_AUTOTUNE_CYCLES) {
+      // describing function of a relay with hysteresis, Ku = 4d/(pi*sqrt(a^2 - h^2))
+      float a = amplitudeSum/measured;
+      float h = SERVO_AUTOTUNE_HYSTERESIS;
+      if (a > h) {
+        ultimateGain = (4.0F*relay)/(PI*sqrtf(a*a - h*h));
+        ultimatePeriod = periodSum/measured;
+        state = AT_DONE;
+      } else state = AT_FAILED;
+      return 0.0F;
+    }
+  } else
+  if (output > 0 && error < -SERVO_AUTOTUNE_HYSTERESIS) output = -1;
+
+  return output*relay;
+}
+
+// tuning rules, Ziegler-Nichols no overshoot for tracking and classic for slewing
+bool Autotune::getParameters(float *p, float *i, float *d, float *pGoto, float *iGoto, float *dGoto) {
+  if (state != AT_DONE || ultimatePeriod <= 0.0F) return false;
+
+  *p = 0.2F*ultimateGain;
+  *i = 0.4F*ultimateGain/ultimatePeriod;
+  *d = 0.066F*ultimateGain*ultimatePeriod;
+
+  *pGoto = 0.6F*ultimateGain;
+  *iGoto = 1.2F*ultimateGain/ultimatePeriod;
+  *dGoto = 0.075F*ultimateGain*ultimatePeriod;
+
+  return true;
+}
+
+#endif
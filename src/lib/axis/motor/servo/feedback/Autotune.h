@@ -0,0 +1,59 @@
+// -----------------------------------------------------------------------------------
+// servo motor feedback, relay autotune
+#pragma once
+#include "../../../../../Common.h"
+
+#ifdef SERVO_MOTOR_PRESENT
+
+#ifndef SERVO_AUTOTUNE_RELAY
+  #define SERVO_AUTOTUNE_RELAY 10      // relay output in % of the motor control range (1 to 30)
+#endif
+#ifndef SERVO_AUTOTUNE_HYSTERESIS
+  #define SERVO_AUTOTUNE_HYSTERESIS 2  // relay hysteresis in encoder counts
+#endif
+#ifndef SERVO_AUTOTUNE_CYCLES
+  #define SERVO_AUTOTUNE_CYCLES 6      // oscillation cycles measured, after two settling cycles
+#endif
+#ifndef SERVO_AUTOTUNE_MAX_ERROR
+  #define SERVO_AUTOTUNE_MAX_ERROR 5000 // position error in encoder counts that stops the experiment
+#endif
+#ifndef SERVO_AUTOTUNE_TIMEOUT
+  #define SERVO_AUTOTUNE_TIMEOUT 60000 // in milliseconds
+#endif
+
+// AT_DONE has gains ready to be saved, AT_STORED once they have been written to NV
+enum AutotuneState: uint8_t {AT_IDLE, AT_RUNNING, AT_DONE, AT_STORED, AT_FAILED};
+
+class Autotune {
+  public:
+    // start the relay feedback experiment, relay is the output amplitude (in driver units)
+    void start(float relay);
+
+    // stop any experiment in progress
+    void abort();
+
+    // relay output (in driver units) for this control loop pass given the position error (in counts)
+    float update(long error);
+
+    // tracking and slewing PID gain sets from the experiment results, false if not available
+    bool getParameters(float *p, float *i, float *d, float *pGoto, float *iGoto, float *dGoto);
+
+    volatile AutotuneState state = AT_IDLE;
+
+    float ultimateGain = 0.0F;   // Ku, in driver units per count
+    float ultimatePeriod = 0.0F; // Tu, in seconds
+
+  private:
+    float relay = 0.0F;
+    int8_t output = 1;
+    uint8_t cycles = 0;
+    uint8_t measured = 0;
+    long errorMin = 0;
+    long errorMax = 0;
+    float amplitudeSum = 0.0F;
+    float periodSum = 0.0F;
+    unsigned long startTime = 0;
+    unsigned long cycleStartTime = 0;
+};
+
+#endif
@@ -12,6 +12,21 @@ void Feedback::init(uint8_t axisNumber, ServoControl *control, float controlRang
   this->control = control;
   control->in = 0;
   control->set = 0;
+
+  switch (axisNumber) {
+    case 1: accelerationFactor = AXIS1_SERVO_ACCEL_FACTOR; break;
+    case 2: accelerationFactor = AXIS2_SERVO_ACCEL_FACTOR; break;
+    case 3: accelerationFactor = AXIS3_SERVO_ACCEL_FACTOR; break;
+    case 4: accelerationFactor = AXIS4_SERVO_ACCEL_FACTOR; break;
+    case 5: accelerationFactor = AXIS5_SERVO_ACCEL_FACTOR; break;
+    case 6: accelerationFactor = AXIS6_SERVO_ACCEL_FACTOR; break;
+    case 7: accelerationFactor = AXIS7_SERVO_ACCEL_FACTOR; break;
+    case 8: accelerationFactor = AXIS8_SERVO_ACCEL_FACTOR; break;
+    case 9: accelerationFactor = AXIS9_SERVO_ACCEL_FACTOR; break;
+  }
+
+  feedforwardVelocity = 0;
+  feedforwardAcceleration = 0;
 }
 
 // get default feedback parameters
@@ -5,6 +5,34 @@
 
 #ifdef SERVO_MOTOR_PRESENT
 
+#ifndef AXIS1_SERVO_ACCEL_FACTOR
+  #define AXIS1_SERVO_ACCEL_FACTOR 0.0
+#endif
+#ifndef AXIS2_SERVO_ACCEL_FACTOR
+  #define AXIS2_SERVO_ACCEL_FACTOR 0.0
+#endif
+#ifndef AXIS3_SERVO_ACCEL_FACTOR
+  #define AXIS3_SERVO_ACCEL_FACTOR 0.0
+#endif
+#ifndef AXIS4_SERVO_ACCEL_FACTOR
+  #define AXIS4_SERVO_ACCEL_FACTOR 0.0
+#endif
+#ifndef AXIS5_SERVO_ACCEL_FACTOR
+  #define AXIS5_SERVO_ACCEL_FACTOR 0.0
+#endif
+#ifndef AXIS6_SERVO_ACCEL_FACTOR
+  #define AXIS6_SERVO_ACCEL_FACTOR 0.0
+#endif
+#ifndef AXIS7_SERVO_ACCEL_FACTOR
+  #define AXIS7_SERVO_ACCEL_FACTOR 0.0
+#endif
+#ifndef AXIS8_SERVO_ACCEL_FACTOR
+  #define AXIS8_SERVO_ACCEL_FACTOR 0.0
+#endif
+#ifndef AXIS9_SERVO_ACCEL_FACTOR
+  #define AXIS9_SERVO_ACCEL_FACTOR 0.0
+#endif
+
 typedef struct ServoControl {
   float in;
   float out;
@@ -49,6 +77,18 @@ class Feedback {
 
     virtual void poll();
 
+    // set the +/- output range of the feedback control
+    virtual void setControlRange(float controlRange) { UNUSED(controlRange); }
+
+    // set the feedback control sample time in microseconds
+    virtual void setSampleTime(unsigned long sampleTimeUs) { UNUSED(sampleTimeUs); }
+
+    // set the feedforward terms from the commanded ramp, velocity (in driver units) and acceleration (in counts per second per second)
+    inline void setFeedforward(float velocity, float acceleration) { feedforwardVelocity = velocity; feedforwardAcceleration = acceleration; }
+
+    // get the feedforward velocity (in driver units) that is added to the feedback control output
+    virtual float getFeedforward() { return feedforwardVelocity + feedforwardAcceleration*accelerationFactor; }
+
     bool useVariableParameters = false;
 
   protected:
@@ -56,6 +96,10 @@ class Feedback {
     float param1 = 0, param2 = 0, param3 = 0, param4 = 0, param5 = 0, param6 = 0;
     ServoControl *control;
     uint8_t axisNumber = 0;
+
+    volatile float feedforwardVelocity = 0;     // commanded velocity (in driver units)
+    volatile float feedforwardAcceleration = 0; // commanded acceleration (in counts per second per second)
+    float accelerationFactor = 0;               // converts acceleration to velocity (in driver units)
 };
 
 #endif
\ No newline at end of file
@@ -46,6 +46,18 @@ void Pid::reset() {
   selectSlewingParameters();
 }
 
+// set the +/- output range of the PID
+void Pid::setControlRange(float controlRange) {
+  V(axisPrefix); VF("setting feedback with range +/-"); VL(controlRange);
+  c = controlRange;
+  pid->SetOutputLimits(-controlRange, controlRange);
+}
+
+// set the PID sample time in microseconds
+void Pid::setSampleTime(unsigned long sampleTimeUs) {
+  pid->SetSampleTimeUs(sampleTimeUs);
+}
+
 void Pid::setControlDirection(int8_t state) {
   if (state == ON) pid->SetControllerDirection(QuickPID::Action::reverse); else pid->SetControllerDirection(QuickPID::Action::direct);
 }
@@ -13,7 +13,11 @@
   #define PID_SLEWING_TO_TRACKING_TIME_MS 1000 // time to switch from PID slewing to tracking parameters in milliseconds
 #endif
 #ifndef PID_SAMPLE_TIME_US
-  #define PID_SAMPLE_TIME_US 10000 // PID sample time in microseconds (defaults to 10 milliseconds)
+  #if defined(SERVO_CONTROL_RATE) && SERVO_CONTROL_RATE != OFF
+    #define PID_SAMPLE_TIME_US (1000000L/SERVO_CONTROL_RATE) // PID sample time matches the fixed rate control loop
+  #else
+    #define PID_SAMPLE_TIME_US 10000 // PID sample time in microseconds (defaults to 10 milliseconds)
+  #endif
 #endif
 #ifndef PID_PMODE
   #define PID_PMODE pOnError // http://brettbeauregard.com/blog/2017/06/introducing-proportional-on-measurement/
@@ -50,6 +54,12 @@ class Pid : public Feedback {
     // variable feedback, variable PID params
     void variableParameters(float percent);
 
+    // set the +/- output range of the PID
+    void setControlRange(float controlRange);
+
+    // set the PID sample time in microseconds
+    void setSampleTime(unsigned long sampleTimeUs);
+
     inline void poll() {
       pid->Compute();
 
@@ -212,7 +212,7 @@ void ServoTmc2209::updateStatus() {
 }
 
 // calibrate the motor driver if required
-void ServoTmc2209::calibrateDriver() {
+bool ServoTmc2209::calibrateDriverStart() {
   if (stealthChop()) {
     VF("MSG: ServoTmc2209 Axis"); V(axisNumber); VL(", TMC standstill automatic current calibration");
     driver->irun(mAToCs(Settings->current));
@@ -220,8 +220,9 @@ void ServoTmc2209::calibrateDriver() {
     ((TMC2209Stepper*)driver)->pwm_autograd(DRIVER_TMC_STEPPER_AUTOGRAD);
     ((TMC2209Stepper*)driver)->pwm_autoscale(true);
     ((TMC2209Stepper*)driver)->en_spreadCycle(false);
-    delay(1000);
+    return true;
   }
+  return false;
 }
 
 #endif
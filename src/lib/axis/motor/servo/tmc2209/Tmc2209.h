@@ -70,7 +70,7 @@ class ServoTmc2209 : public ServoDriver {
     void updateStatus();
 
     // calibrate the motor if required
-    void calibrateDriver();
+    bool calibrateDriverStart();
 
     const ServoTmcSettings *Settings;
 
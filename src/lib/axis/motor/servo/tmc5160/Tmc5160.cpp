@@ -168,7 +168,7 @@ void ServoTmc5160::updateStatus() {
 }
 
 // calibrate the motor driver if required
-void ServoTmc5160::calibrateDriver() {
+bool ServoTmc5160::calibrateDriverStart() {
   if (stealthChop()) {
     VF("MSG: ServoTmc5160 Axis"); V(axisNumber); VL(", TMC standstill automatic current calibration");
     driver->irun(mAToCs(Settings->current));
@@ -176,8 +176,9 @@ void ServoTmc5160::calibrateDriver() {
     driver->pwm_autograd(DRIVER_TMC_STEPPER_AUTOGRAD);
     driver->pwm_autoscale(true);
     driver->en_pwm_mode(true);
-    delay(1000);
+    return true;
   }
+  return false;
 }
 
 #endif
@@ -54,7 +54,7 @@ class ServoTmc5160 : public ServoDriver {
     void updateStatus();
 
     // calibrate the motor if required
-    void calibrateDriver();
+    bool calibrateDriverStart();
 
     const ServoTmcSettings *Settings;
 
@@ -6,71 +6,61 @@
 #ifdef STEP_DIR_MOTOR_PRESENT
 
 #include "../../../tasks/OnTask.h"
+#include "../../../memory/Memory.h"
 
 StepDirMotor *stepDirMotorInstance[9];
 
-#ifndef AXIS1_STEP_PIN
-  #define AXIS1_STEP_PIN stepDirMotorInstance[0]->Pins->step
+// the step and direction pins are template parameters so each axis ISR writes its port registers directly
+#ifdef STEP_DIR_BENCHMARK
+  #define STEP_DIR_ISR(index, ...) { uint32_t t0 = STEP_DIR_CYCLES(); stepDirMotorInstance[index]->__VA_ARGS__; stepDirMotorInstance[index]->benchmarkRecord(t0); }
+#else
+  #define STEP_DIR_ISR(index, ...) { stepDirMotorInstance[index]->__VA_ARGS__; }
 #endif
-IRAM_ATTR void moveStepDirMotorAxis1() { stepDirMotorInstance[0]->move(AXIS1_STEP_PIN); }
-IRAM_ATTR void moveStepDirMotorFFAxis1() { stepDirMotorInstance[0]->moveFF(AXIS1_STEP_PIN); }
-IRAM_ATTR void moveStepDirMotorFRAxis1() { stepDirMotorInstance[0]->moveFR(AXIS1_STEP_PIN); }
+IRAM_ATTR void moveStepDirMotorAxis1() { STEP_DIR_ISR(0, move<AXIS1_STEP_PIN, AXIS1_DIR_PIN>()); }
+IRAM_ATTR void moveStepDirMotorFFAxis1() { STEP_DIR_ISR(0, moveFF<AXIS1_STEP_PIN, AXIS1_DIR_PIN>()); }
+IRAM_ATTR void moveStepDirMotorFRAxis1() { STEP_DIR_ISR(0, moveFR<AXIS1_STEP_PIN, AXIS1_DIR_PIN>()); }
 
-#ifndef AXIS2_STEP_PIN
-  #define AXIS2_STEP_PIN stepDirMotorInstance[1]->Pins->step
-#endif
-IRAM_ATTR void moveStepDirMotorAxis2() { stepDirMotorInstance[1]->move(AXIS2_STEP_PIN); }
-IRAM_ATTR void moveStepDirMotorFFAxis2() { stepDirMotorInstance[1]->moveFF(AXIS2_STEP_PIN); }
-IRAM_ATTR void moveStepDirMotorFRAxis2() { stepDirMotorInstance[1]->moveFR(AXIS2_STEP_PIN); }
+IRAM_ATTR void moveStepDirMotorAxis2() { STEP_DIR_ISR(1, move<AXIS2_STEP_PIN, AXIS2_DIR_PIN>()); }
+IRAM_ATTR void moveStepDirMotorFFAxis2() { STEP_DIR_ISR(1, moveFF<AXIS2_STEP_PIN, AXIS2_DIR_PIN>()); }
+IRAM_ATTR void moveStepDirMotorFRAxis2() { STEP_DIR_ISR(1, moveFR<AXIS2_STEP_PIN, AXIS2_DIR_PIN>()); }
 
-#ifndef AXIS3_STEP_PIN
-  #define AXIS3_STEP_PIN stepDirMotorInstance[2]->Pins->step
-#endif
-void moveStepDirMotorAxis3() { stepDirMotorInstance[2]->move(AXIS3_STEP_PIN); }
-void moveStepDirMotorFFAxis3() { stepDirMotorInstance[2]->moveFF(AXIS3_STEP_PIN); }
-void moveStepDirMotorFRAxis3() { stepDirMotorInstance[2]->moveFR(AXIS3_STEP_PIN); }
+void moveStepDirMotorAxis3() { STEP_DIR_ISR(2, move<AXIS3_STEP_PIN, AXIS3_DIR_PIN>()); }
+void moveStepDirMotorFFAxis3() { STEP_DIR_ISR(2, moveFF<AXIS3_STEP_PIN, AXIS3_DIR_PIN>()); }
+void moveStepDirMotorFRAxis3() { STEP_DIR_ISR(2, moveFR<AXIS3_STEP_PIN, AXIS3_DIR_PIN>()); }
 
-#ifndef AXIS4_STEP_PIN
-  #define AXIS4_STEP_PIN stepDirMotorInstance[3]->Pins->step
-#endif
-void moveStepDirMotorAxis4() { stepDirMotorInstance[3]->move(AXIS4_STEP_PIN); }
-void moveStepDirMotorFFAxis4() { stepDirMotorInstance[3]->moveFF(AXIS4_STEP_PIN); }
-void moveStepDirMotorFRAxis4() { stepDirMotorInstance[3]->moveFR(AXIS4_STEP_PIN); }
+void moveStepDirMotorAxis4() { STEP_DIR_ISR(3, move<AXIS4_STEP_PIN, AXIS4_DIR_PIN>()); }
+void moveStepDirMotorFFAxis4() { STEP_DIR_ISR(3, moveFF<AXIS4_STEP_PIN, AXIS4_DIR_PIN>()); }
+void moveStepDirMotorFRAxis4() { STEP_DIR_ISR(3, moveFR<AXIS4_STEP_PIN, AXIS4_DIR_PIN>()); }
 
-#ifndef AXIS5_STEP_PIN
-  #define AXIS5_STEP_PIN stepDirMotorInstance[4]->Pins->step
-#endif
-void moveStepDirMotorAxis5() { stepDirMotorInstance[4]->move(AXIS5_STEP_PIN); }
-void moveStepDirMotorFFAxis5() { stepDirMotorInstance[4]->moveFF(AXIS5_STEP_PIN); }
-void moveStepDirMotorFRAxis5() { stepDirMotorInstance[4]->moveFR(AXIS5_STEP_PIN); }
+void moveStepDirMotorAxis5() { STEP_DIR_ISR(4, move<AXIS5_STEP_PIN, AXIS5_DIR_PIN>()); }
+void moveStepDirMotorFFAxis5() { STEP_DIR_ISR(4, moveFF<AXIS5_STEP_PIN, AXIS5_DIR_PIN>()); }
+void moveStepDirMotorFRAxis5() { STEP_DIR_ISR(4, moveFR<AXIS5_STEP_PIN, AXIS5_DIR_PIN>()); }
 
-#ifndef AXIS6_STEP_PIN
-  #define AXIS6_STEP_PIN stepDirMotorInstance[5]->Pins->step
-#endif
-void moveStepDirMotorAxis6() { stepDirMotorInstance[5]->move(AXIS6_STEP_PIN); }
-void moveStepDirMotorFFAxis6() { stepDirMotorInstance[5]->moveFF(AXIS6_STEP_PIN); }
-void moveStepDirMotorFRAxis6() { stepDirMotorInstance[5]->moveFR(AXIS6_STEP_PIN); }
+void moveStepDirMotorAxis6() { STEP_DIR_ISR(5, move<AXIS6_STEP_PIN, AXIS6_DIR_PIN>()); }
+void moveStepDirMotorFFAxis6() { STEP_DIR_ISR(5, moveFF<AXIS6_STEP_PIN, AXIS6_DIR_PIN>()); }
+void moveStepDirMotorFRAxis6() { STEP_DIR_ISR(5, moveFR<AXIS6_STEP_PIN, AXIS6_DIR_PIN>()); }
 
-#ifndef AXIS7_STEP_PIN
-  #define AXIS7_STEP_PIN stepDirMotorInstance[6]->Pins->step
-#endif
-void moveStepDirMotorAxis7() { stepDirMotorInstance[6]->move(AXIS7_STEP_PIN); }
-void moveStepDirMotorFFAxis7() { stepDirMotorInstance[6]->moveFF(AXIS7_STEP_PIN); }
-void moveStepDirMotorFRAxis7() { stepDirMotorInstance[6]->moveFR(AXIS7_STEP_PIN); }
+void moveStepDirMotorAxis7() { STEP_DIR_ISR(6, move<AXIS7_STEP_PIN, AXIS7_DIR_PIN>()); }
+void moveStepDirMotorFFAxis7() { STEP_DIR_ISR(6, moveFF<AXIS7_STEP_PIN, AXIS7_DIR_PIN>()); }
+void moveStepDirMotorFRAxis7() { STEP_DIR_ISR(6, moveFR<AXIS7_STEP_PIN, AXIS7_DIR_PIN>()); }
+
+void moveStepDirMotorAxis8() { STEP_DIR_ISR(7, move<AXIS8_STEP_PIN, AXIS8_DIR_PIN>()); }
+void moveStepDirMotorFFAxis8() { STEP_DIR_ISR(7, moveFF<AXIS8_STEP_PIN, AXIS8_DIR_PIN>()); }
+void moveStepDirMotorFRAxis8() { STEP_DIR_ISR(7, moveFR<AXIS8_STEP_PIN, AXIS8_DIR_PIN>()); }
 
-#ifndef AXIS8_STEP_PIN
-  #define AXIS8_STEP_PIN stepDirMotorInstance[7]->Pins->step
+void moveStepDirMotorAxis9() { STEP_DIR_ISR(8, move<AXIS9_STEP_PIN, AXIS9_DIR_PIN>()); }
+void moveStepDirMotorFFAxis9() { STEP_DIR_ISR(8, moveFF<AXIS9_STEP_PIN, AXIS9_DIR_PIN>()); }
+void moveStepDirMotorFRAxis9() { STEP_DIR_ISR(8, moveFR<AXIS9_STEP_PIN, AXIS9_DIR_PIN>()); }
+
+#ifdef STEP_DIR_ENCODER_PRESENT
+  void encoderStepDirMotorAxis1() { stepDirMotorInstance[0]->encoderPoll(); }
+  void encoderStepDirMotorAxis2() { stepDirMotorInstance[1]->encoderPoll(); }
 #endif
-void moveStepDirMotorAxis8() { stepDirMotorInstance[7]->move(AXIS8_STEP_PIN); }
-void moveStepDirMotorFFAxis8() { stepDirMotorInstance[7]->moveFF(AXIS8_STEP_PIN); }
-void moveStepDirMotorFRAxis8() { stepDirMotorInstance[7]->moveFR(AXIS8_STEP_PIN); }
 
-#ifndef AXIS9_STEP_PIN
-  #define AXIS9_STEP_PIN stepDirMotorInstance[8]->Pins->step
+#ifdef STEP_DIR_RMT_PRESENT
+  IRAM_ATTR void moveStepDirMotorBurstFF(void *motor) { ((StepDirMotor *)motor)->moveBurstFF(); }
+  IRAM_ATTR void moveStepDirMotorBurstFR(void *motor) { ((StepDirMotor *)motor)->moveBurstFR(); }
 #endif
-void moveStepDirMotorAxis9() { stepDirMotorInstance[8]->move(AXIS9_STEP_PIN); }
-void moveStepDirMotorFFAxis9() { stepDirMotorInstance[8]->moveFF(AXIS9_STEP_PIN); }
-void moveStepDirMotorFRAxis9() { stepDirMotorInstance[8]->moveFR(AXIS9_STEP_PIN); }
 
 StepDirMotor::StepDirMotor(const uint8_t axisNumber, const StepDirPins *Pins, StepDirDriver *Driver, bool useFastHardwareTimers) {
   if (axisNumber < 1 || axisNumber > 9) return;
@@ -101,6 +91,43 @@ StepDirMotor::StepDirMotor(const uint8_t axisNumber, const StepDirPins *Pins, St
     case 8: callback = moveStepDirMotorAxis8; callbackFF = moveStepDirMotorFFAxis8; callbackFR = moveStepDirMotorFRAxis8; break;
     case 9: callback = moveStepDirMotorAxis9; callbackFF = moveStepDirMotorFFAxis9; callbackFR = moveStepDirMotorFRAxis9; break;
   }
+
+  #ifdef STEP_DIR_RMT_PRESENT
+    switch (axisNumber) {
+      #if AXIS1_STEP_RMT == ON
+        case 1: useRmt = true; break;
+      #endif
+      #if AXIS2_STEP_RMT == ON
+        case 2: useRmt = true; break;
+      #endif
+      #if AXIS3_STEP_RMT == ON
+        case 3: useRmt = true; break;
+      #endif
+      #if AXIS4_STEP_RMT == ON
+        case 4: useRmt = true; break;
+      #endif
+      #if AXIS5_STEP_RMT == ON
+        case 5: useRmt = true; break;
+      #endif
+      #if AXIS6_STEP_RMT == ON
+        case 6: useRmt = true; break;
+      #endif
+      #if AXIS7_STEP_RMT == ON
+        case 7: useRmt = true; break;
+      #endif
+      #if AXIS8_STEP_RMT == ON
+        case 8: useRmt = true; break;
+      #endif
+      #if AXIS9_STEP_RMT == ON
+        case 9: useRmt = true; break;
+      #endif
+      default: break;
+    }
+    // the direction pin is written before every step for shared direction pins
+    #ifdef SHARED_DIRECTION_PINS
+      if (axisNumber > 2) useRmt = false;
+    #endif
+  #endif
 }
 
 bool StepDirMotor::init() {
@@ -133,6 +160,11 @@ bool StepDirMotor::init() {
   pinModeEx(Pins->enable, OUTPUT);
   digitalWriteEx(Pins->enable, !Pins->enabledState)
 
+  #if defined(STEP_DIR_BENCHMARK) && !defined(ESP32)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  #endif
+
   // start the motor timer
   V(axisPrefix); VF("start task to move motor... ");
   char timerName[] = "Motor_";
@@ -146,6 +178,37 @@ bool StepDirMotor::init() {
     return false;
   }
 
+  #ifdef MEMORY_PLACEMENT_MAX
+    char isrName[] = "Motor_n FF";
+    isrName[6] = '0' + axisNumber;
+    isrName[7] = 0; IRAM_HOT_CHECK(isrName, callback);
+    isrName[7] = ' '; IRAM_HOT_CHECK(isrName, callbackFF);
+    isrName[9] = 'R'; IRAM_HOT_CHECK(isrName, callbackFR);
+  #endif
+
+  #if DEBUG != OFF && defined(DEBUG_STEPDIR_PERIOD_BENCHMARK) && defined(DWT) && defined(CoreDebug)
+    benchmarkPeriod();
+  #endif
+
+  #ifdef STEP_DIR_ENCODER_PRESENT
+    if (encoder != NULL) {
+      encoder->init();
+      encoder->setOrigin(encoderOrigin);
+      V(axisPrefix); VF("start encoder tracking correction task (rate "); V(STEP_DIR_ENCODER_PERIOD_MS); VF("ms priority 6)... ");
+      char encoderName[] = "EncTk_";
+      encoderName[5] = '0' + axisNumber;
+      encoderHandle = tasks.add(STEP_DIR_ENCODER_PERIOD_MS, 0, true, 6, axisNumber == 1 ? encoderStepDirMotorAxis1 : encoderStepDirMotorAxis2, encoderName);
+      if (encoderHandle) { VLF("success"); } else { VLF("FAILED!"); encoder = NULL; }
+    }
+  #endif
+
+  #ifdef STEP_DIR_RMT_PRESENT
+    if (useRmt) {
+      V(axisPrefix); VF("start RMT step pulse generation... ");
+      if (rmt.init(axisNumber - 1, Pins->step, stepSet, pulseWidth)) { VLF("success"); } else { VLF("FAILED!"); useRmt = false; }
+    }
+  #endif
+
   return true;
 }
 
@@ -188,8 +251,100 @@ DriverStatus StepDirMotor::getDriverStatus() {
   return driver->getStatus();
 }
 
+// frequency in steps per second to timer period in sub-micros per step, 0 if out of range
+// also runs the timer twice as fast if using a square wave
+static inline unsigned long frequencyToPeriodFloat(float frequency) {
+  #if STEP_WAVE_FORM == SQUARE
+    float period = 500000.0F/frequency;
+  #else
+    float period = 1000000.0F/frequency;
+  #endif
+
+  // range is 0 to 130 seconds/step
+  if (!isnan(period) && period <= 130000000.0F) return (unsigned long)lroundf(period*16.0F);
+  return 0;
+}
+
+// same as above without floating point math, the float is split into its 24 bit mantissa and
+// exponent then the divide is done 8 bits at a time so each step fits a 32/32 bit hardware divide
+static inline unsigned long frequencyToPeriodInteger(float frequency) {
+  #if STEP_WAVE_FORM == SQUARE
+    const uint32_t k = 8000000UL;
+  #else
+    const uint32_t k = 16000000UL;
+  #endif
+
+  union { float f; uint32_t i; } bits;
+  bits.f = frequency;
+
+  // zero, denormal, negative, infinite, or nan
+  uint32_t exponent = (bits.i >> 23) & 0xFF;
+  if (exponent == 0 || exponent == 0xFF || (bits.i & 0x80000000UL)) return 0;
+
+  // frequency = mantissa*2^(exponent - 150) so period = k*2^shift/mantissa
+  uint32_t mantissa = (bits.i & 0x7FFFFFUL) | 0x800000UL;
+  int shift = 150 - (int)exponent;
+  if (shift < 0 || shift > 31) return 0;
+
+  uint32_t quotient = k/mantissa;
+  uint32_t remainder = k%mantissa;
+  while (shift > 0) {
+    int bitsNow = shift > 8 ? 8 : shift;
+    remainder <<= bitsNow;
+    quotient = (quotient << bitsNow) + remainder/mantissa;
+    remainder %= mantissa;
+    shift -= bitsNow;
+  }
+  if (remainder >= mantissa - remainder) quotient++;
+
+  if (quotient > STEP_DIR_PERIOD_MAX) return 0;
+  return quotient;
+}
+
+#if DEBUG != OFF && defined(DEBUG_STEPDIR_PERIOD_BENCHMARK) && defined(DWT) && defined(CoreDebug)
+  // cycle counts for both period calculations over a sweep of frequencies
+  static void benchmarkPeriod() {
+    static bool done = false;
+    if (done) return;
+    done = true;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    volatile unsigned long sink = 0;
+    uint32_t cyclesFloat = 0, cyclesInteger = 0;
+    for (int i = 0; i < 1000; i++) {
+      float frequency = 0.1F + i*i*0.37F;
+      uint32_t t0 = DWT->CYCCNT;
+      sink = frequencyToPeriodFloat(frequency);
+      uint32_t t1 = DWT->CYCCNT;
+      sink = frequencyToPeriodInteger(frequency);
+      uint32_t t2 = DWT->CYCCNT;
+      cyclesFloat += t1 - t0;
+      cyclesInteger += t2 - t1;
+    }
+    (void)sink;
+
+    DF("MSG: StepDir, period calc average cycles float "); D(cyclesFloat/1000);
+    DF(" integer "); DL(cyclesInteger/1000);
+  }
+#endif
+
+// the fraction of a step each timer tick is worth (2^32 is one step) for a period in sub-micros, the period is
+// shortened if needed so a tick is never worth more than a step, stepsPerSubMicro is the rate the ISR steps at
+static inline uint32_t periodToIncrement(unsigned long *period, double stepsPerSubMicro) {
+  if (*period == 0) return 0xFFFFFFFFUL;
+  double perTick = *period*stepsPerSubMicro;
+  if (perTick > 1.0) {
+    unsigned long shorter = (unsigned long)(1.0/stepsPerSubMicro);
+    if (shorter >= 16 && shorter < *period) { *period = shorter; perTick = *period*stepsPerSubMicro; }
+  }
+  if (perTick >= 1.0) return 0xFFFFFFFFUL;
+  return (uint32_t)(perTick*4294967296.0);
+}
+
 // set frequency (+/-) in steps per second negative frequencies move reverse in direction (0 stops motion)
-void StepDirMotor::setFrequencySteps(float frequency) {
+IRAM_HOT void StepDirMotor::setFrequencySteps(float frequency) {
 
   // chart acceleration
   #if DEBUG != OFF && defined(DEBUG_STEPDIR_ACCEL) && DEBUG_STEPDIR_ACCEL != OFF
@@ -202,6 +357,12 @@ void StepDirMotor::setFrequencySteps(float frequency) {
     }
   #endif
 
+  #ifdef STEP_DIR_ENCODER_PRESENT
+    // the encoder tracking correction trims the requested rate, it's refreshed at the axis poll rate
+    requestedFrequency = frequency;
+    if (frequency != 0.0F) frequency += trim;
+  #endif
+
   if (!inBacklash) modeSwitch();
 
   Y;
@@ -209,41 +370,77 @@ void StepDirMotor::setFrequencySteps(float frequency) {
   int dir = 0;
   if (frequency > 0.0F) dir = 1; else if (frequency < 0.0F) { frequency = -frequency; dir = -1; }
 
+  // commanded motion ends any backlash preload
+  if (dir != 0) backlashPreloadDir = 0;
+
   // if in backlash override the frequency OR change
   // microstep mode and/or swap in fast ISRs as required
-  if (inBacklash) frequency = backlashFrequency;
+  if (inBacklash) frequency = backlashRampFrequency(frequency);
 
-  if (frequency != currentFrequency || microstepModeControl >= MMC_SLEWING_PAUSE) {
+  if (frequency != lastFrequency || microstepModeControl >= MMC_SLEWING_PAUSE) {
     lastFrequency = frequency;
 
-    // if slewing has a larger step size divide the frequency to account for it
-    if (microstepModeControl == MMC_SLEWING || microstepModeControl == MMC_SLEWING_READY) frequency /= stepSize;
+    #ifdef STEP_DIR_INTEGER_PERIOD
+      lastPeriod = frequencyToPeriodInteger(frequency);
 
-    // frequency in steps per second to period in microsecond counts per step
-    // also runs the timer twice as fast if using a square wave
+      // if slewing has a larger step size multiply the period to account for it
+      if (microstepModeControl == MMC_SLEWING || microstepModeControl == MMC_SLEWING_READY) {
+        if (lastPeriod > STEP_DIR_PERIOD_MAX/stepSize) lastPeriod = 0; else lastPeriod *= stepSize;
+      }
+    #else
+      // if slewing has a larger step size divide the frequency to account for it
+      if (microstepModeControl == MMC_SLEWING || microstepModeControl == MMC_SLEWING_READY) frequency /= stepSize;
+
+      lastPeriod = frequencyToPeriodFloat(frequency);
+    #endif
+
+    // the timer period is whole sub-micros, the phase increment carries the rest so the average rate is exact
     #if STEP_WAVE_FORM == SQUARE
-      float period = 500000.0F/frequency;
+      double stepsPerSubMicro = frequency*(1.0/8000000.0);
     #else
-      float period = 1000000.0F/frequency;
+      double stepsPerSubMicro = frequency*(1.0/16000000.0);
+    #endif
+    #ifdef STEP_DIR_INTEGER_PERIOD
+      if (microstepModeControl == MMC_SLEWING || microstepModeControl == MMC_SLEWING_READY) stepsPerSubMicro /= stepSize;
+    #endif
+    uint32_t increment = periodToIncrement(&lastPeriod, stepsPerSubMicro);
+
+    if (lastPeriod == 0) dir = 0;
+
+    unsigned long timerPeriod = lastPeriod;
+    #ifdef STEP_DIR_RMT_PRESENT
+      // while bursting, the timer runs once for every rmtBurst steps
+      if (rmtActive && lastPeriod != 0) {
+        #if STEP_WAVE_FORM == SQUARE
+          unsigned long stepPeriod = lastPeriod*2;
+        #else
+          unsigned long stepPeriod = lastPeriod;
+        #endif
+        unsigned long burst = STEP_DIR_RMT_BURST_PERIOD/stepPeriod;
+        if (burst < 1) burst = 1;
+        if (burst > STEP_DIR_RMT_BURST_MAX) burst = STEP_DIR_RMT_BURST_MAX;
+        timerPeriod = stepPeriod*burst;
+
+        noInterrupts();
+        rmt.setStepPeriod(stepPeriod);
+        rmtBurst = burst;
+        interrupts();
+      }
+      if (rmtActive) increment = 0xFFFFFFFFUL;
     #endif
-   
-    // range is 0 to 134 seconds/step
-    if (!isnan(period) && period <= 130000000.0F) {
-      period *= 16.0F;
-      lastPeriod = (unsigned long)lroundf(period);
-    } else {
-      lastPeriod = 0;
-      frequency = 0.0F;
-      dir = 0;
-    }
 
-    currentFrequency = frequency;
+    noInterrupts();
+    stepIncrement = increment;
+    interrupts();
 
     // change the motor rate/direction
     if (step != dir) step = 0;
-    if (lastPeriodSet != lastPeriod) {
-      tasks.setPeriodSubMicros(taskHandle, lastPeriod);
-      lastPeriodSet = lastPeriod;
+    if (lastPeriodSet != timerPeriod) {
+      tasks.setPeriodSubMicros(taskHandle, timerPeriod);
+      lastPeriodSet = timerPeriod;
+      #ifdef STEP_DIR_BENCHMARK
+        benchmarkPeriodCycles = timerPeriod*(F_CPU/16000000.0F);
+      #endif
     }
     step = dir;
 
@@ -262,8 +459,33 @@ void StepDirMotor::setFrequencySteps(float frequency) {
   }
 }
 
+// take up backlash toward the direction of the next move while stopped, DIR_NONE cancels
+void StepDirMotor::setBacklashPreload(Direction direction) {
+  noInterrupts();
+  if (direction == DIR_NONE || getFrequencySteps() != 0.0F) backlashPreloadDir = 0; else {
+    backlashPreloadDir = direction == DIR_FORWARD ? 1 : -1;
+    if (backlashPreloadDir > 0 && backlashSteps < backlashAmountSteps) inBacklash = true;
+    if (backlashPreloadDir < 0 && backlashSteps > 0) inBacklash = true;
+  }
+  interrupts();
+}
+
 // switch microstep modes as needed
 void StepDirMotor::modeSwitch() {
+  // the high speed band only changes decay mode and current, no need to pause stepping for it
+  if (slewing && driver->modeFastAllowed) {
+    if (!fastBand && lastFrequency > driver->settings.rateFast) {
+      V(axisPrefix); VLF("mode switch fast set");
+      driver->modeDecayFast();
+      fastBand = true;
+    } else
+    if (fastBand && lastFrequency < driver->settings.rateFast*0.8F) {
+      V(axisPrefix); VLF("mode switch fast exit");
+      driver->modeDecaySlewing();
+      fastBand = false;
+    }
+  }
+
   if (lastFrequency <= backlashFrequency*2.0F) {
     if (microstepModeControl >= MMC_SLEWING) {
       microstepModeControl = MMC_TRACKING_READY;
@@ -306,11 +528,110 @@ float StepDirMotor::getFrequencySteps() {
 
 // set slewing state (hint that we are about to slew or are done slewing)
 void StepDirMotor::setSlewing(bool state) {
+  slewing = state;
+  fastBand = false;
   if (state == true) driver->modeDecaySlewing(); else driver->modeDecayTracking();
 }
 
+// set what the axis is doing, outside of slewing this picks the run current
+void StepDirMotor::setCurrentProfile(CurrentProfile profile) {
+  if (profile == driver->getCurrentProfile()) return;
+  driver->setCurrentProfile(profile);
+  if (!slewing && enabled) driver->modeDecayTracking();
+}
+
+#ifdef STEP_DIR_ENCODER_PRESENT
+  // resets motor and target angular position in steps, also zeros backlash and index
+  void StepDirMotor::resetPositionSteps(long value) {
+    Motor::resetPositionSteps(value);
+    // the encoder offset is stale, start the correction over
+    trimEngaged = false;
+    trim = 0.0F;
+  }
+
+  // tracking correction from an axis encoder, call before init()
+  void StepDirMotor::setEncoder(Encoder *encoder, uint32_t encoderOrigin, bool encoderReverse, float stepsPerCount, float trimLimit, float trimTime) {
+    if (axisNumber < 1 || axisNumber > 2) return;
+    this->encoder = encoder;
+    this->encoderOrigin = encoderOrigin;
+    this->encoderReverse = encoderReverse;
+    encoderStepsPerCount = stepsPerCount;
+    this->trimLimit = trimLimit/100.0F;
+    this->trimTime = trimTime;
+  }
+
+  // compares the encoder to the commanded position and updates the tracking rate trim
+  void StepDirMotor::encoderPoll() {
+    int32_t count = encoder->read();
+    if (count == INT32_MAX) return;
+    if (encoderReverse) count = -count;
+    long encoderSteps = lround(count*encoderStepsPerCount);
+
+    noInterrupts();
+    long steps = motorSteps;
+    bool tracking = synchronized && !inBacklash && microstepModeControl == MMC_TRACKING;
+    interrupts();
+
+    // only correct while tracking, slews and guides at high rate are left open loop
+    float limit = fabs(requestedFrequency)*trimLimit;
+    if (!tracking || slewing || limit == 0.0F || !encoder->ready || encoder->error) {
+      if (trimEngaged) { V(axisPrefix); VLF("encoder tracking correction stopped"); }
+      trimEngaged = false;
+      trim = 0.0F;
+      return;
+    }
+
+    // the commanded position is taken as where the axis is when tracking starts
+    if (!trimEngaged) {
+      encoderOffset = steps - encoderSteps;
+      trimApplied = 0.0F;
+      trimIntegral = 0.0F;
+      trimEngaged = true;
+      V(axisPrefix); VLF("encoder tracking correction started");
+      return;
+    }
+
+    // the commanded position is where open loop stepping puts the axis, less the steps the trim added
+    const float dt = STEP_DIR_ENCODER_PERIOD_MS/1000.0F;
+    trimApplied += trim*dt;
+    float error = (steps - trimApplied) - (encoderSteps + encoderOffset);
+
+    // PI correction, the integral takes up a steady rate error (gear ratio, etc.) without windup past the limit
+    trimIntegral += error*dt/(4.0F*trimTime*trimTime);
+    if (trimIntegral > limit) trimIntegral = limit; else if (trimIntegral < -limit) trimIntegral = -limit;
+    float t = error/trimTime + trimIntegral;
+    if (t > limit) t = limit; else if (t < -limit) t = -limit;
+    trim = t;
+  }
+#endif
+
 // swaps in/out fast unidirectional ISR for slewing 
 bool StepDirMotor::enableMoveFast(const bool fast) {
+  #ifdef STEP_DIR_RMT_PRESENT
+    if (fast && useRmt && rmt.isReady()) {
+      noInterrupts();
+      rmtBurst = 1;
+      interrupts();
+      rmt.attach();
+      if (direction == dirRev) {
+        tasks.setCallback(taskHandle, moveStepDirMotorBurstFR, this);
+        V(axisPrefix); VF("RMT Rev ISR swapped in at "); V(lastFrequency); VLF(" steps/sec.");
+      } else {
+        tasks.setCallback(taskHandle, moveStepDirMotorBurstFF, this);
+        V(axisPrefix); VF("RMT Fwd ISR swapped in at "); V(lastFrequency); VLF(" steps/sec.");
+      }
+      rmtActive = true;
+      return true;
+    }
+    if (!fast && rmtActive) {
+      tasks.setCallback(taskHandle, callback);
+      rmt.detach();
+      rmtActive = false;
+      V(axisPrefix); VF("RMT ISR swapped out at "); V(lastFrequency); VL(" steps/sec.");
+      return true;
+    }
+  #endif
+
   if (fast) {
     if (direction == dirRev) {
       tasks.setCallback(taskHandle, callbackFR);
@@ -340,9 +661,10 @@ bool StepDirMotor::enableMoveFast(const bool fast) {
   }
 #endif
 
-IRAM_ATTR void StepDirMotor::move(const int16_t stepPin) {
+template <int16_t STEP_PIN, int16_t DIR_PIN>
+IRAM_ATTR void StepDirMotor::move() {
   #if STEP_WAVE_FORM == PULSE
-    digitalWriteF(stepPin, stepClr);
+    StepDirPin<STEP_PIN>::write(stepClr);
   #endif
 
   #ifdef GPIO_DIRECTION_PINS
@@ -360,16 +682,22 @@ IRAM_ATTR void StepDirMotor::move(const int16_t stepPin) {
   #endif
 
   long lastTargetSteps = targetSteps;
-  if (synchronized && !inBacklash) targetSteps += step;
+  uint32_t lastStepPhase = stepPhase;
+  if (synchronized && !inBacklash) {
+    // the target moves a step each time the phase carries
+    stepPhase += stepIncrement;
+    if (stepPhase < lastStepPhase) targetSteps += step;
+  }
 
-  if (motorSteps > targetSteps || (inBacklash && direction == dirRev)) {
+  if (motorSteps > targetSteps || (inBacklash && direction == dirRev) || (backlashPreloadDir < 0 && backlashSteps > 0)) {
     if (direction != dirRev) {
       targetSteps = lastTargetSteps;
+      stepPhase = lastStepPhase;
       #ifdef GPIO_DIRECTION_PINS
         direction = DirSetRev;
       #else
         direction = dirRev;
-        digitalWriteF(Pins->dir, dirRev);
+        StepDirPin<DIR_PIN>::write(dirRev);
       #endif
       return;
     }
@@ -383,19 +711,20 @@ IRAM_ATTR void StepDirMotor::move(const int16_t stepPin) {
     }
 
     #ifdef SHARED_DIRECTION_PINS
-      if (axisNumber > 2) { digitalWriteF(Pins->dir, direction); delayNanoseconds(pulseWidth); }
+      if (axisNumber > 2) { StepDirPin<DIR_PIN>::write(direction); delayNanoseconds(pulseWidth); }
     #endif
-    digitalWriteF(stepPin, stepSet);
+    StepDirPin<STEP_PIN>::write(stepSet);
   } else
 
-  if (motorSteps < targetSteps || (inBacklash && direction == dirFwd)) {
+  if (motorSteps < targetSteps || (inBacklash && direction == dirFwd) || (backlashPreloadDir > 0 && backlashSteps < backlashAmountSteps)) {
     if (direction != dirFwd) {
       targetSteps = lastTargetSteps;
+      stepPhase = lastStepPhase;
       #ifdef GPIO_DIRECTION_PINS
         direction = DirSetFwd;
       #else
         direction = dirFwd;
-        digitalWriteF(Pins->dir, dirFwd);
+        StepDirPin<DIR_PIN>::write(dirFwd);
       #endif
       return;
     }
@@ -409,21 +738,22 @@ IRAM_ATTR void StepDirMotor::move(const int16_t stepPin) {
     }
 
     #ifdef SHARED_DIRECTION_PINS
-      if (axisNumber > 2) { digitalWriteF(Pins->dir, direction); delayNanoseconds(pulseWidth); }
+      if (axisNumber > 2) { StepDirPin<DIR_PIN>::write(direction); delayNanoseconds(pulseWidth); }
     #endif
-    digitalWriteF(stepPin, stepSet);
+    StepDirPin<STEP_PIN>::write(stepSet);
 
   } else if (!inBacklash) direction = DirNone;
 
   #if STEP_WAVE_FORM == SQUARE
-    } else digitalWriteF(stepPin, stepClr);
+    } else StepDirPin<STEP_PIN>::write(stepClr);
     takeStep = !takeStep;
   #endif
 }
 
-IRAM_ATTR void StepDirMotor::moveFF(const int16_t stepPin) {
+template <int16_t STEP_PIN, int16_t DIR_PIN>
+IRAM_ATTR void StepDirMotor::moveFF() {
   #if STEP_WAVE_FORM == PULSE
-    digitalWriteF(stepPin, stepClr);
+    StepDirPin<STEP_PIN>::write(stepClr);
   #endif
 
   if (microstepModeControl >= MMC_SLEWING_PAUSE) return;
@@ -438,20 +768,21 @@ IRAM_ATTR void StepDirMotor::moveFF(const int16_t stepPin) {
     motorSteps += stepSize;
 
     #ifdef SHARED_DIRECTION_PINS
-      if (axisNumber > 2) { digitalWriteF(Pins->dir, direction); delayNanoseconds(pulseWidth); }
+      if (axisNumber > 2) { StepDirPin<DIR_PIN>::write(direction); delayNanoseconds(pulseWidth); }
     #endif
-    digitalWriteF(stepPin, stepSet);
+    StepDirPin<STEP_PIN>::write(stepSet);
   }
 
   #if STEP_WAVE_FORM == SQUARE
-    } else digitalWriteF(stepPin, stepClr);
+    } else StepDirPin<STEP_PIN>::write(stepClr);
     takeStep = !takeStep;
   #endif
 }
 
-IRAM_ATTR void StepDirMotor::moveFR(const int16_t stepPin) {
+template <int16_t STEP_PIN, int16_t DIR_PIN>
+IRAM_ATTR void StepDirMotor::moveFR() {
   #if STEP_WAVE_FORM == PULSE
-    digitalWriteF(stepPin, stepClr);
+    StepDirPin<STEP_PIN>::write(stepClr);
   #endif
 
   if (microstepModeControl >= MMC_SLEWING_PAUSE) return;
@@ -466,15 +797,137 @@ IRAM_ATTR void StepDirMotor::moveFR(const int16_t stepPin) {
     motorSteps -= stepSize;
 
     #ifdef SHARED_DIRECTION_PINS
-      if (axisNumber > 2) { digitalWriteF(Pins->dir, direction); delayNanoseconds(pulseWidth); }
+      if (axisNumber > 2) { StepDirPin<DIR_PIN>::write(direction); delayNanoseconds(pulseWidth); }
     #endif
-    digitalWriteF(stepPin, stepSet);
+    StepDirPin<STEP_PIN>::write(stepSet);
   }
 
   #if STEP_WAVE_FORM == SQUARE
-    } else digitalWriteF(stepPin, stepClr);
+    } else StepDirPin<STEP_PIN>::write(stepClr);
     takeStep = !takeStep;
   #endif
 }
 
+#ifdef STEP_DIR_BENCHMARK
+  #define STEP_DIR_BENCHMARK_CALLS 256
+
+  // run the move() and moveFF() ISRs at max rate without motion, get their worst case cycles, the worst
+  // case cycles and entry latency seen in operation (the latter are reset), and the sustainable step rate
+  void StepDirMotor::benchmark(uint32_t *cyclesMove, uint32_t *cyclesFast, uint32_t *cyclesLive, uint32_t *latencyLive, float *stepRate) {
+    uint32_t worstMove = 0, worstFast = 0;
+
+    noInterrupts();
+
+    // save the ISR state
+    long lastTargetSteps = targetSteps;
+    long lastMotorSteps = motorSteps;
+    long lastStep = step;
+    bool lastSynchronized = synchronized;
+    bool lastTakeStep = takeStep;
+    bool lastInBacklash = inBacklash;
+    uint16_t lastBacklashSteps = backlashSteps;
+    int8_t lastBacklashPreloadDir = backlashPreloadDir;
+    uint8_t lastDirection = direction;
+    uint32_t lastStepPhase = stepPhase;
+    uint32_t lastStepIncrement = stepIncrement;
+    MicrostepModeControl lastMicrostepModeControl = microstepModeControl;
+
+    // a synchronized forward slew where every call takes a step, to pins that are never written
+    microstepModeControl = MMC_TRACKING;
+    synchronized = true;
+    step = 1;
+    stepIncrement = 0xFFFFFFFFUL;
+    backlashPreloadDir = 0;
+    direction = dirFwd;
+    for (int i = 0; i < STEP_DIR_BENCHMARK_CALLS; i++) {
+      uint32_t t0 = STEP_DIR_CYCLES();
+      move<STEP_DIR_PIN_NONE, STEP_DIR_PIN_NONE>();
+      uint32_t cycles = STEP_DIR_CYCLES() - t0;
+      if (cycles > worstMove) worstMove = cycles;
+    }
+    for (int i = 0; i < STEP_DIR_BENCHMARK_CALLS; i++) {
+      uint32_t t0 = STEP_DIR_CYCLES();
+      moveFF<STEP_DIR_PIN_NONE, STEP_DIR_PIN_NONE>();
+      uint32_t cycles = STEP_DIR_CYCLES() - t0;
+      if (cycles > worstFast) worstFast = cycles;
+    }
+
+    // restore the ISR state
+    targetSteps = lastTargetSteps;
+    motorSteps = lastMotorSteps;
+    step = lastStep;
+    synchronized = lastSynchronized;
+    takeStep = lastTakeStep;
+    inBacklash = lastInBacklash;
+    backlashSteps = lastBacklashSteps;
+    backlashPreloadDir = lastBacklashPreloadDir;
+    direction = lastDirection;
+    stepPhase = lastStepPhase;
+    stepIncrement = lastStepIncrement;
+    microstepModeControl = lastMicrostepModeControl;
+
+    // get and reset the operating statistics
+    uint32_t worstLive = benchmarkCyclesMax;
+    uint32_t worstLatency = benchmarkLatencyMax;
+    uint32_t count = benchmarkCount;
+    uint32_t total = benchmarkCycles;
+    benchmarkCyclesMax = 0;
+    benchmarkLatencyMax = 0;
+    benchmarkCount = 0;
+    benchmarkCycles = 0;
+
+    interrupts();
+
+    // the slew ISR cost per call, at least what was seen in operation, plus the worst entry latency
+    uint32_t cyclesPerCall = (worstLive > worstFast ? worstLive : worstFast) + worstLatency;
+    float rate = 0.0F;
+    if (cyclesPerCall > 0) rate = (float)F_CPU/cyclesPerCall;
+    #if STEP_WAVE_FORM == SQUARE
+      rate /= 2.0F;
+    #endif
+
+    *cyclesMove = worstMove;
+    *cyclesFast = worstFast;
+    *cyclesLive = worstLive;
+    *latencyLive = worstLatency;
+    *stepRate = rate;
+
+    V(axisPrefix); VF("benchmark move "); V(worstMove); VF(", moveFF "); V(worstFast);
+    VF(", in operation "); if (count > 0) V(total/count); else V(0); VF(" avg "); V(worstLive);
+    VF(" max and latency "); V(worstLatency); VF(" cycles, "); V(rate); VLF(" steps/s max");
+  }
+#endif
+
+#ifdef STEP_DIR_RMT_PRESENT
+  IRAM_ATTR void StepDirMotor::moveBurstFF() {
+    if (microstepModeControl >= MMC_SLEWING_PAUSE) return;
+
+    long count = rmtBurst;
+    if (synchronized) targetSteps += count*stepSize;
+
+    long remaining = targetSteps - motorSteps;
+    if (remaining <= 0) return;
+    remaining = (remaining + stepSize - 1)/stepSize;
+    if (count > remaining) count = remaining;
+
+    motorSteps += count*stepSize;
+    rmt.pulses(count);
+  }
+
+  IRAM_ATTR void StepDirMotor::moveBurstFR() {
+    if (microstepModeControl >= MMC_SLEWING_PAUSE) return;
+
+    long count = rmtBurst;
+    if (synchronized) targetSteps -= count*stepSize;
+
+    long remaining = motorSteps - targetSteps;
+    if (remaining <= 0) return;
+    remaining = (remaining + stepSize - 1)/stepSize;
+    if (count > remaining) count = remaining;
+
+    motorSteps -= count*stepSize;
+    rmt.pulses(count);
+  }
+#endif
+
 #endif
@@ -10,13 +10,43 @@
   #error "Configuration (Config.h): Having both GPIO_DIRECTION_PINS and SHARED_DIRECTION_PINS is not allowed"
 #endif
 
+// cycle counter for the step ISR benchmark
+#ifdef STEP_DIR_BENCHMARK
+  #if defined(ESP32)
+    #define STEP_DIR_CYCLES() ESP.getCycleCount()
+  #elif defined(DWT) && defined(CoreDebug)
+    #define STEP_DIR_CYCLES() DWT->CYCCNT
+  #else
+    #error "Configuration (Constants.h): STEP_DIR_BENCHMARK requires an ESP32 or ARM Cortex-M3/M4/M7 cycle counter"
+  #endif
+#endif
+
 #include "generic/Generic.h"
 #include "tmcLegacy/LegacySPI.h"
 #include "tmcLegacy/LegacyUART.h"
 #include "tmcStepper/StepperSPI.h"
 #include "tmcStepper/StepperUART.h"
+#include "StepDirRmt.h"
+#include "StepDirPin.h"
 #include "../Motor.h"
 
+#ifdef STEP_DIR_ENCODER_PRESENT
+  #include "../../../encoder/bissc/As37h39bb.h"
+  #include "../../../encoder/bissc/Jtw24.h"
+  #include "../../../encoder/cwCcw/CwCcw.h"
+  #include "../../../encoder/pulseDir/PulseDir.h"
+  #include "../../../encoder/quadrature/Quadrature.h"
+  #include "../../../encoder/quadratureEsp32/QuadratureEsp32.h"
+  #include "../../../encoder/quadratureStm32/QuadratureStm32.h"
+  #include "../../../encoder/quadratureTeensy4/QuadratureTeensy4.h"
+  #include "../../../encoder/serialBridge/SerialBridge.h"
+
+  // rate in ms the axis encoder is compared to the commanded position for the tracking correction
+  #ifndef STEP_DIR_ENCODER_PERIOD_MS
+    #define STEP_DIR_ENCODER_PERIOD_MS 100
+  #endif
+#endif
+
 typedef struct StepDirPins {
   int16_t step;
   uint8_t stepState;
@@ -25,6 +55,14 @@ typedef struct StepDirPins {
   uint8_t enabledState;
 } StepDirPins;
 
+// use integer math for the step period on processors with a hardware divide but no FPU (Cortex-M3, Teensy3.2)
+#if !defined(STEP_DIR_INTEGER_PERIOD) && defined(__SOFTFP__) && defined(__ARM_FEATURE_IDIV)
+  #define STEP_DIR_INTEGER_PERIOD
+#endif
+
+// longest step period in sub-micros (130 seconds)
+#define STEP_DIR_PERIOD_MAX 2080000000UL
+
 #define DirNone 253
 #define DirSetRev 254
 #define DirSetFwd 255
@@ -54,10 +92,13 @@ class StepDirMotor : public Motor {
     // sets motor enable on/off (if possible)
     void enable(bool value);
 
-    // calibrate stealthChop then return to tracking mode
-    void calibrateDriver() {
+    // calibrate stealthChop then return to tracking mode, the driver stays enabled in between
+    bool calibrateDriverStart() {
       digitalWriteEx(Pins->enable, Pins->enabledState);
-      driver->calibrateDriver();
+      return driver->calibrateDriverStart();
+    }
+    void calibrateDriverFinish() {
+      driver->calibrateDriverFinish();
       digitalWriteEx(Pins->enable, !Pins->enabledState);
     }
 
@@ -70,6 +111,9 @@ class StepDirMotor : public Motor {
     // set frequency (+/-) in steps per second negative frequencies move reverse in direction (0 stops motion)
     void setFrequencySteps(float frequency);
 
+    // take up backlash toward the direction of the next move while stopped, DIR_NONE cancels
+    void setBacklashPreload(Direction direction);
+
     // get tracking mode steps per slewing mode step
     inline int getStepsPerStepSlewing() { return driver->getMicrostepRatio(); }
 
@@ -82,6 +126,26 @@ class StepDirMotor : public Motor {
     // set slewing state (hint that we are about to slew or are done slewing)
     void setSlewing(bool state);
 
+    // set what the axis is doing so the driver can pick its current
+    void setCurrentProfile(CurrentProfile profile);
+
+    #ifdef STEP_DIR_ENCODER_PRESENT
+      // resets motor and target angular position in steps, also zeros backlash and index
+      void resetPositionSteps(long value);
+
+      // tracking correction from an axis encoder (axis1 and axis2 only), call before init()
+      // encoderOrigin is the count at home (for absolute encoders), stepsPerCount is motor steps per encoder count,
+      // trimLimit the largest correction in % of the tracking rate, and trimTime the time constant in seconds the
+      // position error is removed over
+      void setEncoder(Encoder *encoder, uint32_t encoderOrigin, bool encoderReverse, float stepsPerCount, float trimLimit, float trimTime);
+
+      // return the encoder count, if present
+      int32_t getEncoderCount() { return encoder == NULL ? 0 : encoder->count; }
+
+      // compares the encoder to the commanded position and updates the tracking rate trim
+      void encoderPoll();
+    #endif
+
     #if defined(GPIO_DIRECTION_PINS)
       // monitor and respond to motor state as required
       void poll() { updateMotorDirection(); }
@@ -91,13 +155,43 @@ class StepDirMotor : public Motor {
     #endif
 
     // sets dir as required and moves coord toward target at setFrequencySteps() rate
-    void move(const int16_t stepPin);
+    template <int16_t STEP_PIN, int16_t DIR_PIN> void move();
 
     // fast forward axis movement, no backlash, no mode switching
-    void moveFF(const int16_t stepPin);
+    template <int16_t STEP_PIN, int16_t DIR_PIN> void moveFF();
 
     // fast reverse axis movement, no backlash, no mode switching
-    void moveFR(const int16_t stepPin);
+    template <int16_t STEP_PIN, int16_t DIR_PIN> void moveFR();
+
+    #ifdef STEP_DIR_BENCHMARK
+      // record cycles and entry latency for a step ISR call that started at cycle count t0
+      inline void benchmarkRecord(uint32_t t0) {
+        uint32_t cycles = STEP_DIR_CYCLES() - t0;
+        if (cycles > benchmarkCyclesMax) benchmarkCyclesMax = cycles;
+        benchmarkCycles += cycles;
+        benchmarkCount++;
+
+        // an entry later than the timer period is latency, an early one follows a late one
+        uint32_t interval = t0 - benchmarkLastEntry;
+        benchmarkLastEntry = t0;
+        if (benchmarkPeriodCycles > 0 && interval > benchmarkPeriodCycles && interval < benchmarkPeriodCycles*2) {
+          uint32_t latency = interval - benchmarkPeriodCycles;
+          if (latency > benchmarkLatencyMax) benchmarkLatencyMax = latency;
+        }
+      }
+
+      // run the move() and moveFF() ISRs at max rate without motion, get their worst case cycles, the worst
+      // case cycles and entry latency seen in operation (the latter are reset), and the sustainable step rate
+      void benchmark(uint32_t *cyclesMove, uint32_t *cyclesFast, uint32_t *cyclesLive, uint32_t *latencyLive, float *stepRate);
+    #endif
+
+    #ifdef STEP_DIR_RMT_PRESENT
+      // fast forward axis movement using RMT step pulse bursts, no backlash, no mode switching
+      void moveBurstFF();
+
+      // fast reverse axis movement using RMT step pulse bursts, no backlash, no mode switching
+      void moveBurstFR();
+    #endif
 
     // a stepper motor driver, should not be used above the StepDir class
     StepDirDriver *driver;
@@ -123,8 +217,9 @@ class StepDirMotor : public Motor {
     volatile int16_t homeSteps = 1;      // step count for microstep sequence between home positions (driver indexer)
     volatile int16_t stepSize = 1;       // step size during slews (for micro-step mode switching)
     volatile bool takeStep = false;      // should we take a step
+    volatile uint32_t stepPhase = 0;     // target motion phase accumulator, a carry is one step
+    volatile uint32_t stepIncrement = 0xFFFFFFFFUL; // fraction of a step each timer tick is worth (2^32 for one)
 
-    float currentFrequency = 0.0F;       // last frequency set 
     float lastFrequency = 0.0F;          // last frequency requested
     unsigned long lastPeriod = 0;        // last timer period (in sub-micros)
     unsigned long lastPeriodSet = 0;     // last timer period actually set (in sub-micros)
@@ -132,11 +227,46 @@ class StepDirMotor : public Motor {
 
     volatile MicrostepModeControl microstepModeControl = MMC_TRACKING;
 
+    bool slewing = false;                // slewing decay mode and current are in use
+    bool fastBand = false;               // high speed decay mode and current are in use
+
     bool useFastHardwareTimers = true;
 
     void (*callback)() = NULL;
     void (*callbackFF)() = NULL;
     void (*callbackFR)() = NULL;
+
+    #ifdef STEP_DIR_BENCHMARK
+      volatile uint32_t benchmarkCycles = 0;       // total cycles in the step ISR since the last report
+      volatile uint32_t benchmarkCount = 0;        // step ISR calls since the last report
+      volatile uint32_t benchmarkCyclesMax = 0;    // worst case step ISR cycles since the last report
+      volatile uint32_t benchmarkLatencyMax = 0;   // worst case step ISR entry latency cycles since the last report
+      volatile uint32_t benchmarkLastEntry = 0;    // cycle count at the last step ISR entry
+      volatile uint32_t benchmarkPeriodCycles = 0; // timer period in cycles, 0 when stopped
+    #endif
+
+    #ifdef STEP_DIR_ENCODER_PRESENT
+      Encoder *encoder = NULL;
+      uint32_t encoderOrigin = 0;
+      bool encoderReverse = false;
+      float encoderStepsPerCount = 1.0F;
+      float trimLimit = 0.0F;            // largest trim as a fraction of the requested frequency
+      float trimTime = 2.0F;             // correction time constant in seconds
+      bool trimEngaged = false;          // the encoder offset is set and the correction is running
+      long encoderOffset = 0;            // motor steps less encoder steps when the correction started
+      float trimApplied = 0.0F;          // steps the trim has added to the motion since it started
+      float trimIntegral = 0.0F;         // integral part of the trim in steps per second
+      volatile float trim = 0.0F;        // tracking rate trim in steps per second
+      float requestedFrequency = 0.0F;   // last frequency requested, without the trim
+      uint8_t encoderHandle = 0;
+    #endif
+
+    #ifdef STEP_DIR_RMT_PRESENT
+      StepDirRmt rmt;
+      bool useRmt = false;               // RMT step pulse generation is enabled for this axis
+      bool rmtActive = false;            // RMT burst ISR is swapped in
+      volatile uint8_t rmtBurst = 1;     // step pulses per burst
+    #endif
 };
 
 #endif
\ No newline at end of file
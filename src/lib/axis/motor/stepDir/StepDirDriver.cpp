@@ -5,6 +5,13 @@
 
 #ifdef STEP_DIR_MOTOR_PRESENT
 
+#include "../../../tasks/OnTask.h"
+#include "../../../counters/Counters.h"
+
+#ifndef STEP_DIR_STATUS_PERIOD_MS
+  #define STEP_DIR_STATUS_PERIOD_MS 200 // status refresh period for each driver
+#endif
+
 // the various microsteps for different driver models, with the bit modes for each
 #define DRIVER_MODEL_COUNT 17 
 
@@ -90,9 +97,12 @@ void StepDirDriver::init(float param1, float param2, float param3, float param4,
   settings.currentGoto = round(param5);
   UNUSED(param6);
 
+  faultCounter = counters.add("DrvFlt");
+
   if (settings.intpol == ON) settings.intpol = true; else settings.intpol = false;
   if (settings.decay == OFF) settings.decay = STEALTHCHOP;
   if (settings.decaySlewing == OFF) settings.decaySlewing = SPREADCYCLE;
+  if (settings.decayFast == OFF) settings.decayFast = settings.decaySlewing;
 
   VF("MSG: StepDirDriver"); V(axisNumber); VF(", init model "); V(DRIVER_NAME[settings.model]);
   VF(" u-step mode "); if (settings.microsteps == OFF) { VF("OFF (assuming 1X)"); settings.microsteps = 1; } else { V(settings.microsteps); VF("X"); }
@@ -176,8 +186,51 @@ int StepDirDriver::subdivisionsToCode(long microsteps) {
   return OFF;
 }
 
+// the shared status poll reads one driver per call so a slow (UART) bus never stalls an axis task
+static StepDirDriver *statusDriver[9];
+static uint8_t statusDriverCount = 0;
+static uint8_t statusDriverIndex = 0;
+static uint8_t statusHandle = 0;
+
+void statusPollWrapper() {
+  if (statusDriverCount == 0) return;
+  statusDriver[statusDriverIndex]->readStatus();
+  if (++statusDriverIndex >= statusDriverCount) statusDriverIndex = 0;
+}
+
+// add this driver to the shared status poll, one register read per poll across all axes
+void StepDirDriver::statusPollRegister() {
+  if (statusDriverCount >= 9) return;
+  statusDriver[statusDriverCount++] = this;
+
+  if (statusHandle == 0) {
+    VF("MSG: StepDirDriver, start status poll task (priority 7)... ");
+    statusHandle = tasks.add(STEP_DIR_STATUS_PERIOD_MS, 0, true, 7, statusPollWrapper, "DrvSts");
+    if (statusHandle) { VLF("success"); } else { VLF("FAILED!"); return; }
+  }
+
+  // spread the reads so each driver is still refreshed once per period
+  tasks.setPeriod(statusHandle, STEP_DIR_STATUS_PERIOD_MS/statusDriverCount);
+}
+
 // update status info. for driver
+// the run current in mA for tracking mode, ITRACK while only tracking unless it has stalled there
+int16_t StepDirDriver::currentTracking() {
+  if (currentProfile == CP_TRACKING && settings.currentTrack != OFF && !currentTrackStalled) return settings.currentTrack;
+  return settings.currentRun;
+}
+
 void StepDirDriver::updateStatus() {
+  if (status.fault && !faultLast) counters.increment(faultCounter);
+  faultLast = status.fault;
+
+  // a stall at the lower tracking current means this mount needs more, use IRUN from then on
+  if (status.stalled && currentProfile == CP_TRACKING && settings.currentTrack != OFF && !currentTrackStalled) {
+    DF("WRN: StepDirDriver"); D(axisNumber); DLF(", stalled while tracking at ITRACK, using IRUN");
+    currentTrackStalled = true;
+    modeDecayTracking();
+  }
+
   #if DEBUG == VERBOSE
     if ((status.outputA.shortToGround     != lastStatus.outputA.shortToGround) ||
         (status.outputA.openLoad          != lastStatus.outputA.openLoad) ||
@@ -31,6 +31,11 @@ typedef struct StepDirDriverSettings {
   int8_t  decay;
   int8_t  decaySlewing;
   int8_t  status;
+  int16_t stall;
+  int8_t  decayFast;
+  int16_t currentFast;
+  float   rateFast;
+  int16_t currentTrack;
 } StepDirDriverSettings;
 
 class StepDirDriver {
@@ -56,20 +61,35 @@ class StepDirDriver {
     // set decay mode for slewing
     virtual void modeDecaySlewing();
 
+    // set decay mode and current for slewing above the fast rate
+    virtual void modeDecayFast() {}
+
+    // set what the axis is doing, modeDecayTracking() then applies the current for it
+    inline void setCurrentProfile(CurrentProfile profile) { currentProfile = profile; }
+
+    // get what the axis is doing
+    inline CurrentProfile getCurrentProfile() { return currentProfile; }
+
     // get microstep ratio for slewing
     inline int getMicrostepRatio() { return microstepRatio; }
 
     // update status info. for driver
     virtual void updateStatus();
 
+    // read status registers from the driver hardware, called round-robin by the shared status poll
+    virtual void readStatus() {}
+
     // get status info.
     inline DriverStatus getStatus() { return status; }
 
     // secondary way to power down not using the enable pin
     virtual bool enable(bool state) { UNUSED(state); return false; }
 
-    // calibrate the motor driver if required
-    virtual void calibrateDriver() {}
+    // start calibrating the motor driver, true if it must be held at standstill before calibrateDriverFinish()
+    virtual bool calibrateDriverStart() { return false; }
+
+    // finish calibrating the motor driver and return to tracking mode
+    virtual void calibrateDriverFinish() {}
 
     // get the pulse width in nanoseconds, if unknown (-1) returns 2000 nanoseconds
     long getPulseWidth();
@@ -80,9 +100,18 @@ class StepDirDriver {
     // true if switching microstep modes at high speed is allowed
     bool modeSwitchFastAllowed = false;
 
+    // true if the driver has a decay mode and current band for slewing above the fast rate
+    bool modeFastAllowed = false;
+
     StepDirDriverSettings settings;
 
   protected:
+    // add this driver to the shared status poll, one register read per poll across all axes
+    void statusPollRegister();
+
+    // the run current in mA for tracking mode, ITRACK while only tracking unless it has stalled there
+    int16_t currentTracking();
+
     inline float mAToCs(float mA) { return 32.0F*(((mA/1000.0F)*(rSense+0.02F))/0.325F) - 1.0F; }
     float rSense = 0.11F;
 
@@ -92,6 +121,13 @@ class StepDirDriver {
       DriverStatus lastStatus = {false, {false, false}, {false, false}, false, false, false, false};
     #endif
     unsigned long timeLastStatusUpdate = 0;
+
+    // health counter shared by all drivers, counts each time a fault is first seen
+    uint8_t faultCounter = 0;
+    bool faultLast = false;
+
+    CurrentProfile currentProfile = CP_IDLE;
+    bool currentTrackStalled = false;
   
     const int16_t* microsteps;
     int16_t microstepRatio = 1;
@@ -0,0 +1,58 @@
+// -----------------------------------------------------------------------------------
+// axis step/dir motor, step and direction pin writes resolved at compile time for the step ISRs
+#pragma once
+
+#include "../../../../Common.h"
+
+#ifdef STEP_DIR_MOTOR_PRESENT
+
+#if defined(ESP32) && (defined(CONFIG_IDF_TARGET_ESP32) || defined(CONFIG_IDF_TARGET_ESP32S3))
+  #include <soc/gpio_struct.h>
+  #define STEP_DIR_PIN_ESP32_W1TS
+#endif
+
+// a pin number that is never written, lets the step ISRs run without motion for the self-test
+#define STEP_DIR_PIN_NONE -32767
+
+// pins 0 to 255 are written directly to the port registers where the platform allows, others (OFF,
+// DAC, and external GPIO) fall back to digitalWriteF()
+template <int16_t PIN>
+class StepDirPin {
+  public:
+    static const bool direct = PIN >= 0 && PIN <= 0xFF;
+
+    static inline __attribute__((always_inline)) void write(uint8_t state) {
+      if (PIN == STEP_DIR_PIN_NONE) return;
+      if (!direct) { digitalWriteF(PIN, state); return; }
+
+      #if defined(__TEENSYDUINO__)
+        // a constant pin number makes digitalWriteFast() a single CORE_PINx_PORTSET/PORTCLEAR store
+        digitalWriteFast((uint8_t)PIN, state);
+      #elif defined(STEP_DIR_PIN_ESP32_W1TS)
+        if (PIN < 32) {
+          if (state) GPIO.out_w1ts = 1UL << (PIN & 31); else GPIO.out_w1tc = 1UL << (PIN & 31);
+        } else {
+          if (state) GPIO.out1_w1ts.val = 1UL << (PIN & 31); else GPIO.out1_w1tc.val = 1UL << (PIN & 31);
+        }
+      #elif defined(ARDUINO_ARCH_STM32)
+        // the upper half of BSRR resets the pin
+        if (state) port->BSRR = mask; else port->BSRR = mask << 16;
+      #else
+        digitalWriteF(PIN, state);
+      #endif
+    }
+
+  private:
+    #if defined(ARDUINO_ARCH_STM32)
+      // the STM32 pin map isn't constexpr so the port and mask are resolved once at startup
+      static GPIO_TypeDef * const port;
+      static const uint32_t mask;
+    #endif
+};
+
+#if defined(ARDUINO_ARCH_STM32)
+  template <int16_t PIN> GPIO_TypeDef * const StepDirPin<PIN>::port = StepDirPin<PIN>::direct ? digitalPinToPort(PIN) : NULL;
+  template <int16_t PIN> const uint32_t StepDirPin<PIN>::mask = StepDirPin<PIN>::direct ? digitalPinToBitMask(PIN) : 0;
+#endif
+
+#endif
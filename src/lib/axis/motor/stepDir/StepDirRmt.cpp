@@ -0,0 +1,93 @@
+// -----------------------------------------------------------------------------------
+// axis step/dir motor, ESP32 RMT peripheral step pulse generation
+
+#include "StepDirRmt.h"
+
+#if defined(STEP_DIR_MOTOR_PRESENT) && defined(STEP_DIR_RMT_PRESENT)
+
+#include <driver/rmt.h>
+#include <hal/rmt_ll.h>
+#include <soc/rmt_struct.h>
+
+// RMT clock is 80MHz/2 for 25ns per tick
+#define RMT_CLK_DIV 2
+#define RMT_TICKS_PER_US 40
+#define RMT_DURATION_MAX 32767
+
+bool StepDirRmt::init(uint8_t channel, int16_t stepPin, uint8_t stepSet, uint32_t pulseWidth) {
+  if (channel >= RMT_CHANNEL_MAX || !GPIO_IS_VALID_OUTPUT_GPIO(stepPin)) return false;
+
+  this->channel = channel;
+  this->stepPin = stepPin;
+  this->stepSet = stepSet;
+  this->pulseWidth = pulseWidth;
+
+  rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)stepPin, (rmt_channel_t)channel);
+  config.clk_div = RMT_CLK_DIV;
+  config.mem_block_num = 1;
+  config.tx_config.loop_en = false;
+  config.tx_config.carrier_en = false;
+  config.tx_config.idle_output_en = true;
+  config.tx_config.idle_level = stepSet == HIGH ? RMT_IDLE_LEVEL_LOW : RMT_IDLE_LEVEL_HIGH;
+  if (rmt_config(&config) != ESP_OK) return false;
+
+  // rmt_config() claims the pin, hand it back to GPIO until slewing
+  attached = true;
+  detach();
+
+  ready = true;
+  return true;
+}
+
+void StepDirRmt::setStepPeriod(unsigned long period) {
+  // sub-micros to RMT ticks
+  unsigned long ticks = (period*RMT_TICKS_PER_US)/16;
+  if (ticks < 2) ticks = 2;
+
+  #if STEP_WAVE_FORM == SQUARE
+    unsigned long ticksHigh = ticks/2;
+  #else
+    unsigned long ticksHigh = (pulseWidth*RMT_TICKS_PER_US)/1000;
+    if (ticksHigh < 1) ticksHigh = 1;
+    if (ticksHigh > ticks/2) ticksHigh = ticks/2;
+  #endif
+
+  // only the last pulse in a burst can be longer than the RMT allows, the timer covers the rest
+  unsigned long ticksLow = ticks - ticksHigh;
+  if (ticksHigh > RMT_DURATION_MAX) ticksHigh = RMT_DURATION_MAX;
+  if (ticksLow > RMT_DURATION_MAX) ticksLow = RMT_DURATION_MAX;
+
+  rmt_item32_t pulse;
+  pulse.level0 = stepSet;
+  pulse.duration0 = ticksHigh;
+  pulse.level1 = !stepSet;
+  pulse.duration1 = ticksLow;
+  item = pulse.val;
+}
+
+void StepDirRmt::attach() {
+  if (attached || stepPin < 0) return;
+  rmt_set_pin((rmt_channel_t)channel, RMT_MODE_TX, (gpio_num_t)stepPin);
+  attached = true;
+}
+
+void StepDirRmt::detach() {
+  if (!attached) return;
+  rmt_tx_stop((rmt_channel_t)channel);
+  pinMatrixOutDetach(stepPin, false, false);
+  pinMode(stepPin, OUTPUT);
+  digitalWrite(stepPin, !stepSet);
+  attached = false;
+}
+
+IRAM_ATTR void StepDirRmt::pulses(uint8_t count) {
+  if (count > STEP_DIR_RMT_BURST_MAX) count = STEP_DIR_RMT_BURST_MAX;
+
+  for (uint8_t i = 0; i < count; i++) RMTMEM.chan[channel].data32[i].val = item;
+  RMTMEM.chan[channel].data32[count].val = 0;
+
+  rmt_ll_tx_reset_pointer(&RMT, channel);
+  rmt_ll_tx_start(&RMT, channel);
+}
+
+#endif
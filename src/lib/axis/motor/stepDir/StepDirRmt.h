@@ -0,0 +1,46 @@
+// -----------------------------------------------------------------------------------
+// axis step/dir motor, ESP32 RMT peripheral step pulse generation
+#pragma once
+
+#include "../../../../Common.h"
+
+#if defined(STEP_DIR_MOTOR_PRESENT) && defined(STEP_DIR_RMT_PRESENT)
+
+// target timer period while streaming step bursts (in sub-micros, 1ms)
+#ifndef STEP_DIR_RMT_BURST_PERIOD
+  #define STEP_DIR_RMT_BURST_PERIOD 16000
+#endif
+
+// one RMT memory block holds 64 items, one is reserved for the end marker
+#define STEP_DIR_RMT_BURST_MAX 63
+
+class StepDirRmt {
+  public:
+    // sets up the RMT channel for the given step pin, the pin stays under GPIO control until attached
+    bool init(uint8_t channel, int16_t stepPin, uint8_t stepSet, uint32_t pulseWidth);
+
+    // set the step period (in sub-micros) used for each pulse in a burst
+    void setStepPeriod(unsigned long period);
+
+    // routes the step pin to the RMT channel
+    void attach();
+
+    // routes the step pin back to GPIO control
+    void detach();
+
+    // starts sending a burst of count (1 to STEP_DIR_RMT_BURST_MAX) step pulses
+    void pulses(uint8_t count);
+
+    inline bool isReady() { return ready; }
+
+  private:
+    bool ready = false;
+    bool attached = false;
+    uint8_t channel = 0;
+    int16_t stepPin = -1;
+    uint8_t stepSet = HIGH;
+    uint32_t pulseWidth = 2000;          // step pulse width in nanoseconds
+    volatile uint32_t item = 0;          // RMT item for one step pulse
+};
+
+#endif
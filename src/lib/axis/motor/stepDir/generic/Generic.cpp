@@ -113,6 +113,7 @@ void StepDirGeneric::updateStatus() {
   if (settings.status == LOW || settings.status == HIGH) {
     status.fault = digitalReadEx(Pins->fault) == settings.status;
   }
+  StepDirDriver::updateStatus();
 }
 
 int8_t StepDirGeneric::getDecayPinState(int8_t decay) {
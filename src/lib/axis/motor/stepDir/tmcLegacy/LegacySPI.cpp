@@ -47,7 +47,7 @@ void StepDirTmcSPI::init(float param1, float param2, float param3, float param4,
 
   // get TMC SPI driver ready
   driver.init(settings.model, Pins->m0, Pins->m1, Pins->m2, Pins->m3, axisNumber);
-  driver.mode(settings.intpol, settings.decay, microstepCode, settings.currentRun, settings.currentHold);
+  driver.mode(settings.intpol, settings.decay, microstepCode, currentTracking(), settings.currentHold);
 
   // automatically set fault status for known drivers
   status.active = settings.status != OFF;
@@ -113,7 +113,7 @@ int StepDirTmcSPI::modeMicrostepSlewing() {
 }
 
 void StepDirTmcSPI::modeDecayTracking() {
-  driver.mode(settings.intpol, settings.decay, microstepCode, settings.currentRun, settings.currentHold);
+  driver.mode(settings.intpol, settings.decay, microstepCode, currentTracking(), settings.currentHold);
 }
 
 void StepDirTmcSPI::modeDecaySlewing() {
@@ -165,7 +165,7 @@ void StepDirTmcSPI::updateStatus() {
 // secondary way to power down not using the enable pin
 bool StepDirTmcSPI::enable(bool state) {
   if (state) {
-    driver.mode(settings.intpol, settings.decay, microstepCode, settings.currentRun, settings.currentHold);
+    driver.mode(settings.intpol, settings.decay, microstepCode, currentTracking(), settings.currentHold);
   } else {
     driver.mode(settings.intpol, STEALTHCHOP, microstepCode, settings.currentRun, 0);
   }
@@ -174,12 +174,20 @@ bool StepDirTmcSPI::enable(bool state) {
 }
 
 // calibrate the motor driver if required
-void StepDirTmcSPI::calibrateDriver() {
+bool StepDirTmcSPI::calibrateDriverStart() {
   if (settings.decay == STEALTHCHOP || settings.decaySlewing == STEALTHCHOP) {
     VF("MSG: StepDirDriver"); V(axisNumber); VL(", TMC standstill automatic current calibration");
+    // the driver may have lost power, rewrite all registers
+    driver.invalidate();
     driver.mode(settings.intpol, STEALTHCHOP, microstepCode, settings.currentRun, settings.currentRun);
-    delay(1000);
-    driver.mode(settings.intpol, settings.decay, microstepCode, settings.currentRun, settings.currentHold);
+    return true;
+  }
+  return false;
+}
+
+void StepDirTmcSPI::calibrateDriverFinish() {
+  if (settings.decay == STEALTHCHOP || settings.decaySlewing == STEALTHCHOP) {
+    driver.mode(settings.intpol, settings.decay, microstepCode, currentTracking(), settings.currentHold);
   }
 }
 
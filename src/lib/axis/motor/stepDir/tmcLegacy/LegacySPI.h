@@ -43,7 +43,8 @@ class StepDirTmcSPI : public StepDirDriver {
     bool enable(bool state);
 
     // calibrate the motor driver if required
-    void calibrateDriver();
+    bool calibrateDriverStart();
+    void calibrateDriverFinish();
 
     TmcSPI driver;
 
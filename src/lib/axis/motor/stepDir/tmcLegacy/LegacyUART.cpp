@@ -102,9 +102,9 @@ void StepDirTmcUART::init(float param1, float param2, float param3, float param4
     VF("WRN: StepDirDriver"); V(axisNumber); VLF(", TMC UART driver interpolation control not supported");
   }
   modeMicrostepTracking();
-  driver->setRunCurrent(settings.currentRun/25); // current in %
-  driver->setHoldCurrent(settings.currentHold/25); // current in %
-  driver->disableStealthChop();
+  setRunCurrent(settings.currentRun/25); // current in %
+  setHoldCurrent(settings.currentHold/25); // current in %
+  setStealthChop(false);
 
   // automatically set fault status for known drivers
   status.active = settings.status != OFF;
@@ -158,28 +158,28 @@ bool StepDirTmcUART::validateParameters(float param1, float param2, float param3
 }
 
 void StepDirTmcUART::modeMicrostepTracking() {
-  driver->setMicrostepsPerStep(settings.microsteps);
+  setMicrosteps(settings.microsteps);
 }
 
 int StepDirTmcUART::modeMicrostepSlewing() {
   if (microstepRatio > 1) {
-    driver->setMicrostepsPerStep(settings.microstepsSlewing);
+    setMicrosteps(settings.microstepsSlewing);
   }
   return microstepRatio;
 }
 
 void StepDirTmcUART::modeDecayTracking() {
-  if (settings.decay == SPREADCYCLE) driver->disableStealthChop(); else driver->enableStealthChop();
-  driver->setRunCurrent(settings.currentRun/25); // current in %
-  driver->setHoldCurrent(settings.currentHold/25); // current in %
+  setStealthChop(settings.decay != SPREADCYCLE);
+  setRunCurrent(currentTracking()/25); // current in %
+  setHoldCurrent(settings.currentHold/25); // current in %
 }  
 
 void StepDirTmcUART::modeDecaySlewing() {
   int IGOTO = settings.currentGoto;
   if (IGOTO == OFF) IGOTO = settings.currentRun;
-  if (settings.decaySlewing == SPREADCYCLE) driver->disableStealthChop(); else driver->enableStealthChop();
-  driver->setRunCurrent(IGOTO/25); // current in %
-  driver->setHoldCurrent(settings.currentHold/25); // current in %
+  setStealthChop(settings.decaySlewing != SPREADCYCLE);
+  setRunCurrent(IGOTO/25); // current in %
+  setHoldCurrent(settings.currentHold/25); // current in %
 }
 
 void StepDirTmcUART::updateStatus() {
@@ -217,25 +217,61 @@ bool StepDirTmcUART::enable(bool state) {
   if (state) {
     modeDecayTracking();
   } else {
-    driver->enableStealthChop();
-    driver->setHoldCurrent(0);
+    setStealthChop(true);
+    setHoldCurrent(0);
   }
 
   return true;
 }
 
 // calibrate the motor driver if required
-void StepDirTmcUART::calibrateDriver() {
+bool StepDirTmcUART::calibrateDriverStart() {
   if (settings.decay == STEALTHCHOP || settings.decaySlewing == STEALTHCHOP) {
     VF("MSG: StepDirDriver"); V(axisNumber); VL(", TMC standstill automatic current calibration");
-    driver->setRunCurrent(settings.currentRun/25); // current in %
-    driver->setHoldCurrent(settings.currentRun/25); // current in %
-    driver->enableStealthChop();
-    delay(1000);
-    driver->setRunCurrent(settings.currentRun/25); // current in %
-    driver->setHoldCurrent(settings.currentHold/25); // current in %
-    driver->disableStealthChop();
+    // the driver may have lost power, forget the cached register values so everything is rewritten
+    lastMicrosteps = -1; lastRunCurrent = -1; lastHoldCurrent = -1; lastStealthChop = -1;
+    setRunCurrent(settings.currentRun/25); // current in %
+    setHoldCurrent(settings.currentRun/25); // current in %
+    setStealthChop(true);
+    return true;
   }
+  return false;
+}
+
+void StepDirTmcUART::calibrateDriverFinish() {
+  if (settings.decay == STEALTHCHOP || settings.decaySlewing == STEALTHCHOP) {
+    setRunCurrent(currentTracking()/25); // current in %
+    setHoldCurrent(settings.currentHold/25); // current in %
+    setStealthChop(false);
+  }
+}
+
+// set the microstep mode, CHOPCONF is only written if the mode changes
+void StepDirTmcUART::setMicrosteps(int microsteps) {
+  if (microsteps == lastMicrosteps) return;
+  lastMicrosteps = microsteps;
+  driver->setMicrostepsPerStep(microsteps);
+}
+
+// set the run current in %, IHOLD_IRUN is only written if the value changes
+void StepDirTmcUART::setRunCurrent(int percent) {
+  if (percent == lastRunCurrent) return;
+  lastRunCurrent = percent;
+  driver->setRunCurrent(percent);
+}
+
+// set the hold current in %, IHOLD_IRUN is only written if the value changes
+void StepDirTmcUART::setHoldCurrent(int percent) {
+  if (percent == lastHoldCurrent) return;
+  lastHoldCurrent = percent;
+  driver->setHoldCurrent(percent);
+}
+
+// set the decay mode, GCONF is only written if the mode changes
+void StepDirTmcUART::setStealthChop(bool state) {
+  if (state == lastStealthChop) return;
+  lastStealthChop = state;
+  if (state) driver->enableStealthChop(); else driver->disableStealthChop();
 }
 
 #endif
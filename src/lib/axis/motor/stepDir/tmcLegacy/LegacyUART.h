@@ -67,7 +67,8 @@ class StepDirTmcUART : public StepDirDriver {
     bool enable(bool state);
 
     // calibrate the motor driver if required
-    void calibrateDriver();
+    bool calibrateDriverStart();
+    void calibrateDriverFinish();
 
     TMC2209Stepper *driver;
 
@@ -75,6 +76,18 @@ class StepDirTmcUART : public StepDirDriver {
     // checks if decay pin should be HIGH/LOW for a given decay setting
     int8_t getDecayPinState(int8_t decay);
 
+    // write the microstep mode, currents, and decay mode only when they change
+    void setMicrosteps(int microsteps);
+    void setRunCurrent(int percent);
+    void setHoldCurrent(int percent);
+    void setStealthChop(bool state);
+
+    // last values written to the driver registers, -1 when unknown
+    int16_t lastMicrosteps = -1;
+    int16_t lastRunCurrent = -1;
+    int16_t lastHoldCurrent = -1;
+    int8_t lastStealthChop = -1;
+
     const int MicroStepCodeToMode[9] = {256, 128, 64, 32, 16, 8, 4, 2, 1};
 
     // TMC2209/TMC5160 specific
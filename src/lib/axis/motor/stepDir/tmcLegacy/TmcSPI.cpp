@@ -104,8 +104,11 @@ bool TmcSPI::mode(bool intpol, int decay_mode, byte micro_step_code, int irun, i
     if (model == TMC5160) last_chop_config = (cc_toff<<0)+(cc_hstart<<4)+(cc_hend<<7)+(cc_tbl<<15)+(cc_vhighfs<<18)+(cc_vhighchm<<19)+(cc_tpfd<<20)+(cc_intpol<<28);
     if (micro_step_code != 255) {
       data_out = last_chop_config + (((uint32_t)micro_step_code)<<24);
-      write(REG_CHOPCONF, data_out);
-      softSpi.pause();
+      if (last_CHOPCONF != data_out) {
+        last_CHOPCONF = data_out;
+        write(REG_CHOPCONF, data_out);
+        softSpi.pause();
+      }
     }
 
     // GCONF
@@ -154,7 +157,11 @@ bool TmcSPI::refresh_CHOPCONF(byte micro_step_code) {
     // default=0x10410150UL
     if (model == TMC5160) last_chop_config = (cc_toff<<0)+(cc_hstart<<4)+(cc_hend<<7)+(cc_tbl<<15)+(cc_vhighfs<<18)+(cc_vhighchm<<19)+(cc_tpfd<<20)+(cc_intpol<<28);
 
-    write(REG_CHOPCONF, last_chop_config + (((uint32_t)micro_step_code)<<24));
+    uint32_t data_out = last_chop_config + (((uint32_t)micro_step_code)<<24);
+    if (last_CHOPCONF != data_out) {
+      last_CHOPCONF = data_out;
+      write(REG_CHOPCONF, data_out);
+    }
     softSpi.end();
     return true;
   } else
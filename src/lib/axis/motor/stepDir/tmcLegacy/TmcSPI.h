@@ -29,6 +29,11 @@ class TmcSPI {
     // irun, ihold, rsense:  current in mA and sense resistor value
     bool mode(bool intpol, int decay_mode, byte micro_step_code, int irun, int ihold);
 
+    // forget the last register values written so the next mode() rewrites them all
+    inline void invalidate() {
+      last_GCONF = last_IHOLD_IRUN = last_TPOWERDOWN = last_TPWMTHRS = last_THIGH = last_PWMCONF = last_CHOPCONF = 0xFFFFFFFFUL;
+    }
+
     // Check for TMC error from DRVSTATUS register
     bool error();
     int refresh_DRVSTATUS();
@@ -119,6 +124,7 @@ class TmcSPI {
     uint32_t last_TPWMTHRS    = 0;
     uint32_t last_THIGH       = 0;
     uint32_t last_PWMCONF     = 0;
+    uint32_t last_CHOPCONF    = 0;
 
     // CHOPCONF settings
     uint32_t cc_toff          = 4;    // default=4,   range 2 to 15 (Off time setting, slow decay phase)
@@ -44,6 +44,9 @@ void StepDirTmcSPI::init(float param1, float param2, float param3, float param4,
     VF("Irun="); V(settings.currentRun); VF("mA, ");
     VF("Igoto="); V(settings.currentGoto); VL("mA");
   }
+  if (settings.currentTrack != OFF) {
+    VF("MSG: StepDirDriver"); V(axisNumber); VF(", TMC tracking Itrack="); V(settings.currentTrack); VL("mA");
+  }
 
   if (settings.model == TMC2130) {
     rSense = 0.11F;
@@ -52,9 +55,9 @@ void StepDirTmcSPI::init(float param1, float param2, float param3, float param4,
     ((TMC2130Stepper*)driver)->pwm_autoscale(true);
     ((TMC2130Stepper*)driver)->intpol(settings.intpol);
     modeMicrostepTracking();
-    driver->irun(mAToCs(settings.currentRun));
-    driver->ihold(mAToCs(settings.currentHold));
-    ((TMC2130Stepper*)driver)->en_pwm_mode(false);
+    setIrun(mAToCs(settings.currentRun));
+    setIhold(mAToCs(settings.currentHold));
+    setDecayMode(SPREADCYCLE);
   } else
   if (settings.model == TMC5160) {
     rSense = 0.075F;
@@ -63,9 +66,9 @@ void StepDirTmcSPI::init(float param1, float param2, float param3, float param4,
     ((TMC5160Stepper*)driver)->pwm_autoscale(true);
     ((TMC5160Stepper*)driver)->intpol(settings.intpol);
     modeMicrostepTracking();
-    driver->irun(mAToCs(settings.currentRun));
-    driver->ihold(mAToCs(settings.currentHold));
-    ((TMC5160Stepper*)driver)->en_pwm_mode(false);
+    setIrun(mAToCs(settings.currentRun));
+    setIhold(mAToCs(settings.currentHold));
+    setDecayMode(SPREADCYCLE);
   } else
   if (settings.model == TMC5161) {
     rSense = 0.075F;
@@ -74,13 +77,24 @@ void StepDirTmcSPI::init(float param1, float param2, float param3, float param4,
     ((TMC5161Stepper*)driver)->pwm_autoscale(true);
     ((TMC5161Stepper*)driver)->intpol(settings.intpol);
     modeMicrostepTracking();
-    driver->irun(mAToCs(settings.currentRun));
-    driver->ihold(mAToCs(settings.currentHold));
-    ((TMC5161Stepper*)driver)->en_pwm_mode(false);
+    setIrun(mAToCs(settings.currentRun));
+    setIhold(mAToCs(settings.currentHold));
+    setDecayMode(SPREADCYCLE);
   }
 
   // automatically set fault status for known drivers
   status.active = settings.status != OFF;
+  if (settings.status == ON) statusPollRegister();
+
+  // StallGuard2 threshold, TCOOLTHRS at max so the stall flag is valid at any speed (spreadCycle only)
+  if (settings.stall != OFF) {
+    if (settings.stall < -64) settings.stall = -64;
+    if (settings.stall > 63) settings.stall = 63;
+    VF("MSG: StepDirDriver"); V(axisNumber); VF(", TMC StallGuard threshold SGT="); VL(settings.stall);
+    if (settings.model == TMC2130) { ((TMC2130Stepper*)driver)->sgt(settings.stall); ((TMC2130Stepper*)driver)->TCOOLTHRS(0xFFFFF); } else
+    if (settings.model == TMC5160) { ((TMC5160Stepper*)driver)->sgt(settings.stall); ((TMC5160Stepper*)driver)->TCOOLTHRS(0xFFFFF); } else
+    if (settings.model == TMC5161) { ((TMC5161Stepper*)driver)->sgt(settings.stall); ((TMC5161Stepper*)driver)->TCOOLTHRS(0xFFFFF); }
+  }
 
   // set fault pin mode
   if (settings.status == LOW) pinModeEx(Pins->fault, INPUT_PULLUP);
@@ -94,6 +108,13 @@ void StepDirTmcSPI::init(float param1, float param2, float param3, float param4,
   // use low speed mode switch for TMC drivers or high speed otherwise
   modeSwitchAllowed = microstepRatio != 1;
   modeSwitchFastAllowed = false;
+
+  // the high speed band only changes the chopper mode and current so it can switch without a pause
+  if (settings.currentFast == OFF) settings.currentFast = settings.currentGoto;
+  modeFastAllowed = settings.rateFast != OFF;
+  if (modeFastAllowed) {
+    VF("MSG: StepDirDriver"); V(axisNumber); VF(", TMC above "); V(settings.rateFast); VF(" steps/s Ifast="); V(settings.currentFast); VL("mA");
+  }
 }
 
 // validate driver parameters
@@ -133,53 +154,54 @@ bool StepDirTmcSPI::validateParameters(float param1, float param2, float param3,
 }
 
 void StepDirTmcSPI::modeMicrostepTracking() {
-  if (settings.microsteps == 1) driver->microsteps(0); else driver->microsteps(settings.microsteps);
+  setMicrosteps(settings.microsteps);
 }
 
 int StepDirTmcSPI::modeMicrostepSlewing() {
   if (microstepRatio > 1) {
-    if (settings.microstepsSlewing == 1) driver->microsteps(0); else driver->microsteps(settings.microstepsSlewing);
+    setMicrosteps(settings.microstepsSlewing);
   }
   return microstepRatio;
 }
 
 void StepDirTmcSPI::modeDecayTracking() {
   setDecayMode(settings.decay);
-  driver->irun(mAToCs(settings.currentRun));
-  driver->ihold(mAToCs(settings.currentHold));
+  setIrun(mAToCs(currentTracking()));
+  setIhold(mAToCs(settings.currentHold));
 }
 
 void StepDirTmcSPI::modeDecaySlewing() {
   setDecayMode(settings.decaySlewing);
   int IGOTO = settings.currentGoto;
   if (IGOTO == OFF) IGOTO = settings.currentRun;
-  driver->irun(mAToCs(IGOTO));
-  driver->ihold(mAToCs(settings.currentHold));
+  setIrun(mAToCs(IGOTO));
+  setIhold(mAToCs(settings.currentHold));
 }
 
+// read status registers from the driver, DRV_STATUS also carries SG_RESULT and CS_ACTUAL
+void StepDirTmcSPI::readStatus() {
+  TMC2130_n::DRV_STATUS_t status_result;
+  if (settings.model == TMC2130) { status_result.sr = ((TMC2130Stepper*)driver)->DRV_STATUS(); } else
+  if (settings.model == TMC5160) { status_result.sr = ((TMC5160Stepper*)driver)->DRV_STATUS(); } else
+  if (settings.model == TMC5161) { status_result.sr = ((TMC5161Stepper*)driver)->DRV_STATUS(); } else return;
+  status.outputA.shortToGround = status_result.s2ga;
+  status.outputA.openLoad      = status_result.ola;
+  status.outputB.shortToGround = status_result.s2gb;
+  status.outputB.openLoad      = status_result.olb;
+  status.overTemperatureWarning= status_result.otpw;
+  status.overTemperature       = status_result.ot;
+  status.standstill            = status_result.stst;
+  status.sgResult              = status_result.sg_result;
+  status.csActual              = status_result.cs_actual;
+  status.stalled               = settings.stall != OFF && status_result.stallGuard;
+
+  // open load indication is not reliable in standstill
+  if (status.outputA.shortToGround || status.outputB.shortToGround ||
+      status.overTemperatureWarning || status.overTemperature) status.fault = true; else status.fault = false;
+}
+
+// the TMC registers are read by the shared status poll, this only handles the fault pin
 void StepDirTmcSPI::updateStatus() {
-  if (settings.status == ON) {
-    if ((long)(millis() - timeLastStatusUpdate) > 200) {
-      uint32_t status_word;
-      TMC2130_n::DRV_STATUS_t status_result;
-      if (settings.model == TMC2130) { status_result.sr = ((TMC2130Stepper*)driver)->DRV_STATUS(); } else
-      if (settings.model == TMC5160) { status_result.sr = ((TMC5160Stepper*)driver)->DRV_STATUS(); } else
-      if (settings.model == TMC5161) { status_result.sr = ((TMC5161Stepper*)driver)->DRV_STATUS(); }
-      status.outputA.shortToGround = status_result.s2ga;
-      status.outputA.openLoad      = status_result.ola;
-      status.outputB.shortToGround = status_result.s2gb;
-      status.outputB.openLoad      = status_result.olb;
-      status.overTemperatureWarning= status_result.otpw;
-      status.overTemperature       = status_result.ot;
-      status.standstill            = status_result.stst;
-
-      // open load indication is not reliable in standstill
-      if (status.outputA.shortToGround || status.outputB.shortToGround ||
-          status.overTemperatureWarning || status.overTemperature) status.fault = true; else status.fault = false;
-
-      timeLastStatusUpdate = millis();
-    }
-  } else
   if (settings.status == LOW || settings.status == HIGH) {
     status.fault = digitalReadEx(Pins->fault) == settings.status;
   }
@@ -193,17 +215,19 @@ bool StepDirTmcSPI::enable(bool state) {
     modeDecayTracking();
   } else {
     setDecayMode(STEALTHCHOP);
-    driver->ihold(0);
+    setIhold(0);
   }
   return true;
 }
 
 // calibrate the motor driver if required
-void StepDirTmcSPI::calibrateDriver() {
+bool StepDirTmcSPI::calibrateDriverStart() {
   if (settings.decay == STEALTHCHOP || settings.decaySlewing == STEALTHCHOP) {
     VF("MSG: StepDirDriver"); V(axisNumber); VL(", TMC standstill automatic current calibration");
-    driver->irun(mAToCs(settings.currentRun));
-    driver->ihold(mAToCs(settings.currentRun));
+    // the driver may have lost power, forget the cached register values so everything is rewritten
+    lastMicrosteps = -1; lastIrun = -1; lastIhold = -1; lastSpreadCycle = -1;
+    setIrun(mAToCs(settings.currentRun));
+    setIhold(mAToCs(settings.currentRun));
     if (settings.model == TMC2130) {
       ((TMC2130Stepper*)driver)->pwm_autograd(DRIVER_TMC_STEPPER_AUTOGRAD);
       ((TMC2130Stepper*)driver)->pwm_autoscale(true);
@@ -219,16 +243,52 @@ void StepDirTmcSPI::calibrateDriver() {
       ((TMC5161Stepper*)driver)->pwm_autoscale(true);
       ((TMC5161Stepper*)driver)->en_pwm_mode(true);
     }
-    delay(1000);
-    modeDecayTracking();
+    return true;
   }
+  return false;
+}
+
+void StepDirTmcSPI::calibrateDriverFinish() {
+  if (settings.decay == STEALTHCHOP || settings.decaySlewing == STEALTHCHOP) modeDecayTracking();
+}
+
+void StepDirTmcSPI::modeDecayFast() {
+  setDecayMode(settings.decayFast);
+  setIrun(mAToCs(settings.currentFast));
+  setIhold(mAToCs(settings.currentHold));
 }
 
 // set the decay mode STEALTHCHOP or SPREADCYCLE
 void StepDirTmcSPI::setDecayMode(int decayMode) {
-  if (settings.model == TMC2130) { ((TMC2130Stepper*)driver)->en_pwm_mode(decayMode != SPREADCYCLE); } else
-  if (settings.model == TMC5160) { ((TMC5160Stepper*)driver)->en_pwm_mode(decayMode != SPREADCYCLE); } else
-  if (settings.model == TMC5161) { ((TMC5161Stepper*)driver)->en_pwm_mode(decayMode != SPREADCYCLE); }
+  int8_t spreadCycle = decayMode == SPREADCYCLE;
+  if (spreadCycle == lastSpreadCycle) return;
+  lastSpreadCycle = spreadCycle;
+
+  if (settings.model == TMC2130) { ((TMC2130Stepper*)driver)->en_pwm_mode(!spreadCycle); } else
+  if (settings.model == TMC5160) { ((TMC5160Stepper*)driver)->en_pwm_mode(!spreadCycle); } else
+  if (settings.model == TMC5161) { ((TMC5161Stepper*)driver)->en_pwm_mode(!spreadCycle); }
+}
+
+// set the microstep mode, CHOPCONF is only written if the mode changes
+void StepDirTmcSPI::setMicrosteps(int microsteps) {
+  if (microsteps == 1) microsteps = 0;
+  if (microsteps == lastMicrosteps) return;
+  lastMicrosteps = microsteps;
+  driver->microsteps(microsteps);
+}
+
+// set the run current scale, IHOLD_IRUN is only written if the value changes
+void StepDirTmcSPI::setIrun(uint8_t cs) {
+  if (cs == lastIrun) return;
+  lastIrun = cs;
+  driver->irun(cs);
+}
+
+// set the hold current scale, IHOLD_IRUN is only written if the value changes
+void StepDirTmcSPI::setIhold(uint8_t cs) {
+  if (cs == lastIhold) return;
+  lastIhold = cs;
+  driver->ihold(cs);
 }
 
 #endif
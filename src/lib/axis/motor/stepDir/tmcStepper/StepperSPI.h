@@ -42,6 +42,12 @@ class StepDirTmcSPI : public StepDirDriver {
     // set decay mode for slewing
     void modeDecaySlewing();
 
+    // set decay mode and current for slewing above the fast rate
+    void modeDecayFast();
+
+    // read status registers from the driver hardware
+    void readStatus();
+
     // update status info. for driver
     void updateStatus();
 
@@ -49,7 +55,8 @@ class StepDirTmcSPI : public StepDirDriver {
     bool enable(bool state);
 
     // calibrate the motor driver if required
-    void calibrateDriver();
+    bool calibrateDriverStart();
+    void calibrateDriverFinish();
 
     TMCStepper *driver;
 
@@ -59,6 +66,17 @@ class StepDirTmcSPI : public StepDirDriver {
 
     // set the decay mode STEALTH_CHOP or SPREAD_CYCLE
     void setDecayMode(int decayMode);
+
+    // write the microstep mode and current scales only when they change
+    void setMicrosteps(int microsteps);
+    void setIrun(uint8_t cs);
+    void setIhold(uint8_t cs);
+
+    // last values written to the driver registers, -1 when unknown
+    int16_t lastMicrosteps = -1;
+    int16_t lastIrun = -1;
+    int16_t lastIhold = -1;
+    int8_t lastSpreadCycle = -1;
 };
 
 #endif
@@ -50,6 +50,9 @@ void StepDirTmcUART::init(float param1, float param2, float param3, float param4
     VF("Irun="); V(settings.currentRun); VF("mA, ");
     VF("Igoto="); V(settings.currentGoto); VL("mA");
   }
+  if (settings.currentTrack != OFF) {
+    VF("MSG: StepDirDriver"); V(axisNumber); VF(", TMC tracking Itrack="); V(settings.currentTrack); VL("mA");
+  }
 
   // get TMC UART driver ready
   pinModeEx(Pins->m0, OUTPUT);
@@ -97,9 +100,9 @@ void StepDirTmcUART::init(float param1, float param2, float param3, float param4
     ((TMC2208Stepper*)driver)->begin();
     ((TMC2208Stepper*)driver)->intpol(settings.intpol);
     modeMicrostepTracking();
-    driver->irun(mAToCs(settings.currentRun));
-    driver->ihold(mAToCs(settings.currentHold));
-    ((TMC2208Stepper*)driver)->en_spreadCycle(true);
+    setIrun(mAToCs(settings.currentRun));
+    setIhold(mAToCs(settings.currentHold));
+    setDecayMode(SPREADCYCLE);
   } else
   if (settings.model == TMC2209) { // also handles TMC2226
     rSense = 0.11F;
@@ -107,13 +110,28 @@ void StepDirTmcUART::init(float param1, float param2, float param3, float param4
     ((TMC2209Stepper*)driver)->begin();
     ((TMC2209Stepper*)driver)->intpol(settings.intpol);
     modeMicrostepTracking();
-    driver->irun(mAToCs(settings.currentRun));
-    driver->ihold(mAToCs(settings.currentHold));
-    ((TMC2209Stepper*)driver)->en_spreadCycle(true);
+    setIrun(mAToCs(settings.currentRun));
+    setIhold(mAToCs(settings.currentHold));
+    setDecayMode(SPREADCYCLE);
   }
 
   // automatically set fault status for known drivers
   status.active = settings.status != OFF;
+  if (settings.status == ON) statusPollRegister();
+
+  // StallGuard4 threshold, a stall is SG_RESULT <= 2*SGTHRS (TMC2209 only)
+  if (settings.stall != OFF) {
+    if (settings.model == TMC2209) {
+      if (settings.stall < 0) settings.stall = 0;
+      if (settings.stall > 255) settings.stall = 255;
+      VF("MSG: StepDirDriver"); V(axisNumber); VF(", TMC StallGuard threshold SGTHRS="); VL(settings.stall);
+      ((TMC2209Stepper*)driver)->SGTHRS(settings.stall);
+      ((TMC2209Stepper*)driver)->TCOOLTHRS(0xFFFFF);
+    } else {
+      VF("WRN: StepDirDriver"); V(axisNumber); VLF(", TMC StallGuard not supported by this driver model");
+      settings.stall = OFF;
+    }
+  }
 
   // set fault pin mode
   if (settings.status == LOW) pinModeEx(Pins->fault, INPUT_PULLUP);
@@ -127,6 +145,13 @@ void StepDirTmcUART::init(float param1, float param2, float param3, float param4
   // use low speed mode switch for TMC drivers or high speed otherwise
   modeSwitchAllowed = microstepRatio != 1;
   modeSwitchFastAllowed = false;
+
+  // the high speed band only changes the chopper mode and current so it can switch without a pause
+  if (settings.currentFast == OFF) settings.currentFast = settings.currentGoto;
+  modeFastAllowed = settings.rateFast != OFF;
+  if (modeFastAllowed) {
+    VF("MSG: StepDirDriver"); V(axisNumber); VF(", TMC above "); V(settings.rateFast); VF(" steps/s Ifast="); V(settings.currentFast); VL("mA");
+  }
 }
 
 // validate driver parameters
@@ -165,68 +190,86 @@ bool StepDirTmcUART::validateParameters(float param1, float param2, float param3
 }
 
 void StepDirTmcUART::modeMicrostepTracking() {
-  if (settings.microsteps == 1) driver->microsteps(0); else driver->microsteps(settings.microsteps);
+  setMicrosteps(settings.microsteps);
 }
 
 int StepDirTmcUART::modeMicrostepSlewing() {
   if (microstepRatio > 1) {
-    if (settings.microstepsSlewing == 1) driver->microsteps(0); else driver->microsteps(settings.microstepsSlewing);
+    setMicrosteps(settings.microstepsSlewing);
   }
   return microstepRatio;
 }
 
 void StepDirTmcUART::modeDecayTracking() {
   setDecayMode(settings.decay);
-  driver->irun(mAToCs(settings.currentRun));
-  driver->ihold(mAToCs(settings.currentHold));
+  setIrun(mAToCs(currentTracking()));
+  setIhold(mAToCs(settings.currentHold));
 }
 
 void StepDirTmcUART::modeDecaySlewing() {
   setDecayMode(settings.decaySlewing);
   int IGOTO = settings.currentGoto;
   if (IGOTO == OFF) IGOTO = settings.currentRun;
-  driver->irun(mAToCs(IGOTO));
-  driver->ihold(mAToCs(settings.currentHold));
+  setIrun(mAToCs(IGOTO));
+  setIhold(mAToCs(settings.currentHold));
+}
+
+void StepDirTmcUART::modeDecayFast() {
+  setDecayMode(settings.decayFast);
+  setIrun(mAToCs(settings.currentFast));
+  setIhold(mAToCs(settings.currentHold));
 }
 
 // set the decay mode STEALTHCHOP or SPREADCYCLE
 void StepDirTmcUART::setDecayMode(int decayMode) {
+  int8_t spreadCycle = decayMode == SPREADCYCLE;
+  if (spreadCycle == lastSpreadCycle) return;
+  lastSpreadCycle = spreadCycle;
+
   if (settings.model == TMC2208) {
-    ((TMC2208Stepper*)driver)->en_spreadCycle(decayMode == SPREADCYCLE);
+    ((TMC2208Stepper*)driver)->en_spreadCycle(spreadCycle);
   } else
   if (settings.model == TMC2209) {
-    ((TMC2209Stepper*)driver)->en_spreadCycle(decayMode == SPREADCYCLE);
+    ((TMC2209Stepper*)driver)->en_spreadCycle(spreadCycle);
   }
 }
 
-void StepDirTmcUART::updateStatus() {
-  if (settings.status == ON) {
-    if ((long)(millis() - timeLastStatusUpdate) > 200) {
-
-      TMC2208_n::DRV_STATUS_t status_result;
-      if (settings.model == TMC2208) {
-        status_result.sr = ((TMC2208Stepper*)driver)->DRV_STATUS();
-      } else
-      if (settings.model == TMC2209) {
-        status_result.sr = ((TMC2209Stepper*)driver)->DRV_STATUS();
-      }
-      status.outputA.shortToGround = status_result.s2ga;
-      status.outputA.openLoad      = status_result.ola;
-      status.outputB.shortToGround = status_result.s2gb;
-      status.outputB.openLoad      = status_result.olb;
-      status.overTemperatureWarning = status_result.otpw;
-      status.overTemperature       = status_result.ot;
-      status.standstill            = status_result.stst;
-
-      // open load indication is not reliable in standstill
-      if (status.outputA.shortToGround ||
-          status.outputB.shortToGround ||
-          status.overTemperatureWarning ||
-          status.overTemperature) status.fault = true; else status.fault = false;
-
-      timeLastStatusUpdate = millis();
-    }
+// read status registers from the driver, one register per call
+// the TMC2209 keeps SG_RESULT in its own register so it's read on alternate calls
+void StepDirTmcUART::readStatus() {
+  if (settings.model == TMC2209 && readStallGuardNext) {
+    status.sgResult = ((TMC2209Stepper*)driver)->SG_RESULT();
+    status.stalled = settings.stall != OFF && !status.standstill && status.sgResult <= 2*settings.stall;
+    readStallGuardNext = false;
+    return;
+  }
+
+  TMC2208_n::DRV_STATUS_t status_result;
+  if (settings.model == TMC2208) {
+    status_result.sr = ((TMC2208Stepper*)driver)->DRV_STATUS();
   } else
+  if (settings.model == TMC2209) {
+    status_result.sr = ((TMC2209Stepper*)driver)->DRV_STATUS();
+    readStallGuardNext = true;
+  } else return;
+  status.outputA.shortToGround = status_result.s2ga;
+  status.outputA.openLoad      = status_result.ola;
+  status.outputB.shortToGround = status_result.s2gb;
+  status.outputB.openLoad      = status_result.olb;
+  status.overTemperatureWarning = status_result.otpw;
+  status.overTemperature       = status_result.ot;
+  status.standstill            = status_result.stst;
+  status.csActual              = status_result.cs_actual;
+
+  // open load indication is not reliable in standstill
+  if (status.outputA.shortToGround ||
+      status.outputB.shortToGround ||
+      status.overTemperatureWarning ||
+      status.overTemperature) status.fault = true; else status.fault = false;
+}
+
+// the TMC registers are read by the shared status poll, this only handles the fault pin
+void StepDirTmcUART::updateStatus() {
   if (settings.status == LOW || settings.status == HIGH) {
     status.fault = digitalReadEx(Pins->fault) == settings.status;
   }
@@ -240,17 +283,19 @@ bool StepDirTmcUART::enable(bool state) {
     modeDecayTracking();
   } else {
     setDecayMode(STEALTHCHOP);
-    driver->ihold(0);
+    setIhold(0);
   }
   return true;
 }
 
 // calibrate the motor driver if required
-void StepDirTmcUART::calibrateDriver() {
+bool StepDirTmcUART::calibrateDriverStart() {
   if (settings.decay == STEALTHCHOP || settings.decaySlewing == STEALTHCHOP) {
     VF("MSG: StepDirDriver Axis"); V(axisNumber); VL(", TMC standstill automatic current calibration");
-    driver->irun(mAToCs(settings.currentRun));
-    driver->ihold(mAToCs(settings.currentRun));
+    // the driver may have lost power, forget the cached register values so everything is rewritten
+    lastMicrosteps = -1; lastIrun = -1; lastIhold = -1; lastSpreadCycle = -1;
+    setIrun(mAToCs(settings.currentRun));
+    setIhold(mAToCs(settings.currentRun));
     if (settings.model == TMC2208) {
       ((TMC2208Stepper*)driver)->pwm_autograd(DRIVER_TMC_STEPPER_AUTOGRAD);
       ((TMC2208Stepper*)driver)->pwm_autoscale(true);
@@ -261,9 +306,35 @@ void StepDirTmcUART::calibrateDriver() {
       ((TMC2209Stepper*)driver)->pwm_autoscale(true);
       ((TMC2209Stepper*)driver)->en_spreadCycle(false);
     }
-    delay(1000);
-    modeDecayTracking();
+    return true;
   }
+  return false;
+}
+
+void StepDirTmcUART::calibrateDriverFinish() {
+  if (settings.decay == STEALTHCHOP || settings.decaySlewing == STEALTHCHOP) modeDecayTracking();
+}
+
+// set the microstep mode, CHOPCONF is only written if the mode changes
+void StepDirTmcUART::setMicrosteps(int microsteps) {
+  if (microsteps == 1) microsteps = 0;
+  if (microsteps == lastMicrosteps) return;
+  lastMicrosteps = microsteps;
+  driver->microsteps(microsteps);
+}
+
+// set the run current scale, IHOLD_IRUN is only written if the value changes
+void StepDirTmcUART::setIrun(uint8_t cs) {
+  if (cs == lastIrun) return;
+  lastIrun = cs;
+  driver->irun(cs);
+}
+
+// set the hold current scale, IHOLD_IRUN is only written if the value changes
+void StepDirTmcUART::setIhold(uint8_t cs) {
+  if (cs == lastIhold) return;
+  lastIhold = cs;
+  driver->ihold(cs);
 }
 
 #endif
@@ -57,9 +57,15 @@ class StepDirTmcUART : public StepDirDriver {
     // set decay mode for slewing
     void modeDecaySlewing();
 
+    // set decay mode and current for slewing above the fast rate
+    void modeDecayFast();
+
     // set the decay mode STEALTH_CHOP or SPREAD_CYCLE
     void setDecayMode(int decayMode);
 
+    // read status registers from the driver hardware
+    void readStatus();
+
     // update status info. for driver
     void updateStatus();
 
@@ -67,7 +73,8 @@ class StepDirTmcUART : public StepDirDriver {
     bool enable(bool state);
 
     // calibrate the motor driver if required
-    void calibrateDriver();
+    bool calibrateDriverStart();
+    void calibrateDriverFinish();
 
   private:
     #if SERIAL_TMC == SoftSerial
@@ -76,9 +83,22 @@ class StepDirTmcUART : public StepDirDriver {
 
     TMCStepper *driver;
 
+    // alternate DRV_STATUS and SG_RESULT reads on the TMC2209
+    bool readStallGuardNext = false;
+
     // checks if decay pin should be HIGH/LOW for a given decay setting
     int8_t getDecayPinState(int8_t decay);
 
+    // write the microstep mode and current scales only when they change
+    void setMicrosteps(int microsteps);
+    void setIrun(uint8_t cs);
+    void setIhold(uint8_t cs);
+
+    // last values written to the driver registers, -1 when unknown
+    int16_t lastMicrosteps = -1;
+    int16_t lastIrun = -1;
+    int16_t lastIhold = -1;
+    int8_t lastSpreadCycle = -1;
 };
 
 #endif
@@ -0,0 +1,359 @@
+// -----------------------------------------------------------------------------------
+// axis TMC5160 motion controller motor, the driver's internal ramp generator moves the motor
+
+// note: requires MOSI, SCK, CS, and MISO, with the driver's SD_MODE pin tied low
+
+#include "TmcRamp.h"
+
+#ifdef TMC_RAMP_MOTOR_PRESENT
+
+// help with pin names
+#define mosi m0
+#define sck  m1
+#define cs   m2
+#define miso m3
+
+#define TMC_RAMP_VMAX_LIMIT 8388096UL // largest VMAX
+#define TMC_RAMP_AMAX_LIMIT 65535UL   // largest AMAX, DMAX, A1, and D1
+
+// constructor
+TmcRampMotor::TmcRampMotor(uint8_t axisNumber, const TmcRampPins *Pins, const TmcRampSettings *Settings) {
+  if (axisNumber < 1 || axisNumber > 2) return;
+
+  driverType = TMC_RAMP;
+  strcpy(axisPrefix, "MSG: TmcRamp_, ");
+  axisPrefix[12] = '0' + axisNumber;
+  this->axisNumber = axisNumber;
+  this->Pins = Pins;
+
+  settings = *Settings;
+  setDefaultParameters(settings.microsteps, OFF, settings.currentHold, settings.currentRun, settings.currentGoto, 0);
+}
+
+bool TmcRampMotor::init() {
+  if (axisNumber < 1 || axisNumber > 2) return false;
+
+  if (Pins->enable != OFF && Pins->enable != SHARED) {
+    pinModeEx(Pins->enable, OUTPUT);
+    digitalWriteEx(Pins->enable, !Pins->enabledState);
+  }
+
+  V(axisPrefix); VLF("ramp generator in positioning mode");
+  driver = new TMC5160Stepper(Pins->cs, Pins->mosi, Pins->miso, Pins->sck);
+  driver->begin();
+  driver->pwm_autoscale(true);
+  driver->intpol(true);
+
+  // a trapezoid from standstill, V1 = 0 leaves out the A1/D1 phases but D1 must never be 0 in positioning mode
+  driver->RAMPMODE(0);
+  driver->XACTUAL(0);
+  driver->XTARGET(0);
+  driver->VSTART(0);
+  driver->V1(0);
+  driver->VSTOP(10);
+  driver->VMAX(0);
+  driver->A1(1);
+  driver->D1(1);
+  driver->AMAX(1);
+  driver->DMAX(1);
+  lastXtarget = 0;
+  lastVmax = 0;
+  lastAmax = 1;
+
+  // automatically set fault status for known drivers
+  status.active = settings.status != OFF;
+
+  // set fault pin mode
+  if (settings.status == LOW) pinModeEx(Pins->fault, INPUT_PULLUP);
+  #ifdef PULLDOWN
+    if (settings.status == HIGH) pinModeEx(Pins->fault, INPUT_PULLDOWN);
+  #else
+    if (settings.status == HIGH) pinModeEx(Pins->fault, INPUT);
+  #endif
+
+  lastPollTime = micros();
+
+  return true;
+}
+
+// set driver reverse state
+void TmcRampMotor::setReverse(int8_t state) {
+  if (driver != NULL) driver->shaft(state == ON);
+}
+
+// sets driver parameters: microsteps, unused, hold current, run current, goto current, unused
+void TmcRampMotor::setParameters(float param1, float param2, float param3, float param4, float param5, float param6) {
+  UNUSED(param2);
+  UNUSED(param6);
+  settings.microsteps = lround(param1);
+  settings.currentHold = lround(param3);
+  settings.currentRun = lround(param4);
+  settings.currentGoto = lround(param5);
+
+  if (settings.currentRun != OFF) {
+    // automatically set goto and hold current if they are disabled
+    if (settings.currentGoto == OFF) settings.currentGoto = settings.currentRun;
+    if (settings.currentHold == OFF) settings.currentHold = lround(settings.currentRun/2.0F);
+  } else {
+    settings.currentRun = 600;
+    settings.currentGoto = settings.currentRun;
+    settings.currentHold = lround(settings.currentRun/2.0F);
+  }
+  if (settings.decay == OFF) settings.decay = STEALTHCHOP;
+  if (settings.decaySlewing == OFF) settings.decaySlewing = SPREADCYCLE;
+
+  V(axisPrefix); VF("Ihold="); V(settings.currentHold); VF("mA, ");
+  VF("Irun="); V(settings.currentRun); VF("mA, ");
+  VF("Igoto="); V(settings.currentGoto); VL("mA");
+
+  // the ramp generator counts in microsteps so the mode stays put, even for slews
+  V(axisPrefix); VF("u-step mode ");
+  if (settings.microsteps == OFF) { VLF("OFF (assuming 1X)"); settings.microsteps = 1; } else { V(settings.microsteps); VLF("X"); }
+  if (settings.microsteps == 1) driver->microsteps(0); else driver->microsteps(settings.microsteps);
+
+  setMode(slewing);
+}
+
+// validate driver parameters
+bool TmcRampMotor::validateParameters(float param1, float param2, float param3, float param4, float param5, float param6) {
+  UNUSED(param2);
+  UNUSED(param6);
+
+  long microsteps = lround(param1);
+  if (microsteps != OFF && (microsteps < 1 || microsteps > 256)) {
+    DF("ERR: TmcRampMotor::validateParameters(), Axis"); D(axisNumber); DF(" bad microsteps="); DL(microsteps);
+    return false;
+  }
+
+  long current[3] = { lround(param3), lround(param4), lround(param5) };
+  for (int i = 0; i < 3; i++) {
+    if (current[i] != OFF && (current[i] < 0 || current[i] > 3000)) {
+      DF("ERR: TmcRampMotor::validateParameters(), Axis"); D(axisNumber); DF(" bad current="); DL(current[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// sets motor enable on/off (if possible)
+void TmcRampMotor::enable(bool state) {
+  V(axisPrefix); VF("driver powered ");
+  if (state) { VF("up"); } else { VF("down"); }
+
+  if (Pins->enable != OFF && Pins->enable != SHARED) {
+    VF(" using pin "); VL(Pins->enable);
+    digitalWriteEx(Pins->enable, state ? Pins->enabledState : !Pins->enabledState);
+  } else {
+    VLF(" using SPI");
+    if (state) setMode(slewing); else {
+      driver->en_pwm_mode(true);
+      driver->ihold(0);
+    }
+  }
+
+  if (!state) gotoActive = false;
+  enabled = state;
+}
+
+// get the associated driver status
+DriverStatus TmcRampMotor::getDriverStatus() {
+  if (settings.status == ON) {
+    if ((long)(millis() - timeLastStatusUpdate) > 200) {
+      TMC2130_n::DRV_STATUS_t status_result;
+      status_result.sr = driver->DRV_STATUS();
+      status.outputA.shortToGround = status_result.s2ga;
+      status.outputA.openLoad      = status_result.ola;
+      status.outputB.shortToGround = status_result.s2gb;
+      status.outputB.openLoad      = status_result.olb;
+      status.overTemperatureWarning= status_result.otpw;
+      status.overTemperature       = status_result.ot;
+      status.standstill            = status_result.stst;
+
+      // open load indication is not reliable in standstill
+      if (status.outputA.shortToGround || status.outputB.shortToGround ||
+          status.overTemperatureWarning || status.overTemperature) status.fault = true; else status.fault = false;
+
+      timeLastStatusUpdate = millis();
+    }
+  } else
+  if (settings.status == LOW || settings.status == HIGH) {
+    status.fault = digitalReadEx(Pins->fault) == settings.status;
+  }
+
+  return status;
+}
+
+// resets motor and target angular position in steps, also zeros backlash and index
+void TmcRampMotor::resetPositionSteps(long value) {
+  Motor::resetPositionSteps(value);
+  if (driver == NULL) return;
+
+  // hold mode while XACTUAL and XTARGET are changed so there's no move between the writes
+  driver->RAMPMODE(3);
+  driver->XACTUAL(value);
+  driver->XTARGET(value);
+  driver->RAMPMODE(0);
+  lastXtarget = value;
+  targetFraction = 0.0F;
+}
+
+// get movement frequency in steps per second
+float TmcRampMotor::getFrequencySteps() {
+  if (gotoActive) return fabs(velocity);
+  return fabs(frequency);
+}
+
+// set frequency (+/-) in steps per second negative frequencies move reverse in direction (0 stops motion)
+void TmcRampMotor::setFrequencySteps(float frequency) {
+  this->frequency = frequency;
+}
+
+// set synchronized state (automatic movement of target at setFrequencySteps() rate)
+void TmcRampMotor::setSynchronized(bool state) {
+  if (state) {
+    // any autoGoto is over, rate moves carry on from where the motor is now
+    gotoActive = false;
+    if (driver != NULL) readPosition();
+    targetFraction = 0.0F;
+  }
+  Motor::setSynchronized(state);
+}
+
+// set the slew and emergency stop acceleration in steps per second per second
+void TmcRampMotor::setAccelerationSteps(float acceleration, float accelerationAbort) {
+  this->acceleration = acceleration;
+  this->accelerationAbort = accelerationAbort;
+}
+
+// the ramp generator takes the autoGoto to the target
+bool TmcRampMotor::autoGoto(float frequency) {
+  gotoFrequency = fabs(frequency);
+  gotoActive = true;
+  V(axisPrefix); VLF("autoGoto handed to the ramp generator");
+  return true;
+}
+
+// set slewing state (hint that we are about to slew or are done slewing)
+void TmcRampMotor::setSlewing(bool state) {
+  slewing = state;
+  if (enabled) setMode(slewing);
+}
+
+// calibrate the motor driver if required
+bool TmcRampMotor::calibrateDriverStart() {
+  if (settings.decay != STEALTHCHOP && settings.decaySlewing != STEALTHCHOP) return false;
+
+  V(axisPrefix); VLF("TMC standstill automatic current calibration");
+  if (Pins->enable != OFF && Pins->enable != SHARED) digitalWriteEx(Pins->enable, Pins->enabledState);
+  driver->irun(mAToCs(settings.currentRun));
+  driver->ihold(mAToCs(settings.currentRun));
+  driver->pwm_autograd(DRIVER_TMC_STEPPER_AUTOGRAD);
+  driver->pwm_autoscale(true);
+  driver->en_pwm_mode(true);
+  return true;
+}
+
+void TmcRampMotor::calibrateDriverFinish() {
+  if (settings.decay != STEALTHCHOP && settings.decaySlewing != STEALTHCHOP) return;
+
+  setMode(slewing);
+  if (Pins->enable != OFF && Pins->enable != SHARED) digitalWriteEx(Pins->enable, !Pins->enabledState);
+}
+
+// moves the target at the commanded rate and updates the driver
+void TmcRampMotor::poll() {
+  unsigned long now = micros();
+  float seconds = (long)(now - lastPollTime)/1000000.0F;
+  if (seconds > 1.0F) seconds = 1.0F;
+  lastPollTime = now;
+
+  readPosition();
+
+  // rate moves, the target moves here instead of in a step timer ISR
+  if (!gotoActive && synchronized && !inBacklash) {
+    targetFraction += frequency*seconds;
+    long steps = (long)targetFraction;
+    targetFraction -= steps;
+    noInterrupts();
+    targetSteps += steps;
+    interrupts();
+  }
+
+  writeTarget();
+}
+
+// reads XACTUAL and VACTUAL, the motor position is what's left after the backlash
+void TmcRampMotor::readPosition() {
+  long position = driver->XACTUAL();
+  int32_t v = driver->VACTUAL();
+  if (v & 0x00800000L) v |= 0xFF000000L; // VACTUAL is 24 bit signed
+  velocity = v*(TMC_RAMP_FCLK/16777216.0F);
+
+  // the motor only moves once the backlash is taken up, in either direction
+  noInterrupts();
+  long backlash = position - motorSteps;
+  if (backlash > (long)backlashAmountSteps) { motorSteps = position - backlashAmountSteps; backlash = backlashAmountSteps; } else
+  if (backlash < 0) { motorSteps = position; backlash = 0; }
+  backlashSteps = backlash;
+  long distance = targetSteps - motorSteps;
+  inBacklash = (distance > 0 && backlash < (long)backlashAmountSteps) || (distance < 0 && backlash > 0);
+  if (distance != 0) step = distance > 0 ? 1 : -1; else if (frequency != 0.0F) step = frequency > 0.0F ? 1 : -1;
+  interrupts();
+}
+
+// writes XTARGET and the ramp limits, registers are only written when they change
+void TmcRampMotor::writeTarget() {
+  noInterrupts();
+  long target = targetSteps;
+  long distance = targetSteps - motorSteps;
+  long backlash = backlashSteps;
+  interrupts();
+
+  // moving forward ends with the backlash taken up, moving in reverse with none
+  if (distance > 0) backlash = backlashAmountSteps; else if (distance < 0) backlash = 0;
+
+  long xtarget;
+  float vmax, amax;
+  if (gotoActive) {
+    xtarget = target + backlash;
+    vmax = gotoFrequency;
+    amax = acceleration;
+  } else {
+    // the target leads by one poll so the ramp generator runs through at the rate instead of stopping at each
+    // update, the 10% extra on VMAX covers the driver clock tolerance so any lag is made up
+    float f = fabs(frequency);
+    long lead = 0;
+    if (inBacklash) f = backlashRampFrequency(f); else if (synchronized) lead = lroundf(frequency/FRACTIONAL_SEC);
+    xtarget = target + backlash + lead;
+    vmax = f*1.1F;
+    if (vmax < backlashFrequency) vmax = backlashFrequency;
+    amax = accelerationAbort;
+    if (amax < backlashFrequency*FRACTIONAL_SEC) amax = backlashFrequency*FRACTIONAL_SEC;
+  }
+
+  uint32_t v = toVmax(vmax);
+  if (v > TMC_RAMP_VMAX_LIMIT) v = TMC_RAMP_VMAX_LIMIT;
+  uint32_t a = toAmax(amax);
+  if (a < 1) a = 1;
+  if (a > TMC_RAMP_AMAX_LIMIT) a = TMC_RAMP_AMAX_LIMIT;
+
+  if (a != lastAmax) {
+    driver->AMAX(a);
+    driver->DMAX(a);
+    driver->A1(a);
+    driver->D1(a);
+    lastAmax = a;
+  }
+  if (v != lastVmax) { driver->VMAX(v); lastVmax = v; }
+  if (xtarget != lastXtarget) { driver->XTARGET(xtarget); lastXtarget = xtarget; }
+}
+
+// set the decay mode and currents for tracking or slewing
+void TmcRampMotor::setMode(bool slewing) {
+  driver->en_pwm_mode((slewing ? settings.decaySlewing : settings.decay) != SPREADCYCLE);
+  driver->irun(mAToCs(slewing ? settings.currentGoto : settings.currentRun));
+  driver->ihold(mAToCs(settings.currentHold));
+}
+
+#endif
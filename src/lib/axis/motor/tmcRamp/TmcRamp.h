@@ -0,0 +1,148 @@
+// -----------------------------------------------------------------------------------
+// axis TMC5160 motion controller motor, the driver's internal ramp generator moves the motor
+//
+// The TMC5160 is run in positioning mode (SD_MODE tied low) so it makes its own steps and the axis has no step timer.
+// Rate moves (tracking, guiding, and slews by time) move the target at the commanded rate in the axis poll and hand
+// it to the driver as XTARGET, keeping the MCU as the time base since the driver's internal clock is only good to a
+// few percent.  An autoGoto hands the destination to the driver with VMAX, AMAX, and DMAX and the driver ramps the
+// whole move itself.  The motor position is always read back from XACTUAL.
+#pragma once
+
+#include <Arduino.h>
+#include "../../../../Common.h"
+
+#ifdef TMC_RAMP_MOTOR_PRESENT
+
+#include <TMCStepper.h> // https://github.com/teemuatlut/TMCStepper
+
+#include "../Motor.h"
+
+#ifndef DRIVER_TMC_STEPPER_AUTOGRAD
+  #define DRIVER_TMC_STEPPER_AUTOGRAD true
+#endif
+
+// driver clock in Hz, the internal oscillator or the frequency on the CLK pin
+#ifndef TMC_RAMP_FCLK
+  #define TMC_RAMP_FCLK 12000000.0F
+#endif
+
+typedef struct TmcRampPins {
+  int16_t enable;
+  uint8_t enabledState;
+  int16_t m0;
+  int16_t m1;
+  int16_t m2;
+  int16_t m3;
+  int16_t fault;
+} TmcRampPins;
+
+typedef struct TmcRampSettings {
+  int16_t model;
+  int16_t microsteps;
+  int16_t currentHold;
+  int16_t currentRun;
+  int16_t currentGoto;
+  int8_t  decay;
+  int8_t  decaySlewing;
+  int8_t  status;
+} TmcRampSettings;
+
+class TmcRampMotor : public Motor {
+  public:
+    // constructor
+    TmcRampMotor(uint8_t axisNumber, const TmcRampPins *Pins, const TmcRampSettings *Settings);
+
+    // sets up the driver and its ramp generator
+    bool init();
+
+    // set driver reverse state
+    void setReverse(int8_t state);
+
+    // get driver type code
+    inline char getParameterTypeCode() { return 'T'; }
+
+    // sets driver parameters: microsteps, unused, hold current, run current, goto current, unused
+    void setParameters(float param1, float param2, float param3, float param4, float param5, float param6);
+
+    // validate driver parameters
+    bool validateParameters(float param1, float param2, float param3, float param4, float param5, float param6);
+
+    // sets motor enable on/off (if possible)
+    void enable(bool value);
+
+    // get the associated driver status
+    DriverStatus getDriverStatus();
+
+    // resets motor and target angular position in steps, also zeros backlash and index
+    void resetPositionSteps(long value);
+
+    // get tracking mode steps per slewing mode step
+    inline int getStepsPerStepSlewing() { return 1; }
+
+    // get movement frequency in steps per second
+    float getFrequencySteps();
+
+    // set frequency (+/-) in steps per second negative frequencies move reverse in direction (0 stops motion)
+    void setFrequencySteps(float frequency);
+
+    // set synchronized state (automatic movement of target at setFrequencySteps() rate)
+    void setSynchronized(bool state);
+
+    // set the slew and emergency stop acceleration in steps per second per second
+    void setAccelerationSteps(float acceleration, float accelerationAbort);
+
+    // the ramp generator takes the autoGoto to the target
+    bool autoGoto(float frequency);
+
+    // set slewing state (hint that we are about to slew or are done slewing)
+    void setSlewing(bool state);
+
+    // calibrate the motor driver if required
+    bool calibrateDriverStart();
+    void calibrateDriverFinish();
+
+    // moves the target at the commanded rate and updates the driver
+    void poll();
+
+  private:
+    // reads XACTUAL and VACTUAL, the motor position is what's left after the backlash
+    void readPosition();
+
+    // writes XTARGET and the ramp limits, registers are only written when they change
+    void writeTarget();
+
+    // set the decay mode and currents for tracking or slewing
+    void setMode(bool slewing);
+
+    // register values for a frequency in steps per second and an acceleration in steps per second per second
+    inline uint32_t toVmax(float frequency) { return lroundf(fabs(frequency)*(16777216.0F/TMC_RAMP_FCLK)); }
+    inline uint32_t toAmax(float acceleration) { return lroundf(fabs(acceleration)*(2199023255552.0F/(TMC_RAMP_FCLK*TMC_RAMP_FCLK))); }
+
+    inline float mAToCs(float mA) { return 32.0F*(((mA/1000.0F)*(rSense+0.02F))/0.325F) - 1.0F; }
+    float rSense = 0.075F;
+
+    TMC5160Stepper *driver = NULL;
+
+    bool slewing = false;               // slewing decay mode and current
+    bool gotoActive = false;            // the ramp generator has an autoGoto
+    float gotoFrequency = 0.0F;         // autoGoto VMAX in steps per second
+    float acceleration = 0.0F;          // autoGoto AMAX/DMAX in steps per second per second
+    float accelerationAbort = 0.0F;     // fastest change the Axis makes to a rate move, in steps per second per second
+
+    float frequency = 0.0F;             // last frequency requested (+/-)
+    float velocity = 0.0F;              // from VACTUAL, in steps per second (+/-)
+    float targetFraction = 0.0F;        // rate move target position within the step
+    unsigned long lastPollTime = 0;     // in microseconds
+
+    long lastXtarget = 0;               // register values last written
+    uint32_t lastVmax = 0;
+    uint32_t lastAmax = 0;
+
+    DriverStatus status = { false, {false, false}, {false, false}, false, false, false, false };
+    unsigned long timeLastStatusUpdate = 0;
+
+    TmcRampSettings settings;
+    const TmcRampPins *Pins;
+};
+
+#endif
@@ -0,0 +1,30 @@
+// -----------------------------------------------------------------------------------------------------------------------------
+// Startup timing, how long each phase of setup() took
+
+#include "BootTime.h"
+
+void BootTime::mark(const char *name) {
+  unsigned long now = millis();
+  if (count < BOOT_TIME_PHASES) {
+    phaseName[count] = name;
+    phaseMs[count] = now - lastMs;
+    count++;
+  }
+  lastMs = now;
+}
+
+void BootTime::report() {
+  for (uint8_t i = 0; i < count; i++) {
+    VF("MSG: Boot, "); V(phaseName[i]); V(" "); V(phaseMs[i]); VLF("ms");
+  }
+  VF("MSG: Boot, ready after "); V(lastMs); VLF("ms");
+}
+
+bool BootTime::getPhase(uint8_t index, const char **name, unsigned long *ms) {
+  if (index >= count) return false;
+  *name = phaseName[index];
+  *ms = phaseMs[index];
+  return true;
+}
+
+BootTime bootTime;
@@ -0,0 +1,34 @@
+// -----------------------------------------------------------------------------------------------------------------------------
+// Startup timing, how long each phase of setup() took
+#pragma once
+
+#include "../../Common.h"
+
+#define BOOT_TIME_PHASES 24
+
+class BootTime {
+  public:
+    // the time since the last mark (or power up) is logged against the phase just finished
+    // name must be a literal, it's kept rather than copied
+    void mark(const char *name);
+
+    // print the phase times and the total
+    void report();
+
+    // get the name and time in ms of phase index, false if there is no such phase
+    bool getPhase(uint8_t index, const char **name, unsigned long *ms);
+
+    // number of phases marked
+    inline uint8_t getCount() { return count; }
+
+    // time from power up to the last mark in ms
+    inline unsigned long getTotal() { return lastMs; }
+
+  private:
+    const char *phaseName[BOOT_TIME_PHASES];
+    unsigned long phaseMs[BOOT_TIME_PHASES];
+    uint8_t count = 0;
+    unsigned long lastMs = 0;
+};
+
+extern BootTime bootTime;
@@ -0,0 +1,63 @@
+// -----------------------------------------------------------------------------------
+// Binary command framing
+
+#include "BinaryCmds.h"
+
+bool BinaryBuffer::add(uint8_t b) {
+  unsigned long now = millis();
+  if (state != BS_SYNC && state != BS_READY && (long)(now - lastByteTime) > BINARY_TIMEOUT_MS) state = BS_SYNC;
+  lastByteTime = now;
+
+  switch (state) {
+    case BS_SYNC:
+      if (b == BINARY_SYNC) state = BS_LENGTH;
+    break;
+    case BS_LENGTH:
+      if (b > BINARY_PAYLOAD_MAX) { state = BS_SYNC; break; }
+      length = b;
+      crc = crc16(&b, 1);
+      state = BS_OP;
+    break;
+    case BS_OP:
+      op = b;
+      crc = crc16(&b, 1, crc);
+      count = 0;
+      state = length > 0 ? BS_PAYLOAD : BS_CRC_LOW;
+    break;
+    case BS_PAYLOAD:
+      payload[count++] = b;
+      crc = crc16(&b, 1, crc);
+      if (count >= length) state = BS_CRC_LOW;
+    break;
+    case BS_CRC_LOW:
+      if (b != (crc & 0xFF)) { crcErrors++; state = BS_SYNC; } else state = BS_CRC_HIGH;
+    break;
+    case BS_CRC_HIGH:
+      if (b != (crc >> 8)) { crcErrors++; state = BS_SYNC; } else state = BS_READY;
+    break;
+    case BS_READY:
+    break;
+  }
+
+  return state == BS_READY;
+}
+
+size_t BinaryBuffer::frame(uint8_t *dest, uint8_t op, const void *data, uint8_t dataLength) {
+  if (dataLength > BINARY_PAYLOAD_MAX) dataLength = BINARY_PAYLOAD_MAX;
+  dest[0] = BINARY_SYNC;
+  dest[1] = dataLength;
+  dest[2] = op;
+  if (dataLength > 0) memcpy(&dest[3], data, dataLength);
+  uint16_t c = crc16(&dest[1], dataLength + 2);
+  dest[dataLength + 3] = c & 0xFF;
+  dest[dataLength + 4] = c >> 8;
+  return dataLength + 5;
+}
+
+uint16_t BinaryBuffer::crc16(const uint8_t *data, size_t count, uint16_t crc) {
+  while (count--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
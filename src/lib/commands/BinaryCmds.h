@@ -0,0 +1,47 @@
+// -----------------------------------------------------------------------------------
+// Binary command framing
+//
+// frame: SYNC, length, op, payload[length], crc low, crc high
+// the crc is CRC-16/CCITT-FALSE over length, op, and payload
+#pragma once
+
+#include <Arduino.h>
+
+#define BINARY_SYNC        0xA5
+#define BINARY_PAYLOAD_MAX 48
+#define BINARY_FRAME_MAX   (BINARY_PAYLOAD_MAX + 5)
+#define BINARY_TIMEOUT_MS  100    // a partial frame is dropped after this long without a byte
+
+class BinaryBuffer {
+  public:
+    // add a byte to the incomming frame, returns true once a frame with a valid crc is ready
+    bool add(uint8_t b);
+
+    inline bool ready() { return state == BS_READY; }
+    inline uint8_t getOp() { return op; }
+    inline uint8_t getLength() { return length; }
+    inline uint8_t *getPayload() { return payload; }
+
+    // count of frames dropped for a bad crc
+    inline uint16_t getCrcErrors() { return crcErrors; }
+
+    // discards the current frame
+    inline void flush() { state = BS_SYNC; }
+
+    // builds a frame in dest (which must hold BINARY_FRAME_MAX bytes), returns the frame length
+    static size_t frame(uint8_t *dest, uint8_t op, const void *data, uint8_t dataLength);
+
+    static uint16_t crc16(const uint8_t *data, size_t count, uint16_t crc = 0xFFFF);
+
+  private:
+    enum BinaryState: uint8_t {BS_SYNC, BS_LENGTH, BS_OP, BS_PAYLOAD, BS_CRC_LOW, BS_CRC_HIGH, BS_READY};
+
+    BinaryState state = BS_SYNC;
+    uint8_t length = 0;
+    uint8_t op = 0;
+    uint8_t count = 0;
+    uint16_t crc = 0;
+    uint16_t crcErrors = 0;
+    unsigned long lastByteTime = 0;
+    uint8_t payload[BINARY_PAYLOAD_MAX];
+};
@@ -36,6 +36,7 @@ bool Buffer::add(char c) {
       if (len < 5) {
         flush();
         cb[0] = ':'; cb[1] = (char)6; cb[2] = '0'; cb[3] = '#'; cb[4] = 0; cbp = 4; 
+        tokenize();
         return true; 
       }
       
@@ -51,6 +52,7 @@ bool Buffer::add(char c) {
         flush();
         cb[0] = ':'; cb[1] = (char)6; cb[2] = '0'; cb[3] = '#'; cb[4] = 0;
         cbp = 4; 
+        tokenize();
         return true;
       }
 
@@ -58,27 +60,32 @@ bool Buffer::add(char c) {
       --len; --len; cb[--len] = 0;
     }
 
+    if (cbp == 1) { flush(); return false; }
+    tokenize();
     return true;
   } else {
     return false;
   }
 }
 
-char* Buffer::getCmd() {
-  // the command is either one or two chars in length
-  cmd[0] = 0;
-  memmove(cmd, (char *)&cb[1], 2);
+// split the frame in place, once, into the command (one or two chars) and the parameter that follows
+void Buffer::tokenize() {
+  char *end = strchr(cb, '#');
+  if (end != NULL) *end = 0;
+
+  cmd[0] = cb[1];
+  cmd[1] = cmd[0] ? cb[2] : 0;
   cmd[2] = 0;
-  if (cmd[1] == '#' && cmd[2] == 0) cmd[1] = 0;
+  parameter = cmd[1] ? &cb[3] : &cb[strlen(cb)];
+  complete = true;
+}
+
+char* Buffer::getCmd() {
   return cmd;
 }
 
 char* Buffer::getParameter() {
-  // the remaining parameter
-  pb[0] = 0;
-  if (cbp > 4) memmove(pb, (char *)&cb[3], cbp-4);
-  pb[cbp-4] = 0;
-  return pb;
+  return parameter;
 }
 
 char* Buffer::getSeq() {
@@ -88,13 +95,18 @@ char* Buffer::getSeq() {
 }
 
 bool Buffer::ready() {
-  if (!cbp) return false;
-  if (cb[cbp-1] == '#' && cbp == 1) flush();
-  return (cb[cbp-1] == '#');
+  return complete;
+}
+
+bool Buffer::isEmpty() {
+  return cbp == 0;
 }
 
 bool Buffer::flush() {
   cbp = 0;
   cb[0] = (char)0;
+  cmd[0] = 0;
+  parameter = cb;
+  complete = false;
   return true;
 }
@@ -13,9 +13,12 @@ class Buffer {
     char* getParameter();
     char* getSeq();
     bool ready();
+    bool isEmpty();
     bool flush();
 
   private:
+    void tokenize();
+
     int mountType = 0;
     char channel;
     char (*reader)();
@@ -23,8 +26,9 @@ class Buffer {
 
     const static int bufferSize = 80;
     char cmd[4] = "";
-    char pb[bufferSize] = "";
     char cb[bufferSize] = "";
+    char *parameter = cb;
     int  cbp = 0;
+    bool complete = false;
     char seq = 0;
 };
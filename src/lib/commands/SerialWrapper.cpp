@@ -26,24 +26,48 @@
 
 #ifdef SERIAL_BT
   BluetoothSerial bluetoothSerial;
+
+  #if SERIAL_BT_THROUGHPUT == ON
+    // replies for the bluetooth channel are gathered here and sent once per poll
+    static uint8_t btTx[SERIAL_BT_TX_BUFFER_SIZE];
+    static uint16_t btTxCount = 0;
+
+    static void btSend() {
+      if (btTxCount == 0) return;
+      SERIAL_BT.write(btTx, btTxCount);
+      btTxCount = 0;
+    }
+  #endif
 #endif
 
+#if SERIAL_TX_BUFFER_SIZE > 0
+  // transmit rings for the hardware serial channels (A to D)
+  static uint8_t txRings[4][SERIAL_TX_BUFFER_SIZE];
+  static uint8_t txRingsUsed = 0;
+#endif
+
+void SerialWrapper::txBufferAssign() {
+  #if SERIAL_TX_BUFFER_SIZE > 0
+    if (txRingsUsed < 4) txBuffer = txRings[txRingsUsed++];
+  #endif
+}
+
 SerialWrapper::SerialWrapper() {
   static uint8_t channel = 0;
   #ifdef SERIAL_A
-    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); return; }
+    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); txBufferAssign(); return; }
     channel++;
   #endif
   #ifdef SERIAL_B
-    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); return; }
+    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); txBufferAssign(); return; }
     channel++;
   #endif
   #ifdef SERIAL_C
-    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); return; }
+    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); txBufferAssign(); return; }
     channel++;
   #endif
   #ifdef SERIAL_D
-    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); return; }
+    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); txBufferAssign(); return; }
     channel++;
   #endif
   #ifdef SERIAL_ST4
@@ -51,7 +75,13 @@ SerialWrapper::SerialWrapper() {
     channel++;
   #endif
   #ifdef SERIAL_BT
-    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); return; }
+    if (!hasChannel(channel)) {
+      thisChannel = channel; setChannel(channel);
+      #if SERIAL_BT_THROUGHPUT == ON
+        coalesce = true;
+      #endif
+      return;
+    }
     channel++;
   #endif
   #ifdef SERIAL_PIP1
@@ -70,6 +100,10 @@ SerialWrapper::SerialWrapper() {
     if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); return; }
     channel++;
   #endif
+  #ifdef SERIAL_WS
+    if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); return; }
+    channel++;
+  #endif
   #ifdef SERIAL_LOCAL
     if (!hasChannel(channel)) { thisChannel = channel; setChannel(channel); return; }
     channel++;
@@ -131,6 +165,9 @@ void SerialWrapper::begin(long baud) {
   #ifdef SERIAL_SIP
     if (isChannel(channel++)) SERIAL_SIP.begin(9999, 10L*1000L, true);
   #endif
+  #ifdef SERIAL_WS
+    if (isChannel(channel++)) SERIAL_WS.begin(SERIAL_WEBSOCKET_PORT);
+  #endif
   #ifdef SERIAL_LOCAL
     if (isChannel(channel++)) SERIAL_LOCAL.begin(baud);
   #endif
@@ -170,6 +207,9 @@ void SerialWrapper::end() {
   #ifdef SERIAL_SIP
     if (isChannel(channel++)) SERIAL_SIP.end();
   #endif
+  #ifdef SERIAL_WS
+    if (isChannel(channel++)) SERIAL_WS.end();
+  #endif
   #ifdef SERIAL_LOCAL
     if (isChannel(channel++)) SERIAL_LOCAL.end();
   #endif
@@ -177,46 +217,136 @@ void SerialWrapper::end() {
 }
 
 size_t SerialWrapper::write(uint8_t data) {
+  return write(&data, 1);
+}
+
+size_t SerialWrapper::write(const uint8_t *data, size_t quantity) {
+  #if defined(SERIAL_BT) && SERIAL_BT_THROUGHPUT == ON
+    if (coalesce) {
+      if (btTxCount + quantity > SERIAL_BT_TX_BUFFER_SIZE) btSend();
+      if (quantity > SERIAL_BT_TX_BUFFER_SIZE) return SERIAL_BT.write(data, quantity);
+      memcpy(&btTx[btTxCount], data, quantity);
+      btTxCount += quantity;
+      return quantity;
+    }
+  #endif
+  #if SERIAL_TX_BUFFER_SIZE > 0
+    if (txBuffer != NULL) {
+      // keep the order, anything already waiting goes first
+      drain();
+      size_t sent = 0;
+      if (txHead == txTail) {
+        int room = portAvailableForWrite();
+        if (room > 0) sent = portWrite(data, min((size_t)room, quantity));
+      }
+      while (sent < quantity) {
+        uint16_t next = (txHead + 1) % SERIAL_TX_BUFFER_SIZE;
+        if (next == txTail) {
+          // the ring is full, wait on the port for the rest
+          drain();
+          if (next == txTail) { txFlush(); continue; }
+        }
+        txBuffer[txHead] = data[sent++];
+        txHead = next;
+      }
+      return quantity;
+    }
+  #endif
+  return portWrite(data, quantity);
+}
+
+void SerialWrapper::drain() {
+  // the IP (and bluetooth throughput mode) channels gather replies and send them here in one write
+  #if defined(SERIAL_BT) && SERIAL_BT_THROUGHPUT == ON
+    if (coalesce) { btSend(); return; }
+  #endif
   uint8_t channel = 0;
   #ifdef SERIAL_A
-    if (isChannel(channel++)) return SERIAL_A.write(data);
+    channel++;
   #endif
   #ifdef SERIAL_B
-    if (isChannel(channel++)) return SERIAL_B.write(data);
+    channel++;
   #endif
   #ifdef SERIAL_C
-    if (isChannel(channel++)) return SERIAL_C.write(data);
+    channel++;
   #endif
   #ifdef SERIAL_D
-    if (isChannel(channel++)) return SERIAL_D.write(data);
+    channel++;
   #endif
   #ifdef SERIAL_ST4
-    if (isChannel(channel++)) return SERIAL_ST4.write(data);
+    channel++;
   #endif
   #ifdef SERIAL_BT
-    if (isChannel(channel++)) return SERIAL_BT.write(data);
+    channel++;
   #endif
   #ifdef SERIAL_PIP1
-    if (isChannel(channel++)) return SERIAL_PIP1.write(data);
+    if (isChannel(channel++)) { SERIAL_PIP1.send(); return; }
   #endif
   #ifdef SERIAL_PIP2
-    if (isChannel(channel++)) return SERIAL_PIP2.write(data);
+    if (isChannel(channel++)) { SERIAL_PIP2.send(); return; }
   #endif
   #ifdef SERIAL_PIP3
-    if (isChannel(channel++)) return SERIAL_PIP3.write(data);
+    if (isChannel(channel++)) { SERIAL_PIP3.send(); return; }
   #endif
   #ifdef SERIAL_SIP
-    if (isChannel(channel++)) return SERIAL_SIP.write(data);
+    if (isChannel(channel++)) { SERIAL_SIP.send(); return; }
   #endif
-  #ifdef SERIAL_LOCAL
-    if (isChannel(channel++)) return SERIAL_LOCAL.write(data);
+  UNUSED(channel);
+
+  #if SERIAL_TX_BUFFER_SIZE > 0
+    if (txBuffer == NULL) return;
+    while (txHead != txTail) {
+      int room = portAvailableForWrite();
+      if (room <= 0) return;
+      // the contiguous part of the ring up to the end of the array or the head
+      size_t count = (txHead > txTail ? txHead : SERIAL_TX_BUFFER_SIZE) - txTail;
+      if (count > (size_t)room) count = room;
+      portWrite(&txBuffer[txTail], count);
+      txTail = (txTail + count) % SERIAL_TX_BUFFER_SIZE;
+    }
+  #endif
+}
+
+size_t SerialWrapper::txPending() {
+  #if defined(SERIAL_BT) && SERIAL_BT_THROUGHPUT == ON
+    if (coalesce) return btTxCount;
+  #endif
+  #if SERIAL_TX_BUFFER_SIZE > 0
+    if (txBuffer != NULL) return (txHead + SERIAL_TX_BUFFER_SIZE - txTail) % SERIAL_TX_BUFFER_SIZE;
+  #endif
+  return 0;
+}
+
+// blocking write of everything in the ring
+void SerialWrapper::txFlush() {
+  #if SERIAL_TX_BUFFER_SIZE > 0
+    while (txHead != txTail) {
+      size_t count = (txHead > txTail ? txHead : SERIAL_TX_BUFFER_SIZE) - txTail;
+      portWrite(&txBuffer[txTail], count);
+      txTail = (txTail + count) % SERIAL_TX_BUFFER_SIZE;
+    }
+  #endif
+}
+
+int SerialWrapper::portAvailableForWrite() {
+  uint8_t channel = 0;
+  #ifdef SERIAL_A
+    if (isChannel(channel++)) return SERIAL_A.availableForWrite();
+  #endif
+  #ifdef SERIAL_B
+    if (isChannel(channel++)) return SERIAL_B.availableForWrite();
+  #endif
+  #ifdef SERIAL_C
+    if (isChannel(channel++)) return SERIAL_C.availableForWrite();
+  #endif
+  #ifdef SERIAL_D
+    if (isChannel(channel++)) return SERIAL_D.availableForWrite();
   #endif
-  UNUSED(data);
   UNUSED(channel);
   return -1;
 }
 
-size_t SerialWrapper::write(const uint8_t *data, size_t quantity) {
+size_t SerialWrapper::portWrite(const uint8_t *data, size_t quantity) {
   uint8_t channel = 0;
   #ifdef SERIAL_A
     if (isChannel(channel++)) return SERIAL_A.write(data, quantity);
@@ -248,6 +378,9 @@ size_t SerialWrapper::write(const uint8_t *data, size_t quantity) {
   #ifdef SERIAL_SIP
     if (isChannel(channel++)) return SERIAL_SIP.write(data, quantity);
   #endif
+  #ifdef SERIAL_WS
+    if (isChannel(channel++)) return SERIAL_WS.write(data, quantity);
+  #endif
   #ifdef SERIAL_LOCAL
     if (isChannel(channel++)) return SERIAL_LOCAL.write(data, quantity);
   #endif
@@ -289,6 +422,9 @@ int SerialWrapper::available() {
   #ifdef SERIAL_SIP
     if (isChannel(channel++)) return SERIAL_SIP.available();
   #endif
+  #ifdef SERIAL_WS
+    if (isChannel(channel++)) return SERIAL_WS.available();
+  #endif
   #ifdef SERIAL_LOCAL
     if (isChannel(channel++)) return SERIAL_LOCAL.available();
   #endif
@@ -328,6 +464,9 @@ int SerialWrapper::read() {
   #ifdef SERIAL_SIP
     if (isChannel(channel++)) return SERIAL_SIP.read();
   #endif
+  #ifdef SERIAL_WS
+    if (isChannel(channel++)) return SERIAL_WS.read();
+  #endif
   #ifdef SERIAL_LOCAL
     if (isChannel(channel++)) return SERIAL_LOCAL.read();
   #endif
@@ -335,6 +474,65 @@ int SerialWrapper::read() {
   return -1;
 }
 
+size_t SerialWrapper::read(uint8_t *buffer, size_t count) {
+  uint8_t channel = 0;
+  // the IP channels read a block from the client in one call
+  #ifdef SERIAL_A
+    channel++;
+  #endif
+  #ifdef SERIAL_B
+    channel++;
+  #endif
+  #ifdef SERIAL_C
+    channel++;
+  #endif
+  #ifdef SERIAL_D
+    channel++;
+  #endif
+  #ifdef SERIAL_ST4
+    channel++;
+  #endif
+  #ifdef SERIAL_BT
+    #if SERIAL_BT_THROUGHPUT == ON
+      if (isChannel(channel++)) {
+        // everything already queued, in one call
+        int waiting = SERIAL_BT.available();
+        if (waiting <= 0) return 0;
+        return SERIAL_BT.readBytes(buffer, (size_t)waiting < count ? waiting : count);
+      }
+    #else
+      channel++;
+    #endif
+  #endif
+  #ifdef SERIAL_PIP1
+    if (isChannel(channel++)) return SERIAL_PIP1.read(buffer, count);
+  #endif
+  #ifdef SERIAL_PIP2
+    if (isChannel(channel++)) return SERIAL_PIP2.read(buffer, count);
+  #endif
+  #ifdef SERIAL_PIP3
+    if (isChannel(channel++)) return SERIAL_PIP3.read(buffer, count);
+  #endif
+  #ifdef SERIAL_SIP
+    if (isChannel(channel++)) return SERIAL_SIP.read(buffer, count);
+  #endif
+  #ifdef SERIAL_WS
+    if (isChannel(channel++)) return SERIAL_WS.read(buffer, count);
+  #endif
+  UNUSED(channel);
+
+  // the others already buffer received chars in RAM
+  int waiting = available();
+  if (waiting <= 0) return 0;
+  if ((size_t)waiting < count) count = waiting;
+  for (size_t i = 0; i < count; i++) {
+    int c = read();
+    if (c < 0) return i;
+    buffer[i] = c;
+  }
+  return count;
+}
+
 int SerialWrapper::peek() {
   uint8_t channel = 0;
   #ifdef SERIAL_A
@@ -367,6 +565,9 @@ int SerialWrapper::peek() {
   #ifdef SERIAL_SIP
     if (isChannel(channel++)) return SERIAL_SIP.peek();
   #endif
+  #ifdef SERIAL_WS
+    if (isChannel(channel++)) return SERIAL_WS.peek();
+  #endif
   #ifdef SERIAL_LOCAL
     if (isChannel(channel++)) return SERIAL_LOCAL.peek();
   #endif
@@ -375,6 +576,7 @@ int SerialWrapper::peek() {
 }
 
 void SerialWrapper::flush() {
+  txFlush();
   uint8_t channel = 0;
   #ifdef SERIAL_A
     if (isChannel(channel++)) SERIAL_A.flush();
@@ -406,6 +608,9 @@ void SerialWrapper::flush() {
   #ifdef SERIAL_SIP
     if (isChannel(channel++)) SERIAL_SIP.flush();
   #endif
+  #ifdef SERIAL_WS
+    if (isChannel(channel++)) SERIAL_WS.flush();
+  #endif
   #ifdef SERIAL_LOCAL
     if (isChannel(channel++)) SERIAL_LOCAL.flush();
   #endif
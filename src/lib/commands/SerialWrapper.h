@@ -6,6 +6,7 @@
 
 #include "../serial/Serial_IP_Wifi.h"
 #include "../serial/Serial_IP_Ethernet.h"
+#include "../serial/Serial_WebSocket.h"
 
 #ifdef MOUNT_PRESENT
   #if ST4_INTERFACE == ON && ST4_HAND_CONTROL == ON
@@ -14,7 +15,17 @@
 #endif
 #include "../serial/Serial_Local.h"
 
-static uint8_t _wrapper_channels = 0;
+// software transmit ring buffer size for each of the hardware serial channels (A to D), 0 to disable
+#ifndef SERIAL_TX_BUFFER_SIZE
+  #define SERIAL_TX_BUFFER_SIZE 128
+#endif
+
+// replies gathered per poll on the bluetooth channel in throughput mode
+#ifndef SERIAL_BT_TX_BUFFER_SIZE
+  #define SERIAL_BT_TX_BUFFER_SIZE 512
+#endif
+
+static uint16_t _wrapper_channels = 0;
 
 #define isChannel(x) (x == thisChannel)
 
@@ -31,9 +42,18 @@ class SerialWrapper : public Stream {
     virtual size_t write(const uint8_t *, size_t);
     virtual int available(void);
     virtual int read(void);
+
+    // read up to count bytes that are already waiting without blocking, returns the number read
+    size_t read(uint8_t *buffer, size_t count);
     virtual int peek(void);
     virtual void flush(void);
 
+    // send as much buffered transmit data as the port will take without waiting (the IP channels send all of it)
+    void drain();
+
+    // count of bytes waiting in the transmit buffer
+    size_t txPending();
+
     inline size_t write(unsigned long n) { return write((uint8_t)n); }
     inline size_t write(long n) { return write((uint8_t)n); }
     inline size_t write(unsigned int n) { return write((uint8_t)n); }
@@ -46,5 +66,14 @@ class SerialWrapper : public Stream {
     using Print::write;
 
   private:
+    size_t portWrite(const uint8_t *data, size_t quantity);
+    int portAvailableForWrite();
+    void txBufferAssign();
+    void txFlush();
+
     uint8_t thisChannel = 0;
+    bool coalesce = false;
+    uint8_t *txBuffer = NULL;
+    uint16_t txHead = 0;
+    uint16_t txTail = 0;
 };
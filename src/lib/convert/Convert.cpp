@@ -46,6 +46,98 @@ void strncpyex(char *result, const char *source, size_t length) {
   }
 #endif
 
+Formatter::Formatter(char *buffer, size_t size) {
+  start = cursor = buffer;
+  end = buffer + size - 1;
+  *cursor = 0;
+}
+
+Formatter& Formatter::str(const char *s) {
+  while (*s && cursor < end) *cursor++ = *s++;
+  *cursor = 0;
+  return *this;
+}
+
+Formatter& Formatter::chr(char c) {
+  if (cursor < end) *cursor++ = c;
+  *cursor = 0;
+  return *this;
+}
+
+Formatter& Formatter::uint(unsigned long n, uint8_t width) {
+  char digits[10];
+  uint8_t count = 0;
+  do { digits[count++] = '0' + n % 10; n /= 10; } while (n > 0);
+  while (width > count) { chr('0'); width--; }
+  while (count > 0) chr(digits[--count]);
+  return *this;
+}
+
+Formatter& Formatter::sint(long n, uint8_t width, bool plus) {
+  if (n < 0) chr('-'); else if (plus) chr('+');
+  return uint(n < 0 ? -(unsigned long)n : (unsigned long)n, width);
+}
+
+Formatter& Formatter::hex(unsigned long n, uint8_t width) {
+  char digits[8];
+  uint8_t count = 0;
+  do { digits[count++] = "0123456789ABCDEF"[n & 15]; n >>= 4; } while (n > 0);
+  while (width > count) { chr('0'); width--; }
+  while (count > 0) chr(digits[--count]);
+  return *this;
+}
+
+Formatter& Formatter::fixed(double f, uint8_t decimals) {
+  static const unsigned long scale[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+  if (decimals > 9) decimals = 9;
+  if (isnan(f)) return str("nan");
+  bool negative = f < 0;
+  if (negative) f = -f;
+
+  // integer and fractional parts each must fit an unsigned long
+  double whole = floor(f);
+  if (whole > 4294967295.0) return str(negative ? "-inf" : "inf");
+  unsigned long integer = (unsigned long)whole;
+  unsigned long fraction = (unsigned long)((f - whole)*scale[decimals] + 0.5);
+  if (fraction >= scale[decimals]) { fraction -= scale[decimals]; integer++; }
+
+  if (negative && (integer > 0 || fraction > 0)) chr('-');
+  uint(integer);
+  if (decimals > 0) { chr('.'); uint(fraction, decimals); }
+  return *this;
+}
+
+Formatter& Formatter::hms(double value, bool signPresent, PrecisionMode p) {
+  if (signPresent) { if (value < 0) { value = -value; chr('-'); } else chr('+'); }
+
+  // round to 0.00005 second or 0.5 second, depending on precision mode
+  if (p == PM_HIGHEST) value += 0.0000000139; else value += 0.000139;
+
+  // in units of 0.0001 second
+  unsigned long t = (unsigned long)(value*36000000.0);
+  uint(t/36000000UL, 2).chr(':').uint((t/600000UL) % 60, 2);
+  if (p == PM_LOWEST) return *this;
+  if (p == PM_LOW) return chr('.').uint((t/60000UL) % 10);
+  chr(':').uint((t/10000UL) % 60, 2);
+  if (p == PM_HIGHEST) chr('.').uint(t % 10000UL, 4);
+  return *this;
+}
+
+Formatter& Formatter::dms(double value, bool fullRange, bool signPresent, PrecisionMode p) {
+  if (signPresent) { if (value < 0) { value = -value; chr('-'); } else chr('+'); }
+
+  // round to 0.0005 arc-second or 0.5 arc-second, depending on precision mode
+  if (p == PM_HIGHEST) value += 0.000000139; else value += 0.000139;
+
+  // in units of 0.001 arc-second
+  unsigned long t = (unsigned long)(value*3600000.0);
+  uint(t/3600000UL, fullRange ? 3 : 2).chr('*').uint((t/60000UL) % 60, 2);
+  if (p == PM_LOW || p == PM_LOWEST) return *this;
+  chr(':').uint((t/1000UL) % 60, 2);
+  if (p == PM_HIGHEST) chr('.').uint(t % 1000UL, 3);
+  return *this;
+}
+
 bool Convert::tzToDouble(double *value, char *hm) {
   int16_t sign = 1;
   int16_t hour, minute = 0;
@@ -188,32 +280,7 @@ bool Convert::dmsToDouble(double *value, char *dms, bool signPresent) {
 }
 
 void Convert::doubleToHms(char *reply, double value, bool signPresent, PrecisionMode p) {
-  char sign[2] = "";
-  double hour, minute, second, decimal = 0;
-
-  // setup formatting, handle adding the sign
-  if (signPresent) {
-    if (value < 0) { value = -value; strcpy(sign,"-"); } else strcpy(sign,"+");
-  }
-  
-  // round to 0.00005 second or 0.5 second, depending on precision mode
-  if (p == PM_HIGHEST) value += 0.0000000139; else value += 0.000139;
-
-  hour = floor(value);
-  minute = (value - hour)*60.0;
-  second = (minute - floor(minute))*60.0;
-
-  // finish off calculations for hms and form string template
-  char form[]="%s%02d:%02d:%02d.%04d";
-  if (p == PM_HIGHEST) { decimal = (second - floor(second))*10000.0; } else
-  if (p == PM_HIGH)    { form[16] = 0; } else
-  if (p == PM_LOW)     { form[16] = 0; form[11] = '.'; form[14] = '1'; second = second/6.0; } else
-  if (p == PM_LOWEST)  { form[11] = 0; second = 0; }
-
-  // set sign and return result string
-  if (p == PM_HIGHEST) sprintf(reply, form, sign, (int)hour, (int)minute, (int)second, (int)decimal); else
-  if (p == PM_LOWEST)  sprintf(reply, form, sign, (int)hour, (int)minute); else
-                       sprintf(reply, form, sign, (int)hour, (int)minute, (int)second);
+  Formatter(reply, 16).hms(value, signPresent, p);
 }
 
 // convert double (in degrees) to string in format as follows:
@@ -224,31 +291,7 @@ void Convert::doubleToHms(char *reply, double value, bool signPresent, Precision
 // DDD:MM:SS       PM_HIGH
 // sDD:MM:SS.SSS   PM_HIGHEST
 void Convert::doubleToDms(char *reply, double value, bool fullRange, bool signPresent, PrecisionMode p) {
-  char sign[2] = "";
-  double deg, minute, second = 0, decimal = 0;
-
-  // setup formatting, handle adding the sign
-  if (signPresent) {
-    if (value < 0) { value = -value; strcpy(sign,"-"); } else strcpy(sign,"+");
-  }
-
-  // round to 0.0005 arc-second or 0.5 arc-second, depending on precision mode
-  if (p == PM_HIGHEST) value += 0.000000139; else value += 0.000139; 
-
-  deg = floor(value);
-  minute = (value - deg)*60.0;
-  second = (minute - floor(minute))*60.0;
-
-  // finish off calculations for dms and form string template
-  char form[]="%s%02d*%02d:%02d.%03d";
-  if (p != PM_HIGHEST) form[16] = 0; else decimal = (second - floor(second))*1000.0;
-  if (p == PM_LOW)     form[11] = 0;
-  if (fullRange)                   form[4]  = '3';
- 
-  // return result string
-  if (p == PM_HIGHEST) sprintf(reply, form, sign, (int)deg, (int)minute, (int)second, (int)decimal); else
-  if (p == PM_HIGH)    sprintf(reply, form, sign, (int)deg, (int)minute, (int)second); else
-  if (p == PM_LOW)     sprintf(reply, form, sign, (int)deg, (int)minute);
+  Formatter(reply, 16).dms(value, fullRange, signPresent, p);
 }
 
 bool Convert::atoi2(char *a, int16_t *i, bool sign) {
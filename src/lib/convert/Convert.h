@@ -12,6 +12,38 @@ void strncpyex(char *result, const char *source, size_t length);
 // sprintf like function for float type, limited to one parameter
 extern void sprintF(char *result, const char *source, double f);
 
+// cursor based reply formatting using integer math only, no sprintf or heap, output is always terminated
+// and clipped to the buffer size
+class Formatter {
+  public:
+    Formatter(char *buffer, size_t size);
+
+    // append a string or character
+    Formatter& str(const char *s);
+    Formatter& chr(char c);
+
+    // append an integer, zero padded to width digits and with an optional leading +
+    Formatter& uint(unsigned long n, uint8_t width = 1);
+    Formatter& sint(long n, uint8_t width = 1, bool plus = false);
+
+    // append a hex value, zero padded to width digits
+    Formatter& hex(unsigned long n, uint8_t width = 2);
+
+    // append a rounded value with the given number of decimals (0 to 9), like "%0.nf"
+    Formatter& fixed(double f, uint8_t decimals);
+
+    // append hours or degrees in the forms of Convert::doubleToHms() and Convert::doubleToDms()
+    Formatter& hms(double value, bool signPresent, PrecisionMode p);
+    Formatter& dms(double value, bool fullRange, bool signPresent, PrecisionMode p);
+
+    inline size_t length() { return cursor - start; }
+
+  private:
+    char *start;
+    char *cursor;
+    char *end;
+};
+
 class Convert {
   public:
     // convert timezone string  sHH:MM to double (in hours):
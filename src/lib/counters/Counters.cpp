@@ -0,0 +1,33 @@
+// -----------------------------------------------------------------------------------------------------------------------------
+// Health counters and gauges, registered by subsystems at init and read back together with :GXN#
+
+#include "Counters.h"
+
+uint8_t Counters::add(const char *name, CounterType type) {
+  for (uint8_t i = 0; i < count; i++) if (strcmp(this->name[i], name) == 0) return i + 1;
+  if (count >= COUNTERS_MAX) { DF("WRN: Counters, no room for "); DL(name); return 0; }
+
+  this->name[count] = name;
+  this->type[count] = type;
+  value[count] = 0;
+  return ++count;
+}
+
+uint32_t Counters::get(uint8_t handle) {
+  if (handle == 0 || handle > count) return 0;
+  #ifdef __AVR__
+    noInterrupts(); uint32_t v = value[handle - 1]; interrupts();
+    return v;
+  #else
+    return value[handle - 1];
+  #endif
+}
+
+bool Counters::getInfo(uint8_t index, const char **name, CounterType *type) {
+  if (index >= count) return false;
+  *name = this->name[index];
+  *type = this->type[index];
+  return true;
+}
+
+Counters counters;
@@ -0,0 +1,54 @@
+// -----------------------------------------------------------------------------------------------------------------------------
+// Health counters and gauges, registered by subsystems at init and read back together with :GXN#
+#pragma once
+
+#include "../../Common.h"
+
+#define COUNTERS_MAX 24
+
+enum CounterType: uint8_t {CT_COUNTER, CT_GAUGE};
+
+class Counters {
+  public:
+    // register a counter (only goes up) or gauge (set to the latest value) by name, names must be literals
+    // registering a name again returns the existing handle so instances of a class can share one
+    // returns a handle (from 1) or 0 if the registry is full, a 0 handle is ignored by increment() and set()
+    uint8_t add(const char *name, CounterType type = CT_COUNTER);
+
+    // count an event, safe from ISRs and from either core
+    inline void increment(uint8_t handle, uint32_t amount = 1) {
+      if (handle == 0) return;
+      #ifdef __AVR__
+        noInterrupts(); value[handle - 1] += amount; interrupts();
+      #else
+        __atomic_fetch_add(&value[handle - 1], amount, __ATOMIC_RELAXED);
+      #endif
+    }
+
+    // set a gauge, safe from ISRs
+    inline void set(uint8_t handle, uint32_t amount) {
+      if (handle == 0) return;
+      #ifdef __AVR__
+        noInterrupts(); value[handle - 1] = amount; interrupts();
+      #else
+        __atomic_store_n(&value[handle - 1], amount, __ATOMIC_RELAXED);
+      #endif
+    }
+
+    // get the value of handle
+    uint32_t get(uint8_t handle);
+
+    // get the name and type of counter index (from 0), false if there is no such counter
+    bool getInfo(uint8_t index, const char **name, CounterType *type);
+
+    // number of counters registered
+    inline uint8_t getCount() { return count; }
+
+  private:
+    const char *name[COUNTERS_MAX];
+    CounterType type[COUNTERS_MAX];
+    volatile uint32_t value[COUNTERS_MAX];
+    uint8_t count = 0;
+};
+
+extern Counters counters;
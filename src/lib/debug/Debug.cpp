@@ -46,6 +46,11 @@
         SERIAL_DEBUG.print(s); Y;
         SERIAL_DEBUG.println(); Y;
         SERIAL_DEBUG.print("\x1b[K");
+
+        sprintf(s, "[NV commit ] stall last %6ldus, max %6ldus%s", (long)nv.commitStallUs, (long)nv.commitStallMaxUs, nv.committed() ? "" : ", pending"); Y;
+        SERIAL_DEBUG.print(s); Y;
+        SERIAL_DEBUG.println(); Y;
+        SERIAL_DEBUG.print("\x1b[K");
     
         count = 0;
         handle = tasks.getFirstHandle();
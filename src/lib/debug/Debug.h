@@ -13,7 +13,17 @@
     // echo strings to OnStep debug interface (supports embedded spaces and cr/lf)
     extern void debugPrint(const char* s);
     extern bool debugRemoteConnected;
+  #endif
+
+  #if DEBUG_DEFERRED != OFF
+    // record into the deferred log, printed later by a low priority task
+    #include "DebugLog.h"
 
+    #define D(x)     debugLog(x, false)
+    #define DF(x)    debugLog(F(x), false)
+    #define DL(x)    debugLog(x, true)
+    #define DLF(x)   debugLog(F(x), true)
+  #elif defined(REMOTE) && DEBUG == REMOTE
     #define D(x)     { if (debugRemoteConnected) { SERIAL_ONSTEP.print(":EC"); SERIAL_ONSTEP.print(x); SERIAL_ONSTEP.print("#"); delay(50); } }
     #define DF(x)    { if (debugRemoteConnected) { SERIAL_ONSTEP.print(":EC"); debugPrint(x); SERIAL_ONSTEP.print("#"); delay(50); } }
     #define DL(x)    { if (debugRemoteConnected) { SERIAL_ONSTEP.print(":EC"); SERIAL_ONSTEP.print(x); SERIAL_ONSTEP.print("&#"); delay(50); } }
@@ -0,0 +1,191 @@
+// -----------------------------------------------------------------------------------
+// Deferred debug logging, the D/V macros record into a RAM ring buffer and a low priority task prints it
+
+#include "Debug.h"
+
+#if defined(DEBUG) && DEBUG != OFF && DEBUG != PROFILER && DEBUG_DEFERRED != OFF
+
+#include "../tasks/OnTask.h"
+
+enum DebugLogType : uint8_t {DLT_FLASH, DLT_TEXT, DLT_CHAR, DLT_LONG, DLT_ULONG, DLT_DOUBLE};
+
+#define DLF_NEWLINE   1 // print a newline after this record
+#define DLF_CONTINUED 2 // the next record holds more of this text
+
+#define DEBUG_LOG_TEXT_CHARS (sizeof(double)*2)
+
+typedef struct DebugLogRecord {
+  uint8_t type;
+  uint8_t flags;
+  uint8_t length;
+  union {
+    const __FlashStringHelper *f;
+    long l;
+    unsigned long u;
+    double d;
+    char s[DEBUG_LOG_TEXT_CHARS];
+  } v;
+} DebugLogRecord;
+
+#define DEBUG_LOG_MASK (DEBUG_DEFERRED - 1)
+
+static DebugLogRecord debugLogBuffer[DEBUG_DEFERRED];
+static volatile uint16_t debugLogHead = 0;
+static volatile uint16_t debugLogTail = 0;
+static volatile unsigned long debugLogDropped = 0;
+static bool debugLogDeferred = false;
+
+#if defined(REMOTE) && DEBUG == REMOTE
+  // the OnStep debug interface can't take embedded spaces
+  class DebugLogRemote : public Print {
+    public:
+      size_t write(uint8_t c) { return SERIAL_ONSTEP.write(c == ' ' ? '_' : c); }
+      using Print::write;
+  } debugLogRemote;
+  #define DEBUG_LOG_OUT debugLogRemote
+#else
+  #define DEBUG_LOG_OUT SERIAL_DEBUG
+#endif
+
+// print a value as the original macros did, used until debugLogStart()
+template <typename T> static void debugLogPrint(T x, bool newline) {
+  #if defined(REMOTE) && DEBUG == REMOTE
+    if (!debugRemoteConnected) return;
+    SERIAL_ONSTEP.print(":EC"); DEBUG_LOG_OUT.print(x); SERIAL_ONSTEP.print(newline ? "&#" : "#"); delay(50);
+  #else
+    if (newline) DEBUG_LOG_OUT.println(x); else DEBUG_LOG_OUT.print(x);
+  #endif
+}
+
+// copy records into the buffer as a unit, interrupts are held off only for the copy
+static void debugLogPush(const DebugLogRecord *records, uint8_t count) {
+  noInterrupts();
+  if (((debugLogHead - debugLogTail) & DEBUG_LOG_MASK) + count > DEBUG_LOG_MASK) {
+    debugLogDropped++;
+  } else {
+    for (uint8_t i = 0; i < count; i++) {
+      debugLogBuffer[debugLogHead] = records[i];
+      debugLogHead = (debugLogHead + 1) & DEBUG_LOG_MASK;
+    }
+  }
+  interrupts();
+}
+
+static inline void debugLogValue(uint8_t type, bool newline, DebugLogRecord *record) {
+  record->type = type;
+  record->flags = newline ? DLF_NEWLINE : 0;
+  record->length = 0;
+  debugLogPush(record, 1);
+}
+
+void debugLog(const __FlashStringHelper *x, bool newline) {
+  if (!debugLogDeferred) { debugLogPrint(x, newline); return; }
+  DebugLogRecord record; record.v.f = x; debugLogValue(DLT_FLASH, newline, &record);
+}
+
+void debugLog(const char *x, bool newline) {
+  if (!debugLogDeferred) { debugLogPrint(x, newline); return; }
+
+  const uint8_t maxRecords = (DEBUG_LOG_STRING_MAX + DEBUG_LOG_TEXT_CHARS - 1)/DEBUG_LOG_TEXT_CHARS;
+  DebugLogRecord records[maxRecords];
+  size_t length = strnlen(x, DEBUG_LOG_STRING_MAX);
+  uint8_t count = 0;
+  do {
+    uint8_t chunk = length > DEBUG_LOG_TEXT_CHARS ? DEBUG_LOG_TEXT_CHARS : length;
+    records[count].type = DLT_TEXT;
+    records[count].flags = DLF_CONTINUED;
+    records[count].length = chunk;
+    memcpy(records[count].v.s, x, chunk);
+    x += chunk; length -= chunk; count++;
+  } while (length > 0);
+  records[count - 1].flags = newline ? DLF_NEWLINE : 0;
+  debugLogPush(records, count);
+}
+
+void debugLog(char *x, bool newline) { debugLog((const char *)x, newline); }
+
+void debugLog(char x, bool newline) {
+  if (!debugLogDeferred) { debugLogPrint(x, newline); return; }
+  DebugLogRecord record; record.v.s[0] = x; debugLogValue(DLT_CHAR, newline, &record);
+}
+
+void debugLog(unsigned char x, bool newline) { debugLog((unsigned long)x, newline); }
+void debugLog(int x, bool newline) { debugLog((long)x, newline); }
+void debugLog(unsigned int x, bool newline) { debugLog((unsigned long)x, newline); }
+
+void debugLog(long x, bool newline) {
+  if (!debugLogDeferred) { debugLogPrint(x, newline); return; }
+  DebugLogRecord record; record.v.l = x; debugLogValue(DLT_LONG, newline, &record);
+}
+
+void debugLog(unsigned long x, bool newline) {
+  if (!debugLogDeferred) { debugLogPrint(x, newline); return; }
+  DebugLogRecord record; record.v.u = x; debugLogValue(DLT_ULONG, newline, &record);
+}
+
+void debugLog(double x, bool newline) {
+  if (!debugLogDeferred) { debugLogPrint(x, newline); return; }
+  DebugLogRecord record; record.v.d = x; debugLogValue(DLT_DOUBLE, newline, &record);
+}
+
+// take the oldest record, false if the buffer is empty
+static bool debugLogPop(DebugLogRecord *record) {
+  bool available = false;
+  noInterrupts();
+  if (debugLogTail != debugLogHead) {
+    *record = debugLogBuffer[debugLogTail];
+    debugLogTail = (debugLogTail + 1) & DEBUG_LOG_MASK;
+    available = true;
+  }
+  interrupts();
+  return available;
+}
+
+static void debugLogFormat(const DebugLogRecord *record) {
+  switch (record->type) {
+    case DLT_FLASH:  DEBUG_LOG_OUT.print(record->v.f); break;
+    case DLT_TEXT:   DEBUG_LOG_OUT.write((const uint8_t *)record->v.s, record->length); break;
+    case DLT_CHAR:   DEBUG_LOG_OUT.print(record->v.s[0]); break;
+    case DLT_LONG:   DEBUG_LOG_OUT.print(record->v.l); break;
+    case DLT_ULONG:  DEBUG_LOG_OUT.print(record->v.u); break;
+    case DLT_DOUBLE: DEBUG_LOG_OUT.print(record->v.d); break;
+  }
+}
+
+// drain the buffer, a few records per call so the task never runs long
+static void debugLogPoll() {
+  #if defined(REMOTE) && DEBUG == REMOTE
+    // one message per call, the task rate paces the remote debug interface in place of the delay
+    DebugLogRecord record;
+    if (!debugLogPop(&record)) return;
+    bool connected = debugRemoteConnected;
+    if (connected) { SERIAL_ONSTEP.print(":EC"); debugLogFormat(&record); }
+    while ((record.flags & DLF_CONTINUED) && debugLogPop(&record)) { if (connected) debugLogFormat(&record); }
+    if (connected) SERIAL_ONSTEP.print((record.flags & DLF_NEWLINE) ? "&#" : "#");
+  #else
+    static bool lineStart = true;
+    DebugLogRecord record;
+    for (int i = 0; i < 8; i++) {
+      if (lineStart && debugLogDropped > 0) {
+        noInterrupts(); unsigned long dropped = debugLogDropped; debugLogDropped = 0; interrupts();
+        SERIAL_DEBUG.print(F("WRN: Debug, log buffer full ")); SERIAL_DEBUG.print(dropped); SERIAL_DEBUG.println(F(" entries dropped"));
+      }
+      if (!debugLogPop(&record)) return;
+      debugLogFormat(&record);
+      lineStart = record.flags & DLF_NEWLINE;
+      if (lineStart) SERIAL_DEBUG.println();
+    }
+  #endif
+}
+
+void debugLogStart() {
+  #if defined(REMOTE) && DEBUG == REMOTE
+    const int rate = 50;
+  #else
+    const int rate = 10;
+  #endif
+  VF("MSG: Debug, start deferred log task (rate "); V(rate); VF("ms priority 7, "); V(DEBUG_DEFERRED); VF(" entries)... ");
+  if (tasks.add(rate, 0, true, 7, debugLogPoll, "DbgLog")) { VLF("success"); debugLogDeferred = true; } else { VLF("FAILED!"); }
+}
+
+#endif
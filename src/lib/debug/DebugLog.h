@@ -0,0 +1,35 @@
+// -----------------------------------------------------------------------------------
+// Deferred debug logging, the D/V macros record into a RAM ring buffer and a low priority task prints it
+#pragma once
+
+#include <Arduino.h>
+
+// longest string recorded by one call, longer strings are truncated
+#define DEBUG_LOG_STRING_MAX 80
+
+// log entries are written so they can be recorded from ISR's, the string overloads copy the text
+void debugLog(const __FlashStringHelper *x, bool newline);
+void debugLog(const char *x, bool newline);
+void debugLog(char *x, bool newline);
+void debugLog(char x, bool newline);
+void debugLog(unsigned char x, bool newline);
+void debugLog(int x, bool newline);
+void debugLog(unsigned int x, bool newline);
+void debugLog(long x, bool newline);
+void debugLog(unsigned long x, bool newline);
+void debugLog(double x, bool newline);
+inline void debugLog(float x, bool newline) { debugLog((double)x, newline); }
+inline void debugLog(const String &x, bool newline) { debugLog(x.c_str(), newline); }
+
+// anything else Print knows how to handle is formatted into a local buffer first
+class DebugLogText : public Print {
+  public:
+    size_t write(uint8_t c) { if (length < DEBUG_LOG_STRING_MAX) { s[length++] = c; s[length] = 0; } return 1; }
+    char s[DEBUG_LOG_STRING_MAX + 1] = "";
+    uint8_t length = 0;
+};
+
+template <typename T> void debugLog(const T &x, bool newline) { DebugLogText text; text.print(x); debugLog(text.s, newline); }
+
+// switch from printing immediately to recording, and start the task that drains the buffer
+void debugLogStart();
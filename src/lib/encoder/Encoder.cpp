@@ -10,3 +10,60 @@ void Encoder::init() {
 void Encoder::setOrigin(uint32_t count) {
   origin = count;
 }
+
+// get current position with the time it was sampled
+EncoderSample Encoder::readLatched() {
+  EncoderSample sample;
+  sample.count = read();
+  sample.time = micros();
+  updateVelocity(sample);
+  return sample;
+}
+
+// update the velocity estimate, from the count change at high speed or the edge period at low speed
+void Encoder::updateVelocity(EncoderSample sample) {
+  if (sample.count == INT32_MAX) return;
+
+  if (!velocityPrimed) {
+    velocityCount = sample.count;
+    velocityTime = sample.time;
+    velocityPrimed = true;
+    return;
+  }
+
+  int32_t counts = sample.count - velocityCount;
+  uint32_t elapsed = sample.time - velocityTime;
+
+  if (labs(counts) >= ENCODER_VELOCITY_COUNTS) {
+    velocity = (counts*1000000.0F)/elapsed;
+    velocityCount = sample.count;
+    velocityTime = sample.time;
+    return;
+  }
+
+  noInterrupts();
+  uint32_t period = edgePeriod;
+  uint32_t lastEdgeTime = edgeLastTime;
+  int8_t dir = edgeDir;
+  interrupts();
+
+  if (period != 0) {
+    // with no edge yet since the last one the velocity must be falling
+    uint32_t sinceEdge = sample.time - lastEdgeTime;
+    if (sinceEdge > ENCODER_VELOCITY_TIMEOUT*1000UL) velocity = 0.0F; else {
+      if (sinceEdge > period) period = sinceEdge;
+      velocity = (dir*1000000.0F)/period;
+    }
+    // keep the count window short so the switch back to counts over time is clean
+    if (elapsed > 100000UL) {
+      velocityCount = sample.count;
+      velocityTime = sample.time;
+    }
+  } else
+  if (elapsed > ENCODER_VELOCITY_TIMEOUT*1000UL) {
+    // no edge timing available, so average the count change over the timeout
+    velocity = (counts*1000000.0F)/elapsed;
+    velocityCount = sample.count;
+    velocityTime = sample.time;
+  }
+}
@@ -47,6 +47,20 @@
   #define HAS_BISS_C
 #endif
 
+// count change above which velocity comes from the counts over time rather than the period between edges
+#ifndef ENCODER_VELOCITY_COUNTS
+  #define ENCODER_VELOCITY_COUNTS 10
+#endif
+// time in milliseconds without an edge before the velocity estimate drops to zero
+#ifndef ENCODER_VELOCITY_TIMEOUT
+  #define ENCODER_VELOCITY_TIMEOUT 1000
+#endif
+
+typedef struct EncoderSample {
+  int32_t count;     // encoder count
+  uint32_t time;     // time the count was sampled, in microseconds
+} EncoderSample;
+
 class Encoder {
   public:
     // get device ready for use
@@ -58,6 +72,12 @@ class Encoder {
     // get current position
     virtual int32_t read();
 
+    // get current position with the time it was sampled, also updates the velocity estimate
+    virtual EncoderSample readLatched();
+
+    // get the velocity estimate in counts per second as of the last readLatched()
+    inline float getVelocity() { return velocity; }
+
     // set current position to value
     virtual void write(int32_t count);
 
@@ -79,7 +99,28 @@ class Encoder {
     int32_t count = 0;
 
   protected:
+    // interrupt driven encoders call this for each counted edge, so low speed velocity can be found by period measurement
+    inline void edge(int8_t dir) {
+      uint32_t now = micros();
+      if (dir == edgeDir) edgePeriod = now - edgeLastTime; else edgePeriod = 0;
+      edgeDir = dir;
+      edgeLastTime = now;
+    }
+
+    // update the velocity estimate from a new sample
+    void updateVelocity(EncoderSample sample);
+
     bool initialized = false;
 
     int16_t axis = 0;
+
+  private:
+    volatile uint32_t edgeLastTime = 0;
+    volatile uint32_t edgePeriod = 0;
+    volatile int8_t edgeDir = 0;
+
+    bool velocityPrimed = false;
+    int32_t velocityCount = 0;
+    uint32_t velocityTime = 0;
+    float velocity = 0.0F;
 };
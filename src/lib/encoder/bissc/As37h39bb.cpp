@@ -4,6 +4,8 @@
 
 #ifdef HAS_AS37_H39B_B
 
+#include "../../counters/Counters.h"
+
 // initialize BiSS-C encoder
 // nvAddress holds settings for the 9 supported axes, 9*4 = 72 bytes; set nvAddress 0 to disable
 As37h39bb::As37h39bb(int16_t maPin, int16_t sloPin, int16_t axis) {
@@ -32,99 +34,113 @@ IRAM_ATTR bool As37h39bb::readEnc(uint32_t &position) {
   // bit delay in nanoseconds
   int rate = lround(500000.0/BISSC_CLOCK_RATE_KHZ);
 
-  #ifdef ESP32
-    portMUX_TYPE bisscMutex = portMUX_INITIALIZER_UNLOCKED;
-    taskENTER_CRITICAL(&bisscMutex);
-  #elif defined(__TEENSYDUINO__)
-    noInterrupts();
+  #if BISSC_SPI != OFF
+    if (useSpi) {
+      // 16 multi-turn, 23 position, Err, Wrn, and 6 CRC bits
+      uint64_t frame;
+      readFrameSpi(frame, 47, foundAck, foundStart, foundCds);
+      encTurns = (frame >> 31) & 0xFFFF;
+      position = (frame >> 8) & 0x7FFFFF;
+      encErr = (frame >> 7) & 1;
+      encWrn = (frame >> 6) & 1;
+      as37Crc = frame & 0b111111;
+    } else
   #endif
-
-  // sync phase
-  for (int i = 0; i < 20; i++) {
-    digitalWriteF(maPin, LOW);
-    if (digitalReadF(sloPin) == LOW) foundAck = true;
-    delayNanoseconds(rate);
-    digitalWriteF(maPin, HIGH);
-    delayNanoseconds(rate);
-    if (foundAck) break;
-  }
-
-  // if we have an Ack
-  if (foundAck) {
+  {
+    #ifdef ESP32
+      portMUX_TYPE bisscMutex = portMUX_INITIALIZER_UNLOCKED;
+      taskENTER_CRITICAL(&bisscMutex);
+    #elif defined(__TEENSYDUINO__)
+      noInterrupts();
+    #endif
+
+    // sync phase
     for (int i = 0; i < 20; i++) {
       digitalWriteF(maPin, LOW);
-      if (digitalReadF(sloPin) == HIGH) foundStart = true;
+      if (digitalReadF(sloPin) == LOW) foundAck = true;
       delayNanoseconds(rate);
       digitalWriteF(maPin, HIGH);
       delayNanoseconds(rate);
-      if (foundStart) break;
+      if (foundAck) break;
     }
 
-    // if we have an Start
-    if (foundStart) {
-      digitalWriteF(maPin, LOW);
-      if (digitalReadF(sloPin) == LOW) foundCds = true;
-      delayNanoseconds(rate);
-      digitalWriteF(maPin, HIGH);
-      delayNanoseconds(rate);
-
-      // if we have an Cds, read the data
-      if (foundCds) {
-
-        // the first 16 bits are the multi-turn count
-        for (int i = 0; i < 16; i++) {
-          digitalWriteF(maPin, LOW);
-          if (digitalReadF(sloPin) == HIGH) bitSet(encTurns, 15 - i);
-          delayNanoseconds(rate);
-          digitalWriteF(maPin, HIGH);
-          delayNanoseconds(rate);
-        }
-        
-        // the next 23 bits are the encoder absolute count
-        for (int i = 0; i < 23; i++) {
-          digitalWriteF(maPin, LOW);
-          if (digitalReadF(sloPin) == HIGH) bitSet(position, 22 - i);
-          delayNanoseconds(rate);
-          digitalWriteF(maPin, HIGH);
-          delayNanoseconds(rate);
-        }
-
-        // the Err bit
+    // if we have an Ack
+    if (foundAck) {
+      for (int i = 0; i < 20; i++) {
         digitalWriteF(maPin, LOW);
-        if (digitalReadF(sloPin) == HIGH) encErr = 1;
+        if (digitalReadF(sloPin) == HIGH) foundStart = true;
         delayNanoseconds(rate);
         digitalWriteF(maPin, HIGH);
         delayNanoseconds(rate);
+        if (foundStart) break;
+      }
 
-        // the Wrn bit
+      // if we have an Start
+      if (foundStart) {
         digitalWriteF(maPin, LOW);
-        if (digitalReadF(sloPin) == HIGH) encWrn = 1;
+        if (digitalReadF(sloPin) == LOW) foundCds = true;
         delayNanoseconds(rate);
         digitalWriteF(maPin, HIGH);
         delayNanoseconds(rate);
 
-        // the last 6 bits are the CRC
-        for (int i = 0; i < 6; i++) {
+        // if we have an Cds, read the data
+        if (foundCds) {
+
+          // the first 16 bits are the multi-turn count
+          for (int i = 0; i < 16; i++) {
+            digitalWriteF(maPin, LOW);
+            if (digitalReadF(sloPin) == HIGH) bitSet(encTurns, 15 - i);
+            delayNanoseconds(rate);
+            digitalWriteF(maPin, HIGH);
+            delayNanoseconds(rate);
+          }
+        
+          // the next 23 bits are the encoder absolute count
+          for (int i = 0; i < 23; i++) {
+            digitalWriteF(maPin, LOW);
+            if (digitalReadF(sloPin) == HIGH) bitSet(position, 22 - i);
+            delayNanoseconds(rate);
+            digitalWriteF(maPin, HIGH);
+            delayNanoseconds(rate);
+          }
+
+          // the Err bit
+          digitalWriteF(maPin, LOW);
+          if (digitalReadF(sloPin) == HIGH) encErr = 1;
+          delayNanoseconds(rate);
+          digitalWriteF(maPin, HIGH);
+          delayNanoseconds(rate);
+
+          // the Wrn bit
           digitalWriteF(maPin, LOW);
-          if (digitalReadF(sloPin) == HIGH) bitSet(as37Crc, 5 - i);
+          if (digitalReadF(sloPin) == HIGH) encWrn = 1;
           delayNanoseconds(rate);
           digitalWriteF(maPin, HIGH);
           delayNanoseconds(rate);
+
+          // the last 6 bits are the CRC
+          for (int i = 0; i < 6; i++) {
+            digitalWriteF(maPin, LOW);
+            if (digitalReadF(sloPin) == HIGH) bitSet(as37Crc, 5 - i);
+            delayNanoseconds(rate);
+            digitalWriteF(maPin, HIGH);
+            delayNanoseconds(rate);
+          }
         }
       }
     }
-  }
 
-  // send a CDM (invert)
-  digitalWriteF(maPin, LOW);
-  delayNanoseconds(rate*4);
-  digitalWriteF(maPin, HIGH);
+    // send a CDM (invert)
+    digitalWriteF(maPin, LOW);
+    delayNanoseconds(rate*4);
+    digitalWriteF(maPin, HIGH);
 
-  #ifdef ESP32
-    taskEXIT_CRITICAL(&bisscMutex);
-  #elif defined(__TEENSYDUINO__)
-    interrupts();
-  #endif
+    #ifdef ESP32
+      taskEXIT_CRITICAL(&bisscMutex);
+    #elif defined(__TEENSYDUINO__)
+      interrupts();
+    #endif
+  }
 
   // trap errors
   int16_t errors = 0;
@@ -136,6 +152,7 @@ IRAM_ATTR bool As37h39bb::readEnc(uint32_t &position) {
 
   if (crc6(encData) != as37Crc) {
     bad++;
+    counters.increment(crcCounter);
     VF("WRN: Encoder AS37_H39B_B"); V(axis); VF(", Crc invalid (overall "); V(((float)bad/good)*100.0F); V('%'); VLF(")"); errors++;
   } else {
     good++;
@@ -146,6 +163,7 @@ IRAM_ATTR bool As37h39bb::readEnc(uint32_t &position) {
   }
 
   if (errors > 0) {
+    counters.increment(errorCounter);
     if (errors <= 2) warn = true; else error = true;
     return false;
   }
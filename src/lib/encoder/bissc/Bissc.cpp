@@ -4,10 +4,45 @@
 
 #ifdef HAS_BISS_C
 
+#include "../../counters/Counters.h"
+
+#if BISSC_SPI != OFF
+  #include <SPI.h>
+#endif
+
 // get device ready for use
 void Bissc::init() {
   if (initialized) { VF("WRN: Encoder BiSS-C"); V(axis); VLF(" init(), already initialized!"); return; }
 
+  // all BiSS-C encoders share the counters
+  crcCounter = counters.add("EncCrc");
+  errorCounter = counters.add("EncErr");
+
+  #if BISSC_SPI != OFF
+    if (axis == BISSC_SPI) {
+      #if defined(ESP32)
+        SPI.begin(maPin, sloPin, -1, -1);
+        useSpi = true;
+      #elif defined(__TEENSYDUINO__)
+        SPI.setSCK(maPin);
+        SPI.setMISO(sloPin);
+        SPI.begin();
+        useSpi = true;
+      #else
+        if (maPin == SCK && sloPin == MISO) {
+          SPI.begin();
+          useSpi = true;
+        }
+      #endif
+      if (useSpi) {
+        VF("MSG: Encoder BiSS-C"); V(axis); VLF(", using hardware SPI");
+        initialized = true;
+        return;
+      }
+      VF("WRN: Encoder BiSS-C"); V(axis); VLF(", MA/SLO aren't the SPI SCK/MISO pins falling back to bit-bang");
+    }
+  #endif
+
   pinMode(maPin, OUTPUT);
   digitalWriteF(maPin, LOW);
   pinMode(sloPin, INPUT_PULLUP);
@@ -56,6 +91,40 @@ void Bissc::write(int32_t count) {
   }
 }
 
+#if BISSC_SPI != OFF
+  static inline uint8_t frameBit(const uint8_t *frame, int bit) { return (frame[bit >> 3] >> (7 - (bit & 7))) & 1; }
+
+  // read a frame by hardware SPI, the clock idles high (MA) and SLO is sampled on the falling edge
+  // the SPI hardware times the whole frame so interrupts are left enabled
+  IRAM_ATTR void Bissc::readFrameSpi(uint64_t &data, uint8_t bits, bool &foundAck, bool &foundStart, bool &foundCds) {
+    uint8_t frame[BISSC_SPI_FRAME_BYTES];
+    memset(frame, 0xFF, sizeof(frame));
+
+    SPI.beginTransaction(SPISettings(BISSC_CLOCK_RATE_KHZ*1000UL, MSBFIRST, SPI_MODE2));
+    SPI.transfer(frame, sizeof(frame));
+    SPI.endTransaction();
+
+    const int frameBits = BISSC_SPI_FRAME_BYTES*8;
+    int bit = 0;
+
+    data = 0;
+    foundAck = false;
+    foundStart = false;
+    foundCds = false;
+
+    for (int i = 0; i < 20; i++) { if (frameBit(frame, bit++) == 0) { foundAck = true; break; } }
+    if (!foundAck) return;
+
+    for (int i = 0; i < 20; i++) { if (frameBit(frame, bit++) == 1) { foundStart = true; break; } }
+    if (!foundStart) return;
+
+    if (frameBit(frame, bit++) != 0 || bit + bits > frameBits) return;
+    foundCds = true;
+
+    for (int i = 0; i < bits; i++) data = (data << 1) | frameBit(frame, bit++);
+  }
+#endif
+
 // read encoder count with (1 second) error recovery
 bool Bissc::readEncLatest(uint32_t &position) {
   uint32_t temp = position;
@@ -12,6 +12,14 @@
     #define BISSC_CLOCK_RATE_KHZ 4000
   #endif
 
+  // axis number (1 to 9) whose BiSS-C encoder is read by hardware SPI (MA on SCK, SLO on MISO) or OFF to bit-bang all of them
+  #ifndef BISSC_SPI
+    #define BISSC_SPI OFF
+  #endif
+
+  // bits captured per hardware SPI frame, enough for 20 Ack, 20 Start, Cds, and up to 55 data bits
+  #define BISSC_SPI_FRAME_BYTES 12
+
   // default to single turn mode
   #ifndef BISSC_SINGLE
     #define BISSC_SINGLE_TURN ON
@@ -38,8 +46,19 @@
       // read encoder position
       virtual bool readEnc(uint32_t &position);
 
+      #if BISSC_SPI != OFF
+        // read a frame by hardware SPI and decode the Ack, Start, Cds bits then the data bits (msb first) that follow
+        void readFrameSpi(uint64_t &data, uint8_t bits, bool &foundAck, bool &foundStart, bool &foundCds);
+
+        bool useSpi = false;
+      #endif
+
       uint32_t good = 0;
       uint32_t bad = 0;
+
+      // health counters for frames with a bad CRC, and for all frames rejected
+      uint8_t crcCounter = 0;
+      uint8_t errorCounter = 0;
       int16_t axis;
       uint16_t nvAddress = 0;
 
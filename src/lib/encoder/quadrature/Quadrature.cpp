@@ -185,6 +185,7 @@ ICACHE_RAM_ATTR void Quadrature::A(const int16_t pin) {
     case 0b1111: dir = 0; error = true; break; // skipped pulse use last dir (way too fast if this is happening)
   }
   count += dir;
+  if (dir != 0) edge(dir);
   
   lastA = stateA;
   lastB = stateB;
@@ -214,6 +215,7 @@ ICACHE_RAM_ATTR void Quadrature::B(const int16_t pin) {
     case 0b1111: dir = 0; error = true; break;
   }
   count += dir;
+  if (dir != 0) edge(dir);
   
   lastA = stateA;
   lastB = stateB;
@@ -5,7 +5,8 @@
 
 #if AXIS1_ENCODER == AB_ESP32 || AXIS2_ENCODER == AB_ESP32 || AXIS3_ENCODER == AB_ESP32 || \
     AXIS4_ENCODER == AB_ESP32 || AXIS5_ENCODER == AB_ESP32 || AXIS6_ENCODER == AB_ESP32 || \
-    AXIS7_ENCODER == AB_ESP32 || AXIS8_ENCODER == AB_ESP32 || AXIS9_ENCODER == AB_ESP32
+    AXIS7_ENCODER == AB_ESP32 || AXIS8_ENCODER == AB_ESP32 || AXIS9_ENCODER == AB_ESP32 || \
+    AXIS1_MOTOR_ENCODER == AB_ESP32 || AXIS2_MOTOR_ENCODER == AB_ESP32
 
 #include <ESP32Encoder.h> // https://github.com/madhephaestus/ESP32Encoder/tree/master
 
@@ -0,0 +1,95 @@
+// A/B Quadrature encoders (STM32 hardware timer encoder mode decode)
+
+#include "QuadratureStm32.h"
+
+#if AXIS1_ENCODER == AB_STM32 || AXIS2_ENCODER == AB_STM32 || AXIS3_ENCODER == AB_STM32 || \
+    AXIS4_ENCODER == AB_STM32 || AXIS5_ENCODER == AB_STM32 || AXIS6_ENCODER == AB_STM32 || \
+    AXIS7_ENCODER == AB_STM32 || AXIS8_ENCODER == AB_STM32 || AXIS9_ENCODER == AB_STM32 || \
+    AXIS1_MOTOR_ENCODER == AB_STM32 || AXIS2_MOTOR_ENCODER == AB_STM32
+
+// for example:
+// QuadratureStm32 encoder1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+
+QuadratureStm32::QuadratureStm32(int16_t APin, int16_t BPin, int16_t axis) {
+  if (axis < 1 || axis > 9) return;
+  this->axis = axis;
+  this->APin = APin;
+  this->BPin = BPin;
+}
+
+void QuadratureStm32::init() {
+  if (initialized) { VF("WRN: Encoder QuadratureStm32"); V(axis); VLF(" init(), already initialized!"); return; }
+
+  // both pins must map to channels 1 and 2 of the same timer
+  PinName a = digitalPinToPinName(APin);
+  PinName b = digitalPinToPinName(BPin);
+  TIM_TypeDef *instance = (TIM_TypeDef*)pinmap_peripheral(a, PinMap_TIM);
+  if (instance == NP || instance != (TIM_TypeDef*)pinmap_peripheral(b, PinMap_TIM) ||
+      STM_PIN_CHANNEL(pinmap_function(a, PinMap_TIM)) != 1 || STM_PIN_CHANNEL(pinmap_function(b, PinMap_TIM)) != 2) {
+    VF("ERR: Encoder QuadratureStm32"); V(axis); VLF(" init(), A/B pins aren't channel 1/2 of a timer!");
+    return;
+  }
+
+  pinmap_pinout(a, PinMap_TIM);
+  pinmap_pinout(b, PinMap_TIM);
+
+  memset(&handle, 0, sizeof(handle));
+  handle.Instance = instance;
+  handle.Init.Prescaler = 0;
+  handle.Init.CounterMode = TIM_COUNTERMODE_UP;
+  handle.Init.Period = 0xFFFF;
+  handle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  handle.Init.RepetitionCounter = 0;
+  enableTimerClock(&handle);
+
+  // count on both edges of both channels (x4)
+  TIM_Encoder_InitTypeDef config;
+  memset(&config, 0, sizeof(config));
+  config.EncoderMode = TIM_ENCODERMODE_TI12;
+  config.IC1Polarity = TIM_ICPOLARITY_RISING;
+  config.IC1Selection = TIM_ICSELECTION_DIRECTTI;
+  config.IC1Prescaler = TIM_ICPSC_DIV1;
+  config.IC1Filter = QUADRATURE_STM32_FILTER;
+  config.IC2Polarity = TIM_ICPOLARITY_RISING;
+  config.IC2Selection = TIM_ICSELECTION_DIRECTTI;
+  config.IC2Prescaler = TIM_ICPSC_DIV1;
+  config.IC2Filter = QUADRATURE_STM32_FILTER;
+
+  if (HAL_TIM_Encoder_Init(&handle, &config) != HAL_OK || HAL_TIM_Encoder_Start(&handle, TIM_CHANNEL_ALL) != HAL_OK) {
+    VF("ERR: Encoder QuadratureStm32"); V(axis); VLF(" init(), timer encoder mode start failed!");
+    return;
+  }
+
+  lastCounter = __HAL_TIM_GET_COUNTER(&handle);
+  position = 0;
+
+  initialized = true;
+}
+
+// the timer counter is 16 bits, it's extended to 32 bits here so this must be
+// called before the encoder moves 32767 counts (i.e. every 10ms for 3.2M counts/s)
+int32_t QuadratureStm32::read() {
+  if (!initialized) { VF("WRN: Encoder QuadratureStm32"); V(axis); VLF(" read(), not initialized!"); return 0; }
+
+  noInterrupts();
+  uint16_t counter = __HAL_TIM_GET_COUNTER(&handle);
+  position += (int16_t)(counter - lastCounter);
+  lastCounter = counter;
+  count = position;
+  interrupts();
+
+  return count + origin;
+}
+
+void QuadratureStm32::write(int32_t count) {
+  if (!initialized) { VF("WRN: Encoder QuadratureStm32"); V(axis); VLF(" write(), not initialized!"); return; }
+
+  count -= origin;
+
+  noInterrupts();
+  lastCounter = __HAL_TIM_GET_COUNTER(&handle);
+  position = count;
+  interrupts();
+}
+
+#endif
@@ -0,0 +1,41 @@
+// A/B Quadrature encoders (STM32 hardware timer encoder mode decode)
+#pragma once
+
+#include "../Encoder.h"
+
+#if AXIS1_ENCODER == AB_STM32 || AXIS2_ENCODER == AB_STM32 || AXIS3_ENCODER == AB_STM32 || \
+    AXIS4_ENCODER == AB_STM32 || AXIS5_ENCODER == AB_STM32 || AXIS6_ENCODER == AB_STM32 || \
+    AXIS7_ENCODER == AB_STM32 || AXIS8_ENCODER == AB_STM32 || AXIS9_ENCODER == AB_STM32 || \
+    AXIS1_MOTOR_ENCODER == AB_STM32 || AXIS2_MOTOR_ENCODER == AB_STM32
+
+#ifndef ARDUINO_ARCH_STM32
+  #error "Configuration (Config.h): AB_STM32 encoders are only supported on STM32 processors"
+#endif
+
+// input capture filter (0 to 15) applied to the A and B timer channels
+#ifndef QUADRATURE_STM32_FILTER
+  #define QUADRATURE_STM32_FILTER 4
+#endif
+
+// for example:
+// QuadratureStm32 encoder1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+// the A and B pins must be channel 1 and 2 of the same timer (TIM1, TIM2, TIM3, etc.)
+
+class QuadratureStm32 : public Encoder {
+  public:
+    QuadratureStm32(int16_t APin, int16_t BPin, int16_t axis);
+    void init();
+
+    int32_t read();
+    void write(int32_t count);
+
+  private:
+    int16_t APin = OFF;
+    int16_t BPin = OFF;
+
+    TIM_HandleTypeDef handle;
+    uint16_t lastCounter = 0;
+    int32_t position = 0;
+};
+
+#endif
@@ -0,0 +1,58 @@
+// A/B Quadrature encoders (Teensy 4 hardware quadrature decoder)
+
+#include "QuadratureTeensy4.h"
+
+#if AXIS1_ENCODER == AB_TEENSY4 || AXIS2_ENCODER == AB_TEENSY4 || AXIS3_ENCODER == AB_TEENSY4 || \
+    AXIS4_ENCODER == AB_TEENSY4 || AXIS5_ENCODER == AB_TEENSY4 || AXIS6_ENCODER == AB_TEENSY4 || \
+    AXIS7_ENCODER == AB_TEENSY4 || AXIS8_ENCODER == AB_TEENSY4 || AXIS9_ENCODER == AB_TEENSY4 || \
+    AXIS1_MOTOR_ENCODER == AB_TEENSY4 || AXIS2_MOTOR_ENCODER == AB_TEENSY4
+
+// for example:
+// QuadratureTeensy4 encoder1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+
+uint8_t QuadratureTeensy4::channelsUsed = 0;
+
+QuadratureTeensy4::QuadratureTeensy4(int16_t APin, int16_t BPin, int16_t axis) {
+  if (axis < 1 || axis > 9) return;
+  this->axis = axis;
+  this->APin = APin;
+  this->BPin = BPin;
+}
+
+void QuadratureTeensy4::init() {
+  if (initialized) { VF("WRN: Encoder QuadratureTeensy4"); V(axis); VLF(" init(), already initialized!"); return; }
+
+  // each encoder uses the next free ENC1 to ENC4 decoder
+  if (channelsUsed >= 4) { VF("ERR: Encoder QuadratureTeensy4"); V(axis); VLF(" init(), no free decoder!"); return; }
+
+  ab = new QuadEncoder(channelsUsed + 1, APin, BPin, 0);
+  if (ab == NULL) {
+    VF("ERR: Encoder QuadratureTeensy4"); V(axis); VLF(" init(), didn't get instance!"); 
+    return;
+  }
+  channelsUsed++;
+
+  ab->setInitConfig();
+  ab->init();
+  ab->write(0);
+
+  initialized = true;
+}
+
+int32_t QuadratureTeensy4::read() {
+  if (!initialized) { VF("WRN: Encoder QuadratureTeensy4"); V(axis); VLF(" read(), not initialized!"); return 0; }
+
+  count = (int32_t)ab->read();
+
+  return count + origin;
+}
+
+void QuadratureTeensy4::write(int32_t count) {
+  if (!initialized) { VF("WRN: Encoder QuadratureTeensy4"); V(axis); VLF(" write(), not initialized!"); return; }
+
+  count -= origin;
+
+  ab->write((uint32_t)count);
+}
+
+#endif
@@ -0,0 +1,38 @@
+// A/B Quadrature encoders (Teensy 4 hardware quadrature decoder)
+#pragma once
+
+#include "../Encoder.h"
+
+#if AXIS1_ENCODER == AB_TEENSY4 || AXIS2_ENCODER == AB_TEENSY4 || AXIS3_ENCODER == AB_TEENSY4 || \
+    AXIS4_ENCODER == AB_TEENSY4 || AXIS5_ENCODER == AB_TEENSY4 || AXIS6_ENCODER == AB_TEENSY4 || \
+    AXIS7_ENCODER == AB_TEENSY4 || AXIS8_ENCODER == AB_TEENSY4 || AXIS9_ENCODER == AB_TEENSY4 || \
+    AXIS1_MOTOR_ENCODER == AB_TEENSY4 || AXIS2_MOTOR_ENCODER == AB_TEENSY4
+
+#if !defined(__IMXRT1062__)
+  #error "Configuration (Config.h): AB_TEENSY4 encoders are only supported on Teensy 4.0 and 4.1"
+#endif
+
+#include <QuadEncoder.h> // https://github.com/mjs513/Teensy-4.x-Quad-Encoder-Library
+
+// for example:
+// QuadratureTeensy4 encoder1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+// the A and B pins must be XBAR capable (0 to 8, 30 to 33, and 36 to 37) and at most four are available
+
+class QuadratureTeensy4 : public Encoder {
+  public:
+    QuadratureTeensy4(int16_t APin, int16_t BPin, int16_t axis);
+    void init();
+
+    int32_t read();
+    void write(int32_t count);
+
+    QuadEncoder *ab;
+
+  private:
+    int16_t APin = OFF;
+    int16_t BPin = OFF;
+
+    static uint8_t channelsUsed;
+};
+
+#endif
@@ -24,17 +24,114 @@ SerialBridge::SerialBridge(int16_t axis) {
   this->channel[0] = '1' + axis;
 }
 
+void serialBridgeBegin() {
+  if (_serial_bridge_initialized) return;
+
+  #if defined(SERIAL_ENCODER_RX) && defined(SERIAL_ENCODER_TX) && !defined(SERIAL_ENCODER_RXTX_SET)
+    SERIAL_ENCODER.begin(SERIAL_ENCODER_BAUD, SERIAL_8N1, SERIAL_ENCODER_RX, SERIAL_ENCODER_TX);
+  #else
+    SERIAL_ENCODER.begin(SERIAL_ENCODER_BAUD);
+  #endif
+  delay(100);
+  _serial_bridge_initialized = true;
+}
+
+#if SERIAL_ENCODER_BINARY == ON
+  // latest decoded frame, shared by all axes
+  volatile int32_t _serial_bridge_counts[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+  uint8_t _serial_bridge_axes = 0;
+  uint8_t _serial_bridge_sequence = 0;
+  uint32_t _serial_bridge_time = 0;
+  uint32_t _serial_bridge_frame_micros = 0;
+  unsigned long _serial_bridge_frame_millis = 0;
+  unsigned long _serial_bridge_start_millis = 0;
+  bool _serial_bridge_dropped = false;
+
+  // CRC-8, polynomial x^8 + x^2 + x + 1
+  static uint8_t serialBridgeCrc8(const uint8_t *data, uint8_t length) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < length; i++) {
+      crc ^= data[i];
+      for (uint8_t j = 0; j < 8; j++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+  }
+
+  static int32_t serialBridgeInt32(const uint8_t *data) {
+    return (int32_t)((uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+  }
+
+  // decode any waiting bytes without blocking, keeps the latest valid frame
+  void serialBridgePoll() {
+    static uint8_t frame[SERIAL_ENCODER_FRAME_MAX];
+    static uint8_t index = 0;
+    static uint8_t length = 0;
+
+    // ask the bridge to (re)start streaming if frames stop arriving
+    if ((long)(millis() - _serial_bridge_start_millis) > 1000 && (long)(millis() - _serial_bridge_frame_millis) > 1000) {
+      SERIAL_ENCODER.print("B"); SERIAL_ENCODER.print(SERIAL_ENCODER_RATE); SERIAL_ENCODER.print('\r');
+      _serial_bridge_start_millis = millis();
+    }
+
+    int available = SERIAL_ENCODER.available();
+    while (available-- > 0) {
+      uint8_t b = SERIAL_ENCODER.read();
+
+      if (index == 0) { if (b == SERIAL_ENCODER_SYNC1) frame[index++] = b; continue; }
+      if (index == 1) { if (b == SERIAL_ENCODER_SYNC2) frame[index++] = b; else index = (b == SERIAL_ENCODER_SYNC1); continue; }
+      if (index == 2) {
+        if (b < 1 || b > 9) { index = 0; continue; }
+        length = 2 + 1 + 1 + 4 + b*4 + 1;
+      }
+
+      frame[index++] = b;
+      if (index < length) continue;
+      index = 0;
+
+      if (serialBridgeCrc8(&frame[2], length - 3) != frame[length - 1]) continue;
+
+      // a gap in the sequence numbers means frames were lost
+      if (_serial_bridge_axes != 0 && (uint8_t)(frame[3] - _serial_bridge_sequence) != 1) _serial_bridge_dropped = true;
+
+      uint8_t axes = frame[2];
+      noInterrupts();
+      for (uint8_t i = 0; i < axes; i++) _serial_bridge_counts[i] = serialBridgeInt32(&frame[8 + i*4]);
+      interrupts();
+      _serial_bridge_axes = axes;
+      _serial_bridge_sequence = frame[3];
+      _serial_bridge_time = (uint32_t)serialBridgeInt32(&frame[4]);
+      _serial_bridge_frame_micros = micros();
+      _serial_bridge_frame_millis = millis();
+    }
+  }
+#endif
+
 int32_t SerialBridge::read() {
   if (!initialized) { VF("WRN: Encoder SerialBridge"); V(axis); VLF(" read(), not initialized!"); return 0; }
 
-  if (millis() - lastReadMillis > 10) {
+  #if SERIAL_ENCODER_BINARY == ON
     count = raw();
-    lastReadMillis = millis();
-  }
+  #else
+    if (millis() - lastReadMillis > 10) {
+      count = raw();
+      lastReadMillis = millis();
+    }
+  #endif
 
   return count + offset;
 }
 
+#if SERIAL_ENCODER_BINARY == ON
+  // get current position with the time its frame arrived
+  EncoderSample SerialBridge::readLatched() {
+    EncoderSample sample;
+    sample.count = read();
+    sample.time = _serial_bridge_frame_micros;
+    updateVelocity(sample);
+    return sample;
+  }
+#endif
+
 void SerialBridge::write(int32_t count) {
   if (!initialized) { VF("WRN: Encoder SerialBridge"); V(axis); VLF(" write(), not initialized!"); return; }
 
@@ -42,37 +139,42 @@ void SerialBridge::write(int32_t count) {
 }
 
 int32_t SerialBridge::raw() {
-  if (!_serial_bridge_initialized) {
-    #if defined(SERIAL_ENCODER_RX) && defined(SERIAL_ENCODER_TX) && !defined(SERIAL_ENCODER_RXTX_SET)
-      SERIAL_ENCODER.begin(SERIAL_ENCODER_BAUD, SERIAL_8N1, SERIAL_ENCODER_RX, SERIAL_ENCODER_TX);
-    #else
-      SERIAL_ENCODER.begin(SERIAL_ENCODER_BAUD);
-    #endif
-    delay(100);
-    _serial_bridge_initialized = true;
-  }
+  serialBridgeBegin();
+
+  #if SERIAL_ENCODER_BINARY == ON
+    serialBridgePoll();
 
-  SERIAL_ENCODER.print(channel);
+    // hold the last count if frames stop arriving
+    if ((long)(millis() - _serial_bridge_frame_millis) > SERIAL_ENCODER_TIMEOUT || axis > _serial_bridge_axes) error = true;
+    if (_serial_bridge_dropped) warn = true;
+
+    noInterrupts();
+    int32_t counts = _serial_bridge_counts[axis - 1];
+    interrupts();
+    return counts + origin;
+  #else
+    SERIAL_ENCODER.print(channel);
   
-  char c;
-  char result[32] = "";
-  int index = 0;
-  unsigned long start = millis();
-  do {
-    if (SERIAL_ENCODER.available()) c = SERIAL_ENCODER.read(); else c = 'x';
-    if ((c >= '0' && c <= '9') || c == '-') {
-      result[index++] = c;
-      result[index] = 0;
+    char c;
+    char result[32] = "";
+    int index = 0;
+    unsigned long start = millis();
+    do {
+      if (SERIAL_ENCODER.available()) c = SERIAL_ENCODER.read(); else c = 'x';
+      if ((c >= '0' && c <= '9') || c == '-') {
+        result[index++] = c;
+        result[index] = 0;
+      }
+    } while (c != 13 && (millis() - start) < 4 && index < 16);
+
+    if (strlen(result) > 0) {
+      return atoi(result) + origin;
+    } else {
+      VLF("WRN: SerialBridge raw(), timed out!");
+      error = true;
+      return 0  + origin;
     }
-  } while (c != 13 && (millis() - start) < 4 && index < 16);
-
-  if (strlen(result) > 0) {
-    return atoi(result) + origin;
-  } else {
-    VLF("WRN: SerialBridge raw(), timed out!");
-    error = true;
-    return 0  + origin;
-  }
-} 
+  #endif
+}
 
 #endif
@@ -11,12 +11,36 @@
   #define SERIAL_ENCODER_BAUD 460800
 #endif
 
+// ON streams all axes from the bridge in binary frames, OFF polls each axis with ASCII commands
+#ifndef SERIAL_ENCODER_BINARY
+  #define SERIAL_ENCODER_BINARY OFF
+#endif
+#ifndef SERIAL_ENCODER_RATE
+  #define SERIAL_ENCODER_RATE 500     // binary frames per second requested from the bridge
+#endif
+#ifndef SERIAL_ENCODER_TIMEOUT
+  #define SERIAL_ENCODER_TIMEOUT 50   // in milliseconds without a valid binary frame before an error
+#endif
+
+// binary streaming, the bridge is started with "B[rate]<CR>" and then pushes frames of:
+//   0xA5 0x5A, axes n (1 to 9), sequence (uint8), bridge time in microseconds (uint32),
+//   n counts (int32), CRC-8 (poly 0x07) of everything after the sync bytes
+// multi-byte values are little-endian
+#define SERIAL_ENCODER_SYNC1 0xA5
+#define SERIAL_ENCODER_SYNC2 0x5A
+#define SERIAL_ENCODER_FRAME_MAX (2 + 1 + 1 + 4 + 9*4 + 1)
+
 class SerialBridge : public Encoder {
   public:
     SerialBridge(int16_t axis);
     int32_t read();
     void write(int32_t count);
 
+    #if SERIAL_ENCODER_BINARY == ON
+      // get current position with the time its frame arrived
+      EncoderSample readLatched();
+    #endif
+
   private:
     int32_t raw();
 
@@ -43,6 +43,14 @@ bool EthernetManager::init() {
       active = true;
     }
 
+    #ifndef ESP8266
+      // the Ethernet library only uses as many sockets as it was built for
+      if (MAX_SOCK_NUM < ETHERNET_SOCKETS) { DF("WRN: Ethernet, library limited to "); D(MAX_SOCK_NUM); DF(" of "); D(ETHERNET_SOCKETS); DLF(" sockets"); }
+      #if OPERATIONAL_MODE == ETHERNET_W5500
+        if (Ethernet.hardwareStatus() != EthernetW5500) { DLF("WRN: Ethernet, W5500 not found"); }
+      #endif
+    #endif
+
     VLF("MSG: Ethernet, initialized");
   }
   return active;
@@ -18,6 +18,21 @@
 #ifndef COMMAND_SERVER
 #define COMMAND_SERVER OFF
 #endif
+// hardware sockets shared by every server port and client session (each port listens on one, each client holds one)
+#ifndef ETHERNET_SOCKETS
+  #if OPERATIONAL_MODE == ETHERNET_W5500
+    #define ETHERNET_SOCKETS 8            // the W5500 has 8 sockets and 32KB of buffers
+  #else
+    #define ETHERNET_SOCKETS 4            // the W5100 has 4 sockets and 16KB of buffers
+  #endif
+#endif
+#ifndef COMMAND_SERVER_CLIENTS
+  #if ETHERNET_SOCKETS >= 8 && COMMAND_SERVER == STANDARD
+    #define COMMAND_SERVER_CLIENTS 5      // concurrent client sessions, leaves port 9999's listener and the web server two sockets
+  #else
+    #define COMMAND_SERVER_CLIENTS 3      // concurrent client sessions on each command server port
+  #endif
+#endif
 
 // optional Arduino Serial class work-alike IP channels 9996 to 9999 as a server (listens to clients)
 // OFF or STANDARD (port 9999), or PERSISTENT (ports 9996 to 9998), or BOTH
@@ -25,6 +40,14 @@
 #define SERIAL_SERVER OFF                    // SERIAL_SIP, SERIAL_PIP1, etc.
 #endif
 
+// optional WebSocket command channel (one client, LX200 commands and the status stream) for browser apps
+#ifndef SERIAL_WEBSOCKET
+#define SERIAL_WEBSOCKET OFF              // ON for SERIAL_WS
+#endif
+#ifndef SERIAL_WEBSOCKET_PORT
+#define SERIAL_WEBSOCKET_PORT 81          // WebSocket port
+#endif
+
 // optional Arduino Serial class work-alike IP channel to port 9998 as a client (connects to a server)
 #ifndef SERIAL_CLIENT
 #define SERIAL_CLIENT OFF                    // ON for SERIAL_IP at port 9998
@@ -35,24 +35,41 @@
       int handler_number = -1;
       lastMethod = HTTP_UNKNOWN;
 
+      // the request is read a block at a time, each read or available() from the chip is an SPI transaction
+      uint8_t rx[WEB_RX_BLOCK_SIZE];
+      int rxPos = 0;
+      int rxCount = 0;
+
       unsigned long to = millis() + WEB_SOCKET_TIMEOUT;
       while (client.connected() && (long)(millis() - to) < 0 && currentSection <= 2) {
-        if (client.available()) {
+        if (rxPos >= rxCount) {
+          rxPos = 0;
+          rxCount = client.available();
+          if (rxCount > WEB_RX_BLOCK_SIZE) rxCount = WEB_RX_BLOCK_SIZE;
+          if (rxCount > 0) rxCount = client.read(rx, rxCount);
+          if (rxCount < 0) rxCount = 0;
+        }
+
+        if (rxPos < rxCount) {
           // read in a char
-          char c = client.read(); if (c == '\r') continue;
+          char c = rx[rxPos++]; if (c == '\r') continue;
 
           // build up ea. line
           if (line.length() <= 1024) line += c;
 
           // loop until an entire line is present
-          if (c != '\n' && client.available()) continue;
+          if (c != '\n' && (rxPos < rxCount || client.available())) continue;
 
           // look for end of sections
-          if (line.equals("\n")) { line = ""; currentSection++; continue; }
+          if (line.equals("\n")) { line = ""; currentSection++; if (lastMethod == HTTP_GET) break; continue; }
 
           // scan the header
           if (currentSection == 1) {
             if (!modifiedSinceFound && line.indexOf("If-Modified-Since:") >= 0) modifiedSinceFound = true;
+            if (line.startsWith("If-None-Match:")) {
+              String tag = line.substring(14); tag.trim();
+              strncpy(noneMatchTag, tag.c_str(), sizeof(noneMatchTag) - 1); noneMatchTag[sizeof(noneMatchTag) - 1] = 0;
+            }
             if (lastMethod == HTTP_UNKNOWN) {
               int index = line.indexOf("GET ");
               if (index >= 0) {
@@ -60,7 +77,6 @@
                 line = line.substring(index + 4);
                 handler_number = getHandler(&line);
                 if (handler_number >= 0) processGet(&line);
-                break;
               } else {
                 index = line.indexOf("POST ");
                 if (index >= 0) {
@@ -120,6 +136,7 @@
       if (autoReset) webServer->begin();
 
       modifiedSinceFound = false;
+      noneMatchTag[0] = 0;
   
       WL("MSG: Webserver, client disconnected");
     }
@@ -330,6 +347,14 @@
     client.print(s);
   }
 
+  void WebServer::sendContent(const uint8_t *data, size_t length) {
+    while (length > 0) {
+      size_t sent = client.write(data, length);
+      if (sent == 0) { if (!client.connected()) return; Y; continue; }
+      data += sent; length -= sent;
+    }
+  }
+
   WebServer www;
 
 #endif
@@ -33,6 +33,9 @@
   #ifndef WEB_HANDLER_COUNT_MAX
   #define WEB_HANDLER_COUNT_MAX  24
   #endif
+  #ifndef WEB_RX_BLOCK_SIZE
+  #define WEB_RX_BLOCK_SIZE      64
+  #endif
   #define PARAMETER_COUNT_MAX    12
   #define CONTENT_LENGTH_UNKNOWN -1
   #define CONTENT_LENGTH_NOT_SET -2
@@ -74,12 +77,16 @@
       // return modified since state
       bool modifiedSince() { return modifiedSinceFound; }
 
+      // return the If-None-Match entity tag, or "" if none was sent
+      const char *ifNoneMatch() { return noneMatchTag; }
+
       void setContentLength(long length);
       void setResponseHeader(const char *str);
       void sendHeader(const char* key, const char* val, bool first = false);
       void send(int code, const char* content_type = "text/html", const String& content = "");
       void sendContent(String s);
       void sendContent(const char * s);
+      void sendContent(const uint8_t *data, size_t length);
 
       EthernetServer *webServer = NULL;
       EthernetClient client;
@@ -91,6 +98,7 @@
  
       char responseHeader[200] = "";
       bool modifiedSinceFound = false;
+      char noneMatchTag[40] = "";
   
       webFunction notFoundHandler = NULL;
       webFunction handlers[WEB_HANDLER_COUNT_MAX];
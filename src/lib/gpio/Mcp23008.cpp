@@ -11,6 +11,13 @@
 
 #include "../tasks/OnTask.h"
 
+// how often outputs are written (only if changed) and inputs are read
+#ifndef GPIO_POLL_PERIOD_MS
+  #define GPIO_POLL_PERIOD_MS 10
+#endif
+
+void mcp23008Wrapper() { gpio.poll(); }
+
 // needs: https://github.com/adafruit/Adafruit-MCP23017-Arduino-Library and https://github.com/adafruit/Adafruit_BusIO
 #include "Adafruit_MCP23X08.h"
 Adafruit_MCP23X08 mcp;
@@ -26,6 +33,12 @@ bool Mcp23008::init() {
   } else { found = false; DF("WRN: Gpio.init(), MCP23008 (I2C 0x"); if (DEBUG != OFF) SERIAL_DEBUG.print(GPIO_MCP23008_I2C_ADDRESS, HEX); DLF(") not found"); }
   HAL_Wire.setClock(HAL_WIRE_CLOCK);
 
+  if (found) {
+    VF("MSG: Gpio, start MCP23008 poll task (rate "); V(GPIO_POLL_PERIOD_MS); VF("ms priority 6)... ");
+    if (tasks.add(GPIO_POLL_PERIOD_MS, 0, true, 6, mcp23008Wrapper, "GpioPol")) { VLF("success"); } else { VLF("FAILED!"); }
+  }
+
+  initialized = true;
   return found;
 }
 
@@ -48,14 +61,22 @@ void Mcp23008::pinMode(int pin, int mode) {
     #endif
     mcp.pinMode(pin, mode);
     this->mode[pin] = mode;
+    if (mode == OUTPUT) inputMask &= ~(1 << pin); else inputMask |= (1 << pin);
+    dirty = true;
   }
 }
 
-// one eight channel MCP23008 GPIO is supported, this gets the last set value
+// write any changed outputs and read all inputs, one I2C transaction each
+void Mcp23008::poll() {
+  if (dirty) { dirty = false; mcp.writeGPIO(outputs); }
+  if (inputMask) inputs = mcp.readGPIO();
+}
+
+// one eight channel MCP23008 GPIO is supported, this gets the last value read or set
 int Mcp23008::digitalRead(int pin) {
   if (found && pin >= 0 && pin <= 7) {
     if (mode[pin] == INPUT || mode[pin] == INPUT_PULLUP) {
-      return mcp.digitalRead(pin);
+      return (inputs >> pin) & 1;
     } else return state[pin]; 
   } else return 0;
 }
@@ -65,9 +86,12 @@ void Mcp23008::digitalWrite(int pin, bool value) {
   if (found && pin >= 0 && pin <= 7) {
     state[pin] = value;
     if (mode[pin] == OUTPUT) {
-      mcp.digitalWrite(pin, value);
+      // only a change is written, at the next poll along with any others
+      uint8_t bit = (uint8_t)1 << pin;
+      if (((outputs & bit) != 0) != value) { if (value) outputs |= bit; else outputs &= ~bit; dirty = true; }
     } else {
-      if (value == HIGH) pinMode(pin, INPUT_PULLUP); else pinMode(pin, INPUT);
+      int pullMode = value == HIGH ? INPUT_PULLUP : INPUT;
+      if (mode[pin] != pullMode) pinMode(pin, pullMode);
     }
   } else return;
 }
@@ -18,6 +18,9 @@ class Mcp23008 {
 
     void pinMode(int pin, int mode);
 
+    // write any changed outputs and read all inputs, one I2C transaction each
+    void poll();
+
     // one eight channel MCP23008 GPIO is supported, this gets the last set value
     int digitalRead(int pin);
 
@@ -27,6 +30,12 @@ class Mcp23008 {
   private:
     bool found = false;
 
+    // shadow registers, bit n is pin n
+    uint8_t outputs = 0;
+    uint8_t inputs = 0;
+    uint8_t inputMask = (uint8_t)-1;
+    bool dirty = false;
+
     int mode[8] = { INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT };
     bool state[8] = { false, false, false, false, false, false, false, false };
 };
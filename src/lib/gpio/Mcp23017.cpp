@@ -11,6 +11,13 @@
 
 #include "../tasks/OnTask.h"
 
+// how often outputs are written (only if changed) and inputs are read
+#ifndef GPIO_POLL_PERIOD_MS
+  #define GPIO_POLL_PERIOD_MS 10
+#endif
+
+void mcp23017Wrapper() { gpio.poll(); }
+
 // needs: https://github.com/adafruit/Adafruit-MCP23017-Arduino-Library and https://github.com/adafruit/Adafruit_BusIO
 #include "Adafruit_MCP23X17.h"
 Adafruit_MCP23X17 mcp;
@@ -29,6 +36,12 @@ bool Mcp23017::init() {
   }
   HAL_Wire.setClock(HAL_WIRE_CLOCK);
 
+  if (found) {
+    VF("MSG: Gpio, start MCP23017 poll task (rate "); V(GPIO_POLL_PERIOD_MS); VF("ms priority 6)... ");
+    if (tasks.add(GPIO_POLL_PERIOD_MS, 0, true, 6, mcp23017Wrapper, "GpioPol")) { VLF("success"); } else { VLF("FAILED!"); }
+  }
+
+  initialized = true;
   return found;
 }
 
@@ -51,14 +64,22 @@ void Mcp23017::pinMode(int pin, int mode) {
     #endif
     mcp.pinMode(pin, mode);
     this->mode[pin] = mode;
+    if (mode == OUTPUT) inputMask &= ~(1 << pin); else inputMask |= (1 << pin);
+    dirty = true;
   }
 }
 
-// one sixteen channel MCP23017 GPIO is supported, this gets the last set value
+// write any changed outputs and read all inputs, one I2C transaction each
+void Mcp23017::poll() {
+  if (dirty) { dirty = false; mcp.writeGPIOAB(outputs); }
+  if (inputMask) inputs = mcp.readGPIOAB();
+}
+
+// one sixteen channel MCP23017 GPIO is supported, this gets the last value read or set
 int Mcp23017::digitalRead(int pin) {
   if (found && pin >= 0 && pin <= 15) {
     if (mode[pin] == INPUT || mode[pin] == INPUT_PULLUP) {
-      return mcp.digitalRead(pin);
+      return (inputs >> pin) & 1;
     } else return state[pin]; 
   } else return 0;
 }
@@ -68,9 +89,12 @@ void Mcp23017::digitalWrite(int pin, bool value) {
   if (found && pin >= 0 && pin <= 15) {
     state[pin] = value;
     if (mode[pin] == OUTPUT) {
-      mcp.digitalWrite(pin, value);
+      // only a change is written, at the next poll along with any others
+      uint16_t bit = (uint16_t)1 << pin;
+      if (((outputs & bit) != 0) != value) { if (value) outputs |= bit; else outputs &= ~bit; dirty = true; }
     } else {
-      if (value == HIGH) pinMode(pin, INPUT_PULLUP); else pinMode(pin, INPUT);
+      int pullMode = value == HIGH ? INPUT_PULLUP : INPUT;
+      if (mode[pin] != pullMode) pinMode(pin, pullMode);
     }
   } else return;
 }
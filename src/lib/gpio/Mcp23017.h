@@ -18,6 +18,9 @@ class Mcp23017 {
 
     void pinMode(int pin, int mode);
 
+    // write any changed outputs and read all inputs, one I2C transaction each
+    void poll();
+
     // one sixteen channel MCP23017 GPIO is supported, this gets the last set value
     int digitalRead(int pin);
 
@@ -27,6 +30,12 @@ class Mcp23017 {
   private:
     bool found = false;
 
+    // shadow registers, bit n is pin n
+    uint16_t outputs = 0;
+    uint16_t inputs = 0;
+    uint16_t inputMask = (uint16_t)-1;
+    bool dirty = false;
+
     int mode[16] = { INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT, INPUT };
     bool state[16] = { false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false };
 };
@@ -11,6 +11,13 @@
 
 #include "../tasks/OnTask.h"
 
+// how often outputs are written (only if changed) and inputs are read
+#ifndef GPIO_POLL_PERIOD_MS
+  #define GPIO_POLL_PERIOD_MS 10
+#endif
+
+void pcf8575Wrapper() { gpio.poll(); }
+
 #include <PCF8575.h> // https://www.arduino.cc/reference/en/libraries/pcf8575/
 
 PCF8575 pcf(GPIO_PCF8575_I2C_ADDRESS, &HAL_Wire); // might need to change this I2C Address?
@@ -25,6 +32,12 @@ bool Pcf8575::init() {
   } else { found = false; DF("WRN: Gpio.init(), PCF8575 (I2C 0x"); if (DEBUG != OFF) SERIAL_DEBUG.print(GPIO_PCF8575_I2C_ADDRESS, HEX); DLF(") not found"); }
   HAL_Wire.setClock(HAL_WIRE_CLOCK);
 
+  if (found) {
+    VF("MSG: Gpio, start PCF8575 poll task (rate "); V(GPIO_POLL_PERIOD_MS); VF("ms priority 6)... ");
+    if (tasks.add(GPIO_POLL_PERIOD_MS, 0, true, 6, pcf8575Wrapper, "GpioPol")) { VLF("success"); } else { VLF("FAILED!"); }
+  }
+
+  initialized = true;
   return found;
 }
 
@@ -48,14 +61,22 @@ void Pcf8575::pinMode(int pin, int mode) {
     if (mode == INPUT_PULLUP) mode = INPUT;
     // no pinMode() seems to exist for the PCF8575, I assume reading sets input mode and writing sets output mode automatically
     this->mode[pin] = mode;
+    if (mode == OUTPUT) inputMask &= ~(1 << pin); else inputMask |= (1 << pin);
+    dirty = true;
   }
 }
 
-// one sixteen channel Pcf8575 GPIO is supported, this gets the last set value
+// write any changed outputs and read all inputs, one I2C transaction each
+void Pcf8575::poll() {
+  if (dirty) { dirty = false; pcf.write16(outputs | inputMask); }
+  if (inputMask) inputs = pcf.read16();
+}
+
+// one sixteen channel Pcf8575 GPIO is supported, this gets the last value read or set
 int Pcf8575::digitalRead(int pin) {
   if (found && pin >= 0 && pin <= 15) {
     if (mode[pin] == INPUT || mode[pin] == INPUT_PULLUP) {
-      return pcf.read(pin);
+      return (inputs >> pin) & 1;
     } else return state[pin];
   } else return 0;
 }
@@ -65,9 +86,12 @@ void Pcf8575::digitalWrite(int pin, bool value) {
   if (found && pin >= 0 && pin <= 15) {
     state[pin] = value;
     if (mode[pin] == OUTPUT) {
-      pcf.write(pin, value);
+      // only a change is written, at the next poll along with any others
+      uint16_t bit = (uint16_t)1 << pin;
+      if (((outputs & bit) != 0) != value) { if (value) outputs |= bit; else outputs &= ~bit; dirty = true; }
     } else {
-      if (value == HIGH) pinMode(pin, INPUT_PULLUP); else pinMode(pin, INPUT);
+      // INPUT_PULLUP is the same as INPUT here
+      if (mode[pin] != INPUT) pinMode(pin, INPUT);
     }
   } else return;
 }
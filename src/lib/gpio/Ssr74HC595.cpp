@@ -20,6 +20,19 @@
 #if GPIO_SSR74HC595_COUNT != 8 && GPIO_SSR74HC595_COUNT != 16 && GPIO_SSR74HC595_COUNT != 24 && GPIO_SSR74HC595_COUNT != 32
   #error "GPIO device SSR74HC595 supports GPIO_SSR74HC595_COUNT of 8, 16, 24, or 32 only."
 #endif
+#if GPIO_SSR74HC595_DEFERRED != OFF && GPIO_SSR74HC595_DEFERRED != ON
+  #error "GPIO device SSR74HC595 GPIO_SSR74HC595_DEFERRED unknown, use OFF or ON."
+#endif
+#if GPIO_SSR74HC595_SPI != OFF && GPIO_SSR74HC595_SPI != ON
+  #error "GPIO device SSR74HC595 GPIO_SSR74HC595_SPI unknown, use OFF or ON."
+#endif
+#if GPIO_SSR74HC595_SPI == ON && GPIO_SSR74HC595_DEFERRED != ON
+  #error "GPIO device SSR74HC595 GPIO_SSR74HC595_SPI ON requires GPIO_SSR74HC595_DEFERRED ON."
+#endif
+
+#if GPIO_SSR74HC595_SPI == ON
+  #include <SPI.h>
+#endif
 
 #ifdef ESP32
   // ESP32 GPIO SSR74HC595 macros (if used, code below only works for pins 0 to 31)
@@ -41,6 +54,10 @@
 
 #include "../tasks/OnTask.h"
 
+#if GPIO_SSR74HC595_DEFERRED == ON
+  void ssr74HC595Wrapper() { gpio.poll(); }
+#endif
+
 // designed for a 20MHz max bit rate
 IRAM_ATTR void shiftOut20MHz(uint32_t val) {
   if ((val & 0b10000000) == 0) { GPIO_SSR74HC595_DATA_LOW(); } else { GPIO_SSR74HC595_DATA_HIGH(); }
@@ -83,6 +100,24 @@ bool Ssr74HC595::init() {
     state[i] = false;
   }
 
+  #if GPIO_SSR74HC595_SPI == ON
+    #if defined(ESP32)
+      SPI.begin(GPIO_SSR74HC595_CLOCK_PIN, -1, GPIO_SSR74HC595_DATA_PIN, -1);
+      useSpi = true;
+    #else
+      if (GPIO_SSR74HC595_CLOCK_PIN == SCK && GPIO_SSR74HC595_DATA_PIN == MOSI) {
+        SPI.begin();
+        useSpi = true;
+      }
+    #endif
+    if (useSpi) { VLF("MSG: GPIO, SSR74HC595 using hardware SPI"); } else { VLF("WRN: GPIO, SSR74HC595 CLOCK/DATA aren't the SPI pins falling back to bit-bang"); }
+  #endif
+
+  #if GPIO_SSR74HC595_DEFERRED == ON
+    VF("MSG: GPIO, SSR74HC595 start latch task (rate 1ms priority 3)... ");
+    if (tasks.add(1, 0, true, 3, ssr74HC595Wrapper, "Gpio595")) { VLF("success"); } else { VLF("FAILED!"); return false; }
+  #endif
+
   VLF("MSG: GPIO, SSR74HC595 Initialized");
 
   found = true;
@@ -120,19 +155,60 @@ int Ssr74HC595::digitalRead(int pin) {
 // up to four eight channel 74HC595 GPIOs are supported, this sets each output on or off
 void Ssr74HC595::digitalWrite(int pin, bool value) {
   if (found && pin >= 0 && pin < GPIO_SSR74HC595_COUNT) {
-    cli();
-    state[pin] = value;
-    if (mode[pin] == OUTPUT) {
-      if (value) bitSet(register_value, pin); else bitClear(register_value, pin);
-      GPIO_SSR74HC595_LATCH_LOW();
-      if (GPIO_SSR74HC595_COUNT >= 32) shiftOut20MHz((register_value>>24) & 0xff);
-      if (GPIO_SSR74HC595_COUNT >= 24) shiftOut20MHz((register_value>>16) & 0xff);
-      if (GPIO_SSR74HC595_COUNT >= 16) shiftOut20MHz((register_value>>8) & 0xff);
-      shiftOut20MHz((register_value) & 0xff);
+    #if GPIO_SSR74HC595_DEFERRED == ON
+      // interrupts are held off just for the register update
+      noInterrupts();
+      state[pin] = value;
+      if (mode[pin] == OUTPUT) {
+        uint32_t v = register_value;
+        if (value) bitSet(v, pin); else bitClear(v, pin);
+        if (v != register_value) { register_value = v; pending = true; }
+      }
+      interrupts();
+    #else
+      cli();
+      state[pin] = value;
+      if (mode[pin] == OUTPUT) {
+        uint32_t v = register_value;
+        if (value) bitSet(v, pin); else bitClear(v, pin);
+        register_value = v;
+        latch(v);
+      }
+      sei();
+    #endif
+  } else return;
+}
+
+#if GPIO_SSR74HC595_DEFERRED == ON
+  void Ssr74HC595::poll() {
+    if (!pending) return;
+    noInterrupts();
+    uint32_t v = register_value;
+    pending = false;
+    interrupts();
+    latch(v);
+  }
+#endif
+
+IRAM_ATTR void Ssr74HC595::latch(uint32_t value) {
+  GPIO_SSR74HC595_LATCH_LOW();
+  #if GPIO_SSR74HC595_SPI == ON
+    if (useSpi) {
+      SPI.beginTransaction(SPISettings(GPIO_SSR74HC595_SPI_RATE_HZ, MSBFIRST, SPI_MODE0));
+      if (GPIO_SSR74HC595_COUNT >= 32) SPI.transfer((value>>24) & 0xff);
+      if (GPIO_SSR74HC595_COUNT >= 24) SPI.transfer((value>>16) & 0xff);
+      if (GPIO_SSR74HC595_COUNT >= 16) SPI.transfer((value>>8) & 0xff);
+      SPI.transfer(value & 0xff);
+      SPI.endTransaction();
       GPIO_SSR74HC595_LATCH_HIGH();
+      return;
     }
-    sei();
-  } else return;
+  #endif
+  if (GPIO_SSR74HC595_COUNT >= 32) shiftOut20MHz((value>>24) & 0xff);
+  if (GPIO_SSR74HC595_COUNT >= 24) shiftOut20MHz((value>>16) & 0xff);
+  if (GPIO_SSR74HC595_COUNT >= 16) shiftOut20MHz((value>>8) & 0xff);
+  shiftOut20MHz(value & 0xff);
+  GPIO_SSR74HC595_LATCH_HIGH();
 }
 
 Ssr74HC595 gpio;
@@ -8,6 +8,21 @@
 
 #include "../commands/CommandErrors.h"
 
+// ON pin writes only update the register and a task shifts out and latches any changes once each 1ms,
+// several writes in that time go out together and interrupts are never held off for the shift out
+#ifndef GPIO_SSR74HC595_DEFERRED
+  #define GPIO_SSR74HC595_DEFERRED OFF
+#endif
+
+// ON shifts out over hardware SPI when the CLOCK and DATA pins are the SPI SCK and MOSI pins (any pins
+// on ESP32) this needs GPIO_SSR74HC595_DEFERRED ON so the SPI bus is only used from the task
+#ifndef GPIO_SSR74HC595_SPI
+  #define GPIO_SSR74HC595_SPI OFF
+#endif
+#ifndef GPIO_SSR74HC595_SPI_RATE_HZ
+  #define GPIO_SSR74HC595_SPI_RATE_HZ 8000000
+#endif
+
 class Ssr74HC595 {
   public:
     // init for SSR74HC595 device
@@ -25,9 +40,23 @@ class Ssr74HC595 {
     // up to four eight channel 74HC595 GPIOs are supported, this sets each output on or off
     void digitalWrite(int pin, bool value);
 
+    #if GPIO_SSR74HC595_DEFERRED == ON
+      // shift out and latch the register if it changed
+      void poll();
+    #endif
+
   private:
-    uint32_t register_value = 0;
+    // shift out the register value and latch it
+    void latch(uint32_t value);
+
+    volatile uint32_t register_value = 0;
     bool found = false;
+    #if GPIO_SSR74HC595_DEFERRED == ON
+      volatile bool pending = false;
+    #endif
+    #if GPIO_SSR74HC595_SPI == ON
+      bool useSpi = false;
+    #endif
 
     int mode[32];
     bool state[32];
@@ -50,6 +50,14 @@ bool SwsGpio::command(char *reply, char *command, char *parameter, bool *supress
           reply[i + 1] = 0;
         }
         *numericReply = false;
+      } else
+
+      // :GXGB#     Get Gpio state as bitmasks
+      //            Returns: i,o,s# in hex, i the pins in input mode, o the pins in output mode, and s the output states
+      //            the same masks are in status frames as ,Gooss when the channel is subscribed with :SXPS
+      if (parameter[0] == 'G' && parameter[1] == 'B') {
+        sprintf(reply, "%02X,%02X,%02X", inputMask(), outputMask(), outputState());
+        *numericReply = false;
       } else return false;
     } else return false;
   } else
@@ -58,6 +66,19 @@ bool SwsGpio::command(char *reply, char *command, char *parameter, bool *supress
     if (command[1] == 'X') {
       if (parameter[2] != ',') { *commandError = CE_PARAM_FORM; return true; }
 
+      // :SXGB,m,v#     Set Gpio inputs in bitmask [m] to the bits in [v]alue, both in hex
+      //              Return: 0 on failure
+      //                      1 on success
+      if (parameter[0] == 'G' && parameter[1] == 'B') {
+        long m = strtol(&parameter[3], &conv_end, 16);
+        if (&parameter[3] == conv_end || *conv_end != ',') { *commandError = CE_PARAM_FORM; return true; }
+        char *v_start = conv_end + 1;
+        long v = strtol(v_start, &conv_end, 16);
+        if (v_start == conv_end || *conv_end != 0) { *commandError = CE_PARAM_FORM; return true; }
+        if (m < 0 || m > 0xFF || v < 0 || v > 0xFF) { *commandError = CE_PARAM_RANGE; return true; }
+        for (int i = 0; i < 8; i++) if (bitRead(m, i)) virtualRead[i] = bitRead(v, i);
+      } else
+
       // :SXG[n],[v]#   Set Gpio input [n]umber to [v]alue
       //              Return: 0 on failure
       //                      1 on success
@@ -102,6 +123,24 @@ void SwsGpio::digitalWrite(int pin, bool value) {
   } else return;
 }
 
+uint8_t SwsGpio::inputMask() {
+  uint8_t m = 0;
+  for (int i = 0; i < 8; i++) if (mode[i] == INPUT) bitSet(m, i);
+  return m;
+}
+
+uint8_t SwsGpio::outputMask() {
+  uint8_t m = 0;
+  for (int i = 0; i < 8; i++) if (mode[i] == OUTPUT) bitSet(m, i);
+  return m;
+}
+
+uint8_t SwsGpio::outputState() {
+  uint8_t s = 0;
+  for (int i = 0; i < 8; i++) if (mode[i] == OUTPUT && virtualWrite[i]) bitSet(s, i);
+  return s;
+}
+
 SwsGpio gpio;
 
 #endif
@@ -24,6 +24,15 @@ class SwsGpio {
     // one eight channel SWS GPIO is supported, this sets each output on or off
     void digitalWrite(int pin, bool value);
 
+    // bitmask of the pins in INPUT mode
+    uint8_t inputMask();
+
+    // bitmask of the pins in OUTPUT mode
+    uint8_t outputMask();
+
+    // bitmask of the output states, pins not in OUTPUT mode are 0
+    uint8_t outputState();
+
   private:
     bool found = false;
 
@@ -11,6 +11,13 @@
 
 #include "../tasks/OnTask.h"
 
+// how often outputs are written (only if changed) and inputs are read
+#ifndef GPIO_POLL_PERIOD_MS
+  #define GPIO_POLL_PERIOD_MS 10
+#endif
+
+void tca9555Wrapper() { gpio.poll(); }
+
 #include <TCA9555.h> // https://www.arduino.cc/reference/en/libraries/tca9555/
 
 TCA9555 tca(GPIO_TCA9555_I2C_ADDRESS, &HAL_Wire); // might need to change this I2C Address?
@@ -26,6 +33,12 @@ bool Tca9555::init() {
   } else { found = false; DLF("WRN: Gpio.init(), TCA9555 (I2C 0x"); if (DEBUG != OFF) SERIAL_DEBUG.print(GPIO_TCA9555_I2C_ADDRESS, HEX); DLF(") not found"); }
   HAL_Wire.setClock(HAL_WIRE_CLOCK);
 
+  if (found) {
+    VF("MSG: Gpio, start TCA9555 poll task (rate "); V(GPIO_POLL_PERIOD_MS); VF("ms priority 6)... ");
+    if (tasks.add(GPIO_POLL_PERIOD_MS, 0, true, 6, tca9555Wrapper, "GpioPol")) { VLF("success"); } else { VLF("FAILED!"); }
+  }
+
+  initialized = true;
   return found;
 }
 
@@ -49,14 +62,22 @@ void Tca9555::pinMode(int pin, int mode) {
     if (mode == INPUT_PULLUP) mode = INPUT;
     tca.pinMode(pin, mode);
     this->mode[pin] = mode;
+    if (mode == OUTPUT) inputMask &= ~(1 << pin); else inputMask |= (1 << pin);
+    dirty = true;
   }
 }
 
-// one sixteen channel Tca9555 GPIO is supported, this gets the last set value
+// write any changed outputs and read all inputs, one I2C transaction each
+void Tca9555::poll() {
+  if (dirty) { dirty = false; tca.write16(outputs); }
+  if (inputMask) inputs = tca.read16();
+}
+
+// one sixteen channel Tca9555 GPIO is supported, this gets the last value read or set
 int Tca9555::digitalRead(int pin) {
   if (found && pin >= 0 && pin <= 15) {
     if (mode[pin] == INPUT || mode[pin] == INPUT_PULLUP) {
-      return tca.digitalRead(pin);
+      return (inputs >> pin) & 1;
     } else return state[pin]; 
   } else return 0;
 }
@@ -66,9 +87,12 @@ void Tca9555::digitalWrite(int pin, bool value) {
   if (found && pin >= 0 && pin <= 15) {
     state[pin] = value;
     if (mode[pin] == OUTPUT) {
-      tca.digitalWrite(pin, value);
+      // only a change is written, at the next poll along with any others
+      uint16_t bit = (uint16_t)1 << pin;
+      if (((outputs & bit) != 0) != value) { if (value) outputs |= bit; else outputs &= ~bit; dirty = true; }
     } else {
-      if (value == HIGH) pinMode(pin, INPUT_PULLUP); else pinMode(pin, INPUT);
+      // INPUT_PULLUP is the same as INPUT here
+      if (mode[pin] != INPUT) pinMode(pin, INPUT);
     }
   } else return;
 }
@@ -0,0 +1,204 @@
+// -----------------------------------------------------------------------------------------------------------------------------
+// RAM usage, static data, heap, and stack high-water marks
+
+#include "Memory.h"
+
+#if defined(ESP32)
+  #include <esp_heap_caps.h>
+  #ifdef MEMORY_PLACEMENT_MAX
+    #if __has_include(<esp_memory_utils.h>)
+      #include <esp_memory_utils.h>
+    #else
+      #include <soc/soc_memory_layout.h>
+    #endif
+  #endif
+
+#elif defined(__AVR__)
+  extern char __data_start, __bss_end, __heap_start;
+  extern char *__brkval;
+  extern char *__malloc_heap_start;
+  extern size_t __malloc_margin;
+
+  // avr-libc free list entry
+  typedef struct MemoryFreeBlock { size_t size; struct MemoryFreeBlock *next; } MemoryFreeBlock;
+  extern MemoryFreeBlock *__flp;
+
+  #define MEMORY_STACK_TOP ((uint8_t *)RAMEND + 1)
+
+#else
+  // ARM (Teensy and STM32) newlib targets, the linker scripts export the section bounds
+  #include <malloc.h>
+  #include <unistd.h>
+  extern "C" unsigned long _sdata, _ebss, _estack;
+  #if defined(__IMXRT1062__)
+    // Teensy 4.x, the stack is in DTCM above the static data and the heap is in RAM2
+    extern "C" unsigned long _heap_end;
+  #endif
+
+  #define MEMORY_STACK_TOP ((uint8_t *)&_estack)
+#endif
+
+#ifndef ESP32
+  // the current stack pointer, near enough
+  #define memoryStackPointer() ((uint8_t *)__builtin_frame_address(0))
+
+  // the first byte above the heap (or above the static data if the heap lives elsewhere)
+  static inline uint8_t *memoryHeapTop() {
+    #if defined(__AVR__)
+      return __brkval == NULL ? (uint8_t *)&__heap_start : (uint8_t *)__brkval;
+    #elif defined(__IMXRT1062__)
+      return (uint8_t *)&_ebss;
+    #else
+      return (uint8_t *)sbrk(0);
+    #endif
+  }
+#endif
+
+void Memory::init() {
+  #ifndef ESP32
+    fillStart = memoryHeapTop();
+    fillEnd = memoryStackPointer() - MEMORY_STACK_GUARD;
+    for (volatile uint8_t *p = fillStart; p < fillEnd; p++) *p = MEMORY_STACK_FILL;
+  #endif
+}
+
+uint32_t Memory::getStaticBytes() {
+  #if defined(ESP32)
+    return 0;
+  #elif defined(__AVR__)
+    return (uint32_t)(&__bss_end - &__data_start);
+  #else
+    return (uint32_t)((uint8_t *)&_ebss - (uint8_t *)&_sdata);
+  #endif
+}
+
+uint32_t Memory::getHeapUsed() {
+  #if defined(ESP32)
+    return ESP.getHeapSize() - ESP.getFreeHeap();
+  #elif defined(__AVR__)
+    uint32_t used = __brkval == NULL ? 0 : (uint32_t)(__brkval - __malloc_heap_start);
+    for (MemoryFreeBlock *block = __flp; block != NULL; block = block->next) used -= block->size + sizeof(size_t);
+    return used;
+  #else
+    return mallinfo().uordblks;
+  #endif
+}
+
+uint32_t Memory::getHeapFree() {
+  #if defined(ESP32)
+    return ESP.getFreeHeap();
+  #elif defined(__AVR__)
+    uint32_t bytes = getHeapLargestFree();
+    for (MemoryFreeBlock *block = __flp; block != NULL; block = block->next) bytes += block->size;
+    return bytes;
+  #elif defined(__IMXRT1062__)
+    return mallinfo().fordblks + ((uint8_t *)&_heap_end - (uint8_t *)sbrk(0));
+  #else
+    return mallinfo().fordblks + getHeapLargestFree();
+  #endif
+}
+
+uint32_t Memory::getHeapLargestFree() {
+  #if defined(ESP32)
+    return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  #elif defined(__AVR__)
+    // the space between the heap and stack less the margin malloc() keeps for the stack
+    long gap = (long)(memoryStackPointer() - memoryHeapTop()) - (long)__malloc_margin;
+    uint32_t largest = gap > 0 ? gap : 0;
+    for (MemoryFreeBlock *block = __flp; block != NULL; block = block->next) if (block->size > largest) largest = block->size;
+    return largest;
+  #elif defined(__IMXRT1062__)
+    return (uint8_t *)&_heap_end - (uint8_t *)sbrk(0);
+  #else
+    // newlib doesn't expose its free list, the unclaimed space above the heap is the block that can be counted on
+    long gap = (long)(memoryStackPointer() - memoryHeapTop()) - MEMORY_STACK_GUARD;
+    return gap > 0 ? gap : 0;
+  #endif
+}
+
+uint32_t Memory::getHeapFreeMin() {
+  #if defined(ESP32)
+    return ESP.getMinFreeHeap();
+  #else
+    return 0;
+  #endif
+}
+
+#ifndef ESP32
+  // the deepest byte of the stack that changed since init(), the heap may have claimed some of the filled area
+  static uint8_t *memoryStackDeepest(uint8_t *fillStart, uint8_t *fillEnd) {
+    uint8_t *p = memoryHeapTop();
+    if (p < fillStart) p = fillStart;
+    while (p < fillEnd && *p == MEMORY_STACK_FILL) p++;
+    return p;
+  }
+#endif
+
+uint32_t Memory::getStackUsedMax() {
+  #if defined(ESP32)
+    #ifdef CONFIG_ARDUINO_LOOP_STACK_SIZE
+      long unused = getTaskStackFreeMin("loopTask");
+      return unused < 0 ? 0 : CONFIG_ARDUINO_LOOP_STACK_SIZE - unused;
+    #else
+      return 0;
+    #endif
+  #else
+    if (fillStart == NULL) return 0;
+    return MEMORY_STACK_TOP - memoryStackDeepest(fillStart, fillEnd);
+  #endif
+}
+
+uint32_t Memory::getStackFreeMin() {
+  #if defined(ESP32)
+    long unused = getTaskStackFreeMin("loopTask");
+    return unused < 0 ? 0 : unused;
+  #else
+    if (fillStart == NULL) return 0;
+    uint8_t *heapTop = memoryHeapTop();
+    uint8_t *deepest = memoryStackDeepest(fillStart, fillEnd);
+    return deepest > heapTop ? deepest - heapTop : 0;
+  #endif
+}
+
+#ifdef ESP32
+  long Memory::getTaskStackFreeMin(const char *name) {
+    TaskHandle_t handle = xTaskGetHandle(name);
+    if (handle == NULL) return -1;
+    // ESP-IDF counts stack in bytes
+    return uxTaskGetStackHighWaterMark(handle);
+  }
+#endif
+
+#ifdef MEMORY_PLACEMENT_MAX
+  void Memory::placementAdd(const char *name, const void *address) {
+    // axes share their member functions, each is only listed once
+    if (address == NULL) return;
+    for (uint8_t i = 0; i < placementCount; i++) if (placementAddress[i] == address) return;
+    if (placementCount >= MEMORY_PLACEMENT_MAX) { DLF("WRN: Memory, too many hot path placement checks"); return; }
+
+    strncpy(placementName[placementCount], name, MEMORY_PLACEMENT_NAME - 1);
+    placementName[placementCount][MEMORY_PLACEMENT_NAME - 1] = 0;
+    placementAddress[placementCount] = address;
+    placementIram[placementCount] = esp_ptr_in_iram(address);
+
+    #if DEBUG != OFF
+      char at[12];
+      sprintf(at, "0x%08lx", (unsigned long)address);
+      if (placementIram[placementCount]) {
+        VF("MSG: Memory, hot path "); V(name); VF(" in IRAM at "); VL(at);
+      } else {
+        DF("WRN: Memory, hot path "); D(name); DF(" linked into flash at "); DL(at);
+      }
+    #endif
+    placementCount++;
+  }
+
+  bool Memory::getPlacement(uint8_t n, const char **name, bool *inIram) {
+    if (n >= placementCount) return false;
+    *name = placementName[n];
+    *inIram = placementIram[n];
+    return true;
+  }
+#endif
+
+Memory memory;
@@ -0,0 +1,84 @@
+// -----------------------------------------------------------------------------------------------------------------------------
+// RAM usage, static data, heap, and stack high-water marks
+#pragma once
+
+#include "../../Common.h"
+
+// byte the unused stack is filled with at startup, the deepest byte that changed marks the high-water
+#define MEMORY_STACK_FILL 0xA5
+
+// headroom left below the stack pointer while filling, covers the frames of the fill itself
+#define MEMORY_STACK_GUARD 128
+
+#if defined(ESP32) && HOT_PATH_IRAM == ON
+  // hot path functions that can be checked for IRAM placement, and the longest name kept for each
+  #define MEMORY_PLACEMENT_MAX 24
+  #define MEMORY_PLACEMENT_NAME 32
+
+  // address of the code for a function or (non-virtual) member function, GCC keeps the code address in the
+  // first word of a pointer to member function
+  template <typename T> inline const void *codeAddress(T function) {
+    union { T function; const void *address; } u = { function };
+    return u.address;
+  }
+
+  // check a function marked IRAM_HOT was linked into IRAM, the result is logged and kept for :GXRPn#
+  #define IRAM_HOT_CHECK(name, function) memory.placementAdd(name, codeAddress(function))
+#else
+  #define IRAM_HOT_CHECK(name, function)
+#endif
+
+class Memory {
+  public:
+    // fill the unused stack so getStackUsedMax() can find the high-water, call first thing in setup()
+    void init();
+
+    // bytes of RAM taken by initialized and zeroed static data, 0 if unknown on this platform
+    uint32_t getStaticBytes();
+
+    // bytes of heap allocated
+    uint32_t getHeapUsed();
+
+    // bytes of heap still available, including any free blocks between allocations
+    uint32_t getHeapFree();
+
+    // largest single block that can be allocated, less than getHeapFree() when the heap is fragmented
+    uint32_t getHeapLargestFree();
+
+    // lowest getHeapFree() seen, 0 if unknown on this platform
+    uint32_t getHeapFreeMin();
+
+    // most bytes of the main stack used since startup, 0 if unknown
+    uint32_t getStackUsedMax();
+
+    // fewest bytes of the main stack left unused since startup (between the stack and heap where they share RAM)
+    uint32_t getStackFreeMin();
+
+    #ifdef ESP32
+      // fewest bytes of stack left unused by the named FreeRTOS task, -1 if there is no such task
+      long getTaskStackFreeMin(const char *name);
+    #endif
+
+    #ifdef MEMORY_PLACEMENT_MAX
+      // record a hot path function and check its placement, logs a warning if it was linked into flash
+      void placementAdd(const char *name, const void *address);
+
+      // name of hot path function n (from 0) and true if its code is in IRAM, false if there is no such entry
+      bool getPlacement(uint8_t n, const char **name, bool *inIram);
+    #endif
+
+  private:
+    #ifdef MEMORY_PLACEMENT_MAX
+      char placementName[MEMORY_PLACEMENT_MAX][MEMORY_PLACEMENT_NAME];
+      const void *placementAddress[MEMORY_PLACEMENT_MAX];
+      bool placementIram[MEMORY_PLACEMENT_MAX];
+      uint8_t placementCount = 0;
+    #endif
+
+    #ifndef ESP32
+      uint8_t *fillStart = NULL;
+      uint8_t *fillEnd = NULL;
+    #endif
+};
+
+extern Memory memory;
@@ -3,6 +3,7 @@
 
 #include "NV.h"
 #include "../debug/Debug.h"
+#include "../counters/Counters.h"
 
 #ifndef NV_WIPE
   #define NV_WIPE OFF
@@ -14,19 +15,23 @@ bool NonVolatileStorage::init(uint16_t size, bool cacheEnable, uint16_t wait, bo
   // set cache size, defaults to 0 otherwise
   if (cacheEnable) cacheSize = size; else cacheSize = 0;
   waitMs = wait;
+  bytesWrittenCounter = counters.add("NvBytes");
   if (waitMs == 0) delayedCommitEnabled = false; else delayedCommitEnabled = true;
 
-  cacheStateSize = cacheSize/8 + 1;
+  cacheStateSize = (cacheSize + 31)/32;
   if (cacheSize == 0) return true;
 
   cache = new uint8_t[cacheSize];
-  cacheStateRead  = new uint8_t[cacheStateSize];
-  cacheStateWrite = new uint8_t[cacheStateSize];
+  cacheStateRead  = new uint32_t[cacheStateSize];
+  cacheStateWrite = new uint32_t[cacheStateSize];
 
-  // mark entire read cache as dirty
-  for (uint16_t i = 0; i < cacheStateSize; i++) cacheStateRead[i] = 255;
+  // mark entire read cache as dirty (just the bits that map to the cache)
+  for (uint16_t i = 0; i < cacheStateSize; i++) cacheStateRead[i] = 0xFFFFFFFFUL;
+  if (cacheSize % 32) cacheStateRead[cacheStateSize - 1] = (1UL << (cacheSize % 32)) - 1;
+  cacheSizeUnreadCount = cacheSize;
   // mark entire write cache as clean
   for (uint16_t i = 0; i < cacheStateSize; i++) cacheStateWrite[i] = 0;
+  cacheSizeDirtyCount = 0;
 
   // stop compiler warnings
   (void)(checkEnable);
@@ -105,16 +110,12 @@ bool NonVolatileStorage::verify() {
   VLF("MSG: NV, verify phase 1");
   wipe(0xff);
   wait();
-  ignoreCache(true);
-  for (uint16_t i = 0; i < size - 1; i++) { if (read(i) != 0xff) errors++; }
-  ignoreCache(false);
+  errors += verifyErrors(0xff);
 
   VLF("MSG: NV, verify phase 2");
   wipe(0x00);
   wait();
-  ignoreCache(true);
-  for (uint16_t i = 0; i < size - 1; i++) { if (read(i) != 0x00) errors++; }
-  ignoreCache(false);
+  errors += verifyErrors(0x00);
 
   if (errors == 0) {
     VLF("MSG: NV, verify success");
@@ -126,83 +127,99 @@ bool NonVolatileStorage::verify() {
   return initError;
 }
 
+long NonVolatileStorage::verifyErrors(uint8_t j) {
+  long errors = 0;
+  uint8_t block[NV_WIRE_BUFFER_SIZE > 255 ? 255 : NV_WIRE_BUFFER_SIZE];
+  uint8_t blockSize = blockReadSize < sizeof(block) ? blockReadSize : sizeof(block);
+  for (uint16_t i = 0; i < size - 1; i += blockSize) {
+    uint8_t n = (size - 1 - i) < blockSize ? size - 1 - i : blockSize;
+    readPageFromStorage(i, block, n);
+    for (uint8_t k = 0; k < n; k++) { if (block[k] != j) errors++; }
+  }
+  return errors;
+}
+
 void NonVolatileStorage::poll(bool disableInterrupts) {
-  if (cacheSize == 0 || cacheClean) return;
+  regionPoll();
 
-  int8_t dirtyW = 0, dirtyR = 0;
+  if (cacheSize == 0 || (cacheSizeDirtyCount == 0 && cacheSizeUnreadCount == 0)) return;
 
   if (busy()) return;
 
-  // check 20 byte chunks of cache for data that needs processing
-  for (uint8_t j = 0; j < 20; j++) {
-    cacheIndex++;
-    if (cacheIndex >= cacheSize) {
-      if (cacheCleanThisPass) cacheClean = true;
-      cacheIndex = 0;
-      cacheCleanThisPass = true;
-    }
-
-    if (!delayedCommitEnabled || (long)(millis() - commitReadyTimeMs) >= 0)
-      dirtyW = bitRead(cacheStateWrite[cacheIndex/8], cacheIndex%8); else cacheCleanThisPass = false;
-    dirtyR = bitRead(cacheStateRead[cacheIndex/8], cacheIndex%8);
-    if (dirtyW || dirtyR) { cacheCleanThisPass = false; break; }
-  }
-
-  if (dirtyW) {
-    uint16_t p = pageWriteSize;
-
-    // if not a page boundary use a page size of 1
-    if ((cacheIndex % p) != 0) p = 1; else
-
-    for (uint16_t k = 0; k < p; k++) {
-      // if a page write would exceed the NV size use a page size of 1
-      if (cacheIndex + k >= cacheSize) { p = 1; break; }
-      // check that the read cache for these locations is clean otherwise use a page size of 1
-      if (bitRead(cacheStateRead[(cacheIndex + k)/8], (cacheIndex + k)%8)) { p = 1; break; }
+  // go straight to the next byte that needs writing (once the commit is due) or reading
+  if (cacheSizeDirtyCount > 0 && !commitHold && (!delayedCommitEnabled || (long)(millis() - commitReadyTimeMs) >= 0)) {
+    uint32_t stallUs = 0;
+
+    // several bursts can go out in one pass as long as the storage keeps up
+    for (uint8_t b = 0; b < NV_COMMIT_BURSTS && cacheSizeDirtyCount > 0 && (b == 0 || !busy()); b++) {
+      cacheIndex = nextDirty(cacheStateWrite, cacheIndex);
+
+      // burst from here up to the last dirty byte that's in the same page and within the burst size,
+      // clean bytes in between are rewritten as long as the cache holds their value
+      uint8_t snapshot[NV_WIRE_BUFFER_SIZE];
+      uint32_t limit = cacheIndex - (cacheIndex % pageWriteSize) + pageWriteSize;
+      if (limit > (uint32_t)cacheIndex + burstWriteSize) limit = (uint32_t)cacheIndex + burstWriteSize;
+      if (limit > (uint32_t)cacheIndex + sizeof(snapshot)) limit = (uint32_t)cacheIndex + sizeof(snapshot);
+      if (limit > cacheSize) limit = cacheSize;
+      uint16_t last = cacheIndex;
+      for (uint32_t k = cacheIndex + 1; k < limit; k++) {
+        if (isDirty(cacheStateRead, k)) break;
+        if (isDirty(cacheStateWrite, k)) last = k;
+      }
+      uint16_t p = last - cacheIndex + 1;
+
+      // the burst is copied and marked clean before the physical write, so a cache update that
+      // comes in while the write is underway is marked dirty again instead of being lost
+      memcpy(snapshot, &cache[cacheIndex], p);
+      for (uint16_t k = 0; k < p; k++) markWrite(cacheIndex + k, false);
+
+      uint32_t startUs = micros();
+      writePageToStorage(cacheIndex, snapshot, p);
+      stallUs += micros() - startUs;
+      counters.increment(bytesWrittenCounter, p);
     }
+    commitStall(stallUs);
+  } else
 
-    // write the page and update the cache write state
-    writePageToStorage(cacheIndex, &cache[cacheIndex], p);
-    for (uint16_t k = 0; k < p; k++) {
-      bitWrite(cacheStateWrite[(cacheIndex + k)/8], (cacheIndex + k)%8, 0);
-    }
-  } else {
-    if (dirtyR) {
-      cache[cacheIndex] = readFromStorage(cacheIndex);
-      bitWrite(cacheStateRead[cacheIndex/8], cacheIndex%8, 0);
-    }
+  if (cacheSizeUnreadCount > 0) {
+    cacheIndex = nextDirty(cacheStateRead, cacheIndex);
+    prefetch(cacheIndex, blockReadSize);
   }
 
-  /*
-  int32_t dirtyWriteCount = 0;
-  static int32_t lastDirtyWriteCount = 0;
-  for (uint16_t i = 0; i < cacheSize; i++) { if (bitRead(cacheStateWrite[i/8], i%8)) dirtyWriteCount++; }
-  if (lastDirtyWriteCount != dirtyWriteCount) { V("MSG: NV, cache "); V(dirtyWriteCount); VL(" bytes to be written"); }
-
-  int32_t dirtyReadCount = 0;
-  static int32_t lastDirtyReadCount = 0;
-  for (uint16_t i = 0; i < cacheSize; i++) { if (bitRead(cacheStateRead[i/8], i%8)) dirtyReadCount++; }
-  if (lastDirtyReadCount != dirtyReadCount) { V("MSG: NV, cache "); V(dirtyReadCount); VL(" bytes to be read"); }
-  */
-
   // stop compiler warnings
   (void)(disableInterrupts);
 }
 
 bool NonVolatileStorage::committed() {
-  cacheSizeDirtyCount = 0;
+  return !cacheSizeDirtyCount;
+}
 
-  for (uint16_t i = 0; i < cacheSize; i++) {
-    if (bitRead(cacheStateWrite[i/8], i%8)) {
-      cacheSizeDirtyCount++;
-    }
-  }
+void NonVolatileStorage::markRead(uint16_t i, bool dirty) {
+  uint32_t bit = 1UL << (i & 31);
+  uint32_t *word = &cacheStateRead[i >> 5];
+  if (dirty == ((*word & bit) != 0)) return;
+  if (dirty) { *word |= bit; cacheSizeUnreadCount++; } else { *word &= ~bit; cacheSizeUnreadCount--; }
+}
 
-  return !cacheSizeDirtyCount;
+void NonVolatileStorage::markWrite(uint16_t i, bool dirty) {
+  uint32_t bit = 1UL << (i & 31);
+  uint32_t *word = &cacheStateWrite[i >> 5];
+  if (dirty == ((*word & bit) != 0)) return;
+  if (dirty) { *word |= bit; cacheSizeDirtyCount++; } else { *word &= ~bit; cacheSizeDirtyCount--; }
 }
 
-bool valid() {
-  return true;
+uint16_t NonVolatileStorage::nextDirty(const uint32_t *state, uint16_t i) {
+  if (i >= cacheSize) i = 0;
+  uint16_t w = i >> 5;
+
+  // the rest of the first word, then whole words (wrapping around) back to and including the first
+  uint32_t bits = state[w] & (0xFFFFFFFFUL << (i & 31));
+  for (uint16_t n = 0; n <= cacheStateSize; n++) {
+    if (bits) return (w << 5) + __builtin_ctzl(bits);
+    if (++w >= cacheStateSize) w = 0;
+    bits = state[w];
+  }
+  return i;
 }
 
 void NonVolatileStorage::ignoreCache(bool state) {
@@ -212,29 +229,25 @@ void NonVolatileStorage::ignoreCache(bool state) {
 uint8_t NonVolatileStorage::readFromCache(uint16_t i) {
   if (cacheSize == 0 || readAndWriteThrough) return readFromStorage(i);
 
-  uint8_t dirty = bitRead(cacheStateRead[i/8], i%8);
-  if (dirty) {
+  if (isDirty(cacheStateRead, i)) {
     uint8_t j = readFromStorage(i);
     
     // store and mark as clean
     cache[i] = j;
-    bitWrite(cacheStateRead[i/8], i%8, 0);
+    markRead(i, false);
 
     return j;
   } else return cache[i];
 }
 
 void NonVolatileStorage::writeToCache(uint16_t i, uint8_t j) {
-  // no longer clean
-  cacheClean = false;
-
-  if (readAndWriteThrough) if (!readOnlyMode) writeToStorage(i, j);
+  if (readAndWriteThrough) if (!readOnlyMode) { writeToStorage(i, j); counters.increment(bytesWrittenCounter); }
 
   if (cacheSize == 0) {
     if (!readOnlyMode) {
       if (!readAndWriteThrough) {
-        if (j != readFromStorage(i)) writeToStorage(i, j);
-      } else writeToStorage(i, j);
+        if (j != readFromStorage(i)) { writeToStorage(i, j); regionChange(i); counters.increment(bytesWrittenCounter); }
+      } else { writeToStorage(i, j); regionChange(i); counters.increment(bytesWrittenCounter); }
     }
 
     commitReadyTimeMs = millis() + waitMs;
@@ -244,12 +257,13 @@ void NonVolatileStorage::writeToCache(uint16_t i, uint8_t j) {
   uint8_t k = readFromCache(i);
   if (j != k) {
     cache[i] = j;
+    regionChange(i);
 
     // mark write as dirty (needs to be written)
-    bitWrite(cacheStateWrite[i/8], i%8, 1);
+    markWrite(i, true);
 
     // mark read as clean (so we don't overwrite the cache)
-    bitWrite(cacheStateRead[i/8], i%8, 0);
+    markRead(i, false);
   }
 
   commitReadyTimeMs = millis() + waitMs;
@@ -268,11 +282,32 @@ void     NonVolatileStorage::readStr(uint16_t i, char* j, int16_t maxLen) { read
 
 bool NonVolatileStorage::isNull(uint16_t i, int16_t count) {
   if (count < 0) count = -count;
-  for (int16_t k = 0; k < count; k++) { if (read(i++) != 0) return false; }
+
+  // a block at a time so large areas don't take a storage access per byte
+  while (count > 0) {
+    uint8_t block[32];
+    int16_t n = count < 32 ? count : 32;
+    readBytes(i, block, n);
+    for (int16_t k = 0; k < n; k++) { if (block[k] != 0) return false; }
+    i += n;
+    count -= n;
+  }
   return true;
 }
 
 void NonVolatileStorage::readBytes(uint16_t i, void *j, int16_t count) {
+  if (cacheSize == 0 && !readAndWriteThrough && count > 0) {
+    while (count > 0) {
+      uint8_t n = count < blockReadSize ? count : blockReadSize;
+      readPageFromStorage(i, (uint8_t*)j, n);
+      i += n;
+      j = (uint8_t*)j + n;
+      count -= n;
+    }
+    return;
+  }
+
+  prefetch(i, count < 0 ? -count : count);
   if (count < 0) {
     count = -count;
     for (int16_t k = 0; k < count; k++) { *(uint8_t*)j = read(i++); if (*(uint8_t*)j == 0) return; else j = (uint8_t*)j + 1; }
@@ -281,6 +316,24 @@ void NonVolatileStorage::readBytes(uint16_t i, void *j, int16_t count) {
   }
 }
 
+void NonVolatileStorage::prefetch(uint16_t i, uint16_t count) {
+  if (cacheSize == 0 || cacheSizeUnreadCount == 0 || readAndWriteThrough) return;
+  uint32_t end = (uint32_t)i + count;
+  if (end > cacheSize) end = cacheSize;
+
+  while (i < end) {
+    if (!isDirty(cacheStateRead, i)) { i++; continue; }
+
+    // a block of unread bytes, stopping at any byte the cache already holds
+    uint16_t n = 1;
+    while (n < blockReadSize && i + n < end && isDirty(cacheStateRead, i + n)) n++;
+
+    readPageFromStorage(i, &cache[i], n);
+    for (uint16_t k = 0; k < n; k++) markRead(i + k, false);
+    i += n;
+  }
+}
+
 void NonVolatileStorage::updateBytes(uint16_t i, void *j, int16_t count) {
   if (count < 0) {
     count = -count;
@@ -290,6 +343,105 @@ void NonVolatileStorage::updateBytes(uint16_t i, void *j, int16_t count) {
   }
 }
 
+int8_t NonVolatileStorage::addRegion(uint16_t base, uint16_t count) {
+  if (regionCount >= NV_REGIONS_MAX || count == 0 || (uint32_t)base + count > regionTableBase()) return -1;
+  regions[regionCount].base = base;
+  regions[regionCount].count = count;
+  regionTableChecked = false;
+  return regionCount++;
+}
+
+void NonVolatileStorage::regionPoll() {
+  if (regionCount == 0 || readOnlyMode) return;
+
+  if (regionJob < 0) {
+    // a table without the magic number (new, wiped, or the regions changed) gets all of its CRCs rebuilt
+    if (!regionTableChecked) {
+      regionTableChecked = true;
+      regionTableValid = readUI(regionTableBase()) == regionTableMagic();
+      if (!regionTableValid) { VLF("MSG: NV, region CRC table rebuild"); regionChanged = (1 << regionCount) - 1; }
+    }
+
+    // CRC updates are done from the cache so they go out with the commit of the data they cover
+    if (regionChanged) {
+      regionJob = __builtin_ctz(regionChanged);
+      regionChanged &= ~(1 << regionJob);
+      regionJobVerify = false;
+    } else
+    if (!regionTableValid) {
+      write(regionTableBase(), regionTableMagic());
+      regionTableValid = true;
+      return;
+    } else
+    if ((long)(millis() - regionVerifyTimeMs) >= 0 && committed()) {
+      regionVerifyTimeMs = millis() + NV_REGION_VERIFY_MS/regionCount;
+      regionJob = regionNext;
+      if (++regionNext >= regionCount) regionNext = 0;
+      regionJobVerify = true;
+    } else return;
+
+    regionJobOffset = 0;
+    regionJobCrc = 0xFFFF;
+  }
+
+  // a change while verifying means the stored CRC is about to be replaced, check again later
+  if (regionJobVerify && (regionChanged & (1 << regionJob))) { regionJob = -1; return; }
+
+  // an update works from the cache (the data as written), a verify reads back from storage
+  NvRegion *r = &regions[regionJob];
+  uint8_t block[NV_REGION_BLOCK];
+  uint16_t n = r->count - regionJobOffset;
+  if (n > NV_REGION_BLOCK) n = NV_REGION_BLOCK;
+  if (regionJobVerify) {
+    if (busy()) return;
+    for (uint16_t k = 0; k < n; ) {
+      uint8_t m = (n - k) < blockReadSize ? (n - k) : blockReadSize;
+      readPageFromStorage(r->base + regionJobOffset + k, &block[k], m);
+      k += m;
+    }
+  } else readBytes(r->base + regionJobOffset, block, n);
+  regionJobCrc = crc16(regionJobCrc, block, n);
+  regionJobOffset += n;
+  if (regionJobOffset < r->count) return;
+
+  uint16_t i = regionTableBase() + 2 + regionJob*2;
+  if (regionJobVerify) {
+    if (readUI(i) != regionJobCrc) {
+      if (!(regionErrors & (1 << regionJob))) { DF("WRN: NV, region "); D(regionJob); DLF(" CRC check failed"); }
+      regionErrors |= 1 << regionJob;
+      initError = true;
+    } else regionErrors &= ~(1 << regionJob);
+  } else {
+    // if it changed again while this was running the result is stale, it's queued to be done again
+    if (!(regionChanged & (1 << regionJob))) write(i, regionJobCrc);
+  }
+  regionJob = -1;
+}
+
+uint16_t NonVolatileStorage::regionTableMagic() {
+  return NV_REGION_MAGIC ^ crc16(0xFFFF, (const uint8_t*)regions, regionCount*sizeof(NvRegion));
+}
+
+uint16_t NonVolatileStorage::crcBytes(uint16_t i, uint32_t count, uint16_t crc) {
+  while (count > 0) {
+    uint8_t block[NV_REGION_BLOCK];
+    uint16_t n = count < NV_REGION_BLOCK ? count : NV_REGION_BLOCK;
+    readBytes(i, block, n);
+    crc = crc16(crc, block, n);
+    i += n;
+    count -= n;
+  }
+  return crc;
+}
+
+uint16_t NonVolatileStorage::crc16(uint16_t crc, const uint8_t *data, uint16_t count) {
+  while (count--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t k = 0; k < 8; k++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
 bool NonVolatileStorage::busy() {
   return false;
 }
@@ -6,6 +6,34 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+// transmit buffer size of the Wire library, an I2C write burst is this less the two address bytes
+#ifndef NV_WIRE_BUFFER_SIZE
+  #if defined(I2C_BUFFER_LENGTH)
+    #define NV_WIRE_BUFFER_SIZE I2C_BUFFER_LENGTH
+  #elif defined(BUFFER_LENGTH)
+    #define NV_WIRE_BUFFER_SIZE BUFFER_LENGTH
+  #else
+    #define NV_WIRE_BUFFER_SIZE 32
+  #endif
+#endif
+
+// regions of NV protected by a CRC16, the table of CRCs is kept in the top bytes of NV
+#define NV_REGIONS_MAX         7
+#define NV_REGION_TABLE_SIZE   16            // magic number then a CRC16 for each region
+#define NV_REGION_MAGIC        0xC5A3
+#define NV_REGION_BLOCK        32            // bytes checked per poll
+#ifndef NV_COMMIT_BURSTS
+  #define NV_COMMIT_BURSTS     4             // most write bursts in one poll() while the storage isn't busy
+#endif
+#ifndef NV_REGION_VERIFY_MS
+  #define NV_REGION_VERIFY_MS  60000         // in ms, all regions are verified (in turn) over this period
+#endif
+
+typedef struct NvRegion {
+  uint16_t base;
+  uint16_t count;
+} NvRegion;
+
 class NonVolatileStorage {
   public:
     // prepare      EEPROM, FLASH based emulation, etc. for operation
@@ -46,11 +74,36 @@ class NonVolatileStorage {
     // call frequently to perform any operations that need to happen in the background
     virtual void poll(bool disableInterrupts = true);
 
+    // while held the cache (or buffer) keeps taking writes but nothing is physically written, this is
+    // for times when a storage stall (flash commits mask interrupts) would disturb step timing
+    inline void holdCommits(bool state) { commitHold = state; }
+
+    // time in microseconds spent in physical writes by the most recent commit pass and the worst so far
+    uint32_t commitStallUs = 0;
+    uint32_t commitStallMaxUs = 0;
+
     // returns true if all data in any cache has been written or the commit has been done
     virtual bool committed();
 
     // returns true if all data in nv has passed ongoing validation checks
-    bool valid();
+    inline bool valid() { return regionErrors == 0; }
+
+    // add count bytes starting at position base as a CRC protected region, once changes are committed its
+    // CRC is updated and in the background each region is read back from storage and checked against its CRC
+    // result:      the region number, or -1 if no more regions are available
+    int8_t addRegion(uint16_t base, uint16_t count);
+
+    // CRC-16/CCITT of count bytes of NV starting at position i, a block at a time, continues from crc
+    uint16_t crcBytes(uint16_t i, uint32_t count, uint16_t crc = 0xFFFF);
+
+    // CRC-16/CCITT of count bytes of data, continues from crc
+    uint16_t crc16(uint16_t crc, const uint8_t *data, uint16_t count);
+
+    // base of the region CRC table, the space above this is reserved
+    inline uint16_t regionTableBase() { return size - NV_REGION_TABLE_SIZE; }
+
+    // bit n is set if region n failed verification
+    uint8_t regionErrors = 0;
 
     // causes read/write to ignore cache, write by update is disabled also
     void ignoreCache(bool state);
@@ -119,12 +172,21 @@ class NonVolatileStorage {
     // for char arrays a negative count represents the maximum length to write (if a terminating null is not found)
     inline void writeBytes(uint16_t i, void *j, int16_t count) { updateBytes(i, j, count); }
 
+    // fill the cache for count bytes starting at position i using block reads, so later reads don't go to storage
+    void prefetch(uint16_t i, uint16_t count);
+
     // NV size in bytes
     uint16_t size = 0;
 
+    // bytes of heap allocated for the cache and its state bitmaps
+    inline uint32_t getCacheBytes() { return cacheSize + cacheStateSize*2UL*sizeof(uint32_t); }
+
     bool initError = false;
 
   protected:
+    // number of bytes in storage that don't match j, read a block at a time
+    long verifyErrors(uint8_t j);
+
     // returns false if ready to read or write immediately
     virtual bool busy();
 
@@ -135,34 +197,77 @@ class NonVolatileStorage {
     virtual void writeToStorage(uint16_t i, uint8_t j);
 
     // write value j of count bytes to position starting at i in storage
-    // these writes must be aligned with the page size!
+    // these writes never cross a page boundary or exceed the burst size
     virtual void writePageToStorage(uint16_t i, uint8_t *j, uint8_t count) { writeToStorage(i, *j); (void)(count); }
 
-    // default page write size is 1
-    int pageWriteSize = 1;
+    // read count bytes starting at position i from storage into j, default is a byte at a time
+    virtual void readPageFromStorage(uint16_t i, uint8_t *j, uint8_t count) { for (uint8_t k = 0; k < count; k++) j[k] = readFromStorage(i + k); }
+
+    // device page size, a write burst stays within one page, default is 1
+    uint16_t pageWriteSize = 1;
+
+    // most bytes written in one burst (at most the page size), default is 1
+    uint8_t burstWriteSize = 1;
+
+    // most bytes read in one block, default is 1
+    uint8_t blockReadSize = 1;
 
     bool readAndWriteThrough = false;
     bool readOnlyMode = false;
+    bool commitHold = false;
+
+    // record the time spent in a physical write
+    inline void commitStall(uint32_t us) { commitStallUs = us; if (us > commitStallMaxUs) commitStallMaxUs = us; }
+
+    // cache state bitmaps, one bit per byte (LSB first) in 32 bit words
+    inline bool isDirty(const uint32_t *state, uint16_t i) { return state[i >> 5] & (1UL << (i & 31)); }
+
+    // set or clear the read or write state of a cache byte and keep the dirty counts
+    void markRead(uint16_t i, bool dirty);
+    void markWrite(uint16_t i, bool dirty);
+
+    // index of the next dirty byte at or after i (wrapping around), the count must be > 0
+    uint16_t nextDirty(const uint32_t *state, uint16_t i);
 
-    uint16_t cacheIndex = -1;
+    uint16_t cacheIndex = 0;
     uint16_t cacheSize = 0;
     uint8_t* cache;
     uint16_t cacheStateSize = 0;
-    uint8_t* cacheStateRead;
-    uint8_t* cacheStateWrite;
+    uint32_t* cacheStateRead;
+    uint32_t* cacheStateWrite;
     uint16_t cacheSizeDirtyCount = 0;
+    uint16_t cacheSizeUnreadCount = 0;
 
     uint32_t waitMs = 0;
 
     bool keyMatches = false;
 
+    // flag the region(s) holding position i as changed
+    inline void regionChange(uint16_t i) { for (uint8_t n = 0; n < regionCount; n++) if ((uint16_t)(i - regions[n].base) < regions[n].count) regionChanged |= 1 << n; }
+
+    // update or verify region CRCs a block at a time, in the background
+    void regionPoll();
+
+    // the magic number depends on the region layout, so a change in layout rebuilds the table
+    uint16_t regionTableMagic();
+
+    NvRegion regions[NV_REGIONS_MAX];
+    uint8_t regionCount = 0;
+    uint8_t regionChanged = 0;
+    bool regionTableChecked = false;
+    bool regionTableValid = false;
+    int8_t regionJob = -1;
+    bool regionJobVerify = false;
+    uint16_t regionJobOffset = 0;
+    uint16_t regionJobCrc = 0;
+    uint8_t regionNext = 0;
+    uint32_t regionVerifyTimeMs = 0;
+
     // a quick to access flag to tell us if delayed commit is enabled
     bool delayedCommitEnabled = false;
 
-    // true if the entire cache was clean for the pass 
-    bool cacheCleanThisPass = false;
-    // if the entire cache is up to date, skip the scanning
-    bool cacheClean = false;
-
     uint32_t commitReadyTimeMs = 0;
+
+    // health counter for the bytes physically written, wear on the storage
+    uint8_t bytesWrittenCounter = 0;
 };
@@ -13,8 +13,16 @@ bool NonVolatileStorage24XX::init(uint16_t size, bool cacheEnable, uint16_t wait
   // setup size, cache, etc.
   NonVolatileStorage::init(size, cacheEnable, wait, checkEnable, wire, address);
 
-  // device page size must be >= 8 and a multipule of 8
-  if (cacheEnable) pageWriteSize = 8;
+  // page size by device size, 24LC16 16 bytes, 24LC32/64 32 bytes, 24LC128/256 64 bytes, 24LC512 128 bytes
+  if (cacheEnable) {
+    if (size <= 2048) pageWriteSize = 16; else
+    if (size <= 8192) pageWriteSize = 32; else
+    if (size <= 32768) pageWriteSize = 64; else pageWriteSize = 128;
+    burstWriteSize = min(pageWriteSize, (uint16_t)(NV_WIRE_BUFFER_SIZE - 2));
+  }
+
+  // sequential reads run across pages, a block is limited only by the Wire receive buffer
+  blockReadSize = NV_WIRE_BUFFER_SIZE > 255 ? 255 : NV_WIRE_BUFFER_SIZE;
 
   this->wire = wire;
   eepromAddress = address;
@@ -54,7 +62,7 @@ void NonVolatileStorage24XX::writeToStorage(uint16_t i,  uint8_t j) {
 }
 
 // write value j of count bytes to position starting at i in storage
-// these writes must be aligned with the page size!
+// these writes never cross a page boundary
 void NonVolatileStorage24XX::writePageToStorage(uint16_t i, uint8_t *j, uint8_t count) {
   while (busy()) {}
 
@@ -65,3 +73,14 @@ void NonVolatileStorage24XX::writePageToStorage(uint16_t i, uint8_t *j, uint8_t
   wire->endTransmission();
   nextOpMs = millis() + EEPROM_WRITE_WAIT;
 }
+
+void NonVolatileStorage24XX::readPageFromStorage(uint16_t i, uint8_t *j, uint8_t count) {
+  while (busy()) {}
+  wire->beginTransmission(eepromAddress);
+  wire->write(MSB(i));
+  wire->write(LSB(i));
+  wire->endTransmission();
+
+  uint8_t received = wire->requestFrom(eepromAddress, count);
+  for (uint8_t k = 0; k < count; k++) j[k] = (k < received && wire->available()) ? wire->read() : 0;
+}
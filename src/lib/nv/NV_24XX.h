@@ -29,8 +29,11 @@ class NonVolatileStorage24XX : public NonVolatileStorage {
     void writeToStorage(uint16_t i, uint8_t j);
 
     // write value j of count bytes to position starting at i in storage
-    // these writes must be aligned with the page size!
+    // these writes never cross a page boundary
     void writePageToStorage(uint16_t i, uint8_t *j, uint8_t count);
+
+    // read count bytes starting at position i from storage into j, in one sequential read
+    void readPageFromStorage(uint16_t i, uint8_t *j, uint8_t count);
  
     TwoWire* wire;
     uint8_t eepromAddress = 0;
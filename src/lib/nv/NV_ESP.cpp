@@ -22,7 +22,10 @@
   }
 
   void NonVolatileStorageESP::poll(bool disableInterrupts) {
-    if (dirty && ((long)(millis() - commitReadyTimeMs) >= 0)) {
+    regionPoll();
+
+    if (dirty && !commitHold && ((long)(millis() - commitReadyTimeMs) >= 0)) {
+      uint32_t startUs = micros();
       #if defined(ESP32)
         if (disableInterrupts) timerAlarmsDisable();
       #endif
@@ -30,6 +33,7 @@
       #if defined(ESP32)
         if (disableInterrupts) timerAlarmsEnable();
       #endif
+      commitStall(micros() - startUs);
       dirty = false;
     }
     #if !defined(ESP32)
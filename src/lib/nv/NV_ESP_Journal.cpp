@@ -0,0 +1,31 @@
+// -----------------------------------------------------------------------------------
+// non-volatile storage (log structured journal in a flash data partition, ESP32)
+
+#include "NV_ESP_Journal.h"
+
+#if defined(ESP32)
+
+  bool NonVolatileStorageESPJournal::flashBegin() {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, NV_PARTITION);
+    if (partition == NULL) return false;
+
+    bankSize = partition->size/2;
+    if (bankSize > NV_JOURNAL_BANK_SIZE) bankSize = NV_JOURNAL_BANK_SIZE;
+    bankSize -= bankSize % SPI_FLASH_SEC_SIZE;
+
+    return bankSize > 0;
+  }
+
+  bool NonVolatileStorageESPJournal::flashErase(uint32_t address, uint32_t count) {
+    return esp_partition_erase_range(partition, address, count) == ESP_OK;
+  }
+
+  bool NonVolatileStorageESPJournal::flashWrite(uint32_t address, const uint8_t *data, uint16_t count) {
+    return esp_partition_write(partition, address, data, count) == ESP_OK;
+  }
+
+  bool NonVolatileStorageESPJournal::flashRead(uint32_t address, uint8_t *data, uint16_t count) {
+    return esp_partition_read(partition, address, data, count) == ESP_OK;
+  }
+
+#endif
@@ -0,0 +1,36 @@
+// -----------------------------------------------------------------------------------
+// non-volatile storage (log structured journal in a flash data partition, ESP32)
+
+#pragma once
+
+#include <Arduino.h>
+
+#if defined(ESP32)
+
+  #include "NV_Journal.h"
+  #include "esp_partition.h"
+
+  // label of the data partition used, the default partition tables have an (otherwise unused) "spiffs" partition
+  #ifndef NV_PARTITION
+    #define NV_PARTITION "spiffs"
+  #endif
+
+  // upper limit on the size of each of the two banks, the rest of the partition is left alone
+  #ifndef NV_JOURNAL_BANK_SIZE
+    #define NV_JOURNAL_BANK_SIZE 32768
+  #endif
+
+  class NonVolatileStorageESPJournal : public NonVolatileStorageJournal {
+    protected:
+      bool flashBegin();
+      bool flashErase(uint32_t address, uint32_t count);
+      bool flashWrite(uint32_t address, const uint8_t *data, uint16_t count);
+      bool flashRead(uint32_t address, uint8_t *data, uint16_t count);
+
+    private:
+      const esp_partition_t *partition = NULL;
+  };
+
+  #define NVS NonVolatileStorageESPJournal
+
+#endif
@@ -0,0 +1,158 @@
+// -----------------------------------------------------------------------------------
+// non-volatile storage (log structured journal in flash, wear leveled)
+
+#include "NV_Journal.h"
+#include "../debug/Debug.h"
+
+bool NonVolatileStorageJournal::init(uint16_t size, bool cacheEnable, uint16_t wait, bool checkEnable, TwoWire* wire, uint8_t address) {
+  if (!flashBegin()) { DLF("ERR: NV, journal flash region not found"); return false; }
+
+  // a snapshot of the full image has to fit in a bank with room left for records
+  uint32_t snapshotSize = NV_JOURNAL_BANK_HEADER + ((size + NV_JOURNAL_RECORD_DATA - 1)/NV_JOURNAL_RECORD_DATA)*(NV_JOURNAL_RECORD_HEADER + NV_JOURNAL_RECORD_DATA);
+  if (bankSize < snapshotSize*2) { DLF("ERR: NV, journal flash region too small"); return false; }
+
+  // setup size, cache, etc.
+  NonVolatileStorage::init(size, true, wait, checkEnable, wire, address);
+  (void)(cacheEnable);
+
+  // records can start anywhere and hold up to NV_JOURNAL_RECORD_DATA bytes
+  pageWriteSize = size;
+  burstWriteSize = NV_JOURNAL_RECORD_DATA;
+
+  memset(cache, 0xFF, size);
+  mount();
+
+  // the image is complete, nothing is left to read
+  for (uint16_t i = 0; i < cacheStateSize; i++) cacheStateRead[i] = 0;
+  cacheSizeUnreadCount = 0;
+
+  return true;
+}
+
+uint8_t NonVolatileStorageJournal::readFromStorage(uint16_t i) {
+  return cache[i];
+}
+
+void NonVolatileStorageJournal::writeToStorage(uint16_t i, uint8_t j) {
+  writePageToStorage(i, &j, 1);
+}
+
+void NonVolatileStorageJournal::writePageToStorage(uint16_t i, uint8_t *j, uint8_t count) {
+  // when the bank is full the snapshot picks this write up along with the rest of the image
+  if (!append(i, j, count)) compact();
+}
+
+void NonVolatileStorageJournal::mount() {
+  uint32_t header[2][2];
+  bool valid[2];
+  for (uint8_t b = 0; b < 2; b++) {
+    valid[b] = flashRead(b*bankSize, (uint8_t*)header[b], NV_JOURNAL_BANK_HEADER) &&
+               header[b][0] == NV_JOURNAL_MAGIC && header[b][1] != 0xFFFFFFFFUL;
+  }
+
+  if (!valid[0] && !valid[1]) {
+    VLF("MSG: NV, journal is empty, formatting");
+    activeBank = 1;
+    sequence = 0;
+    compact();
+    return;
+  }
+
+  if (valid[0] && valid[1]) activeBank = (int32_t)(header[1][1] - header[0][1]) > 0 ? 1 : 0; else activeBank = valid[1] ? 1 : 0;
+  sequence = header[activeBank][1];
+
+  // a record cut short by a power loss ends the replay, start over in a clean bank
+  if (!replay()) {
+    DLF("WRN: NV, journal has a bad record, compacting");
+    compact();
+  }
+}
+
+bool NonVolatileStorageJournal::replay() {
+  uint32_t base = activeBank*bankSize;
+  writeOffset = NV_JOURNAL_BANK_HEADER;
+
+  while (writeOffset + NV_JOURNAL_RECORD_HEADER <= bankSize) {
+    uint8_t record[NV_JOURNAL_RECORD_HEADER + NV_JOURNAL_RECORD_DATA];
+    if (!flashRead(base + writeOffset, record, NV_JOURNAL_RECORD_HEADER)) return false;
+
+    uint16_t i = record[0] | (record[1] << 8);
+    uint8_t count = record[2];
+
+    // erased flash marks the end of the journal
+    if (i == 0xFFFF && count == 0xFF && record[3] == 0xFF) return true;
+
+    if (count == 0 || count > NV_JOURNAL_RECORD_DATA || (uint32_t)i + count > size) return false;
+    uint16_t length = NV_JOURNAL_RECORD_HEADER + ((count + 3) & ~3);
+    if (writeOffset + length > bankSize) return false;
+    if (!flashRead(base + writeOffset + NV_JOURNAL_RECORD_HEADER, &record[NV_JOURNAL_RECORD_HEADER], count)) return false;
+    if (crc8(crc8(0, record, 3), &record[NV_JOURNAL_RECORD_HEADER], count) != record[3]) return false;
+
+    memcpy(&cache[i], &record[NV_JOURNAL_RECORD_HEADER], count);
+    writeOffset += length;
+  }
+  return true;
+}
+
+bool NonVolatileStorageJournal::append(uint16_t i, const uint8_t *j, uint8_t count) {
+  uint16_t length = NV_JOURNAL_RECORD_HEADER + ((count + 3) & ~3);
+  if (writeOffset + length > bankSize) return false;
+
+  if (writeRecord(activeBank, writeOffset, i, j, count) == 0) { DLF("ERR: NV, journal write failed"); initError = true; }
+  writeOffset += length;
+  return true;
+}
+
+void NonVolatileStorageJournal::compact() {
+  uint8_t target = activeBank ^ 1;
+  uint32_t offset = NV_JOURNAL_BANK_HEADER;
+
+  if (!flashErase(target*bankSize, bankSize)) { DLF("ERR: NV, journal erase failed"); initError = true; return; }
+
+  // erased bytes are the default so blocks that are all 0xFF are left out
+  for (uint32_t i = 0; i < size; i += NV_JOURNAL_RECORD_DATA) {
+    uint8_t count = (size - i < NV_JOURNAL_RECORD_DATA) ? size - i : NV_JOURNAL_RECORD_DATA;
+    bool erased = true;
+    for (uint8_t k = 0; k < count; k++) if (cache[i + k] != 0xFF) { erased = false; break; }
+    if (erased) continue;
+
+    uint16_t length = writeRecord(target, offset, i, &cache[i], count);
+    if (length == 0) { DLF("ERR: NV, journal write failed"); initError = true; return; }
+    offset += length;
+  }
+
+  // the header goes last, until it's written the old bank is still the one used at startup
+  uint32_t header[2] = { NV_JOURNAL_MAGIC, sequence + 1 };
+  if (!flashWrite(target*bankSize, (uint8_t*)header, NV_JOURNAL_BANK_HEADER)) { DLF("ERR: NV, journal write failed"); initError = true; return; }
+
+  activeBank = target;
+  sequence++;
+  writeOffset = offset;
+
+  // the snapshot holds everything that was waiting to be written
+  for (uint16_t k = 0; k < cacheStateSize; k++) cacheStateWrite[k] = 0;
+  cacheSizeDirtyCount = 0;
+}
+
+uint16_t NonVolatileStorageJournal::writeRecord(uint8_t b, uint32_t offset, uint16_t i, const uint8_t *j, uint8_t count) {
+  uint8_t record[NV_JOURNAL_RECORD_HEADER + NV_JOURNAL_RECORD_DATA];
+  uint16_t length = NV_JOURNAL_RECORD_HEADER + ((count + 3) & ~3);
+
+  memset(record, 0xFF, length);
+  record[0] = i & 0xFF;
+  record[1] = i >> 8;
+  record[2] = count;
+  memcpy(&record[NV_JOURNAL_RECORD_HEADER], j, count);
+  record[3] = crc8(crc8(0, record, 3), j, count);
+
+  if (!flashWrite(b*bankSize + offset, record, length)) return 0;
+  return length;
+}
+
+uint8_t NonVolatileStorageJournal::crc8(uint8_t crc, const uint8_t *data, uint16_t count) {
+  while (count--) {
+    crc ^= *data++;
+    for (uint8_t k = 0; k < 8; k++) crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : crc << 1;
+  }
+  return crc;
+}
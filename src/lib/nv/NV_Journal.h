@@ -0,0 +1,73 @@
+// -----------------------------------------------------------------------------------
+// non-volatile storage (log structured journal in flash, wear leveled)
+//
+// The whole NV image lives in the cache, changes are appended to flash as small address/data
+// records instead of rewriting a sector on each commit.  The flash region is split into two banks,
+// when the active bank fills a snapshot of the image goes into the other bank (compaction) and that
+// becomes the active bank.  At startup the newest bank is replayed to rebuild the image.
+
+#pragma once
+
+#include <Arduino.h>
+#include "NV.h"
+
+#define NV_JOURNAL_MAGIC       0x4A58534FUL  // "OSXJ"
+#define NV_JOURNAL_BANK_HEADER 8             // magic and sequence number
+#define NV_JOURNAL_RECORD_HEADER 4           // address (2 bytes), count, crc
+#define NV_JOURNAL_RECORD_DATA 32            // most data bytes in one record
+
+class NonVolatileStorageJournal : public NonVolatileStorage {
+  public:
+    // prepare the journal for operation, the cache is always enabled since it holds the image
+    // size:        NV size in bytes
+    // cacheEnable: ignored
+    // wait:        minimum time in milliseconds to wait (after last write) before appending records
+    // checkEnable: enable or disable checksum error detection
+    // wire:        I2C interface pointer (set to NULL if not used)
+    // address:     I2C address
+    // result:      true if the flash region was found and the journal mounted, or false if not
+    bool init(uint16_t size, bool cacheEnable, uint16_t wait, bool checkEnable, TwoWire* wire = NULL, uint8_t address = 0);
+
+  protected:
+    // find the flash region and set bankSize (a multiple of the erase size), returns false if not available
+    virtual bool flashBegin() = 0;
+
+    // erase, write, or read count bytes at address (an offset into the flash region), return false on failure
+    virtual bool flashErase(uint32_t address, uint32_t count) = 0;
+    virtual bool flashWrite(uint32_t address, const uint8_t *data, uint16_t count) = 0;
+    virtual bool flashRead(uint32_t address, uint8_t *data, uint16_t count) = 0;
+
+    // size of each of the two banks in bytes
+    uint32_t bankSize = 0;
+
+  private:
+    // the image is always in the cache
+    uint8_t readFromStorage(uint16_t i);
+
+    // append a one byte record
+    void writeToStorage(uint16_t i, uint8_t j);
+
+    // append a record of count bytes
+    void writePageToStorage(uint16_t i, uint8_t *j, uint8_t count);
+
+    // pick the newest bank and replay it into the image
+    void mount();
+
+    // apply the records in the active bank to the image, false if a bad (torn) record was found
+    bool replay();
+
+    // write a record at the end of the active bank, false if it doesn't fit
+    bool append(uint16_t i, const uint8_t *j, uint8_t count);
+
+    // write a snapshot of the image into the other bank and make it the active bank
+    void compact();
+
+    // writes a record at offset in bank b, returns the record length or 0 on failure
+    uint16_t writeRecord(uint8_t b, uint32_t offset, uint16_t i, const uint8_t *j, uint8_t count);
+
+    uint8_t crc8(uint8_t crc, const uint8_t *data, uint16_t count);
+
+    uint8_t activeBank = 0;
+    uint32_t sequence = 0;
+    uint32_t writeOffset = 0;
+};
@@ -15,8 +15,12 @@
   }
 
   void NonVolatileStorageM0::poll(bool disableInterrupts) {
-    if (dirty && ((long)(millis() - commitReadyTimeMs) >= 0)) {
+    regionPoll();
+
+    if (dirty && !commitHold && ((long)(millis() - commitReadyTimeMs) >= 0)) {
+      uint32_t startUs = micros();
       EEPROM.commit();
+      commitStall(micros() - startUs);
       dirty = false;
     }
     // stop compiler warnings
@@ -13,6 +13,15 @@ bool NonVolatileStorageMB85RC::init(uint16_t size, bool cacheEnable, uint16_t wa
   // setup size, cache, etc.
   NonVolatileStorage::init(size, cacheEnable, wait, checkEnable, wire, address);
 
+  // FRAM has no pages, any run of bytes can be written in one sequential burst
+  if (cacheEnable) {
+    pageWriteSize = size;
+    burstWriteSize = NV_WIRE_BUFFER_SIZE - 2;
+  }
+
+  // a block is limited only by the Wire receive buffer
+  blockReadSize = NV_WIRE_BUFFER_SIZE > 255 ? 255 : NV_WIRE_BUFFER_SIZE;
+
   this->wire = wire;
   framAddress = address;
   wire->begin();
@@ -54,3 +63,25 @@ void NonVolatileStorageMB85RC::writeToStorage(uint16_t i,  uint8_t j) {
   nextOpMs = millis() + FRAM_WRITE_WAIT;
 }
 
+// write value j of count bytes to position starting at i in storage
+void NonVolatileStorageMB85RC::writePageToStorage(uint16_t i, uint8_t *j, uint8_t count) {
+  while (busy()) {}
+
+  wire->beginTransmission(framAddress);
+  wire->write(MSB(i));
+  wire->write(LSB(i));
+  wire->write(j, count);
+  wire->endTransmission();
+  nextOpMs = millis() + FRAM_WRITE_WAIT;
+}
+
+void NonVolatileStorageMB85RC::readPageFromStorage(uint16_t i, uint8_t *j, uint8_t count) {
+  while (busy()) {}
+  wire->beginTransmission(framAddress);
+  wire->write(MSB(i));
+  wire->write(LSB(i));
+  wire->endTransmission();
+
+  uint8_t received = wire->requestFrom(framAddress, count);
+  for (uint8_t k = 0; k < count; k++) j[k] = (k < received && wire->available()) ? wire->read() : 0;
+}
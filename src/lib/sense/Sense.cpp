@@ -10,6 +10,29 @@
   #define ANALOG_READ_RANGE 1023
 #endif
 
+#if SENSE_SAMPLED == ON
+  void senseSampleWrapper() { sense.poll(); }
+#endif
+
+IRAM_ATTR void senseEdge1() { sense.edge(0); }
+IRAM_ATTR void senseEdge2() { sense.edge(1); }
+IRAM_ATTR void senseEdge3() { sense.edge(2); }
+IRAM_ATTR void senseEdge4() { sense.edge(3); }
+IRAM_ATTR void senseEdge5() { sense.edge(4); }
+IRAM_ATTR void senseEdge6() { sense.edge(5); }
+IRAM_ATTR void senseEdge7() { sense.edge(6); }
+IRAM_ATTR void senseEdge8() { sense.edge(7); }
+IRAM_ATTR void senseEdge9() { sense.edge(8); }
+IRAM_ATTR void senseEdge10() { sense.edge(9); }
+IRAM_ATTR void senseEdge11() { sense.edge(10); }
+IRAM_ATTR void senseEdge12() { sense.edge(11); }
+IRAM_ATTR void senseEdge13() { sense.edge(12); }
+IRAM_ATTR void senseEdge14() { sense.edge(13); }
+IRAM_ATTR void senseEdge15() { sense.edge(14); }
+IRAM_ATTR void senseEdge16() { sense.edge(15); }
+void (*senseEdge[SENSE_INTERRUPT_MAX])() = { senseEdge1, senseEdge2, senseEdge3, senseEdge4, senseEdge5, senseEdge6, senseEdge7, senseEdge8,
+                                             senseEdge9, senseEdge10, senseEdge11, senseEdge12, senseEdge13, senseEdge14, senseEdge15, senseEdge16 };
+
 SenseInput::SenseInput(int pin, int initState, int32_t trigger) {
   this->pin = pin;
 
@@ -49,6 +72,8 @@ SenseInput::SenseInput(int pin, int initState, int32_t trigger) {
 
 int SenseInput::isOn() {
   int value = lastValue;
+  if (isInterrupt) value = stableValue(); else
+  if (isSampled) value = sampledValue; else
   if (isAnalog) {
     int sample = analogRead(pin);
     if (sample >= threshold + hysteresis) value = HIGH;
@@ -65,6 +90,8 @@ int SenseInput::isOn() {
 
 int SenseInput::changed() {
   int value = lastChangedValue;
+  if (isInterrupt) value = stableValue(); else
+  if (isSampled) value = sampledValue; else
   if (isAnalog) {
     int sample = analogRead(pin);
     if (sample >= threshold + hysteresis) value = HIGH;
@@ -81,6 +108,22 @@ int SenseInput::changed() {
 }
 
 void SenseInput::poll() {
+  if (isSampled) {
+    int value = sampledValue;
+    if (isAnalog) {
+      int sample = analogRead(pin);
+      if (sample >= threshold + hysteresis) value = HIGH;
+      if (sample <= threshold - hysteresis) value = LOW;
+    } else {
+      int sample = digitalReadEx(pin);
+      unsigned long now = millis();
+      if (stableSample != sample) { stableStartMs = now; stableSample = sample; }
+      if ((long)(now - stableStartMs) >= hysteresis) value = stableSample;
+    }
+    sampledValue = value;
+    return;
+  }
+
   int value = lastValue;
   if (!isAnalog) {
     int sample = digitalReadEx(pin);
@@ -91,9 +134,41 @@ void SenseInput::poll() {
   lastValue = value;
 }
 
+bool SenseInput::attachEdge(void (*isr)()) {
+  if (isInterrupt) return true;
+  if (isAnalog || pin < 0 || pin >= 0x100) return false;
+  #ifdef NOT_AN_INTERRUPT
+    if (digitalPinToInterrupt(CLEAN_PIN(pin)) == NOT_AN_INTERRUPT) return false;
+  #endif
+  noInterrupts();
+  stableSample = digitalReadEx(pin);
+  stableStartMs = millis();
+  interrupts();
+  attachInterrupt(digitalPinToInterrupt(CLEAN_PIN(pin)), isr, CHANGE);
+  isInterrupt = true;
+  return true;
+}
+
+IRAM_ATTR void SenseInput::edge() {
+  // the debounce time starts over at each edge, until then the last stable state holds
+  int sample = digitalReadEx(pin);
+  if (sample != stableSample) { stableSample = sample; stableStartMs = millis(); }
+  edgeMicros = micros();
+  if (edgeCallback != NULL) edgeCallback();
+}
+
+int SenseInput::stableValue() {
+  noInterrupts();
+  int sample = stableSample;
+  long stableMs = (long)(millis() - stableStartMs);
+  interrupts();
+  if (stableMs >= hysteresis) return sample; else return lastValue;
+}
+
 void SenseInput::reset() {
   if (isAnalog) { if ((int)analogRead(pin) > threshold) lastValue = HIGH; else lastValue = LOW; } else lastValue = digitalReadEx(pin);
   stableSample = lastValue;
+  sampledValue = lastValue;
 }
 
 // Manage sense pins
@@ -108,7 +183,21 @@ uint8_t Sense::add(int pin, int initState, int32_t trigger, bool force) {
   }
   VF("MSG: Sense"); V(senseCount); V(", init ");
   senseInput[senseCount] = new SenseInput(pin, initState, trigger);
+  #if SENSE_INTERRUPT == ON
+    if (senseCount < SENSE_INTERRUPT_MAX && senseInput[senseCount]->attachEdge(senseEdge[senseCount])) { VLF("MSG: Sense, on pin change"); }
+  #endif
   senseCount++;
+
+  #if SENSE_SAMPLED == ON
+    if (sampleHandle == 0) {
+      VF("MSG: Sense, start input sampling task (rate "); V(SENSE_SAMPLE_PERIOD_MS); VF("ms priority 2)... ");
+      sampleHandle = tasks.add(SENSE_SAMPLE_PERIOD_MS, 0, true, 2, senseSampleWrapper, "Sense");
+      if (sampleHandle) { VLF("success"); } else { VLF("FAILED!"); }
+    }
+    // without the task the input is read each time it's checked
+    if (!senseInput[senseCount - 1]->isInterrupt) senseInput[senseCount - 1]->isSampled = sampleHandle != 0;
+  #endif
+
   return senseCount;
 }
 
@@ -122,8 +211,27 @@ int Sense::changed(uint8_t handle) {
   return senseInput[handle - 1]->changed();
 }
 
+bool Sense::onEdge(uint8_t handle, void (*callback)()) {
+  if (handle == 0 || handle > SENSE_INTERRUPT_MAX) return false;
+  if (!senseInput[handle - 1]->attachEdge(senseEdge[handle - 1])) return false;
+  senseInput[handle - 1]->edgeCallback = callback;
+  return true;
+}
+
+unsigned long Sense::edgeMicros(uint8_t handle) {
+  if (handle == 0) return 0;
+  noInterrupts();
+  unsigned long t = senseInput[handle - 1]->edgeMicros;
+  interrupts();
+  return t;
+}
+
 void Sense::poll() {
-  for (int i = 0; i < senseCount; i++) { senseInput[i]->poll(); Y; }
+  for (int i = 0; i < senseCount; i++) { if (!senseInput[i]->isInterrupt) senseInput[i]->poll(); Y; }
+}
+
+IRAM_ATTR void Sense::edge(uint8_t index) {
+  senseInput[index]->edge();
 }
 
 Sense sense;
@@ -21,6 +21,23 @@
   #define SENSE_MAX 8
 #endif
 
+// ON reads digital sense inputs on MCU pins on pin change (interrupt), not each time they're checked
+#ifndef SENSE_INTERRUPT
+  #define SENSE_INTERRUPT OFF
+#endif
+
+// sense inputs past this many are always polled
+#define SENSE_INTERRUPT_MAX 16
+
+// ON reads all polled sense inputs (analog and digital) once each period from a task, so isOn() and changed()
+// just return the last sample rather than doing an ADC, pin, or I2C expander read each time they're checked
+#ifndef SENSE_SAMPLED
+  #define SENSE_SAMPLED OFF
+#endif
+#ifndef SENSE_SAMPLE_PERIOD_MS
+  #define SENSE_SAMPLE_PERIOD_MS 5
+#endif
+
 // largest possible trigger value == 2^21
 #define SENSE_MAX_TRIGGER 2097152
 
@@ -33,9 +50,24 @@ class SenseInput {
 
     void poll();
 
+    // read the pin on change, isr is the function the pin change interrupt calls
+    bool attachEdge(void (*isr)());
+
+    // called from the pin change ISR
+    void edge();
+
+    bool isInterrupt = false;
+    // isOn() and changed() return the last sample taken by poll()
+    bool isSampled = false;
+    volatile unsigned long edgeMicros = 0;
+    void (*volatile edgeCallback)() = NULL;
+
   private:
     void reset();
 
+    // the stable (debounced) pin state
+    int stableValue();
+
     int pin;
     int activeState = OFF;
     bool isAnalog;
@@ -45,8 +77,10 @@ class SenseInput {
     int lastValue = LOW;
     int lastChangedValue = LOW;
     int lastResult = LOW;
-    int stableSample = 0;
-    unsigned long stableStartMs = 0;
+    volatile int stableSample = 0;
+    volatile unsigned long stableStartMs = 0;
+    // the debounced or schmitt triggered state from the last sample
+    volatile int sampledValue = LOW;
 };
 
 class Sense {
@@ -68,12 +102,28 @@ class Sense {
     // \param handle      sense handle
     int changed(uint8_t handle);
 
-    // call repeatedly to check inputs for changes
+    // call a function from the pin change ISR on each edge, the input is read on change from then on
+    // \param handle      sense handle
+    // \param callback    function to call, keep it short
+    // \returns           true if the input is now interrupt driven, false if it's polled (no callback)
+    bool onEdge(uint8_t handle, void (*callback)());
+
+    // time of the last edge seen by an interrupt driven input, in microseconds
+    // \param handle      sense handle
+    unsigned long edgeMicros(uint8_t handle);
+
+    // call repeatedly to check inputs for changes, with SENSE_SAMPLED ON the sampling task does this
     void poll();
 
+    // called from the pin change ISR for sense input index
+    void edge(uint8_t index);
+
   private:
     uint8_t senseCount = 0;
     SenseInput *senseInput[SENSE_MAX];
+    #if SENSE_SAMPLED == ON
+      uint8_t sampleHandle = 0;
+    #endif
 };
 
 extern Sense sense;
@@ -42,6 +42,7 @@
       #endif
       cmdSvrClient.stop();
     }
+    txCount = 0;
   }
 
   int IPSerial::available(void) {
@@ -62,6 +63,7 @@
           VLF("MSG: available(), not connected STOP cmdSvrClient");
         #endif
         cmdSvrClient.stop();
+        txCount = 0;
         return 0;
       }
       if ((long)(clientEndTimeMs - millis()) < 0) {
@@ -69,10 +71,13 @@
           VLF("MSG: available(), timed out STOP cmdSvrClient");
         #endif
         cmdSvrClient.stop();
+        txCount = 0;
         return 0;
       }
     }
 
+    if (txCount > 0 && (long)(millis() - txTimeMs) >= IP_TX_COALESCE_MS) send();
+
     int i = cmdSvrClient.available();
 
     #if DEBUG_CMDSERVER == ON
@@ -89,6 +94,7 @@
 
   void IPSerial::flush(void) {
     if (!ethernetManager.active || !cmdSvrClient) return;
+    send();
     cmdSvrClient.flush();
   }
 
@@ -102,14 +108,34 @@
     return c;
   }
 
-  size_t IPSerial::write(uint8_t data) {
+  size_t IPSerial::read(uint8_t *buffer, size_t count) {
     if (!ethernetManager.active || !cmdSvrClient) return 0;
-    return cmdSvrClient.write(data);
+    if (persist) clientEndTimeMs = millis() + clientTimeoutMs;
+    int i = cmdSvrClient.read(buffer, count);
+    #if DEBUG_CMDSERVER == ON
+      if (i > 0) { VF("MSG: read(), found "); V(i); VLF(" chars"); }
+    #endif
+    return i > 0 ? i : 0;
+  }
+
+  size_t IPSerial::write(uint8_t data) {
+    return write(&data, 1);
   }
 
   size_t IPSerial::write(const uint8_t *data, size_t count) {
     if (!ethernetManager.active || !cmdSvrClient) return 0;
-    return cmdSvrClient.write(data, count);
+    if (txCount + count > IP_TX_COALESCE_SIZE) send();
+    if (count > IP_TX_COALESCE_SIZE) return cmdSvrClient.write(data, count);
+    if (txCount == 0) txTimeMs = millis();
+    memcpy(&tx[txCount], data, count);
+    txCount += count;
+    return count;
+  }
+
+  void IPSerial::send() {
+    if (txCount == 0) return;
+    if (cmdSvrClient.connected()) cmdSvrClient.write(tx, txCount);
+    txCount = 0;
   }
 
   #if SERIAL_SERVER == STANDARD || SERIAL_SERVER == BOTH
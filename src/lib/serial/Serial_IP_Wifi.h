@@ -19,6 +19,9 @@
     #error "Configuration (Config.h): No Wifi support is present for this device"
   #endif
 
+  #define IP_TX_COALESCE_SIZE 192 // replies are gathered and sent as one TCP segment up to this size
+  #define IP_TX_COALESCE_MS   20  // upper bound on how long a reply waits to be sent
+
   class IPSerial : public Stream {
     public:
       void begin(long port, unsigned long clientTimeoutMs = 2000, bool persist = false);
@@ -27,6 +30,9 @@
 
       int read(void);
 
+      // read up to count bytes that are already waiting, returns the number read
+      size_t read(uint8_t *buffer, size_t count);
+
       int available(void);
 
       int peek(void);
@@ -35,8 +41,12 @@
 
       size_t write(uint8_t data);
 
+      // gathered until send() or the buffer fills
       size_t write(const uint8_t* data, size_t count);
 
+      // send any gathered replies in a single write
+      void send();
+
       inline size_t write(unsigned long n) { return write((uint8_t)n); }
       inline size_t write(long n) { return write((uint8_t)n); }
       inline size_t write(unsigned int n) { return write((uint8_t)n); }
@@ -48,6 +58,10 @@
       WiFiServer *cmdSvr;
       WiFiClient cmdSvrClient;
 
+      uint8_t tx[IP_TX_COALESCE_SIZE];
+      uint16_t txCount = 0;
+      unsigned long txTimeMs = 0;
+
       int port = -1;
       unsigned long clientTimeoutMs;
       unsigned long clientEndTimeMs = 0;
@@ -1,5 +1,5 @@
 // -----------------------------------------------------------------------------------
-// Low overhead communication routines for Serial0, Serial1
+// Low overhead communication routines for Serial0 to Serial3, interrupt driven receive and transmit
 
 #include "Serial_MEGA2560.h"
 
@@ -10,30 +10,31 @@
 #define MSB(i) (i >> 8)
 #define LSB(i) (i & 0xFF)
 
-#ifdef HAL_POLLING_MEGA2560_SERIAL_A
+0ifdef HAL_POLLING_MEGA2560_SERIAL_A
 
 void PollingSerialA::begin(long baud) {
   // init the buffers
-  xmit_index = 0; xmit_buffer[0] = 0; recv_head = 0; recv_tail = 0; recv_buffer[0] = 0;
+  xmit_head = 0; xmit_tail = 0; recv_head = 0; recv_tail = 0; recv_buffer[0] = 0; rxOverruns = 0;
+  ucsrb = &UCSR0B; udrie = (1<<UDRIE0);
 
   // Set baud rate
-  uint16_t ubrr = F_CPU/16/baud - 1;
-  UBRR0H = MSB(ubrr);
-  UBRR0L = LSB(ubrr);
+  uint16_t rate = ubrr(baud);
+  UBRR0H = MSB(rate);
+  UBRR0L = LSB(rate);
 
-  // Disable U2X mode
-  UCSR0A = 0;
+  // Enable U2X mode, 16x mode is 8.5% off at 115200 baud with a 16MHz clock
+  UCSR0A = (1<<U2X0);
 
   // Enable receiver and transmitter
   UCSR0B = (1<<RXEN0) | (1<<TXEN0) | (1<<RXCIE0);
 
   // 8-bit, 1 stop bit, no parity, asynchronous UART
-  UCSR0C = (1 << UCSZ01) | (1 << UCSZ00) | (0 << USBS0)   |
-            (0 << UPM01)  | (0 << UPM00)  | (0 << UMSEL01) |
-            (0 << UMSEL00);
+  UCSR0C = (1 <<  UCSZ01) | (1 << UCSZ00) | (0 <<  USBS0 ) |
+           (0 <<   UPM01) | (0 <<  UPM00) | (0 << UMSEL01) |
+           (0 << UMSEL00);
 }
 
-void PollingSerialA::end() { UCSR0B = 0; }
+void PollingSerialA::end() { UCSR0B = 0; xmit_tail = xmit_head; }
 
 int PollingSerialA::read(void) {
   if (!available()) return -1;
@@ -46,8 +47,11 @@ int PollingSerialA::read(void) {
 }
 
 bool PollingSerialA::poll(void) {
-  if (xmit_buffer[xmit_index] == 0) return false;
-  if ( ( UCSR0A & (1<<UDRE0)) ) { UDR0 = xmit_buffer[xmit_index]; xmit_index++; xmit_index &= 0b111111; }
+  if (xmit_head == xmit_tail) return false;
+  if (!(SREG & (1<<SREG_I)) && (UCSR0A & (1<<UDRE0))) {
+    UDR0 = xmit_buffer[xmit_tail];
+    xmit_tail = (xmit_tail + 1) & SERIAL_MEGA2560_TX_MASK;
+  }
   return true;
 }
 
@@ -55,25 +59,41 @@ PollingSerialA SerialA;
 
 // UART receive complete interrupt handler for Serial0
 ISR(USART0_RX_vect)  {
-  SerialA.recv_buffer[SerialA.recv_tail] = UDR0; 
-  SerialA.recv_tail++;
+  // the error flags are only valid until UDR0 is read
+  bool overrun = UCSR0A & (1<<DOR0);
+  char c = UDR0;
+  uint8_t next = SerialA.recv_tail + 1;
+  if (next == SerialA.recv_head) { SerialA.rxOverruns++; return; }
+  if (overrun) SerialA.rxOverruns++;
+  SerialA.recv_buffer[SerialA.recv_tail] = c; 
+  SerialA.recv_tail = next;
 }
 
-#endif
+// UART data register empty interrupt handler for Serial0, sends the next byte or stops when done
+ISR(USART0_UDRE_vect)  {
+  uint8_t tail = SerialA.xmit_tail;
+  if (tail != SerialA.xmit_head) {
+    UDR0 = SerialA.xmit_buffer[tail];
+    tail = (tail + 1) & SERIAL_MEGA2560_TX_MASK;
+    SerialA.xmit_tail = tail;
+  }
+  if (tail == SerialA.xmit_head) UCSR0B &= ~(1<<UDRIE0);
+}
 
-#ifdef HAL_POLLING_MEGA2560_SERIAL_B
+1ifdef HAL_POLLING_MEGA2560_SERIAL_B
 
 void PollingSerialB::begin(long baud) {
   // init the buffers
-  xmit_index = 0; xmit_buffer[0] = 0; recv_head = 0; recv_tail = 0; recv_buffer[0] = 0;
+  xmit_head = 0; xmit_tail = 0; recv_head = 0; recv_tail = 0; recv_buffer[0] = 0; rxOverruns = 0;
+  ucsrb = &UCSR1B; udrie = (1<<UDRIE1);
 
   // Set baud rate
-  uint16_t ubrr = F_CPU/16/baud - 1;
-  UBRR1H = MSB(ubrr);
-  UBRR1L = LSB(ubrr);
+  uint16_t rate = ubrr(baud);
+  UBRR1H = MSB(rate);
+  UBRR1L = LSB(rate);
 
-  // Disable U2X mode
-  UCSR1A = 0;
+  // Enable U2X mode, 16x mode is 8.5% off at 115200 baud with a 16MHz clock
+  UCSR1A = (1<<U2X1);
 
   // Enable receiver and transmitter
   UCSR1B = (1<<RXEN1) | (1<<TXEN1) | (1<<RXCIE1);
@@ -84,7 +104,7 @@ void PollingSerialB::begin(long baud) {
            (0 << UMSEL10);
 }
 
-void PollingSerialB::end() { UCSR1B = 0; }
+void PollingSerialB::end() { UCSR1B = 0; xmit_tail = xmit_head; }
 
 int PollingSerialB::read(void) {
   if (!available()) return -1;
@@ -97,34 +117,53 @@ int PollingSerialB::read(void) {
 }
 
 bool PollingSerialB::poll(void) {
-  if (xmit_buffer[xmit_index] == 0) return false;
-  if ( ( UCSR1A & (1<<UDRE1)) ) { UDR1 = xmit_buffer[xmit_index]; xmit_index++; }
+  if (xmit_head == xmit_tail) return false;
+  if (!(SREG & (1<<SREG_I)) && (UCSR1A & (1<<UDRE1))) {
+    UDR1 = xmit_buffer[xmit_tail];
+    xmit_tail = (xmit_tail + 1) & SERIAL_MEGA2560_TX_MASK;
+  }
   return true;
 }
 
 PollingSerialB SerialB;
 
-// UART receive complete interrupt handler for Serial0
+// UART receive complete interrupt handler for Serial1
 ISR(USART1_RX_vect)  {
-  SerialB.recv_buffer[SerialB.recv_tail] = UDR1; 
-  SerialB.recv_tail++; 
+  // the error flags are only valid until UDR1 is read
+  bool overrun = UCSR1A & (1<<DOR1);
+  char c = UDR1;
+  uint8_t next = SerialB.recv_tail + 1;
+  if (next == SerialB.recv_head) { SerialB.rxOverruns++; return; }
+  if (overrun) SerialB.rxOverruns++;
+  SerialB.recv_buffer[SerialB.recv_tail] = c; 
+  SerialB.recv_tail = next;
 }
 
-#endif
+// UART data register empty interrupt handler for Serial1, sends the next byte or stops when done
+ISR(USART1_UDRE_vect)  {
+  uint8_t tail = SerialB.xmit_tail;
+  if (tail != SerialB.xmit_head) {
+    UDR1 = SerialB.xmit_buffer[tail];
+    tail = (tail + 1) & SERIAL_MEGA2560_TX_MASK;
+    SerialB.xmit_tail = tail;
+  }
+  if (tail == SerialB.xmit_head) UCSR1B &= ~(1<<UDRIE1);
+}
 
-#ifdef HAL_POLLING_MEGA2560_SERIAL_C
+2ifdef HAL_POLLING_MEGA2560_SERIAL_C
 
 void PollingSerialC::begin(long baud) {
   // init the buffers
-  xmit_index = 0; xmit_buffer[0] = 0; recv_head = 0; recv_tail = 0; recv_buffer[0] = 0;
+  xmit_head = 0; xmit_tail = 0; recv_head = 0; recv_tail = 0; recv_buffer[0] = 0; rxOverruns = 0;
+  ucsrb = &UCSR2B; udrie = (1<<UDRIE2);
 
   // Set baud rate
-  uint16_t ubrr = F_CPU/16/baud - 1;
-  UBRR2H = MSB(ubrr);
-  UBRR2L = LSB(ubrr);
+  uint16_t rate = ubrr(baud);
+  UBRR2H = MSB(rate);
+  UBRR2L = LSB(rate);
 
-  // Disable U2X mode
-  UCSR1A = 0;
+  // Enable U2X mode, 16x mode is 8.5% off at 115200 baud with a 16MHz clock
+  UCSR2A = (1<<U2X2);
 
   // Enable receiver and transmitter
   UCSR2B = (1<<RXEN2) | (1<<TXEN2) | (1<<RXCIE2);
@@ -135,7 +174,7 @@ void PollingSerialC::begin(long baud) {
            (0 << UMSEL20);
 }
 
-void PollingSerialC::end() { UCSR2B = 0; }
+void PollingSerialC::end() { UCSR2B = 0; xmit_tail = xmit_head; }
 
 int PollingSerialC::read(void) {
   if (!available()) return -1;
@@ -148,34 +187,53 @@ int PollingSerialC::read(void) {
 }
 
 bool PollingSerialC::poll(void) {
-  if (xmit_buffer[xmit_index] == 0) return false;
-  if ( ( UCSR2A & (1<<UDRE2)) ) { UDR2 = xmit_buffer[xmit_index]; xmit_index++; }
+  if (xmit_head == xmit_tail) return false;
+  if (!(SREG & (1<<SREG_I)) && (UCSR2A & (1<<UDRE2))) {
+    UDR2 = xmit_buffer[xmit_tail];
+    xmit_tail = (xmit_tail + 1) & SERIAL_MEGA2560_TX_MASK;
+  }
   return true;
 }
 
 PollingSerialC SerialC;
 
-// UART receive complete interrupt handler for Serial0
+// UART receive complete interrupt handler for Serial2
 ISR(USART2_RX_vect)  {
-  SerialC.recv_buffer[SerialC.recv_tail] = UDR2; 
-  SerialC.recv_tail++; 
+  // the error flags are only valid until UDR2 is read
+  bool overrun = UCSR2A & (1<<DOR2);
+  char c = UDR2;
+  uint8_t next = SerialC.recv_tail + 1;
+  if (next == SerialC.recv_head) { SerialC.rxOverruns++; return; }
+  if (overrun) SerialC.rxOverruns++;
+  SerialC.recv_buffer[SerialC.recv_tail] = c; 
+  SerialC.recv_tail = next;
 }
 
-#endif
+// UART data register empty interrupt handler for Serial2, sends the next byte or stops when done
+ISR(USART2_UDRE_vect)  {
+  uint8_t tail = SerialC.xmit_tail;
+  if (tail != SerialC.xmit_head) {
+    UDR2 = SerialC.xmit_buffer[tail];
+    tail = (tail + 1) & SERIAL_MEGA2560_TX_MASK;
+    SerialC.xmit_tail = tail;
+  }
+  if (tail == SerialC.xmit_head) UCSR2B &= ~(1<<UDRIE2);
+}
 
-#ifdef HAL_POLLING_MEGA2560_SERIAL_D
+3ifdef HAL_POLLING_MEGA2560_SERIAL_D
 
 void PollingSerialD::begin(long baud) {
   // init the buffers
-  xmit_index = 0; xmit_buffer[0] = 0; recv_head = 0; recv_tail = 0; recv_buffer[0] = 0;
+  xmit_head = 0; xmit_tail = 0; recv_head = 0; recv_tail = 0; recv_buffer[0] = 0; rxOverruns = 0;
+  ucsrb = &UCSR3B; udrie = (1<<UDRIE3);
 
   // Set baud rate
-  uint16_t ubrr = F_CPU/16/baud - 1;
-  UBRR3H = MSB(ubrr);
-  UBRR3L = LSB(ubrr);
+  uint16_t rate = ubrr(baud);
+  UBRR3H = MSB(rate);
+  UBRR3L = LSB(rate);
 
-  // Disable U2X mode
-  UCSR3A = 0;
+  // Enable U2X mode, 16x mode is 8.5% off at 115200 baud with a 16MHz clock
+  UCSR3A = (1<<U2X3);
 
   // Enable receiver and transmitter
   UCSR3B = (1<<RXEN3) | (1<<TXEN3) | (1<<RXCIE3);
@@ -186,7 +244,7 @@ void PollingSerialD::begin(long baud) {
            (0 << UMSEL30);
 }
 
-void PollingSerialD::end() { UCSR3B = 0; }
+void PollingSerialD::end() { UCSR3B = 0; xmit_tail = xmit_head; }
 
 int PollingSerialD::read(void) {
   if (!available()) return -1;
@@ -199,20 +257,38 @@ int PollingSerialD::read(void) {
 }
 
 bool PollingSerialD::poll(void) {
-  if (xmit_buffer[xmit_index] == 0) return false;
-  if ( ( UCSR3A & (1<<UDRE3)) ) { UDR3 = xmit_buffer[xmit_index]; xmit_index++; }
+  if (xmit_head == xmit_tail) return false;
+  if (!(SREG & (1<<SREG_I)) && (UCSR3A & (1<<UDRE3))) {
+    UDR3 = xmit_buffer[xmit_tail];
+    xmit_tail = (xmit_tail + 1) & SERIAL_MEGA2560_TX_MASK;
+  }
   return true;
 }
 
 PollingSerialD SerialD;
 
-// UART receive complete interrupt handler for Serial0
+// UART receive complete interrupt handler for Serial3
 ISR(USART3_RX_vect)  {
-  SerialD.recv_buffer[SerialD.recv_tail] = UDR3; 
-  SerialD.recv_tail++; 
+  // the error flags are only valid until UDR3 is read
+  bool overrun = UCSR3A & (1<<DOR3);
+  char c = UDR3;
+  uint8_t next = SerialD.recv_tail + 1;
+  if (next == SerialD.recv_head) { SerialD.rxOverruns++; return; }
+  if (overrun) SerialD.rxOverruns++;
+  SerialD.recv_buffer[SerialD.recv_tail] = c; 
+  SerialD.recv_tail = next;
 }
 
-#endif
+// UART data register empty interrupt handler for Serial3, sends the next byte or stops when done
+ISR(USART3_UDRE_vect)  {
+  uint8_t tail = SerialD.xmit_tail;
+  if (tail != SerialD.xmit_head) {
+    UDR3 = SerialD.xmit_buffer[tail];
+    tail = (tail + 1) & SERIAL_MEGA2560_TX_MASK;
+    SerialD.xmit_tail = tail;
+  }
+  if (tail == SerialD.xmit_head) UCSR3B &= ~(1<<UDRIE3);
+}
 
 #endif
 
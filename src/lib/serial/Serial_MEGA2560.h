@@ -8,6 +8,15 @@
 
 #if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
 
+// transmit ring buffer size, a power of two up to 256 bytes
+#ifndef SERIAL_MEGA2560_TX_BUFFER_SIZE
+  #define SERIAL_MEGA2560_TX_BUFFER_SIZE 128
+#endif
+#if SERIAL_MEGA2560_TX_BUFFER_SIZE > 256 || (SERIAL_MEGA2560_TX_BUFFER_SIZE & (SERIAL_MEGA2560_TX_BUFFER_SIZE - 1)) != 0
+  #error "Configuration: SERIAL_MEGA2560_TX_BUFFER_SIZE must be a power of two up to 256."
+#endif
+#define SERIAL_MEGA2560_TX_MASK (SERIAL_MEGA2560_TX_BUFFER_SIZE - 1)
+
 class PollingSerial : public Stream {
   public:
     PollingSerial();
@@ -15,7 +24,9 @@ class PollingSerial : public Stream {
     inline void begin() { begin(9600); }
     virtual void begin(long baud);
     virtual void end();
-    inline virtual bool poll(void) { return true; }
+
+    // true while data is waiting to be sent, moves a byte by hand if interrupts are off
+    inline virtual bool poll(void) { return false; }
 
     virtual int read(void);
 
@@ -29,11 +40,15 @@ class PollingSerial : public Stream {
 
     inline void flush(void) { while (poll()) {}; }
 
+    inline int availableForWrite(void) { return (uint8_t)(xmit_tail - xmit_head - 1) & SERIAL_MEGA2560_TX_MASK; }
+
+    // queue a byte and let the data register empty interrupt send it, waits if the ring is full
     inline size_t write(uint8_t data) {
-      //if (xmit_tail == xmit_index) return 0; 
-      xmit_buffer[xmit_tail] = data;
-      xmit_tail++; xmit_tail &= 0b111111;
-      xmit_buffer[xmit_tail] = 0;
+      uint8_t next = (xmit_head + 1) & SERIAL_MEGA2560_TX_MASK;
+      while (next == xmit_tail) { if (!(SREG & (1 << SREG_I))) poll(); }
+      xmit_buffer[xmit_head] = data;
+      xmit_head = next;
+      if (ucsrb != NULL) { noInterrupts(); *ucsrb |= udrie; interrupts(); }
       return 1;
     }
     virtual size_t write(const uint8_t* data, size_t count) {
@@ -51,10 +66,20 @@ class PollingSerial : public Stream {
     volatile uint8_t recv_head = 0;
     volatile uint8_t recv_tail = 0;
 
+    // bytes lost on receive, to the hardware overrun flag or a full ring
+    volatile uint16_t rxOverruns = 0;
+
+    char xmit_buffer[SERIAL_MEGA2560_TX_BUFFER_SIZE];
+    volatile uint8_t xmit_head = 0;
+    volatile uint8_t xmit_tail = 0;
+
   protected:
-    char xmit_buffer[64] = "";
-    uint8_t xmit_index = 0;
-    uint8_t xmit_tail = 0;
+    // baud rate register value for double speed mode, rounded to the nearest rate
+    static inline uint16_t ubrr(long baud) { return (F_CPU/8 + baud/2)/baud - 1; }
+
+    // the control register and data register empty interrupt enable bit for this UART
+    volatile uint8_t *ucsrb = NULL;
+    uint8_t udrie = 0;
 };
 
 #ifdef HAL_POLLING_MEGA2560_SERIAL_A
@@ -0,0 +1,313 @@
+// -----------------------------------------------------------------------------------
+// WebSocket serial IP command channel, for browser apps on the WiFi or Ethernet interface
+
+#include "Serial_WebSocket.h"
+
+#if OPERATIONAL_MODE != OFF && SERIAL_WEBSOCKET == ON
+
+  #define WS_OP_CONTINUATION 0x0
+  #define WS_OP_TEXT         0x1
+  #define WS_OP_BINARY       0x2
+  #define WS_OP_CLOSE        0x8
+  #define WS_OP_PING         0x9
+  #define WS_OP_PONG         0xA
+
+  #define rxCount() ((uint8_t)(rxHead - rxTail))
+
+  // SHA-1 is only needed once per connection for the handshake
+  static inline uint32_t rol(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+  static void sha1Block(uint32_t *h, const uint8_t *block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) w[i] = (uint32_t)block[i*4] << 24 | (uint32_t)block[i*4 + 1] << 16 | (uint32_t)block[i*4 + 2] << 8 | block[i*4 + 3];
+    for (int i = 16; i < 80; i++) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; } else
+      if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; } else
+      if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; } else
+                  { f = b ^ c ^ d; k = 0xCA62C1D6; }
+      uint32_t t = rol(a, 5) + f + e + k + w[i];
+      e = d; d = c; c = rol(b, 30); b = a; a = t;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+  }
+
+  static void sha1(const uint8_t *data, size_t length, uint8_t *digest) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    uint8_t block[64];
+
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) sha1Block(h, &data[i]);
+
+    size_t rest = length - i;
+    memset(block, 0, sizeof(block));
+    memcpy(block, &data[i], rest);
+    block[rest] = 0x80;
+    if (rest >= 56) { sha1Block(h, block); memset(block, 0, sizeof(block)); }
+    uint32_t bits = length*8;
+    for (int j = 0; j < 4; j++) block[63 - j] = bits >> (j*8);
+    sha1Block(h, block);
+
+    for (int j = 0; j < 20; j++) digest[j] = h[j >> 2] >> (24 - (j & 3)*8);
+  }
+
+  void WebSocketSerial::acceptKey(const char *key, char *accept) {
+    static const char *guid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    static const char *base64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    char s[32 + 36 + 1];
+    strncpy(s, key, 32); s[32] = 0;
+    strcat(s, guid);
+
+    uint8_t digest[21];
+    sha1((const uint8_t*)s, strlen(s), digest);
+    digest[20] = 0;
+
+    // 20 bytes encode as 27 chars plus one pad
+    for (int i = 0; i < 21; i += 3) {
+      uint32_t n = (uint32_t)digest[i] << 16 | (uint32_t)digest[i + 1] << 8 | (i + 2 < 21 ? digest[i + 2] : 0);
+      *accept++ = base64[(n >> 18) & 63];
+      *accept++ = base64[(n >> 12) & 63];
+      *accept++ = base64[(n >> 6) & 63];
+      *accept++ = i < 18 ? base64[n & 63] : '=';
+    }
+    *accept = 0;
+  }
+
+  void WebSocketSerial::begin(long port) {
+    if (active) return;
+
+    #if OPERATIONAL_MODE == WIFI
+      wifiManager.init();
+      server = new WiFiServer(port);
+      server->begin();
+      server->setNoDelay(true);
+      VF("MSG: WiFi, started WebSocket server on port "); VL(port);
+    #else
+      ethernetManager.init();
+      server = new EthernetServer(port);
+      server->begin();
+      VF("MSG: Ethernet, started WebSocket server on port "); VL(port);
+    #endif
+
+    active = true;
+  }
+
+  void WebSocketSerial::end() {
+    if (state != WSS_NONE) close();
+  }
+
+  int WebSocketSerial::available(void) {
+    if (!active) return 0;
+
+    if (state == WSS_NONE) { accept(); return 0; }
+
+    if (!client.connected()) {
+      #if DEBUG_CMDSERVER == ON
+        VLF("MSG: WebSocket, not connected STOP client");
+      #endif
+      client.stop();
+      state = WSS_NONE;
+      return rxCount();
+    }
+
+    unsigned long now = millis();
+    if (state == WSS_HANDSHAKE) {
+      handshake();
+      if (state == WSS_HANDSHAKE && (long)(now - connectTimeMs) > WEBSOCKET_HANDSHAKE_MS) close();
+      return 0;
+    }
+
+    receive();
+
+    if ((long)(now - lastRxTimeMs) > WEBSOCKET_TIMEOUT_MS) {
+      #if DEBUG_CMDSERVER == ON
+        VLF("MSG: WebSocket, timed out STOP client");
+      #endif
+      close();
+    } else
+    if ((long)(now - lastRxTimeMs) > WEBSOCKET_PING_MS && (long)(now - lastPingTimeMs) > WEBSOCKET_PING_MS) {
+      sendFrame(WS_OP_PING, NULL, 0);
+      lastPingTimeMs = now;
+    }
+
+    return rxCount();
+  }
+
+  int WebSocketSerial::peek(void) {
+    if (rxCount() == 0) return -1;
+    return rx[rxTail & (WEBSOCKET_RX_SIZE - 1)];
+  }
+
+  void WebSocketSerial::flush(void) {
+    if (state != WSS_OPEN) return;
+    client.flush();
+  }
+
+  int WebSocketSerial::read(void) {
+    if (rxCount() == 0) return -1;
+    return rx[rxTail++ & (WEBSOCKET_RX_SIZE - 1)];
+  }
+
+  size_t WebSocketSerial::read(uint8_t *buffer, size_t count) {
+    size_t i = 0;
+    while (i < count && rxCount() > 0) buffer[i++] = rx[rxTail++ & (WEBSOCKET_RX_SIZE - 1)];
+    return i;
+  }
+
+  size_t WebSocketSerial::write(uint8_t data) {
+    return write(&data, 1);
+  }
+
+  size_t WebSocketSerial::write(const uint8_t *data, size_t count) {
+    if (state != WSS_OPEN) return 0;
+    return sendFrame(dataOpcode, data, count) ? count : 0;
+  }
+
+  void WebSocketSerial::accept() {
+    #if OPERATIONAL_MODE == WIFI
+      if (!server->hasClient()) return;
+    #endif
+    client = server->available();
+    if (!client) return;
+
+    #if DEBUG_CMDSERVER == ON
+      VLF("MSG: WebSocket, NEW client");
+    #endif
+    state = WSS_HANDSHAKE;
+    connectTimeMs = millis();
+    linePos = 0;
+    key[0] = 0;
+  }
+
+  void WebSocketSerial::handshake() {
+    while (client.available() > 0) {
+      int c = client.read();
+      if (c < 0) return;
+      if (c == '\r') continue;
+      if (c != '\n') { if (linePos < WEBSOCKET_LINE_SIZE - 1) line[linePos++] = c; continue; }
+      line[linePos] = 0;
+      linePos = 0;
+
+      if (line[0] != 0) {
+        if (strncasecmp(line, "Sec-WebSocket-Key:", 18) == 0) {
+          char *value = &line[18];
+          while (*value == ' ') value++;
+          strncpy(key, value, sizeof(key) - 1); key[sizeof(key) - 1] = 0;
+          char *end = strchr(key, ' '); if (end != NULL) *end = 0;
+        }
+        continue;
+      }
+
+      // a blank line ends the request
+      if (key[0] == 0) {
+        client.print("HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n");
+        close();
+        return;
+      }
+
+      char accept[29];
+      acceptKey(key, accept);
+      client.print("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: ");
+      client.print(accept);
+      client.print("\r\n\r\n");
+
+      #if DEBUG_CMDSERVER == ON
+        VLF("MSG: WebSocket, client OPEN");
+      #endif
+      state = WSS_OPEN;
+      frameState = WSF_HEADER;
+      dataOpcode = WS_OP_TEXT;
+      rxHead = rxTail = 0;
+      lastRxTimeMs = lastPingTimeMs = millis();
+      return;
+    }
+  }
+
+  void WebSocketSerial::receive() {
+    // take no more than the receive buffer has room for, so the payload is never dropped
+    uint8_t block[32];
+    while (state == WSS_OPEN) {
+      size_t room = WEBSOCKET_RX_SIZE - rxCount();
+      if (room == 0 || client.available() <= 0) return;
+      if (room > sizeof(block)) room = sizeof(block);
+      int count = client.read(block, room);
+      if (count <= 0) return;
+      lastRxTimeMs = millis();
+      for (int i = 0; i < count && state == WSS_OPEN; i++) decode(block[i]);
+    }
+  }
+
+  void WebSocketSerial::decode(uint8_t b) {
+    switch (frameState) {
+      case WSF_HEADER:
+        opcode = b & 0x0F;
+        frameState = WSF_LENGTH;
+      break;
+      case WSF_LENGTH:
+        // frames from a client must be masked
+        if (!(b & 0x80)) { close(); return; }
+        length = b & 0x7F;
+        if (length >= 126) { lengthBytes = length == 126 ? 2 : 8; length = 0; frameState = WSF_EXT_LENGTH; } else { maskPos = 0; frameState = WSF_MASK; }
+      break;
+      case WSF_EXT_LENGTH:
+        length = (length << 8) | b;
+        if (--lengthBytes == 0) { maskPos = 0; frameState = WSF_MASK; }
+      break;
+      case WSF_MASK:
+        mask[maskPos++] = b;
+        if (maskPos == 4) { payloadPos = 0; if (length == 0) frameEnd(); else frameState = WSF_PAYLOAD; }
+      break;
+      case WSF_PAYLOAD:
+        b ^= mask[payloadPos & 3];
+        if (opcode & 0x08) {
+          if (payloadPos < WEBSOCKET_CONTROL_SIZE) control[payloadPos] = b;
+        } else rx[rxHead++ & (WEBSOCKET_RX_SIZE - 1)] = b;
+        if (++payloadPos >= length) frameEnd();
+      break;
+    }
+  }
+
+  void WebSocketSerial::frameEnd() {
+    frameState = WSF_HEADER;
+    size_t count = length < WEBSOCKET_CONTROL_SIZE ? length : WEBSOCKET_CONTROL_SIZE;
+    switch (opcode) {
+      case WS_OP_CONTINUATION: break;
+      case WS_OP_TEXT: case WS_OP_BINARY: dataOpcode = opcode; break;
+      case WS_OP_PING: sendFrame(WS_OP_PONG, control, count); break;
+      case WS_OP_PONG: break;
+      case WS_OP_CLOSE: sendFrame(WS_OP_CLOSE, control, count < 2 ? count : 2); close(); break;
+      default: close(); break;
+    }
+  }
+
+  bool WebSocketSerial::sendFrame(uint8_t opcode, const uint8_t *data, size_t count) {
+    if (!client.connected()) return false;
+
+    uint8_t header = 2;
+    tx[0] = 0x80 | opcode;
+    if (count < 126) tx[1] = count; else { tx[1] = 126; tx[2] = count >> 8; tx[3] = count & 0xFF; header = 4; }
+
+    // header and payload go out in one write where they fit
+    if (header + count <= WEBSOCKET_TX_SIZE) {
+      if (count > 0) memcpy(&tx[header], data, count);
+      return client.write(tx, header + count) == header + count;
+    }
+    if (client.write(tx, header) != header) return false;
+    return client.write(data, count) == count;
+  }
+
+  void WebSocketSerial::close() {
+    #if DEBUG_CMDSERVER == ON
+      VLF("MSG: WebSocket, STOP client");
+    #endif
+    client.stop();
+    state = WSS_NONE;
+  }
+
+  WebSocketSerial SerialWS;
+
+#endif
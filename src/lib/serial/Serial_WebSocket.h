@@ -0,0 +1,119 @@
+// -----------------------------------------------------------------------------------
+// WebSocket serial IP command channel, for browser apps on the WiFi or Ethernet interface
+#pragma once
+
+#include "../../Common.h"
+
+#ifndef OPERATIONAL_MODE
+#define OPERATIONAL_MODE OFF
+#endif
+
+#if OPERATIONAL_MODE == WIFI
+  #include "../wifi/WifiManager.h"
+#elif OPERATIONAL_MODE == ETHERNET_W5100 || OPERATIONAL_MODE == ETHERNET_W5500
+  #include "../ethernet/EthernetManager.h"
+#endif
+
+#if OPERATIONAL_MODE != OFF && SERIAL_WEBSOCKET == ON
+
+  #define WEBSOCKET_RX_SIZE      64    // payload bytes waiting to be read, power of 2 up to 128
+  #define WEBSOCKET_TX_SIZE      260   // largest reply sent as one TCP write (header plus payload)
+  #define WEBSOCKET_LINE_SIZE    80    // handshake header lines are truncated to this length
+  #define WEBSOCKET_CONTROL_SIZE 125   // largest ping/close payload
+  #define WEBSOCKET_HANDSHAKE_MS 2000  // time allowed for the HTTP upgrade request
+  #define WEBSOCKET_PING_MS      20000 // ping a client that's been quiet this long
+  #define WEBSOCKET_TIMEOUT_MS   60000 // drop a client that's been quiet this long (browsers answer pings)
+
+  enum WebSocketState: uint8_t {WSS_NONE, WSS_HANDSHAKE, WSS_OPEN};
+  enum WebSocketFrameState: uint8_t {WSF_HEADER, WSF_LENGTH, WSF_EXT_LENGTH, WSF_MASK, WSF_PAYLOAD};
+
+  // one client at a time, LX200 commands arrive in text (or binary) frames and each
+  // reply or status stream frame (see :SXPS,n#) goes back as a frame of the same type
+  class WebSocketSerial : public Stream {
+    public:
+      void begin(long port);
+
+      void end();
+
+      int read(void);
+
+      // read up to count bytes that are already waiting, returns the number read
+      size_t read(uint8_t *buffer, size_t count);
+
+      int available(void);
+
+      int peek(void);
+
+      void flush(void);
+
+      size_t write(uint8_t data);
+
+      // each call is sent as a single frame
+      size_t write(const uint8_t* data, size_t count);
+
+      inline size_t write(unsigned long n) { return write((uint8_t)n); }
+      inline size_t write(long n) { return write((uint8_t)n); }
+      inline size_t write(unsigned int n) { return write((uint8_t)n); }
+      inline size_t write(int n) { return write((uint8_t)n); }
+
+      using Print::write;
+
+      // Sec-WebSocket-Accept value (28 chars) for the client's Sec-WebSocket-Key
+      static void acceptKey(const char *key, char *accept);
+
+    private:
+      // take a waiting client, if any
+      void accept();
+
+      // read the HTTP upgrade request and answer it
+      void handshake();
+
+      // decode frames from the client into the receive buffer
+      void receive();
+      void decode(uint8_t b);
+      void frameEnd();
+
+      bool sendFrame(uint8_t opcode, const uint8_t *data, size_t count);
+
+      void close();
+
+      #if OPERATIONAL_MODE == WIFI
+        WiFiServer *server;
+        WiFiClient client;
+      #else
+        EthernetServer *server;
+        EthernetClient client;
+      #endif
+
+      WebSocketState state = WSS_NONE;
+      unsigned long connectTimeMs = 0;
+      unsigned long lastRxTimeMs = 0;
+      unsigned long lastPingTimeMs = 0;
+
+      char line[WEBSOCKET_LINE_SIZE];
+      uint8_t linePos = 0;
+      char key[32];
+
+      WebSocketFrameState frameState = WSF_HEADER;
+      uint8_t opcode = 0;
+      uint8_t dataOpcode = 1;
+      uint8_t lengthBytes = 0;
+      uint32_t length = 0;
+      uint32_t payloadPos = 0;
+      uint8_t mask[4];
+      uint8_t maskPos = 0;
+      uint8_t control[WEBSOCKET_CONTROL_SIZE];
+
+      uint8_t rx[WEBSOCKET_RX_SIZE];
+      uint8_t rxHead = 0;
+      uint8_t rxTail = 0;
+
+      uint8_t tx[WEBSOCKET_TX_SIZE];
+
+      bool active = false;
+  };
+
+  extern WebSocketSerial SerialWS;
+  #define SERIAL_WS SerialWS
+
+#endif
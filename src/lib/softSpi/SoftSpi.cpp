@@ -4,6 +4,13 @@
 #include "../../Common.h"
 #include "SoftSpi.h"
 
+#if SOFT_SPI_HARDWARE == ON
+  #include <SPI.h>
+
+  // the pins the SPI peripheral was started on, later users must be on the same bus
+  static int16_t spiMosi = OFF, spiSck = OFF, spiMiso = OFF;
+#endif
+
 bool SoftSpi::init(int16_t mosi, int16_t sck, int16_t cs, int16_t miso) {
   this->miso = miso;
   this->mosi = mosi;
@@ -17,56 +24,103 @@ bool SoftSpi::init(int16_t mosi, int16_t sck, int16_t cs, int16_t miso) {
     VF(", MISO="); if (miso == OFF) { VL("OFF"); } else { VL(miso); }
   #endif
 
-  if (mosi == OFF || sck == OFF || cs == OFF) return false; else return true;
+  if (mosi == OFF || sck == OFF || cs == OFF) return false;
+
+  #if SOFT_SPI_HARDWARE == ON
+    if (miso != OFF) {
+      if (spiSck == OFF) {
+        #if defined(ESP32)
+          SPI.begin(sck, miso, mosi, -1);
+          spiMosi = mosi; spiSck = sck; spiMiso = miso;
+        #else
+          if (mosi == MOSI && sck == SCK && miso == MISO) {
+            SPI.begin();
+            spiMosi = mosi; spiSck = sck; spiMiso = miso;
+          }
+        #endif
+      }
+      useSpi = mosi == spiMosi && sck == spiSck && miso == spiMiso;
+    }
+    if (useSpi) { VLF("MSG: SoftSpi, using hardware SPI"); } else { VLF("WRN: SoftSpi, MOSI/SCK/MISO aren't the SPI pins falling back to bit-bang"); }
+    pinModeEx(cs, OUTPUT);
+    digitalWriteEx(cs, HIGH);
+  #endif
+
+  return true;
 }
 
 void SoftSpi::begin() {
+  #if SOFT_SPI_HARDWARE == ON
+    if (useSpi) {
+      // the transaction holds the bus for this driver until end()
+      SPI.beginTransaction(SPISettings(SOFT_SPI_CLOCK_RATE_HZ, MSBFIRST, SPI_MODE3));
+      digitalWriteEx(cs, LOW);
+      delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
+      return;
+    }
+  #endif
+
   pinModeEx(cs, OUTPUT);
   digitalWriteEx(cs, HIGH);
-  delayMicroseconds(1);
+  delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
   pinMode(sck, OUTPUT);
   digitalWriteF(sck, HIGH);
   pinMode(miso, INPUT);
   pinMode(mosi, OUTPUT);
-  delayMicroseconds(1);
+  delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
   digitalWriteEx(cs, LOW);
-  delayMicroseconds(1);
+  delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
 }
 
 void SoftSpi::pause() {
   digitalWriteEx(cs, HIGH);
-  delayMicroseconds(1);
+  delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
   digitalWriteEx(cs, LOW);
-  delayMicroseconds(1);
+  delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
 }
 
 void SoftSpi::end() {
   digitalWriteEx(cs, HIGH);
-  delayMicroseconds(1);
+  delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
+  #if SOFT_SPI_HARDWARE == ON
+    if (useSpi) SPI.endTransaction();
+  #endif
 }
 
 uint8_t SoftSpi::transfer(uint8_t data_out) {
+  #if SOFT_SPI_HARDWARE == ON
+    if (useSpi) return SPI.transfer(data_out);
+  #endif
+
   uint8_t data_in = 0;
   for(int i = 7; i >= 0; i--) {
     digitalWriteF(sck, LOW);
     digitalWriteF(mosi, bitRead(data_out, i));
-    delayMicroseconds(1);
+    delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
     digitalWriteF(sck, HIGH);
     bitWrite(data_in, i, digitalReadF(miso));
-    delayMicroseconds(1);
+    delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
   }
   return data_in;
 }
 
 uint32_t SoftSpi::transfer32(uint32_t data_out) {
+  #if SOFT_SPI_HARDWARE == ON
+    if (useSpi) {
+      uint32_t data_in = 0;
+      for (int i = 3; i >= 0; i--) data_in = (data_in << 8) | SPI.transfer((uint8_t)(data_out >> (i*8)));
+      return data_in;
+    }
+  #endif
+
   uint32_t data_in = 0;
   for(int i = 31; i >= 0; i--) {
     digitalWriteF(sck, LOW);
     digitalWriteF(mosi, bitRead(data_out, i));
-    delayMicroseconds(1);
+    delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
     digitalWriteF(sck, HIGH);
     bitWrite(data_in, i, digitalReadF(miso));
-    delayMicroseconds(1);
+    delayNanoseconds(SOFT_SPI_HALF_PERIOD_NS);
   }
   return data_in;
 }
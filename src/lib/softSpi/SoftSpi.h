@@ -4,6 +4,22 @@
 
 #include <Arduino.h>
 
+// ON uses the hardware SPI peripheral when MOSI, SCK, and MISO are its pins (any pins on ESP32) the
+// bus can be shared by several drivers each with its own CS, otherwise the transfers are bit-banged
+#ifndef SOFT_SPI_HARDWARE
+  #define SOFT_SPI_HARDWARE OFF
+#endif
+
+// hardware SPI clock rate, the TMC2130/5160 allow up to 4MHz on their internal clock
+#ifndef SOFT_SPI_CLOCK_RATE_HZ
+  #define SOFT_SPI_CLOCK_RATE_HZ 2000000
+#endif
+
+// bit-bang half clock period and CS setup/hold time in nanoseconds, TMC drivers need >= 100ns
+#ifndef SOFT_SPI_HALF_PERIOD_NS
+  #define SOFT_SPI_HALF_PERIOD_NS 150
+#endif
+
 class SoftSpi {
   public:
     // check pins and report status
@@ -21,4 +37,7 @@ class SoftSpi {
 
   private:
     int16_t miso, mosi, sck, cs;
+    #if SOFT_SPI_HARDWARE == ON
+      bool useSpi = false;
+    #endif
 };
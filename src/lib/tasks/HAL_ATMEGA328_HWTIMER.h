@@ -49,13 +49,15 @@
 
   #define HAL_HWTIMER1_SET_PERIOD() (OCR1A = _nextPeriod1)
   ISR(TIMER1_COMPA_vect) {
+    TASKS_HWTIMER1_PROBE_PREFIX;
     TASKS_HWTIMER1_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep1 > 1) { count++; if (count%_nextRep1 != 0) goto done; }
-    if (_nextRep1) HAL_HWTIMER1_FUN();
+    if (_nextRep1) HAL_HWTIMER1_CALL();
     HAL_HWTIMER1_SET_PERIOD();
     done: {}
     TASKS_HWTIMER1_PROFILER_SUFFIX;
+    TASKS_HWTIMER1_PROBE_SUFFIX;
   }
 #endif
 
@@ -50,13 +50,15 @@
 
   #define HAL_HWTIMER1_SET_PERIOD() {} // <--- code to set timer period goes here
   void HAL_HWTIMER1_WRAPPER() {
+    TASKS_HWTIMER1_PROBE_PREFIX;
     TASKS_HWTIMER1_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep1 > 1) { count++; if (count%_nextRep1 != 0) goto done; }
-    if (_nextRep1) HAL_HWTIMER1_FUN();
+    if (_nextRep1) HAL_HWTIMER1_CALL();
     HAL_HWTIMER1_SET_PERIOD();
     done: {}
     TASKS_HWTIMER1_PROFILER_SUFFIX;
+    TASKS_HWTIMER1_PROBE_SUFFIX;
   }
 #endif
 
@@ -76,13 +78,15 @@
 
   #define HAL_HWTIMER2_SET_PERIOD() {} // <--- code to set timer period goes here
   void HAL_HWTIMER2_WRAPPER() {
+    TASKS_HWTIMER2_PROBE_PREFIX;
     TASKS_HWTIMER2_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep2 > 1) { count++; if (count%_nextRep2 != 0) goto done; }
-    if (_nextRep2) HAL_HWTIMER2_FUN();
+    if (_nextRep2) HAL_HWTIMER2_CALL();
     HAL_HWTIMER2_SET_PERIOD();
     done: {}
     TASKS_HWTIMER2_PROFILER_SUFFIX;
+    TASKS_HWTIMER2_PROBE_SUFFIX;
   }
 #endif
 
@@ -102,13 +106,15 @@
 
   #define HAL_HWTIMER3_SET_PERIOD() {} // <--- code to set timer period goes here
   void HAL_HWTIMER3_WRAPPER() {
+    TASKS_HWTIMER3_PROBE_PREFIX;
     TASKS_HWTIMER3_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep3 > 1) { count++; if (count%_nextRep3 != 0) goto done; }
-    if (_nextRep3) HAL_HWTIMER3_FUN();
+    if (_nextRep3) HAL_HWTIMER3_CALL();
     HAL_HWTIMER3_SET_PERIOD();
     done: {}
     TASKS_HWTIMER3_PROFILER_SUFFIX;
+    TASKS_HWTIMER3_PROBE_SUFFIX;
   }
 #endif
 
@@ -128,12 +134,14 @@
 
   #define HAL_HWTIMER4_SET_PERIOD() {} // <--- code to set timer period goes here
   void HAL_HWTIMER4_WRAPPER() {
+    TASKS_HWTIMER4_PROBE_PREFIX;
     TASKS_HWTIMER4_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep4 > 1) { count++; if (count%_nextRep4 != 0) goto done; }
-    if (_nextRep4) HAL_HWTIMER4_FUN();
+    if (_nextRep4) HAL_HWTIMER4_CALL();
     HAL_HWTIMER4_SET_PERIOD();
     done: {}
     TASKS_HWTIMER4_PROFILER_SUFFIX;
+    TASKS_HWTIMER4_PROBE_SUFFIX;
   }
 #endif
@@ -20,7 +20,7 @@ portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
   // prepare hw timer for interval in sub-microseconds (1/16us)
   volatile uint32_t _nextPeriod1 = 16000, _nextPeriod2 = 16000, _nextPeriod3 = 16000, _nextPeriod4 = 16000;
   volatile uint16_t _nextRep1 = 0, _nextRep2 = 0, _nextRep3 = 0, _nextRep4 = 0;
-  void HAL_HWTIMER_PREPARE_PERIOD(uint8_t num, unsigned long period) {
+  IRAM_HOT void HAL_HWTIMER_PREPARE_PERIOD(uint8_t num, unsigned long period) {
     // maximum time is about 134 seconds for this design
     uint32_t counts, reps = 0;
     if (period != 0 && period <= 2144000000) {
@@ -66,13 +66,15 @@ portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
   #define HAL_HWTIMER1_SET_PERIOD() timerAlarmWrite(itimer1, _nextPeriod1, true)
   IRAM_ATTR void HAL_HWTIMER1_WRAPPER() {
     portENTER_CRITICAL_ISR(&timerMux);
+    TASKS_HWTIMER1_PROBE_PREFIX;
     TASKS_HWTIMER1_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep1 > 1) { count++; if (count % _nextRep1 != 0) goto done; }
-    if (_nextRep1) HAL_HWTIMER1_FUN();
+    if (_nextRep1) HAL_HWTIMER1_CALL();
     HAL_HWTIMER1_SET_PERIOD();
     done: {}
     TASKS_HWTIMER1_PROFILER_SUFFIX;
+    TASKS_HWTIMER1_PROBE_SUFFIX;
     portEXIT_CRITICAL_ISR ( &timerMux );
   }
 #endif
@@ -100,13 +102,15 @@ portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
   #define HAL_HWTIMER2_SET_PERIOD() timerAlarmWrite(itimer2, _nextPeriod2, true)
   IRAM_ATTR void HAL_HWTIMER2_WRAPPER() {
     portENTER_CRITICAL_ISR(&timerMux);
+    TASKS_HWTIMER2_PROBE_PREFIX;
     TASKS_HWTIMER2_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep2 > 1) { count++; if (count % _nextRep2 != 0) goto done; }
-    if (_nextRep2) HAL_HWTIMER2_FUN();
+    if (_nextRep2) HAL_HWTIMER2_CALL();
     HAL_HWTIMER2_SET_PERIOD();
     done: {}
     TASKS_HWTIMER2_PROFILER_SUFFIX;
+    TASKS_HWTIMER2_PROBE_SUFFIX;
     portEXIT_CRITICAL_ISR ( &timerMux );
   }
 #endif
@@ -134,13 +138,15 @@ portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
   #define HAL_HWTIMER3_SET_PERIOD() timerAlarmWrite(itimer3, _nextPeriod3, true)
   IRAM_ATTR void HAL_HWTIMER3_WRAPPER() {
     portENTER_CRITICAL_ISR(&timerMux);
+    TASKS_HWTIMER3_PROBE_PREFIX;
     TASKS_HWTIMER3_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep3 > 1) { count++; if (count % _nextRep3 != 0) goto done; }
-    if (_nextRep3) HAL_HWTIMER3_FUN();
+    if (_nextRep3) HAL_HWTIMER3_CALL();
     HAL_HWTIMER3_SET_PERIOD();
     done: {}
     TASKS_HWTIMER3_PROFILER_SUFFIX;
+    TASKS_HWTIMER3_PROBE_SUFFIX;
     portEXIT_CRITICAL_ISR ( &timerMux );
   }
 #endif
@@ -168,13 +174,15 @@ portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
   #define HAL_HWTIMER4_SET_PERIOD() timerAlarmWrite(itimer4, _nextPeriod4, true)
   IRAM_ATTR void HAL_HWTIMER4_WRAPPER() {
     portENTER_CRITICAL_ISR(&timerMux);
+    TASKS_HWTIMER4_PROBE_PREFIX;
     TASKS_HWTIMER4_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep4 > 1) { count++; if (count % _nextRep4 != 0) goto done; }
-    if (_nextRep4) HAL_HWTIMER4_FUN();
+    if (_nextRep4) HAL_HWTIMER4_CALL();
     HAL_HWTIMER4_SET_PERIOD();
     done: {}
     TASKS_HWTIMER4_PROFILER_SUFFIX;
+    TASKS_HWTIMER4_PROBE_SUFFIX;
     portEXIT_CRITICAL_ISR ( &timerMux );
   }
 #endif
@@ -1,6 +1,20 @@
 //--------------------------------------------------------------------------------------------------
 // Selects hardware timer HAL according to platform
 
+// hardware timer callbacks that take a context pointer, these are called when set instead of HAL_HWTIMERn_FUN
+void (*HAL_HWTIMER1_CONTEXT_FUN)(void *) = NULL;
+void *HAL_HWTIMER1_CONTEXT = NULL;
+#define HAL_HWTIMER1_CALL() { if (HAL_HWTIMER1_CONTEXT_FUN != NULL) HAL_HWTIMER1_CONTEXT_FUN(HAL_HWTIMER1_CONTEXT); else HAL_HWTIMER1_FUN(); }
+void (*HAL_HWTIMER2_CONTEXT_FUN)(void *) = NULL;
+void *HAL_HWTIMER2_CONTEXT = NULL;
+#define HAL_HWTIMER2_CALL() { if (HAL_HWTIMER2_CONTEXT_FUN != NULL) HAL_HWTIMER2_CONTEXT_FUN(HAL_HWTIMER2_CONTEXT); else HAL_HWTIMER2_FUN(); }
+void (*HAL_HWTIMER3_CONTEXT_FUN)(void *) = NULL;
+void *HAL_HWTIMER3_CONTEXT = NULL;
+#define HAL_HWTIMER3_CALL() { if (HAL_HWTIMER3_CONTEXT_FUN != NULL) HAL_HWTIMER3_CONTEXT_FUN(HAL_HWTIMER3_CONTEXT); else HAL_HWTIMER3_FUN(); }
+void (*HAL_HWTIMER4_CONTEXT_FUN)(void *) = NULL;
+void *HAL_HWTIMER4_CONTEXT = NULL;
+#define HAL_HWTIMER4_CALL() { if (HAL_HWTIMER4_CONTEXT_FUN != NULL) HAL_HWTIMER4_CONTEXT_FUN(HAL_HWTIMER4_CONTEXT); else HAL_HWTIMER4_FUN(); }
+
 // these must be present even if the hardware timer isn't brought in
 #ifndef TASKS_HWTIMER1_ENABLE
   void (*HAL_HWTIMER1_FUN)() = NULL;
@@ -45,3 +59,18 @@
 #else
   #include "HAL_EMPTY_HWTIMER.h"
 #endif
+
+// idle the processor until the next interrupt
+#ifdef TASKS_IDLE_WAIT
+  #if defined(__AVR__)
+    #include <avr/sleep.h>
+    #define TASKS_IDLE_WAIT_FOR_INTERRUPT() { set_sleep_mode(SLEEP_MODE_IDLE); sleep_mode(); }
+  #elif defined(ESP32)
+    // block until the next FreeRTOS tick, this lets the idle task put the core in its wait state
+    #define TASKS_IDLE_WAIT_FOR_INTERRUPT() vTaskDelay(1)
+  #elif defined(__arm__)
+    #define TASKS_IDLE_WAIT_FOR_INTERRUPT() __asm__ volatile("wfi")
+  #else
+    #define TASKS_IDLE_WAIT_FOR_INTERRUPT()
+  #endif
+#endif
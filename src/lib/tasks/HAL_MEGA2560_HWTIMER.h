@@ -58,13 +58,15 @@
   
   #define HAL_HWTIMER1_SET_PERIOD() OCR1A = _nextPeriod1
   ISR(TIMER1_COMPA_vect) {
+    TASKS_HWTIMER1_PROBE_PREFIX;
     TASKS_HWTIMER1_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep1 > 1) { count++; if (count%_nextRep1 != 0) goto done; }
-    if (_nextRep1) HAL_HWTIMER1_FUN();
+    if (_nextRep1) HAL_HWTIMER1_CALL();
     HAL_HWTIMER1_SET_PERIOD();
     done: {}
     TASKS_HWTIMER1_PROFILER_SUFFIX;
+    TASKS_HWTIMER1_PROBE_SUFFIX;
   }
 #endif
 
@@ -89,13 +91,15 @@
 
   #define HAL_HWTIMER2_SET_PERIOD() OCR3A = _nextPeriod2
   ISR(TIMER3_COMPA_vect) {
+    TASKS_HWTIMER2_PROBE_PREFIX;
     TASKS_HWTIMER2_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep2 > 1) { count++; if (count%_nextRep2 != 0) goto done; }
-    if (_nextRep2) HAL_HWTIMER2_FUN();
+    if (_nextRep2) HAL_HWTIMER2_CALL();
     HAL_HWTIMER2_SET_PERIOD();
     done: {}
     TASKS_HWTIMER2_PROFILER_SUFFIX;
+    TASKS_HWTIMER2_PROBE_SUFFIX;
   }
 #endif
 
@@ -120,13 +124,15 @@
 
   #define HAL_HWTIMER3_SET_PERIOD() OCR4A = _nextPeriod3
   ISR(TIMER4_COMPA_vect) {
+    TASKS_HWTIMER3_PROBE_PREFIX;
     TASKS_HWTIMER3_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep3 > 1) { count++; if (count%_nextRep3 != 0) goto done; }
-    if (_nextRep3) HAL_HWTIMER3_FUN();
+    if (_nextRep3) HAL_HWTIMER3_CALL();
     HAL_HWTIMER3_SET_PERIOD();
     done: {}
     TASKS_HWTIMER3_PROFILER_SUFFIX;
+    TASKS_HWTIMER3_PROBE_SUFFIX;
   }
 #endif
 
@@ -151,12 +157,14 @@
 
   #define HAL_HWTIMER4_SET_PERIOD() OCR5A = _nextPeriod4
   ISR(TIMER5_COMPA_vect) {
+    TASKS_HWTIMER4_PROBE_PREFIX;
     TASKS_HWTIMER4_PROFILER_PREFIX;
     static uint16_t count = 0;
     if (_nextRep4 > 1) { count++; if (count%_nextRep4 != 0) goto done; }
-    if (_nextRep4) HAL_HWTIMER4_FUN();
+    if (_nextRep4) HAL_HWTIMER4_CALL();
     HAL_HWTIMER4_SET_PERIOD();
     done: {}
     TASKS_HWTIMER4_PROFILER_SUFFIX;
+    TASKS_HWTIMER4_PROBE_SUFFIX;
   }
 #endif
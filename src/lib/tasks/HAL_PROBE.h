@@ -0,0 +1,95 @@
+//--------------------------------------------------------------------------------------------------
+// Configures the probe pins according to platform, a pin is driven HIGH while its task or the
+// hardware timer ISR it was given runs so timing can be seen on a logic analyzer
+
+#ifdef TASKS_PROBE_ENABLE
+  #if defined(ESP32) && (defined(CONFIG_IDF_TARGET_ESP32) || defined(CONFIG_IDF_TARGET_ESP32S3))
+    #include <soc/gpio_struct.h>
+  #endif
+
+  // the pin numbers are constants so each write below comes down to a single port store
+  #if defined(__TEENSYDUINO__)
+    #define TASKS_PROBE_WRITE(pin, state) digitalWriteFast(pin, state)
+  #elif defined(ESP32) && (defined(CONFIG_IDF_TARGET_ESP32) || defined(CONFIG_IDF_TARGET_ESP32S3))
+    #define TASKS_PROBE_WRITE(pin, state) { if ((pin) < 32) { if (state) GPIO.out_w1ts = 1UL << ((pin) & 31); else GPIO.out_w1tc = 1UL << ((pin) & 31); } else \
+                                                            { if (state) GPIO.out1_w1ts.val = 1UL << ((pin) & 31); else GPIO.out1_w1tc.val = 1UL << ((pin) & 31); } }
+  #elif defined(ARDUINO_ARCH_STM32)
+    // the STM32 pin map isn't constexpr so the port and mask are looked up once when the probe is assigned
+    GPIO_TypeDef *_task_probe_port[4] = {NULL, NULL, NULL, NULL};
+    uint32_t _task_probe_mask[4] = {0, 0, 0, 0};
+    #define TASKS_PROBE_RESOLVE(n, pin) { _task_probe_port[n - 1] = digitalPinToPort(pin); _task_probe_mask[n - 1] = digitalPinToBitMask(pin); }
+    #define TASKS_PROBE_WRITE_N(n, state) { if (state) _task_probe_port[n - 1]->BSRR = _task_probe_mask[n - 1]; else _task_probe_port[n - 1]->BSRR = _task_probe_mask[n - 1] << 16; }
+  #else
+    #define TASKS_PROBE_WRITE(pin, state) digitalWrite(pin, state)
+  #endif
+
+  #ifndef TASKS_PROBE_RESOLVE
+    #define TASKS_PROBE_RESOLVE(n, pin)
+  #endif
+  #ifndef TASKS_PROBE_WRITE_N
+    #define TASKS_PROBE_WRITE_N(n, state) TASKS_PROBE_WRITE(DEBUG_PROBE##n##_PIN, state)
+  #endif
+
+  static inline __attribute__((always_inline)) void tasksProbeWrite(uint8_t probe, uint8_t state) {
+    switch (probe) {
+      #if DEBUG_PROBE1_PIN != OFF
+        case 1: TASKS_PROBE_WRITE_N(1, state); break;
+      #endif
+      #if DEBUG_PROBE2_PIN != OFF
+        case 2: TASKS_PROBE_WRITE_N(2, state); break;
+      #endif
+      #if DEBUG_PROBE3_PIN != OFF
+        case 3: TASKS_PROBE_WRITE_N(3, state); break;
+      #endif
+      #if DEBUG_PROBE4_PIN != OFF
+        case 4: TASKS_PROBE_WRITE_N(4, state); break;
+      #endif
+    }
+  }
+
+  // the probe (1 to 4) for a task name, 0 if it has none, the pin is set up when first matched
+  static uint8_t tasksProbeFind(const char name[]) {
+    uint8_t probe = 0;
+    int pin = OFF;
+    #if DEBUG_PROBE1_PIN != OFF
+      if (probe == 0 && strncmp(name, DEBUG_PROBE1_TASK, 7) == 0) { probe = 1; pin = DEBUG_PROBE1_PIN; TASKS_PROBE_RESOLVE(1, DEBUG_PROBE1_PIN); }
+    #endif
+    #if DEBUG_PROBE2_PIN != OFF
+      if (probe == 0 && strncmp(name, DEBUG_PROBE2_TASK, 7) == 0) { probe = 2; pin = DEBUG_PROBE2_PIN; TASKS_PROBE_RESOLVE(2, DEBUG_PROBE2_PIN); }
+    #endif
+    #if DEBUG_PROBE3_PIN != OFF
+      if (probe == 0 && strncmp(name, DEBUG_PROBE3_TASK, 7) == 0) { probe = 3; pin = DEBUG_PROBE3_PIN; TASKS_PROBE_RESOLVE(3, DEBUG_PROBE3_PIN); }
+    #endif
+    #if DEBUG_PROBE4_PIN != OFF
+      if (probe == 0 && strncmp(name, DEBUG_PROBE4_TASK, 7) == 0) { probe = 4; pin = DEBUG_PROBE4_PIN; TASKS_PROBE_RESOLVE(4, DEBUG_PROBE4_PIN); }
+    #endif
+    if (probe != 0) { pinMode(pin, OUTPUT); digitalWrite(pin, LOW); }
+    return probe;
+  }
+
+  // probe for each hardware timer, taken from the task it runs
+  volatile uint8_t _task_hwtimer_probe[4] = {0, 0, 0, 0};
+
+  #define TASKS_PROBE_PREFIX if (probe) tasksProbeWrite(probe, HIGH)
+  #define TASKS_PROBE_SUFFIX if (probe) tasksProbeWrite(probe, LOW)
+
+  #define TASKS_HWTIMER1_PROBE_PREFIX uint8_t probe = _task_hwtimer_probe[0]; if (probe) tasksProbeWrite(probe, HIGH)
+  #define TASKS_HWTIMER1_PROBE_SUFFIX if (probe) tasksProbeWrite(probe, LOW)
+  #define TASKS_HWTIMER2_PROBE_PREFIX uint8_t probe = _task_hwtimer_probe[1]; if (probe) tasksProbeWrite(probe, HIGH)
+  #define TASKS_HWTIMER2_PROBE_SUFFIX if (probe) tasksProbeWrite(probe, LOW)
+  #define TASKS_HWTIMER3_PROBE_PREFIX uint8_t probe = _task_hwtimer_probe[2]; if (probe) tasksProbeWrite(probe, HIGH)
+  #define TASKS_HWTIMER3_PROBE_SUFFIX if (probe) tasksProbeWrite(probe, LOW)
+  #define TASKS_HWTIMER4_PROBE_PREFIX uint8_t probe = _task_hwtimer_probe[3]; if (probe) tasksProbeWrite(probe, HIGH)
+  #define TASKS_HWTIMER4_PROBE_SUFFIX if (probe) tasksProbeWrite(probe, LOW)
+#else
+  #define TASKS_PROBE_PREFIX
+  #define TASKS_PROBE_SUFFIX
+  #define TASKS_HWTIMER1_PROBE_PREFIX
+  #define TASKS_HWTIMER1_PROBE_SUFFIX
+  #define TASKS_HWTIMER2_PROBE_PREFIX
+  #define TASKS_HWTIMER2_PROBE_SUFFIX
+  #define TASKS_HWTIMER3_PROBE_PREFIX
+  #define TASKS_HWTIMER3_PROBE_SUFFIX
+  #define TASKS_HWTIMER4_PROBE_PREFIX
+  #define TASKS_HWTIMER4_PROBE_SUFFIX
+#endif
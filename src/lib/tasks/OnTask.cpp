@@ -33,13 +33,43 @@
 #include "OnTask.h"
 
 #include "HAL_PROFILER.h"
+#include "HAL_PROBE.h"
 #include "HAL_HWTIMERS.h"
 
+#ifdef TASKS_CORE_AFFINITY
+  // task_core[] is -1 for tasks on the core running loop(), or -2 for those just handed back from the other core
+  #define TASKS_ON_LOOP_CORE(e) (task_core[e] < 0)
+  #ifdef TASKS_READY_QUEUE
+    #define TASKS_CORE_RELEASED() immediate_pending = true
+  #else
+    #define TASKS_CORE_RELEASED()
+  #endif
+#else
+  #define TASKS_ON_LOOP_CORE(e) true
+#endif
+
 #define roundPeriod(x) ((unsigned long)((x)+(double)0.5L))
 
 unsigned char _task_postpone = false;
+#ifdef TASKS_LOAD_METER
+  volatile unsigned long _task_runs = 0;
+#endif
 unsigned long _taskMasterFrequencyRatio = 16000000UL;
 
+#ifdef TASKS_BUDGET_ENABLE
+  // the group and budget new tasks get, and the time any nested tasks ran, for the task running on each core
+  #ifdef TASKS_CORE_AFFINITY
+    #define TASKS_CONTEXTS 2
+    #define TASKS_CONTEXT xPortGetCoreID()
+  #else
+    #define TASKS_CONTEXTS 1
+    #define TASKS_CONTEXT 0
+  #endif
+  static uint8_t _task_group[TASKS_CONTEXTS];
+  static unsigned long _task_budget[TASKS_CONTEXTS];
+  static unsigned long _task_nested_time[TASKS_CONTEXTS];
+#endif
+
 // Task object
 Task::Task(uint32_t period, uint32_t duration, bool repeat, uint8_t priority, void (*volatile callback)()) {
   idle = period == 0;
@@ -53,14 +83,20 @@ Task::Task(uint32_t period, uint32_t duration, bool repeat, uint8_t priority, vo
   start_time     = millis();
   next_task_time = start_time + period;
   strcpy(processName, "");
+  #ifdef TASKS_STATISTICS_ENABLE
+    clearStatistics();
+  #endif
 }
 
 Task::~Task() {
+  #ifdef TASKS_PROBE_ENABLE
+    if (hardware_timer >= 1 && hardware_timer <= 4) _task_hwtimer_probe[hardware_timer - 1] = 0;
+  #endif
   switch (hardware_timer) {
-    case 1: HAL_HWTIMER1_DONE(); break;
-    case 2: HAL_HWTIMER2_DONE(); break;
-    case 3: HAL_HWTIMER3_DONE(); break;
-    case 4: HAL_HWTIMER4_DONE(); break;
+    case 1: HAL_HWTIMER1_DONE(); HAL_HWTIMER1_CONTEXT_FUN = NULL; break;
+    case 2: HAL_HWTIMER2_DONE(); HAL_HWTIMER2_CONTEXT_FUN = NULL; break;
+    case 3: HAL_HWTIMER3_DONE(); HAL_HWTIMER3_CONTEXT_FUN = NULL; break;
+    case 4: HAL_HWTIMER4_DONE(); HAL_HWTIMER4_CONTEXT_FUN = NULL; break;
   }
 }
 
@@ -70,16 +106,16 @@ bool Task::requestHardwareTimer(uint8_t num, uint8_t hwPriority) {
   if (priority != 0) { DLF("ERR: Task::requestHardwareTimer(), s/w priority must be 0 (highest)"); return false; }
   switch (num) {
     case 1:
-      if (HAL_HWTIMER1_FUN != NULL) { DLF("ERR: Task::requestHardwareTimer(), channel1 already in use"); return false; }
+      if (HAL_HWTIMER1_FUN != NULL || HAL_HWTIMER1_CONTEXT_FUN != NULL) { DLF("ERR: Task::requestHardwareTimer(), channel1 already in use"); return false; }
     break;
     case 2:
-      if (HAL_HWTIMER2_FUN != NULL) { DLF("ERR: Task::requestHardwareTimer(), channel2 already in use"); return false; }
+      if (HAL_HWTIMER2_FUN != NULL || HAL_HWTIMER2_CONTEXT_FUN != NULL) { DLF("ERR: Task::requestHardwareTimer(), channel2 already in use"); return false; }
     break;
     case 3:
-      if (HAL_HWTIMER3_FUN != NULL) { DLF("ERR: Task::requestHardwareTimer(), channel3 already in use"); return false; }
+      if (HAL_HWTIMER3_FUN != NULL || HAL_HWTIMER3_CONTEXT_FUN != NULL) { DLF("ERR: Task::requestHardwareTimer(), channel3 already in use"); return false; }
     break;
     case 4:
-      if (HAL_HWTIMER4_FUN != NULL) { DLF("ERR: Task::requestHardwareTimer(), channel4 already in use"); return false; }
+      if (HAL_HWTIMER4_FUN != NULL || HAL_HWTIMER4_CONTEXT_FUN != NULL) { DLF("ERR: Task::requestHardwareTimer(), channel4 already in use"); return false; }
     break;
   }
 
@@ -94,26 +130,43 @@ bool Task::requestHardwareTimer(uint8_t num, uint8_t hwPriority) {
   interrupts();
   HAL_HWTIMER_PREPARE_PERIOD(num, hardware_timer_period);
 
+  #ifdef TASKS_PROBE_ENABLE
+    _task_hwtimer_probe[num - 1] = probe;
+  #endif
+
   bool success = true;
   switch (num) {
     case 1:
       HAL_HWTIMER1_FUN = callback;
-      if (!HAL_HWTIMER1_INIT(hwPriority)) { success = false; HAL_HWTIMER1_FUN = NULL; }
+      HAL_HWTIMER1_CONTEXT = context;
+      HAL_HWTIMER1_CONTEXT_FUN = contextCallback;
+      if (!HAL_HWTIMER1_INIT(hwPriority)) { success = false; HAL_HWTIMER1_FUN = NULL; HAL_HWTIMER1_CONTEXT_FUN = NULL; }
     break;
     case 2:
       HAL_HWTIMER2_FUN = callback;
-      if (!HAL_HWTIMER2_INIT(hwPriority)) { success = false; HAL_HWTIMER2_FUN = NULL; }
+      HAL_HWTIMER2_CONTEXT = context;
+      HAL_HWTIMER2_CONTEXT_FUN = contextCallback;
+      if (!HAL_HWTIMER2_INIT(hwPriority)) { success = false; HAL_HWTIMER2_FUN = NULL; HAL_HWTIMER2_CONTEXT_FUN = NULL; }
     break;
     case 3:
       HAL_HWTIMER3_FUN = callback;
-      if (!HAL_HWTIMER3_INIT(hwPriority)) { success = false; HAL_HWTIMER3_FUN = NULL; }
+      HAL_HWTIMER3_CONTEXT = context;
+      HAL_HWTIMER3_CONTEXT_FUN = contextCallback;
+      if (!HAL_HWTIMER3_INIT(hwPriority)) { success = false; HAL_HWTIMER3_FUN = NULL; HAL_HWTIMER3_CONTEXT_FUN = NULL; }
     break;
     case 4:
       HAL_HWTIMER4_FUN = callback;
-      if (!HAL_HWTIMER4_INIT(hwPriority)) { success = false; HAL_HWTIMER4_FUN = NULL; }
+      HAL_HWTIMER4_CONTEXT = context;
+      HAL_HWTIMER4_CONTEXT_FUN = contextCallback;
+      if (!HAL_HWTIMER4_INIT(hwPriority)) { success = false; HAL_HWTIMER4_FUN = NULL; HAL_HWTIMER4_CONTEXT_FUN = NULL; }
     break;
   }
-  if (!success) { DF("ERR: Task::requestHardwareTimer(), HAL_HWTIMER"); D(num); DLF("_INIT() failed"); return false; }
+  if (!success) {
+    #ifdef TASKS_PROBE_ENABLE
+      _task_hwtimer_probe[num - 1] = 0;
+    #endif
+    DF("ERR: Task::requestHardwareTimer(), HAL_HWTIMER"); D(num); DLF("_INIT() failed"); return false;
+  }
   hardware_timer = num;
   period = hardware_timer_period;
   period_units = PU_SUB_MICROS;
@@ -121,20 +174,50 @@ bool Task::requestHardwareTimer(uint8_t num, uint8_t hwPriority) {
 }
 
 void Task::setCallback(void (*volatile callback)()) {
-  this->callback = callback;
   noInterrupts();
+  this->callback = callback;
+  contextCallback = NULL;
   switch (hardware_timer) {
     case 1:
       HAL_HWTIMER1_FUN = callback;
+      HAL_HWTIMER1_CONTEXT_FUN = NULL;
     break;
     case 2:
       HAL_HWTIMER2_FUN = callback;
+      HAL_HWTIMER2_CONTEXT_FUN = NULL;
     break;
     case 3:
       HAL_HWTIMER3_FUN = callback;
+      HAL_HWTIMER3_CONTEXT_FUN = NULL;
     break;
     case 4:
       HAL_HWTIMER4_FUN = callback;
+      HAL_HWTIMER4_CONTEXT_FUN = NULL;
+    break;
+  }
+  interrupts();
+}
+
+void Task::setCallback(void (*volatile callback)(void *), void *context) {
+  noInterrupts();
+  this->context = context;
+  contextCallback = callback;
+  switch (hardware_timer) {
+    case 1:
+      HAL_HWTIMER1_CONTEXT = context;
+      HAL_HWTIMER1_CONTEXT_FUN = callback;
+    break;
+    case 2:
+      HAL_HWTIMER2_CONTEXT = context;
+      HAL_HWTIMER2_CONTEXT_FUN = callback;
+    break;
+    case 3:
+      HAL_HWTIMER3_CONTEXT = context;
+      HAL_HWTIMER3_CONTEXT_FUN = callback;
+    break;
+    case 4:
+      HAL_HWTIMER4_CONTEXT = context;
+      HAL_HWTIMER4_CONTEXT_FUN = callback;
     break;
   }
   interrupts();
@@ -144,7 +227,7 @@ void Task::setTimingMode(TimingMode mode) {
   timingMode = mode;
 }
 
-bool Task::poll() {
+IRAM_HOT bool Task::poll() {
   if (hardware_timer || running) return false;
 
   if (period != 0) {
@@ -157,10 +240,50 @@ bool Task::poll() {
     if ((long)time_to_next_task < 0) {
       running = true;
 
+      #ifdef TASKS_STATISTICS_ENABLE
+        unsigned long lateness = -(long)time_to_next_task;
+        if (lateness >= period) miss_count++;
+        if (period_units == PU_MILLIS) lateness *= 1000UL;
+        unsigned long statistics_t0 = micros();
+      #endif
+
+      #ifdef TASKS_BUDGET_ENABLE
+        uint8_t context_index = TASKS_CONTEXT;
+        uint8_t outer_group = _task_group[context_index];
+        unsigned long outer_budget = _task_budget[context_index];
+        unsigned long outer_nested_time = _task_nested_time[context_index];
+        _task_group[context_index] = group;
+        _task_budget[context_index] = budget;
+        _task_nested_time[context_index] = 0;
+        unsigned long budget_t0 = micros();
+      #endif
+
       TASKS_PROFILER_PREFIX;
-      callback();
+      TASKS_PROBE_PREFIX;
+      if (contextCallback != NULL) contextCallback(context); else callback();
+      TASKS_PROBE_SUFFIX;
       TASKS_PROFILER_SUFFIX;
-    
+
+      #ifdef TASKS_BUDGET_ENABLE
+        // tasks that ran while this one yielded are charged to themselves
+        unsigned long runtime_gross = micros() - budget_t0;
+        unsigned long runtime_net = runtime_gross - _task_nested_time[context_index];
+        runtime_net_total += runtime_net;
+        if (runtime_net > runtime_net_max) runtime_net_max = runtime_net;
+        if (budget != 0 && runtime_net > budget) overrun_count++;
+        _task_group[context_index] = outer_group;
+        _task_budget[context_index] = outer_budget;
+        _task_nested_time[context_index] = outer_nested_time + runtime_gross;
+      #endif
+
+      #ifdef TASKS_LOAD_METER
+        _task_runs++;
+      #endif
+
+      #ifdef TASKS_STATISTICS_ENABLE
+        recordStatistics(lateness, micros() - statistics_t0);
+      #endif
+
       running = false;
 
       if (_task_postpone) { _task_postpone = false; return false; }
@@ -200,7 +323,7 @@ void Task::refreshPeriod() {
   if (hardware_timer) setHardwareTimerPeriod();
 }
 
-void Task::setPeriod(unsigned long period, PeriodUnits units) {
+IRAM_HOT void Task::setPeriod(unsigned long period, PeriodUnits units) {
   if (hardware_timer) {
     next_period = period;
     next_period_units = units;
@@ -247,7 +370,7 @@ void Task::setDuration(unsigned long duration) {
   this->duration = duration;
 }
 
-bool Task::isDurationComplete() {
+IRAM_HOT bool Task::isDurationComplete() {
   return (duration > 0 && ((long)(millis() - (start_time + duration)) >= 0));
 }
 
@@ -261,24 +384,52 @@ void Task::setRepeat(bool repeat) {
   this->repeat = repeat;
 }
 
-void Task::setPriority(bool priority) {
+void Task::setPriority(uint8_t priority) {
   if (hardware_timer) return;
   this->priority = priority;
 }
 
-uint8_t Task::getPriority() {
+IRAM_HOT uint8_t Task::getPriority() {
   return priority;
 }
 
 void Task::setNameStr(const char name[]) {
   strncpy(processName, name, 7);
   processName[7] = 0;
+  #ifdef TASKS_PROBE_ENABLE
+    probe = tasksProbeFind(processName);
+    if (hardware_timer >= 1 && hardware_timer <= 4) _task_hwtimer_probe[hardware_timer - 1] = probe;
+  #endif
 }
 
 char* Task::getNameStr() {
   return processName;
 }
 
+#ifdef TASKS_READY_QUEUE
+unsigned long Task::getMicrosToNext() {
+  if (hardware_timer || period == 0) return TASKS_READY_QUEUE_HORIZON;
+  if (immediate) return 0;
+
+  long time_to_next_task;
+  if (period_units == PU_MICROS) time_to_next_task = (long)(next_task_time - micros()) + 1; else {
+    time_to_next_task = (long)(next_task_time - millis());
+    if (time_to_next_task > TASKS_READY_QUEUE_HORIZON/1000L) return TASKS_READY_QUEUE_HORIZON;
+    time_to_next_task = time_to_next_task*1000L + 500L;
+  }
+
+  // be back in time to remove the task when its duration is complete
+  if (duration > 0) {
+    long time_to_complete = (long)((start_time + duration) - millis());
+    if (time_to_complete < TASKS_READY_QUEUE_HORIZON/1000L && time_to_complete*1000L < time_to_next_task) time_to_next_task = time_to_complete*1000L;
+  }
+
+  if (time_to_next_task < 0) return 0;
+  if (time_to_next_task > TASKS_READY_QUEUE_HORIZON) return TASKS_READY_QUEUE_HORIZON;
+  return time_to_next_task;
+}
+#endif
+
 #ifdef TASKS_PROFILER_ENABLE
 float Task::getArrivalAvg() {
   if (hardware_timer) return 0;
@@ -315,7 +466,67 @@ float Task::getRuntimeMax() {
 }
 #endif
 
-void Task::setHardwareTimerPeriod() {
+#ifdef TASKS_STATISTICS_ENABLE
+// find the histogram bin for a time in microseconds
+static uint8_t histogramBin(unsigned long value) {
+  uint8_t bin = 0;
+  while (value >= 16 && bin < TASKS_HISTOGRAM_BINS - 1) { value >>= 2; bin++; }
+  return bin;
+}
+
+void Task::recordStatistics(unsigned long lateness, unsigned long runtime) {
+  poll_count++;
+  if (lateness > max_lateness) max_lateness = lateness;
+  if (runtime > max_runtime_micros) max_runtime_micros = runtime;
+  uint8_t bin = histogramBin(lateness);
+  if (lateness_histogram[bin] < 65535) lateness_histogram[bin]++;
+  bin = histogramBin(runtime);
+  if (runtime_histogram[bin] < 65535) runtime_histogram[bin]++;
+}
+
+unsigned long Task::getPollCount() {
+  return poll_count;
+}
+
+unsigned long Task::getMissCount() {
+  return miss_count;
+}
+
+unsigned long Task::getLatenessMax() {
+  return max_lateness;
+}
+
+unsigned long Task::getRuntimeMaxMicros() {
+  return max_runtime_micros;
+}
+
+uint16_t Task::getLatenessHistogram(uint8_t bin) {
+  if (bin >= TASKS_HISTOGRAM_BINS) return 0;
+  return lateness_histogram[bin];
+}
+
+uint16_t Task::getRuntimeHistogram(uint8_t bin) {
+  if (bin >= TASKS_HISTOGRAM_BINS) return 0;
+  return runtime_histogram[bin];
+}
+
+void Task::clearStatistics() {
+  poll_count = 0;
+  miss_count = 0;
+  max_lateness = 0;
+  max_runtime_micros = 0;
+  for (uint8_t bin = 0; bin < TASKS_HISTOGRAM_BINS; bin++) { lateness_histogram[bin] = 0; runtime_histogram[bin] = 0; }
+}
+#endif
+
+#ifdef TASKS_BUDGET_ENABLE
+void Task::setGroup(uint8_t group, unsigned long budget) {
+  this->group = group;
+  this->budget = budget;
+}
+#endif
+
+IRAM_HOT void Task::setHardwareTimerPeriod() {
   // adopt next period
   if (next_period_units != PU_NONE) {
     if (next_period_units == PU_MILLIS) next_period *= 16000UL; else if (next_period_units == PU_MICROS) next_period *= 16UL;
@@ -359,6 +570,12 @@ Tasks::Tasks() {
   for (uint8_t c = 0; c < TASKS_MAX; c++) {
     task[c] = NULL;
     allocated[c] = false;
+    #ifdef TASKS_READY_QUEUE
+      queued[c] = false;
+    #endif
+    #ifdef TASKS_CORE_AFFINITY
+      task_core[c] = -1;
+    #endif
   }
 
   // start the task monitor
@@ -389,6 +606,19 @@ uint8_t Tasks::add(uint32_t period, uint32_t duration, bool repeat, uint8_t prio
   task[e] = new Task(period, duration, repeat, priority, callback);
   if (task[e] != NULL) allocated[e] = true; else return false;
 
+  #ifdef TASKS_CORE_AFFINITY
+    task_core[e] = -1;
+  #endif
+
+  #ifdef TASKS_BUDGET_ENABLE
+    task[e]->setGroup(_task_group[TASKS_CONTEXT], _task_budget[TASKS_CONTEXT]);
+  #endif
+
+  #ifdef TASKS_READY_QUEUE
+    queued[e] = false;
+    queueInsert(e);
+  #endif
+
   updateEventRange();
   return e + 1;
 }
@@ -399,15 +629,30 @@ uint8_t Tasks::add(uint32_t period, uint32_t duration, bool repeat, uint8_t prio
   return handle;
 }
 
+uint8_t Tasks::add(uint32_t period, uint32_t duration, bool repeat, uint8_t priority, void (*volatile callback)(void *), void *context, const char name[]) {
+  uint8_t handle = add(period, duration, repeat, priority, (void (*)())NULL);
+  if (handle) {
+    task[handle - 1]->setCallback(callback, context);
+    setNameStr(handle, name);
+  }
+  return handle;
+}
+
 bool Tasks::requestHardwareTimer(uint8_t handle) {
   return requestHardwareTimer(handle, 128);
 }
 
 bool Tasks::requestHardwareTimer(uint8_t handle, uint8_t hwPriority) {
+  #ifdef TASKS_CORE_AFFINITY
+    if (handle != 0 && task_core[handle - 1] >= 0) { DLF("ERR: Tasks::requestHardwareTimer(), task is on the other core"); return false; }
+  #endif
   if (handle != 0 && allocated[handle - 1] && TASKS_HWTIMERS > 0) {
     for (int num = 0; num < TASKS_HWTIMERS; num++) {
       if (!hardware_timer_allocated[num]) {
         hardware_timer_allocated[num] = task[handle - 1]->requestHardwareTimer(num + 1, hwPriority);
+        #ifdef TASKS_READY_QUEUE
+          if (hardware_timer_allocated[num]) queueRemove(handle - 1);
+        #endif
         return hardware_timer_allocated[num];
       }
     }
@@ -422,6 +667,13 @@ bool Tasks::setCallback(uint8_t handle, void (*volatile callback)()) {
   } else return false;
 }
 
+bool Tasks::setCallback(uint8_t handle, void (*volatile callback)(void *), void *context) {
+  if (handle != 0 && allocated[handle - 1]) {
+    task[handle - 1]->setCallback(callback, context);
+    return true;
+  } else return false;
+}
+
 bool Tasks::setTimingMode(uint8_t handle, TimingMode mode) {
   if (handle != 0 && allocated[handle - 1]) {
     task[handle - 1]->setTimingMode(mode);
@@ -431,6 +683,9 @@ bool Tasks::setTimingMode(uint8_t handle, TimingMode mode) {
 
 void Tasks::remove(uint8_t handle) {
   if (handle != 0 && allocated[handle - 1]) {
+    #ifdef TASKS_READY_QUEUE
+      queueRemove(handle - 1);
+    #endif
     delete task[handle - 1];
     allocated[handle - 1] = false;
     updateEventRange();
@@ -447,24 +702,36 @@ void Tasks::refreshPeriod(uint8_t handle) {
 void Tasks::setPeriod(uint8_t handle, unsigned long period) {
   if (handle != 0 && allocated[handle - 1]) {
     task[handle - 1]->setPeriod(period);
+    #ifdef TASKS_READY_QUEUE
+      queueReschedule(handle - 1);
+    #endif
   }
 }
 
 void Tasks::setPeriodMicros(uint8_t handle, unsigned long period) {
   if (handle != 0 && allocated[handle - 1]) {
     task[handle - 1]->setPeriod(period, PU_MICROS);
+    #ifdef TASKS_READY_QUEUE
+      queueReschedule(handle - 1);
+    #endif
   }
 }
 
-void Tasks::setPeriodSubMicros(uint8_t handle, unsigned long period) {
+IRAM_HOT void Tasks::setPeriodSubMicros(uint8_t handle, unsigned long period) {
   if (handle != 0 && allocated[handle - 1]) {
     task[handle - 1]->setPeriod(period, PU_SUB_MICROS);
+    #ifdef TASKS_READY_QUEUE
+      queueReschedule(handle - 1);
+    #endif
   }
 }
 
 void Tasks::setFrequency(uint8_t handle, double freq) {
   if (handle != 0 && allocated[handle - 1]) {
     task[handle - 1]->setFrequency(freq);
+    #ifdef TASKS_READY_QUEUE
+      queueReschedule(handle - 1);
+    #endif
   }
 }
 
@@ -475,30 +742,88 @@ IRAM_ATTR void Tasks::setPeriodRatioSubMicros(unsigned long value) {
 void Tasks::setDuration(uint8_t handle, unsigned long duration) {
   if (handle != 0 && allocated[handle - 1]) {
     task[handle - 1]->setDuration(duration);
+    #ifdef TASKS_READY_QUEUE
+      queueReschedule(handle - 1);
+    #endif
   }
 }
 
 void Tasks::setDurationComplete(uint8_t handle) {
   if (handle != 0 && allocated[handle - 1]) {
     task[handle - 1]->setDurationComplete();
+    #ifdef TASKS_READY_QUEUE
+      queueReschedule(handle - 1);
+    #endif
   }
 }
 
 void Tasks::setRepeat(uint8_t handle, bool repeat) {
   if (handle != 0 && allocated[handle - 1]) {
     task[handle - 1]->setRepeat(repeat);
+    #ifdef TASKS_READY_QUEUE
+      queueReschedule(handle - 1);
+    #endif
   }
 }
 
 void Tasks::setPriority(uint8_t handle, uint8_t priority) {
   if (handle != 0 && allocated[handle - 1]) {
     if (priority > 7) return;
+    #ifdef TASKS_READY_QUEUE
+      bool wasQueued = queued[handle - 1];
+      queueRemove(handle - 1);
+    #endif
     task[handle - 1]->setPriority(priority);
+    #ifdef TASKS_READY_QUEUE
+      if (wasQueued) queueInsert(handle - 1);
+    #endif
     updateEventRange();
     updatePriorityRange();
   }
 }
 
+#ifdef TASKS_CORE_AFFINITY
+  static void tasksCoreRunner(void *parameter) {
+    for (;;) {
+      tasks.pollCore();
+      vTaskDelay(1);
+    }
+  }
+
+  bool Tasks::setCore(uint8_t handle, uint8_t core) {
+    if (handle == 0 || !allocated[handle - 1] || core > 1) return false;
+    if (task[handle - 1]->hardware_timer) return false;
+
+    // start the task that polls the other core, this is called from the core running loop()
+    if (core_runner == NULL) {
+      loop_core = xPortGetCoreID();
+      xTaskCreatePinnedToCore(tasksCoreRunner, "OnTask", TASKS_CORE_STACK_SIZE, NULL, tskIDLE_PRIORITY, &core_runner, 1 - loop_core);
+      if (core_runner == NULL) { DLF("ERR: Tasks::setCore(), FreeRTOS task create failed"); return false; }
+    }
+
+    if (core == loop_core) {
+      if (task_core[handle - 1] >= 0) { task_core[handle - 1] = -2; TASKS_CORE_RELEASED(); }
+    } else {
+      #ifdef TASKS_READY_QUEUE
+        queueRemove(handle - 1);
+      #endif
+      task_core[handle - 1] = core;
+    }
+    return true;
+  }
+
+  void Tasks::pollCore() {
+    for (uint8_t priority = 0; priority <= 7; priority++) {
+      for (uint8_t e = 0; e <= highest_task; e++) {
+        if (task_core[e] >= 0 && task[e]->getPriority() == priority) {
+          // hand tasks that are done back to loop() for removal
+          if (task[e]->isDurationComplete()) { task_core[e] = -2; TASKS_CORE_RELEASED(); } else task[e]->poll();
+        }
+      }
+    }
+  }
+#endif
+
 void Tasks::setNameStr(uint8_t handle, const char name[]) {
   if (handle != 0 && allocated[handle - 1]) {
     task[handle - 1]->setNameStr(name);
@@ -568,9 +893,129 @@ uint8_t Tasks::getHandleByName(const char name[]) {
   }
 #endif
 
-#ifdef TASKS_HIGHER_PRIORITY_ONLY
-  void Tasks::yield() {
+#ifdef TASKS_STATISTICS_ENABLE
+  unsigned long Tasks::getPollCount(uint8_t handle) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getPollCount();
+    } else return 0;
+  }
+  unsigned long Tasks::getMissCount(uint8_t handle) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getMissCount();
+    } else return 0;
+  }
+  unsigned long Tasks::getLatenessMax(uint8_t handle) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getLatenessMax();
+    } else return 0;
+  }
+  unsigned long Tasks::getRuntimeMaxMicros(uint8_t handle) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getRuntimeMaxMicros();
+    } else return 0;
+  }
+  uint16_t Tasks::getLatenessHistogram(uint8_t handle, uint8_t bin) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getLatenessHistogram(bin);
+    } else return 0;
+  }
+  uint16_t Tasks::getRuntimeHistogram(uint8_t handle, uint8_t bin) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getRuntimeHistogram(bin);
+    } else return 0;
+  }
+  void Tasks::clearStatistics(uint8_t handle) {
+    for (uint8_t e = 0; e < TASKS_MAX; e++) {
+      if (allocated[e] && (handle == 0 || handle - 1 == e)) task[e]->clearStatistics();
+    }
+  }
+#endif
+
+#ifdef TASKS_BUDGET_ENABLE
+  void Tasks::setGroup(uint8_t group, unsigned long budget) {
+    _task_group[TASKS_CONTEXT] = group;
+    _task_budget[TASKS_CONTEXT] = budget;
+  }
+  uint8_t Tasks::getGroup(uint8_t handle) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getGroup();
+    } else return 0;
+  }
+  unsigned long Tasks::getBudget(uint8_t handle) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getBudget();
+    } else return 0;
+  }
+  unsigned long Tasks::getRuntimeNetTotal(uint8_t handle) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getRuntimeNetTotal();
+    } else return 0;
+  }
+  unsigned long Tasks::getRuntimeNetMax(uint8_t handle) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getRuntimeNetMax();
+    } else return 0;
+  }
+  unsigned long Tasks::getOverrunCount(uint8_t handle) {
+    if (handle != 0 && allocated[handle - 1]) {
+      return task[handle - 1]->getOverrunCount();
+    } else return 0;
+  }
+#endif
+
+#if defined(TASKS_READY_QUEUE)
+  IRAM_HOT void Tasks::schedule() {
+    #ifdef TASKS_HIGHER_PRIORITY_ONLY
+      ::yield();
+    #endif
+    #ifdef TASKS_CORE_AFFINITY
+      if (core_runner != NULL && xPortGetCoreID() != loop_core) { ::yield(); return; }
+    #endif
+    pass_time = micros64();
+    if (immediate_pending) queueImmediate();
+    if (queued_priorities == 0) return;
+
+    unsigned long t = (unsigned long)pass_time;
+    for (uint8_t priority = 0; priority <= highest_priority; priority++) {
+      #ifdef TASKS_HIGHER_PRIORITY_ONLY
+        if (priority >= highest_active_priority) return;
+      #endif
+      if (!bitRead(queued_priorities, priority) || (long)(t - queue_due[queue_head[priority]]) < 0) continue;
+
+      // take the tasks that are due at this priority level off the queue
+      uint8_t ready[TASKS_MAX];
+      uint8_t ready_count = 0;
+      while (bitRead(queued_priorities, priority) && (long)(t - queue_due[queue_head[priority]]) >= 0) {
+        ready[ready_count] = queue_head[priority];
+        queueRemove(ready[ready_count++]);
+      }
+
+      #ifdef TASKS_HIGHER_PRIORITY_ONLY
+        uint8_t last_priority = highest_active_priority;
+        highest_active_priority = priority;
+      #endif
+
+      // poll them in order and put them back in line
+      for (uint8_t i = 0; i < ready_count; i++) {
+        uint8_t e = ready[i];
+        if (!allocated[e]) continue;
+        if (task[e]->isDurationComplete()) { remove(e + 1); continue; }
+        task[e]->poll();
+        if (allocated[e]) queueInsert(e);
+      }
+
+      #ifdef TASKS_HIGHER_PRIORITY_ONLY
+        highest_active_priority = last_priority;
+      #endif
+    }
+  }
+#elif defined(TASKS_HIGHER_PRIORITY_ONLY)
+  IRAM_HOT void Tasks::schedule() {
     ::yield();
+    #ifdef TASKS_CORE_AFFINITY
+      if (core_runner != NULL && xPortGetCoreID() != loop_core) return;
+    #endif
+    pass_time = micros64();
     for (uint8_t priority = 0; priority <= highest_priority; priority++) {
       uint8_t last_priority = highest_active_priority;
       if (priority < highest_active_priority) {
@@ -578,7 +1023,7 @@ uint8_t Tasks::getHandleByName(const char name[]) {
         for (uint8_t i = 0; i <= highest_task; i++) {
           if (++number[priority] > highest_task) number[priority] = 0;
           if (allocated[number[priority]]) {
-            if (task[number[priority]]->getPriority() == priority) {
+            if (task[number[priority]]->getPriority() == priority && TASKS_ON_LOOP_CORE(number[priority])) {
               if (task[number[priority]]->isDurationComplete()) { remove(number[priority] + 1); highest_active_priority = last_priority; return; }
               if (task[number[priority]]->poll()) { highest_active_priority = last_priority; return; }
             }
@@ -589,12 +1034,16 @@ uint8_t Tasks::getHandleByName(const char name[]) {
     }
   }
 #else
-  void Tasks::yield() {
+  IRAM_HOT void Tasks::schedule() {
+    #ifdef TASKS_CORE_AFFINITY
+      if (core_runner != NULL && xPortGetCoreID() != loop_core) { ::yield(); return; }
+    #endif
+    pass_time = micros64();
     for (uint8_t priority = 0; priority <= highest_priority; priority++) {
       for (uint8_t i = 0; i <= highest_task; i++) {
         if (++number[priority] > highest_task) number[priority] = 0;
         if (allocated[number[priority]]) {
-          if (task[number[priority]]->getPriority() == priority) {
+          if (task[number[priority]]->getPriority() == priority && TASKS_ON_LOOP_CORE(number[priority])) {
             if (task[number[priority]]->isDurationComplete()) { remove(number[priority] + 1); return; }
             if (task[number[priority]]->poll()) return;
           }
@@ -604,6 +1053,64 @@ uint8_t Tasks::getHandleByName(const char name[]) {
   }
 #endif
 
+#ifdef TASKS_LOAD_METER
+  IRAM_HOT void Tasks::yield() {
+    // only the outermost yield() (from loop() or setup() code) is metered
+    if (yield_depth > 0) { schedule(); return; }
+    #ifdef TASKS_CORE_AFFINITY
+      if (core_runner != NULL && xPortGetCoreID() != loop_core) { schedule(); return; }
+    #endif
+
+    yield_depth++;
+    unsigned long runs = _task_runs;
+    unsigned long t0 = micros();
+    schedule();
+    unsigned long t1 = micros();
+    yield_depth--;
+
+    if (runs != _task_runs) load_busy += t1 - t0; else {
+      #ifdef TASKS_IDLE_WAIT
+        // nothing ran, if nothing is due for a while wait for the next interrupt (SysTick, serial, etc.)
+        if (!immediate_pending) {
+          long time_to_next_task = TASKS_READY_QUEUE_HORIZON;
+          for (uint8_t priority = 0; priority <= highest_priority; priority++) {
+            if (!bitRead(queued_priorities, priority)) continue;
+            long t = (long)(queue_due[queue_head[priority]] - t1);
+            if (t < time_to_next_task) time_to_next_task = t;
+          }
+          if (time_to_next_task >= TASKS_IDLE_WAIT_MIN) TASKS_IDLE_WAIT_FOR_INTERRUPT();
+        }
+      #endif
+    }
+
+    unsigned long window = t1 - load_window_start;
+    if (window >= 1000000UL) {
+      load = (load_busy*100.0F)/window;
+      load_busy = 0;
+      load_window_start = t1;
+    }
+  }
+
+  float Tasks::getLoad() {
+    return load;
+  }
+#endif
+
+IRAM_HOT uint64_t Tasks::micros64() {
+  #ifdef HAL_MICROS64
+    return HAL_MICROS64();
+  #else
+    // micros() extended to 64 bits, every scheduler pass reads it so no rollover is missed
+    noInterrupts();
+    unsigned long t = micros();
+    if (t < micros_last) micros_high++;
+    micros_last = t;
+    uint64_t result = ((uint64_t)micros_high << 32) | t;
+    interrupts();
+    return result;
+  #endif
+}
+
 void Tasks::yield(unsigned long milliseconds) {
   unsigned long endTime = millis() + milliseconds;
   while ((long)(millis() - endTime) < 0) this->yield();
@@ -618,6 +1125,7 @@ void Tasks::updatePriorityRange() {
   // scan for highest priority
   highest_priority = 0;
   for (uint8_t e = 0; e <= highest_task; e++) {
+    if (!allocated[e]) continue;
     uint8_t p = task[e]->getPriority();
     if (p > highest_priority) highest_priority = p;
   }
@@ -634,4 +1142,54 @@ void Tasks::updateEventRange() {
   }
 }
 
+#ifdef TASKS_READY_QUEUE
+  IRAM_HOT void Tasks::queueInsert(uint8_t e) {
+    if (queued[e] || task[e]->hardware_timer || !TASKS_ON_LOOP_CORE(e)) return;
+
+    unsigned long due = micros() + task[e]->getMicrosToNext();
+    uint8_t priority = task[e]->getPriority();
+
+    // find our place in line, behind any tasks due at the same time so equals still take turns
+    uint8_t *link = &queue_head[priority];
+    while (*link != 255 && (long)(queue_due[*link] - due) <= 0) link = &queue_next[*link];
+
+    queue_due[e] = due;
+    queue_next[e] = *link;
+    *link = e;
+    queued[e] = true;
+    bitSet(queued_priorities, priority);
+  }
+
+  IRAM_HOT void Tasks::queueRemove(uint8_t e) {
+    if (!queued[e]) return;
+
+    uint8_t priority = task[e]->getPriority();
+    uint8_t *link = &queue_head[priority];
+    while (*link != 255) {
+      if (*link == e) { *link = queue_next[e]; break; }
+      link = &queue_next[*link];
+    }
+
+    queued[e] = false;
+    if (queue_head[priority] == 255) bitClear(queued_priorities, priority);
+  }
+
+  IRAM_HOT void Tasks::queueReschedule(uint8_t e) {
+    // a task that isn't queued is running and gets put back in line when it exits
+    if (!queued[e]) return;
+    queueRemove(e);
+    queueInsert(e);
+  }
+
+  IRAM_HOT void Tasks::queueImmediate() {
+    immediate_pending = false;
+    for (uint8_t e = 0; e <= highest_task; e++) {
+      #ifdef TASKS_CORE_AFFINITY
+        if (allocated[e] && task_core[e] == -2) { task_core[e] = -1; queueInsert(e); }
+      #endif
+      if (allocated[e] && queued[e] && task[e]->immediate) queueReschedule(e);
+    }
+  }
+#endif
+
 Tasks tasks;
@@ -36,6 +36,11 @@
   #define IRAM_ATTR
 #endif
 
+// the scheduler's polling path, placed in IRAM by the application when it asks for it
+#ifndef IRAM_HOT
+  #define IRAM_HOT
+#endif
+
 // To enable the option to use a given hardware timer (1..4), if available, uncomment that line:
 #ifndef TASKS_HWTIMERS
   #define TASKS_HWTIMERS -1
@@ -66,6 +71,52 @@
 // comment out and any task can run except the task that yields
 #define TASKS_HIGHER_PRIORITY_ONLY
 
+// default is to poll every software timed task during a yield() to find one that is due
+// to instead keep a ready queue where tasks are sorted by next due time within each priority level
+// (so a yield() reads the clock once and checks only the first task in each level) use:
+// #define TASKS_READY_QUEUE
+#ifdef TASKS_READY_QUEUE
+  // the furthest ahead (in microseconds) a task is scheduled in the ready queue, tasks due later
+  // than this are simply polled again at this interval (keeps the queue safe from timer wrap)
+  #ifndef TASKS_READY_QUEUE_HORIZON
+    #define TASKS_READY_QUEUE_HORIZON 1000000L
+  #endif
+#endif
+
+// to keep run-time statistics for each software timed task (a count of polls and missed periods, the worst case and
+// log scaled histograms of arrival lateness and runtime) for use in production firmware use:
+// #define TASKS_STATISTICS_ENABLE
+#ifdef TASKS_STATISTICS_ENABLE
+  // histogram bins are in microseconds, bin0 < 16, bin1 < 64, bin2 < 256, ... bin7 >= 262144 (x4 per bin)
+  #define TASKS_HISTOGRAM_BINS 8
+#endif
+
+// to give tasks a group (tasks added while a task of the group runs join it) and a runtime budget per call, and keep
+// their runtime net of any higher priority tasks that ran while they yielded, use:
+// #define TASKS_BUDGET_ENABLE
+
+// to measure processor load (the fraction of time loop() spends in yield() passes that ran a task) use:
+// #define TASKS_LOAD_METER
+// and with TASKS_READY_QUEUE the processor can also be idled until the next interrupt
+// (when no software timed task is due for at least TASKS_IDLE_WAIT_MIN microseconds) use:
+// #define TASKS_IDLE_WAIT
+#if defined(TASKS_IDLE_WAIT) && (!defined(TASKS_LOAD_METER) || !defined(TASKS_READY_QUEUE))
+  #error "Configuration (OnTask): TASKS_IDLE_WAIT requires TASKS_LOAD_METER and TASKS_READY_QUEUE"
+#endif
+#ifndef TASKS_IDLE_WAIT_MIN
+  #define TASKS_IDLE_WAIT_MIN 1500L
+#endif
+
+// on dual core ESP32's a task can be moved with setCore() to the core that isn't running loop(), where a
+// FreeRTOS task polls it instead of yield(), this is meant for low priority, long running tasks that don't
+// share data with the step generation or tracking code
+#if defined(ESP32) && !defined(CONFIG_FREERTOS_UNICORE)
+  #define TASKS_CORE_AFFINITY
+  #ifndef TASKS_CORE_STACK_SIZE
+    #define TASKS_CORE_STACK_SIZE 8192
+  #endif
+#endif
+
 // ESP32 override cli/sei and use muxes to block the h/w timer ISR's instead
 #ifdef ESP32
   // on the ESP32 noInterrupts()/interrupts() are #defined to be cli()/sei()
@@ -84,6 +135,9 @@
   extern void timerAlarmsEnable();
 #endif
 
+// a deadline that never expires
+#define TASKS_NEVER 0xFFFFFFFFFFFFFFFFULL
+
 // short Y macro to embed yield()
 #define Y tasks.yield()
 
@@ -109,6 +163,7 @@ class Task {
     uint8_t hardware_timer = 0;
 
     void setCallback(void (*volatile callback)());
+    void setCallback(void (*volatile callback)(void *), void *context);
 
     void setTimingMode(TimingMode mode);
 
@@ -127,12 +182,17 @@ class Task {
 
     void setRepeat(bool repeat);
 
-    void setPriority(bool priority);
+    void setPriority(uint8_t priority);
     uint8_t getPriority();
 
     void setNameStr(const char name[]);
     char *getNameStr();
 
+    #ifdef TASKS_READY_QUEUE
+      // microseconds until this task should next be polled (0 if due now), limited to TASKS_READY_QUEUE_HORIZON
+      unsigned long getMicrosToNext();
+    #endif
+
     #ifdef TASKS_PROFILER_ENABLE
       float getArrivalAvg();
       float getArrivalMax();
@@ -141,6 +201,25 @@ class Task {
       float getRuntimeMax();
     #endif
 
+    #ifdef TASKS_STATISTICS_ENABLE
+      unsigned long getPollCount();
+      unsigned long getMissCount();
+      unsigned long getLatenessMax();
+      unsigned long getRuntimeMaxMicros();
+      uint16_t getLatenessHistogram(uint8_t bin);
+      uint16_t getRuntimeHistogram(uint8_t bin);
+      void clearStatistics();
+    #endif
+
+    #ifdef TASKS_BUDGET_ENABLE
+      void setGroup(uint8_t group, unsigned long budget);
+      inline uint8_t getGroup() { return group; }
+      inline unsigned long getBudget() { return budget; }
+      inline unsigned long getRuntimeNetTotal() { return runtime_net_total; }
+      inline unsigned long getRuntimeNetMax() { return runtime_net_max; }
+      inline unsigned long getOverrunCount() { return overrun_count; }
+    #endif
+
     volatile bool immediate = true;
 
   private:
@@ -148,6 +227,9 @@ class Task {
     void setHardwareTimerPeriod();
 
     char                   processName[8];
+    #ifdef TASKS_PROBE_ENABLE
+      uint8_t              probe             = 0;
+    #endif
     unsigned long          period            = 0;
     unsigned long          next_period       = 0;
     unsigned long          duration          = 0;
@@ -162,6 +244,8 @@ class Task {
     unsigned long          next_task_time    = 0;
     TimingMode             timingMode        = TM_BALANCED;
     void (*volatile callback)() = NULL;
+    void (*volatile contextCallback)(void *) = NULL;
+    void *volatile         context           = NULL;
 
     #ifdef TASKS_PROFILER_ENABLE
       volatile double        average_arrival_time       = 0;
@@ -171,6 +255,26 @@ class Task {
       volatile unsigned long total_runtime_count        = 0;
       volatile long          max_runtime                = 0;
     #endif
+
+    #ifdef TASKS_STATISTICS_ENABLE
+      // record arrival lateness and runtime (in microseconds) for this poll
+      void recordStatistics(unsigned long lateness, unsigned long runtime);
+
+      unsigned long          poll_count                 = 0;
+      unsigned long          miss_count                 = 0;
+      unsigned long          max_lateness               = 0;
+      unsigned long          max_runtime_micros         = 0;
+      uint16_t               lateness_histogram[TASKS_HISTOGRAM_BINS];
+      uint16_t               runtime_histogram[TASKS_HISTOGRAM_BINS];
+    #endif
+
+    #ifdef TASKS_BUDGET_ENABLE
+      uint8_t                group                      = 0;
+      unsigned long          budget                     = 0;
+      unsigned long          runtime_net_total          = 0;
+      unsigned long          runtime_net_max            = 0;
+      unsigned long          overrun_count              = 0;
+    #endif
 };
 
 class Tasks {
@@ -205,6 +309,14 @@ class Tasks {
     // \return          handle to the task on success, or 0 on failure
     uint8_t add(uint32_t period, uint32_t duration, bool repeat, uint8_t priority, void (*volatile callback)(), const char name[]);
 
+    // add process task, as above but the callback is passed a context pointer (usually the object it works on)
+    // this avoids the need for a wrapper function (and a global object lookup) for each instance of a class
+    // \param callback  function to handle this tasks processing
+    // \param context   pointer passed to the callback
+    // \param name      an optional short (max length 7) char str describing the task 
+    // \return          handle to the task on success, or 0 on failure
+    uint8_t add(uint32_t period, uint32_t duration, bool repeat, uint8_t priority, void (*volatile callback)(void *), void *context, const char name[]);
+
     // allocates a hardware timer, if available, for this task. Note: for the associated task: *repeat* must be true,
     // *priority* must be 0 (all are higher than s/w task priority 0.)
     // \param handle        task handle
@@ -219,6 +331,13 @@ class Tasks {
     // \return              true if successful, or false if unable to find the associated task
     bool setCallback(uint8_t handle, void (*volatile callback)());
 
+    // change task callback to one that is passed a context pointer
+    // \param handle        task handle
+    // \param callback      function to handle this tasks processing
+    // \param context       pointer passed to the callback
+    // \return              true if successful, or false if unable to find the associated task
+    bool setCallback(uint8_t handle, void (*volatile callback)(void *), void *context);
+
     // change task timing mode
     // \param handle        task handle
     // \param mode          either TM_BALANCED (default) or TM_MINIMUM
@@ -273,7 +392,14 @@ class Tasks {
     IRAM_ATTR void setPeriodRatioSubMicros(unsigned long value);
 
     // set process to run immediately on the next pass (within its priority level)
-    IRAM_ATTR inline void immediate(uint8_t handle) { if (handle != 0 && allocated[handle - 1]) { task[handle - 1]->immediate = true; } }
+    IRAM_ATTR inline void immediate(uint8_t handle) {
+      if (handle != 0 && allocated[handle - 1]) {
+        task[handle - 1]->immediate = true;
+        #ifdef TASKS_READY_QUEUE
+          immediate_pending = true;
+        #endif
+      }
+    }
 
     // change process duration (milliseconds,) use 0 for disabled
     void setDuration(uint8_t handle, unsigned long duration);
@@ -289,6 +415,16 @@ class Tasks {
     // change process priority level (highest 0 to 7 lowest)
     void setPriority(uint8_t handle, uint8_t priority);
 
+    #ifdef TASKS_CORE_AFFINITY
+      // change the core (0 or 1) this process runs on, the default is the core running loop()
+      // note: software timed tasks only, a task on the other core must end with setDurationComplete()
+      //       and yield() there just gives time to other FreeRTOS tasks
+      bool setCore(uint8_t handle, uint8_t core);
+
+      // polls the tasks assigned to the other core, for internal use by the FreeRTOS task there
+      void pollCore();
+    #endif
+
     // set the process name
     void setNameStr(uint8_t handle, const char name[]);
 
@@ -312,18 +448,87 @@ class Tasks {
       double getRuntimeMax(uint8_t handle);
     #endif
 
+    #ifdef TASKS_STATISTICS_ENABLE
+      // number of times the process was called
+      unsigned long getPollCount(uint8_t handle);
+      // number of times the process was called a full period (or more) late
+      unsigned long getMissCount(uint8_t handle);
+      // largest arrival lateness (in microseconds)
+      unsigned long getLatenessMax(uint8_t handle);
+      // largest runtime (in microseconds)
+      unsigned long getRuntimeMaxMicros(uint8_t handle);
+      // count of calls that arrived late within the range of this histogram bin
+      uint16_t getLatenessHistogram(uint8_t handle, uint8_t bin);
+      // count of calls that ran for a time within the range of this histogram bin
+      uint16_t getRuntimeHistogram(uint8_t handle, uint8_t bin);
+      // zero the statistics for this process, use handle 0 for all processes
+      void clearStatistics(uint8_t handle);
+    #endif
+
     // runs tasks at their prescribed interval, each call can trigger at most a single process
     // processes that are already running are ignored so it's ok to poll() within a process
-    void yield();
+    #ifdef TASKS_LOAD_METER
+      void yield();
+    #else
+      IRAM_HOT inline void yield() { schedule(); }
+    #endif
     void yield(unsigned long milliseconds);
     void yieldMicros(unsigned long microseconds);
 
+    #ifdef TASKS_BUDGET_ENABLE
+      // group and runtime budget (in microseconds, 0 for none) given to tasks added from here on outside of a task
+      // tasks added by a running task join its group and budget instead
+      void setGroup(uint8_t group, unsigned long budget);
+      // group of the process, 0 if none
+      uint8_t getGroup(uint8_t handle);
+      // runtime budget per call (in microseconds)
+      unsigned long getBudget(uint8_t handle);
+      // total runtime (in microseconds, wraps) not counting higher priority tasks that ran while it yielded
+      unsigned long getRuntimeNetTotal(uint8_t handle);
+      // largest runtime of a single call (in microseconds) not counting higher priority tasks
+      unsigned long getRuntimeNetMax(uint8_t handle);
+      // number of calls that ran longer than the budget
+      unsigned long getOverrunCount(uint8_t handle);
+    #endif
+
+    #ifdef TASKS_LOAD_METER
+      // processor load in percent, averaged over about a second
+      float getLoad();
+    #endif
+
+    // free running 64 bit microsecond count, read fresh from the system clock and never wraps
+    uint64_t micros64();
+
+    // the micros64() count at the start of this scheduler pass, a cheap "now" shared by all tasks
+    inline uint64_t now() { return pass_time; }
+
+    // a deadline on the micros64() timebase some time from now, in ms or us
+    inline uint64_t deadline(unsigned long milliseconds) { return pass_time + milliseconds*1000ULL; }
+    inline uint64_t deadlineMicros(unsigned long microseconds) { return pass_time + microseconds; }
+
+    // true once now() has reached the deadline
+    inline bool expired(uint64_t deadline) { return pass_time >= deadline; }
+
   private:
+    // polls the tasks once, this is the body of yield()
+    void schedule();
+
+    #ifdef TASKS_LOAD_METER
+      uint8_t          yield_depth = 0;
+      unsigned long    load_busy = 0;         // microseconds spent in yield() passes that ran a task
+      unsigned long    load_window_start = 0;
+      float            load = 0.0F;
+    #endif
+
     // keep track of the range of priorities so we don't waste cycles looking at empty ones
     void updatePriorityRange();
     // keep track of the range of tasks so we don't waste cycles looking at empty ones
     void updateEventRange();
 
+    uint64_t pass_time = 0;                // micros64() at the start of the scheduler pass
+    unsigned long micros_last = 0;         // for extending micros() to 64 bits when the HAL can't
+    uint32_t micros_high = 0;
+
     uint8_t highest_task     = 0; // the highest task# assigned
     uint8_t highest_priority = 0; // the highest task priority
     #ifdef TASKS_HIGHER_PRIORITY_ONLY
@@ -335,6 +540,30 @@ class Tasks {
     bool    allocated[TASKS_MAX];
     bool    hardware_timer_allocated[4] = {false, false, false, false};
     Task    *task[TASKS_MAX];
+
+    #ifdef TASKS_CORE_AFFINITY
+      int8_t           task_core[TASKS_MAX];  // core this task# runs on, or -1 for the core running loop()
+      int8_t           loop_core = -1;
+      TaskHandle_t     core_runner = NULL;
+    #endif
+
+    #ifdef TASKS_READY_QUEUE
+      // add a software timed task to the ready queue for its priority level, in order of next due time
+      void queueInsert(uint8_t e);
+      // take a task out of the ready queue for its priority level
+      void queueRemove(uint8_t e);
+      // move a queued task to its correct place after its timing changes
+      void queueReschedule(uint8_t e);
+      // move queued tasks flagged by immediate() to the front of the queue
+      void queueImmediate();
+
+      uint8_t          queued_priorities = 0; // bitmap of the priority levels that have queued tasks
+      uint8_t          queue_head[8]     = {255, 255, 255, 255, 255, 255, 255, 255}; // the first task# due at this priority level
+      uint8_t          queue_next[TASKS_MAX]; // the task# due after this one, or 255 if none
+      unsigned long    queue_due[TASKS_MAX];  // time (in microseconds) this task# should next be polled
+      bool             queued[TASKS_MAX];
+      volatile bool    immediate_pending = false;
+    #endif
 };
 
 extern Tasks tasks;
@@ -79,6 +79,17 @@ void TimeLocationSource::get(JulianDate &ut1) {
   }
 }
 
+int TimeLocationSource::getSecond() {
+  if (!ready) return -1;
+
+  // the seconds register alone, one byte instead of the whole date/time
+  HAL_Wire.beginTransmission(0x68);
+  HAL_Wire.write((uint8_t)0x00);
+  if (HAL_Wire.endTransmission() != 0 || HAL_Wire.requestFrom(0x68, 1) != 1) return -1;
+  uint8_t bcd = HAL_Wire.read() & 0x7F;
+  return (bcd >> 4)*10 + (bcd & 0x0F);
+}
+
 TimeLocationSource tls;
 
 #endif
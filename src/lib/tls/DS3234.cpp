@@ -83,6 +83,19 @@ void TimeLocationSource::get(JulianDate &ut1) {
   #endif
 }
 
+int TimeLocationSource::getSecond() {
+  if (!ready) return -1;
+
+  #ifdef SSPI_SHARED
+    SPI.begin();
+  #endif
+  int second = rtcDS3234.GetDateTime().Second();
+  #ifdef SSPI_SHARED
+    SPI.end();
+  #endif
+  return second <= 59 ? second : -1;
+}
+
 TimeLocationSource tls;
 
 #endif
\ No newline at end of file
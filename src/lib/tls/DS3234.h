@@ -32,6 +32,9 @@ class TimeLocationSource {
     // get the RTC's time
     void get(JulianDate &ut1);
 
+    // get just the seconds count (0 to 59) with as short a read as possible, -1 on failure
+    int getSecond();
+
     // not used, date/time is stored as UT1
     double DUT1 = 0.0L;
 
@@ -114,7 +114,9 @@ void TimeLocationSource::get(JulianDate &ut1) {
   ut1 = calendars.gregorianToJulianDay(greg);
   // DUT1 = UT1 − UTC
   // UT1 = DUT1 + UTC
-  ut1.hour = gps.time.hour() + gps.time.minute()/60.0 + (gps.time.second() + DUT1)/3600.0;
+  // the fix is as old as the time since its sentence was read
+  double seconds = gps.time.second() + gps.time.centisecond()/100.0 + gps.time.age()/1000.0;
+  ut1.hour = gps.time.hour() + gps.time.minute()/60.0 + (seconds + DUT1)/3600.0;
 
   // adjust date/time for DUT1 as needed
   if (ut1.hour >= 24.0L) { ut1.hour -= 24.0L; ut1.day += 1.0L; } else
@@ -137,14 +139,20 @@ void TimeLocationSource::poll() {
 
   if (gps.location.isValid() && siteIsValid()) {
     if (gps.date.isValid() && gps.time.isValid() && timeIsValid()) {
-      if (waitIsValid()) {
+      if (!ready && waitIsValid()) {
         VLF("MSG: TLS, GPS date/time/location is ready");
 
-        VLF("MSG: TLS, closing GPS serial port");
-        SERIAL_GPS.end();
+        #if GPS_CONTINUOUS == ON
+          // the UART's RX interrupt buffers the sentences, they only need reading before it fills
+          VF("MSG: TLS, GPS monitor task continues (rate "); V(GPS_POLL_MS); VLF("ms)");
+          tasks.setPeriod(tasks.getHandleByName("gpsPoll"), GPS_POLL_MS);
+        #else
+          VLF("MSG: TLS, closing GPS serial port");
+          SERIAL_GPS.end();
 
-        VLF("MSG: TLS, stopping GPS monitor task");
-        tasks.setDurationComplete(tasks.getHandleByName("gpsPoll"));
+          VLF("MSG: TLS, stopping GPS monitor task");
+          tasks.setDurationComplete(tasks.getHandleByName("gpsPoll"));
+        #endif
 
         #ifdef TLS_TIMELIB
           setTime(gps.time.hour(), gps.time.minute(), gps.time.second(), gps.date.day(), gps.date.month(), gps.date.year());
@@ -156,6 +164,12 @@ void TimeLocationSource::poll() {
   }
 }
 
+#if GPS_CONTINUOUS == ON
+  bool TimeLocationSource::isUpdated() {
+    return ready && gps.time.isUpdated() && gps.date.isValid() && timeIsValid();
+  }
+#endif
+
 // starts keeping track of the wait once (PPS is synced, if applicable) and GPS has a lock 
 bool TimeLocationSource::waitIsValid() {
   if (startTime == 0) startTime = millis();
@@ -15,6 +15,25 @@
 #ifndef GPS_MIN_WAIT_MINUTES
   #define GPS_MIN_WAIT_MINUTES 2 // minimum wait for stabilization in minutes, use 0 to disable
 #endif
+#ifndef GPS_CONTINUOUS
+  #define GPS_CONTINUOUS OFF     // ON keeps reading the GPS after the first fix so drift can be corrected
+#endif
+#ifndef GPS_POLL_MS
+  #define GPS_POLL_MS 50         // in ms, continuous mode reads the serial RX buffer this often (64 bytes is 66ms at 9600 baud)
+#endif
+#ifndef GPS_RESYNC_MINUTES
+  #define GPS_RESYNC_MINUTES 10  // in minutes, how often continuous mode checks the site time against the GPS
+#endif
+#ifndef GPS_RESYNC_MS
+  #define GPS_RESYNC_MS 250      // in ms, the site time is corrected when off by more than this
+#endif
+#ifndef GPS_MOVED_METERS
+  #define GPS_MOVED_METERS 100   // in meters, the site is flagged as moved when the GPS fix is further than this
+#endif
+
+#if GPS_CONTINUOUS != OFF && GPS_CONTINUOUS != ON
+  #error "Configuration (Config.h): Setting GPS_CONTINUOUS unknown, use OFF or ON."
+#endif
 
 class TimeLocationSource {
   public:
@@ -37,6 +56,11 @@ class TimeLocationSource {
     // update from GPS
     void poll();
 
+    #if GPS_CONTINUOUS == ON
+      // true if a new date/time fix has been read since the last get()
+      bool isUpdated();
+    #endif
+
     // for conversion from UTC to UT1
     double DUT1 = 0.0L;
 
@@ -6,8 +6,6 @@
 
 #if defined(TIME_LOCATION_SOURCE) && TIME_LOCATION_SOURCE == NTP
 
-#include <TimeLib.h> // https://github.com/PaulStoffregen/Time/archive/master.zip
-
 #if OPERATIONAL_MODE == WIFI
   #include <WiFiUdp.h>
   WiFiUDP Udp;
@@ -23,15 +21,21 @@ IPAddress timeServer = IPAddress TIME_IP_ADDR;
 // local port to listen for UDP packets
 unsigned int localPort = 8888;
 
+// ms between NTP steps while an update is under way
+#define NTP_STEP_MS 50
+
+// seconds from 1900 (NTP) to 1970 (unix)
+#define NTP_UNIX_OFFSET 2208988800UL
+
 void ntpWrapper() {
-  if (!tls.isReady()) tls.poll();
+  tls.poll();
 }
 
 // initialize
 bool TimeLocationSource::init() {
   
-  VF("MSG: TLS, start NTP monitor task (rate 5 min priority 7)... ");
-  handle = tasks.add(5*60*1000L, 0, true, 7, ntpWrapper, "ntp");
+  VF("MSG: TLS, start NTP monitor task (rate 50ms priority 7)... ");
+  handle = tasks.add(NTP_STEP_MS, 0, true, 7, ntpWrapper, "ntp");
   if (handle) {
     VLF("success");
     active = true;
@@ -43,6 +47,7 @@ bool TimeLocationSource::init() {
   // flag that start time is unknown
   startTime = 0;
 
+  state = NTP_IDLE;
   ready = false;
 
   return active;
@@ -58,6 +63,9 @@ void TimeLocationSource::set(JulianDate ut1) {
 void TimeLocationSource::set(int year, int month, int day, int hour, int minute, int second) {
   #ifdef TLS_TIMELIB
     setTime(hour, minute, second, day, month, year);
+    referenceSeconds = now();
+    referenceFractionMs = 0;
+    referenceTimeMs = millis();
   #else
     (void)year; (void)month; (void)day; (void)hour; (void)minute; (void)second;
   #endif
@@ -65,53 +73,114 @@ void TimeLocationSource::set(int year, int month, int day, int hour, int minute,
 
 void TimeLocationSource::get(JulianDate &ut1) {
   if (!ready) return;
-  if (year() >= 0 && year() <= 3000 && month() >= 1 && month() <= 12 && day() >= 1 && day() <= 31 &&
-      hour() <= 23 && minute() <= 59 && second() <= 59) {
-    GregorianDate greg; greg.year = year(); greg.month = month(); greg.day = day();
+
+  // carry the time forward from the reference by millis(), keeping the fraction of a second
+  unsigned long elapsedMs = (millis() - referenceTimeMs) + referenceFractionMs;
+  tmElements_t t;
+  breakTime(referenceSeconds + elapsedMs/1000UL, t);
+  int year = t.Year + 1970;
+
+  if (year >= 0 && year <= 3000 && t.Month >= 1 && t.Month <= 12 && t.Day >= 1 && t.Day <= 31 &&
+      t.Hour <= 23 && t.Minute <= 59 && t.Second <= 59) {
+    GregorianDate greg; greg.year = year; greg.month = t.Month; greg.day = t.Day;
     ut1 = calendars.gregorianToJulianDay(greg);
-    ut1.hour = hour() + minute()/60.0 + (second() + DUT1)/3600.0;
+    ut1.hour = t.Hour + t.Minute/60.0 + (t.Second + (elapsedMs % 1000UL)/1000.0 + DUT1)/3600.0;
   }
 }
 
 void TimeLocationSource::poll() {
-  Udp.begin(localPort);
-
-  // discard any previously received packets
-  unsigned long tOut = millis() + 3000L;
-  while ((Udp.parsePacket() > 0) && ((long)(millis() - tOut) < 0)) Y;
-
-  VLF("MSG: TLS, transmit NTP Request");
-  sendNTPpacket(timeServer);
-
-  uint32_t beginWait = millis();
-  while (millis() - beginWait < 1500) {
-    int size = Udp.parsePacket();
-    if (size >= NTP_PACKET_SIZE) {
-      VLF("MSG: TLS, receive NTP Response");
-      // read packet into the buffer
-      Udp.read(packetBuffer, NTP_PACKET_SIZE);
-      unsigned long secsSince1900;
-      // convert four bytes starting at location 40 to a long integer
-      secsSince1900 =  (unsigned long)packetBuffer[40] << 24;
-      secsSince1900 |= (unsigned long)packetBuffer[41] << 16;
-      secsSince1900 |= (unsigned long)packetBuffer[42] << 8;
-      secsSince1900 |= (unsigned long)packetBuffer[43];
-      time_t ntpTime = secsSince1900 - 2208988800UL;
-      setTime(ntpTime);
-      DLF("MSG: TLS, next NTP query in 24 hours");
-      tasks.setPeriod(handle, 24L*60L*60L*1000L);
-      ready = true;
-
-      Udp.stop();
-      return;
-    }
-    Y;
+  switch (state) {
+    case NTP_IDLE:
+      // start an update, the task runs quickly until it's done
+      Udp.begin(localPort);
+      requests = 0;
+      bestValid = false;
+      tasks.setPeriod(handle, NTP_STEP_MS);
+      state = NTP_SEND;
+    break;
+
+    case NTP_SEND:
+      // discard anything left over from an earlier request (late replies are also rejected by their origin timestamp)
+      for (int i = 0; i < 4 && Udp.parsePacket() > 0; i++) Udp.flush();
+
+      VLF("MSG: TLS, transmit NTP Request");
+      sendNTPpacket(timeServer);
+      requests++;
+      state = NTP_WAIT;
+    break;
+
+    case NTP_WAIT:
+      receive();
+      if (state == NTP_WAIT && (long)(millis() - sendTimeMs) > NTP_REPLY_TIMEOUT_MS) {
+        VLF("MSG: TLS, no NTP Response");
+        state = NTP_SEND;
+      }
+      if (state == NTP_SEND && requests >= NTP_SAMPLES) complete();
+    break;
+  }
+}
+
+void TimeLocationSource::receive() {
+  int size = Udp.parsePacket();
+  if (size < NTP_PACKET_SIZE) return;
+  unsigned long receiveTimeMs = millis();
+
+  Udp.read(packetBuffer, NTP_PACKET_SIZE);
+
+  #define ntpLong(i) ((unsigned long)packetBuffer[i] << 24 | (unsigned long)packetBuffer[i + 1] << 16 | (unsigned long)packetBuffer[i + 2] << 8 | (unsigned long)packetBuffer[i + 3])
+  #define ntpFractionMs(i) ((long)(((ntpLong(i) >> 16)*1000UL) >> 16))
+
+  // a server reply (mode 4) that's synchronized (leap indicator not 3, stratum not 0) to our request
+  uint8_t leap = packetBuffer[0] >> 6;
+  uint8_t mode = packetBuffer[0] & 0x07;
+  if (mode != 4 || leap == 3 || packetBuffer[1] == 0 || ntpLong(24) != sendTimeMs) {
+    VLF("MSG: TLS, NTP Response rejected");
+    return;
+  }
+
+  // the round trip less the time the server held the request, the reply took about half that to get here
+  unsigned long receiveSeconds = ntpLong(32);
+  unsigned long transmitSeconds = ntpLong(40);
+  long serverMs = (long)(transmitSeconds - receiveSeconds)*1000L + (ntpFractionMs(44) - ntpFractionMs(36));
+  long delayMs = (long)(receiveTimeMs - sendTimeMs) - serverMs;
+  if (delayMs < 0) delayMs = 0;
+
+  VF("MSG: TLS, receive NTP Response (delay "); V(delayMs); VLF("ms)");
+
+  if (!bestValid || delayMs < bestDelayMs) {
+    bestValid = true;
+    bestDelayMs = delayMs;
+    bestSeconds = transmitSeconds;
+    bestFractionMs = ntpFractionMs(44) + delayMs/2;
+    bestTimeMs = receiveTimeMs;
   }
-  DLF("MSG: TLS, no NTP Response :-(");
-  DLF("MSG: TLS, next NTP query in 5 minutes");
-  tasks.setPeriod(handle, 5*60*1000L);
 
+  #undef ntpFractionMs
+  #undef ntpLong
+
+  state = NTP_SEND;
+}
+
+void TimeLocationSource::complete() {
   Udp.stop();
+  state = NTP_IDLE;
+
+  if (!bestValid) {
+    DLF("MSG: TLS, no NTP Response :-(");
+    DLF("MSG: TLS, next NTP query in 5 minutes");
+    tasks.setPeriod(handle, 5*60*1000L);
+    return;
+  }
+
+  referenceSeconds = (time_t)(bestSeconds - NTP_UNIX_OFFSET) + bestFractionMs/1000L;
+  referenceFractionMs = bestFractionMs % 1000L;
+  referenceTimeMs = bestTimeMs;
+  setTime(referenceSeconds + ((millis() - referenceTimeMs) + referenceFractionMs)/1000UL);
+
+  VF("MSG: TLS, NTP time set (best delay "); V(bestDelayMs); VLF("ms)");
+  DLF("MSG: TLS, next NTP query in 24 hours");
+  tasks.setPeriod(handle, 24L*60L*60L*1000L);
+  ready = true;
 }
 
 // send an NTP request to the time server at the given address
@@ -129,6 +198,12 @@ void TimeLocationSource::sendNTPpacket(IPAddress &address) {
   packetBuffer[13]  = 0x4E;
   packetBuffer[14]  = 49;
   packetBuffer[15]  = 52;
+  // our transmit timestamp is just millis(), the server echoes it back as the origin timestamp
+  sendTimeMs = millis();
+  packetBuffer[40] = sendTimeMs >> 24;
+  packetBuffer[41] = sendTimeMs >> 16;
+  packetBuffer[42] = sendTimeMs >> 8;
+  packetBuffer[43] = sendTimeMs;
   // all NTP fields have been given values, now
   // you can send a packet requesting a timestamp:                 
   Udp.beginPacket(address, 123); //NTP requests are to port 123
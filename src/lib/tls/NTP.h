@@ -12,11 +12,20 @@
 #else
   #include <EthernetUdp.h>
 #endif
+#include <TimeLib.h> // https://github.com/PaulStoffregen/Time/archive/master.zip
 #include "../calendars/Calendars.h"
 
 #ifndef NTP_TIMEOUT_SECONDS
   #define NTP_TIMEOUT_SECONDS 300 // wait up to 5 minutes to get date/time, use 0 to disable timeout
 #endif
+#ifndef NTP_SAMPLES
+  #define NTP_SAMPLES 4           // requests per update, the reply with the shortest round trip is used
+#endif
+#ifndef NTP_REPLY_TIMEOUT_MS
+  #define NTP_REPLY_TIMEOUT_MS 1000 // give up on a request after this long
+#endif
+
+enum NtpState: uint8_t {NTP_IDLE, NTP_SEND, NTP_WAIT};
 
 class TimeLocationSource {
   public:
@@ -36,7 +45,7 @@ class TimeLocationSource {
     // get the RTC's time
     void get(JulianDate &ut1);
 
-    // update from NTP
+    // update from NTP, each call does one step of the exchange and returns without waiting
     void poll();
 
     // for conversion from UTC to UT1
@@ -46,12 +55,34 @@ class TimeLocationSource {
     // send an NTP request to the time server at the given address
     void sendNTPpacket(IPAddress &address);
 
+    // check for the reply and keep it if it has the shortest round trip so far
+    void receive();
+
+    // finish the update, setting the time from the best sample if there is one
+    void complete();
+
     // NTP time is in the first 48 bytes of message
     static const int NTP_PACKET_SIZE = 48;
 
     // buffer to hold incoming & outgoing packets
     uint8_t packetBuffer[NTP_PACKET_SIZE];
 
+    NtpState state = NTP_IDLE;
+    uint8_t requests = 0;
+    unsigned long sendTimeMs = 0;
+
+    // best sample of this update, seconds since 1900 and ms at the moment millis() read bestTimeMs
+    bool bestValid = false;
+    long bestDelayMs = 0;
+    unsigned long bestSeconds = 0;
+    long bestFractionMs = 0;
+    unsigned long bestTimeMs = 0;
+
+    // the time is kept as a unix time and ms at the moment millis() read referenceTimeMs
+    time_t referenceSeconds = 0;
+    long referenceFractionMs = 0;
+    unsigned long referenceTimeMs = 0;
+
     unsigned long startTime = 0;
     bool ready = false;
     bool active = false;
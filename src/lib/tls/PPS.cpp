@@ -7,19 +7,9 @@
 
 #include "../tasks/OnTask.h"
 
-void ppsIsr() {
-  unsigned long t = micros();
-  unsigned long oneSecond = t - pps.lastMicros;
-  if (oneSecond > 1000000 - PPS_WINDOW_MICROS && oneSecond < 1000000 + PPS_WINDOW_MICROS) {
-    pps.averageMicros = (pps.averageMicros*(PPS_SECS_TO_AVERAGE - 1) + oneSecond)/PPS_SECS_TO_AVERAGE;
-    pps.synced = true;
-    tasks.setPeriodRatioSubMicros(pps.averageMicros*16UL);
-  } else {
-    pps.synced = false;
-    tasks.setPeriodRatioSubMicros(16000000UL);
-  }
-  pps.lastMicros = t;
-}
+void ppsIsr() { pps.edge(micros()); }
+
+void ppsPollWrapper() { pps.poll(); }
 
 void Pps::init() {
     VLF("MSG: PPS, attaching ISR to sense input");
@@ -31,6 +21,72 @@ void Pps::init() {
     #elif TIME_LOCATION_PPS_SENSE == BOTH
       attachInterrupt(digitalPinToInterrupt(PPS_SENSE_PIN), ppsIsr, CHANGE);
     #endif
+
+    VF("MSG: PPS, start monitor task (rate 1000ms priority 7)... ");
+    if (tasks.add(1000, 0, true, 7, ppsPollWrapper, "PpsPoll")) { VLF("success"); } else { VLF("FAILED!"); }
+}
+
+void Pps::poll() {
+  noInterrupts();
+  unsigned long since = micros() - lastMicros;
+  if (locked && since > 1000000UL + PPS_WINDOW_MICROS && !holdover) {
+    // a missed edge, carry on at the estimated frequency without steering the phase
+    holdover = true;
+    steer(frequencySubMicros);
+  }
+  if (locked && since > PPS_HOLDOVER_SECS*1000000UL) {
+    locked = false;
+    synced = false;
+    holdover = false;
+  }
+  interrupts();
+}
+
+void Pps::edge(unsigned long t) {
+  unsigned long interval = t - lastMicros;
+
+  if (!locked) {
+    // the first good second sets the frequency and the clock's phase is taken from this edge
+    if (interval > 1000000UL - PPS_WINDOW_MICROS && interval < 1000000UL + PPS_WINDOW_MICROS) {
+      frequencySubMicros = interval*16UL;
+      modelMicros = t;
+      phaseMicros = 0;
+      errorMicros = 0;
+      locked = true;
+      synced = true;
+      steer(frequencySubMicros);
+    }
+    lastMicros = t;
+    return;
+  }
+
+  // whole seconds since the last good edge, the ones missed in a dropout are bridged
+  long seconds = (long)((interval + 500000UL)/1000000UL);
+  long deviation = (long)interval - (seconds*frequencySubMicros)/16;
+
+  // anything else is a glitch, not a second, and the last good edge stays the reference
+  if (seconds < 1 || seconds > PPS_HOLDOVER_SECS || labs(deviation) > PPS_WINDOW_MICROS) return;
+
+  // frequency loop, a running average of the measured length of a second
+  long measured = (long)(interval*16UL)/seconds;
+  frequencySubMicros += (measured - frequencySubMicros)/PPS_SECS_TO_AVERAGE;
+
+  // phase loop, where the disciplined clock says these seconds ended vs. the edge
+  modelMicros += (seconds*(long)periodSubMicros)/16;
+  phaseMicros = (long)(modelMicros - t);
+  errorMicros += (labs(phaseMicros) - errorMicros)/8;
+
+  // a clock that's behind gets shorter seconds until it catches up, and the other way around
+  steer(frequencySubMicros - (phaseMicros*16L)/PPS_PHASE_SECS);
+
+  holdover = false;
+  synced = true;
+  lastMicros = t;
+}
+
+void Pps::steer(unsigned long period) {
+  periodSubMicros = period;
+  tasks.setPeriodRatioSubMicros(period);
 }
 
 Pps pps;
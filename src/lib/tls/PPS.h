@@ -5,23 +5,37 @@
 
 #if defined(TIME_LOCATION_PPS_SENSE) && TIME_LOCATION_PPS_SENSE != OFF
 
-#define PPS_SECS_TO_AVERAGE 40   // running average of 40 samples (1 per second)
-#define PPS_WINDOW_MICROS 20000  // +/- window in microseconds to meet synced criteria (2%)
-
-#if !defined(PPS_SENSE_PIN) || PPS_SENSE_PIN == OFF
-  #error "Configuration (Config.h): PPS_SENSE_PIN must be defined for TIME_LOCATION_PPS_SENSE ON"
-#endif
+#define PPS_SECS_TO_AVERAGE 40   // frequency loop time constant in seconds (1 sample per second)
+#define PPS_PHASE_SECS 10        // phase loop time constant in seconds, how quickly a phase offset is steered out
+#define PPS_WINDOW_MICROS 20000  // +/- window in microseconds for an edge to count as a second (2%)
+#define PPS_HOLDOVER_SECS 60     // in seconds, the last frequency estimate carries on this long without PPS edges
 
 class Pps {
   public:
     // attach interrupt and start PPS
     void init();
 
-    volatile bool synced = false;
+    // watch for the PPS edges stopping, holdover and then loss of sync
+    void poll();
+
+    // discipline loop, t is the micros() count at a PPS edge
+    void edge(unsigned long t);
+
+    volatile bool synced = false;        // locked to PPS, including holdover
+    volatile bool holdover = false;      // edges have stopped, running on the estimated frequency
+
+    volatile unsigned long periodSubMicros = 16000000UL; // length of a second in use, in sub-micros (16 per us)
+    volatile long frequencySubMicros = 16000000UL;       // estimated length of a PPS second, in sub-micros
+    volatile long phaseMicros = 0;       // disciplined clock minus PPS at the last edge, in us
+    volatile long errorMicros = 0;       // estimated timing error (average size of the phase offset), in us
 
-    volatile unsigned long averageMicros = 1000000;
     volatile unsigned long lastMicros = 1000000;
   private:
+    // use this length of second for timing
+    void steer(unsigned long period);
+
+    volatile unsigned long modelMicros = 0; // micros() count where the disciplined clock reached the last edge's second
+    volatile bool locked = false;
 };
 
 extern Pps pps;
@@ -74,6 +74,13 @@ void TimeLocationSource::get(JulianDate &ut1) {
   }
 }
 
+int TimeLocationSource::getSecond() {
+  if (!ready) return -1;
+
+  sTimeData_t dateTime = rtcSD3031.getRTCTime();
+  return dateTime.second <= 59 ? dateTime.second : -1;
+}
+
 TimeLocationSource tls;
 
 #endif
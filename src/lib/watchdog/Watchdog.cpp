@@ -1,17 +1,80 @@
 // -----------------------------------------------------------------------------------------------------------------------------
-// General purpose "virtual" watchdog
+// General purpose watchdog, uses the MCU's hardware watchdog where available or a "virtual" one otherwise
 #include "Watchdog.h"
 
 #include "../tasks/OnTask.h"
 
 #if !defined(__AVR_ATmega2560__) && defined(WATCHDOG) && WATCHDOG != OFF
 
+#if defined(ESP32)
+  #include <esp_task_wdt.h>
+#elif defined(ARDUINO_ARCH_STM32)
+  #include <IWatchdog.h>
+#endif
+
+#if defined(ESP32)
+  // survives the reset so the starved task can be reported at the next boot
+  #define WATCHDOG_STARVED_MAGIC 0x57444F47UL
+  RTC_NOINIT_ATTR static uint32_t lastStarvedMagic;
+  RTC_NOINIT_ATTR static char lastStarvedName[8];
+#endif
+
 void watchdogWrapper() { watchdog.poll(); }
 
+#ifdef WATCHDOG_HARDWARE
+// start the hardware watchdog, false if it couldn't be started
+static bool hardwareStart(int seconds) {
+  #if defined(ESP32)
+    #if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+      esp_task_wdt_config_t config = { .timeout_ms = (uint32_t)seconds*1000UL, .idle_core_mask = 0, .trigger_panic = true };
+      if (esp_task_wdt_reconfigure(&config) != ESP_OK && esp_task_wdt_init(&config) != ESP_OK) return false;
+    #else
+      if (esp_task_wdt_init(seconds, true) != ESP_OK) return false;
+    #endif
+    // the loop task is the one that feeds it, the core may have subscribed it already
+    esp_err_t e = esp_task_wdt_add(NULL);
+    return e == ESP_OK || e == ESP_ERR_INVALID_ARG;
+  #elif defined(ARDUINO_TEENSY40) || defined(ARDUINO_TEENSY41)
+    // timeout is in 0.5 second steps, WDA and SRS are set so only a timeout resets the MCU
+    CCM_CCGR3 |= CCM_CCGR3_WDOG1(3);
+    WDOG1_WMCR = 0;
+    WDOG1_WCR = WDOG_WCR_SRS | WDOG_WCR_WDA | WDOG_WCR_WT(seconds*2 - 1) | WDOG_WCR_WDE;
+    return true;
+  #elif defined(ARDUINO_ARCH_STM32)
+    IWatchdog.begin((uint32_t)seconds*1000000UL);
+    return true;
+  #endif
+}
+#endif
+
+static inline void hardwareFeed() {
+  #if defined(ESP32)
+    esp_task_wdt_reset();
+  #elif defined(ARDUINO_TEENSY40) || defined(ARDUINO_TEENSY41)
+    WDOG1_WSR = 0x5555;
+    WDOG1_WSR = 0xAAAA;
+  #elif defined(ARDUINO_ARCH_STM32)
+    IWatchdog.reload();
+  #endif
+}
+
 void Watchdog::enable(int seconds) {
   if (this->seconds == -1) {
+    #if defined(ESP32)
+      if (lastStarvedMagic == WATCHDOG_STARVED_MAGIC) {
+        lastStarvedName[7] = 0;
+        DF("WRN: Watchdog, last reset was task "); D(lastStarvedName); DLF(" starved");
+      }
+      lastStarvedMagic = 0;
+    #endif
+
     this->seconds = seconds;
 
+    #ifdef WATCHDOG_HARDWARE
+      VF("MSG: Watchdog, start " WATCHDOG_HARDWARE " ("); V(seconds); VF("s timeout)... ");
+      if (hardwareStart(seconds)) { VLF("success"); enabled = true; return; } else { VLF("FAILED!"); }
+    #endif
+
     // poll at 100ms
     VF("MSG: Watchdog, start monitor task (100ms rate priority 0)... ");
     uint8_t taskHandle = tasks.add(100, 0, true, 0, watchdogWrapper, "wdog");
@@ -24,6 +87,64 @@ void Watchdog::enable(int seconds) {
   enabled = true;
 }
 
+void Watchdog::reset() {
+  if (seconds == -1) return;
+
+  // the heartbeats are slow so there's no need to look more often than the virtual watchdog counts
+  unsigned long now = millis();
+  if ((long)(now - lastCheckMs) < 100) return;
+  lastCheckMs = now;
+
+  if (enabled) {
+    if (starved == 0) {
+      starved = findStarved();
+      if (starved) {
+        DF("ERR: Watchdog, task "); D(heartbeats[starved - 1].name); DF(" starved for "); D(now - heartbeats[starved - 1].lastMs);
+        DF("ms, MCU reset in "); D(seconds); DLF("s");
+        #if defined(ESP32)
+          memcpy(lastStarvedName, heartbeats[starved - 1].name, sizeof(lastStarvedName));
+          lastStarvedMagic = WATCHDOG_STARVED_MAGIC;
+        #endif
+      }
+    }
+
+    // once a task has starved the watchdog is left to run out
+    if (starved) return;
+  }
+
+  count = 0;
+  hardwareFeed();
+}
+
+void Watchdog::resume() {
+  if (seconds == -1) return;
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < heartbeatCount; i++) heartbeats[i].lastMs = now;
+  enabled = true;
+}
+
+uint8_t Watchdog::heartbeatRegister(const char *name, unsigned long timeoutMs) {
+  if (heartbeatCount >= WATCHDOG_HEARTBEATS_MAX) { DLF("ERR: Watchdog, too many heartbeats"); return 0; }
+
+  WatchdogHeartbeat *h = &heartbeats[heartbeatCount];
+  strncpy(h->name, name, sizeof(h->name) - 1);
+  h->name[sizeof(h->name) - 1] = 0;
+  h->timeoutMs = timeoutMs;
+  h->lastMs = millis();
+  h->active = false;
+
+  VF("MSG: Watchdog, heartbeat "); V(h->name); VF(" registered ("); V(timeoutMs); VLF("ms timeout)");
+  return ++heartbeatCount;
+}
+
+uint8_t Watchdog::findStarved() {
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < heartbeatCount; i++) {
+    if (heartbeats[i].active && (long)(now - heartbeats[i].lastMs) > (long)heartbeats[i].timeoutMs) return i + 1;
+  }
+  return 0;
+}
+
 void Watchdog::poll() {
   if (!enabled) return;
   if (count++ > 10 * seconds) { HAL_RESET(); }
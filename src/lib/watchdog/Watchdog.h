@@ -1,29 +1,78 @@
 // -----------------------------------------------------------------------------------------------------------------------------
-// General purpose "virtual" watchdog
+// General purpose watchdog, uses the MCU's hardware watchdog where available or a "virtual" one otherwise
 #pragma once
 
 #include "../../Common.h"
 
 #if !defined(__AVR_ATmega2560__) && defined(WATCHDOG) && WATCHDOG != OFF
 
+#define WATCHDOG_PRESENT
+
+#if defined(ESP32)
+  #define WATCHDOG_HARDWARE "ESP32 TWDT"
+#elif defined(ARDUINO_TEENSY40) || defined(ARDUINO_TEENSY41)
+  #define WATCHDOG_HARDWARE "WDOG1"
+#elif defined(ARDUINO_ARCH_STM32)
+  #define WATCHDOG_HARDWARE "IWDG"
+#endif
+
+// tasks that can be monitored for liveness, the axis monitors (up to nine) and mount tracking, limits, and goto
+#define WATCHDOG_HEARTBEATS_MAX 12
+
+typedef struct WatchdogHeartbeat {
+  char name[8];
+  unsigned long timeoutMs;
+  volatile unsigned long lastMs;
+  volatile bool active;
+} WatchdogHeartbeat;
+
 class Watchdog {
   public:
     // initialize and start the watchdog with timeout (to reset MCU) of seconds
     void enable(int seconds);
 
     // call atleast once every (seconds) to reset the count or the MCU will be reset if WD is enabled
-    inline void reset() { count = 0; }
+    // the count is only reset (and the hardware watchdog fed) while every active heartbeat is fresh
+    void reset();
 
-    // disable the watchdog
+    // disable the watchdog, the hardware watchdogs can't be stopped once running so they are just fed from here on
     inline void disable() { enabled = false; }
 
+    // enable again after disable(), the heartbeats start over so tasks that were held off meanwhile aren't starved
+    void resume();
+
+    // register a task that must call heartbeat() at least every timeoutMs once it has started
+    // returns a handle or 0 if there are too many heartbeats
+    uint8_t heartbeatRegister(const char *name, unsigned long timeoutMs = WATCHDOG_HEARTBEAT_MS);
+
+    // the task is alive, the first heartbeat (or the first after heartbeatIdle()) starts monitoring
+    inline void heartbeat(uint8_t handle) {
+      if (handle == 0) return;
+      heartbeats[handle - 1].lastMs = millis();
+      heartbeats[handle - 1].active = true;
+    }
+
+    // stop monitoring a task that has gone idle until its next heartbeat
+    inline void heartbeatIdle(uint8_t handle) { if (handle != 0) heartbeats[handle - 1].active = false; }
+
+    // name of the task that starved or NULL if none has
+    inline const char *starvedName() { return starved ? heartbeats[starved - 1].name : NULL; }
+
     // for internal use
     void poll();
 
   private:
+    // returns the handle of the first active heartbeat that is overdue or 0 if all are fresh
+    uint8_t findStarved();
+
     volatile int16_t count = 0;
     volatile int16_t seconds = -1;
     volatile bool enabled = false;
+
+    WatchdogHeartbeat heartbeats[WATCHDOG_HEARTBEATS_MAX];
+    uint8_t heartbeatCount = 0;
+    uint8_t starved = 0;
+    unsigned long lastCheckMs = 0;
 };
 
 extern Watchdog watchdog;
@@ -0,0 +1,109 @@
+// -----------------------------------------------------------------------------------
+// Web server responses, a fixed buffer chunked writer and precompressed static assets
+
+#include "WebResponse.h"
+
+#if OPERATIONAL_MODE != OFF && WEB_SERVER == ON
+
+WebResponse::WebResponse(int code, const char *contentType) {
+  www.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  www.send(code, contentType, "");
+}
+
+WebResponse::~WebResponse() {
+  end();
+}
+
+size_t WebResponse::write(uint8_t data) {
+  if (ended) return 0;
+  if (count >= WEB_RESPONSE_BUFFER_SIZE) send();
+  buffer[count++] = data;
+  return 1;
+}
+
+size_t WebResponse::write(const uint8_t *data, size_t length) {
+  if (ended) return 0;
+  size_t written = 0;
+  while (written < length) {
+    if (count >= WEB_RESPONSE_BUFFER_SIZE) send();
+    size_t n = WEB_RESPONSE_BUFFER_SIZE - count;
+    if (n > length - written) n = length - written;
+    memcpy(&buffer[count], &data[written], n);
+    count += n;
+    written += n;
+  }
+  return length;
+}
+
+void WebResponse::end() {
+  if (ended) return;
+  send();
+  #if OPERATIONAL_MODE == WIFI
+    // the zero length chunk ends the response
+    www.sendContent(buffer, 0);
+  #endif
+  ended = true;
+}
+
+void WebResponse::send() {
+  if (count == 0) return;
+  #if OPERATIONAL_MODE == WIFI
+    www.sendContent(buffer, count);
+  #else
+    www.sendContent((const uint8_t*)buffer, count);
+  #endif
+  count = 0;
+}
+
+void webAssetHandler() { webAssets.serve(); }
+
+void WebAssets::init() {
+  #if OPERATIONAL_MODE == WIFI
+    static const char *headers[] = {"If-None-Match"};
+    www.collectHeaders(headers, 1);
+  #endif
+}
+
+bool WebAssets::add(const WebAsset *asset) {
+  if (count >= WEB_ASSET_COUNT_MAX) { DLF("WRN: WebAssets, too many assets"); return false; }
+  assets[count++] = asset;
+  www.on(asset->uri, webAssetHandler);
+  return true;
+}
+
+void WebAssets::serve() {
+  const WebAsset *asset = NULL;
+  for (int i = 0; i < count; i++) if (strcmp(www.uri().c_str(), assets[i]->uri) == 0) { asset = assets[i]; break; }
+  if (asset == NULL) { www.send(404, "text/plain", "Not found"); return; }
+
+  // the browser's copy is current, tell it so without sending the file again
+  #if OPERATIONAL_MODE == WIFI
+    bool current = strcmp(www.header("If-None-Match").c_str(), asset->etag) == 0;
+  #else
+    bool current = strcmp(www.ifNoneMatch(), asset->etag) == 0;
+  #endif
+
+  char cacheControl[24];
+  sprintf(cacheControl, "max-age=%ld", (long)WEB_ASSET_MAX_AGE);
+  www.sendHeader("ETag", asset->etag);
+  www.sendHeader("Cache-Control", cacheControl);
+
+  if (current) {
+    www.setContentLength(0);
+    www.send(304, asset->contentType, "");
+    return;
+  }
+
+  www.sendHeader("Content-Encoding", "gzip");
+  #if OPERATIONAL_MODE == WIFI
+    www.send_P(200, asset->contentType, (PGM_P)asset->data, asset->length);
+  #else
+    www.setContentLength(asset->length);
+    www.send(200, asset->contentType, "");
+    www.sendContent(asset->data, asset->length);
+  #endif
+}
+
+WebAssets webAssets;
+
+#endif
@@ -0,0 +1,81 @@
+// -----------------------------------------------------------------------------------
+// Web server responses, a fixed buffer chunked writer and precompressed static assets
+#pragma once
+
+#include "../../Common.h"
+
+#ifndef OPERATIONAL_MODE
+#define OPERATIONAL_MODE OFF
+#endif
+
+#if OPERATIONAL_MODE == WIFI
+  #include "../wifi/webServer/WebServer.h"
+#elif OPERATIONAL_MODE == ETHERNET_W5100 || OPERATIONAL_MODE == ETHERNET_W5500
+  #include "../ethernet/webServer/WebServer.h"
+#endif
+
+#if OPERATIONAL_MODE != OFF && WEB_SERVER == ON
+
+#ifndef WEB_RESPONSE_BUFFER_SIZE
+  #define WEB_RESPONSE_BUFFER_SIZE 512      // page content is sent in pieces up to this size
+#endif
+#ifndef WEB_ASSET_MAX_AGE
+  #define WEB_ASSET_MAX_AGE        86400    // in seconds, how long browsers may cache a static asset
+#endif
+#ifndef WEB_ASSET_COUNT_MAX
+  #define WEB_ASSET_COUNT_MAX      16
+#endif
+
+// builds a page in a fixed buffer, sending it as the buffer fills, so no String is ever allocated
+// use as: WebResponse r(200, "text/html"); r.print(...); ... r.end();
+class WebResponse : public Print {
+  public:
+    // sends the response header, the length isn't known so the body goes out chunked (or until close)
+    WebResponse(int code, const char *contentType);
+    ~WebResponse();
+
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t count);
+    using Print::write;
+
+    // send what's buffered and finish the response
+    void end();
+
+  private:
+    void send();
+
+    char buffer[WEB_RESPONSE_BUFFER_SIZE + 1];
+    size_t count = 0;
+    bool ended = false;
+};
+
+// a gzip compressed file in flash, make the data and length with for example:
+//   gzip -9 -c index.html | xxd -i
+// the etag should change whenever the file does (a hash or the build date works)
+typedef struct WebAsset {
+  const char *uri;
+  const char *contentType;
+  const uint8_t *data;
+  size_t length;
+  const char *etag;
+} WebAsset;
+
+class WebAssets {
+  public:
+    // have the web server keep the request headers needed, call before www.begin()
+    void init();
+
+    // serve an asset at its uri, returns false if the table is full
+    bool add(const WebAsset *asset);
+
+    // answer a request for a registered asset
+    void serve();
+
+  private:
+    const WebAsset *assets[WEB_ASSET_COUNT_MAX];
+    int count = 0;
+};
+
+extern WebAssets webAssets;
+
+#endif
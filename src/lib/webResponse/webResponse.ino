@@ -0,0 +1,5 @@
+// Placeholder file
+// Nothing to see here ...
+//
+// This file is only present so the Arduino IDE can edit the .h file(s)
+
@@ -4,13 +4,33 @@
 #if OPERATIONAL_MODE == WIFI
 
 #include "../tasks/OnTask.h"
+#include "../counters/Counters.h"
+
+#define STA_ASSOCIATE_TIMEOUT_MS 8000  // give up on the station at startup after this long
 
 #if STA_AUTO_RECONNECT == true
+  #define STA_CONNECT_TIMEOUT_MS   6000  // give up on a connection attempt after this long
+  #define STA_BACKOFF_MS           1000  // wait after the first failed attempt, doubles with each failure
+  #define STA_BACKOFF_MAX_MS       30000
+
   void reconnectStationWrapper() { wifiManager.reconnectStation(); }
+
+  // the callbacks only flag the link state, the reconnect itself is done from the WifiChk task
+  #if defined(ESP32)
+    void stationEvent(WiFiEvent_t event) {
+      #if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 2
+        if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) wifiManager.linkUp = true; else
+        if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) wifiManager.linkUp = false;
+      #else
+        if (event == SYSTEM_EVENT_STA_GOT_IP) wifiManager.linkUp = true; else
+        if (event == SYSTEM_EVENT_STA_DISCONNECTED) wifiManager.linkUp = false;
+      #endif
+    }
+  #endif
 #endif
 
-bool WifiManager::init() {
-  if (!active) {
+void WifiManager::begin() {
+  if (!active && !started) {
 
     #ifdef NV_WIFI_SETTINGS_BASE
       if (WifiSettingsSize < sizeof(WifiSettings)) { nv.initError = true; DL("ERR: WifiManager::init(), WifiSettingsSize error"); }
@@ -61,41 +81,62 @@ bool WifiManager::init() {
       VF("MSG: WiFi, Sta TARGET  = "); VL(target.toString());
     }
 
-  TryAgain:
-    if (settings.accessPointEnabled && !settings.stationEnabled) {
-      VLF("MSG: WiFi, starting Soft AP");
-      WiFi.softAP(settings.ap.ssid, settings.ap.pwd, settings.ap.channel);
-      #if defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
-        WiFi.setTxPower(WIFI_POWER_8_5dBm);
-      #endif
-      WiFi.mode(WIFI_AP);
-    } else
-    if (!settings.accessPointEnabled && settings.stationEnabled) {
-      VLF("MSG: WiFi, starting Station");
-      WiFi.begin(sta->ssid, sta->pwd);
-      #if defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
-        WiFi.setTxPower(WIFI_POWER_8_5dBm);
-      #endif
-      WiFi.mode(WIFI_STA);
-    } else
-    if (settings.accessPointEnabled && settings.stationEnabled) {
-      VLF("MSG: WiFi, starting Soft AP");
-      WiFi.softAP(settings.ap.ssid, settings.ap.pwd, settings.ap.channel);
-      VLF("MSG: WiFi, starting Station");
-      WiFi.begin(sta->ssid, sta->pwd);
-      #if defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
-        WiFi.setTxPower(WIFI_POWER_8_5dBm);
-      #endif
-      WiFi.mode(WIFI_AP_STA);
-    }
+    connect();
+    started = true;
+  }
+}
+
+void WifiManager::connect() {
+  IPAddress ap_ip = IPAddress(settings.ap.ip);
+  IPAddress ap_gw = IPAddress(settings.ap.gw);
+  IPAddress ap_sn = IPAddress(settings.ap.sn);
+  IPAddress sta_ip = IPAddress(sta->ip);
+  IPAddress sta_gw = IPAddress(sta->gw);
+  IPAddress sta_sn = IPAddress(sta->sn);
+
+  if (settings.accessPointEnabled && !settings.stationEnabled) {
+    VLF("MSG: WiFi, starting Soft AP");
+    WiFi.softAP(settings.ap.ssid, settings.ap.pwd, settings.ap.channel);
+    #if defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
+      WiFi.setTxPower(WIFI_POWER_8_5dBm);
+    #endif
+    WiFi.mode(WIFI_AP);
+  } else
+  if (!settings.accessPointEnabled && settings.stationEnabled) {
+    VLF("MSG: WiFi, starting Station");
+    WiFi.begin(sta->ssid, sta->pwd);
+    #if defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
+      WiFi.setTxPower(WIFI_POWER_8_5dBm);
+    #endif
+    WiFi.mode(WIFI_STA);
+  } else
+  if (settings.accessPointEnabled && settings.stationEnabled) {
+    VLF("MSG: WiFi, starting Soft AP");
+    WiFi.softAP(settings.ap.ssid, settings.ap.pwd, settings.ap.channel);
+    VLF("MSG: WiFi, starting Station");
+    WiFi.begin(sta->ssid, sta->pwd);
+    #if defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
+      WiFi.setTxPower(WIFI_POWER_8_5dBm);
+    #endif
+    WiFi.mode(WIFI_AP_STA);
+  }
 
-    delay(100);
-    
-    if (settings.stationEnabled && !sta->dhcpEnabled) WiFi.config(sta_ip, sta_gw, sta_sn);
-    if (settings.accessPointEnabled) WiFi.softAPConfig(ap_ip, ap_gw, ap_sn);
+  delay(100);
+  
+  if (settings.stationEnabled && !sta->dhcpEnabled) WiFi.config(sta_ip, sta_gw, sta_sn);
+  if (settings.accessPointEnabled) WiFi.softAPConfig(ap_ip, ap_gw, ap_sn);
 
-    // wait for connection
-    if (settings.stationEnabled) { for (int i = 0; i < 8; i++) if (WiFi.status() != WL_CONNECTED) delay(1000); else break; }
+  connectStartMs = millis();
+}
+
+bool WifiManager::init() {
+  if (!active) {
+    begin();
+    started = false;
+
+  TryAgain:
+    // wait for connection, time spent since begin() counts toward the timeout
+    if (settings.stationEnabled) { while (WiFi.status() != WL_CONNECTED && (long)(millis() - connectStartMs) < STA_ASSOCIATE_TIMEOUT_MS) delay(100); }
 
     if (settings.stationEnabled && WiFi.status() != WL_CONNECTED) {
 
@@ -107,6 +148,7 @@ bool WifiManager::init() {
         VLF("MSG: WiFi, switching to SoftAP mode");
         settings.stationEnabled = false;
         settings.accessPointEnabled = true;
+        connect();
         goto TryAgain;
       }
 
@@ -122,8 +164,20 @@ bool WifiManager::init() {
 
       #if STA_AUTO_RECONNECT == true
         if (settings.stationEnabled) {
-          VF("MSG: WiFi, start connection check task (rate 8s priority 7)... ");
-          if (tasks.add(8000, 0, true, 7, reconnectStationWrapper, "WifiChk")) { VLF("success"); } else { VLF("FAILED!"); }
+          // reconnects are handled here rather than by the SDK so they can fall back to the other stations
+          WiFi.setAutoReconnect(false);
+          #if defined(ESP32)
+            WiFi.onEvent(stationEvent);
+          #else
+            gotIpHandler = WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP&) { wifiManager.linkUp = true; });
+            disconnectedHandler = WiFi.onStationModeDisconnected([](const WiFiEventStationModeDisconnected&) { wifiManager.linkUp = false; });
+          #endif
+          linkUp = WiFi.status() == WL_CONNECTED;
+          if (linkUp) { stats.connects++; cacheAccessPoint(); }
+          reconnectCounter = counters.add("WiFiRcon");
+
+          VF("MSG: WiFi, start connection monitor task (rate 250ms priority 7)... ");
+          if (tasks.add(250, 0, true, 7, reconnectStationWrapper, "WifiChk")) { VLF("success"); } else { VLF("FAILED!"); }
         }
       #endif
     }
@@ -134,11 +188,84 @@ bool WifiManager::init() {
 
 #if STA_AUTO_RECONNECT == true
   void WifiManager::reconnectStation() {
-    if (WiFi.status() != WL_CONNECTED) {
-      VLF("MSG: WiFi, attempting reconnect");
-      WiFi.disconnect();
-      WiFi.reconnect();
+    unsigned long now = millis();
+
+    if (linkUp) {
+      if (reconnecting) {
+        reconnecting = false;
+        attempting = false;
+        stats.connects++;
+        counters.increment(reconnectCounter);
+        stats.downtimeMs += now - disconnectTimeMs;
+        cacheAccessPoint();
+        VF("MSG: WiFi, reconnected to station "); V(stationNumber); VF(" after "); V(now - disconnectTimeMs); VLF("ms");
+      }
+      stats.rssi = WiFi.RSSI();
+      return;
     }
+
+    // the link just dropped, try again right away on the same access point
+    if (!reconnecting) {
+      VLF("MSG: WiFi, station link lost");
+      reconnecting = true;
+      attempting = false;
+      attempts = 0;
+      stats.disconnects++;
+      disconnectTimeMs = now;
+      nextAttemptTimeMs = now;
+    }
+
+    if (attempting) {
+      if ((long)(now - attemptTimeMs) < STA_CONNECT_TIMEOUT_MS) return;
+
+      // that attempt failed, back off (longer if the link was weak) and after a few tries move on to the next station
+      attempting = false;
+      attempts++;
+      stats.failedAttempts++;
+      unsigned long backoffMs = (unsigned long)STA_BACKOFF_MS << (attempts - 1 < 5 ? attempts - 1 : 5);
+      if (stats.rssi != 0 && stats.rssi < STA_WEAK_RSSI) backoffMs *= 2;
+      if (backoffMs > STA_BACKOFF_MAX_MS) backoffMs = STA_BACKOFF_MAX_MS;
+      nextAttemptTimeMs = now + backoffMs;
+      if (attempts % STA_RECONNECT_ATTEMPTS == 0) nextStation();
+    }
+
+    if ((long)(now - nextAttemptTimeMs) < 0) return;
+
+    connectStation(bssidValid && attempts == 0);
+  }
+
+  unsigned long WifiManager::getDowntime() {
+    return stats.downtimeMs + (reconnecting ? millis() - disconnectTimeMs : 0);
+  }
+
+  void WifiManager::connectStation(bool fast) {
+    VF("MSG: WiFi, attempting reconnect to station "); V(stationNumber); if (fast) { VLF(" (cached access point)"); } else { VL(""); }
+    WiFi.disconnect();
+    if (!sta->dhcpEnabled) WiFi.config(IPAddress(sta->ip), IPAddress(sta->gw), IPAddress(sta->sn));
+    if (fast) WiFi.begin(sta->ssid, sta->pwd, channel, bssid); else WiFi.begin(sta->ssid, sta->pwd);
+    attempting = true;
+    attemptTimeMs = millis();
+  }
+
+  void WifiManager::cacheAccessPoint() {
+    uint8_t *ap = WiFi.BSSID();
+    if (ap == NULL) { bssidValid = false; return; }
+    memcpy(bssid, ap, sizeof(bssid));
+    channel = WiFi.channel();
+    bssidValid = true;
+  }
+
+  void WifiManager::nextStation() {
+    int number = stationNumber;
+    for (int i = 0; i < WifiStationCount; i++) {
+      number = number % WifiStationCount + 1;
+      if (settings.station[number - 1].ssid[0] != 0) break;
+    }
+    if (number == stationNumber) return;
+
+    VF("MSG: WiFi, falling back to station "); VL(number);
+    setStation(number);
+    bssidValid = false;
   }
 #endif
 
@@ -18,6 +18,9 @@
 #ifndef COMMAND_SERVER
 #define COMMAND_SERVER OFF
 #endif
+#ifndef COMMAND_SERVER_CLIENTS
+#define COMMAND_SERVER_CLIENTS 3          // concurrent client sessions on each command server port
+#endif
 
 // optional Arduino Serial class work-alike IP channels 9996 to 9999 as a server (listens to clients)
 // OFF or STANDARD (port 9999), or PERSISTENT (ports 9996 to 9998), or BOTH
@@ -25,6 +28,22 @@
 #define SERIAL_SERVER OFF                 // SERIAL_SIP, SERIAL_PIP1, etc.
 #endif
 
+// optional WebSocket command channel (one client, LX200 commands and the status stream) for browser apps
+#ifndef SERIAL_WEBSOCKET
+#define SERIAL_WEBSOCKET OFF              // ON for SERIAL_WS
+#endif
+#ifndef SERIAL_WEBSOCKET_PORT
+#define SERIAL_WEBSOCKET_PORT 81          // WebSocket port
+#endif
+
+// optional firmware update over the web server (ESP32 only), POST /update?url=http://host/firmware.bin[&md5=hash]
+#ifndef OTA_UPDATE
+#define OTA_UPDATE OFF                    // ON to stream new firmware into the inactive app partition, switched to at park
+#endif
+#ifndef OTA_UPDATE_CHUNK
+#define OTA_UPDATE_CHUNK 1024             // bytes written to flash per pass of the update task
+#endif
+
 // optional Arduino Serial class work-alike IP channel (ports 9996 to 9998) as a client (connects to a server)
 #ifndef SERIAL_CLIENT
 #define SERIAL_CLIENT OFF                 // ON to enable SERIAL_IP
@@ -83,6 +102,14 @@
 #define STA_AUTO_RECONNECT          false // normally not enabled
 #endif
 
+#ifndef STA_RECONNECT_ATTEMPTS
+#define STA_RECONNECT_ATTEMPTS          3 // failed reconnects before trying the next configured station
+#endif
+
+#ifndef STA_WEAK_RSSI
+#define STA_WEAK_RSSI                 -80 // in dBm, reconnects back off twice as long after losing a link this weak
+#endif
+
 #ifndef STA_HOST_NAME
 #define STA_HOST_NAME               "Home" // Wifi Host Name to connect to
 #endif
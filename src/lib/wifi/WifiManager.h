@@ -57,12 +57,33 @@ typedef struct WifiSettings {
 
 } WifiSettings;
 
+typedef struct WifiStationStats {
+  unsigned long connects;       // connections made, including the first
+  unsigned long disconnects;    // links lost
+  unsigned long failedAttempts; // reconnect attempts that timed out
+  unsigned long downtimeMs;     // total time without a link, not counting the current outage
+  int rssi;                     // signal strength of the link (or the last link) in dBm
+} WifiStationStats;
+
 class WifiManager {
   public:
+    // start the soft AP and/or station without waiting for the station to associate
+    void begin();
+
+    // start (if not already started) and wait for the station to associate, true if WiFi is up
     bool init();
     void disconnect();
     #if STA_AUTO_RECONNECT == true
+      // watch the station link and bring it back when it drops
       void reconnectStation();
+
+      // time without a link, including the current outage (in ms)
+      unsigned long getDowntime();
+
+      WifiStationStats stats = {0, 0, 0, 0, 0};
+
+      // set from the WiFi event callbacks
+      volatile bool linkUp = false;
     #endif
     void setStation(int number);
     void writeSettings();
@@ -104,7 +125,39 @@ class WifiManager {
     int stationNumber = 1;
 
   private:
-    
+    // bring up the soft AP and/or station as set
+    void connect();
+
+    bool started = false;
+    unsigned long connectStartMs = 0;
+
+    #if STA_AUTO_RECONNECT == true
+      // start a connection attempt, to the cached access point if fast is true
+      void connectStation(bool fast);
+
+      // remember the access point of the link so a reconnect can skip the scan
+      void cacheAccessPoint();
+
+      // move on to the next station that has an SSID
+      void nextStation();
+
+      bool reconnecting = false;
+      bool attempting = false;
+      uint8_t attempts = 0;
+      unsigned long disconnectTimeMs = 0;
+      unsigned long attemptTimeMs = 0;
+      unsigned long nextAttemptTimeMs = 0;
+      uint8_t reconnectCounter = 0;
+
+      bool bssidValid = false;
+      uint8_t bssid[6];
+      int32_t channel = 0;
+
+      #if defined(ESP8266)
+        WiFiEventHandler gotIpHandler;
+        WiFiEventHandler disconnectedHandler;
+      #endif
+    #endif
 };
 
 extern WifiManager wifiManager;
@@ -10,6 +10,7 @@
     this->clientTimeoutMs = clientTimeoutMs;
     this->persist = persist;
     this->port = port;
+    for (int i = 0; i < COMMAND_SERVER_CLIENTS; i++) { session[i].rxPos = 0; session[i].rx[0] = 0; session[i].txCount = 0; }
   }
 
   void CmdServer::begin() {
@@ -19,53 +20,86 @@
   }
 
   void CmdServer::handleClient() {
-    // disconnect client
-    if (cmdSvrClient && !cmdSvrClient.connected()) cmdSvrClient.stop();
-    if (cmdSvrClient && (long)(clientEndTimeMs - millis()) < 0) cmdSvrClient.stop();
+    // disconnect clients
+    for (int i = 0; i < COMMAND_SERVER_CLIENTS; i++) {
+      if (session[i].client && !session[i].client.connected()) session[i].client.stop();
+      if (session[i].client && (long)(session[i].endTimeMs - millis()) < 0) session[i].client.stop();
+    }
 
     // new client
-    if (!cmdSvrClient && cmdSvr->hasClient()) {
-      // find free/disconnected spot
-      cmdSvrClient = cmdSvr->available();
-      clientEndTimeMs = millis() + (unsigned long)clientTimeoutMs;
+    accept();
+
+    // check clients for data, if found get the command, pass to OnStep and pickup the response, then queue the response for the client
+    for (int i = 0; i < COMMAND_SERVER_CLIENTS; i++) {
+      if (!session[i].client) continue;
+      handleSession(&session[i]);
+      send(&session[i]);
     }
+  }
 
-    // check clients for data, if found get the command, pass to OnStep and pickup the response, then return the response to client
-    while (cmdSvrClient && cmdSvrClient.connected() && cmdSvrClient.available() > 0) {
-      static char cmdBuffer[40] = "";
-      static int cmdBufferPos = 0;
+  void CmdServer::accept() {
+    if (!cmdSvr->hasClient()) return;
+    for (int i = 0; i < COMMAND_SERVER_CLIENTS; i++) {
+      if (!session[i].client) {
+        session[i].client = cmdSvr->available();
+        session[i].endTimeMs = millis() + (unsigned long)clientTimeoutMs;
+        session[i].rxPos = 0; session[i].rx[0] = 0; session[i].txCount = 0;
+        return;
+      }
+    }
+    // no free session, turn the client away
+    cmdSvr->available().stop();
+  }
 
-      // still active? push back disconnect
-      if (persist) clientEndTimeMs = millis() + (unsigned long)clientTimeoutMs;
+  void CmdServer::handleSession(CmdSession *s) {
+    uint8_t data[CMDSERVER_RX_SIZE];
+    int count = s->client.available();
+    if (count <= 0) return;
+    if (count > CMDSERVER_RX_SIZE) count = CMDSERVER_RX_SIZE;
+    count = s->client.read(data, count);
+    if (count <= 0) return;
+
+    // still active? push back disconnect
+    if (persist) s->endTimeMs = millis() + (unsigned long)clientTimeoutMs;
+
+    for (int j = 0; j < count; j++) {
+      char b = data[j];
 
-      // get the data
-      byte b = cmdSvrClient.read();
-      
       // insert into the command buffer
-      cmdBuffer[cmdBufferPos] = b;
-      cmdBufferPos++;
-      if (cmdBufferPos > 39) cmdBufferPos = 39;
-      cmdBuffer[cmdBufferPos] = 0;
+      s->rx[s->rxPos] = b;
+      s->rxPos++;
+      if (s->rxPos > CMDSERVER_RX_SIZE - 1) s->rxPos = CMDSERVER_RX_SIZE - 1;
+      s->rx[s->rxPos] = 0;
 
       // send cmd and pickup the response
-      if (b == '#' || (strlen(cmdBuffer) == 1 && b == (char)6)) {
+      if (b == '#' || (s->rxPos == 1 && b == (char)6)) {
         char result[40] = "";
 
-        onStep.processCommand(cmdBuffer, result, cmdTimeout); 
+        onStep.processCommand(s->rx, result, cmdTimeout);
 
-        // pickup response
-        if (strlen(result) > 0) {
-          if (cmdSvrClient && cmdSvrClient.connected()) {
-            cmdSvrClient.print(result);
-            delay(2);
-          }
+        // queue the response, if the queue is full send what's there first
+        int length = strlen(result);
+        if (s->txCount + length > CMDSERVER_TX_SIZE) {
+          s->client.write((const uint8_t*)s->tx, s->txCount);
+          s->txCount = 0;
         }
+        memcpy(&s->tx[s->txCount], result, length);
+        s->txCount += length;
 
         // reset command buffer
-        cmdBuffer[0] = 0;
-        cmdBufferPos = 0;
-      } else tasks.yield();
+        s->rx[0] = 0;
+        s->rxPos = 0;
+      }
     }
   }
 
+  void CmdServer::send(CmdSession *s) {
+    if (s->txCount == 0) return;
+    if (!s->client.connected()) { s->txCount = 0; return; }
+    int sent = s->client.write((const uint8_t*)s->tx, s->txCount);
+    if (sent <= 0) return;
+    if (sent < s->txCount) memmove(s->tx, &s->tx[sent], s->txCount - sent);
+    s->txCount -= sent;
+  }
+
 #endif
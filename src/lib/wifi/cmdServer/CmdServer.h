@@ -6,6 +6,18 @@
 
 #if OPERATIONAL_MODE == WIFI && COMMAND_SERVER != OFF
 
+  #define CMDSERVER_RX_SIZE 40
+  #define CMDSERVER_TX_SIZE 128
+
+  typedef struct CmdSession {
+    WiFiClient client;
+    unsigned long endTimeMs;
+    char rx[CMDSERVER_RX_SIZE];
+    int rxPos;
+    char tx[CMDSERVER_TX_SIZE];
+    int txCount;
+  } CmdSession;
+
   class CmdServer {
     public:
       CmdServer(uint32_t port, long clientTimeoutMs, bool persist = false);
@@ -13,11 +25,19 @@
       void handleClient();
 
     private:
+      // accept a new client into a free session
+      void accept();
+
+      // read and process any commands from a session's client and queue the replies
+      void handleSession(CmdSession *session);
+
+      // send as much of a session's queued replies as the client will take
+      void send(CmdSession *session);
+
       WiFiServer *cmdSvr;
-      WiFiClient cmdSvrClient;
+      CmdSession session[COMMAND_SERVER_CLIENTS];
 
       unsigned long clientTimeoutMs;
-      unsigned long clientEndTimeMs = 0;
       bool persist;
       long port;
   };
@@ -0,0 +1,144 @@
+// -----------------------------------------------------------------------------------
+// ESP32 firmware update, streams an image into the inactive app partition a piece at a time
+
+#include "OtaUpdate.h"
+
+#if OPERATIONAL_MODE == WIFI && WEB_SERVER == ON && OTA_UPDATE == ON
+
+#include "../../tasks/OnTask.h"
+
+// erase flash a sector at a time as the image is written rather than all at once up front, that
+// takes seconds and would stall everything else
+#ifndef OTA_WITH_SEQUENTIAL_WRITES
+  #define OTA_WITH_SEQUENTIAL_WRITES OTA_SIZE_UNKNOWN
+#endif
+
+void otaRequestWrapper() { otaUpdate.request(); }
+void otaPollWrapper() { otaUpdate.poll(); }
+
+void OtaUpdate::init(OtaCallback hold, OtaCallback ready) {
+  this->hold = hold;
+  this->ready = ready;
+
+  www.on("/update", otaRequestWrapper);
+
+  VF("MSG: OTA, start update task (rate 10ms priority 7)... ");
+  if (tasks.add(10, 0, true, 7, otaPollWrapper, "OtaUpd")) { VLF("success"); } else { VLF("FAILED!"); }
+}
+
+void OtaUpdate::request() {
+  if (www.method() == HTTP_POST && www.hasArg("url")) {
+    if (state == OS_WRITE || state == OS_READY) { www.send(409, "text/plain", "update already in progress"); return; }
+    if (!start(www.arg("url").c_str(), www.hasArg("md5") ? www.arg("md5").c_str() : "")) {
+      char reply[64];
+      sprintf(reply, "failed, %s", failReason);
+      www.send(400, "text/plain", reply);
+      return;
+    }
+  }
+
+  char reply[64];
+  switch (state) {
+    case OS_IDLE:   strcpy(reply, "idle"); break;
+    case OS_WRITE:  sprintf(reply, "writing %ld of %ld bytes%s", (long)written, (long)length, (hold != NULL && hold()) ? ", held" : ""); break;
+    case OS_READY:  strcpy(reply, "verified, restarting at next park"); break;
+    case OS_FAILED: sprintf(reply, "failed, %s", failReason); break;
+  }
+  www.send(200, "text/plain", reply);
+}
+
+bool OtaUpdate::start(const char *url, const char *md5) {
+  if (strlen(md5) != 0 && strlen(md5) != 32) { fail("bad md5"); return false; }
+
+  partition = esp_ota_get_next_update_partition(NULL);
+  if (partition == NULL) { fail("no OTA partition"); return false; }
+
+  VF("MSG: OTA, downloading "); VL(url);
+  http = new HTTPClient();
+  if (!http->begin(url)) { fail("bad url"); return false; }
+  if (http->GET() != HTTP_CODE_OK) { fail("download refused"); return false; }
+
+  length = http->getSize();
+  if (length <= 0 || (uint32_t)length > partition->size) { fail("bad image size"); return false; }
+
+  if (esp_ota_begin(partition, OTA_WITH_SEQUENTIAL_WRITES, &handle) != ESP_OK) { fail("flash begin failed"); return false; }
+  handleOpen = true;
+
+  this->md5.begin();
+  strcpy(md5Expected, md5);
+  written = 0;
+  lastDataMs = millis();
+  state = OS_WRITE;
+  return true;
+}
+
+void OtaUpdate::poll() {
+  if (state == OS_READY) {
+    if (ready != NULL && !ready()) return;
+
+    if (esp_ota_set_boot_partition(partition) != ESP_OK) { fail("set boot partition failed"); return; }
+    VLF("MSG: OTA, restarting into the new image");
+    nv.wait();
+    tasks.yield(1000);
+    HAL_RESET();
+    return;
+  }
+
+  if (state != OS_WRITE) return;
+
+  // while held nothing is read so TCP flow control pauses the sender
+  if (hold != NULL && hold()) { lastDataMs = millis(); return; }
+
+  WiFiClient *stream = http->getStreamPtr();
+  int32_t count = stream->available();
+  if (count <= 0) {
+    if (!stream->connected()) fail("connection lost"); else
+    if ((long)(millis() - lastDataMs) > OTA_UPDATE_TIMEOUT) fail("download timed out");
+    return;
+  }
+  if (count > OTA_UPDATE_CHUNK) count = OTA_UPDATE_CHUNK;
+  if (count > length - written) count = length - written;
+
+  count = stream->read(buffer, count);
+  if (count <= 0) return;
+  if (esp_ota_write(handle, buffer, count) != ESP_OK) { fail("flash write failed"); return; }
+  md5.add(buffer, count);
+  written += count;
+  lastDataMs = millis();
+
+  if (written >= length) finish();
+}
+
+void OtaUpdate::finish() {
+  // esp_ota_end() checks the image header and its appended SHA-256
+  handleOpen = false;
+  if (esp_ota_end(handle) != ESP_OK) { fail("image verify failed"); return; }
+
+  if (md5Expected[0] != 0) {
+    md5.calculate();
+    if (!md5.toString().equalsIgnoreCase(md5Expected)) { fail("md5 mismatch"); return; }
+  }
+
+  close();
+  state = OS_READY;
+  VLF("MSG: OTA, image verified, restarting at next park");
+}
+
+void OtaUpdate::fail(const char *reason) {
+  DF("ERR: OTA, update failed "); DL(reason);
+  if (handleOpen) { esp_ota_abort(handle); handleOpen = false; }
+  close();
+  failReason = reason;
+  state = OS_FAILED;
+}
+
+void OtaUpdate::close() {
+  if (http == NULL) return;
+  http->end();
+  delete http;
+  http = NULL;
+}
+
+OtaUpdate otaUpdate;
+
+#endif
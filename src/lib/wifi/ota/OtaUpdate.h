@@ -0,0 +1,70 @@
+// -----------------------------------------------------------------------------------
+// ESP32 firmware update, streams an image into the inactive app partition a piece at a time
+#pragma once
+
+#include "../../../Common.h"
+#include "../webServer/WebServer.h"
+
+#if OPERATIONAL_MODE == WIFI && WEB_SERVER == ON && OTA_UPDATE == ON
+
+#ifndef ESP32
+  #error "Configuration (Config.h): Setting OTA_UPDATE ON is only supported on the ESP32"
+#endif
+
+#include <HTTPClient.h>
+#include <MD5Builder.h>
+#include <esp_ota_ops.h>
+
+// give up if the download stops sending data for this long (in ms) while not held off
+#ifndef OTA_UPDATE_TIMEOUT
+  #define OTA_UPDATE_TIMEOUT 15000
+#endif
+
+enum OtaState: uint8_t {OS_IDLE, OS_WRITE, OS_READY, OS_FAILED};
+
+// returns true if the update should wait (hold) or may restart into the new image (ready)
+typedef bool (*OtaCallback)();
+
+class OtaUpdate {
+  public:
+    // serve /update on the web server and start the update task, hold is checked before each chunk is
+    // written and ready before restarting into the new image
+    void init(OtaCallback hold, OtaCallback ready);
+
+    // answer a request to /update, a POST with a url (and optionally the image md5) starts the download
+    // otherwise it reports the update status
+    void request();
+
+    // write the next chunk of the image, once verified restart into it when ready
+    void poll();
+
+  private:
+    bool start(const char *url, const char *md5);
+    void finish();
+    void fail(const char *reason);
+    void close();
+
+    OtaCallback hold = NULL;
+    OtaCallback ready = NULL;
+
+    OtaState state = OS_IDLE;
+    const char *failReason = "";
+
+    HTTPClient *http = NULL;
+    const esp_partition_t *partition = NULL;
+    esp_ota_handle_t handle = 0;
+    bool handleOpen = false;
+
+    MD5Builder md5;
+    char md5Expected[33] = "";
+
+    int32_t length = 0;
+    int32_t written = 0;
+    unsigned long lastDataMs = 0;
+
+    uint8_t buffer[OTA_UPDATE_CHUNK];
+};
+
+extern OtaUpdate otaUpdate;
+
+#endif
@@ -0,0 +1,413 @@
+// -----------------------------------------------------------------------------------
+// ASCOM Alpaca device API (Telescope, Focuser, Rotator) with UDP discovery
+
+#include "Alpaca.h"
+
+#if OPERATIONAL_MODE != OFF && ALPACA == ON
+
+#include "../../lib/tasks/OnTask.h"
+#include "../commands/ProcessCmds.h"
+#include "../../telescope/focuser/Focuser.h"
+
+void alpacaWrapper() { alpaca.poll(); }
+
+void Alpaca::init() {
+  #if OPERATIONAL_MODE == WIFI
+    if (!wifiManager.init()) { DLF("WRN: Alpaca, no WiFi skipping"); return; }
+    server = new WiFiServer(ALPACA_PORT);
+    server->begin();
+    server->setNoDelay(true);
+  #else
+    if (!ethernetManager.init()) { DLF("WRN: Alpaca, no Ethernet skipping"); return; }
+    server = new EthernetServer(ALPACA_PORT);
+    server->begin();
+  #endif
+  udp.begin(ALPACA_DISCOVERY_PORT);
+  VF("MSG: Alpaca, started device API on port "); V(ALPACA_PORT); VF(" discovery on port "); VL(ALPACA_DISCOVERY_PORT);
+
+  for (int i = 0; i < ALPACA_CLIENTS; i++) sessions[i].length = 0;
+
+  VF("MSG: Alpaca, start server task (rate 5ms priority 5)... ");
+  if (tasks.add(5, 0, true, 5, alpacaWrapper, "Alpaca")) { VLF("success"); active = true; } else { VLF("FAILED!"); }
+}
+
+void Alpaca::poll() {
+  if (!active) return;
+
+  discovery();
+  accept();
+  for (int i = 0; i < ALPACA_CLIENTS; i++) if (sessions[i].client) session(&sessions[i]);
+}
+
+void Alpaca::discovery() {
+  int length = udp.parsePacket();
+  if (length <= 0) return;
+
+  char packet[32];
+  length = udp.read(packet, sizeof(packet) - 1);
+  if (length < 0) return;
+  packet[length] = 0;
+  if (strncmp(packet, "alpacadiscovery1", 16) != 0) return;
+
+  char reply[32];
+  Formatter(reply, sizeof(reply)).str("{\"AlpacaPort\":").uint(ALPACA_PORT).chr('}');
+  udp.beginPacket(udp.remoteIP(), udp.remotePort());
+  udp.write((const uint8_t*)reply, strlen(reply));
+  udp.endPacket();
+}
+
+void Alpaca::accept() {
+  #if OPERATIONAL_MODE == WIFI
+    if (!server->hasClient()) return;
+  #endif
+
+  for (int i = 0; i < ALPACA_CLIENTS; i++) {
+    if (!sessions[i].client) {
+      sessions[i].client = server->available();
+      if (!sessions[i].client) return;
+      sessions[i].endTimeMs = millis() + ALPACA_CLIENT_TIMEOUT;
+      sessions[i].length = 0;
+      return;
+    }
+  }
+
+  // no free session, turn the client away
+  #if OPERATIONAL_MODE == WIFI
+    WiFiClient client = server->available();
+  #else
+    EthernetClient client = server->available();
+  #endif
+  if (client) client.stop();
+}
+
+void Alpaca::session(AlpacaSession *s) {
+  if (!s->client.connected() || (long)(millis() - s->endTimeMs) > 0) { s->client.stop(); s->length = 0; return; }
+
+  int waiting = s->client.available();
+  if (waiting > 0) {
+    int room = ALPACA_REQUEST_SIZE - 1 - s->length;
+    if (waiting > room) waiting = room;
+    int count = s->client.read((uint8_t*)&s->request[s->length], waiting);
+    if (count > 0) s->length += count;
+    s->request[s->length] = 0;
+    s->endTimeMs = millis() + ALPACA_CLIENT_TIMEOUT;
+  }
+
+  // wait for the whole header and then any body
+  char *body = strstr(s->request, "\r\n\r\n");
+  if (body == NULL) {
+    if (s->length >= ALPACA_REQUEST_SIZE - 1) { jsonValue[0] = 0; respond(s, 413, false); s->client.stop(); s->length = 0; }
+    return;
+  }
+  body += 4;
+
+  long contentLength = 0;
+  for (char *line = strstr(s->request, "\r\n"); line != NULL && line + 2 < body; line = strstr(line + 2, "\r\n")) {
+    if (strncasecmp(line + 2, "Content-Length:", 15) == 0) contentLength = atol(line + 17);
+  }
+  if (contentLength < 0 || body + contentLength > &s->request[ALPACA_REQUEST_SIZE - 1]) {
+    jsonValue[0] = 0; respond(s, 413, false); s->client.stop(); s->length = 0; return;
+  }
+  if (body + contentLength > &s->request[s->length]) return;
+
+  // the request is complete, answer then keep anything that followed
+  char *next = body + contentLength;
+  char nextChar = *next;
+  *next = 0;
+  bool keepAlive = request(s, body);
+  *next = nextChar;
+
+  if (!keepAlive) { s->client.stop(); s->length = 0; return; }
+  s->length = &s->request[s->length] - next;
+  memmove(s->request, next, s->length);
+  s->request[s->length] = 0;
+}
+
+bool Alpaca::request(AlpacaSession *s, char *body) {
+  // request line, "GET /api/v1/telescope/0/rightascension?ClientID=1 HTTP/1.1"
+  char *path;
+  if (strncmp(s->request, "GET ", 4) == 0) { isPut = false; path = &s->request[4]; } else
+  if (strncmp(s->request, "PUT ", 4) == 0) { isPut = true; path = &s->request[4]; } else {
+    jsonValue[0] = 0; respond(s, 405, false); return false;
+  }
+
+  char *lineEnd = strstr(s->request, "\r\n");
+  *lineEnd = 0;
+  bool keepAlive = strstr(path, " HTTP/1.1") != NULL;
+  char *headers = lineEnd + 2;
+  for (char *line = headers; line < body - 2; line = strstr(line, "\r\n") + 2) {
+    if (strncasecmp(line, "Connection:", 11) == 0) {
+      char *v = line + 11; while (*v == ' ') v++;
+      if (strncasecmp(v, "close", 5) == 0) keepAlive = false; else
+      if (strncasecmp(v, "keep-alive", 10) == 0) keepAlive = true;
+    }
+  }
+
+  char *end = strchr(path, ' '); if (end != NULL) *end = 0;
+  char *query = strchr(path, '?');
+  if (query != NULL) *query++ = 0; else query = (char*)"";
+
+  // the arguments are the query string and form body together
+  Formatter(args, sizeof(args)).str(query).chr('&').str(body);
+
+  // path is case insensitive
+  for (char *c = path; *c; c++) *c = tolower(*c);
+
+  jsonValue[0] = 0;
+  errorNumber = AE_NONE;
+  errorMessage[0] = 0;
+  long id = 0;
+  clientTransactionId = argLong("ClientTransactionID", &id) && id > 0 ? id : 0;
+  serverTransactionId++;
+
+  bool handled = false;
+  if (strncmp(path, "/management/", 12) == 0) handled = management(&path[12]); else
+  if (strncmp(path, "/api/v1/", 8) == 0) {
+    char *type = &path[8];
+    char *number = strchr(type, '/');
+    if (number != NULL) {
+      *number++ = 0;
+      char *member = strchr(number, '/');
+      if (member != NULL && isdigit(*number)) { *member++ = 0; handled = device(type, atoi(number), member); }
+    }
+  }
+
+  if (!handled) { jsonValue[0] = 0; respond(s, 400, keepAlive); return keepAlive; }
+  respond(s, 200, keepAlive);
+  return keepAlive;
+}
+
+bool Alpaca::arg(const char *name, char *value, int size) {
+  size_t nameLength = strlen(name);
+  for (char *a = args; *a; ) {
+    char *next = strchr(a, '&');
+    if (next == NULL) next = a + strlen(a);
+    if (strncasecmp(a, name, nameLength) == 0 && a[nameLength] == '=') {
+      // url decode the value
+      char *v = &a[nameLength + 1];
+      int i = 0;
+      while (v < next && i < size - 1) {
+        if (*v == '+') value[i++] = ' '; else
+        if (*v == '%' && v + 2 < next && isxdigit(v[1]) && isxdigit(v[2])) {
+          char hex[3] = {v[1], v[2], 0};
+          value[i++] = strtol(hex, NULL, 16);
+          v += 2;
+        } else value[i++] = *v;
+        v++;
+      }
+      value[i] = 0;
+      return true;
+    }
+    if (*next == 0) break;
+    a = next + 1;
+  }
+  return false;
+}
+
+bool Alpaca::argDouble(const char *name, double *value) {
+  char s[24];
+  if (!arg(name, s, sizeof(s)) || s[0] == 0) return false;
+  char *end;
+  *value = strtod(s, &end);
+  return *end == 0;
+}
+
+bool Alpaca::argLong(const char *name, long *value) {
+  char s[16];
+  if (!arg(name, s, sizeof(s)) || s[0] == 0) return false;
+  char *end;
+  *value = strtol(s, &end, 10);
+  return *end == 0;
+}
+
+bool Alpaca::argBool(const char *name, bool *value) {
+  char s[8];
+  if (!arg(name, s, sizeof(s))) return false;
+  if (strcasecmp(s, "true") == 0) { *value = true; return true; }
+  if (strcasecmp(s, "false") == 0) { *value = false; return true; }
+  return false;
+}
+
+bool Alpaca::management(const char *path) {
+  if (isPut) return false;
+
+  if (strcmp(path, "apiversions") == 0) { value().str("[1]"); return true; }
+
+  if (strcmp(path, "v1/description") == 0) {
+    char version[20] = "";
+    commandLocal(version, "GVN");
+    Formatter f = value();
+    f.str("{\"ServerName\":\"OnStepX\",\"Manufacturer\":\"OnStep\",\"ManufacturerVersion\":\"").str(version);
+    f.str("\",\"Location\":\"\"}");
+    return true;
+  }
+
+  if (strcmp(path, "v1/configureddevices") == 0) {
+    Formatter f = value();
+    f.chr('[');
+    bool first = true;
+    #ifdef MOUNT_PRESENT
+      f.str("{\"DeviceName\":\"OnStepX Telescope\",\"DeviceType\":\"Telescope\",\"DeviceNumber\":0,\"UniqueID\":\"OnStepX-Telescope-0\"}");
+      first = false;
+    #endif
+    #ifdef FOCUSER_PRESENT
+      for (int i = 0; i < FOCUSER_MAX; i++) {
+        float microns;
+        if (!focuser.getPosition(i, &microns)) continue;
+        if (!first) f.chr(',');
+        f.str("{\"DeviceName\":\"OnStepX Focuser ").uint(i + 1).str("\",\"DeviceType\":\"Focuser\",\"DeviceNumber\":").uint(i);
+        f.str(",\"UniqueID\":\"OnStepX-Focuser-").uint(i).str("\"}");
+        first = false;
+      }
+    #endif
+    #ifdef ROTATOR_PRESENT
+      if (!first) f.chr(',');
+      f.str("{\"DeviceName\":\"OnStepX Rotator\",\"DeviceType\":\"Rotator\",\"DeviceNumber\":0,\"UniqueID\":\"OnStepX-Rotator-0\"}");
+    #endif
+    UNUSED(first);
+    f.chr(']');
+    return true;
+  }
+
+  return false;
+}
+
+bool Alpaca::device(const char *type, int number, const char *member) {
+  bool present = false;
+  #ifdef MOUNT_PRESENT
+    if (strcmp(type, "telescope") == 0 && number == 0) present = true;
+  #endif
+  #ifdef FOCUSER_PRESENT
+    float microns;
+    if (strcmp(type, "focuser") == 0 && focuser.getPosition(number, &microns)) present = true;
+  #endif
+  #ifdef ROTATOR_PRESENT
+    if (strcmp(type, "rotator") == 0 && number == 0) present = true;
+  #endif
+  if (!present) return false;
+
+  if (common(type, number, member)) return true;
+
+  bool handled = false;
+  #ifdef MOUNT_PRESENT
+    if (type[0] == 't') handled = telescopeMember(member);
+  #endif
+  #ifdef FOCUSER_PRESENT
+    if (type[0] == 'f') handled = focuserMember(number, member);
+  #endif
+  #ifdef ROTATOR_PRESENT
+    if (type[0] == 'r') handled = rotatorMember(member);
+  #endif
+
+  if (!handled) error(AE_NOT_IMPLEMENTED, "not implemented");
+  return true;
+}
+
+bool Alpaca::common(const char *type, int number, const char *member) {
+  if (!isPut) {
+    if (strcmp(member, "connected") == 0) valueBool(connected); else
+    if (strcmp(member, "description") == 0 || strcmp(member, "name") == 0) {
+      Formatter f = value();
+      f.str("\"OnStepX ").chr(toupper(type[0])).str(&type[1]);
+      if (type[0] == 'f') f.chr(' ').uint(number + 1);
+      f.chr('"');
+    } else
+    if (strcmp(member, "driverinfo") == 0) valueString("OnStepX native Alpaca device API"); else
+    if (strcmp(member, "driverversion") == 0) {
+      char version[20] = "";
+      commandLocal(version, "GVN");
+      valueString(version);
+    } else
+    if (strcmp(member, "interfaceversion") == 0) valueLong(3); else
+    if (strcmp(member, "supportedactions") == 0) value().str("[]"); else return false;
+    return true;
+  }
+
+  if (strcmp(member, "connected") == 0) {
+    if (!argBool("Connected", &connected)) error(AE_INVALID_VALUE, "Connected missing or invalid");
+    return true;
+  }
+  if (strcmp(member, "action") == 0) { error(AE_ACTION_NOT_IMPLEMENTED, "no actions"); return true; }
+
+  // the raw commands are passed straight to the command processor, so any OnStep command is available
+  if (strcmp(member, "commandblind") == 0 || strcmp(member, "commandbool") == 0 || strcmp(member, "commandstring") == 0) {
+    char command[48], reply[80];
+    if (!arg("Command", command, sizeof(command)) || command[0] == 0) { error(AE_INVALID_VALUE, "Command missing"); return true; }
+    commandLocal(reply, command);
+    if (strcmp(member, "commandbool") == 0) valueBool(strcmp(reply, "1") == 0); else
+    if (strcmp(member, "commandstring") == 0) valueString(reply);
+    return true;
+  }
+
+  return false;
+}
+
+void Alpaca::valueBool(bool b) { value().str(b ? "true" : "false"); }
+
+void Alpaca::valueDouble(double d, uint8_t decimals) { value().fixed(d, decimals); }
+
+void Alpaca::valueLong(long n) { value().sint(n); }
+
+void Alpaca::valueString(const char *s) {
+  Formatter f = value();
+  f.chr('"');
+  for (; *s; s++) {
+    if (*s == '"' || *s == '\\') f.chr('\\').chr(*s); else
+    if ((uint8_t)*s < 0x20) f.str("\\u00").hex((uint8_t)*s); else f.chr(*s);
+  }
+  f.chr('"');
+}
+
+void Alpaca::error(int number, const char *message) {
+  errorNumber = number;
+  strncpy(errorMessage, message, sizeof(errorMessage) - 1);
+  errorMessage[sizeof(errorMessage) - 1] = 0;
+}
+
+void Alpaca::error(CommandError e) {
+  char message[24];
+  Formatter(message, sizeof(message)).str("OnStep error ").uint(e);
+  switch (e) {
+    case CE_PARAM_RANGE: case CE_PARAM_FORM: error(AE_INVALID_VALUE, message); break;
+    case CE_PARKED: case CE_SLEW_ERR_IN_PARK: error(AE_INVALID_WHILE_PARKED, message); break;
+    case CE_CMD_UNKNOWN: error(AE_NOT_IMPLEMENTED, message); break;
+    default: error(AE_INVALID_OPERATION, message); break;
+  }
+}
+
+bool Alpaca::lx200(const char *command, char *reply) {
+  char s[80];
+  if (reply == NULL) reply = s;
+  CommandError e = commandLocal(reply, command);
+  if (e == CE_NONE || e == CE_1) return true;
+  error(e);
+  return false;
+}
+
+void Alpaca::respond(AlpacaSession *s, int status, bool keepAlive) {
+  char body[ALPACA_VALUE_SIZE + 160];
+  const char *contentType = "application/json";
+  if (status == 200) {
+    Formatter f(body, sizeof(body));
+    f.chr('{');
+    if (jsonValue[0] != 0) f.str("\"Value\":").str(jsonValue).chr(',');
+    f.str("\"ClientTransactionID\":").uint(clientTransactionId).str(",\"ServerTransactionID\":").uint(serverTransactionId);
+    f.str(",\"ErrorNumber\":").uint(errorNumber).str(",\"ErrorMessage\":\"").str(errorMessage).str("\"}");
+  } else {
+    contentType = "text/plain";
+    Formatter(body, sizeof(body)).str(status == 405 ? "Method not allowed" : status == 413 ? "Request too large" : "Invalid request");
+  }
+
+  char header[160];
+  Formatter f(header, sizeof(header));
+  f.str("HTTP/1.1 ").uint(status).str(status == 200 ? " OK" : status == 405 ? " Method Not Allowed" : status == 413 ? " Payload Too Large" : " Bad Request");
+  f.str("\r\nContent-Type: ").str(contentType).str("\r\nContent-Length: ").uint(strlen(body));
+  f.str(keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+
+  s->client.write((const uint8_t*)header, strlen(header));
+  s->client.write((const uint8_t*)body, strlen(body));
+}
+
+Alpaca alpaca;
+
+#endif
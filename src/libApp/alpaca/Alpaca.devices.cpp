@@ -0,0 +1,209 @@
+// -----------------------------------------------------------------------------------
+// ASCOM Alpaca device API, the Telescope, Focuser, and Rotator members
+
+#include "Alpaca.h"
+
+#if OPERATIONAL_MODE != OFF && ALPACA == ON
+
+#include "../commands/ProcessCmds.h"
+#include "../../telescope/mount/Mount.h"
+#include "../../telescope/mount/coordinates/Transform.h"
+#include "../../telescope/mount/goto/Goto.h"
+#include "../../telescope/mount/guide/Guide.h"
+#include "../../telescope/mount/park/Park.h"
+#include "../../telescope/mount/site/Site.h"
+#include "../../telescope/focuser/Focuser.h"
+#include "../../telescope/rotator/Rotator.h"
+
+#define GET(name) (!isPut && strcmp(member, name) == 0)
+#define PUT(name) (isPut && strcmp(member, name) == 0)
+
+#ifdef MOUNT_PRESENT
+  bool Alpaca::telescopeMember(const char *member) {
+    // capabilities
+    if (GET("canfindhome") || GET("canpark") || GET("canpulseguide") || GET("cansetpark") || GET("cansettracking") ||
+        GET("canslew") || GET("canslewasync") || GET("cansync") || GET("canunpark")) { valueBool(true); return true; }
+    if (GET("cansetdeclinationrate") || GET("cansetguiderates") || GET("cansetpierside") || GET("cansetrightascensionrate") ||
+        GET("canslewaltaz") || GET("canslewaltazasync") || GET("cansyncaltaz") || GET("canmoveaxis")) { valueBool(false); return true; }
+
+    // position and state
+    if (GET("rightascension") || GET("declination") || GET("altitude") || GET("azimuth") || GET("sideofpier")) {
+      Coordinate current = mount.getMountPosition(CR_MOUNT_ALL);
+      Coordinate position = transform.mountToNative(&current, true);
+      if (member[0] == 'r') valueDouble(radToHrs(position.r), 7); else
+      if (member[0] == 'd') valueDouble(radToDeg(position.d), 6); else
+      if (member[1] == 'l') valueDouble(radToDeg(position.a), 6); else
+      if (member[1] == 'z') valueDouble(NormalizeAzimuth(radToDeg(position.z)), 6); else
+      valueLong(current.pierSide == PIER_SIDE_EAST ? 0 : current.pierSide == PIER_SIDE_WEST ? 1 : -1);
+      return true;
+    }
+    if (GET("alignmentmode")) { valueLong(transform.mountType == ALTAZM ? 0 : transform.mountType == FORK ? 1 : 2); return true; }
+    if (GET("equatorialsystem")) { valueLong(1); return true; }
+    if (GET("athome")) { valueBool(mount.isHome()); return true; }
+    if (GET("atpark")) { valueBool(park.state == PS_PARKED); return true; }
+    if (GET("slewing")) { valueBool(goTo.state != GS_NONE || mount.isSlewing()); return true; }
+    if (GET("ispulseguiding")) { valueBool(guide.activePulseGuide()); return true; }
+    if (GET("declinationrate") || GET("rightascensionrate")) { valueDouble(0.0, 1); return true; }
+
+    // site and time
+    if (GET("siderealtime")) { valueDouble(site.getSiderealTime(), 7); return true; }
+    if (GET("sitelatitude")) { valueDouble(radToDeg(site.location.latitude), 6); return true; }
+    if (GET("sitelongitude")) { valueDouble(-radToDeg(site.location.longitude), 6); return true; }
+    if (GET("siteelevation")) { valueDouble(site.location.elevation, 1); return true; }
+    if (GET("utcdate")) {
+      GregorianDate date = calendars.julianToGregorian(site.getDateTime());
+      double seconds = date.hour*3600.0;
+      long s = (long)seconds;
+      Formatter f = value();
+      f.chr('"').uint(date.year, 4).chr('-').uint(date.month, 2).chr('-').uint(date.day, 2).chr('T');
+      f.uint(s/3600, 2).chr(':').uint((s/60) % 60, 2).chr(':').uint(s % 60, 2).chr('.').uint((long)((seconds - s)*1000.0), 3).str("Z\"");
+      return true;
+    }
+
+    // tracking
+    if (GET("tracking")) { valueBool(mount.isTracking()); return true; }
+    if (PUT("tracking")) {
+      bool state;
+      if (!argBool("Tracking", &state)) { error(AE_INVALID_VALUE, "Tracking missing or invalid"); return true; }
+      lx200(state ? "Te" : "Td");
+      return true;
+    }
+    if (GET("trackingrate")) {
+      // sidereal 0, lunar 1, solar 2, king 3
+      float rate = mount.trackingRate;
+      if (fabs(rate - hzToSidereal(57.9F)) < 0.0001) valueLong(1); else
+      if (fabs(rate - hzToSidereal(60.0F)) < 0.0001) valueLong(2); else
+      if (fabs(rate - hzToSidereal(60.136F)) < 0.0001) valueLong(3); else valueLong(0);
+      return true;
+    }
+    if (PUT("trackingrate")) {
+      long rate;
+      if (!argLong("TrackingRate", &rate) || rate < 0 || rate > 3) { error(AE_INVALID_VALUE, "TrackingRate missing or invalid"); return true; }
+      const char *commands[4] = {"TQ", "TL", "TS", "TK"};
+      lx200(commands[rate]);
+      return true;
+    }
+    if (GET("trackingrates")) { value().str("[0,1,2,3]"); return true; }
+
+    // goto and sync
+    #if GOTO_FEATURE == ON
+      if (GET("targetrightascension") || GET("targetdeclination")) {
+        Coordinate target = goTo.getGotoTarget();
+        if (member[6] == 'r') valueDouble(radToHrs(target.r), 7); else valueDouble(radToDeg(target.d), 6);
+        return true;
+      }
+      if (PUT("targetrightascension") || PUT("targetdeclination")) {
+        double v;
+        bool ra = member[6] == 'r';
+        if (!argDouble(ra ? "TargetRightAscension" : "TargetDeclination", &v) ||
+            (ra && (v < 0.0 || v >= 24.0)) || (!ra && fabs(v) > 90.0)) { error(AE_INVALID_VALUE, "target missing or invalid"); return true; }
+        Coordinate target = goTo.getGotoTarget();
+        if (ra) target.r = hrsToRad(v); else target.d = degToRad(v);
+        goTo.setGotoTarget(&target);
+        return true;
+      }
+      if (PUT("slewtocoordinatesasync") || PUT("synctocoordinates") || PUT("slewtotargetasync") || PUT("synctotarget")) {
+        if (strstr(member, "coordinates") != NULL) {
+          double ra, dec;
+          if (!argDouble("RightAscension", &ra) || !argDouble("Declination", &dec) ||
+              ra < 0.0 || ra >= 24.0 || fabs(dec) > 90.0) { error(AE_INVALID_VALUE, "RightAscension or Declination missing or invalid"); return true; }
+          Coordinate target = goTo.getGotoTarget();
+          target.r = hrsToRad(ra);
+          target.d = degToRad(dec);
+          goTo.setGotoTarget(&target);
+        }
+        CommandError e = member[1] == 'l' ? goTo.request() : goTo.requestSync();
+        if (e != CE_NONE) error(e);
+        return true;
+      }
+    #endif
+    if (PUT("abortslew")) { lx200("Q"); return true; }
+
+    // park and home
+    if (PUT("park")) { lx200("hP"); return true; }
+    if (PUT("unpark")) { lx200("hR"); return true; }
+    if (PUT("setpark")) { lx200("hQ"); return true; }
+    if (PUT("findhome")) { lx200("hC"); return true; }
+
+    // guiding, North 0, South 1, East 2, West 3
+    if (PUT("pulseguide")) {
+      long direction, duration;
+      if (!argLong("Direction", &direction) || direction < 0 || direction > 3 ||
+          !argLong("Duration", &duration) || duration < 0 || duration > 32767) { error(AE_INVALID_VALUE, "Direction or Duration missing or invalid"); return true; }
+      char command[12];
+      Formatter(command, sizeof(command)).str("Mg").chr("nsew"[direction]).uint(duration);
+      lx200(command);
+      return true;
+    }
+
+    return false;
+  }
+#endif
+
+#ifdef FOCUSER_PRESENT
+  bool Alpaca::focuserMember(int number, const char *member) {
+    // positions are in microns, so the step size is 1 micron
+    if (GET("absolute") || GET("tempcompavailable")) { valueBool(true); return true; }
+    if (GET("stepsize")) { valueDouble(1.0, 1); return true; }
+    if (GET("position")) {
+      float microns = 0.0F;
+      focuser.getPosition(number, &microns);
+      valueLong(lroundf(microns));
+      return true;
+    }
+
+    // the rest go through the numbered focuser commands, :F1[...]# to :F6[...]#
+    char command[24], reply[80];
+    Formatter f(command, sizeof(command));
+    f.chr('F').uint(number + 1);
+
+    if (GET("ismoving")) { f.chr('T'); if (lx200(command, reply)) valueBool(reply[0] == 'M'); return true; }
+    if (GET("maxstep") || GET("maxincrement")) { f.chr('M'); if (lx200(command, reply)) valueLong(atol(reply)); return true; }
+    if (GET("temperature")) { f.chr('t'); if (lx200(command, reply)) valueDouble(atof(reply), 1); return true; }
+    if (GET("tempcomp")) { f.chr('c'); if (lx200(command, reply)) valueBool(reply[0] == '1'); return true; }
+    if (PUT("tempcomp")) {
+      bool state;
+      if (!argBool("TempComp", &state)) { error(AE_INVALID_VALUE, "TempComp missing or invalid"); return true; }
+      f.chr('c').chr(state ? '1' : '0');
+      lx200(command);
+      return true;
+    }
+    if (PUT("halt")) { f.chr('Q'); lx200(command); return true; }
+    if (PUT("move")) {
+      long position;
+      if (!argLong("Position", &position)) { error(AE_INVALID_VALUE, "Position missing or invalid"); return true; }
+      f.chr('S').sint(position);
+      lx200(command);
+      return true;
+    }
+
+    return false;
+  }
+#endif
+
+#ifdef ROTATOR_PRESENT
+  bool Alpaca::rotatorMember(const char *member) {
+    if (GET("canreverse") || GET("reverse")) { valueBool(false); return true; }
+    if (GET("position") || GET("mechanicalposition")) { valueDouble(rotator.getPosition(), 4); return true; }
+    if (GET("ismoving")) { valueBool(!rotator.isSettled()); return true; }
+    if (GET("targetposition")) { valueDouble(rotatorTarget, 4); return true; }
+
+    char reply[80];
+    if (GET("stepsize")) { if (lx200("rD", reply)) valueDouble(atof(reply), 6); return true; }
+    if (PUT("halt")) { lx200("rQ"); return true; }
+    if (PUT("move") || PUT("moveabsolute") || PUT("movemechanical")) {
+      double position;
+      if (!argDouble("Position", &position)) { error(AE_INVALID_VALUE, "Position missing or invalid"); return true; }
+      if (member[4] == 0) position += rotator.getPosition();
+      rotatorTarget = position;
+      char command[24];
+      Formatter(command, sizeof(command)).str("rS").dms(position, true, true, PM_HIGH);
+      lx200(command);
+      return true;
+    }
+
+    return false;
+  }
+#endif
+
+#endif
@@ -0,0 +1,131 @@
+// -----------------------------------------------------------------------------------
+// ASCOM Alpaca device API (Telescope, Focuser, Rotator) with UDP discovery
+#pragma once
+
+#include "../../Common.h"
+
+#ifndef OPERATIONAL_MODE
+#define OPERATIONAL_MODE OFF
+#endif
+
+#if OPERATIONAL_MODE != OFF && ALPACA == ON
+
+#if OPERATIONAL_MODE == WIFI
+  #include "../../lib/wifi/WifiManager.h"
+  #include <WiFiUdp.h>
+#else
+  #include "../../lib/ethernet/EthernetManager.h"
+  #include <EthernetUdp.h>
+#endif
+
+#include "../../lib/convert/Convert.h"
+
+#define ALPACA_DISCOVERY_PORT 32227
+#define ALPACA_CLIENTS        3      // concurrent (keep-alive) client connections
+#define ALPACA_REQUEST_SIZE   512    // longest http request (header and body) accepted
+#define ALPACA_ARGS_SIZE      256    // query string and form body
+#define ALPACA_VALUE_SIZE     256    // json value of a response
+#define ALPACA_CLIENT_TIMEOUT 10000  // in ms, idle keep-alive connections are closed after this
+
+// Alpaca error numbers
+#define AE_NONE               0x000
+#define AE_NOT_IMPLEMENTED    0x400
+#define AE_INVALID_VALUE      0x401
+#define AE_VALUE_NOT_SET      0x402
+#define AE_NOT_CONNECTED      0x407
+#define AE_INVALID_WHILE_PARKED 0x408
+#define AE_INVALID_OPERATION  0x40B
+#define AE_ACTION_NOT_IMPLEMENTED 0x40C
+#define AE_DRIVER_ERROR       0x500
+
+typedef struct AlpacaSession {
+  #if OPERATIONAL_MODE == WIFI
+    WiFiClient client;
+  #else
+    EthernetClient client;
+  #endif
+  unsigned long endTimeMs;
+  char request[ALPACA_REQUEST_SIZE];
+  int length;
+} AlpacaSession;
+
+class Alpaca {
+  public:
+    // start the http and discovery servers
+    void init();
+
+    // answer discovery and any complete requests
+    void poll();
+
+  private:
+    // take a waiting client into a free session
+    void accept();
+
+    // answer a discovery broadcast
+    void discovery();
+
+    // read what's waiting for a session and answer the request once it's all here
+    void session(AlpacaSession *s);
+
+    // parse and answer a complete http request, returns false if the connection should be closed
+    bool request(AlpacaSession *s, char *body);
+
+    // gets an argument from the query string or form body (names are case insensitive)
+    bool arg(const char *name, char *value, int size);
+    bool argDouble(const char *name, double *value);
+    bool argLong(const char *name, long *value);
+    bool argBool(const char *name, bool *value);
+
+    // Management API
+    bool management(const char *path);
+
+    // Device API, the members common to all devices then each device type
+    bool device(const char *type, int number, const char *member);
+    bool common(const char *type, int number, const char *member);
+    bool telescopeMember(const char *member);
+    bool focuserMember(int number, const char *member);
+    bool rotatorMember(const char *member);
+
+    // set the response value
+    inline Formatter value() { return Formatter(jsonValue, sizeof(jsonValue)); }
+    void valueBool(bool b);
+    void valueDouble(double d, uint8_t decimals = 6);
+    void valueLong(long n);
+    void valueString(const char *s);
+
+    // set the response error, from an Alpaca error number or a command error
+    void error(int number, const char *message);
+    void error(CommandError e);
+
+    // run a command, sets the error response if it fails
+    bool lx200(const char *command, char *reply = NULL);
+
+    // send the json response (or an http error if status isn't 200)
+    void respond(AlpacaSession *s, int status, bool keepAlive);
+
+    #if OPERATIONAL_MODE == WIFI
+      WiFiServer *server;
+      WiFiUDP udp;
+    #else
+      EthernetServer *server;
+      EthernetUDP udp;
+    #endif
+
+    AlpacaSession sessions[ALPACA_CLIENTS];
+
+    bool isPut = false;
+    char args[ALPACA_ARGS_SIZE];
+    char jsonValue[ALPACA_VALUE_SIZE];
+    int errorNumber = AE_NONE;
+    char errorMessage[48];
+    unsigned long clientTransactionId = 0;
+    unsigned long serverTransactionId = 0;
+
+    bool connected = true;
+    float rotatorTarget = 0.0F;
+    bool active = false;
+};
+
+extern Alpaca alpaca;
+
+#endif
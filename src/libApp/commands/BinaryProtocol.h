@@ -0,0 +1,162 @@
+// -----------------------------------------------------------------------------------
+// Binary command protocol, request op codes and fixed-layout payloads
+//
+// negotiated per channel with the :SXCM,B# command, after which frames (see lib/commands/BinaryCmds.h)
+// replace ASCII commands on that channel until a BOP_MODE_ASCII request
+//
+// each response has the op code of the request with the high bit set, its payload starts with
+// the CommandError code (CE_NONE on success) followed by the response struct if any
+// all values are little-endian, angles are in radians and doubles are IEEE 754 64 bit
+#pragma once
+
+#include <Arduino.h>
+
+#define BINARY_RESPONSE 0x80
+
+enum BinaryOp: uint8_t {
+  BOP_MODE_ASCII   = 0x00,  // return to ASCII commands, no payload
+  BOP_GET_POSITION = 0x01,  // no payload, response BinaryPosition
+  BOP_GET_TARGET   = 0x02,  // no payload, response BinaryTarget
+  BOP_GET_STATUS   = 0x03,  // no payload, response BinaryStatus
+  BOP_SET_TARGET   = 0x10,  // request BinaryTarget
+  BOP_GOTO         = 0x11,  // request BinaryGoto
+  BOP_SYNC         = 0x12,  // request BinaryGoto
+  BOP_STOP         = 0x13,  // no payload, stops any goto and guide
+  BOP_GUIDE        = 0x20,  // request BinaryGuide
+  BOP_TRACKING     = 0x21,  // request BinaryTracking
+  BOP_NV_INFO      = 0x30,  // no payload, response BinaryNvInfo
+  BOP_NV_READ      = 0x31,  // request BinaryNvRead, response the offset (uint16_t) then the bytes
+  BOP_NV_BEGIN     = 0x32,  // request BinaryNvBegin, starts an import (the NV key is cleared until it ends)
+  BOP_NV_WRITE     = 0x33,  // request the offset (uint16_t) then 1 to BINARY_NV_CHUNK bytes
+  BOP_NV_END       = 0x34,  // request BinaryNvEnd, the import is kept only if the image CRC matches, restart to use it
+  BOP_LIB_INFO     = 0x40,  // no payload, response BinaryLibInfo
+  BOP_LIB_READ     = 0x41,  // request BinaryLibRead, response the slot (uint16_t) then the slots
+  BOP_LIB_WRITE    = 0x42,  // request the slot (uint16_t) then 1 to BINARY_LIB_SLOTS slots
+  BOP_LIB_CLEAR    = 0x43,  // no payload, clears all catalogs
+  BOP_LOG_INFO     = 0x50,  // no payload, response BinaryLogInfo
+  BOP_LOG_READ     = 0x51,  // request BinaryLogRead, response the sequence (uint32_t) then the records held from there
+  BOP_ALIGN_INFO   = 0x60,  // no payload, response BinaryAlignInfo
+  BOP_ALIGN_POINTS = 0x61,  // request the index (uint16_t) then 1 to BINARY_ALIGN_POINTS BinaryAlignPoint, index 0 starts a new set
+  BOP_ALIGN_FIT    = 0x62   // no payload, fits the pointing model to the points in the background (see BOP_ALIGN_INFO)
+};
+
+// NV snapshots move through BOP_NV_READ and BOP_NV_WRITE in chunks of this many bytes
+#define BINARY_NV_CHUNK    32
+#define BINARY_NV_VERSION  1
+
+// library slots (LIBRARY_SLOT_SIZE bytes each, in the format described in Library.h) move through BOP_LIB_READ
+// and BOP_LIB_WRITE this many at a time, slot 0 holds the format header and isn't transferred
+#define BINARY_LIB_SLOTS   5
+
+// mount log records (MountLogRecord, 16 bytes each, see MountLog.h) move through BOP_LOG_READ this many at a time
+#define BINARY_LOG_RECORDS 2
+
+// pointing model points (BinaryAlignPoint) move through BOP_ALIGN_POINTS this many at a time, each must follow
+// on from the points already held
+#define BINARY_ALIGN_POINTS 2
+
+#pragma pack(1)
+typedef struct BinaryPosition {
+  double ra;                // right ascension (Native coordinate system)
+  double dec;               // declination
+  double alt;               // altitude
+  double azm;               // azimuth
+  uint8_t pierSide;         // PierSide
+} BinaryPosition;
+
+typedef struct BinaryTarget {
+  double ra;
+  double dec;
+} BinaryTarget;
+
+typedef struct BinaryGoto {
+  double ra;
+  double dec;
+  uint8_t pierSideSelect;   // PierSideSelect, PSS_NONE for the preferred pier side
+} BinaryGoto;
+
+typedef struct BinaryStatus {
+  uint8_t tracking;         // 1 if tracking
+  uint8_t gotoState;        // GotoState
+  uint8_t parkState;        // ParkState
+  uint8_t homeState;        // HomeState
+  uint8_t guide;            // bit 0 guide active, bit 1 pulse guide active
+  uint8_t rateComp;         // RateCompensation
+  uint8_t pierSide;         // PierSide
+  uint8_t errorCode;        // general error code as :GU# returns it
+  float trackingRate;       // in sidereal units
+} BinaryStatus;
+
+typedef struct BinaryGuide {
+  uint8_t axis;             // 1 or 2
+  uint8_t action;           // GuideAction, GA_FORWARD or GA_REVERSE to start, GA_BREAK to stop
+  uint8_t rateSelect;       // GuideRateSelect
+  uint32_t timeLimit;       // in ms
+} BinaryGuide;
+
+typedef struct BinaryTracking {
+  uint8_t enable;           // 1 to start tracking, 0 to stop
+} BinaryTracking;
+
+// the image CRC is CRC-16/CCITT (initial value 0xFFFF) over NV up to the region CRC table, the table is
+// rebuilt from the imported data and each region is then checked in the background
+typedef struct BinaryNvInfo {
+  uint8_t version;          // BINARY_NV_VERSION
+  uint16_t size;            // NV size in bytes
+  uint32_t key;             // NV layout key, an image only imports into firmware with the same key
+  uint16_t crc;             // image CRC
+  uint8_t regionErrors;     // bit n set if region n failed its last CRC check
+} BinaryNvInfo;
+
+typedef struct BinaryNvRead {
+  uint16_t offset;
+  uint8_t count;            // 1 to BINARY_NV_CHUNK
+} BinaryNvRead;
+
+typedef struct BinaryNvBegin {
+  uint16_t size;            // must match the NV size
+  uint32_t key;             // must match the NV layout key
+} BinaryNvBegin;
+
+typedef struct BinaryNvEnd {
+  uint16_t crc;             // image CRC from BOP_NV_INFO when exported
+} BinaryNvEnd;
+
+typedef struct BinaryLibInfo {
+  uint8_t format;           // LIBRARY_FORMAT, slots only import into a library with the same format
+  uint16_t slots;           // number of slots including the header
+  uint16_t freeSlots;       // unused slots
+} BinaryLibInfo;
+
+typedef struct BinaryLibRead {
+  uint16_t slot;            // 1 or more
+  uint8_t count;            // 1 to BINARY_LIB_SLOTS
+} BinaryLibRead;
+
+typedef struct BinaryLogInfo {
+  uint32_t first;           // sequence number of the oldest record held
+  uint32_t next;            // sequence number the next record will get
+} BinaryLogInfo;
+
+typedef struct BinaryLogRead {
+  uint32_t sequence;        // first record wanted
+  uint8_t count;            // 1 to BINARY_LOG_RECORDS
+} BinaryLogRead;
+
+typedef struct BinaryAlignInfo {
+  uint16_t maxPoints;       // ALIGN_POINTS_MAX
+  uint16_t points;          // points held
+  uint8_t fit;              // AlignPointsFit
+  float rms;                // rms residual of the last fit in arc-seconds
+} BinaryAlignInfo;
+
+// a point from plate solving, the topocentric hour angle and declination where the telescope was really pointed
+// and where the mount reported it was with no pointing model in use (cleared while the points are captured)
+typedef struct BinaryAlignPoint {
+  float observedH;
+  float observedD;
+  float mountH;
+  float mountD;
+  uint8_t pierSide;         // PierSide as reported by the mount
+} BinaryAlignPoint;
+#pragma pack()
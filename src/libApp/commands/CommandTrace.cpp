@@ -0,0 +1,90 @@
+// -----------------------------------------------------------------------------------
+// Command trace, records timestamped commands from all channels and replays them with the original timing
+
+#include "CommandTrace.h"
+
+#ifdef COMMAND_TRACE
+
+void CommandTrace::capture() {
+  head = count = 0;
+  dropped = 0;
+  state = CTS_CAPTURE;
+  VLF("MSG: Commands, trace capture started");
+}
+
+bool CommandTrace::replay() {
+  if (count == 0) return false;
+
+  cursor = 0;
+  replayed = skipped = 0;
+  latenessMax = latenessTotal = 0;
+  replayStart = millis();
+  state = CTS_REPLAY;
+  VF("MSG: Commands, trace replay of "); V(count); VLF(" records started");
+  return true;
+}
+
+void CommandTrace::stop() {
+  if (state == CTS_IDLE) return;
+  if (state == CTS_REPLAY) {
+    VF("MSG: Commands, trace replay stopped "); V(replayed); VF(" replayed "); V(skipped); VF(" skipped, lateness max ");
+    V(latenessMax); VF("ms average "); V(replayed ? latenessTotal/replayed : 0); VLF("ms");
+  } else { VF("MSG: Commands, trace capture stopped "); V(count); VLF(" records"); }
+  state = CTS_IDLE;
+}
+
+void CommandTrace::record(char channel, const char *command, const char *parameter) {
+  if (state != CTS_CAPTURE) return;
+
+  // baud rate and binary mode changes aren't recorded, replaying them would cut the channel off
+  if (command[0] == 'S' && (command[1] == 'B' || (command[1] == 'X' && parameter[0] == 'C' && parameter[1] == 'M'))) return;
+
+  size_t length = strlen(command) + strlen(parameter) + 2;
+  if (length >= COMMAND_TRACE_TEXT) { dropped++; return; }
+
+  CommandTraceRecord *r = &trace[head];
+  r->time = millis();
+  r->channel = channel;
+  r->text[0] = ':';
+  strcpy(&r->text[1], command);
+  strcat(r->text, parameter);
+  strcat(r->text, "#");
+
+  head = (head + 1) % COMMAND_TRACE;
+  if (count < COMMAND_TRACE) count++;
+}
+
+int CommandTrace::replayRead(char channel, char *data, int size) {
+  if (state != CTS_REPLAY) return 0;
+
+  uint16_t first = (head + COMMAND_TRACE - count) % COMMAND_TRACE;
+  unsigned long now = millis();
+  while (true) {
+    if (cursor >= count) { stop(); return 0; }
+
+    // due at the same offset from the start of the replay as from the first record
+    CommandTraceRecord *r = &trace[(first + cursor) % COMMAND_TRACE];
+    unsigned long due = replayStart + (r->time - trace[first].time);
+    if ((long)(now - due) < 0) return 0;
+
+    unsigned long lateness = now - due;
+    if (r->channel != channel) {
+      if (lateness < COMMAND_TRACE_SKIP_MS) return 0;
+      skipped++; cursor++;
+      continue;
+    }
+
+    int length = strlen(r->text);
+    if (length > size) length = size;
+    memcpy(data, r->text, length);
+
+    if (lateness > latenessMax) latenessMax = lateness;
+    latenessTotal += lateness;
+    replayed++; cursor++;
+    return length;
+  }
+}
+
+CommandTrace commandTrace;
+
+#endif
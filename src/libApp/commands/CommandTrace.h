@@ -0,0 +1,64 @@
+// -----------------------------------------------------------------------------------
+// Command trace, records timestamped commands from all channels and replays them with the original timing
+#pragma once
+
+#include "../../Common.h"
+
+#ifdef COMMAND_TRACE
+
+// the longest command recorded, longer ones are counted as dropped
+#define COMMAND_TRACE_TEXT 27
+
+// a record not taken up by its channel this long after it's due is skipped (the channel isn't present)
+#define COMMAND_TRACE_SKIP_MS 1000
+
+enum CommandTraceState: uint8_t {CTS_IDLE, CTS_CAPTURE, CTS_REPLAY};
+
+typedef struct CommandTraceRecord {
+  uint32_t time;                      // millis() when the command was processed
+  char channel;
+  char text[COMMAND_TRACE_TEXT];      // the command in its frame, ":GR#"
+} CommandTraceRecord;
+
+// captures into a RAM ring holding the last COMMAND_TRACE records, replay feeds the commands back in to the
+// channels they came from as if they had just arrived so the whole command path is exercised, the replies go
+// out on those channels as usual
+class CommandTrace {
+  public:
+    // start capturing, any records held are cleared
+    void capture();
+
+    // replay the records held, false if there are none
+    bool replay();
+
+    // stop capturing or replaying
+    void stop();
+
+    // record a command as processed on a channel
+    void record(char channel, const char *command, const char *parameter);
+
+    // copy the next record into data if it's due and for this channel, returns the number of bytes or 0 if none
+    int replayRead(char channel, char *data, int size);
+
+    CommandTraceState state = CTS_IDLE;
+
+    unsigned long dropped = 0;        // commands too long to record
+    unsigned long replayed = 0;
+    unsigned long skipped = 0;
+    unsigned long latenessMax = 0;    // in ms, how long after it was due a record was taken up by its channel
+    unsigned long latenessTotal = 0;
+
+    inline uint16_t records() { return count; }
+
+  private:
+    CommandTraceRecord trace[COMMAND_TRACE];
+    uint16_t head = 0;                // the next record written
+    uint16_t count = 0;
+
+    uint16_t cursor = 0;              // replay position, 0 to count - 1 from the oldest
+    unsigned long replayStart = 0;
+};
+
+extern CommandTrace commandTrace;
+
+#endif
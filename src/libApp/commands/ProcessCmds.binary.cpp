@@ -0,0 +1,339 @@
+// -----------------------------------------------------------------------------------
+// Command processing, binary protocol
+
+#include "../../Common.h"
+#include "ProcessCmds.h"
+#include "BinaryProtocol.h"
+
+#include "../../telescope/Telescope.h"
+
+#ifdef MOUNT_PRESENT
+  #include "../../telescope/mount/Mount.h"
+  #include "../../telescope/mount/coordinates/Transform.h"
+  #include "../../telescope/mount/goto/Goto.h"
+  #include "../../telescope/mount/guide/Guide.h"
+  #include "../../telescope/mount/home/Home.h"
+  #include "../../telescope/mount/park/Park.h"
+  #include "../../telescope/mount/limits/Limits.h"
+  #include "../../telescope/mount/library/Library.h"
+  #include "../../telescope/mount/log/MountLog.h"
+#endif
+
+void CommandProcessor::binaryPoll() {
+  unsigned long tout = micros() + SERIAL_POLL_BUDGET;
+  while (binaryMode) {
+    if (rxPos >= rxCount && ((long)(micros() - tout) > 0 || !rxFill())) break;
+    if (binaryBuffer.add(rxBlock[rxPos++])) binaryProcess();
+  }
+}
+
+void CommandProcessor::binaryProcess() {
+  uint8_t op = binaryBuffer.getOp();
+  uint8_t response[BINARY_PAYLOAD_MAX];
+  uint8_t responseLength = 1;
+  #if defined(MOUNT_PRESENT) && PARK_LOW_POWER != OFF
+    if (op < BOP_GET_POSITION || op > BOP_GET_STATUS) park.wake();
+  #endif
+  #ifdef COMMAND_STATISTICS_ENABLE
+    unsigned long startTime = micros();
+  #endif
+  commandError = binaryCommand(op, binaryBuffer.getPayload(), binaryBuffer.getLength(), &response[1], &responseLength);
+  #ifdef COMMAND_STATISTICS_ENABLE
+    statisticsRecord(0, micros() - startTime);
+  #endif
+  response[0] = commandError;
+
+  uint8_t frame[BINARY_FRAME_MAX];
+  size_t frameLength = BinaryBuffer::frame(frame, op | BINARY_RESPONSE, response, responseLength);
+  write(frame, frameLength);
+
+  #if DEBUG_ECHO_COMMANDS != OFF
+    if (DEBUG_ECHO_COMMANDS == ON || commandError > CE_0) {
+      DF("MSG: bin"); D(channel); DF(" = "); D(op); DF(", error = "); DL(commandError);
+    }
+  #endif
+  if (commandError != CE_NULL) lastCommandError = commandError;
+
+  binaryBuffer.flush();
+  if (op == BOP_MODE_ASCII) { binaryMode = false; buffer.flush(); }
+}
+
+// an NV import in progress, the key bytes are held back until the image checks out
+static bool nvImportActive = false;
+static uint8_t nvImportKey[4];
+
+#if defined(MOUNT_PRESENT) && ALIGN_MAX_NUM_STARS > 1 && ALIGN_POINTS_MAX != OFF
+  // a topocentric hour angle and declination to the observed place the pointing model works in
+  static void alignPointToObservedPlace(Coordinate *coord) {
+    #if MOUNT_COORDS == TOPOCENTRIC || MOUNT_COORDS == TOPO_STRICT
+      if (transform.mountType == ALTAZM) {
+        transform.equToHor(coord);
+        transform.topocentricToObservedPlace(coord);
+        transform.horToEqu(coord);
+      } else transform.topocentricToObservedPlace(coord);
+    #else
+      UNUSED(coord);
+    #endif
+  }
+#endif
+
+// expects the request payload to be exactly the size of the given struct
+#define BINARY_REQUEST(type) if (length != sizeof(type)) return CE_PARAM_FORM; type request; memcpy(&request, payload, sizeof(type))
+#define BINARY_REPLY(value) memcpy(response, &value, sizeof(value)); *responseLength += sizeof(value)
+
+CommandError CommandProcessor::binaryCommand(uint8_t op, uint8_t *payload, uint8_t length, uint8_t *response, uint8_t *responseLength) {
+  if (op == BOP_MODE_ASCII) return length == 0 ? CE_NONE : CE_PARAM_FORM;
+
+  switch (op) {
+    case BOP_NV_INFO: {
+      if (length != 0) return CE_PARAM_FORM;
+      BinaryNvInfo reply = {BINARY_NV_VERSION, nv.size, (uint32_t)INIT_NV_KEY, nv.crcBytes(0, nv.regionTableBase()), nv.regionErrors};
+      BINARY_REPLY(reply);
+      return CE_NONE;
+    }
+
+    case BOP_NV_READ: {
+      BINARY_REQUEST(BinaryNvRead);
+      if (request.count == 0 || request.count > BINARY_NV_CHUNK || (uint32_t)request.offset + request.count > nv.size) return CE_PARAM_RANGE;
+      BINARY_REPLY(request.offset);
+      nv.readBytes(request.offset, &response[sizeof(request.offset)], request.count);
+      *responseLength += request.count;
+      return CE_NONE;
+    }
+
+    case BOP_NV_BEGIN: {
+      BINARY_REQUEST(BinaryNvBegin);
+      if (request.size != nv.size || request.key != (uint32_t)INIT_NV_KEY) return CE_PARAM_RANGE;
+      // until the import completes the next boot resets NV to defaults instead of running with half an image
+      nv.writeKey(0);
+      memset(nvImportKey, 0, sizeof(nvImportKey));
+      nvImportActive = true;
+      return CE_NONE;
+    }
+
+    case BOP_NV_WRITE: {
+      if (length <= sizeof(uint16_t) || length > sizeof(uint16_t) + BINARY_NV_CHUNK) return CE_PARAM_FORM;
+      if (!nvImportActive) return CE_0;
+      uint16_t offset;
+      memcpy(&offset, payload, sizeof(offset));
+      uint8_t count = length - sizeof(offset);
+      uint8_t *data = &payload[sizeof(offset)];
+      if ((uint32_t)offset + count > nv.size) return CE_PARAM_RANGE;
+      for (uint8_t k = 0; k < count; k++) {
+        uint16_t i = offset + k;
+        if (i < sizeof(nvImportKey)) nvImportKey[i] = data[k]; else nv.write(i, data[k]);
+      }
+      return CE_NONE;
+    }
+
+    case BOP_NV_END: {
+      BINARY_REQUEST(BinaryNvEnd);
+      if (!nvImportActive) return CE_0;
+      nvImportActive = false;
+      uint16_t crc = nv.crc16(0xFFFF, nvImportKey, sizeof(nvImportKey));
+      crc = nv.crcBytes(sizeof(nvImportKey), nv.regionTableBase() - sizeof(nvImportKey), crc);
+      if (crc != request.crc) return CE_0;
+      uint32_t key;
+      memcpy(&key, nvImportKey, sizeof(key));
+      nv.writeKey(key);
+      return CE_NONE;
+    }
+  }
+
+  #ifdef MOUNT_PRESENT
+    switch (op) {
+      case BOP_GET_POSITION: {
+        if (length != 0) return CE_PARAM_FORM;
+        Coordinate current = mount.getMountPosition(CR_MOUNT);
+        Coordinate position = transform.mountToNative(&current, true);
+        BinaryPosition reply = {position.r, position.d, position.a, position.z, current.pierSide};
+        BINARY_REPLY(reply);
+        return CE_NONE;
+      }
+
+      case BOP_GET_STATUS: {
+        if (length != 0) return CE_PARAM_FORM;
+        BinaryStatus reply;
+        reply.tracking = mount.isTracking();
+        reply.gotoState = goTo.state;
+        reply.parkState = park.state;
+        reply.homeState = home.state;
+        reply.guide = (guide.active() ? 1 : 0) | (guide.activePulseGuide() ? 2 : 0);
+        reply.rateComp = mount.settings.rc;
+        reply.pierSide = mount.getMountPosition(CR_MOUNT).pierSide;
+        reply.errorCode = limits.errorCode();
+        reply.trackingRate = mount.trackingRate;
+        BINARY_REPLY(reply);
+        return CE_NONE;
+      }
+
+      #if GOTO_FEATURE == ON
+        case BOP_GET_TARGET: {
+          if (length != 0) return CE_PARAM_FORM;
+          Coordinate target = goTo.getGotoTarget();
+          BinaryTarget reply = {target.r, target.d};
+          BINARY_REPLY(reply);
+          return CE_NONE;
+        }
+
+        case BOP_SET_TARGET: {
+          BINARY_REQUEST(BinaryTarget);
+          if (request.ra < 0.0 || request.ra >= Deg360 || fabs(request.dec) > Deg90) return CE_PARAM_RANGE;
+          Coordinate target = goTo.getGotoTarget();
+          target.r = request.ra;
+          target.d = request.dec;
+          goTo.setGotoTarget(&target);
+          return CE_NONE;
+        }
+
+        case BOP_GOTO: case BOP_SYNC: {
+          BINARY_REQUEST(BinaryGoto);
+          if (request.ra < 0.0 || request.ra >= Deg360 || fabs(request.dec) > Deg90) return CE_PARAM_RANGE;
+          if (request.pierSideSelect > PSS_SAME_ONLY) return CE_PARAM_RANGE;
+          Coordinate target = goTo.getGotoTarget();
+          target.r = request.ra;
+          target.d = request.dec;
+          goTo.setGotoTarget(&target);
+          if (request.pierSideSelect == PSS_NONE) {
+            return op == BOP_GOTO ? goTo.request() : goTo.requestSync();
+          } else {
+            PierSideSelect pierSideSelect = (PierSideSelect)request.pierSideSelect;
+            return op == BOP_GOTO ? goTo.request(target, pierSideSelect) : goTo.requestSync(target, pierSideSelect);
+          }
+        }
+      #endif
+
+      case BOP_STOP: {
+        if (length != 0) return CE_PARAM_FORM;
+        #if GOTO_FEATURE == ON
+          goTo.abort();
+        #endif
+        guide.stop();
+        return CE_NONE;
+      }
+
+      case BOP_GUIDE: {
+        BINARY_REQUEST(BinaryGuide);
+        if (request.axis < 1 || request.axis > 2) return CE_PARAM_RANGE;
+        if (request.action == GA_BREAK) {
+          if (request.axis == 1) guide.stopAxis1(); else guide.stopAxis2();
+          return CE_NONE;
+        }
+        if (request.action != GA_FORWARD && request.action != GA_REVERSE) return CE_PARAM_RANGE;
+        if (request.rateSelect >= GR_CUSTOM) return CE_PARAM_RANGE;
+        GuideAction action = (GuideAction)request.action;
+        GuideRateSelect rateSelect = (GuideRateSelect)request.rateSelect;
+        if (request.axis == 1) return guide.startAxis1(action, rateSelect, request.timeLimit);
+        return guide.startAxis2(action, rateSelect, request.timeLimit);
+      }
+
+      case BOP_LIB_INFO: {
+        if (length != 0) return CE_PARAM_FORM;
+        BinaryLibInfo reply = {LIBRARY_FORMAT, (uint16_t)library.slotCount(), (uint16_t)library.recFreeAll()};
+        BINARY_REPLY(reply);
+        return CE_NONE;
+      }
+
+      case BOP_LIB_READ: {
+        BINARY_REQUEST(BinaryLibRead);
+        if (request.count == 0 || request.count > BINARY_LIB_SLOTS) return CE_PARAM_RANGE;
+        BINARY_REPLY(request.slot);
+        if (!library.readSlots(request.slot, &response[sizeof(request.slot)], request.count)) return CE_PARAM_RANGE;
+        *responseLength += request.count*LIBRARY_SLOT_SIZE;
+        return CE_NONE;
+      }
+
+      case BOP_LIB_WRITE: {
+        if (length <= sizeof(uint16_t) || (length - sizeof(uint16_t)) % LIBRARY_SLOT_SIZE != 0 ||
+            length > sizeof(uint16_t) + BINARY_LIB_SLOTS*LIBRARY_SLOT_SIZE) return CE_PARAM_FORM;
+        uint16_t slot;
+        memcpy(&slot, payload, sizeof(slot));
+        if (!library.writeSlots(slot, &payload[sizeof(slot)], (length - sizeof(slot))/LIBRARY_SLOT_SIZE)) return CE_PARAM_RANGE;
+        return CE_NONE;
+      }
+
+      case BOP_LIB_CLEAR: {
+        if (length != 0) return CE_PARAM_FORM;
+        library.clearAll();
+        return CE_NONE;
+      }
+
+      #if MOUNT_LOG != OFF
+        case BOP_LOG_INFO: {
+          if (length != 0) return CE_PARAM_FORM;
+          BinaryLogInfo reply = {mountLog.first(), mountLog.next()};
+          BINARY_REPLY(reply);
+          return CE_NONE;
+        }
+
+        case BOP_LOG_READ: {
+          BINARY_REQUEST(BinaryLogRead);
+          if (request.count == 0 || request.count > BINARY_LOG_RECORDS) return CE_PARAM_RANGE;
+          BINARY_REPLY(request.sequence);
+          for (uint8_t i = 0; i < request.count; i++) {
+            MountLogRecord record;
+            if (!mountLog.get(request.sequence + i, &record)) { if (i == 0) return CE_PARAM_RANGE; break; }
+            memcpy(&response[sizeof(request.sequence) + i*sizeof(record)], &record, sizeof(record));
+            *responseLength += sizeof(record);
+          }
+          return CE_NONE;
+        }
+      #endif
+
+      #if ALIGN_MAX_NUM_STARS > 1 && ALIGN_POINTS_MAX != OFF
+        case BOP_ALIGN_INFO: {
+          if (length != 0) return CE_PARAM_FORM;
+          BinaryAlignInfo reply = {ALIGN_POINTS_MAX, (uint16_t)transform.align.pointCount(), transform.align.pointsFitState, transform.align.pointsFitRms()};
+          BINARY_REPLY(reply);
+          return CE_NONE;
+        }
+
+        case BOP_ALIGN_POINTS: {
+          if (length <= sizeof(uint16_t) || (length - sizeof(uint16_t)) % sizeof(BinaryAlignPoint) != 0 ||
+              length > sizeof(uint16_t) + BINARY_ALIGN_POINTS*sizeof(BinaryAlignPoint)) return CE_PARAM_FORM;
+          uint16_t index;
+          memcpy(&index, payload, sizeof(index));
+          if (index == 0 && !transform.align.pointsClear()) return CE_0;
+          if (index != transform.align.pointCount()) return CE_PARAM_RANGE;
+
+          int count = (length - sizeof(index))/sizeof(BinaryAlignPoint);
+          for (int i = 0; i < count; i++) {
+            BinaryAlignPoint point;
+            memcpy(&point, &payload[sizeof(index) + i*sizeof(point)], sizeof(point));
+            if (fabs(point.observedD) > Deg90 || fabs(point.mountD) > Deg90 || fabs(point.observedH) > Deg360 || fabs(point.mountH) > Deg360) return CE_PARAM_RANGE;
+            if (point.pierSide != PIER_SIDE_EAST && point.pierSide != PIER_SIDE_WEST) return CE_PARAM_RANGE;
+
+            PierSide pierSide = (PierSide)point.pierSide;
+            Coordinate actual = {0.0, point.observedH, point.observedD, 0.0, 0.0, 0.0, 0.0, pierSide};
+            Coordinate reported = {0.0, point.mountH, point.mountD, 0.0, 0.0, 0.0, 0.0, pierSide};
+            alignPointToObservedPlace(&actual);
+            alignPointToObservedPlace(&reported);
+            if (!transform.align.pointAdd(&actual, &reported)) return CE_0;
+          }
+          return CE_NONE;
+        }
+
+        case BOP_ALIGN_FIT: {
+          if (length != 0) return CE_PARAM_FORM;
+          return transform.align.pointsFit();
+        }
+      #endif
+
+      case BOP_TRACKING: {
+        BINARY_REQUEST(BinaryTracking);
+        if (request.enable > 1) return CE_PARAM_RANGE;
+        // same checks as :Te# and :Td#
+        char reply[80] = "", command[3] = "Td", parameter[1] = "";
+        if (request.enable) command[1] = 'e';
+        bool supressFrame = false, numericReply = true;
+        CommandError e = CE_NONE;
+        telescope.command(reply, command, parameter, &supressFrame, &numericReply, &e);
+        return e;
+      }
+    }
+  #else
+    UNUSED(payload); UNUSED(length); UNUSED(response); UNUSED(responseLength);
+  #endif
+
+  return CE_CMD_UNKNOWN;
+}
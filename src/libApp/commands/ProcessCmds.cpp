@@ -4,15 +4,146 @@
 #include "../../Common.h"
 #include "../../lib/tasks/OnTask.h"
 #include "../../lib/convert/Convert.h"
+#include "../../lib/memory/Memory.h"
+#include "../../lib/boot/BootTime.h"
+#include "../../lib/counters/Counters.h"
 #include "ProcessCmds.h"
+#include "CommandTrace.h"
 
 #include "../../telescope/Telescope.h"
+#include "../../plugins/PluginLoad.h"
 
 #ifdef MOUNT_PRESENT
   #if ST4_INTERFACE == ON && ST4_HAND_CONTROL == ON
     #include "../../lib/serial/Serial_ST4_Master.h"
   #endif
   #include "../../lib/serial/Serial_Local.h"
+  #include "../../telescope/mount/Mount.h"
+  #include "../../telescope/mount/coordinates/Transform.h"
+  #include "../../telescope/mount/goto/Goto.h"
+  #include "../../telescope/mount/guide/Guide.h"
+  #include "../../telescope/mount/library/Library.h"
+  #include "../../telescope/mount/limits/Limits.h"
+  #include "../../telescope/mount/park/Park.h"
+  #include "../../telescope/mount/pec/Pec.h"
+  #include "../../telescope/mount/site/Site.h"
+  #include "../../telescope/mount/status/Status.h"
+  #ifdef FOCUSER_PRESENT
+    #include "../../telescope/focuser/Focuser.h"
+  #endif
+  #ifdef ROTATOR_PRESENT
+    #include "../../telescope/rotator/Rotator.h"
+  #endif
+
+  #define STATUS_STREAM_TICK       50      // in ms, the status frame is rebuilt no more often than this
+  #define STATUS_STREAM_PERIOD_MIN 100     // in ms
+  #define STATUS_STREAM_PERIOD_MAX 60000   // in ms
+
+  // replies to the position and status getters are shared between channels for a short time
+  #define REPLY_CACHE_SIZE         6
+  #define REPLY_CACHE_TIME         10      // in ms, about 0.15 arc-seconds of sidereal motion
+
+  typedef struct ReplyCacheEntry {
+    char command[3];
+    char parameter[2];
+    unsigned long time;
+    char reply[20];
+  } ReplyCacheEntry;
+
+  static ReplyCacheEntry replyCache[REPLY_CACHE_SIZE];
+  static uint8_t replyCacheNext = 0;
+
+  // read-only getters with a reply that only depends on the current position and state
+  static bool replyCacheable(char *command, char *parameter) {
+    if (command[0] != 'G' || strchr("RDAZU", command[1]) == NULL || command[1] == 0) return false;
+    return parameter[0] == 0 || (parameter[1] == 0 && command[1] != 'U');
+  }
+
+  static ReplyCacheEntry *replyCacheFind(char *command, char *parameter) {
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < REPLY_CACHE_SIZE; i++) {
+      ReplyCacheEntry *entry = &replyCache[i];
+      if (entry->command[0] == 0 || (long)(now - entry->time) >= REPLY_CACHE_TIME) continue;
+      if (entry->command[1] == command[1] && entry->parameter[0] == parameter[0]) return entry;
+    }
+    return NULL;
+  }
+
+  static void replyCachePut(char *command, char *parameter, char *reply) {
+    if (strlen(reply) >= sizeof(replyCache[0].reply)) return;
+    ReplyCacheEntry *entry = &replyCache[replyCacheNext];
+    replyCacheNext = (replyCacheNext + 1) % REPLY_CACHE_SIZE;
+    strcpy(entry->command, command);
+    entry->parameter[0] = parameter[0];
+    entry->parameter[1] = 0;
+    entry->time = millis();
+    strcpy(entry->reply, reply);
+  }
+
+  // anything other than a getter may change the position or state
+  static void replyCacheClear() {
+    for (uint8_t i = 0; i < REPLY_CACHE_SIZE; i++) replyCache[i].command[0] = 0;
+  }
+
+  // one status frame shared by all subscribed channels
+  static char statusFrame[128] = "";
+  static uint16_t statusFrameHash = 0;
+  static unsigned long statusFrameTime = 0;
+  static bool statusFrameReady = false;
+  static uint8_t statusEventCount = 0;
+
+  // any axis motion event rebuilds the frame and pushes it to subscribed channels without waiting for the period
+  static void statusAxisEvent(Axis *axis, AxisEvent event) {
+    UNUSED(axis); UNUSED(event);
+    statusFrameReady = false;
+    statusEventCount++;
+  }
+
+  static void statusFrameUpdate() {
+    unsigned long now = millis();
+    if (statusFrameReady && (long)(now - statusFrameTime) < STATUS_STREAM_TICK) return;
+    statusFrameTime = now;
+    statusFrameReady = true;
+
+    Coordinate position = mount.getMountPosition(CR_MOUNT);
+    position = transform.mountToNative(&position, true);
+
+    Formatter frame(statusFrame, sizeof(statusFrame));
+    frame.chr('@').fixed(radToHrs(position.r), 5).chr(',').fixed(radToDeg(position.d), 4).chr(',');
+    frame.fixed(radToDeg(position.a), 4).chr(',').fixed(radToDeg(position.z), 4).chr(',');
+
+    // the state is the same as :GU# returns
+    char cmd[3] = "GU", param[1] = "";
+    bool supressFrame = false, numericReply = true;
+    CommandError e = CE_NONE;
+    char s[40] = "";
+    mountStatus.command(s, cmd, param, &supressFrame, &numericReply, &e);
+    frame.str(s);
+
+    // a focuser or rotator settling changes the frame, so it's pushed without the client polling
+    #ifdef FOCUSER_PRESENT
+      frame.str(",F");
+      for (int index = 0; index < FOCUSER_MAX; index++) frame.chr(focuser.isSettled(index) ? 'S' : 'M');
+    #endif
+    #ifdef ROTATOR_PRESENT
+      frame.str(",R").chr(rotator.isSettled() ? 'S' : 'M');
+    #endif
+    // the dome azimuth includes the goto destination as soon as it's accepted
+    #if DOME_SLAVING == ON
+      float azimuth, azimuthTarget, rate;
+      mount.getDome(&azimuth, &azimuthTarget, &rate);
+      frame.str(",D").fixed(azimuth, 1).chr(',').fixed(azimuthTarget, 1).chr(',').fixed(rate, 4);
+    #endif
+    // as does an SWS GPIO output change
+    #if defined(GPIO_DEVICE) && GPIO_DEVICE == SWS
+      frame.str(",G").hex(gpio.outputMask(), 2).hex(gpio.outputState(), 2);
+    #endif
+    frame.chr('#');
+
+    uint16_t a = 0, b = 0;
+    for (char *c = statusFrame; *c; c++) { a += (uint8_t)*c; b += a; }
+    statusFrameHash = (b << 8) ^ a;
+  }
 #endif
 
 #if DEBUG != OFF
@@ -94,6 +225,10 @@
   CommandProcessor processCommandsIP(9600,'I');
   void processCmdsIP() { ::yield(); processCommandsIP.poll(); }
 #endif
+#ifdef SERIAL_WS
+  CommandProcessor processCommandsWS(9600,'W');
+  void processCmdsWS() { ::yield(); processCommandsWS.poll(); }
+#endif
 #ifdef SERIAL_LOCAL
   CommandProcessor processCommandsLocal(9600,'L');
   void processCmdsLocal() { processCommandsLocal.poll(); }
@@ -102,64 +237,342 @@
 CommandProcessor::CommandProcessor(long baud, char channel) {
   this->channel = channel;
   serialBaud = baud;
+  #ifdef COMMAND_STATISTICS_ENABLE
+    memset(&statistics, 0, sizeof(statistics));
+  #endif
 }
 
+#ifdef COMMAND_STATISTICS_ENABLE
+  // find the command processor for a channel
+  static CommandProcessor *commandProcessor(char channel) {
+    switch (channel) {
+      #ifdef SERIAL_A
+        case 'A': return &processCommandsA;
+      #endif
+      #ifdef SERIAL_B
+        case 'B': return &processCommandsB;
+      #endif
+      #ifdef SERIAL_C
+        case 'C': return &processCommandsC;
+      #endif
+      #ifdef SERIAL_D
+        case 'D': return &processCommandsD;
+      #endif
+      #ifdef SERIAL_ST4
+        case 'S': return &processCommandsST4;
+      #endif
+      #if SERIAL_BT_MODE == SLAVE
+        case 'T': return &processCommandsBT;
+      #endif
+      #ifdef SERIAL_PIP1
+        case '1': return &processCommandsPIP1;
+      #endif
+      #ifdef SERIAL_PIP2
+        case '2': return &processCommandsPIP2;
+      #endif
+      #ifdef SERIAL_PIP3
+        case '3': return &processCommandsPIP3;
+      #endif
+      #ifdef SERIAL_SIP
+        case 'I': return &processCommandsIP;
+      #endif
+      #ifdef SERIAL_WS
+        case 'W': return &processCommandsWS;
+      #endif
+      #ifdef SERIAL_LOCAL
+        case 'L': return &processCommandsLocal;
+      #endif
+      default: return NULL;
+    }
+  }
+#endif
+
 CommandProcessor::~CommandProcessor() {
   SerialPort.end();
 }
 
+#if SERIAL_EXPEDITE_PRIORITY != OFF
+  // channels holding a guide, stop or sync command, the others stop answering queued commands while there are any
+  static uint8_t expeditePending = 0;
+#endif
+
 void CommandProcessor::poll() {
-  if (!serialReady) { delay(200); SerialPort.begin(serialBaud); serialReady = true; }
+  // the port is given 200ms to settle after the channel starts, without holding up the other tasks meanwhile
+  if (!serialReady) {
+    if (!serialStarting) { serialStarting = true; serialBeginTime = millis() + 200UL; return; }
+    if ((long)(millis() - serialBeginTime) < 0) return;
+    SerialPort.begin(serialBaud);
+    serialReady = true;
+  }
 
-  unsigned long tout = micros() + 500;
-  while (SerialPort.available()) { char c = SerialPort.read(); buffer.add(c); if (buffer.ready() || (long)(micros() - tout) > 0) break; }
+  // send any reply still waiting on the port, then apply a pending baud rate change
+  SerialPort.drain();
+  if (baudPending != 0) {
+    if (SerialPort.txPending() > 0 || (long)(millis() - baudChangeTime) < 0) return;
+    SerialPort.flush();
+    SerialPort.begin(baudPending);
+    baudPending = 0;
+  }
 
-  if (buffer.ready()) {
-    char reply[80] = "";
-    bool numericReply = true;
-    bool supressFrame = false;
+  if (binaryMode) { binaryPoll(); return; }
 
-    commandError = command(reply, buffer.getCmd(), buffer.getParameter(), &supressFrame, &numericReply);
+  // keep reading and answering queued commands until the budget runs out
+  unsigned long tout = micros() + SERIAL_POLL_BUDGET;
+  while (true) {
+    bool spent = (long)(micros() - tout) > 0 && !expediting();
+    if (rxPos >= rxCount && (spent || !rxFill())) break;
+    char c = rxBlock[rxPos++];
 
-    if (numericReply) {
-      if (commandError != CE_NONE && commandError != CE_1) strcpy(reply,"0"); else strcpy(reply,"1");
-      supressFrame = true;
+    // a batch {:cmd#:cmd#...} runs each command as it arrives and sends all the replies together at the closing }
+    if (buffer.isEmpty()) {
+      if (c == '{') { batch = true; batchReply[0] = 0; continue; }
+      if (c == '}' && batch) { batch = false; write(batchReply); break; }
     }
-    if (strlen(reply) > 0 || buffer.checksum) {
-      if (buffer.checksum) {
-        appendChecksum(reply);
-        strcat(reply, buffer.getSeq());
-        supressFrame = false;
-      }
-      if (!supressFrame) strcat(reply,"#");
-      SerialPort.write(reply);
+
+    buffer.add(c);
+    if (buffer.ready()) {
+      process();
+      #if SERIAL_EXPEDITE_PRIORITY != OFF
+        if (expedite && !rxExpedited()) setExpedite(false);
+        if (!expedite && expeditePending > 0) break;
+      #endif
+      if (binaryMode || baudPending != 0 || ((long)(micros() - tout) > 0 && !expediting())) break;
     }
+  }
 
-    // debug, log errors and/or commands
-    #if DEBUG_ECHO_COMMANDS != OFF
-      if (DEBUG_ECHO_COMMANDS == ON || commandError > CE_0) {
-        DF("MSG: cmd"); D(channel); D(" = "); D(buffer.getCmd()); D(buffer.getParameter()); DF(", reply = "); D(reply);
-      }
+  #if SERIAL_BACKLOG_PRIORITY != OFF
+    // run ahead of the other command channels while there is a backlog
+    bool backlog = rxPos < rxCount || SerialPort.available() > 0;
+    if (backlog != priorityBoost && taskHandle != 0) {
+      if (!expediting()) tasks.setPriority(taskHandle, backlog ? SERIAL_BACKLOG_PRIORITY : 5);
+      priorityBoost = backlog;
+    }
+  #endif
+
+  #ifdef MOUNT_PRESENT
+    if (!batch) streamStatus();
+  #endif
+
+  // everything answered this pass goes out together
+  SerialPort.drain();
+}
+
+bool CommandProcessor::rxFill() {
+  rxPos = rxCount = 0;
+
+  // replayed commands arrive ahead of the port
+  #ifdef COMMAND_TRACE
+    rxCount = commandTrace.replayRead(channel, rxBlock, RX_BLOCK_SIZE);
+    if (rxCount > 0) return true;
+  #endif
+
+  int waiting = SerialPort.available();
+  if (waiting <= 0) return false;
+  rxCount = SerialPort.read((uint8_t*)rxBlock, waiting < RX_BLOCK_SIZE ? waiting : RX_BLOCK_SIZE);
+  #ifdef COMMAND_STATISTICS_ENABLE
+    statistics.bytesIn += rxCount;
+  #endif
+  #if SERIAL_EXPEDITE_PRIORITY != OFF
+    if (!expedite && rxExpedited()) setExpedite(true);
+  #endif
+  return rxCount > 0;
+}
+
+#if SERIAL_EXPEDITE_PRIORITY != OFF
+  // guide (:Mgx, :Me, :Mw, :Mn, :Ms), stop (:Q) and sync (:CS, :CM) commands, from the first two chars
+  static bool commandExpedited(const char *c) {
+    if (c[0] == 'Q') return true;
+    if (c[0] == 'M') return c[1] != 0 && strchr("gewns", c[1]) != NULL;
+    if (c[0] == 'C') return c[1] == 'S' || c[1] == 'M';
+    return false;
+  }
+
+  // true if a guide, stop or sync command is still waiting in rxBlock
+  bool CommandProcessor::rxExpedited() {
+    for (uint8_t i = rxPos; i < rxCount; i++) {
+      if (rxBlock[i] != ':') continue;
+      char c[3] = "";
+      if (i + 1 < rxCount) c[0] = rxBlock[i + 1];
+      if (i + 2 < rxCount) c[1] = rxBlock[i + 2];
+      if (commandExpedited(c)) return true;
+    }
+    return false;
+  }
+
+  // flag this channel while it holds such a command, the others give way to it
+  void CommandProcessor::setExpedite(bool state) {
+    if (state == expedite) return;
+    expedite = state;
+    if (state) expeditePending++; else expeditePending--;
+    if (taskHandle == 0) return;
+    #if SERIAL_BACKLOG_PRIORITY != OFF
+      if (!state && priorityBoost) { tasks.setPriority(taskHandle, SERIAL_BACKLOG_PRIORITY); return; }
     #endif
-    if (commandError != CE_NULL) {
-      lastCommandError = commandError;
-      #if DEBUG_ECHO_COMMANDS != OFF
-        if (commandError > CE_0) { DF(", Error "); D(commandErrorStr[commandError]); }
-      #endif
+    tasks.setPriority(taskHandle, state ? SERIAL_EXPEDITE_PRIORITY : 5);
+  }
+#endif
+
+// health counters shared by all the command channels
+static uint8_t commandsCounter = 0;
+static uint8_t commandErrorsCounter = 0;
+
+void CommandProcessor::process() {
+  char reply[80] = "";
+  bool numericReply = true;
+  bool supressFrame = false;
+
+  #ifdef COMMAND_TRACE
+    commandTrace.record(channel, buffer.getCmd(), buffer.getParameter());
+  #endif
+
+  // status polls don't count as activity, anything else wakes a parked mount from low power
+  #if defined(MOUNT_PRESENT) && PARK_LOW_POWER != OFF
+    if (buffer.getCmd()[0] != 'G') park.wake();
+  #endif
+
+  #ifdef COMMAND_STATISTICS_ENABLE
+    unsigned long startTime = micros();
+  #endif
+  commandError = command(reply, buffer.getCmd(), buffer.getParameter(), &supressFrame, &numericReply);
+  #ifdef COMMAND_STATISTICS_ENABLE
+    statisticsRecord(buffer.getCmd()[0], micros() - startTime);
+  #endif
+  counters.increment(commandsCounter);
+  if (commandError > CE_0 && commandError < CE_NULL) counters.increment(commandErrorsCounter);
+
+  if (numericReply) {
+    if (commandError != CE_NONE && commandError != CE_1) strcpy(reply,"0"); else strcpy(reply,"1");
+    supressFrame = true;
+  }
+  if (strlen(reply) > 0 || buffer.checksum) {
+    if (buffer.checksum) {
+      appendChecksum(reply);
+      strcat(reply, buffer.getSeq());
+      supressFrame = false;
+    }
+    if (!supressFrame) strcat(reply,"#");
+    if (batch) batchAppend(reply); else write(reply);
+  }
+
+  // debug, log errors and/or commands
+  #if DEBUG_ECHO_COMMANDS != OFF
+    if (DEBUG_ECHO_COMMANDS == ON || commandError > CE_0) {
+      DF("MSG: cmd"); D(channel); D(" = "); D(buffer.getCmd()); D(buffer.getParameter()); DF(", reply = "); D(reply);
     }
+  #endif
+  if (commandError != CE_NULL) {
+    lastCommandError = commandError;
     #if DEBUG_ECHO_COMMANDS != OFF
-      if (DEBUG_ECHO_COMMANDS == ON || commandError > CE_0) { DL(""); }
+      if (commandError > CE_0) { DF(", Error "); D(commandErrorStr[commandError]); }
     #endif
+  }
+  #if DEBUG_ECHO_COMMANDS != OFF
+    if (DEBUG_ECHO_COMMANDS == ON || commandError > CE_0) { DL(""); }
+  #endif
+
+  buffer.flush();
+}
+
+void CommandProcessor::write(const char *s) {
+  #ifdef COMMAND_STATISTICS_ENABLE
+    statistics.bytesOut += strlen(s);
+  #endif
+  SerialPort.write(s);
+}
+
+void CommandProcessor::write(const uint8_t *data, size_t count) {
+  #ifdef COMMAND_STATISTICS_ENABLE
+    statistics.bytesOut += count;
+  #endif
+  SerialPort.write(data, count);
+}
+
+#ifdef COMMAND_STATISTICS_ENABLE
+  void CommandProcessor::statisticsRecord(char commandClass, unsigned long runtime) {
+    statistics.commands++;
+    if (commandError > CE_0 && commandError < CE_NULL) statistics.errors++;
+    if (runtime > statistics.runtimeMax) statistics.runtimeMax = runtime;
+
+    const char *classes = COMMAND_CLASSES;
+    const char *found = commandClass ? strchr(classes, commandClass) : NULL;
+    uint8_t index = found ? found - classes : COMMAND_CLASS_COUNT - 1;
 
-    buffer.flush();
+    uint8_t bin = 0;
+    while (runtime >= 16 && bin < COMMAND_HISTOGRAM_BINS - 1) { runtime >>= 2; bin++; }
+    if (statistics.runtimeHistogram[index][bin] < 65535) statistics.runtimeHistogram[index][bin]++;
   }
+#endif
+
+void CommandProcessor::batchAppend(char *reply) {
+  if (strlen(batchReply) + strlen(reply) >= BATCH_REPLY_SIZE) { write(batchReply); batchReply[0] = 0; }
+  strcat(batchReply, reply);
+}
+
+#ifdef MOUNT_PRESENT
+  void CommandProcessor::setStreamPeriod(unsigned long period) {
+    streamPeriod = period;
+    streamLastTime = millis() - period;
+    streamLastHash = ~statusFrameHash;
+  }
+
+  void CommandProcessor::streamStatus() {
+    if (streamPeriod == 0 || !serialReady) return;
+    unsigned long now = millis();
+    if ((long)(now - streamLastTime) < (long)streamPeriod && streamEventCount == statusEventCount) return;
+    streamEventCount = statusEventCount;
+
+    statusFrameUpdate();
+    if (statusFrameHash == streamLastHash) return;
+
+    streamLastTime = now;
+    streamLastHash = statusFrameHash;
+    write(statusFrame);
+  }
+#endif
+
+CommandError commandLocal(char *reply, const char *command) {
+  char cmd[3] = "", parameter[40] = "";
+  if (*command == ':') command++;
+  size_t length = strlen(command);
+  if (length > 0 && command[length - 1] == '#') length--;
+  if (length < 1 || length > sizeof(parameter) + 1) { strcpy(reply, "0"); return CE_PARAM_FORM; }
+  cmd[0] = command[0];
+  if (length > 1) {
+    cmd[1] = command[1];
+    memcpy(parameter, &command[2], length - 2);
+    parameter[length - 2] = 0;
+  }
+
+  #ifdef MOUNT_PRESENT
+    if (cmd[0] != 'G') replyCacheClear();
+  #endif
+
+  reply[0] = 0;
+  bool supressFrame = false, numericReply = true;
+  CommandError e = CE_NONE;
+  if (!telescope.command(reply, cmd, parameter, &supressFrame, &numericReply, &e) && e == CE_NONE) e = CE_CMD_UNKNOWN;
+  if (numericReply) { if (e != CE_NONE && e != CE_1) strcpy(reply, "0"); else strcpy(reply, "1"); }
+  return e;
 }
 
 CommandError CommandProcessor::command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply) {
   commandError = CE_NONE;
 
+  #ifdef MOUNT_PRESENT
+    bool cacheable = replyCacheable(command, parameter);
+    if (cacheable) {
+      ReplyCacheEntry *entry = replyCacheFind(command, parameter);
+      if (entry != NULL) { strcpy(reply, entry->reply); *numericReply = false; return commandError; }
+    } else if (command[0] != 'G') replyCacheClear();
+  #endif
+
   // handle telescope commands
-  if (telescope.command(reply, command, parameter, supressFrame, numericReply, &commandError)) return commandError;
+  if (telescope.command(reply, command, parameter, supressFrame, numericReply, &commandError)) {
+    #ifdef MOUNT_PRESENT
+      if (cacheable && commandError == CE_NONE && !*numericReply && !*supressFrame) replyCachePut(command, parameter, reply);
+    #endif
+    return commandError;
+  }
 
   // silent bool "errors" allow processing commands more than once
   if (commandError == CE_0 || commandError == CE_1) return commandError;
@@ -183,28 +596,58 @@ CommandError CommandProcessor::command(char *reply, char *command, char *paramet
   //            Returns: 1 (at the current baud rate and then changes to the new rate for further communication)
   if (command[0] == 'S' && command[1] == 'B') {
     int rate = parameter[0] - '0';
-    if (parameter[0] == 'A') {
-      SerialPort.print("1");
-      tasks.yield(50);
-      SerialPort.begin(230400);
-      *numericReply = false;
-    } else
-    if (parameter[0] == 'B') {
-      SerialPort.print("1");
-      tasks.yield(50);
-      SerialPort.begin(460800);
-      *numericReply = false;
-    } else
-    if (rate >= 0 && rate <= 9) {
-      const static long baud[10] = {115200, 56700, 38400, 28800, 19200, 14400, 9600, 4800, 2400, 1200};
-      SerialPort.print("1");
-      tasks.yield(50);
-      SerialPort.begin(baud[rate]);
-      *numericReply = false;
+    const static long baud[10] = {115200, 56700, 38400, 28800, 19200, 14400, 9600, 4800, 2400, 1200};
+    if (parameter[0] == 'A') baudPending = 230400; else
+    if (parameter[0] == 'B') baudPending = 460800; else
+    if (rate >= 0 && rate <= 9) baudPending = baud[rate]; else commandError = CE_PARAM_RANGE;
+    // the change happens in poll() once the reply is out
+    baudChangeTime = millis() + 50;
+    return commandError;
+  } else
+
+  // :SXCM,B#   Set command mode for this channel to binary frames, see BinaryProtocol.h
+  //            Returns: 1 (as ASCII and then only binary frames are accepted)
+  if (command[0] == 'S' && command[1] == 'X' && parameter[0] == 'C' && parameter[1] == 'M' && parameter[2] == ',') {
+    if (parameter[3] == 'B' && parameter[4] == 0) {
+      binaryBuffer.flush();
+      binaryMode = true;
     } else commandError = CE_PARAM_RANGE;
     return commandError;
   } else
 
+  #ifdef COMMAND_STATISTICS_ENABLE
+    // :GXCS[c]#  Get statistics for command channel [c], A to D, S (ST4), T (BT), 1 to 3 (PIP), I (IP), or L (local)
+    //            Returns: commands,errors,bytes in,bytes out,max runtime# (runtime in microseconds)
+    // :GXCH[c][k]#  Get runtime histogram for command class [k] on channel [c], 0 to 7 for G, S, M, Q, R, T, C, others
+    //            Returns: n0,n1,...n7# counts for times of <16us,<64us,<256us... each bin x4, the last >= 262144us
+    if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'C' && (parameter[1] == 'S' || parameter[1] == 'H') && parameter[2] != 0) {
+      CommandProcessor *processor = commandProcessor(parameter[2]);
+      if (processor == NULL) { commandError = CE_PARAM_RANGE; return commandError; }
+      CommandStatistics *s = &processor->statistics;
+      Formatter f(reply, 80);
+      if (parameter[1] == 'S' && parameter[3] == 0) {
+        f.uint(s->commands).chr(',').uint(s->errors).chr(',').uint(s->bytesIn).chr(',').uint(s->bytesOut).chr(',').uint(s->runtimeMax);
+      } else
+      if (parameter[1] == 'H' && parameter[3] >= '0' && parameter[3] < '0' + COMMAND_CLASS_COUNT && parameter[4] == 0) {
+        uint8_t index = parameter[3] - '0';
+        for (uint8_t bin = 0; bin < COMMAND_HISTOGRAM_BINS; bin++) {
+          if (bin > 0) f.chr(',');
+          f.uint(s->runtimeHistogram[index][bin]);
+        }
+      } else { commandError = CE_CMD_UNKNOWN; return commandError; }
+      *numericReply = false;
+      return commandError;
+    } else
+
+    // :SXCZ,[c]# Zero statistics for command channel [c]
+    //            Returns: 0 failure, 1 success
+    if (command[0] == 'S' && command[1] == 'X' && parameter[0] == 'C' && parameter[1] == 'Z' && parameter[2] == ',' && parameter[4] == 0) {
+      CommandProcessor *processor = commandProcessor(parameter[3]);
+      if (processor == NULL) commandError = CE_PARAM_RANGE; else memset(&processor->statistics, 0, sizeof(CommandStatistics));
+      return commandError;
+    } else
+  #endif
+
   // :GX9F#     Get internal MCU temperature in deg. C
   //            Returns: +/-n.n
   if (command[0] == 'G' && command[1] == 'X' && parameter[0] == '9' && parameter[1] == 'F' && parameter[2] == 0) {
@@ -219,10 +662,280 @@ CommandError CommandProcessor::command(char *reply, char *command, char *paramet
     return commandError;
   } else
 
+  // :GXRSn#    Get static RAM used by subsystem n (from 1), or by all static data if n is 0
+  //            Returns: name,bytes# or 0# if there is no such subsystem
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'R' && parameter[1] == 'S' && parameter[2] != 0) {
+    char *conv_end;
+    long index = strtol(&parameter[2], &conv_end, 10);
+    if (&parameter[2] == conv_end || *conv_end != 0) { commandError = CE_PARAM_FORM; return commandError; }
+    const char *name = NULL;
+    uint32_t bytes = 0;
+    switch (index) {
+      case 0: name = "All"; bytes = memory.getStaticBytes(); break;
+      case 1: name = "Telescope"; bytes = sizeof(telescope); break;
+      case 2: name = "NV"; bytes = sizeof(nv); break;
+      case 3: name = "Tasks"; bytes = sizeof(tasks); break;
+      #ifdef MOUNT_PRESENT
+        case 4: name = "Mount"; bytes = sizeof(mount) + sizeof(axis1) + sizeof(axis2) + sizeof(transform); break;
+        case 5: name = "Goto"; bytes = sizeof(goTo); break;
+        case 6: name = "Guide"; bytes = sizeof(guide); break;
+        case 7: name = "Library"; bytes = sizeof(library) + library.getIndexBytes(); break;
+        case 8: name = "Limits"; bytes = sizeof(limits); break;
+        case 9: name = "Pec"; bytes = sizeof(pec); break;
+        case 10: name = "Site"; bytes = sizeof(site); break;
+        #ifdef FOCUSER_PRESENT
+          case 11: name = "Focuser"; bytes = sizeof(focuser) + FOCUSER_MAX*sizeof(Axis); break;
+        #endif
+        #ifdef ROTATOR_PRESENT
+          case 12: name = "Rotator"; bytes = sizeof(rotator) + sizeof(axis3); break;
+        #endif
+      #endif
+    }
+    if (name == NULL) { commandError = CE_0; return commandError; }
+    sprintf(reply, "%s,%lu", name, (unsigned long)bytes);
+    *numericReply = false;
+    return commandError;
+  } else
+
+  // :GXRH#     Get heap usage
+  //            Returns: used,free,largest free block,lowest free# in bytes (lowest free is 0 where unknown)
+  //            free much above the largest block shows fragmentation, a falling free after the same operation a leak
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'R' && parameter[1] == 'H' && parameter[2] == 0) {
+    sprintf(reply, "%lu,%lu,%lu,%lu", (unsigned long)memory.getHeapUsed(), (unsigned long)memory.getHeapFree(),
+                   (unsigned long)memory.getHeapLargestFree(), (unsigned long)memory.getHeapFreeMin());
+    *numericReply = false;
+    return commandError;
+  } else
+
+  // :GXRK#     Get stack high-water marks
+  //            Returns: main most used,main least free[,OnTask least free]# in bytes, the last on ESP32 when tasks run on
+  //            the other core
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'R' && parameter[1] == 'K' && parameter[2] == 0) {
+    sprintf(reply, "%lu,%lu", (unsigned long)memory.getStackUsedMax(), (unsigned long)memory.getStackFreeMin());
+    #ifdef ESP32
+      long coreTaskFree = memory.getTaskStackFreeMin("OnTask");
+      if (coreTaskFree >= 0) sprintf(&reply[strlen(reply)], ",%ld", coreTaskFree);
+    #endif
+    *numericReply = false;
+    return commandError;
+  } else
+
+  // :GXRC#     Get cache sizes
+  //            Returns: NV cache,PEC buffer# in bytes of heap
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'R' && parameter[1] == 'C' && parameter[2] == 0) {
+    #ifdef MOUNT_PRESENT
+      long pecBytes = pec.getBufferBytes();
+    #else
+      long pecBytes = 0;
+    #endif
+    sprintf(reply, "%lu,%ld", (unsigned long)nv.getCacheBytes(), pecBytes);
+    *numericReply = false;
+    return commandError;
+  } else
+
+  // :GXRPn#    Get placement of hot path function n (from 0), with HOT_PATH_IRAM ON (ESP32)
+  //            Returns: name,IRAM# or name,FLASH# (FLASH means the function wasn't linked into IRAM) or 0# if there is no such entry
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'R' && parameter[1] == 'P' && parameter[2] != 0) {
+    char *conv_end;
+    long index = strtol(&parameter[2], &conv_end, 10);
+    if (&parameter[2] == conv_end || *conv_end != 0 || index < 0 || index > 255) { commandError = CE_PARAM_FORM; return commandError; }
+    #ifdef MEMORY_PLACEMENT_MAX
+      const char *name;
+      bool inIram;
+      if (!memory.getPlacement(index, &name, &inIram)) { commandError = CE_0; return commandError; }
+      sprintf(reply, "%s,%s", name, inIram ? "IRAM" : "FLASH");
+      *numericReply = false;
+    #else
+      commandError = CE_0;
+    #endif
+    return commandError;
+  } else
+
+  // :GXN#      Get health counters
+  // :GXNn#     Get health counters starting at n (from 0)
+  //            Returns: v0,v1,...# in hex, ending ;m if more follow starting at m, or 0# if there is no such counter
+  // :GXNNn#    Get name of counter n (from 0)
+  //            Returns: name,C# for a counter or name,G# for a gauge or 0# if there is no such counter
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'N') {
+    bool nameRequest = parameter[1] == 'N';
+    char *start = &parameter[nameRequest ? 2 : 1];
+    long index = 0;
+    if (*start != 0 || nameRequest) {
+      char *conv_end;
+      index = strtol(start, &conv_end, 10);
+      if (start == conv_end || *conv_end != 0) { commandError = CE_PARAM_FORM; return commandError; }
+    }
+    if (index < 0 || index >= counters.getCount()) { commandError = CE_0; return commandError; }
+    if (nameRequest) {
+      const char *name;
+      CounterType type;
+      counters.getInfo(index, &name, &type);
+      sprintf(reply, "%s,%c", name, type == CT_GAUGE ? 'G' : 'C');
+    } else {
+      // up to 8 hex digits and a comma each, leave room for the ;m and the frame
+      reply[0] = 0;
+      char *end = reply;
+      while (index < counters.getCount() && end - reply < 80 - 16) {
+        if (end != reply) *end++ = ',';
+        end += sprintf(end, "%lx", (unsigned long)counters.get(index + 1));
+        index++;
+      }
+      if (index < counters.getCount()) sprintf(end, ";%ld", index);
+    }
+    *numericReply = false;
+    return commandError;
+  } else
+
+  // :GXI#      Get startup time
+  //            Returns: ms,n# the time from power up until ready and the number of phases timed
+  // :GXIn#     Get startup phase n (from 0)
+  //            Returns: name,ms# or 0# if there is no such phase
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'I') {
+    if (parameter[1] == 0) {
+      sprintf(reply, "%lu,%u", bootTime.getTotal(), (unsigned int)bootTime.getCount());
+    } else {
+      char *conv_end;
+      long index = strtol(&parameter[1], &conv_end, 10);
+      if (&parameter[1] == conv_end || *conv_end != 0) { commandError = CE_PARAM_FORM; return commandError; }
+      const char *name;
+      unsigned long ms;
+      if (index < 0 || index > 255 || !bootTime.getPhase(index, &name, &ms)) { commandError = CE_0; return commandError; }
+      sprintf(reply, "%s,%lu", name, ms);
+    }
+    *numericReply = false;
+    return commandError;
+  } else
+
+  #ifdef TASKS_STATISTICS_ENABLE
+    // :GXTNnn#   Get name of task with handle nn (1 to TASKS_MAX)
+    //            Returns: s# or 0# if there is no such task
+    // :GXTSnn#   Get statistics for task with handle nn
+    //            Returns: polls,missed periods,max lateness,max runtime# (times in microseconds)
+    // :GXTLnn#   Get arrival lateness histogram for task with handle nn
+    // :GXTRnn#   Get runtime histogram for task with handle nn
+    //            Returns: n0,n1,...n7# counts for times of <16us,<64us,<256us... each bin x4, the last >= 262144us
+    if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'T' && strchr("NSLR", parameter[1]) && parameter[2] != 0) {
+      char *conv_end;
+      long handle = strtol(&parameter[2], &conv_end, 10);
+      if (&parameter[2] == conv_end || *conv_end != 0) { commandError = CE_PARAM_FORM; return commandError; }
+      if (handle < 1 || handle > TASKS_MAX) { commandError = CE_PARAM_RANGE; return commandError; }
+      if (tasks.getNextHandle(handle - 1) != handle) { commandError = CE_0; return commandError; }
+      switch (parameter[1]) {
+        case 'N': strcpy(reply, tasks.getNameStr(handle)); break;
+        case 'S':
+          sprintf(reply, "%lu,%lu,%lu,%lu", tasks.getPollCount(handle), tasks.getMissCount(handle),
+                         tasks.getLatenessMax(handle), tasks.getRuntimeMaxMicros(handle));
+        break;
+        case 'L': case 'R':
+          reply[0] = 0;
+          for (uint8_t bin = 0; bin < TASKS_HISTOGRAM_BINS; bin++) {
+            uint16_t count = parameter[1] == 'L' ? tasks.getLatenessHistogram(handle, bin) : tasks.getRuntimeHistogram(handle, bin);
+            sprintf(&reply[strlen(reply)], bin == 0 ? "%u" : ",%u", (unsigned int)count);
+          }
+        break;
+      }
+      *numericReply = false;
+      return commandError;
+    } else
+
+    // :SXTZ,nn#  Zero statistics for task with handle nn, or for all tasks if nn is 0
+    //            Returns: 0 failure, 1 success
+    if (command[0] == 'S' && command[1] == 'X' && parameter[0] == 'T' && parameter[1] == 'Z' && parameter[2] == ',') {
+      char *conv_end;
+      long handle = strtol(&parameter[3], &conv_end, 10);
+      if (&parameter[3] == conv_end || *conv_end != 0) commandError = CE_PARAM_FORM; else
+      if (handle < 0 || handle > TASKS_MAX) commandError = CE_PARAM_RANGE; else tasks.clearStatistics(handle);
+      return commandError;
+    } else
+  #endif
+
+  #ifdef COMMAND_TRACE
+    // :GXJ#      Get command trace status
+    //            Returns: s,records,dropped,replayed,skipped,max lateness,average lateness# where s is 0 idle, 1 capturing,
+    //            or 2 replaying and lateness (in ms) is how long after it was due each replayed command was taken up
+    if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'J' && parameter[1] == 0) {
+      CommandTrace *t = &commandTrace;
+      Formatter f(reply, 80);
+      f.uint(t->state).chr(',').uint(t->records()).chr(',').uint(t->dropped).chr(',').uint(t->replayed).chr(',').uint(t->skipped);
+      f.chr(',').uint(t->latenessMax).chr(',').uint(t->replayed ? t->latenessTotal/t->replayed : 0);
+      *numericReply = false;
+      return commandError;
+    } else
+
+    // :SXJC,n#   Command trace capture, 1 to start (clearing any records held) or 0 to stop
+    // :SXJP,n#   Command trace replay, 1 to start or 0 to stop, the task and command statistics are cleared at the start
+    //            so they cover just the replay
+    //            Returns: 0 failure, 1 success
+    if (command[0] == 'S' && command[1] == 'X' && parameter[0] == 'J' && (parameter[1] == 'C' || parameter[1] == 'P') && parameter[2] == ',') {
+      if ((parameter[3] != '0' && parameter[3] != '1') || parameter[4] != 0) { commandError = CE_PARAM_RANGE; return commandError; }
+      commandTrace.stop();
+      if (parameter[3] == '1') {
+        if (parameter[1] == 'C') commandTrace.capture(); else {
+          if (!commandTrace.replay()) { commandError = CE_0; return commandError; }
+          #ifdef TASKS_STATISTICS_ENABLE
+            tasks.clearStatistics(0);
+          #endif
+          #ifdef COMMAND_STATISTICS_ENABLE
+            for (const char *c = "ABCDST123IWL"; *c; c++) {
+              CommandProcessor *processor = commandProcessor(*c);
+              if (processor != NULL) memset(&processor->statistics, 0, sizeof(processor->statistics));
+            }
+          #endif
+        }
+      }
+      return commandError;
+    } else
+  #endif
+
+  #ifdef TASKS_BUDGET_ENABLE
+    // :GXTPn#    Get load of plugin n (1 to 8)
+    //            Returns: name,tasks,load %,max runtime,budget overruns# (runtime in microseconds) or 0# if not present
+    if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'T' && parameter[1] == 'P' && parameter[2] >= '1' && parameter[2] <= '8' && parameter[3] == 0) {
+      char *name;
+      uint8_t taskCount;
+      float load;
+      unsigned long runtimeMax, overruns;
+      if (pluginLoad.get(parameter[2] - '0', &name, &taskCount, &load, &runtimeMax, &overruns)) {
+        sprintf(reply, "%s,%u,", name, (unsigned int)taskCount);
+        sprintF(&reply[strlen(reply)], "%1.1f", load);
+        sprintf(&reply[strlen(reply)], ",%lu,%lu", runtimeMax, overruns);
+        *numericReply = false;
+      } else commandError = CE_0;
+      return commandError;
+    } else
+  #endif
+
+  #ifdef MOUNT_PRESENT
+    // :GXPS#     Get status streaming period for this channel
+    //            Returns: n# (in ms, 0 if not subscribed)
+    if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'P' && parameter[1] == 'S' && parameter[2] == 0) {
+      sprintf(reply, "%lu", streamPeriod);
+      *numericReply = false;
+      return commandError;
+    } else
+
+    // :SXPS,n#   Subscribe this channel to status frames, sent at most every n ms (100 to 60000) and only on change
+    //            or 0 to unsubscribe.  Frames are: @RA,Dec,Alt,Azm,s# with RA in hours, the others in degrees
+    //            and s as returned by :GU#, followed by ,Fm for the focusers and ,Rm for the rotator (when present)
+    //            with m [M]oving or [S]topped and settled for each, and ,Gooss for the SWS GPIO output mask
+    //            and states in hex, and ,Dzzz.z,ttt.t,r.rrrr for the dome azimuth (see :GXDZ#.)  An axis starting,
+    //            stopping, reaching its target, settling, or faulting sends the frame right away
+    //            Returns: 0 failure, 1 success
+    if (command[0] == 'S' && command[1] == 'X' && parameter[0] == 'P' && parameter[1] == 'S' && parameter[2] == ',') {
+      char *conv_end;
+      long period = strtol(&parameter[3], &conv_end, 10);
+      if (&parameter[3] == conv_end || *conv_end != 0) commandError = CE_PARAM_FORM; else
+      if (period != 0 && (period < STATUS_STREAM_PERIOD_MIN || period > STATUS_STREAM_PERIOD_MAX)) commandError = CE_PARAM_RANGE; else {
+        setStreamPeriod(period);
+      }
+      return commandError;
+    } else
+  #endif
+
   // :GE#       Get last command error numeric code
   //            Returns: CC#
   if (command[0] == 'G' && command[1] == 'E' && parameter[0] == 0) {
-    sprintf(reply, "%02d", lastCommandError);
+    Formatter(reply, 3).uint(lastCommandError, 2);
     *numericReply = false;
     return commandError;
   } else
@@ -231,10 +944,10 @@ CommandError CommandProcessor::command(char *reply, char *command, char *paramet
 }
 
 void CommandProcessor::appendChecksum(char *s) {
-  char HEXS[3] = "";
-  uint8_t cks = 0; for (unsigned int cksCount0 = 0; cksCount0 < strlen(s); cksCount0++) { cks += s[cksCount0]; }
-  sprintf(HEXS, "%02X", cks);
-  strcat(s, HEXS);
+  uint8_t cks = 0;
+  char *end = s;
+  while (*end) cks += *end++;
+  Formatter(end, 3).hex(cks, 2);
 }
 
 void commandChannelInit() {
@@ -242,6 +955,13 @@ void commandChannelInit() {
   // add tasks to process commands
   // period ms (0=idle), duration ms (0=forever), repeat, priority (highest 0..7 lowest), task_handle
   uint8_t handle;
+  commandsCounter = counters.add("Cmds");
+  commandErrorsCounter = counters.add("CmdErrs");
+
+  #ifdef MOUNT_PRESENT
+    Axis::onEvent(statusAxisEvent);
+  #endif
+
   #ifdef HAL_SLOW_PROCESSOR
     long comPollRate = 5000;
   #else
@@ -252,60 +972,80 @@ void commandChannelInit() {
     handle = tasks.add(0, 0, true, 5, processCmdsA, "CmdA");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsA.setTaskHandle(handle);
   #endif
   #ifdef SERIAL_B
     VF("MSG: Setup, start command channel B task (priority 5)... ");
     handle = tasks.add(0, 0, true, 5, processCmdsB, "CmdB");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsB.setTaskHandle(handle);
   #endif
   #ifdef SERIAL_C
     VF("MSG: Setup, start command channel C task (priority 5)... ");
     handle = tasks.add(0, 0, true, 5, processCmdsC, "CmdC");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsC.setTaskHandle(handle);
   #endif
   #ifdef SERIAL_D
     VF("MSG: Setup, start command channel D task (priority 5)... ");
     handle = tasks.add(0, 0, true, 5, processCmdsD, "CmdD");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsD.setTaskHandle(handle);
   #endif
   #ifdef SERIAL_ST4
     VF("MSG: Setup, start command channel ST4 task (priority 5)... ");
     handle = tasks.add(0, 0, true, 5, processCmdsST4, "CmdS");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate*4);
+    processCommandsST4.setTaskHandle(handle);
   #endif
   #if SERIAL_BT_MODE == SLAVE
     VF("MSG: Setup, start command channel BT task (priority 5)... ");
     handle = tasks.add(0, 0, true, 5, processCmdsBT, "CmdT");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsBT.setTaskHandle(handle);
+    #if defined(MOUNT_PRESENT) && SERIAL_BT_STATUS_STREAM != OFF
+      processCommandsBT.setStreamPeriod(SERIAL_BT_STATUS_STREAM);
+    #endif
   #endif
   #ifdef SERIAL_PIP1
     VF("MSG: Setup, start command channel PIP1 task (priority 5)... ");
     handle = tasks.add(0, 0, true, 5, processCmdsPIP1, "CmdP1");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsPIP1.setTaskHandle(handle);
   #endif
   #ifdef SERIAL_PIP2
     VF("MSG: Setup, start command channel PIP2 task (priority 5)... ");
     handle = tasks.add(0, 0, true, 5, processCmdsPIP2, "CmdP2");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsPIP2.setTaskHandle(handle);
   #endif
   #ifdef SERIAL_PIP3
     VF("MSG: Setup, start command channel PIP3 task (priority 5)... ");
     handle = tasks.add(0, 0, true, 5, processCmdsPIP3, "CmdP3");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsPIP3.setTaskHandle(handle);
   #endif
   #ifdef SERIAL_SIP
     VF("MSG: Setup, start command channel IP task (priority 5)... ");
     handle = tasks.add(0, 0, true, 5, processCmdsIP, "CmdI");
     if (handle) { VLF("success"); } else { VLF("FAILED!"); }
     tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsIP.setTaskHandle(handle);
+  #endif
+  #ifdef SERIAL_WS
+    VF("MSG: Setup, start command channel WebSocket task (priority 5)... ");
+    handle = tasks.add(0, 0, true, 5, processCmdsWS, "CmdW");
+    if (handle) { VLF("success"); } else { VLF("FAILED!"); }
+    tasks.setPeriodMicros(handle, comPollRate);
+    processCommandsWS.setTaskHandle(handle);
   #endif
   #ifdef SERIAL_LOCAL
     VF("MSG: Setup, start command channel Local task (priority 5)... ");
@@ -4,9 +4,34 @@
 
 #include <Arduino.h>
 #include "../../lib/commands/BufferCmds.h"
+#include "../../lib/commands/BinaryCmds.h"
 #include "../../lib/commands/SerialWrapper.h"
 #include "../../lib/commands/CommandErrors.h"
 
+#define BATCH_REPLY_SIZE 256
+#if SERIAL_BT_MODE == SLAVE && SERIAL_BT_THROUGHPUT == ON
+  #define RX_BLOCK_SIZE  128
+#else
+  #define RX_BLOCK_SIZE  64
+#endif
+
+#ifdef COMMAND_STATISTICS_ENABLE
+  // processing time histograms by command class (the first command char), anything not listed is in the last class
+  #define COMMAND_CLASSES "GSMQRTC"
+  #define COMMAND_CLASS_COUNT 8
+  // histogram bins are in microseconds, bin0 < 16, bin1 < 64, bin2 < 256, ... bin7 >= 262144 (x4 per bin)
+  #define COMMAND_HISTOGRAM_BINS 8
+
+  typedef struct CommandStatistics {
+    unsigned long commands;
+    unsigned long errors;
+    unsigned long bytesIn;
+    unsigned long bytesOut;
+    unsigned long runtimeMax;
+    uint16_t runtimeHistogram[COMMAND_CLASS_COUNT][COMMAND_HISTOGRAM_BINS];
+  } CommandStatistics;
+#endif
+
 class CommandProcessor {
   public:
     // start and stop the serial port for the associated command channel
@@ -16,21 +41,108 @@ class CommandProcessor {
     // check for incomming commands and send responses
     void poll();
 
+    // the handle of the task polling this channel
+    inline void setTaskHandle(uint8_t handle) { taskHandle = handle; }
+
+    #ifdef MOUNT_PRESENT
+      // subscribe to status frames every period ms, 0 to unsubscribe
+      void setStreamPeriod(unsigned long period);
+    #endif
+
     // pass along commands as required for processing
     CommandError command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply);
 
+    #ifdef COMMAND_STATISTICS_ENABLE
+      CommandStatistics statistics;
+    #endif
+
   private:
+    // read the next block of waiting chars into rxBlock, returns false if there were none
+    bool rxFill();
+
+    #if SERIAL_EXPEDITE_PRIORITY != OFF
+      // true if a guide, stop or sync command is still waiting in rxBlock
+      bool rxExpedited();
+
+      // flag this channel while it holds such a command, the others give way to it
+      void setExpedite(bool state);
+    #endif
+
+    // true while this channel holds a guide, stop or sync command
+    inline bool expediting() {
+      #if SERIAL_EXPEDITE_PRIORITY != OFF
+        return expedite;
+      #else
+        return false;
+      #endif
+    }
+
+    // process the command in the buffer and send or batch the reply
+    void process();
+
+    // add a reply to the batch, sending what's already there first if it won't fit
+    void batchAppend(char *reply);
+
     void logErrors(char *cmd, char *param, char *reply, CommandError e);
     void appendChecksum(char *s);
 
+    // write to the serial port, counting the bytes sent
+    void write(const char *s);
+    void write(const uint8_t *data, size_t count);
+
+    #ifdef COMMAND_STATISTICS_ENABLE
+      // count a command and add its runtime to the histogram for its class
+      void statisticsRecord(char commandClass, unsigned long runtime);
+    #endif
+
+    // check for an incomming binary frame and send the response frame
+    void binaryPoll();
+
+    // process the frame in the binary buffer and send the response frame
+    void binaryProcess();
+
+    // process a binary request, the response payload is appended after the command error
+    CommandError binaryCommand(uint8_t op, uint8_t *payload, uint8_t length, uint8_t *response, uint8_t *responseLength);
+    #ifdef MOUNT_PRESENT
+      // push the shared status frame to this channel if subscribed, it's due, and has changed
+      void streamStatus();
+    #endif
+
     CommandError commandError      = CE_NONE;
     CommandError lastCommandError  = CE_NONE;
     bool serialReady               = false;
+    bool serialStarting            = false;
+    unsigned long serialBeginTime  = 0;
     long serialBaud                = 9600;
+    long baudPending               = 0;
+    unsigned long baudChangeTime   = 0;
     char channel                   = '?';
+    bool binaryMode                = false;
+    bool batch                     = false;
+    uint8_t taskHandle             = 0;
+    bool priorityBoost             = false;
+    #if SERIAL_EXPEDITE_PRIORITY != OFF
+      bool expedite                = false;
+    #endif
+    char batchReply[BATCH_REPLY_SIZE] = "";
+    #ifdef MOUNT_PRESENT
+      unsigned long streamPeriod     = 0;  // in ms, 0 if not subscribed
+      unsigned long streamLastTime   = 0;
+      uint16_t streamLastHash        = 0;
+      uint8_t streamEventCount       = 0;  // axis motion events seen, each pushes the frame right away
+    #endif
+
+    char rxBlock[RX_BLOCK_SIZE];
+    uint8_t rxPos                  = 0;
+    uint8_t rxCount                = 0;
 
     Buffer buffer;
+    BinaryBuffer binaryBuffer;
     SerialWrapper SerialPort;
 };
 
 extern void commandChannelInit();
+
+// process one command (like ":GR#", the ':' and '#' are optional) without a command channel, for the IP device APIs
+// the reply is what a command channel would send less the trailing '#', numeric replies are "0" or "1"
+extern CommandError commandLocal(char *reply, const char *command);
@@ -8,8 +8,11 @@
 #include "../../lib/tasks/OnTask.h"
 
 #include "../../lib/1wire/1Wire.h"
-#include <DallasTemperature.h>        // my Dallas Temperature library https://github.com/hjd1964/Arduino-DS1820-Temperature-Library
-DallasTemperature DS18X20(&oneWire);
+
+#define DS1820_CONVERT_T         0x44
+#define DS1820_READ_SCRATCHPAD   0xBE
+#define DS1820_WRITE_SCRATCHPAD  0x4E
+#define DS1820_CONFIGURATION     (((DS1820_RESOLUTION - 9) << 5) | 0x1F)
 
 #include "../weather/Weather.h"
 
@@ -75,38 +78,33 @@ bool Ds1820::init() {
 
   VLF("*********************************************");
 
-  DS18X20.setWaitForConversion(false);
+  // the wait for each conversion is set by the slowest device, reading them once here sets the resolution
+  conversionTime = 750 >> (12 - DS1820_RESOLUTION);
+  for (int i = 0; i < 9; i++) {
+    if (address[i][0] == 0x10) conversionTime = 750;
+    if (address[i][0] == 0x28) readTemperature(address[i]);
+  }
+
   if (deviceCount > 0) {
     found = true;
-    VF("MSG: Temperature, start DS1820 monitor task (rate 250ms priority 7)... ");
-    if (tasks.add(250, 0, true, 7, ds1820Wrapper, "ds1820")) { VLF("success"); } else { VLF("FAILED!"); }
+    VF("MSG: Temperature, start DS1820 monitor task (rate "); V(conversionTime + 50); VF("ms priority 7)... ");
+    if (tasks.add(conversionTime + 50, 0, true, 7, ds1820Wrapper, "ds1820")) { VLF("success"); } else { VLF("FAILED!"); }
   } else found = false;
 
   initialized = true;
   return found;
 }
 
-// read devices
+// read all devices from the last conversion and start the next
 void Ds1820::poll() {
-  static int index = -1;
-  static unsigned long requestTime = 0;
+  if (!found) return;
 
-  if (found) {
-    if (index < 0) { requestTime = millis(); if (DS18X20.requestTemperatures(true)) index++; }
-    if ((long)(millis() - requestTime) < 200) return;
+  // the task period covers the conversion time so all the devices are ready
+  if (converting) {
+    for (int index = 0; index < 9; index++) {
+      if (device[index] == (uint64_t)OFF) continue;
 
-    if (device[index] != (uint64_t)OFF) {
-      // loop to read the temperature
-      // tasks.yield() during the 1-wire command sequence is ok since:
-      //   1. only higher priority level tasks are allowed to run during a yield 
-      //   2. all 1-wire task polling is run at the lowest priority level
-      float rawTemperature = NAN;
-      for (int i = 0; i < 22; i++) {
-        rawTemperature = DS18X20.getTempC(address[index], true);
-        if (polling(rawTemperature)) tasks.yield(2); else break;
-      }
-
-      float temperature = validated(rawTemperature);
+      float temperature = validated(readTemperature(address[index]));
       if (!isnan(temperature)) {
         if (isnan(averageTemperature[index])) averageTemperature[index] = temperature;
         averageTemperature[index] = (averageTemperature[index]*9.0F + temperature)/10.0F;
@@ -115,10 +113,61 @@ void Ds1820::poll() {
         // we must get a reading at least once every 30 seconds otherwise flag the failure with a NAN
         if ((long)(millis() - goodUntil[index]) > 0) averageTemperature[index] = NAN;
       }
+
+      // tasks.yield() between devices is ok since:
+      //   1. only higher priority level tasks are allowed to run during a yield 
+      //   2. all 1-wire task polling is run at the lowest priority level
+      Y;
     }
   }
-  index++;
-  if (index > 8) index = -1;
+
+  converting = startConversion();
+}
+
+// start a conversion on all devices at once, false if no device answered
+bool Ds1820::startConversion() {
+  if (!oneWire.reset()) return false;
+  oneWire.skip();
+  oneWire.write(DS1820_CONVERT_T);
+  return true;
+}
+
+// read a device's scratchpad, returns the temperature in deg. C or NAN on failure
+float Ds1820::readTemperature(const uint8_t *address) {
+  if (address[0] != 0x10 && address[0] != 0x28) return NAN;
+
+  uint8_t data[9];
+  if (!oneWire.reset()) return NAN;
+  oneWire.select(address);
+  oneWire.write(DS1820_READ_SCRATCHPAD);
+  for (int i = 0; i < 9; i++) data[i] = oneWire.read();
+  if (oneWire.crc8(data, 8) != data[8]) return NAN;
+
+  int16_t raw = (data[1] << 8) | data[0];
+  if (address[0] == 0x10) {
+    // DS18S20, 9 bits extended using the count remaining
+    raw = raw << 3;
+    if (data[7] == 0x10) raw = (raw & 0xFFF0) + 12 - data[6];
+  } else {
+    // DS18B20, a device that lost power comes back at its default resolution
+    if (data[4] != DS1820_CONFIGURATION) setResolution(address, data);
+    switch ((data[4] >> 5) & 0x03) {
+      case 0: raw &= ~7; break;
+      case 1: raw &= ~3; break;
+      case 2: raw &= ~1; break;
+    }
+  }
+  return raw/16.0F;
+}
+
+// write the resolution into a DS18B20's scratchpad (data holds the scratchpad as read)
+void Ds1820::setResolution(const uint8_t *address, const uint8_t *data) {
+  if (!oneWire.reset()) return;
+  oneWire.select(address);
+  oneWire.write(DS1820_WRITE_SCRATCHPAD);
+  oneWire.write(data[2]);
+  oneWire.write(data[3]);
+  oneWire.write(DS1820_CONFIGURATION);
 }
 
 // nine temperature sensors are supported, this gets the averaged temperature
@@ -133,14 +182,9 @@ float Ds1820::getChannel(int index) {
   } else return NAN;
 }
 
-// checks for polling status code from DS1820 library
-bool Ds1820::polling(float f) {
-  return (fabs(f - DEVICE_POLLING_C) < 0.001F);
-}
-
-// checks for validated status code from DS1820 library
+// checks for a reading in range, this also drops the 85 deg. C power on value
 float Ds1820::validated(float f) {
-  if (fabs(f - DEVICE_DISCONNECTED_C) < 0.001F) return NAN;
+  if (isnan(f)) return NAN;
   if (f < -100 || f > 70) return NAN;
   return f;
 }
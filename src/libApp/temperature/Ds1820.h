@@ -6,12 +6,20 @@
 
 #ifdef DS1820_DEVICES_PRESENT
 
+// DS18B20 conversion resolution in bits, 9 (94ms) to 12 (750ms), DS18S20's always take 750ms
+#ifndef DS1820_RESOLUTION
+  #define DS1820_RESOLUTION 12
+#endif
+#if DS1820_RESOLUTION < 9 || DS1820_RESOLUTION > 12
+  #error "Configuration (Config.h): Setting DS1820_RESOLUTION unknown, use 9 to 12 (bits.)"
+#endif
+
 class Ds1820 {
   public:
     // scan for DS18B20 devices on the 1-wire bus and prepare for operation
     bool init();
 
-    // read devices
+    // read all devices from the last conversion and start the next
     void poll();
 
     // nine temperature sensors are supported, this gets the averaged
@@ -22,13 +30,21 @@ class Ds1820 {
     float getChannel(int index);
    
   private:
-    // checks for polling status code from DS1820 library
-    bool polling(float f);
+    // start a conversion on all devices at once, false if no device answered
+    bool startConversion();
+
+    // read a device's scratchpad, returns the temperature in deg. C or NAN on failure
+    float readTemperature(const uint8_t *address);
+
+    // write the resolution into a DS18B20's scratchpad (data holds the scratchpad as read)
+    void setResolution(const uint8_t *address, const uint8_t *data);
 
-    // checks for validated status code from DS1820 library
+    // checks for a reading in range
     float validated(float f);
 
     bool found = false;
+    bool converting = false;
+    uint16_t conversionTime = 750; // in ms
     uint8_t deviceCount = 0;
     uint8_t address[9][8];
     uint64_t device[9] = { (uint64_t)FOCUSER_TEMPERATURE, (uint64_t)FEATURE1_TEMP, (uint64_t)FEATURE2_TEMP, (uint64_t)FEATURE3_TEMP, (uint64_t)FEATURE4_TEMP, (uint64_t)FEATURE5_TEMP, (uint64_t)FEATURE6_TEMP, (uint64_t)FEATURE7_TEMP, (uint64_t)FEATURE8_TEMP };
@@ -45,22 +45,22 @@ bool Weather::init() {
     success = false;
     #if WEATHER == BME280 || WEATHER == BME280_0x76
       if (bmx.begin(BME_ADDRESS, &HAL_Wire)) {
-        bmx.setSampling(Adafruit_BME280::MODE_FORCED, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::FILTER_OFF);
+        bmx.setSampling(Adafruit_BME280::MODE_NORMAL, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::FILTER_OFF, Adafruit_BME280::STANDBY_MS_1000);
         weatherSensor = WS_BME280; success = true;
       } else { DF("WRN: Weather.init(), BME280 (I2C 0x"); if (DEBUG != OFF) SERIAL_DEBUG.print(BME_ADDRESS, HEX); DLF(") not found"); }
     #elif WEATHER == BMP280 || WEATHER == BMP280_0x76
       if (bmx.begin(BMP_ADDRESS)) {
-        bmx.setSampling(Adafruit_BMP280::MODE_FORCED, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::FILTER_OFF);
+        bmx.setSampling(Adafruit_BMP280::MODE_NORMAL, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::FILTER_OFF, Adafruit_BMP280::STANDBY_MS_1000);
         weatherSensor = WS_BMP280; success = true;
       } else { DF("WRN: Weather.init(), BMP280 (I2C 0x"); if (DEBUG != OFF) SERIAL_DEBUG.print(BMP_ADDRESS, HEX); DLF(") not found"); }
     #elif WEATHER == BME280_SPI
       if (bmx.begin()) {
-        bmx.setSampling(Adafruit_BME280::MODE_FORCED, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::FILTER_OFF);
+        bmx.setSampling(Adafruit_BME280::MODE_NORMAL, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::FILTER_OFF, Adafruit_BME280::STANDBY_MS_1000);
         weatherSensor = WS_BME280; success = true;
       } else { DLF("WRN: Weather.init(), BME280 (SPI) not found"); }
     #elif WEATHER == BMP280_SPI
       if (bmx.begin()) {
-        bmx.setSampling(Adafruit_BMP280::MODE_FORCED, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::FILTER_OFF);
+        bmx.setSampling(Adafruit_BMP280::MODE_NORMAL, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::FILTER_OFF, Adafruit_BMP280::STANDBY_MS_1000);
         weatherSensor = WS_BMP280; success = true;
       } else { DLF("WRN: Weather.init(), BMP280 (SPI) not found"); }
     #else
@@ -76,8 +76,9 @@ bool Weather::init() {
         HAL_Wire.setClock(HAL_WIRE_CLOCK);
     #endif
 
+    // the sensor converts on its own once a second so reads never wait on a measurement
     if (success) {
-      VF("MSG: Weather, start weather monitor task (rate 5000ms priority 7)... ");
+      VF("MSG: Weather, start weather monitor task (rate 1000ms priority 7)... ");
       if (tasks.add(1000, 0, true, 7, weatherPollWrapper, "WeaPoll")) { VLF("success"); } else { VLF("FAILED!"); }
     }
   #else
@@ -86,7 +87,7 @@ bool Weather::init() {
   return success;
 }
 
-// poll the weather sensor once every 5 seconds
+// poll the weather sensor, one reading each pass
 void Weather::poll() {
   #if WEATHER != OFF
     if (success && !xBusy) {
@@ -110,7 +111,6 @@ void Weather::poll() {
           phase = 0;
         break;
       }
-      bmx.takeForcedMeasurement();
 
       // if any measurements are anomalous assume all are invalid
       #if WEATHER == BME280 || WEATHER == BME280_0x76 || WEATHER == BME280_SPI
@@ -151,9 +151,22 @@ void Weather::poll() {
     #if WEATHER_SUPRESS_ERRORS == OFF
       else { temperature = NAN; pressure = NAN; humidity = NAN; }
     #endif
+    checkChange();
   #endif
 }
 
+// counts a change when the pressure or temperature moves past its threshold (or becomes valid or invalid)
+void Weather::checkChange() {
+  float p = getPressure();
+  float t = getTemperature();
+  if (isnan(p) != isnan(changePressure) || isnan(t) != isnan(changeTemperature) ||
+      fabs(p - changePressure) >= WEATHER_CHANGE_PRESSURE || fabs(t - changeTemperature) >= WEATHER_CHANGE_TEMPERATURE) {
+    changePressure = p;
+    changeTemperature = t;
+    changeCount++;
+  }
+}
+
 // get temperature in deg. C
 float Weather::getTemperature() {
   return averageTemperature;
@@ -163,6 +176,7 @@ float Weather::getTemperature() {
 bool Weather::setTemperature(float t) {
   if (weatherSensor == WS_NONE) { 
     if (t >= -60.0F && t <= 60.0F) { temperature = t; averageTemperature = t; } else return false;
+    checkChange();
   }
   return true;
 }
@@ -176,6 +190,7 @@ float Weather::getPressure() {
 bool Weather::setPressure(float p) {
   if (weatherSensor == WS_NONE) { 
     if (p >= 100.0F && p <= 1100.0F) pressure = p; else return false;
+    checkChange();
   }
   return true;
 }
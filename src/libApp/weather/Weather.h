@@ -6,13 +6,24 @@
 
 enum WeatherSensor: uint8_t {WS_NONE, WS_BMP280, WS_BME280};
 
+// smallest change in pressure (hPa/mb) and temperature (deg. C) passed on to refraction
+#ifndef WEATHER_CHANGE_PRESSURE
+  #define WEATHER_CHANGE_PRESSURE    0.5F
+#endif
+#ifndef WEATHER_CHANGE_TEMPERATURE
+  #define WEATHER_CHANGE_TEMPERATURE 0.5F
+#endif
+
 class Weather {
   public:
     bool init();
 
-    // designed for a 2s polling interval
+    // designed for a 1s polling interval
     void poll();
 
+    // counts up each time the pressure or temperature moves past its change threshold
+    inline uint8_t getChangeCount() { return changeCount; }
+
     // get temperature in deg. C
     float getTemperature();
 
@@ -36,8 +47,15 @@ class Weather {
     float getDewPoint();
 
   private:
+    // counts a change when the pressure or temperature moves past its threshold
+    void checkChange();
+
     WeatherSensor weatherSensor = WS_NONE;
 
+    uint8_t changeCount = 0;
+    float changePressure = NAN;
+    float changeTemperature = NAN;
+
     bool success = false;
 
     float temperature = NAN;
@@ -209,6 +209,9 @@
 #ifndef AXIS1_SERVO_PH2_PIN
 #define AXIS1_SERVO_PH2_PIN         AXIS1_STEP_PIN
 #endif
+#ifndef AXIS1_SERVO_CURRENT_PIN
+#define AXIS1_SERVO_CURRENT_PIN     OFF
+#endif
 #ifndef AXIS1_FAULT_PIN
 #define AXIS1_FAULT_PIN             OFF
 #endif
@@ -252,6 +255,9 @@
 #ifndef AXIS2_SERVO_PH2_PIN
 #define AXIS2_SERVO_PH2_PIN         AXIS2_STEP_PIN
 #endif
+#ifndef AXIS2_SERVO_CURRENT_PIN
+#define AXIS2_SERVO_CURRENT_PIN     OFF
+#endif
 #ifndef AXIS2_FAULT_PIN
 #define AXIS2_FAULT_PIN             OFF
 #endif
@@ -295,6 +301,9 @@
 #ifndef AXIS3_SERVO_PH2_PIN
 #define AXIS3_SERVO_PH2_PIN         OFF
 #endif
+#ifndef AXIS3_SERVO_CURRENT_PIN
+#define AXIS3_SERVO_CURRENT_PIN     OFF
+#endif
 #ifndef AXIS3_ENCODER_A_PIN
 #define AXIS3_ENCODER_A_PIN         OFF
 #endif
@@ -344,6 +353,9 @@
 #ifndef AXIS4_SERVO_PH2_PIN
 #define AXIS4_SERVO_PH2_PIN         OFF
 #endif
+#ifndef AXIS4_SERVO_CURRENT_PIN
+#define AXIS4_SERVO_CURRENT_PIN     OFF
+#endif
 #ifndef AXIS4_ENCODER_A_PIN
 #define AXIS4_ENCODER_A_PIN         OFF
 #endif
@@ -410,6 +422,9 @@
 #ifndef AXIS5_SERVO_PH2_PIN
 #define AXIS5_SERVO_PH2_PIN         OFF
 #endif
+#ifndef AXIS5_SERVO_CURRENT_PIN
+#define AXIS5_SERVO_CURRENT_PIN     OFF
+#endif
 #ifndef AXIS5_ENCODER_A_PIN
 #define AXIS5_ENCODER_A_PIN         OFF
 #endif
@@ -459,6 +474,9 @@
 #ifndef AXIS6_SERVO_PH2_PIN
 #define AXIS6_SERVO_PH2_PIN         OFF
 #endif
+#ifndef AXIS6_SERVO_CURRENT_PIN
+#define AXIS6_SERVO_CURRENT_PIN     OFF
+#endif
 #ifndef AXIS6_ENCODER_A_PIN
 #define AXIS6_ENCODER_A_PIN         OFF
 #endif
@@ -508,6 +526,9 @@
 #ifndef AXIS7_SERVO_PH2_PIN
 #define AXIS7_SERVO_PH2_PIN         OFF
 #endif
+#ifndef AXIS7_SERVO_CURRENT_PIN
+#define AXIS7_SERVO_CURRENT_PIN     OFF
+#endif
 #ifndef AXIS7_ENCODER_A_PIN
 #define AXIS7_ENCODER_A_PIN         OFF
 #endif
@@ -557,6 +578,9 @@
 #ifndef AXIS8_SERVO_PH2_PIN
 #define AXIS8_SERVO_PH2_PIN         OFF
 #endif
+#ifndef AXIS8_SERVO_CURRENT_PIN
+#define AXIS8_SERVO_CURRENT_PIN     OFF
+#endif
 #ifndef AXIS8_ENCODER_A_PIN
 #define AXIS8_ENCODER_A_PIN         OFF
 #endif
@@ -606,6 +630,9 @@
 #ifndef AXIS9_SERVO_PH2_PIN
 #define AXIS9_SERVO_PH2_PIN         OFF
 #endif
+#ifndef AXIS9_SERVO_CURRENT_PIN
+#define AXIS9_SERVO_CURRENT_PIN     OFF
+#endif
 #ifndef AXIS9_ENCODER_A_PIN
 #define AXIS9_ENCODER_A_PIN         OFF
 #endif
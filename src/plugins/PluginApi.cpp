@@ -0,0 +1,133 @@
+// -----------------------------------------------------------------------------------
+// Plugin API, direct access to the mount and focusers without round trips through SERIAL_LOCAL
+
+#include "PluginApi.h"
+
+#include "../lib/tasks/OnTask.h"
+
+#ifdef MOUNT_PRESENT
+  #include "../telescope/mount/park/Park.h"
+#endif
+#ifdef FOCUSER_PRESENT
+  #include "../telescope/focuser/Focuser.h"
+#endif
+
+void pluginApiWrapper() { pluginApi.poll(); }
+
+bool PluginApi::onChange(PluginEventCallback callback) {
+  if (callbackCount >= PLUGIN_CALLBACKS_MAX) { DLF("ERR: Plugins, too many state change callbacks"); return false; }
+
+  // start the state monitor with the first callback
+  if (!handle) {
+    for (int i = 0; i <= PE_FOCUSER; i++) lastState[i] = 255;
+    poll();
+    VF("MSG: Plugins, start state monitor task (rate 10ms priority 6)... ");
+    handle = tasks.add(10, 0, true, 6, pluginApiWrapper, "PlugApi");
+    if (handle) { VLF("success"); } else { VLF("FAILED!"); return false; }
+  }
+
+  this->callback[callbackCount++] = callback;
+  return true;
+}
+
+void PluginApi::poll() {
+  uint8_t state[PE_FOCUSER + 1] = { 0 };
+
+  #ifdef MOUNT_PRESENT
+    PluginMountState mountState = getMountState();
+    state[PE_TRACKING] = mountState.tracking;
+    state[PE_SLEWING] = mountState.slewing;
+    state[PE_GOTO] = mountState.gotoActive;
+    state[PE_GUIDE] = mountState.guiding;
+    state[PE_PARK] = mountState.park;
+  #endif
+
+  #ifdef FOCUSER_PRESENT
+    for (int index = 0; index < FOCUSER_MAX; index++) if (!focuser.isSettled(index)) bitSet(state[PE_FOCUSER], index);
+  #endif
+
+  for (int event = 0; event <= PE_FOCUSER; event++) {
+    if (state[event] == lastState[event]) continue;
+    // the first pass only records the starting state
+    bool first = lastState[event] == 255;
+    lastState[event] = state[event];
+    if (first) continue;
+    for (int i = 0; i < callbackCount; i++) callback[i]((PluginEvent)event, state[event]);
+  }
+}
+
+#ifdef MOUNT_PRESENT
+  void PluginApi::getPosition(double *ra, double *dec) {
+    Coordinate position = mount.getPosition();
+    *ra = position.r;
+    *dec = position.d;
+  }
+
+  void PluginApi::getHorizon(double *alt, double *azm) {
+    Coordinate position = mount.getPosition(CR_MOUNT_HOR);
+    *alt = position.a;
+    *azm = position.z;
+  }
+
+  PluginMountState PluginApi::getMountState() {
+    PluginMountState state;
+    state.tracking = mount.isTracking();
+    state.slewing = mount.isSlewing();
+    #if GOTO_FEATURE == ON
+      state.gotoActive = goTo.state != GS_NONE;
+    #else
+      state.gotoActive = false;
+    #endif
+    state.guiding = guide.state != GU_NONE;
+    state.atHome = mount.isHome();
+    state.fault = mount.motorFault();
+    state.park = park.state;
+    return state;
+  }
+
+  CommandError PluginApi::gotoEqu(double ra, double dec) {
+    #if GOTO_FEATURE == ON
+      Coordinate target = goTo.getGotoTarget();
+      target.r = ra;
+      target.d = dec;
+      goTo.setGotoTarget(&target);
+      return goTo.request();
+    #else
+      UNUSED(ra); UNUSED(dec);
+      return CE_CMD_UNKNOWN;
+    #endif
+  }
+
+  void PluginApi::stop() {
+    #if GOTO_FEATURE == ON
+      goTo.abort();
+    #endif
+    guide.stop();
+  }
+
+  CommandError PluginApi::guidePulse(char direction, GuideRateSelect rateSelect, unsigned long timeMs) {
+    switch (direction) {
+      case 'w': return guide.startAxis1(GA_FORWARD, rateSelect, timeMs);
+      case 'e': return guide.startAxis1(GA_REVERSE, rateSelect, timeMs);
+      case 'n': return guide.startAxis2(GA_FORWARD, rateSelect, timeMs);
+      case 's': return guide.startAxis2(GA_REVERSE, rateSelect, timeMs);
+    }
+    return CE_PARAM_FORM;
+  }
+#endif
+
+#ifdef FOCUSER_PRESENT
+  bool PluginApi::focuserGetPosition(int index, float *microns) {
+    return focuser.getPosition(index, microns);
+  }
+
+  CommandError PluginApi::focuserGoto(int index, float microns) {
+    return focuser.gotoPosition(index, microns);
+  }
+
+  bool PluginApi::focuserIsSettled(int index) {
+    return focuser.isSettled(index);
+  }
+#endif
+
+PluginApi pluginApi;
@@ -0,0 +1,86 @@
+// -----------------------------------------------------------------------------------
+// Plugin API, direct access to the mount and focusers without round trips through SERIAL_LOCAL
+#pragma once
+
+#include "../Common.h"
+#include "../telescope/Telescope.h"
+
+#ifdef MOUNT_PRESENT
+  #include "../telescope/mount/Mount.h"
+  #include "../telescope/mount/goto/Goto.h"
+  #include "../telescope/mount/guide/Guide.h"
+#endif
+
+// the state changes a plugin can be called back for
+enum PluginEvent: uint8_t {PE_TRACKING, PE_SLEWING, PE_GOTO, PE_GUIDE, PE_PARK, PE_FOCUSER};
+
+// callback for state changes, the event and the new state (for PE_PARK the ParkState, for PE_FOCUSER
+// bits set for each focuser that is moving, otherwise true if active)
+typedef void (*PluginEventCallback)(PluginEvent event, uint8_t state);
+
+#define PLUGIN_CALLBACKS_MAX 8
+
+typedef struct PluginMountState {
+  bool tracking;
+  bool slewing;
+  bool gotoActive;
+  bool guiding;
+  bool atHome;
+  bool fault;
+  ParkState park;
+} PluginMountState;
+
+class PluginApi {
+  public:
+    // register a handler for commands starting with any of these characters, the main command handlers
+    // are tried first so a plugin can't take over an existing command
+    inline void commandRegister(const char *firstChars, CommandHandler handler) { telescope.commandRegister(firstChars, handler); }
+
+    // call back when the mount or focuser state changes, checked every 10ms
+    // returns false if there are too many callbacks or the state monitor task couldn't be started
+    bool onChange(PluginEventCallback callback);
+
+    #ifdef MOUNT_PRESENT
+      // current position as RA, Dec (Native coordinate system) in radians
+      void getPosition(double *ra, double *dec);
+
+      // current position as Alt, Azm in radians
+      void getHorizon(double *alt, double *azm);
+
+      // tracking, slewing, park, etc. state of the mount
+      PluginMountState getMountState();
+
+      // goto RA, Dec (Native coordinate system) in radians using the preferred pier side
+      CommandError gotoEqu(double ra, double dec);
+
+      // stop any goto or guide
+      void stop();
+
+      // pulse guide in direction 'n', 's', 'e', or 'w' at the given rate for timeMs
+      CommandError guidePulse(char direction, GuideRateSelect rateSelect, unsigned long timeMs);
+    #endif
+
+    #ifdef FOCUSER_PRESENT
+      // focuser position in microns, returns false if the focuser isn't present
+      bool focuserGetPosition(int index, float *microns);
+
+      // move the focuser to a position in microns
+      CommandError focuserGoto(int index, float microns);
+
+      // true if the focuser has stopped at its target and settled
+      bool focuserIsSettled(int index);
+    #endif
+
+    // check for state changes and run the callbacks
+    void poll();
+
+  private:
+    // state of the mount and focusers as last seen by poll()
+    uint8_t lastState[PE_FOCUSER + 1];
+
+    PluginEventCallback callback[PLUGIN_CALLBACKS_MAX];
+    uint8_t callbackCount = 0;
+    uint8_t handle = 0;
+};
+
+extern PluginApi pluginApi;
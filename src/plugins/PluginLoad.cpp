@@ -0,0 +1,81 @@
+// -----------------------------------------------------------------------------------
+// Plugin load accounting, CPU time used by each plugin's tasks and runtime budget overruns
+
+#include "PluginLoad.h"
+
+#ifdef TASKS_BUDGET_ENABLE
+
+#include "../lib/tasks/OnTask.h"
+
+void pluginLoadWrapper() { pluginLoad.poll(); }
+
+void PluginLoad::begin(uint8_t n, const char *name, unsigned long budget) {
+  if (n < 1 || n > PLUGINS_MAX) return;
+
+  if (!handle) {
+    for (int i = 0; i < PLUGINS_MAX; i++) { this->name[i][0] = 0; load[i] = 0.0F; lastRuntime[i] = 0; lastOverruns[i] = 0; }
+    VF("MSG: Plugins, start load accounting task (rate 1000ms priority 7)... ");
+    handle = tasks.add(1000, 0, true, 7, pluginLoadWrapper, "PlugLd");
+    if (handle) { VLF("success"); } else { VLF("FAILED!"); }
+    lastTime = micros();
+  }
+
+  strncpy(this->name[n - 1], name, 15); this->name[n - 1][15] = 0;
+  this->budget[n - 1] = budget;
+  tasks.setGroup(n, budget);
+}
+
+void PluginLoad::end() {
+  tasks.setGroup(0, 0);
+}
+
+bool PluginLoad::get(uint8_t n, char **name, uint8_t *taskCount, float *load, unsigned long *runtimeMax, unsigned long *overruns) {
+  if (n < 1 || n > PLUGINS_MAX || this->name[n - 1][0] == 0 || !handle) return false;
+
+  *name = this->name[n - 1];
+  *taskCount = 0;
+  *runtimeMax = 0;
+  *overruns = 0;
+  for (uint8_t h = tasks.getFirstHandle(); h != 0; h = tasks.getNextHandle(h)) {
+    if (tasks.getGroup(h) != n) continue;
+    (*taskCount)++;
+    if (tasks.getRuntimeNetMax(h) > *runtimeMax) *runtimeMax = tasks.getRuntimeNetMax(h);
+    *overruns += tasks.getOverrunCount(h);
+  }
+  *load = this->load[n - 1];
+  return true;
+}
+
+void PluginLoad::poll() {
+  unsigned long runtime[PLUGINS_MAX] = { 0 };
+  unsigned long overruns[PLUGINS_MAX] = { 0 };
+
+  for (uint8_t h = tasks.getFirstHandle(); h != 0; h = tasks.getNextHandle(h)) {
+    uint8_t group = tasks.getGroup(h);
+    if (group < 1 || group > PLUGINS_MAX) continue;
+    runtime[group - 1] += tasks.getRuntimeNetTotal(h);
+    overruns[group - 1] += tasks.getOverrunCount(h);
+  }
+
+  unsigned long now = micros();
+  unsigned long elapsed = now - lastTime;
+  lastTime = now;
+
+  for (int i = 0; i < PLUGINS_MAX; i++) {
+    if (name[i][0] == 0) continue;
+
+    // the totals wrap together so the difference is good unless a task was removed
+    unsigned long used = runtime[i] - lastRuntime[i];
+    if (used <= elapsed && elapsed > 0) load[i] = (used*100.0F)/elapsed;
+    lastRuntime[i] = runtime[i];
+
+    if (overruns[i] > lastOverruns[i]) {
+      DF("WRN: Plugins, "); D(name[i]); DF(" ran over its "); D(budget[i]); DF("us task budget "); D(overruns[i] - lastOverruns[i]); DLF(" times");
+    }
+    lastOverruns[i] = overruns[i];
+  }
+}
+
+PluginLoad pluginLoad;
+
+#endif
@@ -0,0 +1,38 @@
+// -----------------------------------------------------------------------------------
+// Plugin load accounting, CPU time used by each plugin's tasks and runtime budget overruns
+#pragma once
+
+#include "../Common.h"
+
+#ifdef TASKS_BUDGET_ENABLE
+
+#define PLUGINS_MAX 8
+
+class PluginLoad {
+  public:
+    // start accounting for plugin n (1 to 8), tasks added until end() (or later by those tasks) belong to it
+    // budget is the runtime allowed per task call in microseconds, 0 for no limit
+    void begin(uint8_t n, const char *name, unsigned long budget);
+    void end();
+
+    // get the load of plugin n (1 to 8,) returns false if it isn't present
+    // tasks is the number of tasks, load the percent of CPU time used over the last second (net of higher priority
+    // tasks that ran while it yielded,) runtimeMax the longest task call and overruns the count of calls over budget
+    bool get(uint8_t n, char **name, uint8_t *taskCount, float *load, unsigned long *runtimeMax, unsigned long *overruns);
+
+    // update the load figures and warn about budget overruns, once a second
+    void poll();
+
+  private:
+    char name[PLUGINS_MAX][16];
+    unsigned long budget[PLUGINS_MAX];
+    unsigned long lastRuntime[PLUGINS_MAX];
+    unsigned long lastOverruns[PLUGINS_MAX];
+    unsigned long lastTime = 0;
+    float load[PLUGINS_MAX];
+    uint8_t handle = 0;
+};
+
+extern PluginLoad pluginLoad;
+
+#endif
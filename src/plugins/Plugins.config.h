@@ -6,12 +6,17 @@
  * Each plugin should have a directory that contains all of its files, which gets dropped into to the /src/plugins directory.
  * The plugin main class instance name should match the directory name.
  * The plugin main class must have a "void init();" method for OnStepX to call when it starts up.
+ * Plugins can #include "../PluginApi.h" to read and command the mount or focusers directly, be called back on state
+ * changes, and add their own commands (see the sample plugin.)
  * 
  * ---------------------------------------------------------------------------------------------------------------------------------
 */
 
 // =================================================================================================================================
 
+#define PLUGIN_TASK_BUDGET           2000 //   2000, n. Where n=100 to 100000 (in us) a plugin task may run per call before a  Adjust
+                                          //         warning, or OFF. Plugin load is reported by :GXTPn# (n=1 to 8.)
+
 #define PLUGIN1                       OFF //    OFF, Specify the class instance (same as plugin directory name) to enable.    Option
 //#include "plugin1/Name.h"               //         Specify the header file to include the class.
 
@@ -2,30 +2,50 @@
 
 #include "Sample.h"
 #include "../../Common.h"
-#include "../../lib/serial/Serial_Local.h"
 #include "../../lib/tasks/OnTask.h"
+#include "../PluginApi.h"
 
 void sampleWrapper() { sample.loop(); }
 
+// :YS#       Sample plugin command, prints the position now
+//            Returns: Nothing
+bool sampleCommand(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError) {
+  UNUSED(reply); UNUSED(supressFrame); UNUSED(commandError);
+  if (command[0] == 'Y' && command[1] == 'S' && parameter[0] == 0) {
+    sample.loop();
+    *numericReply = false;
+    return true;
+  }
+  return false;
+}
+
+// called by the plugin API as soon as the state changes
+void sampleOnChange(PluginEvent event, uint8_t state) {
+  if (event == PE_GOTO) {
+    Serial.println(state ? "Goto started" : "Goto finished");
+  }
+}
+
 void Sample::init() {
   VLF("MSG: Plugins, starting: sample");
 
-  // start a task that runs twice a second, run at priority level 7 so
-  // we can block using tasks.yield(); fairly aggressively without significant impact on operation
+  pluginApi.commandRegister("Y", sampleCommand);
+  pluginApi.onChange(sampleOnChange);
+
+  // start a task that runs twice a second, the plugin API calls return immediately so
+  // this doesn't need to block anything
   tasks.add(500, 0, true, 7, sampleWrapper);
 }
 
 void Sample::loop() {
-  SERIAL_LOCAL.transmit(":GR#");
-  // let OnStepX run for 0.1 second to process the command
-  tasks.yield(100);
-  Serial.print("RA = ");
-  Serial.println(SERIAL_LOCAL.receive());
-
-  SERIAL_LOCAL.transmit(":GD#");
-  tasks.yield(100);
-  Serial.print("Dec=");
-  Serial.println(SERIAL_LOCAL.receive());
+  #ifdef MOUNT_PRESENT
+    double ra, dec;
+    pluginApi.getPosition(&ra, &dec);
+    Serial.print("RA = ");
+    Serial.println(radToHrs(ra), 4);
+    Serial.print("Dec=");
+    Serial.println(radToDeg(dec), 3);
+  #endif
 
   Serial.println();
 }
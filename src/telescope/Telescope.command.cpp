@@ -7,6 +7,7 @@
 #include "../lib/convert/Convert.h"
 #include "../libApp/commands/ProcessCmds.h"
 #include "../libApp/weather/Weather.h"
+#include "../lib/wifi/WifiManager.h"
 #include "Telescope.h"
 
 #include "addonFlasher/AddonFlasher.h"
@@ -16,6 +17,11 @@
 #include "mount/home/Home.h"
 #include "mount/library/Library.h"
 #include "mount/limits/Limits.h"
+#include "mount/log/MountLog.h"
+#include "mount/capture/Capture.h"
+#include "mount/ephemeris/Ephemeris.h"
+#include "mount/trajectory/Trajectory.h"
+#include "mount/scenario/Scenario.h"
 #include "mount/park/Park.h"
 #include "mount/pec/Pec.h"
 #include "mount/site/Site.h"
@@ -29,35 +35,115 @@
   HAL_RESET_FUNC;
 #endif
 
-bool Telescope::command(char reply[], char command[], char parameter[], bool *supressFrame, bool *numericReply, CommandError *commandError) {
+#define COMMAND_HANDLER(name, object) \
+  static bool name(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError) { \
+    return object.command(reply, command, parameter, supressFrame, numericReply, commandError); }
+
+#ifdef MOUNT_PRESENT
+  COMMAND_HANDLER(mountCommand, mount)
+  COMMAND_HANDLER(guideCommand, guide)
+  COMMAND_HANDLER(gpioCommand, gpio)
+  COMMAND_HANDLER(mountStatusCommand, mountStatus)
+  COMMAND_HANDLER(gotoCommand, goTo)
+  COMMAND_HANDLER(parkCommand, park)
+  COMMAND_HANDLER(libraryCommand, library)
+  COMMAND_HANDLER(siteCommand, site)
+  COMMAND_HANDLER(limitsCommand, limits)
+  COMMAND_HANDLER(homeCommand, home)
+  COMMAND_HANDLER(pecCommand, pec)
+  COMMAND_HANDLER(axis1Command, axis1)
+  COMMAND_HANDLER(axis2Command, axis2)
+  #if MOUNT_LOG != OFF
+    COMMAND_HANDLER(mountLogCommand, mountLog)
+  #endif
+  #if MOUNT_CAPTURE != OFF
+    COMMAND_HANDLER(mountCaptureCommand, mountCapture)
+  #endif
+  #if EPHEMERIS == ON
+    COMMAND_HANDLER(ephemerisCommand, ephemeris)
+  #endif
+  #if TRAJECTORY == ON
+    COMMAND_HANDLER(trajectoryCommand, trajectory)
+  #endif
+  #ifdef MOUNT_SCENARIO
+    COMMAND_HANDLER(scenarioCommand, scenario)
+  #endif
+#endif
+#ifdef ROTATOR_PRESENT
+  COMMAND_HANDLER(rotatorCommand, rotator)
+#endif
+#ifdef FOCUSER_PRESENT
+  COMMAND_HANDLER(focuserCommand, focuser)
+#endif
+#ifdef FEATURES_PRESENT
+  COMMAND_HANDLER(featuresCommand, features)
+#endif
 
+void Telescope::commandInit() {
+  // the first characters each subsystem's command() responds to, in the order they're tried
   #ifdef MOUNT_PRESENT
-    if (mount.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (guide.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (gpio.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (mountStatus.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (goTo.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (park.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (library.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (site.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (limits.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (home.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (pec.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (axis1.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
-    if (axis2.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
+    commandRegister("$%GST", mountCommand);
+    commandRegister("GMQR", guideCommand);
+    commandRegister("GS", gpioCommand);
+    commandRegister("GS", mountStatusCommand);
+    commandRegister("ACDGMS", gotoCommand);
+    commandRegister("h", parkCommand);
+    #if EPHEMERIS == ON
+      commandRegister("LT", ephemerisCommand);
+    #endif
+    #if TRAJECTORY == ON
+      commandRegister("T", trajectoryCommand);
+    #endif
+    #ifdef MOUNT_SCENARIO
+      commandRegister("GS", scenarioCommand);
+    #endif
+    commandRegister("L", libraryCommand);
+    commandRegister("GSW", siteCommand);
+    commandRegister("GS", limitsCommand);
+    commandRegister("h", homeCommand);
+    commandRegister("$GSVW", pecCommand);
+    commandRegister("GS", axis1Command);
+    commandRegister("GS", axis2Command);
+    #if MOUNT_LOG != OFF
+      commandRegister("G", mountLogCommand);
+    #endif
+    #if MOUNT_CAPTURE != OFF
+      commandRegister("GS", mountCaptureCommand);
+    #endif
   #endif
 
   #ifdef ROTATOR_PRESENT
-    if (rotator.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
+    commandRegister("GShr", rotatorCommand);
   #endif
 
   #ifdef FOCUSER_PRESENT
-    if (focuser.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
+    commandRegister("FGSh", focuserCommand);
   #endif
 
   #ifdef FEATURES_PRESENT
-    if (features.command(reply, command, parameter, supressFrame, numericReply, commandError)) return true;
+    commandRegister("GS", featuresCommand);
   #endif
+}
+
+void Telescope::commandRegister(const char *firstChars, CommandHandler handler) {
+  if (commandHandlerCount >= COMMAND_HANDLERS_MAX) { DLF("ERR: Telescope, too many command handlers"); return; }
+  for (const char *c = firstChars; *c != 0; c++) {
+    uint8_t i = (uint8_t)*c;
+    if (i >= ' ' && i < 128) commandHandlerMask[i - ' '] |= 1UL << commandHandlerCount;
+  }
+  commandHandler[commandHandlerCount++] = handler;
+}
+
+bool Telescope::command(char reply[], char command[], char parameter[], bool *supressFrame, bool *numericReply, CommandError *commandError) {
+
+  // only the subsystems that handle commands starting with this character are tried
+  uint8_t first = (uint8_t)command[0];
+  if (first >= ' ' && first < 128) {
+    uint32_t mask = commandHandlerMask[first - ' '];
+    for (uint8_t i = 0; mask != 0; i++, mask >>= 1) {
+      if ((mask & 1) && commandHandler[i](reply, command, parameter, supressFrame, numericReply, commandError)) return true;
+    }
+  }
 
   //  B - Reticle/Accessory Control
   // :B+#       Increase reticle Brightness
@@ -117,7 +203,8 @@ bool Telescope::command(char reply[], char command[], char parameter[], bool *su
     #if SERIAL_B_ESP_FLASHING == ON
       if (command[1] == 'S' && parameter[0] == 'P' && parameter[1] == 'F' && parameter[2] == 'L' && parameter[3] == 'A' && parameter[4] == 'S' && parameter[5] == 'H' && parameter[6] == 0) {
         SERIAL_A.println("The ESP8266 will now be placed in flash upload mode (at 115200 Baud.)");
-        SERIAL_A.println("Arduino's 'Tools -> Upload Speed' should be set to 115200 Baud.");
+        SERIAL_A.println("Arduino's 'Tools -> Upload Speed' can be set as high as 921600 Baud, the upload starts");
+        SERIAL_A.println("at 115200 Baud and the passthrough follows it to the faster rate.");
         SERIAL_A.println("Waiting for data, you have one minute to start the upload.");
         tasks.yield(1000);
         addonFlasher.go();
@@ -186,7 +273,18 @@ bool Telescope::command(char reply[], char command[], char parameter[], bool *su
           uint16_t axesToRevert = nv.readUI(NV_AXIS_SETTINGS_REVERT);
           if (!(axesToRevert & 1)) *commandError = CE_0;
         } else return false;
-      } else return false;
+      } else
+
+      #if OPERATIONAL_MODE == WIFI && STA_AUTO_RECONNECT == true
+        // :GXWS#     Get WiFi station link statistics
+        //            Returns: n,c,d,f,t,r# station number, connects, links lost, failed reconnects, downtime in seconds, RSSI in dBm
+        if (parameter[0] == 'W' && parameter[1] == 'S') {
+          sprintf(reply, "%d,%lu,%lu,%lu,%lu,%d", wifiManager.stationNumber, wifiManager.stats.connects, wifiManager.stats.disconnects,
+                  wifiManager.stats.failedAttempts, wifiManager.getDowntime()/1000UL, wifiManager.stats.rssi);
+          *numericReply = false;
+        } else
+      #endif
+      return false;
 
     } else return false;
   } else
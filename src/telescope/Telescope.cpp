@@ -5,9 +5,12 @@
 #include "../lib/tasks/OnTask.h"
 
 #include "../lib/convert/Convert.h"
+#include "../lib/boot/BootTime.h"
 #include "../libApp/commands/ProcessCmds.h"
 #include "../libApp/weather/Weather.h"
 #include "../libApp/temperature/Temperature.h"
+#include "../libApp/alpaca/Alpaca.h"
+#include "../lib/wifi/ota/OtaUpdate.h"
 
 #include "Telescope.h"
 
@@ -22,6 +25,7 @@
 #include "mount/pec/Pec.h"
 #include "mount/site/Site.h"
 #include "mount/status/Status.h"
+#include "mount/telemetry/Telemetry.h"
 #include "rotator/Rotator.h"
 #include "focuser/Focuser.h"
 #include "auxiliary/Features.h"
@@ -29,6 +33,25 @@
 bool xBusy = false;
 InitError initError;
 
+#if OPERATIONAL_MODE == WIFI && WEB_SERVER == ON && OTA_UPDATE == ON
+  // firmware update flash writes wait out any goto, the new image is switched to once parked
+  bool otaHold() {
+    #if defined(MOUNT_PRESENT) && GOTO_FEATURE == ON
+      return goTo.state != GS_NONE;
+    #else
+      return false;
+    #endif
+  }
+
+  bool otaReady() {
+    #ifdef MOUNT_PRESENT
+      return park.state == PS_PARKED;
+    #else
+      return true;
+    #endif
+  }
+#endif
+
 #if STATUS_LED != OFF && STATUS_LED_PIN != OFF
   void statusFlash() {
     static uint8_t cycle = 0;
@@ -121,6 +144,19 @@ void Telescope::init(const char *fwName, int fwMajor, int fwMinor, const char *f
     }
   } else { VLF("MSG: NV, correct key found"); }
 
+  // bring the settings in with block reads, the PEC buffer and library are left until they're used
+  nv.prefetch(0, NV_PEC_BUFFER_BASE);
+
+  // settings regions protected by a CRC, the PEC buffer and library add their own
+  nv.addRegion(NV_SITE_NUMBER, NV_AXIS_SETTINGS_REVERT - NV_SITE_NUMBER);
+  nv.addRegion(NV_AXIS_SETTINGS_REVERT, NV_LAST + 1 - NV_AXIS_SETTINGS_REVERT);
+  #ifdef NV_WIFI_SETTINGS_BASE
+    nv.addRegion(NV_WIFI_SETTINGS_BASE, 451);
+  #endif
+  bootTime.mark("NV");
+
+  commandInit();
+
   if (!gpio.init()) initError.gpio = true;
 
   #ifdef SHARED_ENABLE_PIN
@@ -139,25 +175,28 @@ void Telescope::init(const char *fwName, int fwMajor, int fwMinor, const char *f
   #if SERIAL_B_ESP_FLASHING == ON
     addonFlasher.init();
   #endif
+  bootTime.mark("GPIO");
 
-  weather.init();
-  temperature.init();
-
-  #if OPERATIONAL_MODE == WIFI && WEB_SERVER == ON
-    wifiManager.init();
+  // the station associates in the background while the axes come up, init() below waits for it
+  #if OPERATIONAL_MODE == WIFI
+    wifiManager.begin();
+    bootTime.mark("WiFi start");
   #endif
 
   #ifdef MOUNT_PRESENT
     mount.init();
     mountStatus.init();
+    bootTime.mark("Mount");
   #endif
 
   #ifdef ROTATOR_PRESENT
     rotator.init();
+    bootTime.mark("Rotator");
   #endif
 
   #ifdef FOCUSER_PRESENT
     focuser.init();
+    bootTime.mark("Focuser");
   #endif
 
   #ifdef SHARED_ENABLE_PIN
@@ -170,20 +209,78 @@ void Telescope::init(const char *fwName, int fwMajor, int fwMinor, const char *f
     digitalWriteEx(SHARED_ENABLE_PIN3, SHARED3_ENABLE_STATE);
   #endif
 
+  // all drivers calibrate stealthChop together, so one standstill wait covers every axis
+  #ifdef MOTOR_PRESENT
+    unsigned long calibrateStartMs = millis();
+    bool calibrateWait = false;
+    #ifdef MOUNT_PRESENT
+      if (mount.calibrateDriversStart()) calibrateWait = true;
+    #endif
+    #ifdef ROTATOR_PRESENT
+      if (rotator.calibrateDriversStart()) calibrateWait = true;
+    #endif
+    #ifdef FOCUSER_PRESENT
+      if (focuser.calibrateDriversStart()) calibrateWait = true;
+    #endif
+  #endif
+
+  // weather sensor and 1-Wire device discovery take up the standstill time
+  weather.init();
+  temperature.init();
+  bootTime.mark("Sensors");
+
+  #ifdef MOTOR_PRESENT
+    if (calibrateWait) {
+      long remainingMs = MOTOR_CALIBRATE_DRIVER_MS - (long)(millis() - calibrateStartMs);
+      if (remainingMs > 0) delay(remainingMs);
+    }
+    #ifdef MOUNT_PRESENT
+      mount.calibrateDriversFinish();
+    #endif
+    #ifdef ROTATOR_PRESENT
+      rotator.calibrateDriversFinish();
+    #endif
+    #ifdef FOCUSER_PRESENT
+      focuser.calibrateDriversFinish();
+    #endif
+    bootTime.mark("Calibrate");
+  #endif
+
   #ifdef MOUNT_PRESENT
     mount.begin();
+    #if TELEMETRY_RATE != OFF
+      telemetry.init();
+    #endif
+    bootTime.mark("Mount begin");
   #endif
 
   #ifdef ROTATOR_PRESENT
     rotator.begin();
+    bootTime.mark("Rotator begin");
   #endif
 
   #ifdef FOCUSER_PRESENT
     focuser.begin();
+    bootTime.mark("Focuser begin");
   #endif
 
   #ifdef FEATURES_PRESENT
     features.init();
+    bootTime.mark("Features");
+  #endif
+
+  #if OPERATIONAL_MODE == WIFI && WEB_SERVER == ON
+    wifiManager.init();
+    bootTime.mark("WiFi");
+
+    #if OTA_UPDATE == ON
+      otaUpdate.init(otaHold, otaReady);
+    #endif
+  #endif
+
+  #if OPERATIONAL_MODE != OFF && ALPACA == ON
+    alpaca.init();
+    bootTime.mark("Alpaca");
   #endif
 
   // write the default settings to NV
@@ -36,6 +36,10 @@ typedef struct Firmware {
   char time[20];
 } Firmware;
 
+// subsystem command handlers, dispatched by the command's first character
+typedef bool (*CommandHandler)(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
+#define COMMAND_HANDLERS_MAX 32
+
 class Telescope {
   public:
     Telescope();
@@ -51,7 +55,17 @@ class Telescope {
 
     void statusInit();
 
+    // register a command handler for commands starting with any of these characters, handlers are tried in registration order
+    void commandRegister(const char *firstChars, CommandHandler handler);
+
   private:
+    // register the subsystem command handlers
+    void commandInit();
+
+    CommandHandler commandHandler[COMMAND_HANDLERS_MAX];
+    uint8_t commandHandlerCount = 0;
+    uint32_t commandHandlerMask[96] = { 0 }; // for first characters ' ' to DEL, bit n is set if handler n applies
+
     Firmware firmware;
     int16_t reticleBrightness = RETICLE_LED_DEFAULT;
 };
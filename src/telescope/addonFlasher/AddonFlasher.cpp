@@ -2,6 +2,7 @@
 
 #include "AddonFlasher.h"
 #include "../../lib/tasks/OnTask.h"
+#include "../../lib/watchdog/Watchdog.h"
 
 // ADDON_TRIGR_PIN  HIGH for run and LOW for trigger serial passthrough mode
 // ADDON_RESET_PIN  HIGH for run and LOW for reset
@@ -13,6 +14,51 @@
     void addonFlasherWrapper() { addonFlasher.poll(); }
   #endif
 
+  // esptool commands that are watched for as they go by
+  #define ESP_FLASH_DATA        0x03
+  #define ESP_CHANGE_BAUDRATE   0x0F
+  #define ESP_FLASH_DEFL_DATA   0x11
+
+  // bytes moved from one port to the other each pass
+  #define ADDON_FLASHER_BLOCK   128
+
+  // follows the SLIP framed esptool packets going by, keeping the start of each
+  // packet: direction, command, size, checksum, then (for a baud rate change) the new rate
+  class SlipMonitor {
+    public:
+      // returns true at the end of a packet
+      bool parse(uint8_t c) {
+        if (c == 0xC0) { bool end = length > 0; length = 0; escape = false; return end; }
+        if (c == 0xDB) { escape = true; return false; }
+        if (escape) { if (c == 0xDC) c = 0xC0; else if (c == 0xDD) c = 0xDB; escape = false; }
+        if (length < sizeof(header)) header[length++] = c; else length = sizeof(header);
+        return false;
+      }
+
+      inline uint8_t direction() { return header[0]; }
+      inline uint8_t command() { return header[1]; }
+      inline uint32_t firstValue() { return header[8] | ((uint32_t)header[9] << 8) | ((uint32_t)header[10] << 16) | ((uint32_t)header[11] << 24); }
+
+    private:
+      uint8_t header[12];
+      uint8_t length = 0;
+      bool escape = false;
+  };
+
+  static void serialBegin(long baud) {
+    #if defined(SERIAL_A_RX) && defined(SERIAL_A_TX) && !defined(SERIAL_A_RXTX_SET)
+      SERIAL_A.begin(baud, SERIAL_8N1, SERIAL_A_RX, SERIAL_A_TX);
+    #else
+      SERIAL_A.begin(baud);
+    #endif
+
+    #if defined(SERIAL_PASSTHROUGH_RX) && defined(SERIAL_PASSTHROUGH_TX) && !defined(SERIAL_PASSTHROUGH_RXTX_SET)
+      SERIAL_PASSTHROUGH.begin(baud, SERIAL_8N1, SERIAL_PASSTHROUGH_RX, SERIAL_PASSTHROUGH_TX);
+    #else
+      SERIAL_PASSTHROUGH.begin(baud);
+    #endif
+  }
+
   void AddonFlasher::init() {
     VF("MSG: AddonFlasher, init gpio0="); V(ADDON_GPIO0_PIN); VF(", reset="); VL(ADDON_RESET_PIN);
     pinModeEx(ADDON_GPIO0_PIN, OUTPUT);
@@ -33,32 +79,76 @@
 
     VLF("MSG: AddonFlasher, activating serial passthrough...");
 
+    // nothing else runs until the passthrough ends, so the watchdog is just fed
+    #ifdef WATCHDOG_PRESENT
+      watchdog.disable();
+    #endif
+
+    // the traffic is passed through in blocks, esptool asking for a faster baud rate is followed once the addon
+    // has acknowledged it at the old rate
+    SlipMonitor host, addon;
+    uint8_t buffer[ADDON_FLASHER_BLOCK];
+    uint32_t pendingBaud = 0;
+    uint32_t baud = 115200;
+    unsigned long blocks = 0;
+    unsigned long bytes = 0;
+    unsigned long startTime = millis();
+
     // so we have a total of 1.5 minutes to start the upload
     unsigned long lastRead = millis() + 85000;
     while (true) {
       // read from port 1, send to port 0:
-      if (SERIAL_PASSTHROUGH.available()) {
-        int inByte = SERIAL_PASSTHROUGH.read();
-        delayMicroseconds(5);
-        SERIAL_A.write(inByte);
-        delayMicroseconds(5);
+      int count = SERIAL_PASSTHROUGH.available();
+      if (count > 0) {
+        if (count > ADDON_FLASHER_BLOCK) count = ADDON_FLASHER_BLOCK;
+        count = SERIAL_PASSTHROUGH.readBytes(buffer, count);
+        int sent = 0;
+        for (int i = 0; i < count; i++) {
+          if (addon.parse(buffer[i]) && pendingBaud != 0 && addon.direction() == 1 && addon.command() == ESP_CHANGE_BAUDRATE) {
+            SERIAL_A.write(buffer + sent, i + 1 - sent);
+            sent = i + 1;
+            SERIAL_A.flush();
+            baud = pendingBaud;
+            pendingBaud = 0;
+            serialBegin(baud);
+          }
+        }
+        if (count > sent) SERIAL_A.write(buffer + sent, count - sent);
       }
 
       // read from port 0, send to port 1:
-      if (SERIAL_A.available()) {
-        int inByte = SERIAL_A.read();
-        delayMicroseconds(5);
-        SERIAL_PASSTHROUGH.write(inByte);
-        delayMicroseconds(5);
+      count = SERIAL_A.available();
+      if (count > 0) {
+        if (count > ADDON_FLASHER_BLOCK) count = ADDON_FLASHER_BLOCK;
+        count = SERIAL_A.readBytes(buffer, count);
+        for (int i = 0; i < count; i++) {
+          if (host.parse(buffer[i]) && host.direction() == 0) {
+            if (host.command() == ESP_CHANGE_BAUDRATE) pendingBaud = host.firstValue(); else
+            if (host.command() == ESP_FLASH_DATA || host.command() == ESP_FLASH_DEFL_DATA) blocks++;
+          }
+        }
+        SERIAL_PASSTHROUGH.write(buffer, count);
+        bytes += count;
         if (millis() > lastRead) lastRead = millis();
       }
-      //tasks.yield();
+
+      #ifdef WATCHDOG_PRESENT
+        watchdog.reset();
+      #endif
 
       // wait 5 seconds w/no traffic before resuming normal operation
       if (timeout && (long)(millis() - lastRead) > 5000) break;
     }
     VLF("MSG: AddonFlasher, serial passthrough deactivated");
 
+    // the progress can only be reported once the serial port is free again
+    VF("MSG: AddonFlasher, sent "); V(bytes); VF(" bytes with "); V(blocks); VF(" flash blocks at "); V(baud);
+    VF(" baud in "); V((millis() - startTime)/1000); VLF("s");
+
+    #ifdef WATCHDOG_PRESENT
+      watchdog.resume();
+    #endif
+
     // back to run mode and normal serial comms
     run(true);
   }
@@ -89,17 +179,8 @@
   void AddonFlasher::flash() {
     VLF("MSG: AddonFlasher, setting addon program mode");
 
-    #if defined(SERIAL_A_RX) && defined(SERIAL_A_TX) && !defined(SERIAL_A_RXTX_SET)
-      SERIAL_A.begin(115200, SERIAL_8N1, SERIAL_A_RX, SERIAL_A_TX);
-    #else
-      SERIAL_A.begin(115200);
-    #endif
-
-    #if defined(SERIAL_PASSTHROUGH_RX) && defined(SERIAL_PASSTHROUGH_TX) && !defined(SERIAL_PASSTHROUGH_RXTX_SET)
-      SERIAL_PASSTHROUGH.begin(115200, SERIAL_8N1, SERIAL_PASSTHROUGH_RX, SERIAL_PASSTHROUGH_TX);
-    #else
-      SERIAL_PASSTHROUGH.begin(115200);
-    #endif
+    // esptool always connects at 115200 baud, it may then ask for a faster rate
+    serialBegin(115200);
     tasks.yield(1000);
 
     // enter program mode
@@ -104,7 +104,31 @@ bool Features::command(char *reply, char *command, char *parameter, bool *supres
       strcat(reply, s);
 
       *numericReply = false;
-    } else return false;
+    } else
+
+    #if INTERVALOMETER_TIMED == ON
+      // :GXQn#
+      // where n = 1..8 to get intervalometer hold and the UT1 start time of the last exposure
+      // returns h,YYYY-MM-DDTHH:MM:SS.sss# or h,0# if no exposure was made, h is 1 to hold exposures during gotos
+      if (parameter[0] == 'Q') {
+        int i = parameter[1] - '1';
+        if (i < 0 || i > 7)  { *commandError = CE_PARAM_FORM; return true; }
+        if (device[i].purpose != INTERVALOMETER) { *commandError = CE_CMD_UNKNOWN; return true; }
+
+        JulianDate start;
+        sprintf(reply, "%d,", (int)device[i].intervalometer->getHold());
+        if (device[i].intervalometer->getStartTime(&start)) {
+          GregorianDate date = calendars.julianToGregorian(start);
+          double seconds = date.hour*3600.0;
+          long s = (long)seconds;
+          sprintf(&reply[strlen(reply)], "%04d-%02d-%02dT%02ld:%02ld:%02ld.%03ld", (int)date.year, (int)date.month, (int)date.day,
+                  s/3600, (s/60) % 60, s % 60, (long)((seconds - s)*1000.0));
+        } else strcat(reply, "0");
+        *numericReply = false;
+      } else
+    #endif
+
+    return false;
   } else
 
   // set auXiliary feature
@@ -169,7 +193,15 @@ bool Features::command(char *reply, char *command, char *parameter, bool *supres
 
         if (parameter[3] == 'C') { // count
           if (f >= 0.0F && f <= 255.0F) device[i].intervalometer->setCount(f); else *commandError = CE_PARAM_RANGE;
-        } else *commandError = CE_PARAM_FORM;
+        } else
+
+        #if INTERVALOMETER_TIMED == ON
+          if (parameter[3] == 'H') { // hold exposures during gotos 0..1
+            if (v >= 0 && v <= 1) device[i].intervalometer->setHold(v); else *commandError = CE_PARAM_RANGE;
+          } else
+        #endif
+
+        *commandError = CE_PARAM_FORM;
       }
     } else return false;
   } else return false;
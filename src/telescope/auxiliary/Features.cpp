@@ -40,7 +40,7 @@ void Features::init() {
 
     if (device[i].purpose == INTERVALOMETER) {
       device[i].intervalometer = new Intervalometer;
-      device[i].intervalometer->init(i);
+      device[i].intervalometer->init(i, device[i].pin, device[i].active);
       pinModeEx(device[i].pin, OUTPUT);
       digitalWriteEx(device[i].pin, device[i].value == device[i].active);
     }
@@ -31,12 +31,22 @@ void DewHeater::init(int index) {
 }
 
 void DewHeater::poll(float deltaAboveDewPointC) {
-  if (isnan(deltaAboveDewPointC)) { heaterOn = false; return; }
+  if (isnan(deltaAboveDewPointC)) {
+    heaterOn = false;
+    #if DEW_HEATER_PI == ON
+      lastDelta = NAN;
+    #endif
+    return;
+  }
     
   if (!enabled) return;
 
   int switchTimeMs = 0;
-  switchTimeMs = map(lroundf(deltaAboveDewPointC*10.0F), lroundf(zero*10.0F), lroundf(span*10.0F), DEW_HEATER_PULSE_WIDTH_MS, 0);
+  #if DEW_HEATER_PI == ON
+    switchTimeMs = piSwitchTime(deltaAboveDewPointC);
+  #else
+    switchTimeMs = map(lroundf(deltaAboveDewPointC*10.0F), lroundf(zero*10.0F), lroundf(span*10.0F), DEW_HEATER_PULSE_WIDTH_MS, 0);
+  #endif
   switchTimeMs = constrain(switchTimeMs, 0, DEW_HEATER_PULSE_WIDTH_MS);
   #ifdef DEW_HEATER_MAX_POWER
     switchTimeMs = lroundf(switchTimeMs*(DEW_HEATER_MAX_POWER/100.0));
@@ -56,6 +66,44 @@ void DewHeater::poll(float deltaAboveDewPointC) {
   }
 }
 
+#if DEW_HEATER_PI == ON
+  // get the heater on time in ms for each pulse
+  int DewHeater::piSwitchTime(float deltaAboveDewPointC) {
+    unsigned long now = millis();
+    if (isnan(lastDelta)) {
+      lastDelta = deltaAboveDewPointC;
+      lastUpdate = now - DEW_HEATER_PI_PERIOD_MS;
+      slope = 0.0F;
+    }
+
+    if ((long)(now - lastUpdate) >= DEW_HEATER_PI_PERIOD_MS) {
+      float dt = (now - lastUpdate)/1000.0F;
+      lastUpdate = now;
+
+      // the margin trend, lightly filtered since it's the difference of two sensors
+      slope = slope*0.75F + ((deltaAboveDewPointC - lastDelta)/dt)*0.25F;
+      lastDelta = deltaAboveDewPointC;
+
+      // the error is where the margin is headed, scaled so zero gives +1 and span gives -1
+      // the proportional part alone is half the power of the proportional mode's swing, the
+      // integral then settles on the least power that holds the margin at the midpoint
+      float band = (span - zero)/2.0F;
+      float error = ((zero + band) - (deltaAboveDewPointC + slope*DEW_HEATER_PI_LOOKAHEAD))/band;
+      float p = error*0.5F;
+
+      // don't wind up the integral while the output is saturated
+      if (!(power >= 1.0F && error > 0.0F) && !(power <= 0.0F && error < 0.0F)) {
+        integral += p*dt/DEW_HEATER_PI_INTEGRAL_TIME;
+        integral = constrain(integral, 0.0F, 1.0F);
+      }
+
+      power = constrain(p + integral, 0.0F, 1.0F);
+    }
+
+    return lroundf(power*DEW_HEATER_PULSE_WIDTH_MS);
+  }
+#endif
+
 float DewHeater::getZero() {
   return zero;
 }
@@ -87,6 +135,11 @@ bool DewHeater::isEnabled() {
 void DewHeater::enable(bool state) {
   heaterOn = false;
   enabled = state;
+  #if DEW_HEATER_PI == ON
+    lastDelta = NAN;
+    integral = 0.0F;
+    power = 0.0F;
+  #endif
 }
 
 bool DewHeater::isOn() {
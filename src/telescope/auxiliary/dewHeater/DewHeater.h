@@ -16,6 +16,24 @@
   #define DEW_HEATER_PULSE_WIDTH_MS 2000
 #endif
 
+// ON for PI control of the margin above the dew point, held midway between zero and span, using the trend
+// of that margin to look ahead, OFF for power in proportion to where the margin is between zero and span
+#ifndef DEW_HEATER_PI
+  #define DEW_HEATER_PI OFF
+#endif
+#ifndef DEW_HEATER_PI_PERIOD_MS
+  #define DEW_HEATER_PI_PERIOD_MS 10000   // in ms, how often the power level is updated
+#endif
+#ifndef DEW_HEATER_PI_LOOKAHEAD
+  #define DEW_HEATER_PI_LOOKAHEAD 300.0F  // in seconds, how far ahead the margin trend is followed
+#endif
+#ifndef DEW_HEATER_PI_INTEGRAL_TIME
+  #define DEW_HEATER_PI_INTEGRAL_TIME 600.0F // in seconds
+#endif
+#if DEW_HEATER_PI != OFF && DEW_HEATER_PI != ON
+  #error "Configuration (Config.h): Setting DEW_HEATER_PI unknown, use OFF or ON."
+#endif
+
 class DewHeater {
   public:
     void init(int index);
@@ -34,6 +52,17 @@ class DewHeater {
     bool isOn();
 
   private:
+    #if DEW_HEATER_PI == ON
+      // get the heater on time in ms for each pulse
+      int piSwitchTime(float deltaAboveDewPointC);
+
+      unsigned long lastUpdate = 0;
+      float lastDelta = NAN;
+      float slope = 0.0F;    // in deg. C/s
+      float integral = 0.0F;
+      float power = 0.0F;    // 0 to 1
+    #endif
+
     unsigned long lastHeaterCycle = 0;
     unsigned long currentTime = 0;
 
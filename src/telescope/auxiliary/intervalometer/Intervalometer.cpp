@@ -5,8 +5,23 @@
 
 #ifdef FEATURES_PRESENT
 
-void Intervalometer::init(int index) {
+#if INTERVALOMETER_TIMED == ON
+  #include "../../../lib/tasks/OnTask.h"
+  #include "../../mount/goto/Goto.h"
+  #include "../../mount/site/Site.h"
+
+  void intervalometerEdgeWrapper(void *context) { ((Intervalometer*)context)->edge(); }
+#endif
+
+void Intervalometer::init(int index, int pin, int active) {
   this->index = index;
+  #if INTERVALOMETER_TIMED == ON
+    this->pin = pin;
+    this->active = active;
+  #else
+    UNUSED(pin);
+    UNUSED(active);
+  #endif
 
   // write the default settings to NV
   if (!nv.hasValidKey()) {
@@ -19,8 +34,82 @@ void Intervalometer::init(int index) {
   expTime = byteToTime(nv.readUC(NV_FEATURE_SETTINGS_BASE + index*3));
   expDelay = byteToTime(nv.readUC(NV_FEATURE_SETTINGS_BASE + index*3 + 1));
   expCount = nv.readUC(NV_FEATURE_SETTINGS_BASE + index*3 + 2);
+
+  #if INTERVALOMETER_TIMED == ON
+    VF("MSG: Intervalometer/Feature"); V(index + 1); VF(", start edge task (rate 1ms priority 0)... ");
+    taskHandle = tasks.add(1, 0, true, 0, intervalometerEdgeWrapper, this, "Intrvl");
+    if (taskHandle) { VLF("success"); } else { VLF("FAILED!"); }
+  #endif
 }
 
+#if INTERVALOMETER_TIMED == ON
+  void Intervalometer::poll() {
+    // timestamp the exposure start, site time is taken now and backed off by the time since the edge
+    if (startPending) {
+      startPending = false;
+      #ifdef MOUNT_PRESENT
+        JulianDate now = site.getDateTime();
+        now.hour -= (unsigned long)(micros() - startMicros)/3600000000.0;
+        if (now.hour < 0.0) { now.hour += 24.0; now.day -= 1.0; }
+        startTime = now;
+        startValid = true;
+      #endif
+    }
+  }
+
+  // switch the shutter at the exposure edges
+  void Intervalometer::edge() {
+    if (!enabled) return;
+    unsigned long now = micros();
+
+    if (pressed == P_EXP_START) {
+      // count and stop when done
+      if (thisCount == 0) { pressed = P_STANDBY; enabled = false; return; }
+
+      // wait for the mount to be done moving and settled
+      #ifdef MOUNT_PRESENT
+        if (hold && goTo.state != GS_NONE) return;
+      #endif
+      thisCount--;
+
+      // start a new exposure
+      pressed = P_EXP_DONE;
+      digitalWriteEx(pin, isOn() == active);
+      startMicros = now;
+      startPending = true;
+      stateMicros = now;
+    } else
+
+    // wait until exposure is done
+    if (pressed == P_EXP_DONE && (unsigned long)(now - stateMicros) >= (unsigned long)(expTime*1000000.0)) {
+      // finish an exposure
+      pressed = P_WAIT;
+      digitalWriteEx(pin, isOn() == active);
+      stateMicros = now;
+    } else
+
+    // wait until pause between exposures is done
+    if (pressed == P_WAIT && (unsigned long)(now - stateMicros) >= (unsigned long)(expDelay*1000000.0)) {
+      // start next count
+      pressed = P_EXP_START;
+    }
+  }
+
+  bool Intervalometer::getHold() {
+    return hold;
+  }
+
+  void Intervalometer::setHold(bool state) {
+    hold = state;
+  }
+
+  // gets the UT1 Julian date/time the last exposure started, false if none has
+  bool Intervalometer::getStartTime(JulianDate *julianDate) {
+    if (!startValid) return false;
+    *julianDate = startTime;
+    return true;
+  }
+#else
 void Intervalometer::poll() {
   if (!enabled) return;
 
@@ -47,6 +136,7 @@ void Intervalometer::poll() {
     pressed = P_EXP_START;
   }
 }
+#endif
 
 float Intervalometer::getExposure() {
   return expTime;
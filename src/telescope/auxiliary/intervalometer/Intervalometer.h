@@ -12,12 +12,37 @@
 
 #ifdef FEATURES_PRESENT
 
+// ON to switch the shutter from a 1ms highest priority task with edges timed in microseconds (instead of
+// the 20ms feature poll,) to record the start time of each exposure, and to allow holding exposures during gotos
+#ifndef INTERVALOMETER_TIMED
+  #define INTERVALOMETER_TIMED OFF
+#endif
+#if INTERVALOMETER_TIMED != OFF && INTERVALOMETER_TIMED != ON
+  #error "Configuration (Config.h): Setting INTERVALOMETER_TIMED unknown, use OFF or ON."
+#endif
+
+#if INTERVALOMETER_TIMED == ON
+  #include "../../../lib/calendars/Calendars.h"
+#endif
+
 class Intervalometer {
   public:
-    void init(int index);
+    void init(int index, int pin, int active);
 
     void poll();
 
+    #if INTERVALOMETER_TIMED == ON
+      // switch the shutter at the exposure edges
+      void edge();
+
+      // hold the next exposure until any goto is done and settled
+      bool getHold();
+      void setHold(bool state);
+
+      // gets the UT1 Julian date/time the last exposure started, false if none has
+      bool getStartTime(JulianDate *julianDate);
+    #endif
+
     float getExposure();
     void setExposure(float t);
 
@@ -51,5 +76,21 @@ class Intervalometer {
     unsigned long waitDone = 0;
 
     int index = 0;
+
+    #if INTERVALOMETER_TIMED == ON
+      // shutter pin and on state
+      int pin = OFF;
+      int active = HIGH;
+
+      bool hold = false;
+      bool startPending = false;
+      bool startValid = false;
+      JulianDate startTime;
+
+      // edge timing, unsigned differences cover the full hour range
+      unsigned long startMicros = 0;
+      unsigned long stateMicros = 0;
+      uint8_t taskHandle = 0;
+    #endif
 };
 #endif
@@ -13,6 +13,10 @@
       Quadrature encAxis4(AXIS4_ENCODER_A_PIN, AXIS4_ENCODER_B_PIN, 4);
     #elif AXIS4_ENCODER == AB_ESP32
       QuadratureEsp32 encAxis4(AXIS4_ENCODER_A_PIN, AXIS4_ENCODER_B_PIN, 4);
+    #elif AXIS4_ENCODER == AB_STM32
+      QuadratureStm32 encAxis4(AXIS4_ENCODER_A_PIN, AXIS4_ENCODER_B_PIN, 4);
+    #elif AXIS4_ENCODER == AB_TEENSY4
+      QuadratureTeensy4 encAxis4(AXIS4_ENCODER_A_PIN, AXIS4_ENCODER_B_PIN, 4);
     #elif AXIS4_ENCODER == CW_CCW
       CwCcw encAxis4(AXIS4_ENCODER_A_PIN, AXIS4_ENCODER_B_PIN, 4);
     #elif AXIS4_ENCODER == PULSE_DIR
@@ -30,8 +34,8 @@
     #endif
 
     #if defined(AXIS4_SERVO_DC)
-      const ServoDcPins ServoPinsAxis4 = {AXIS4_SERVO_PH1_PIN, AXIS4_SERVO_PH1_STATE, AXIS4_SERVO_PH2_PIN, AXIS4_SERVO_PH2_STATE, AXIS4_ENABLE_PIN, AXIS4_ENABLE_STATE, AXIS4_FAULT_PIN};
-      const ServoDcSettings ServoSettingsAxis4 = {AXIS4_DRIVER_MODEL, AXIS4_DRIVER_STATUS, AXIS4_SERVO_MAX_VELOCITY, AXIS4_SERVO_ACCELERATION};
+      const ServoDcPins ServoPinsAxis4 = {AXIS4_SERVO_PH1_PIN, AXIS4_SERVO_PH1_STATE, AXIS4_SERVO_PH2_PIN, AXIS4_SERVO_PH2_STATE, AXIS4_ENABLE_PIN, AXIS4_ENABLE_STATE, AXIS4_FAULT_PIN, AXIS4_SERVO_CURRENT_PIN};
+      const ServoDcSettings ServoSettingsAxis4 = {AXIS4_DRIVER_MODEL, AXIS4_DRIVER_STATUS, AXIS4_SERVO_MAX_VELOCITY, AXIS4_SERVO_ACCELERATION, AXIS4_SERVO_CURRENT_SCALE, AXIS4_SERVO_CURRENT_LIMIT};
       ServoDc driver4(4, &ServoPinsAxis4, &ServoSettingsAxis4);
     #elif defined(AXIS4_SERVO_TMC2209)
       const ServoTmcPins ServoPinsAxis4 = {AXIS4_STEP_PIN, AXIS4_DIR_PIN, AXIS4_ENABLE_PIN, AXIS4_ENABLE_STATE, AXIS4_M0_PIN, AXIS4_M1_PIN, AXIS4_FAULT_PIN};
@@ -44,7 +48,7 @@
 
   #ifdef AXIS4_STEP_DIR_PRESENT
     const StepDirDriverPins DriverPinsAxis4 = {AXIS4_M0_PIN, AXIS4_M1_PIN, AXIS4_M2_PIN, AXIS4_M2_ON_STATE, AXIS4_M3_PIN, AXIS4_DECAY_PIN, AXIS4_FAULT_PIN};
-    const StepDirDriverSettings DriverSettingsAxis4 = {AXIS4_DRIVER_MODEL, AXIS4_DRIVER_MICROSTEPS, AXIS4_DRIVER_MICROSTEPS_GOTO, AXIS4_DRIVER_IHOLD, AXIS4_DRIVER_IRUN, AXIS4_DRIVER_IGOTO, AXIS4_DRIVER_INTPOL, AXIS4_DRIVER_DECAY, AXIS4_DRIVER_DECAY_GOTO, AXIS4_DRIVER_STATUS};
+    const StepDirDriverSettings DriverSettingsAxis4 = {AXIS4_DRIVER_MODEL, AXIS4_DRIVER_MICROSTEPS, AXIS4_DRIVER_MICROSTEPS_GOTO, AXIS4_DRIVER_IHOLD, AXIS4_DRIVER_IRUN, AXIS4_DRIVER_IGOTO, AXIS4_DRIVER_INTPOL, AXIS4_DRIVER_DECAY, AXIS4_DRIVER_DECAY_GOTO, AXIS4_DRIVER_STATUS, AXIS4_DRIVER_STALL, AXIS4_DRIVER_DECAY_FAST, AXIS4_DRIVER_IFAST, AXIS4_DRIVER_FAST_RATE, AXIS4_DRIVER_ITRACK};
     #if defined(AXIS4_STEP_DIR_LEGACY)
       StepDirGeneric driver4(4, &DriverPinsAxis4, &DriverSettingsAxis4);
     #elif defined(AXIS4_STEP_DIR_TMC_SPI)
@@ -70,6 +74,10 @@
       Quadrature encAxis5(AXIS5_ENCODER_A_PIN, AXIS5_ENCODER_B_PIN, 5);
     #elif AXIS5_ENCODER == AB_ESP32
       QuadratureEsp32 encAxis5(AXIS5_ENCODER_A_PIN, AXIS5_ENCODER_B_PIN, 5);
+    #elif AXIS5_ENCODER == AB_STM32
+      QuadratureStm32 encAxis5(AXIS5_ENCODER_A_PIN, AXIS5_ENCODER_B_PIN, 5);
+    #elif AXIS5_ENCODER == AB_TEENSY4
+      QuadratureTeensy4 encAxis5(AXIS5_ENCODER_A_PIN, AXIS5_ENCODER_B_PIN, 5);
     #elif AXIS5_ENCODER == CW_CCW
       CwCcw encAxis5(AXIS5_ENCODER_A_PIN, AXIS5_ENCODER_B_PIN, 5);
     #elif AXIS5_ENCODER == PULSE_DIR
@@ -87,8 +95,8 @@
     #endif
 
     #if defined(AXIS5_SERVO_DC)
-      const ServoDcPins ServoPinsAxis5 = {AXIS5_SERVO_PH1_PIN, AXIS5_SERVO_PH1_STATE, AXIS5_SERVO_PH2_PIN, AXIS5_SERVO_PH2_STATE, AXIS5_ENABLE_PIN, AXIS5_ENABLE_STATE, AXIS5_FAULT_PIN};
-      const ServoDcSettings ServoSettingsAxis5 = {AXIS5_DRIVER_MODEL, AXIS5_DRIVER_STATUS, AXIS5_SERVO_MAX_VELOCITY, AXIS5_SERVO_ACCELERATION};
+      const ServoDcPins ServoPinsAxis5 = {AXIS5_SERVO_PH1_PIN, AXIS5_SERVO_PH1_STATE, AXIS5_SERVO_PH2_PIN, AXIS5_SERVO_PH2_STATE, AXIS5_ENABLE_PIN, AXIS5_ENABLE_STATE, AXIS5_FAULT_PIN, AXIS5_SERVO_CURRENT_PIN};
+      const ServoDcSettings ServoSettingsAxis5 = {AXIS5_DRIVER_MODEL, AXIS5_DRIVER_STATUS, AXIS5_SERVO_MAX_VELOCITY, AXIS5_SERVO_ACCELERATION, AXIS5_SERVO_CURRENT_SCALE, AXIS5_SERVO_CURRENT_LIMIT};
       ServoDc driver5(5, &ServoPinsAxis5, &ServoSettingsAxis5);
     #elif defined(AXIS5_SERVO_TMC2209)
       const ServoTmcPins ServoPinsAxis5 = {AXIS5_STEP_PIN, AXIS5_DIR_PIN, AXIS5_ENABLE_PIN, AXIS5_ENABLE_STATE, AXIS5_M0_PIN, AXIS5_M1_PIN, AXIS5_FAULT_PIN};
@@ -101,7 +109,7 @@
 
   #ifdef AXIS5_STEP_DIR_PRESENT
     const StepDirDriverPins DriverPinsAxis5 = {AXIS5_M0_PIN, AXIS5_M1_PIN, AXIS5_M2_PIN, AXIS5_M2_ON_STATE, AXIS5_M3_PIN, AXIS5_DECAY_PIN, AXIS5_FAULT_PIN};
-    const StepDirDriverSettings DriverSettingsAxis5 = {AXIS5_DRIVER_MODEL, AXIS5_DRIVER_MICROSTEPS, AXIS5_DRIVER_MICROSTEPS_GOTO, AXIS5_DRIVER_IHOLD, AXIS5_DRIVER_IRUN, AXIS5_DRIVER_IGOTO, AXIS5_DRIVER_INTPOL, AXIS5_DRIVER_DECAY, AXIS5_DRIVER_DECAY_GOTO, AXIS5_DRIVER_STATUS};
+    const StepDirDriverSettings DriverSettingsAxis5 = {AXIS5_DRIVER_MODEL, AXIS5_DRIVER_MICROSTEPS, AXIS5_DRIVER_MICROSTEPS_GOTO, AXIS5_DRIVER_IHOLD, AXIS5_DRIVER_IRUN, AXIS5_DRIVER_IGOTO, AXIS5_DRIVER_INTPOL, AXIS5_DRIVER_DECAY, AXIS5_DRIVER_DECAY_GOTO, AXIS5_DRIVER_STATUS, AXIS5_DRIVER_STALL, AXIS5_DRIVER_DECAY_FAST, AXIS5_DRIVER_IFAST, AXIS5_DRIVER_FAST_RATE, AXIS5_DRIVER_ITRACK};
     #if defined(AXIS5_STEP_DIR_LEGACY)
       StepDirGeneric driver5(5, &DriverPinsAxis5, &DriverSettingsAxis5);
     #elif defined(AXIS5_STEP_DIR_TMC_SPI)
@@ -127,6 +135,10 @@
       Quadrature encAxis6(AXIS6_ENCODER_A_PIN, AXIS6_ENCODER_B_PIN, 6);
     #elif AXIS6_ENCODER == AB_ESP32
       QuadratureEsp32 encAxis6(AXIS6_ENCODER_A_PIN, AXIS6_ENCODER_B_PIN, 6);
+    #elif AXIS6_ENCODER == AB_STM32
+      QuadratureStm32 encAxis6(AXIS6_ENCODER_A_PIN, AXIS6_ENCODER_B_PIN, 6);
+    #elif AXIS6_ENCODER == AB_TEENSY4
+      QuadratureTeensy4 encAxis6(AXIS6_ENCODER_A_PIN, AXIS6_ENCODER_B_PIN, 6);
     #elif AXIS6_ENCODER == CW_CCW
       CwCcw encAxis6(AXIS6_ENCODER_A_PIN, AXIS6_ENCODER_B_PIN, 6);
     #elif AXIS6_ENCODER == PULSE_DIR
@@ -144,8 +156,8 @@
     #endif
 
     #if defined(AXIS6_SERVO_DC)
-      const ServoDcPins ServoPinsAxis6 = {AXIS6_SERVO_PH1_PIN, AXIS6_SERVO_PH1_STATE, AXIS6_SERVO_PH2_PIN, AXIS6_SERVO_PH2_STATE, AXIS6_ENABLE_PIN, AXIS6_ENABLE_STATE, AXIS6_FAULT_PIN};
-      const ServoDcSettings ServoSettingsAxis6 = {AXIS6_DRIVER_MODEL, AXIS6_DRIVER_STATUS, AXIS6_SERVO_MAX_VELOCITY, AXIS6_SERVO_ACCELERATION};
+      const ServoDcPins ServoPinsAxis6 = {AXIS6_SERVO_PH1_PIN, AXIS6_SERVO_PH1_STATE, AXIS6_SERVO_PH2_PIN, AXIS6_SERVO_PH2_STATE, AXIS6_ENABLE_PIN, AXIS6_ENABLE_STATE, AXIS6_FAULT_PIN, AXIS6_SERVO_CURRENT_PIN};
+      const ServoDcSettings ServoSettingsAxis6 = {AXIS6_DRIVER_MODEL, AXIS6_DRIVER_STATUS, AXIS6_SERVO_MAX_VELOCITY, AXIS6_SERVO_ACCELERATION, AXIS6_SERVO_CURRENT_SCALE, AXIS6_SERVO_CURRENT_LIMIT};
       ServoDc driver6(6, &ServoPinsAxis6, &ServoSettingsAxis6);
     #elif defined(AXIS6_SERVO_TMC2209)
       const ServoTmcPins ServoPinsAxis6 = {AXIS6_STEP_PIN, AXIS6_DIR_PIN, AXIS6_ENABLE_PIN, AXIS6_ENABLE_STATE, AXIS6_M0_PIN, AXIS6_M1_PIN, AXIS6_FAULT_PIN};
@@ -158,7 +170,7 @@
 
   #ifdef AXIS6_STEP_DIR_PRESENT
     const StepDirDriverPins DriverPinsAxis6 = {AXIS6_M0_PIN, AXIS6_M1_PIN, AXIS6_M2_PIN, AXIS6_M2_ON_STATE, AXIS6_M3_PIN, AXIS6_DECAY_PIN, AXIS6_FAULT_PIN};
-    const StepDirDriverSettings DriverSettingsAxis6 = {AXIS6_DRIVER_MODEL, AXIS6_DRIVER_MICROSTEPS, AXIS6_DRIVER_MICROSTEPS_GOTO, AXIS6_DRIVER_IHOLD, AXIS6_DRIVER_IRUN, AXIS6_DRIVER_IGOTO, AXIS6_DRIVER_INTPOL, AXIS6_DRIVER_DECAY, AXIS6_DRIVER_DECAY_GOTO, AXIS6_DRIVER_STATUS};
+    const StepDirDriverSettings DriverSettingsAxis6 = {AXIS6_DRIVER_MODEL, AXIS6_DRIVER_MICROSTEPS, AXIS6_DRIVER_MICROSTEPS_GOTO, AXIS6_DRIVER_IHOLD, AXIS6_DRIVER_IRUN, AXIS6_DRIVER_IGOTO, AXIS6_DRIVER_INTPOL, AXIS6_DRIVER_DECAY, AXIS6_DRIVER_DECAY_GOTO, AXIS6_DRIVER_STATUS, AXIS6_DRIVER_STALL, AXIS6_DRIVER_DECAY_FAST, AXIS6_DRIVER_IFAST, AXIS6_DRIVER_FAST_RATE, AXIS6_DRIVER_ITRACK};
     #if defined(AXIS6_STEP_DIR_LEGACY)
       StepDirGeneric driver6(6, &DriverPinsAxis6, &DriverSettingsAxis6);
     #elif defined(AXIS6_STEP_DIR_TMC_SPI)
@@ -184,6 +196,10 @@
       Quadrature encAxis7(AXIS7_ENCODER_A_PIN, AXIS7_ENCODER_B_PIN, 7);
     #elif AXIS7_ENCODER == AB_ESP32
       QuadratureEsp32 encAxis7(AXIS7_ENCODER_A_PIN, AXIS7_ENCODER_B_PIN, 7);
+    #elif AXIS7_ENCODER == AB_STM32
+      QuadratureStm32 encAxis7(AXIS7_ENCODER_A_PIN, AXIS7_ENCODER_B_PIN, 7);
+    #elif AXIS7_ENCODER == AB_TEENSY4
+      QuadratureTeensy4 encAxis7(AXIS7_ENCODER_A_PIN, AXIS7_ENCODER_B_PIN, 7);
     #elif AXIS7_ENCODER == CW_CCW
       CwCcw encAxis7(AXIS7_ENCODER_A_PIN, AXIS7_ENCODER_B_PIN, 7);
     #elif AXIS7_ENCODER == PULSE_DIR
@@ -201,8 +217,8 @@
     #endif
 
     #if defined(AXIS7_SERVO_DC)
-      const ServoDcPins ServoPinsAxis7 = {AXIS7_SERVO_PH1_PIN, AXIS7_SERVO_PH1_STATE, AXIS7_SERVO_PH2_PIN, AXIS7_SERVO_PH2_STATE, AXIS7_ENABLE_PIN, AXIS7_ENABLE_STATE, AXIS7_FAULT_PIN};
-      const ServoDcSettings ServoSettingsAxis7 = {AXIS7_DRIVER_MODEL, AXIS7_DRIVER_STATUS, AXIS7_SERVO_MAX_VELOCITY, AXIS7_SERVO_ACCELERATION};
+      const ServoDcPins ServoPinsAxis7 = {AXIS7_SERVO_PH1_PIN, AXIS7_SERVO_PH1_STATE, AXIS7_SERVO_PH2_PIN, AXIS7_SERVO_PH2_STATE, AXIS7_ENABLE_PIN, AXIS7_ENABLE_STATE, AXIS7_FAULT_PIN, AXIS7_SERVO_CURRENT_PIN};
+      const ServoDcSettings ServoSettingsAxis7 = {AXIS7_DRIVER_MODEL, AXIS7_DRIVER_STATUS, AXIS7_SERVO_MAX_VELOCITY, AXIS7_SERVO_ACCELERATION, AXIS7_SERVO_CURRENT_SCALE, AXIS7_SERVO_CURRENT_LIMIT};
       ServoDc driver7(7, &ServoPinsAxis7, &ServoSettingsAxis7);
     #elif defined(AXIS7_SERVO_TMC2209)
       const ServoTmcPins ServoPinsAxis7 = {AXIS7_STEP_PIN, AXIS7_DIR_PIN, AXIS7_ENABLE_PIN, AXIS7_ENABLE_STATE, AXIS7_M0_PIN, AXIS7_M1_PIN, AXIS7_FAULT_PIN};
@@ -215,7 +231,7 @@
 
   #ifdef AXIS7_STEP_DIR_PRESENT
     const StepDirDriverPins DriverPinsAxis7 = {AXIS7_M0_PIN, AXIS7_M1_PIN, AXIS7_M2_PIN, AXIS7_M2_ON_STATE, AXIS7_M3_PIN, AXIS7_DECAY_PIN, AXIS7_FAULT_PIN};
-    const StepDirDriverSettings DriverSettingsAxis7 = {AXIS7_DRIVER_MODEL, AXIS7_DRIVER_MICROSTEPS, AXIS7_DRIVER_MICROSTEPS_GOTO, AXIS7_DRIVER_IHOLD, AXIS7_DRIVER_IRUN, AXIS7_DRIVER_IGOTO, AXIS7_DRIVER_INTPOL, AXIS7_DRIVER_DECAY, AXIS7_DRIVER_DECAY_GOTO, AXIS7_DRIVER_STATUS};
+    const StepDirDriverSettings DriverSettingsAxis7 = {AXIS7_DRIVER_MODEL, AXIS7_DRIVER_MICROSTEPS, AXIS7_DRIVER_MICROSTEPS_GOTO, AXIS7_DRIVER_IHOLD, AXIS7_DRIVER_IRUN, AXIS7_DRIVER_IGOTO, AXIS7_DRIVER_INTPOL, AXIS7_DRIVER_DECAY, AXIS7_DRIVER_DECAY_GOTO, AXIS7_DRIVER_STATUS, AXIS7_DRIVER_STALL, AXIS7_DRIVER_DECAY_FAST, AXIS7_DRIVER_IFAST, AXIS7_DRIVER_FAST_RATE, AXIS7_DRIVER_ITRACK};
     #if defined(AXIS7_STEP_DIR_LEGACY)
       StepDirGeneric driver7(7, &DriverPinsAxis7, &DriverSettingsAxis7);
     #elif defined(AXIS7_STEP_DIR_TMC_SPI)
@@ -241,6 +257,10 @@
       Quadrature encAxis8(AXIS8_ENCODER_A_PIN, AXIS8_ENCODER_B_PIN, 8);
     #elif AXIS8_ENCODER == AB_ESP32
       QuadratureEsp32 encAxis8(AXIS8_ENCODER_A_PIN, AXIS8_ENCODER_B_PIN, 8);
+    #elif AXIS8_ENCODER == AB_STM32
+      QuadratureStm32 encAxis8(AXIS8_ENCODER_A_PIN, AXIS8_ENCODER_B_PIN, 8);
+    #elif AXIS8_ENCODER == AB_TEENSY4
+      QuadratureTeensy4 encAxis8(AXIS8_ENCODER_A_PIN, AXIS8_ENCODER_B_PIN, 8);
     #elif AXIS8_ENCODER == CW_CCW
       CwCcw encAxis8(AXIS8_ENCODER_A_PIN, AXIS8_ENCODER_B_PIN, 8);
     #elif AXIS8_ENCODER == PULSE_DIR
@@ -258,8 +278,8 @@
     #endif
 
     #if defined(AXIS8_SERVO_DC)
-      const ServoDcPins ServoPinsAxis8 = {AXIS8_SERVO_PH1_PIN, AXIS8_SERVO_PH1_STATE, AXIS8_SERVO_PH2_PIN, AXIS8_SERVO_PH2_STATE, AXIS8_ENABLE_PIN, AXIS8_ENABLE_STATE, AXIS8_FAULT_PIN};
-      const ServoDcSettings ServoSettingsAxis8 = {AXIS8_DRIVER_MODEL, AXIS8_DRIVER_STATUS, AXIS8_SERVO_MAX_VELOCITY, AXIS8_SERVO_ACCELERATION};
+      const ServoDcPins ServoPinsAxis8 = {AXIS8_SERVO_PH1_PIN, AXIS8_SERVO_PH1_STATE, AXIS8_SERVO_PH2_PIN, AXIS8_SERVO_PH2_STATE, AXIS8_ENABLE_PIN, AXIS8_ENABLE_STATE, AXIS8_FAULT_PIN, AXIS8_SERVO_CURRENT_PIN};
+      const ServoDcSettings ServoSettingsAxis8 = {AXIS8_DRIVER_MODEL, AXIS8_DRIVER_STATUS, AXIS8_SERVO_MAX_VELOCITY, AXIS8_SERVO_ACCELERATION, AXIS8_SERVO_CURRENT_SCALE, AXIS8_SERVO_CURRENT_LIMIT};
       ServoDc driver8(8, &ServoPinsAxis8, &ServoSettingsAxis8);
     #elif defined(AXIS8_SERVO_TMC2209)
       const ServoTmcPins ServoPinsAxis8 = {AXIS8_STEP_PIN, AXIS8_DIR_PIN, AXIS8_ENABLE_PIN, AXIS8_ENABLE_STATE, AXIS8_M0_PIN, AXIS8_M1_PIN, AXIS8_FAULT_PIN};
@@ -272,7 +292,7 @@
 
   #ifdef AXIS8_STEP_DIR_PRESENT
     const StepDirDriverPins DriverPinsAxis8 = {AXIS8_M0_PIN, AXIS8_M1_PIN, AXIS8_M2_PIN, AXIS8_M2_ON_STATE, AXIS8_M3_PIN, AXIS8_DECAY_PIN, AXIS8_FAULT_PIN};
-    const StepDirDriverSettings DriverSettingsAxis8 = {AXIS8_DRIVER_MODEL, AXIS8_DRIVER_MICROSTEPS, AXIS8_DRIVER_MICROSTEPS_GOTO, AXIS8_DRIVER_IHOLD, AXIS8_DRIVER_IRUN, AXIS8_DRIVER_IGOTO, AXIS8_DRIVER_INTPOL, AXIS8_DRIVER_DECAY, AXIS8_DRIVER_DECAY_GOTO, AXIS8_DRIVER_STATUS};
+    const StepDirDriverSettings DriverSettingsAxis8 = {AXIS8_DRIVER_MODEL, AXIS8_DRIVER_MICROSTEPS, AXIS8_DRIVER_MICROSTEPS_GOTO, AXIS8_DRIVER_IHOLD, AXIS8_DRIVER_IRUN, AXIS8_DRIVER_IGOTO, AXIS8_DRIVER_INTPOL, AXIS8_DRIVER_DECAY, AXIS8_DRIVER_DECAY_GOTO, AXIS8_DRIVER_STATUS, AXIS8_DRIVER_STALL, AXIS8_DRIVER_DECAY_FAST, AXIS8_DRIVER_IFAST, AXIS8_DRIVER_FAST_RATE, AXIS8_DRIVER_ITRACK};
     #if defined(AXIS8_STEP_DIR_LEGACY)
       StepDirGeneric driver8(8, &DriverPinsAxis8, &DriverSettingsAxis8);
     #elif defined(AXIS8_STEP_DIR_TMC_SPI)
@@ -298,6 +318,10 @@
       Quadrature encAxis9(AXIS9_ENCODER_A_PIN, AXIS9_ENCODER_B_PIN, 9);
     #elif AXIS9_ENCODER == AB_ESP32
       QuadratureEsp32 encAxis9(AXIS9_ENCODER_A_PIN, AXIS9_ENCODER_B_PIN, 9);
+    #elif AXIS9_ENCODER == AB_STM32
+      QuadratureStm32 encAxis9(AXIS9_ENCODER_A_PIN, AXIS9_ENCODER_B_PIN, 9);
+    #elif AXIS9_ENCODER == AB_TEENSY4
+      QuadratureTeensy4 encAxis9(AXIS9_ENCODER_A_PIN, AXIS9_ENCODER_B_PIN, 9);
     #elif AXIS9_ENCODER == CW_CCW
       CwCcw encAxis9(AXIS9_ENCODER_A_PIN, AXIS9_ENCODER_B_PIN, 9);
     #elif AXIS9_ENCODER == PULSE_DIR
@@ -315,8 +339,8 @@
     #endif
 
     #if defined(AXIS9_SERVO_DC)
-      const ServoDcPins ServoPinsAxis9 = {AXIS9_SERVO_PH1_PIN, AXIS9_SERVO_PH1_STATE, AXIS9_SERVO_PH2_PIN, AXIS9_SERVO_PH2_STATE, AXIS9_ENABLE_PIN, AXIS9_ENABLE_STATE, AXIS9_FAULT_PIN};
-      const ServoDcSettings ServoSettingsAxis9 = {AXIS9_DRIVER_MODEL, AXIS9_DRIVER_STATUS, AXIS9_SERVO_MAX_VELOCITY, AXIS9_SERVO_ACCELERATION};
+      const ServoDcPins ServoPinsAxis9 = {AXIS9_SERVO_PH1_PIN, AXIS9_SERVO_PH1_STATE, AXIS9_SERVO_PH2_PIN, AXIS9_SERVO_PH2_STATE, AXIS9_ENABLE_PIN, AXIS9_ENABLE_STATE, AXIS9_FAULT_PIN, AXIS9_SERVO_CURRENT_PIN};
+      const ServoDcSettings ServoSettingsAxis9 = {AXIS9_DRIVER_MODEL, AXIS9_DRIVER_STATUS, AXIS9_SERVO_MAX_VELOCITY, AXIS9_SERVO_ACCELERATION, AXIS9_SERVO_CURRENT_SCALE, AXIS9_SERVO_CURRENT_LIMIT};
       ServoDc driver9(9, &ServoPinsAxis9, &ServoSettingsAxis9);
     #elif defined(AXIS9_SERVO_TMC2209)
       const ServoTmcPins ServoPinsAxis9 = {AXIS9_STEP_PIN, AXIS9_DIR_PIN, AXIS9_ENABLE_PIN, AXIS9_ENABLE_STATE, AXIS9_M0_PIN, AXIS9_M1_PIN, AXIS9_FAULT_PIN};
@@ -329,7 +353,7 @@
 
   #ifdef AXIS9_STEP_DIR_PRESENT
     const StepDirDriverPins DriverPinsAxis9 = {AXIS9_M0_PIN, AXIS9_M1_PIN, AXIS9_M2_PIN, AXIS9_M2_ON_STATE, AXIS9_M3_PIN, AXIS9_DECAY_PIN, AXIS9_FAULT_PIN};
-    const StepDirDriverSettings DriverSettingsAxis9 = {AXIS9_DRIVER_MODEL, AXIS9_DRIVER_MICROSTEPS, AXIS9_DRIVER_MICROSTEPS_GOTO, AXIS9_DRIVER_IHOLD, AXIS9_DRIVER_IRUN, AXIS9_DRIVER_IGOTO, AXIS9_DRIVER_INTPOL, AXIS9_DRIVER_DECAY, AXIS9_DRIVER_DECAY_GOTO, AXIS9_DRIVER_STATUS};
+    const StepDirDriverSettings DriverSettingsAxis9 = {AXIS9_DRIVER_MODEL, AXIS9_DRIVER_MICROSTEPS, AXIS9_DRIVER_MICROSTEPS_GOTO, AXIS9_DRIVER_IHOLD, AXIS9_DRIVER_IRUN, AXIS9_DRIVER_IGOTO, AXIS9_DRIVER_INTPOL, AXIS9_DRIVER_DECAY, AXIS9_DRIVER_DECAY_GOTO, AXIS9_DRIVER_STATUS, AXIS9_DRIVER_STALL, AXIS9_DRIVER_DECAY_FAST, AXIS9_DRIVER_IFAST, AXIS9_DRIVER_FAST_RATE, AXIS9_DRIVER_ITRACK};
     #if defined(AXIS9_STEP_DIR_LEGACY)
       StepDirGeneric driver9(9, &DriverPinsAxis9, &DriverSettingsAxis9);
     #elif defined(AXIS9_STEP_DIR_TMC_SPI)
@@ -69,6 +69,40 @@ bool Focuser::command(char *reply, char *command, char *parameter, bool *supress
     } else return false;
   } else
 
+  if (command[0] == 'F' && toupper(command[1]) == 'Y') {
+    // :FY#       Get synchronized goto status
+    //            Returns: M# while any focuser moved by the last :FY is moving
+    //                     S# once all of them have stopped and settled
+    if (parameter[0] == 0) {
+      strcpy(reply, isGroupSettled() ? "S" : "M");
+      *numericReply = false;
+    } else
+
+    // :FY[n1],[n2],...#  Goto focuser target positions together (in microns or steps for :Fy)
+    //            Where [n1] is for focuser #1, [n2] for focuser #2, etc. leave a position empty to skip that focuser
+    //            Return: 0 on failure
+    //                    1 on success
+    {
+      long targets[FOCUSER_MAX];
+      uint8_t mask = 0;
+      char *p = parameter;
+      for (int index = 0; *p != 0; index++) {
+        if (index >= FOCUSER_MAX) { *commandError = CE_PARAM_RANGE; return true; }
+        if (*p != ',') {
+          char *conv_end;
+          long n = strtol(p, &conv_end, 10);
+          if (conv_end == p || (*conv_end != ',' && *conv_end != 0)) { *commandError = CE_PARAM_FORM; return true; }
+          if (axes[index] == NULL) { *commandError = CE_PARAM_RANGE; return true; }
+          targets[index] = command[1] == 'y' ? n : lround(n*axes[index]->getStepsPerMeasure());
+          bitSet(mask, index);
+          p = conv_end;
+        }
+        if (*p == ',') p++; else break;
+      }
+      *commandError = gotoTargets(mask, targets);
+    }
+  } else
+
   // :F[...]#   Use selected focuser (defaults to the first focuser)
   // :F1[...]#  Focuser #1 (Axis4)
   // :F2[...]#  Focuser #2 (Axis5)
@@ -102,7 +136,7 @@ bool Focuser::command(char *reply, char *command, char *parameter, bool *supress
     float MicronsToUnits = 1.0F;
     float StepsToUnits  = StepsToMicrons;
     float UnitsToSteps  = MicronsToSteps;
-    if (strchr("bdgimrs",command[1])) {
+    if (strchr("bdgimrsv",command[1])) {
       MicronsToUnits = MicronsToSteps;
       StepsToUnits = 1.0F;
       UnitsToSteps = 1.0F;
@@ -117,7 +151,7 @@ bool Focuser::command(char *reply, char *command, char *parameter, bool *supress
     // :FT#       Get status
     //            Returns: s#
     if (command[1] == 'T') {
-      if (axes[index]->isSlewing()) strcpy(reply,"M"); else strcpy(reply,"S");     // [M] for moving or [S] for stopped
+      if (!axes[index]->isSettled()) strcpy(reply,"M"); else strcpy(reply,"S");    // [M] for moving or [S] for stopped and settled
       char temp[2] = "0"; temp[0] = '0' + getGotoRate(index); strcat(reply, temp); // [1] to [5] for 0.5x to 2x goto rate
       *numericReply = false;
     } else
@@ -221,6 +255,69 @@ bool Focuser::command(char *reply, char *command, char *parameter, bool *supress
       if (!setTcfDeadband(index, round(atol(parameter)*UnitsToSteps))) *commandError = CE_PARAM_RANGE;
     } else
 
+    #if FOCUSER_TCF_TABLE == ON
+      // :FL#       Get focuser temperature compensation table point count
+      //            Returns: n#
+      // :FL[n]#    Get focuser temperature compensation table point n (1 based)
+      //            Returns: sn.n,sn# temperature in °C and focus offset in microns
+      // :FLC#      Clear focuser temperature compensation table (the coefficient is used again)
+      //            Returns: Nothing
+      // :FL[sn.n],[sn]# Set focuser temperature compensation table point for temperature in °C and offset in microns
+      //            points at the same temperature are replaced, with less than two points the coefficient is used
+      //            Return: 0 on failure
+      //                    1 on success
+      if (command[1] == 'L') {
+        char *parameter2 = strchr(parameter, ',');
+        if (parameter[0] == 0) {
+          sprintf(reply, "%d", (int)tcfTable[index].count);
+          *numericReply = false;
+        } else
+        if (parameter[0] == 'C' && parameter[1] == 0) {
+          clearTcfTable(index);
+          *numericReply = false;
+        } else
+        if (parameter2 == NULL) {
+          float t;
+          int offset;
+          if (getTcfPoint(index, atol(parameter), &t, &offset)) {
+            sprintF(reply, "%3.1f", t);
+            sprintf(&reply[strlen(reply)], ",%d", offset);
+            *numericReply = false;
+          } else *commandError = CE_PARAM_RANGE;
+        } else {
+          *commandError = setTcfPoint(index, atof(parameter), atol(&parameter2[1]));
+        }
+      } else
+
+      // :FO#       Get focuser selected filter
+      //            Returns: n# where 0 is none
+      // :FO[n]#    Select filter n (0 for none,) the focuser moves by the filter's offset
+      //            Return: 0 on failure
+      //                    1 on success
+      // :FO[n],[sn]# Set filter n focus offset in microns
+      //            Return: 0 on failure
+      //                    1 on success
+      if (command[1] == 'O') {
+        char *parameter2 = strchr(parameter, ',');
+        if (parameter[0] == 0) {
+          sprintf(reply, "%d", (int)tcfTable[index].filter);
+          *numericReply = false;
+        } else
+        if (parameter2 == NULL) *commandError = setFilter(index, atol(parameter)); else
+          *commandError = setFilterOffset(index, atol(parameter), atol(&parameter2[1]));
+      } else
+
+      // :FK[n]#    Get filter n focus offset in microns
+      //            Returns: sn#
+      if (command[1] == 'K') {
+        int n = atol(parameter);
+        if (n >= 1 && n <= FOCUSER_FILTER_MAX) {
+          sprintf(reply, "%d", (int)tcfTable[index].filterOffset[n - 1]);
+          *numericReply = false;
+        } else *commandError = CE_PARAM_RANGE;
+      } else
+    #endif
+
     // :FP#       Get focuser DC Motor Power Level (in %)
     //            Returns: n#
     // :FP[n]#    Set focuser DC Motor Power Level (in %)
@@ -243,6 +340,9 @@ bool Focuser::command(char *reply, char *command, char *parameter, bool *supress
         axes[index]->autoSlewAbort();
         homing[index] = true;
       } else axes[index]->autoSlewStop();
+      #if FOCUSER_SWEEP == ON
+        if (index == sweepIndex) sweepAbort();
+      #endif
       *numericReply = false;
     } else
 
@@ -336,7 +436,68 @@ bool Focuser::command(char *reply, char *command, char *parameter, bool *supress
         *commandError = gotoTarget(index, t);
       }
       *numericReply = false;
-    } else *commandError = CE_CMD_UNKNOWN;
+    } else
+
+    #if FOCUSER_SWEEP == ON
+      // :FV#       Get V-curve sweep status
+      //            Returns: s,n,p# where s is [N] none, [M] moving, [R] ready to measure, [F] moving to best focus, or [D] done
+      //                     n is the point number (1 based) and p its position (in microns or steps)
+      // :FVN[h]#   Record the HFD h (optional) measured at the ready point and move to the next point
+      //            Return: 0 on failure
+      //                    1 on success
+      // :FVF#      Fit the recorded HFD's and move to best focus
+      //            Returns: n# best focus position (in microns or steps) or 0 on failure
+      // :FVQ#      Stop the sweep
+      //            Returns: Nothing
+      // :FV[s],[t],[n][,d]# Start a sweep of n points from position s by step t (in microns or steps)
+      //            optional d is + or - to arrive at each point moving in that direction (for backlash)
+      //            Return: 0 on failure
+      //                    1 on success
+      if (toupper(command[1]) == 'V') {
+        if (parameter[0] == 0) {
+          const char states[] = "NMMRFD";
+          int p = sweepPoint < sweepCount ? sweepPoint : sweepCount - 1;
+          long position = index == sweepIndex ? sweepStartSteps + sweepStepSteps*p : 0;
+          if (index != sweepIndex) sprintf(reply, "N,0,0"); else
+          sprintf(reply, "%c,%d,%ld", states[sweepState], p + 1, (long)round(position*StepsToUnits));
+          *numericReply = false;
+        } else
+
+        if (toupper(parameter[0]) == 'N') {
+          if (index != sweepIndex) *commandError = CE_0; else
+          *commandError = sweepNext(parameter[1] == 0 ? NAN : atof(&parameter[1]));
+        } else
+
+        if (toupper(parameter[0]) == 'F' && parameter[1] == 0) {
+          long best;
+          if (index != sweepIndex) *commandError = CE_0; else {
+            *commandError = sweepFit(&best);
+            if (*commandError == CE_NONE) { sprintf(reply, "%ld", (long)round(best*StepsToUnits)); *numericReply = false; }
+          }
+        } else
+
+        if (toupper(parameter[0]) == 'Q' && parameter[1] == 0) {
+          if (index == sweepIndex) sweepAbort();
+          *numericReply = false;
+        } else {
+          char *conv_end;
+          long s = strtol(parameter, &conv_end, 10);
+          if (*conv_end != ',') { *commandError = CE_PARAM_FORM; return true; }
+          long t = strtol(conv_end + 1, &conv_end, 10);
+          if (*conv_end != ',') { *commandError = CE_PARAM_FORM; return true; }
+          long n = strtol(conv_end + 1, &conv_end, 10);
+          int d = 0;
+          if (*conv_end == ',') {
+            if (conv_end[1] == '+') d = 1; else if (conv_end[1] == '-') d = -1; else { *commandError = CE_PARAM_FORM; return true; }
+            conv_end += 2;
+          }
+          if (*conv_end != 0) { *commandError = CE_PARAM_FORM; return true; }
+          *commandError = sweepStart(index, lround(s*UnitsToSteps), lround(t*UnitsToSteps), n, d);
+        }
+      } else
+    #endif
+
+    *commandError = CE_CMD_UNKNOWN;
 
   } else return false;
 
@@ -17,37 +17,44 @@ typedef struct FocuserConfiguration {
   uint8_t  slewRateMinimum;
   float    accelerationTime;
   float    rapidStopTime;
+  float    jerkTime;
+  uint16_t settleTime;
   bool     powerDown;
   uint16_t powerDownTime;
 } FocuserConfiguration;
 
 const FocuserConfiguration configuration[] = {
 #if FOCUSER_MAX >= 1
-  {AXIS4_DRIVER_MODEL != OFF, AXIS4_SLEW_RATE_BASE_DESIRED, AXIS4_SLEW_RATE_MINIMUM, AXIS4_ACCELERATION_TIME, AXIS4_RAPID_STOP_TIME, AXIS4_POWER_DOWN == ON, AXIS4_POWER_DOWN_TIME},
+  {AXIS4_DRIVER_MODEL != OFF, AXIS4_SLEW_RATE_BASE_DESIRED, AXIS4_SLEW_RATE_MINIMUM, AXIS4_ACCELERATION_TIME, AXIS4_RAPID_STOP_TIME, AXIS4_JERK_TIME, AXIS4_SETTLE_TIME, AXIS4_POWER_DOWN == ON, AXIS4_POWER_DOWN_TIME},
 #endif
 #if FOCUSER_MAX >= 2
-  {AXIS5_DRIVER_MODEL != OFF, AXIS5_SLEW_RATE_BASE_DESIRED, AXIS5_SLEW_RATE_MINIMUM, AXIS5_ACCELERATION_TIME, AXIS5_RAPID_STOP_TIME, AXIS5_POWER_DOWN == ON, AXIS5_POWER_DOWN_TIME},
+  {AXIS5_DRIVER_MODEL != OFF, AXIS5_SLEW_RATE_BASE_DESIRED, AXIS5_SLEW_RATE_MINIMUM, AXIS5_ACCELERATION_TIME, AXIS5_RAPID_STOP_TIME, AXIS5_JERK_TIME, AXIS5_SETTLE_TIME, AXIS5_POWER_DOWN == ON, AXIS5_POWER_DOWN_TIME},
 #endif
 #if FOCUSER_MAX >= 3
-  {AXIS6_DRIVER_MODEL != OFF, AXIS6_SLEW_RATE_BASE_DESIRED, AXIS6_SLEW_RATE_MINIMUM, AXIS6_ACCELERATION_TIME, AXIS6_RAPID_STOP_TIME, AXIS6_POWER_DOWN == ON, AXIS6_POWER_DOWN_TIME},
+  {AXIS6_DRIVER_MODEL != OFF, AXIS6_SLEW_RATE_BASE_DESIRED, AXIS6_SLEW_RATE_MINIMUM, AXIS6_ACCELERATION_TIME, AXIS6_RAPID_STOP_TIME, AXIS6_JERK_TIME, AXIS6_SETTLE_TIME, AXIS6_POWER_DOWN == ON, AXIS6_POWER_DOWN_TIME},
 #endif
 #if FOCUSER_MAX >= 4
-  {AXIS7_DRIVER_MODEL != OFF, AXIS7_SLEW_RATE_BASE_DESIRED, AXIS7_SLEW_RATE_MINIMUM, AXIS7_ACCELERATION_TIME, AXIS7_RAPID_STOP_TIME, AXIS7_POWER_DOWN == ON, AXIS7_POWER_DOWN_TIME},
+  {AXIS7_DRIVER_MODEL != OFF, AXIS7_SLEW_RATE_BASE_DESIRED, AXIS7_SLEW_RATE_MINIMUM, AXIS7_ACCELERATION_TIME, AXIS7_RAPID_STOP_TIME, AXIS7_JERK_TIME, AXIS7_SETTLE_TIME, AXIS7_POWER_DOWN == ON, AXIS7_POWER_DOWN_TIME},
 #endif
 #if FOCUSER_MAX >= 5
-  {AXIS8_DRIVER_MODEL != OFF, AXIS8_SLEW_RATE_BASE_DESIRED, AXIS8_SLEW_RATE_MINIMUM, AXIS8_ACCELERATION_TIME, AXIS8_RAPID_STOP_TIME, AXIS8_POWER_DOWN == ON, AXIS8_POWER_DOWN_TIME},
+  {AXIS8_DRIVER_MODEL != OFF, AXIS8_SLEW_RATE_BASE_DESIRED, AXIS8_SLEW_RATE_MINIMUM, AXIS8_ACCELERATION_TIME, AXIS8_RAPID_STOP_TIME, AXIS8_JERK_TIME, AXIS8_SETTLE_TIME, AXIS8_POWER_DOWN == ON, AXIS8_POWER_DOWN_TIME},
 #endif
 #if FOCUSER_MAX >= 6
-  {AXIS9_DRIVER_MODEL != OFF, AXIS9_SLEW_RATE_BASE_DESIRED, AXIS9_SLEW_RATE_MINIMUM, AXIS9_ACCELERATION_TIME, AXIS9_RAPID_STOP_TIME, AXIS9_POWER_DOWN == ON, AXIS9_POWER_DOWN_TIME},
+  {AXIS9_DRIVER_MODEL != OFF, AXIS9_SLEW_RATE_BASE_DESIRED, AXIS9_SLEW_RATE_MINIMUM, AXIS9_ACCELERATION_TIME, AXIS9_RAPID_STOP_TIME, AXIS9_JERK_TIME, AXIS9_SETTLE_TIME, AXIS9_POWER_DOWN == ON, AXIS9_POWER_DOWN_TIME},
 #endif
 };
 
 void focWrapper() { focuser.monitor(); }
+void focAxisEventWrapper(Axis *axis, AxisEvent event) { focuser.axisEvent(axis, event); }
 
 #if FOCUSER_BUTTON_SENSE_IN != OFF && FOCUSER_BUTTON_SENSE_OUT != OFF
 void focButtonsWrapper() { focuser.buttons(); }
 #endif
 
+#if FOCUSER_SWEEP == ON
+void focSweepWrapper() { focuser.sweepPoll(); }
+#endif
+
 // setup arrays for easy access to focuser axes
 Axis *axes[6] = {NULL, NULL, NULL, NULL, NULL, NULL};
 
@@ -93,6 +100,9 @@ void Focuser::init() {
 
   // confirm the data structure size
   if (FocuserSettingsSize < sizeof(FocuserSettings)) { nv.initError = true; DL("ERR: Focuser::init(); FocuserSettingsSize error"); }
+  #if FOCUSER_TCF_TABLE == ON
+    if (FocuserTcfTableSize < sizeof(TcfTable)) { nv.initError = true; DL("ERR: Focuser::init(); FocuserTcfTableSize error"); }
+  #endif
 
   // init settings stored in NV
   for (int index = 0; index < FOCUSER_MAX; index++) {
@@ -109,6 +119,13 @@ void Focuser::init() {
       settings[index].gotoRate = configuration[index].slewRateDesired;
       nv.updateBytes(nvFocuserSettingsBase, &settings[index], sizeof(FocuserSettings));
     }
+    #if FOCUSER_TCF_TABLE == ON
+      // an all zero table is empty with no filter selected
+      if (!nv.hasValidKey()) {
+        memset(&tcfTable[index], 0, sizeof(TcfTable));
+        writeTcfTable(index);
+      }
+    #endif
   }
 
   // get settings
@@ -118,6 +135,9 @@ void Focuser::init() {
     // init. some defaults
     moveRate[index] = 100;
     tcfSteps[index] = 0;
+    #if FOCUSER_TCF_TABLE == ON
+      tcfTrack[index] = 0;
+    #endif
     target[index] = 0;
     writeTime[index] = 0;
     parkHandle[index] = 0;
@@ -150,6 +170,8 @@ void Focuser::init() {
         axes[index]->setFrequencySlew(configuration[index].slewRateDesired);
         axes[index]->setSlewAccelerationTime(configuration[index].accelerationTime);
         axes[index]->setSlewAccelerationTimeAbort(configuration[index].rapidStopTime);
+        axes[index]->setSlewJerkTime(configuration[index].jerkTime);
+        axes[index]->setSettleTime(configuration[index].settleTime);
         if (configuration[index].powerDown) axes[index]->setPowerDownTime(configuration[index].powerDownTime);
       }
     }
@@ -157,15 +179,28 @@ void Focuser::init() {
 
 }
 
-void Focuser::begin() {
+bool Focuser::calibrateDriversStart() {
+  bool wait = false;
+  for (int index = 0; index < FOCUSER_MAX; index++) {
+    if (configuration[index].present && axes[index] != NULL && axes[index]->calibrateDriverStart()) wait = true;
+  }
+  return wait;
+}
+
+void Focuser::calibrateDriversFinish() {
   for (int index = 0; index < FOCUSER_MAX; index++) {
-    if (configuration[index].present && axes[index] != NULL) axes[index]->calibrateDriver();
+    if (configuration[index].present && axes[index] != NULL) axes[index]->calibrateDriverFinish();
   }
+}
 
+void Focuser::begin() {
   // start task for temperature compensated focusing
   VF("MSG: Focusers, starting TCF task (rate 1s priority 6)... ");
   if (tasks.add(1000, 0, true, 6, focWrapper, "FocPoll")) { VLF("success"); } else { VLF("FAILED!"); }
 
+  // park and unpark finish as soon as the focuser reaches its target
+  Axis::onEvent(focAxisEventWrapper);
+
   // start task for monitor for focuser buttons
   #if FOCUSER_BUTTON_SENSE_IN != OFF && FOCUSER_BUTTON_SENSE_OUT != OFF
     if (FOCUSER_BUTTON_FOCUSER_INDEX - 1 < 0 ||
@@ -184,6 +219,12 @@ void Focuser::begin() {
     } else { VLF("FAILED!"); }
   #endif
 
+  // start task for the autofocus sweep
+  #if FOCUSER_SWEEP == ON
+    VF("MSG: Focusers, starting sweep task (rate 50ms priority 6)... ");
+    if (tasks.add(50, 0, true, 6, focSweepWrapper, "FocSwp")) { VLF("success"); } else { VLF("FAILED!"); }
+  #endif
+
   for (int index = 0; index < FOCUSER_MAX; index++) {
     if (configuration[index].present && axes[index] != NULL) unpark(index);
   }
@@ -231,8 +272,15 @@ CommandError Focuser::setTcfEnable(int index, bool value) {
   if (value) {
     settings[index].tcf.t0 = getTemperature();
    } else {
-     target[index] += tcfSteps[index];
-     tcfSteps[index] = 0;
+     #if FOCUSER_TCF_TABLE == ON
+       // the filter offset stays in effect
+       target[index] += tcfTrack[index];
+       tcfSteps[index] -= tcfTrack[index];
+       tcfTrack[index] = 0;
+     #else
+       target[index] += tcfSteps[index];
+       tcfSteps[index] = 0;
+     #endif
    }
   writeSettings(index);
   return CE_NONE;
@@ -283,6 +331,26 @@ bool Focuser::setTcfT0(int index, float value) {
   return true;
 }
 
+// get focuser position in microns
+bool Focuser::getPosition(int index, float *microns) {
+  if (index < 0 || index >= FOCUSER_MAX || axes[index] == NULL) return false;
+  *microns = (axes[index]->getInstrumentCoordinateSteps() - tcfSteps[index])/axes[index]->getStepsPerMeasure();
+  return true;
+}
+
+// checks if the focuser has stopped at its target and settled, true if the focuser isn't present
+bool Focuser::isSettled(int index) {
+  if (index < 0 || index >= FOCUSER_MAX || axes[index] == NULL) return true;
+  return axes[index]->isSettled();
+}
+
+// move the focuser to a position in microns
+CommandError Focuser::gotoPosition(int index, float microns) {
+  if (index < 0 || index >= FOCUSER_MAX) return CE_CMD_UNKNOWN;
+  if (axes[index] == NULL) return CE_PARAM_RANGE;
+  return gotoTarget(index, lround(microns*axes[index]->getStepsPerMeasure()));
+}
+
 // get backlash in steps
 int Focuser::getBacklash(int index) {
   if (index < 0 || index >= FOCUSER_MAX) return 0;
@@ -363,6 +431,40 @@ CommandError Focuser::gotoTarget(int index, long target) {
   return e; 
 }
 
+// move the focusers in mask (bit 0 for focuser #1) to their targets (in steps) starting them all together
+CommandError Focuser::gotoTargets(uint8_t mask, long *targets) {
+  if (mask == 0) return CE_PARAM_FORM;
+
+  // check them all first so either every focuser moves or none does
+  for (int index = 0; index < FOCUSER_MAX; index++) {
+    if (!bitRead(mask, index)) continue;
+    if (axes[index] == NULL) return CE_PARAM_RANGE;
+    if (settings[index].parkState >= PS_PARKED) return CE_PARKED;
+    if (axes[index]->isSlewing()) return CE_SLEW_IN_MOTION;
+  }
+
+  groupMask = mask;
+  CommandError e = CE_NONE;
+  for (int index = 0; index < FOCUSER_MAX; index++) {
+    if (!bitRead(mask, index)) continue;
+    CommandError e1 = gotoTarget(index, targets[index]);
+    if (e1 != CE_NONE) e = e1;
+  }
+
+  // a failure stops the rest so the group doesn't end up half moved
+  if (e != CE_NONE) {
+    for (int index = 0; index < FOCUSER_MAX; index++) if (bitRead(mask, index)) axes[index]->autoSlewStop();
+  }
+
+  return e;
+}
+
+// checks if all the focusers of the last gotoTargets() have stopped and settled
+bool Focuser::isGroupSettled() {
+  for (int index = 0; index < FOCUSER_MAX; index++) if (bitRead(groupMask, index) && !isSettled(index)) return false;
+  return true;
+}
+
 // park focuser at its current location
 CommandError Focuser::park(int index) {
   if (index < 0 || index >= FOCUSER_MAX)           return CE_PARAM_RANGE;
@@ -439,6 +541,11 @@ void Focuser::readSettings(int index) {
   if (fabs(settings[index].tcf.t0) > 60.0F)    { settings[index].tcf.t0 = 10.0F;   initError.value = true; DLF("ERR: Focuser.init(), bad NV |tcf.t0| > 60.0 deg. C (set to 10.0)"); }
   if (settings[index].backlash < 0)            { settings[index].backlash = 0;     initError.value = true; DLF("ERR: Focuser.init(), bad NV backlash < 0 steps (set to 0)"); }
   if (settings[index].backlash > 10000)        { settings[index].backlash = 0;     initError.value = true; DLF("ERR: Focuser.init(), bad NV backlash > 10000 steps (set to 0)"); }
+  #if FOCUSER_TCF_TABLE == ON
+    nv.readBytes(NV_FOCUSER_TCF_BASE + index*FocuserTcfTableSize, &tcfTable[index], sizeof(TcfTable));
+    if (tcfTable[index].count > FOCUSER_TCF_POINTS)  { tcfTable[index].count = 0;  initError.value = true; DLF("ERR: Focuser.init(), bad NV TCF table count (set to 0)"); }
+    if (tcfTable[index].filter > FOCUSER_FILTER_MAX) { tcfTable[index].filter = 0; initError.value = true; DLF("ERR: Focuser.init(), bad NV filter (set to 0)"); }
+  #endif
 }
 
 void Focuser::writeSettings(int index) {
@@ -446,6 +553,35 @@ void Focuser::writeSettings(int index) {
 }
 
 // poll focusers to handle parking and TCF
+// motion event from an axis, finishes a park or unpark without waiting for the monitor
+void Focuser::axisEvent(Axis *axis, AxisEvent event) {
+  if (event != AE_TARGET_REACHED) return;
+  for (int index = 0; index < FOCUSER_MAX; index++) {
+    if (axes[index] == axis && (settings[index].parkState == PS_PARKING || settings[index].parkState == PS_UNPARKING)) parkFinish(index);
+  }
+}
+
+// mark a park or unpark done once the focuser is stopped at its target
+void Focuser::parkFinish(int index) {
+  if (axes[index]->isSlewing() || !axes[index]->atTarget()) return;
+
+  if (settings[index].parkState == PS_PARKING) {
+    axes[index]->enable(false);
+    settings[index].parkState = PS_PARKED;
+    writeSettings(index);
+    #if DEBUG == VERBOSE
+      long offset = axes[index]->getInstrumentCoordinateSteps() - axes[index]->getMotorPositionSteps();
+      VF("MSG: Focuser"); V(index + 1); VF(", park motor target   "); VL(axes[index]->getTargetCoordinateSteps() - offset);
+      VF("MSG: Focuser"); V(index + 1); VF(", park motor position "); VL(axes[index]->getMotorPositionSteps());
+    #endif
+  } else
+
+  if (settings[index].parkState == PS_UNPARKING) {
+    settings[index].parkState = PS_UNPARKED;
+    writeSettings(index);
+  }
+}
+
 void Focuser::monitor() {
   secs++;
 
@@ -460,29 +596,22 @@ void Focuser::monitor() {
 
       if (!axes[index]->isSlewing()) {
 
-        if (settings[index].parkState == PS_PARKING) {
-          if (axes[index]->atTarget()) {
-            axes[index]->enable(false);
-            settings[index].parkState = PS_PARKED;
-            writeSettings(index);
-            #if DEBUG == VERBOSE
-              long offset = axes[index]->getInstrumentCoordinateSteps() - axes[index]->getMotorPositionSteps();
-              VF("MSG: Focuser"); V(index + 1); VF(", park motor target   "); VL(axes[index]->getTargetCoordinateSteps() - offset);
-              VF("MSG: Focuser"); V(index + 1); VF(", park motor position "); VL(axes[index]->getMotorPositionSteps());
-            #endif
-          }
-        } else
-
-        if (settings[index].parkState == PS_UNPARKING) {
-          if (axes[index]->atTarget()) {
-            settings[index].parkState = PS_UNPARKED;
-            writeSettings(index);
-          }
-        } else
+        if (settings[index].parkState == PS_PARKING || settings[index].parkState == PS_UNPARKING) parkFinish(index); else
 
         if (settings[index].parkState == PS_UNPARKED) {
-          if (settings[index].tcf.enabled) {
+          bool compensate = settings[index].tcf.enabled;
+          #if FOCUSER_TCF_TABLE == ON
+            if (tcfTable[index].filter > 0 || tcfSteps[index] != 0) compensate = true;
+          #endif
+          if (compensate) {
             Y;
+            #if FOCUSER_TCF_TABLE == ON
+              long steps = getTcfTableSteps(index, t);
+              if (tcfSteps[index] != steps) {
+                tcfSteps[index] = steps;
+                axes[index]->setTargetCoordinateSteps(target[index] + tcfSteps[index]);
+              }
+            #else
             if (!isnan(t)) {
               float offset = settings[index].tcf.coef * (settings[index].tcf.t0 - t);
               offset *= (float)axes[index]->getStepsPerMeasure();
@@ -494,6 +623,7 @@ void Focuser::monitor() {
                 axes[index]->setTargetCoordinateSteps(target[index] + tcfSteps[index]);
               }
             }
+            #endif
             if (!axes[index]->atTarget()) {
               axes[index]->setSynchronized(false);
               axes[index]->setFrequencyBase(20.0F); // 20um/s
@@ -504,6 +634,8 @@ void Focuser::monitor() {
 
           if (homing[index]) {
             long p = round((axes[index]->settings.limits.max + axes[index]->settings.limits.min)/2.0F)*axes[index]->getStepsPerMeasure();
+            // sensorless homing stops against the inward hard stop
+            if (axes[index]->hasHomeStall()) p = round(axes[index]->settings.limits.min*axes[index]->getStepsPerMeasure());
             axes[index]->resetPositionSteps(p);
             axes[index]->setBacklash(getBacklash(index));
             homing[index] = false;
@@ -544,6 +676,241 @@ void Focuser::monitor() {
   }
 #endif
 
+#if FOCUSER_TCF_TABLE == ON
+  // get TCF table point (1 based) temperature in deg. C and offset in microns, false if not set
+  bool Focuser::getTcfPoint(int index, int point, float *t, int *offset) {
+    if (index < 0 || index >= FOCUSER_MAX) return false;
+    if (point < 1 || point > tcfTable[index].count) return false;
+    *t = tcfTable[index].temperature[point - 1]/10.0F;
+    *offset = tcfTable[index].offset[point - 1];
+    return true;
+  }
+
+  // add a TCF table point (or replace the one at this temperature) in deg. C and microns
+  CommandError Focuser::setTcfPoint(int index, float t, int offset) {
+    if (index < 0 || index >= FOCUSER_MAX) return CE_CMD_UNKNOWN;
+    if (fabs(t) > 60.0F || abs(offset) > 30000) return CE_PARAM_RANGE;
+
+    // keep the table in order of temperature
+    int16_t tenths = lroundf(t*10.0F);
+    int i = 0;
+    while (i < tcfTable[index].count && tcfTable[index].temperature[i] < tenths) i++;
+    if (i >= tcfTable[index].count || tcfTable[index].temperature[i] != tenths) {
+      if (tcfTable[index].count >= FOCUSER_TCF_POINTS) return CE_0;
+      for (int j = tcfTable[index].count; j > i; j--) {
+        tcfTable[index].temperature[j] = tcfTable[index].temperature[j - 1];
+        tcfTable[index].offset[j] = tcfTable[index].offset[j - 1];
+      }
+      tcfTable[index].count++;
+    }
+    tcfTable[index].temperature[i] = tenths;
+    tcfTable[index].offset[i] = offset;
+    writeTcfTable(index);
+    return CE_NONE;
+  }
+
+  // clear the TCF table, falling back to the coefficient
+  void Focuser::clearTcfTable(int index) {
+    if (index < 0 || index >= FOCUSER_MAX) return;
+    tcfTable[index].count = 0;
+    writeTcfTable(index);
+  }
+
+  // get TCF table interpolated offset at temperature t in microns, held at the end values outside of the table
+  float Focuser::getTcfTableOffset(int index, float t) {
+    const TcfTable *table = &tcfTable[index];
+    float tenths = t*10.0F;
+    if (tenths <= table->temperature[0]) return table->offset[0];
+    for (int i = 1; i < table->count; i++) {
+      if (tenths <= table->temperature[i]) {
+        float f = (tenths - table->temperature[i - 1])/(float)(table->temperature[i] - table->temperature[i - 1]);
+        return table->offset[i - 1] + f*(table->offset[i] - table->offset[i - 1]);
+      }
+    }
+    return table->offset[table->count - 1];
+  }
+
+  // select filter, 1 to FOCUSER_FILTER_MAX or 0 for none
+  CommandError Focuser::setFilter(int index, int filter) {
+    if (index < 0 || index >= FOCUSER_MAX) return CE_CMD_UNKNOWN;
+    if (filter < 0 || filter > FOCUSER_FILTER_MAX) return CE_PARAM_RANGE;
+    if (settings[index].parkState >= PS_PARKED) return CE_PARKED;
+    tcfTable[index].filter = filter;
+    writeTcfTable(index);
+    return CE_NONE;
+  }
+
+  // set filter focus offset in microns
+  CommandError Focuser::setFilterOffset(int index, int filter, int offset) {
+    if (index < 0 || index >= FOCUSER_MAX) return CE_CMD_UNKNOWN;
+    if (filter < 1 || filter > FOCUSER_FILTER_MAX || abs(offset) > 30000) return CE_PARAM_RANGE;
+    tcfTable[index].filterOffset[filter - 1] = offset;
+    writeTcfTable(index);
+    return CE_NONE;
+  }
+
+  // get the compensation in steps, called once a second
+  long Focuser::getTcfTableSteps(int index, float t) {
+    const float stepsPerMicron = axes[index]->getStepsPerMeasure();
+
+    // the temperature part moves toward the model a little at a time so there's never a jump
+    // big enough to see mid-exposure, the filter part changes at once since that's between exposures
+    if (settings[index].tcf.enabled) {
+      if (!isnan(t)) {
+        float offset;
+        if (tcfTable[index].count >= 2) {
+          offset = getTcfTableOffset(index, t) - getTcfTableOffset(index, settings[index].tcf.t0);
+        } else offset = settings[index].tcf.coef*(settings[index].tcf.t0 - t);
+
+        long delta = lroundf(offset*stepsPerMicron) - tcfTrack[index];
+        long limit = lroundf(FOCUSER_TCF_RATE*stepsPerMicron);
+        if (limit < 1) limit = 1;
+        if (delta > limit) delta = limit;
+        if (delta < -limit) delta = -limit;
+        tcfTrack[index] += delta;
+      }
+    } else tcfTrack[index] = 0;
+
+    long steps = tcfTrack[index];
+    if (tcfTable[index].filter > 0) steps += lroundf(tcfTable[index].filterOffset[tcfTable[index].filter - 1]*stepsPerMicron);
+    return steps;
+  }
+
+  void Focuser::writeTcfTable(int index) {
+    if (index < 0 || index >= FOCUSER_MAX) return;
+    nv.updateBytes(NV_FOCUSER_TCF_BASE + index*FocuserTcfTableSize, &tcfTable[index], sizeof(TcfTable));
+  }
+#endif
+
+#if FOCUSER_SWEEP == ON
+  // start a V-curve sweep of count points from start by step (in steps)
+  CommandError Focuser::sweepStart(int index, long start, long step, int count, int approach) {
+    if (index < 0 || index >= FOCUSER_MAX) return CE_CMD_UNKNOWN;
+    if (axes[index] == NULL) return CE_PARAM_RANGE;
+    if (settings[index].parkState >= PS_PARKED) return CE_PARKED;
+    if (sweepState != SW_NONE && sweepState != SW_DONE) return CE_SLEW_IN_MOTION;
+    if (step == 0 || count < 3 || count > FOCUSER_SWEEP_MAX) return CE_PARAM_RANGE;
+
+    long minSteps = lround(axes[index]->settings.limits.min*axes[index]->getStepsPerMeasure());
+    long maxSteps = lround(axes[index]->settings.limits.max*axes[index]->getStepsPerMeasure());
+    long end = start + step*(count - 1);
+    if (start < minSteps || start > maxSteps || end < minSteps || end > maxSteps) return CE_SLEW_ERR_OUTSIDE_LIMITS;
+
+    sweepIndex = index;
+    sweepStartSteps = start;
+    sweepStepSteps = step;
+    sweepCount = count;
+    sweepPoint = 0;
+    sweepApproach = approach;
+    for (int i = 0; i < FOCUSER_SWEEP_MAX; i++) sweepHfd[i] = NAN;
+
+    VF("MSG: Focuser"); V(index + 1); VF(", sweep of "); V(count); VLF(" points started");
+    return sweepGoto(start, SW_MOVING);
+  }
+
+  // record the HFD measured at the ready point (NAN if none) and move on to the next point
+  CommandError Focuser::sweepNext(float hfd) {
+    if (sweepState == SW_NONE || sweepState == SW_DONE) return CE_0;
+    if (sweepState != SW_READY) return CE_SLEW_IN_MOTION;
+
+    sweepHfd[sweepPoint] = hfd;
+    if (++sweepPoint >= sweepCount) {
+      VF("MSG: Focuser"); V(sweepIndex + 1); VLF(", sweep complete");
+      sweepState = SW_DONE;
+      return CE_NONE;
+    }
+    return sweepGoto(sweepStartSteps + sweepStepSteps*sweepPoint, SW_MOVING);
+  }
+
+  // fit the recorded points and move to the best focus (in steps)
+  CommandError Focuser::sweepFit(long *best) {
+    if (sweepState != SW_READY && sweepState != SW_DONE) return sweepState == SW_NONE ? CE_0 : CE_SLEW_IN_MOTION;
+    if (sweepIndex < 0) return CE_0;
+
+    // HFD follows a hyperbola through focus, HFD^2 = a(x - x0)^2 + c, so squaring the
+    // measurements turns it into a parabola that a linear least squares fit handles
+    // x is the point number to keep the sums small, the normal equations are solved by Cramer's rule
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, t0 = 0, t1 = 0, t2 = 0;
+    int points = 0;
+    for (int i = 0; i < sweepCount; i++) {
+      if (isnan(sweepHfd[i]) || sweepHfd[i] <= 0.0F) continue;
+      double x = i, y = (double)sweepHfd[i]*sweepHfd[i];
+      s0 += 1.0; s1 += x; s2 += x*x; s3 += x*x*x; s4 += x*x*x*x;
+      t0 += y; t1 += x*y; t2 += x*x*y;
+      points++;
+    }
+    if (points < 3) { VF("MSG: Focuser"); V(sweepIndex + 1); VLF(", sweep fit needs 3 or more points"); return CE_0; }
+
+    double det = s4*(s2*s0 - s1*s1) - s3*(s3*s0 - s1*s2) + s2*(s3*s1 - s2*s2);
+    if (fabs(det) < 1e-9) return CE_0;
+    double a = (t2*(s2*s0 - s1*s1) - s3*(t1*s0 - s1*t0) + s2*(t1*s1 - s2*t0))/det;
+    double b = (s4*(t1*s0 - t0*s1) - t2*(s3*s0 - s1*s2) + s2*(s3*t0 - t1*s2))/det;
+
+    // no V or the bottom of it is outside of the sweep
+    if (a <= 0.0) { VF("MSG: Focuser"); V(sweepIndex + 1); VLF(", sweep fit found no minimum"); return CE_0; }
+    double x0 = -b/(2.0*a);
+    if (x0 < 0.0 || x0 > sweepCount - 1) { VF("MSG: Focuser"); V(sweepIndex + 1); VLF(", sweep fit minimum outside of sweep"); return CE_0; }
+
+    *best = lround(sweepStartSteps + x0*sweepStepSteps);
+    VF("MSG: Focuser"); V(sweepIndex + 1); VF(", sweep fit best focus at "); V(*best/axes[sweepIndex]->getStepsPerMeasure()); VLF("um");
+    return sweepGoto(*best, SW_FINAL);
+  }
+
+  // stop the sweep
+  void Focuser::sweepAbort() {
+    if (sweepState == SW_NONE) return;
+    VF("MSG: Focuser"); V(sweepIndex + 1); VLF(", sweep stopped");
+    sweepState = SW_NONE;
+  }
+
+  // move to a point, first overshooting it when needed so it's reached in the approach direction
+  CommandError Focuser::sweepGoto(long steps, SweepState arrived) {
+    sweepTarget = steps;
+    sweepArrived = arrived;
+    sweepState = arrived;
+
+    long from = axes[sweepIndex]->getTargetCoordinateSteps() - tcfSteps[sweepIndex];
+    if (sweepApproach != 0 && (steps - from)*sweepApproach < 0) {
+      // go past by the backlash (or one sweep step if there's none) and come back
+      long overshoot = settings[sweepIndex].backlash > 0 ? settings[sweepIndex].backlash : labs(sweepStepSteps);
+      long minSteps = lround(axes[sweepIndex]->settings.limits.min*axes[sweepIndex]->getStepsPerMeasure());
+      long maxSteps = lround(axes[sweepIndex]->settings.limits.max*axes[sweepIndex]->getStepsPerMeasure());
+      long past = steps - sweepApproach*overshoot;
+      if (past < minSteps) past = minSteps;
+      if (past > maxSteps) past = maxSteps;
+      if (past != steps) { sweepState = SW_APPROACH; steps = past; }
+    }
+
+    CommandError e = gotoTarget(sweepIndex, steps);
+    if (e != CE_NONE) sweepState = SW_NONE;
+    return e;
+  }
+
+  // poll the autofocus sweep to move between points
+  void Focuser::sweepPoll() {
+    if (sweepState == SW_NONE || sweepState == SW_READY || sweepState == SW_DONE) return;
+    if (axes[sweepIndex]->isSlewing()) return;
+
+    if (sweepState == SW_APPROACH) {
+      sweepState = sweepArrived;
+      if (gotoTarget(sweepIndex, sweepTarget) != CE_NONE) {
+        VF("MSG: Focuser"); V(sweepIndex + 1); VLF(", sweep goto failed");
+        sweepState = SW_NONE;
+      }
+    } else
+
+    if (sweepState == SW_MOVING) {
+      VF("MSG: Focuser"); V(sweepIndex + 1); VF(", sweep point "); V(sweepPoint + 1); VLF(" ready");
+      sweepState = SW_READY;
+    } else
+
+    if (sweepState == SW_FINAL) {
+      VF("MSG: Focuser"); V(sweepIndex + 1); VLF(", sweep at best focus");
+      sweepState = SW_DONE;
+    }
+  }
+#endif
+
 Focuser focuser;
 
 #endif
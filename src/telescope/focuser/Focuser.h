@@ -47,6 +47,13 @@
   #endif
 #endif
 
+// most points in a V-curve autofocus sweep
+#ifndef FOCUSER_SWEEP_MAX
+  #define FOCUSER_SWEEP_MAX 32
+#endif
+
+enum SweepState: uint8_t {SW_NONE, SW_APPROACH, SW_MOVING, SW_READY, SW_FINAL, SW_DONE};
+
 #pragma pack(1)
 typedef struct Tcf {
   bool enabled;
@@ -63,6 +70,20 @@ typedef struct FocuserSettings {
   float position;    // in microns
   int16_t gotoRate;  // in microns/s
 } FocuserSettings;
+
+#if FOCUSER_TCF_TABLE == ON
+  #define FOCUSER_TCF_POINTS 8
+  #define FOCUSER_FILTER_MAX 8
+
+  #define FocuserTcfTableSize 50
+  typedef struct TcfTable {
+    uint8_t count;                            // table points in use
+    uint8_t filter;                           // selected filter, 1 to FOCUSER_FILTER_MAX or 0 for none
+    int16_t temperature[FOCUSER_TCF_POINTS];  // in 0.1°C, ascending
+    int16_t offset[FOCUSER_TCF_POINTS];       // in microns
+    int16_t filterOffset[FOCUSER_FILTER_MAX]; // in microns
+  } TcfTable;
+#endif
 #pragma pack()
 
 class Focuser {
@@ -70,18 +91,43 @@ class Focuser {
     void init();
     void begin();
 
+    // start calibrating the axis drivers, true if they must be left at standstill for MOTOR_CALIBRATE_DRIVER_MS
+    bool calibrateDriversStart();
+    // finish calibrating the axis drivers, call before begin()
+    void calibrateDriversFinish();
+
     bool command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
 
     // poll focusers to handle parking and TCF
     void monitor();
 
+    // motion event from an axis, finishes a park or unpark right away
+    void axisEvent(Axis *axis, AxisEvent event);
+
+    #if FOCUSER_SWEEP == ON
+      // poll the autofocus sweep to move between points
+      void sweepPoll();
+    #endif
+
     // poll focuser buttons to start/stop movement
     #if FOCUSER_BUTTON_SENSE_IN != OFF && FOCUSER_BUTTON_SENSE_OUT != OFF
       void buttons();
     #endif
 
+    // get focuser position in microns (as :FG# reports it,) returns false if the focuser isn't present
+    bool getPosition(int index, float *microns);
+
+    // checks if the focuser has stopped at its target and settled (see AXISn_SETTLE_TIME,) true if the focuser isn't present
+    bool isSettled(int index);
+
+    // move the focuser to a position in microns (as :FS# does)
+    CommandError gotoPosition(int index, float microns);
+
   private:
 
+    // mark a park or unpark done once the focuser is stopped at its target
+    void parkFinish(int index);
+
     // get focuser temperature in deg. C
     float getTemperature();
 
@@ -118,6 +164,31 @@ class Focuser {
     // set TCF T0, in deg. C
     bool setTcfT0(int index, float value);
 
+    #if FOCUSER_TCF_TABLE == ON
+      // get TCF table point (1 based) temperature in deg. C and offset in microns, false if not set
+      bool getTcfPoint(int index, int point, float *t, int *offset);
+
+      // add a TCF table point (or replace the one at this temperature) in deg. C and microns
+      CommandError setTcfPoint(int index, float t, int offset);
+
+      // clear the TCF table, falling back to the coefficient
+      void clearTcfTable(int index);
+
+      // get TCF table interpolated offset at temperature t in microns
+      float getTcfTableOffset(int index, float t);
+
+      // select filter, 1 to FOCUSER_FILTER_MAX or 0 for none
+      CommandError setFilter(int index, int filter);
+
+      // set filter focus offset in microns
+      CommandError setFilterOffset(int index, int filter, int offset);
+
+      // get the compensation in steps, the temperature part follows the model at up to FOCUSER_TCF_RATE
+      long getTcfTableSteps(int index, float t);
+
+      void writeTcfTable(int index);
+    #endif
+
     // get backlash in microns
     int getBacklash(int index);
 
@@ -139,12 +210,36 @@ class Focuser {
     // move focuser to a specific location (in steps)
     CommandError gotoTarget(int index, long target);
 
+    // move the focusers in mask (bit 0 for focuser #1) to their targets (in steps) starting them all together
+    CommandError gotoTargets(uint8_t mask, long *targets);
+
+    // checks if all the focusers of the last gotoTargets() have stopped and settled
+    bool isGroupSettled();
+
     // park focuser at its current location
     CommandError park(int index);
 
     // unpark focuser
     CommandError unpark(int index);
 
+    #if FOCUSER_SWEEP == ON
+      // start a V-curve sweep of count points from start by step (in steps,) approach is the direction
+      // each point is arrived at (1 or -1) or 0 to not care about backlash
+      CommandError sweepStart(int index, long start, long step, int count, int approach);
+
+      // record the HFD measured at the ready point (NAN if none) and move on to the next point
+      CommandError sweepNext(float hfd);
+
+      // fit the recorded points and move to the best focus (in steps)
+      CommandError sweepFit(long *best);
+
+      // stop the sweep
+      void sweepAbort();
+
+      // move to a point, first overshooting it when needed so it's reached in the approach direction
+      CommandError sweepGoto(long steps, SweepState arrived);
+    #endif
+
     void readSettings(int index);
     void writeSettings(int index);
 
@@ -153,6 +248,11 @@ class Focuser {
 
     FocuserSettings settings[FOCUSER_MAX];
 
+    #if FOCUSER_TCF_TABLE == ON
+      TcfTable tcfTable[FOCUSER_MAX];
+      long tcfTrack[FOCUSER_MAX]; // in steps, temperature part of tcfSteps
+    #endif
+
     long target[FOCUSER_MAX]; // in steps
 
     unsigned long writeTime[FOCUSER_MAX];
@@ -163,6 +263,21 @@ class Focuser {
 
     unsigned long secs = 0;
 
+    uint8_t groupMask = 0; // focusers moved by the last gotoTargets()
+
+    #if FOCUSER_SWEEP == ON
+      SweepState sweepState = SW_NONE;
+      SweepState sweepArrived = SW_NONE;
+      int sweepIndex = -1;
+      long sweepStartSteps = 0;
+      long sweepStepSteps = 0;
+      long sweepTarget = 0;
+      int sweepCount = 0;
+      int sweepPoint = 0;
+      int sweepApproach = 0;
+      float sweepHfd[FOCUSER_SWEEP_MAX];
+    #endif
+
     // the default focuser is the first found
     int active = -1;
 
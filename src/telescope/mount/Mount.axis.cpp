@@ -17,6 +17,10 @@
     Quadrature encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
   #elif AXIS1_ENCODER == AB_ESP32
     QuadratureEsp32 encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+  #elif AXIS1_ENCODER == AB_STM32
+    QuadratureStm32 encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+  #elif AXIS1_ENCODER == AB_TEENSY4
+    QuadratureTeensy4 encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
   #elif AXIS1_ENCODER == CW_CCW
     CwCcw encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
   #elif AXIS1_ENCODER == PULSE_DIR
@@ -34,8 +38,8 @@
   #endif
 
   #if defined(AXIS1_SERVO_DC)
-    const ServoDcPins ServoPinsAxis1 = {AXIS1_SERVO_PH1_PIN, AXIS1_SERVO_PH1_STATE, AXIS1_SERVO_PH2_PIN, AXIS1_SERVO_PH2_STATE, AXIS1_ENABLE_PIN, AXIS1_ENABLE_STATE, AXIS1_FAULT_PIN};
-    const ServoDcSettings ServoSettingsAxis1 = {AXIS1_DRIVER_MODEL, AXIS1_DRIVER_STATUS, AXIS1_SERVO_MAX_VELOCITY, AXIS1_SERVO_ACCELERATION};
+    const ServoDcPins ServoPinsAxis1 = {AXIS1_SERVO_PH1_PIN, AXIS1_SERVO_PH1_STATE, AXIS1_SERVO_PH2_PIN, AXIS1_SERVO_PH2_STATE, AXIS1_ENABLE_PIN, AXIS1_ENABLE_STATE, AXIS1_FAULT_PIN, AXIS1_SERVO_CURRENT_PIN};
+    const ServoDcSettings ServoSettingsAxis1 = {AXIS1_DRIVER_MODEL, AXIS1_DRIVER_STATUS, AXIS1_SERVO_MAX_VELOCITY, AXIS1_SERVO_ACCELERATION, AXIS1_SERVO_CURRENT_SCALE, AXIS1_SERVO_CURRENT_LIMIT};
     ServoDc driver1(1, &ServoPinsAxis1, &ServoSettingsAxis1);
   #elif defined(AXIS1_SERVO_TMC2209)
     const ServoTmcPins ServoPinsAxis1 = {AXIS1_STEP_PIN, AXIS1_DIR_PIN, AXIS1_ENABLE_PIN, AXIS1_ENABLE_STATE, AXIS1_M0_PIN, AXIS1_M1_PIN, AXIS1_FAULT_PIN};
@@ -47,12 +51,24 @@
     ServoTmc5160 driver1(1, &ServoPinsAxis1, &ServoSettingsAxis1);
   #endif
 
+  #if AXIS1_MOTOR_ENCODER != OFF
+    #if AXIS1_MOTOR_ENCODER == AB_ESP32
+      QuadratureEsp32 encMotorAxis1(AXIS1_MOTOR_ENCODER_A_PIN, AXIS1_MOTOR_ENCODER_B_PIN, 1);
+    #elif AXIS1_MOTOR_ENCODER == AB_STM32
+      QuadratureStm32 encMotorAxis1(AXIS1_MOTOR_ENCODER_A_PIN, AXIS1_MOTOR_ENCODER_B_PIN, 1);
+    #elif AXIS1_MOTOR_ENCODER == AB_TEENSY4
+      QuadratureTeensy4 encMotorAxis1(AXIS1_MOTOR_ENCODER_A_PIN, AXIS1_MOTOR_ENCODER_B_PIN, 1);
+    #endif
+    ServoControl servoVelocityControlAxis1;
+    Pid pidVelocityAxis1(AXIS1_VELOCITY_PID_P, AXIS1_VELOCITY_PID_I, AXIS1_VELOCITY_PID_D, AXIS1_VELOCITY_PID_P, AXIS1_VELOCITY_PID_I, AXIS1_VELOCITY_PID_D);
+  #endif
+
   ServoMotor motor1(1, ((ServoDriver*)&driver1), &encAxis1, AXIS1_ENCODER_ORIGIN, AXIS1_ENCODER_REVERSE == ON, &pidAxis1, &servoControlAxis1, AXIS1_SYNC_THRESHOLD);
 #endif
 
 #ifdef AXIS1_STEP_DIR_PRESENT
   const StepDirDriverPins DriverPinsAxis1 = {AXIS1_M0_PIN, AXIS1_M1_PIN, AXIS1_M2_PIN, AXIS1_M2_ON_STATE, AXIS1_M3_PIN, AXIS1_DECAY_PIN, AXIS1_FAULT_PIN};
-  const StepDirDriverSettings DriverSettingsAxis1 = {AXIS1_DRIVER_MODEL, AXIS1_DRIVER_MICROSTEPS, AXIS1_DRIVER_MICROSTEPS_GOTO, AXIS1_DRIVER_IHOLD, AXIS1_DRIVER_IRUN, AXIS1_DRIVER_IGOTO, AXIS1_DRIVER_INTPOL, AXIS1_DRIVER_DECAY, AXIS1_DRIVER_DECAY_GOTO, AXIS1_DRIVER_STATUS};
+  const StepDirDriverSettings DriverSettingsAxis1 = {AXIS1_DRIVER_MODEL, AXIS1_DRIVER_MICROSTEPS, AXIS1_DRIVER_MICROSTEPS_GOTO, AXIS1_DRIVER_IHOLD, AXIS1_DRIVER_IRUN, AXIS1_DRIVER_IGOTO, AXIS1_DRIVER_INTPOL, AXIS1_DRIVER_DECAY, AXIS1_DRIVER_DECAY_GOTO, AXIS1_DRIVER_STATUS, AXIS1_DRIVER_STALL, AXIS1_DRIVER_DECAY_FAST, AXIS1_DRIVER_IFAST, AXIS1_DRIVER_FAST_RATE, AXIS1_DRIVER_ITRACK};
   #if defined(AXIS1_STEP_DIR_LEGACY)
     StepDirGeneric driver1(1, &DriverPinsAxis1, &DriverSettingsAxis1);
   #elif defined(AXIS1_STEP_DIR_TMC_SPI)
@@ -63,6 +79,30 @@
 
   const StepDirPins StepDirPinsAxis1 = {AXIS1_STEP_PIN, AXIS1_STEP_STATE, AXIS1_DIR_PIN, AXIS1_ENABLE_PIN, AXIS1_ENABLE_STATE};
   StepDirMotor motor1(1, &StepDirPinsAxis1, ((StepDirDriver*)&driver1));
+
+  #if AXIS1_ENCODER == AB
+    Quadrature encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+  #elif AXIS1_ENCODER == AB_ESP32
+    QuadratureEsp32 encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+  #elif AXIS1_ENCODER == AB_STM32
+    QuadratureStm32 encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+  #elif AXIS1_ENCODER == AB_TEENSY4
+    QuadratureTeensy4 encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+  #elif AXIS1_ENCODER == CW_CCW
+    CwCcw encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+  #elif AXIS1_ENCODER == PULSE_DIR
+    PulseDir encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+  #elif AXIS1_ENCODER == AS37_H39B_B
+    As37h39bb encAxis1(AXIS1_ENCODER_A_PIN, AXIS1_ENCODER_B_PIN, 1);
+  #elif AXIS1_ENCODER == SERIAL_BRIDGE
+    SerialBridge encAxis1(1);
+  #endif
+#endif
+
+#ifdef AXIS1_TMC_RAMP_PRESENT
+  const TmcRampPins TmcRampPinsAxis1 = {AXIS1_ENABLE_PIN, AXIS1_ENABLE_STATE, AXIS1_M0_PIN, AXIS1_M1_PIN, AXIS1_M2_PIN, AXIS1_M3_PIN, AXIS1_FAULT_PIN};
+  const TmcRampSettings TmcRampSettingsAxis1 = {AXIS1_DRIVER_MODEL, AXIS1_DRIVER_MICROSTEPS, AXIS1_DRIVER_IHOLD, AXIS1_DRIVER_IRUN, AXIS1_DRIVER_IGOTO, AXIS1_DRIVER_DECAY, AXIS1_DRIVER_DECAY_GOTO, AXIS1_DRIVER_STATUS};
+  TmcRampMotor motor1(1, &TmcRampPinsAxis1, &TmcRampSettingsAxis1);
 #endif
 
 const AxisPins PinsAxis1 = {AXIS1_SENSE_LIMIT_MIN_PIN, AXIS1_SENSE_HOME_PIN, AXIS1_SENSE_LIMIT_MAX_PIN, {AXIS1_SENSE_HOME, AXIS1_SENSE_HOME_INIT, degToRadF(AXIS1_SENSE_HOME_DIST_LIMIT), AXIS1_SENSE_LIMIT_MIN, AXIS1_SENSE_LIMIT_MAX, AXIS1_SENSE_LIMIT_INIT}};
@@ -81,6 +121,10 @@ Axis axis1(1, &PinsAxis1, &SettingsAxis1, AXIS_MEASURE_RADIANS, arcsecToRad(AXIS
     Quadrature encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
   #elif AXIS2_ENCODER == AB_ESP32
     QuadratureEsp32 encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
+  #elif AXIS2_ENCODER == AB_STM32
+    QuadratureStm32 encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
+  #elif AXIS2_ENCODER == AB_TEENSY4
+    QuadratureTeensy4 encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
   #elif AXIS2_ENCODER == CW_CCW
     CwCcw encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
   #elif AXIS2_ENCODER == PULSE_DIR
@@ -98,8 +142,8 @@ Axis axis1(1, &PinsAxis1, &SettingsAxis1, AXIS_MEASURE_RADIANS, arcsecToRad(AXIS
   #endif
 
   #if defined(AXIS2_SERVO_DC)
-    const ServoDcPins ServoPinsAxis2 = {AXIS2_SERVO_PH1_PIN, AXIS2_SERVO_PH1_STATE, AXIS2_SERVO_PH2_PIN, AXIS2_SERVO_PH2_STATE, AXIS2_ENABLE_PIN, AXIS2_ENABLE_STATE, AXIS2_FAULT_PIN};
-    const ServoDcSettings ServoSettingsAxis2 = {AXIS2_DRIVER_MODEL, AXIS2_DRIVER_STATUS, AXIS2_SERVO_MAX_VELOCITY, AXIS2_SERVO_ACCELERATION};
+    const ServoDcPins ServoPinsAxis2 = {AXIS2_SERVO_PH1_PIN, AXIS2_SERVO_PH1_STATE, AXIS2_SERVO_PH2_PIN, AXIS2_SERVO_PH2_STATE, AXIS2_ENABLE_PIN, AXIS2_ENABLE_STATE, AXIS2_FAULT_PIN, AXIS2_SERVO_CURRENT_PIN};
+    const ServoDcSettings ServoSettingsAxis2 = {AXIS2_DRIVER_MODEL, AXIS2_DRIVER_STATUS, AXIS2_SERVO_MAX_VELOCITY, AXIS2_SERVO_ACCELERATION, AXIS2_SERVO_CURRENT_SCALE, AXIS2_SERVO_CURRENT_LIMIT};
     ServoDc driver2(2, &ServoPinsAxis2, &ServoSettingsAxis2);
   #elif defined(AXIS2_SERVO_TMC2209)
     const ServoTmcPins ServoPinsAxis2 = {AXIS2_STEP_PIN, AXIS2_DIR_PIN, AXIS2_ENABLE_PIN, AXIS2_ENABLE_STATE, AXIS2_M0_PIN, AXIS2_M1_PIN, AXIS2_FAULT_PIN};
@@ -111,13 +155,25 @@ Axis axis1(1, &PinsAxis1, &SettingsAxis1, AXIS_MEASURE_RADIANS, arcsecToRad(AXIS
     ServoTmc5160 driver2(2, &ServoPinsAxis2, &ServoSettingsAxis2);
   #endif
 
+  #if AXIS2_MOTOR_ENCODER != OFF
+    #if AXIS2_MOTOR_ENCODER == AB_ESP32
+      QuadratureEsp32 encMotorAxis2(AXIS2_MOTOR_ENCODER_A_PIN, AXIS2_MOTOR_ENCODER_B_PIN, 2);
+    #elif AXIS2_MOTOR_ENCODER == AB_STM32
+      QuadratureStm32 encMotorAxis2(AXIS2_MOTOR_ENCODER_A_PIN, AXIS2_MOTOR_ENCODER_B_PIN, 2);
+    #elif AXIS2_MOTOR_ENCODER == AB_TEENSY4
+      QuadratureTeensy4 encMotorAxis2(AXIS2_MOTOR_ENCODER_A_PIN, AXIS2_MOTOR_ENCODER_B_PIN, 2);
+    #endif
+    ServoControl servoVelocityControlAxis2;
+    Pid pidVelocityAxis2(AXIS2_VELOCITY_PID_P, AXIS2_VELOCITY_PID_I, AXIS2_VELOCITY_PID_D, AXIS2_VELOCITY_PID_P, AXIS2_VELOCITY_PID_I, AXIS2_VELOCITY_PID_D);
+  #endif
+
   ServoMotor motor2(2, ((ServoDriver*)&driver2), &encAxis2, AXIS2_ENCODER_ORIGIN, AXIS2_ENCODER_REVERSE == ON, &pidAxis2, &servoControlAxis2, AXIS2_SYNC_THRESHOLD);
   IRAM_ATTR void moveAxis2() { motor2.move(); }
 #endif
 
 #ifdef AXIS2_STEP_DIR_PRESENT
   const StepDirDriverPins StepDirDriverPinsAxis2 = {AXIS2_M0_PIN, AXIS2_M1_PIN, AXIS2_M2_PIN, AXIS2_M2_ON_STATE, AXIS2_M3_PIN, AXIS2_DECAY_PIN, AXIS2_FAULT_PIN};
-  const StepDirDriverSettings StepDirDriverSettingsAxis2 = {AXIS2_DRIVER_MODEL, AXIS2_DRIVER_MICROSTEPS, AXIS1_DRIVER_MICROSTEPS_GOTO, AXIS2_DRIVER_IHOLD, AXIS2_DRIVER_IRUN, AXIS2_DRIVER_IGOTO, AXIS2_DRIVER_INTPOL, AXIS2_DRIVER_DECAY, AXIS2_DRIVER_DECAY_GOTO, AXIS2_DRIVER_STATUS};
+  const StepDirDriverSettings StepDirDriverSettingsAxis2 = {AXIS2_DRIVER_MODEL, AXIS2_DRIVER_MICROSTEPS, AXIS1_DRIVER_MICROSTEPS_GOTO, AXIS2_DRIVER_IHOLD, AXIS2_DRIVER_IRUN, AXIS2_DRIVER_IGOTO, AXIS2_DRIVER_INTPOL, AXIS2_DRIVER_DECAY, AXIS2_DRIVER_DECAY_GOTO, AXIS2_DRIVER_STATUS, AXIS2_DRIVER_STALL, AXIS2_DRIVER_DECAY_FAST, AXIS2_DRIVER_IFAST, AXIS2_DRIVER_FAST_RATE, AXIS2_DRIVER_ITRACK};
   #if defined(AXIS2_STEP_DIR_LEGACY)
     StepDirGeneric driver2(2, &StepDirDriverPinsAxis2, &StepDirDriverSettingsAxis2);
   #elif defined(AXIS2_STEP_DIR_TMC_SPI)
@@ -128,6 +184,30 @@ Axis axis1(1, &PinsAxis1, &SettingsAxis1, AXIS_MEASURE_RADIANS, arcsecToRad(AXIS
 
   const StepDirPins StepDirPinsAxis2 = {AXIS2_STEP_PIN, AXIS2_STEP_STATE, AXIS2_DIR_PIN, AXIS2_ENABLE_PIN, AXIS2_ENABLE_STATE};
   StepDirMotor motor2(2, &StepDirPinsAxis2, ((StepDirDriver*)&driver2));
+
+  #if AXIS2_ENCODER == AB
+    Quadrature encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
+  #elif AXIS2_ENCODER == AB_ESP32
+    QuadratureEsp32 encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
+  #elif AXIS2_ENCODER == AB_STM32
+    QuadratureStm32 encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
+  #elif AXIS2_ENCODER == AB_TEENSY4
+    QuadratureTeensy4 encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
+  #elif AXIS2_ENCODER == CW_CCW
+    CwCcw encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
+  #elif AXIS2_ENCODER == PULSE_DIR
+    PulseDir encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
+  #elif AXIS2_ENCODER == AS37_H39B_B
+    As37h39bb encAxis2(AXIS2_ENCODER_A_PIN, AXIS2_ENCODER_B_PIN, 2);
+  #elif AXIS2_ENCODER == SERIAL_BRIDGE
+    SerialBridge encAxis2(2);
+  #endif
+#endif
+
+#ifdef AXIS2_TMC_RAMP_PRESENT
+  const TmcRampPins TmcRampPinsAxis2 = {AXIS2_ENABLE_PIN, AXIS2_ENABLE_STATE, AXIS2_M0_PIN, AXIS2_M1_PIN, AXIS2_M2_PIN, AXIS2_M3_PIN, AXIS2_FAULT_PIN};
+  const TmcRampSettings TmcRampSettingsAxis2 = {AXIS2_DRIVER_MODEL, AXIS2_DRIVER_MICROSTEPS, AXIS2_DRIVER_IHOLD, AXIS2_DRIVER_IRUN, AXIS2_DRIVER_IGOTO, AXIS2_DRIVER_DECAY, AXIS2_DRIVER_DECAY_GOTO, AXIS2_DRIVER_STATUS};
+  TmcRampMotor motor2(2, &TmcRampPinsAxis2, &TmcRampSettingsAxis2);
 #endif
 
 const AxisPins PinsAxis2 = {AXIS2_SENSE_LIMIT_MIN_PIN, AXIS2_SENSE_HOME_PIN, AXIS2_SENSE_LIMIT_MAX_PIN, {AXIS2_SENSE_HOME, AXIS2_SENSE_HOME_INIT, degToRadF(AXIS2_SENSE_HOME_DIST_LIMIT), AXIS2_SENSE_LIMIT_MIN, AXIS2_SENSE_LIMIT_MAX, AXIS2_SENSE_LIMIT_INIT}};
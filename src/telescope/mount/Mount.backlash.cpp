@@ -0,0 +1,121 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount control, backlash measurement
+
+#include "Mount.h"
+
+#ifdef MOUNT_PRESENT
+
+#include "../../lib/tasks/OnTask.h"
+
+#include "goto/Goto.h"
+#include "guide/Guide.h"
+#include "park/Park.h"
+
+// travel for each reversal, enough to clear the largest backlash allowed (3600 arc-seconds) with room to spare
+#define BACKLASH_CAL_TRAVEL arcsecToRad(7200.0)
+
+// polls (at 100ms) to wait once stopped so the encoder reading has caught up
+#define BACKLASH_CAL_SETTLE 10
+
+void backlashCalibrateWrapper() { mount.backlashCalibratePoll(); }
+
+CommandError Mount::backlashCalibrate(int axisNumber) {
+  if (axisNumber != 1 && axisNumber != 2) return CE_PARAM_RANGE;
+  if (backlashCal.stage != BCS_NONE && backlashCal.stage != BCS_DONE && backlashCal.stage != BCS_FAILED) return CE_0;
+  if (park.state == PS_PARKED) return CE_PARKED;
+
+  Axis *axis = axisNumber == 1 ? &axis1 : &axis2;
+  backlashCal.axisNumber = axisNumber;
+  backlashCal.saved = axis->getBacklash();
+
+  long steps;
+  if (!encoderSteps(axisNumber, &steps)) {
+    // no encoder, hold off compensation so the client sees the full dead time at each guide reversal
+    axis->setBacklashSteps(0);
+    backlashCal.stage = BCS_CLIENT;
+    VF("MSG: Mount, axis"); V(axisNumber); VLF(" backlash calibration waiting for the client");
+    return CE_NONE;
+  }
+
+  // the encoder measures it, this needs the axis to itself
+  if (isTracking() || isSlewing()) return CE_SLEW_IN_MOTION;
+  #if GOTO_FEATURE == ON
+    if (goTo.state != GS_NONE) return CE_SLEW_IN_MOTION;
+  #endif
+  if (guide.state != GU_NONE) return CE_SLEW_IN_MOTION;
+  if (!axis->isEnabled()) return CE_SLEW_ERR_IN_STANDBY;
+
+  axis->setBacklashSteps(0);
+  backlashCal.start = axis->getTargetCoordinateSteps();
+  backlashCal.travel = lround(BACKLASH_CAL_TRAVEL*axis->getStepsPerMeasure());
+  backlashCal.sum = 0;
+  backlashCal.stage = BCS_TAKEUP;
+  backlashCal.settle = 0;
+
+  // first move forward so any slack is taken up in that direction
+  axis->setTargetCoordinateSteps(backlashCal.start + backlashCal.travel);
+  if (axis->autoGoto() != CE_NONE) { backlashCalibrateEnd(false); backlashCal.stage = BCS_FAILED; return CE_SLEW_ERR_UNSPECIFIED; }
+
+  VF("MSG: Mount, axis"); V(axisNumber); VF(" start backlash calibration task (rate 100ms priority 7)... ");
+  backlashCal.handle = tasks.add(100, 0, true, 7, backlashCalibrateWrapper, "BklCal");
+  if (backlashCal.handle) { VLF("success"); } else { VLF("FAILED!"); axis->autoSlewAbort(); backlashCalibrateEnd(false); backlashCal.stage = BCS_FAILED; return CE_0; }
+  return CE_NONE;
+}
+
+void Mount::backlashCalibratePoll() {
+  Axis *axis = backlashCal.axisNumber == 1 ? &axis1 : &axis2;
+
+  if (axis->isSlewing()) { backlashCal.settle = 0; return; }
+  if (backlashCal.stage == BCS_NONE) { VLF("MSG: Mount, backlash calibration canceled"); backlashCalibrateEnd(false); return; }
+  if (axis->motorFault() || !axis->atTarget()) { DLF("ERR: Mount, backlash calibration move failed"); backlashCalibrateEnd(false); backlashCal.stage = BCS_FAILED; return; }
+  if (++backlashCal.settle < BACKLASH_CAL_SETTLE) return;
+  backlashCal.settle = 0;
+
+  long steps;
+  if (!encoderSteps(backlashCal.axisNumber, &steps)) { DLF("ERR: Mount, backlash calibration encoder failed"); backlashCalibrateEnd(false); backlashCal.stage = BCS_FAILED; return; }
+
+  // after each reversal the encoder comes up short of the motor by the backlash
+  if (backlashCal.stage == BCS_REVERSE || backlashCal.stage == BCS_FORWARD) {
+    long moved = labs(steps - backlashCal.encoder);
+    backlashCal.sum += backlashCal.travel - moved;
+    VF("MSG: Mount, axis"); V(backlashCal.axisNumber); VF(" backlash reversal "); V(backlashCal.travel - moved); VLF(" steps");
+  }
+  backlashCal.encoder = steps;
+
+  long target;
+  switch (backlashCal.stage) {
+    case BCS_TAKEUP:  backlashCal.stage = BCS_REVERSE; target = backlashCal.start; break;
+    case BCS_REVERSE: backlashCal.stage = BCS_FORWARD; target = backlashCal.start + backlashCal.travel; break;
+    case BCS_FORWARD: backlashCal.stage = BCS_RETURN;  target = backlashCal.start; break;
+    default: {
+      float backlash = (backlashCal.sum/2.0F)/axis->getStepsPerMeasure();
+      if (backlash < 0.0F) backlash = 0.0F;
+      if (backlash > arcsecToRad(3600.0F)) backlash = arcsecToRad(3600.0F);
+      backlashCalibrateStore(backlash);
+      backlashCalibrateEnd(true);
+      backlashCal.stage = BCS_DONE;
+      VF("MSG: Mount, axis"); V(backlashCal.axisNumber); VF(" backlash calibrated "); V(radToArcsec(backlash)); VLF(" arc-seconds");
+    }
+    return;
+  }
+
+  axis->setTargetCoordinateSteps(target);
+  if (axis->autoGoto() != CE_NONE) { DLF("ERR: Mount, backlash calibration move failed"); backlashCalibrateEnd(false); backlashCal.stage = BCS_FAILED; }
+}
+
+void Mount::backlashCalibrateStore(float value) {
+  if (backlashCal.axisNumber == 1) { settings.backlash.axis1 = value; axis1.setBacklash(value); } else
+  if (backlashCal.axisNumber == 2) { settings.backlash.axis2 = value; axis2.setBacklash(value); }
+  nv.updateBytes(NV_MOUNT_SETTINGS_BASE, &settings, sizeof(MountSettings));
+}
+
+void Mount::backlashCalibrateEnd(bool keep) {
+  if (backlashCal.handle) { tasks.setDurationComplete(backlashCal.handle); backlashCal.handle = 0; }
+  if (!keep) {
+    if (backlashCal.axisNumber == 1) axis1.setBacklash(backlashCal.saved); else
+    if (backlashCal.axisNumber == 2) axis2.setBacklash(backlashCal.saved);
+  }
+  backlashCal.stage = keep ? BCS_DONE : BCS_NONE;
+}
+
+#endif
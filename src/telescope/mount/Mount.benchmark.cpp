@@ -0,0 +1,91 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount control, coordinate pipeline benchmark
+
+#include "Mount.h"
+
+#if defined(MOUNT_PRESENT) && defined(MOUNT_BENCHMARK)
+
+#include "../../lib/convert/Convert.h"
+#include "site/Site.h"
+#include "coordinates/Transform.h"
+
+#define BENCHMARK_CALLS 100
+
+#if ALIGN_MAX_NUM_STARS > 1
+  // the model fit is timed on its own instance so the model in use isn't disturbed
+  GeoAlign benchmarkAlign;
+
+  // canned star set, mount positions spread over the sky with the stars offset by a known polar misalignment
+  #define BENCHMARK_STARS (ALIGN_MAX_NUM_STARS < 6 ? ALIGN_MAX_NUM_STARS : 6)
+  static void benchmarkAutoModel() {
+    benchmarkAlign.init(transform.mountType, site.location.latitude);
+    for (int i = 0; i < BENCHMARK_STARS; i++) {
+      Coordinate mount, actual;
+      mount.h = degToRad(-60.0 + 120.0*i/(BENCHMARK_STARS - 1));
+      mount.d = degToRad(10.0 + 50.0*((i*3) % BENCHMARK_STARS)/BENCHMARK_STARS);
+      mount.pierSide = (i & 1) ? PIER_SIDE_WEST : PIER_SIDE_EAST;
+      actual = mount;
+      actual.h += arcsecToRad(600.0*sin(mount.h)*tan(mount.d) + 120.0);
+      actual.d += arcsecToRad(600.0*cos(mount.h) - 90.0);
+      // the star count is one more than added so addStar() doesn't start its own model task
+      benchmarkAlign.addStar(i + 1, BENCHMARK_STARS + 1, &actual, &mount);
+    }
+    benchmarkAlign.autoModel(BENCHMARK_STARS);
+  }
+#endif
+
+bool Mount::benchmark(char n, float *us, float *cycles) {
+  Coordinate position = getMountPosition();
+  Coordinate target;
+  char s[16];
+  double d;
+  int calls = BENCHMARK_CALLS;
+
+  unsigned long start = micros();
+  switch (n) {
+    case '0':
+      for (int i = 0; i < calls; i++) target = transform.mountToNative(&position);
+    break;
+    case '1':
+      for (int i = 0; i < calls; i++) { target = position; transform.topocentricToMount(&target); }
+    break;
+    case '2':
+      #if ALIGN_MAX_NUM_STARS > 1
+        calls = 1;
+        start = micros();
+        benchmarkAutoModel();
+      #else
+        return false;
+      #endif
+    break;
+    case '3':
+      for (int i = 0; i < calls; i++) convert.doubleToHms(s, 12.3456789 + i*0.001, false, PM_HIGH);
+    break;
+    case '4':
+      for (int i = 0; i < calls; i++) { strcpy(s, "+45*30:15"); convert.dmsToDouble(&d, s, true, PM_HIGH); }
+    break;
+    case '5':
+      for (int i = 0; i < calls; i++) poll();
+    break;
+    case '6':
+      // the axis monitor steps its acceleration ramps once per call so it is only timed while the axis is still
+      if (axis1.isSlewing()) return false;
+      for (int i = 0; i < calls; i++) axis1.poll();
+    break;
+    default:
+      return false;
+  }
+  unsigned long elapsed = micros() - start;
+
+  *us = (float)elapsed/calls;
+  #ifdef F_CPU
+    *cycles = *us*(F_CPU/1000000.0F);
+  #else
+    *cycles = 0.0F;
+  #endif
+
+  VF("MSG: Mount, benchmark "); V(n); VF(" "); V(*us); VLF("us per call");
+  return true;
+}
+
+#endif
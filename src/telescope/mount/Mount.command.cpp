@@ -50,7 +50,7 @@ bool Mount::command(char *reply, char *command, char *parameter, bool *supressFr
     // :GT#         Get tracking rate, 0.0 unless TrackingSidereal
     //              Returns: n.n# (OnStep returns more decimal places than LX200 standard)
     if (command[1] == 'T' && parameter[0] == 0)  {
-      if (trackingState == TS_NONE) strcpy(reply,"0"); else sprintF(reply, "%0.5f", siderealToHz(trackingRate));
+      if (trackingState == TS_NONE) strcpy(reply,"0"); else Formatter(reply, 20).fixed(siderealToHz(trackingRate), 5);
       *numericReply = false;
     } else 
 
@@ -66,26 +66,52 @@ bool Mount::command(char *reply, char *command, char *parameter, bool *supressFr
         switch (parameter[1]) {
           case '0': convert.doubleToDms(reply, radToDeg(axis1.getInstrumentCoordinate()), true, true, PM_HIGH); break;
           case '1': convert.doubleToDms(reply, radToDeg(axis2.getInstrumentCoordinate()), true, true, PM_HIGH); break; 
-          case '2': sprintF(reply, "%0.6f", radToDeg(axis1.getInstrumentCoordinate())); break;
-          case '3': sprintF(reply, "%0.6f", radToDeg(axis2.getInstrumentCoordinate())); break;
-          case '4': sprintf(reply, "%ld", (long)axis1.motor->getEncoderCount()); break;
-          case '5': sprintf(reply, "%ld", (long)axis2.motor->getEncoderCount()); break;
+          case '2': Formatter(reply, 20).fixed(radToDeg(axis1.getInstrumentCoordinate()), 6); break;
+          case '3': Formatter(reply, 20).fixed(radToDeg(axis2.getInstrumentCoordinate()), 6); break;
+          case '4': Formatter(reply, 20).sint(axis1.motor->getEncoderCount()); break;
+          case '5': Formatter(reply, 20).sint(axis2.motor->getEncoderCount()); break;
           default:  *numericReply = true; *commandError = CE_CMD_UNKNOWN;
         }
       } else
 
+      #ifdef MOUNT_BENCHMARK
+        // :GXB[n]#   Get benchmark time for coordinate pipeline function [n]
+        //            0 = mountToNative, 1 = topocentricToMount, 2 = GeoAlign::autoModel (canned stars),
+        //            3 = doubleToHms, 4 = dmsToDouble, 5 = Mount::poll, 6 = Axis::poll (axis1 monitor, not while slewing)
+        //            Returns: us per call,cycles per call#
+        if (parameter[0] == 'B')  {
+          float us, cycles;
+          if (benchmark(parameter[1], &us, &cycles)) {
+            sprintF(reply, "%0.3f,", us);
+            sprintF(&reply[strlen(reply)], "%0.0f", cycles);
+            *numericReply = false;
+          } else *commandError = CE_PARAM_RANGE;
+        } else
+      #endif
+
+      #if DOME_SLAVING == ON
+        // :GXDZ#     Get dome azimuth for the current position, for the goto destination, and the tracking rate
+        //            Returns: zzz.z,ttt.t,r.rrrr# in degrees and degrees per second
+        if (parameter[0] == 'D' && parameter[1] == 'Z')  {
+          float azimuth, azimuthTarget, rate;
+          getDome(&azimuth, &azimuthTarget, &rate);
+          Formatter(reply, 40).fixed(azimuth, 1).chr(',').fixed(azimuthTarget, 1).chr(',').fixed(rate, 4);
+          *numericReply = false;
+        } else
+      #endif
+
       // :GXE[m]#   Get mount setting
       //            Returns: n#
       if (parameter[0] == 'E')  {
         uint16_t axesToRevert;
         switch (parameter[1]) {
-          case '4': sprintf(reply, "%ld", lround(axis1.getStepsPerMeasure()/RAD_DEG_RATIO)); *numericReply = false; break;
-          case '5': sprintf(reply, "%ld", lround(axis2.getStepsPerMeasure()/RAD_DEG_RATIO)); *numericReply = false; break;
+          case '4': Formatter(reply, 20).sint(lround(axis1.getStepsPerMeasure()/RAD_DEG_RATIO)); *numericReply = false; break;
+          case '5': Formatter(reply, 20).sint(lround(axis2.getStepsPerMeasure()/RAD_DEG_RATIO)); *numericReply = false; break;
           case 'E': reply[0] = '0' + (MOUNT_COORDS - 1); *supressFrame = true; *numericReply = false; break;
           case 'F': if (AXIS2_TANGENT_ARM != ON) *commandError = CE_0; break;
           case 'M':
             axesToRevert = nv.readUI(NV_AXIS_SETTINGS_REVERT);
-            if (axesToRevert & 1) sprintf(reply, "%d", (int)nv.readUC(NV_MOUNT_TYPE_BASE)); else strcpy(reply, "0");
+            if (axesToRevert & 1) Formatter(reply, 20).sint(nv.readUC(NV_MOUNT_TYPE_BASE)); else strcpy(reply, "0");
             *numericReply = false;
           break;
         default:
@@ -97,11 +123,18 @@ bool Mount::command(char *reply, char *command, char *parameter, bool *supressFr
       //            Returns: Value
       if (parameter[0] == 'F')  {
         switch (parameter[1]) {
-          case '3': sprintF(reply, "%0.6f", (axis1.getDirection() == DIR_FORWARD) ? axis1.getFrequencySteps() : -axis1.getFrequencySteps()); *numericReply = false; break;
-          case '4': sprintF(reply, "%0.6f", (axis2.getDirection() == DIR_FORWARD) ? axis2.getFrequencySteps() : -axis2.getFrequencySteps()); *numericReply = false; break;
-          case 'A': sprintf(reply, "%d%%", 50); *numericReply = false; break; // workload
+          case '3': Formatter(reply, 20).fixed((axis1.getDirection() == DIR_FORWARD) ? axis1.getFrequencySteps() : -axis1.getFrequencySteps(), 6); *numericReply = false; break;
+          case '4': Formatter(reply, 20).fixed((axis2.getDirection() == DIR_FORWARD) ? axis2.getFrequencySteps() : -axis2.getFrequencySteps(), 6); *numericReply = false; break;
+          case 'A': // workload
+            #ifdef TASKS_LOAD_METER
+              Formatter(reply, 20).sint((int)lroundf(tasks.getLoad())).chr('%');
+            #else
+              Formatter(reply, 20).sint(50).chr('%');
+            #endif
+            *numericReply = false;
+          break;
           case 'G': // index position for Axis2
-            sprintF(reply, "%0.6f", radToDeg(transform.instrumentToMount(0.0, axis2.getIndexPosition()).a2));
+            Formatter(reply, 20).fixed(radToDeg(transform.instrumentToMount(0.0, axis2.getIndexPosition()).a2), 6);
             *numericReply = false;
           break;
         default:
@@ -112,14 +145,14 @@ bool Mount::command(char *reply, char *command, char *parameter, bool *supressFr
       // :GXTD#     Get tracking rate offset Dec in arc-seconds/sidereal second
       //            Returns: n.nnnnnn#
       if (parameter[0] == 'T' && parameter[1] == 'D' && parameter[2] == 0) {
-        sprintF(reply, "%0.8f", trackingRateOffsetDec*15.0F);
+        Formatter(reply, 20).fixed(trackingRateOffsetDec*15.0F, 8);
         *numericReply = false;
       } else
 
       // :GXTR#     Get tracking rate offset RA in arc-seconds/sidereal second
       //            Returns: n.nnnnnn#
       if (parameter[0] == 'T' && parameter[1] == 'R' && parameter[2] == 0) {
-        sprintF(reply, "%0.8f", trackingRateOffsetRA*15.0F);
+        Formatter(reply, 20).fixed(trackingRateOffsetRA*15.0F, 8);
         *numericReply = false;
       } else return false;
 
@@ -360,16 +393,40 @@ bool Mount::command(char *reply, char *command, char *parameter, bool *supressFr
   //            Return: 0 on failure
   //                    1 on success
   //        Set the Backlash values.  Units are arc-seconds
+  // :$BC[R|D]# Start backlash calibration for the RA/Azm or Dec/Alt axis, with an encoder on the axis it's
+  //            measured and stored by OnStep, otherwise compensation is held off until the client (using
+  //            guide pulse reversals and a guide camera) stores the result with :$B[R|D]n#
+  //            Return: 0 on failure
+  //                    1 on success
+  // :$BCX#     Cancel backlash calibration, restoring the backlash set before it started
+  //            Return: 0 on failure
+  //                    1 on success
+  if (command[0] == '$' && command[1] == 'B' && parameter[0] == 'C') {
+    if (parameter[1] == 'R' && parameter[2] == 0) *commandError = backlashCalibrate(1); else
+    if (parameter[1] == 'D' && parameter[2] == 0) *commandError = backlashCalibrate(2); else
+    if (parameter[1] == 'X' && parameter[2] == 0) {
+      BacklashCalStage stage = backlashCal.stage;
+      if (stage >= BCS_TAKEUP && stage <= BCS_RETURN) {
+        // the calibration task restores the backlash once the axis has stopped
+        if (backlashCal.axisNumber == 1) axis1.autoSlewAbort(); else axis2.autoSlewAbort();
+        backlashCal.stage = BCS_NONE;
+      } else
+      if (stage == BCS_CLIENT) backlashCalibrateEnd(false);
+    } else *commandError = CE_CMD_UNKNOWN;
+  } else
+
   if (command[0] == '$' && command[1] == 'B') {
     int16_t arcSecs;
     if (convert.atoi2((char*)&parameter[1], &arcSecs)) {
       if (arcSecs >= 0 && arcSecs <= 3600) {
         if (parameter[0] == 'D') {
+          if (backlashCal.stage == BCS_CLIENT && backlashCal.axisNumber == 2) backlashCalibrateEnd(true);
           settings.backlash.axis2 = arcsecToRad(arcSecs);
           axis2.setBacklash(settings.backlash.axis2);
           nv.updateBytes(NV_MOUNT_SETTINGS_BASE, &settings, sizeof(MountSettings));
         } else
         if (parameter[0] == 'R') {
+          if (backlashCal.stage == BCS_CLIENT && backlashCal.axisNumber == 1) backlashCalibrateEnd(true);
           settings.backlash.axis1 = arcsecToRad(arcSecs);
           axis1.setBacklash(settings.backlash.axis1);
           nv.updateBytes(NV_MOUNT_SETTINGS_BASE, &settings, sizeof(MountSettings));
@@ -383,6 +440,20 @@ bool Mount::command(char *reply, char *command, char *parameter, bool *supressFr
   //            Return: n#
   // :%BR#      Get RA/Azm Antibacklash value in arc-seconds
   //            Return: n#
+  // :%BC#      Get backlash calibration status
+  //            Return: n#
+  //            where n is 0 idle, 1 measuring, 2 waiting for the client, 3 done, or 4 failed
+  if (command[0] == '%' && command[1] == 'B' && parameter[0] == 'C' && parameter[1] == 0) {
+    BacklashCalStage stage = backlashCal.stage;
+    int n = 0;
+    if (stage >= BCS_TAKEUP && stage <= BCS_RETURN) n = 1; else
+    if (stage == BCS_CLIENT) n = 2; else
+    if (stage == BCS_DONE) n = 3; else
+    if (stage == BCS_FAILED) n = 4;
+    sprintf(reply, "%d", n);
+    *numericReply = false;
+  } else
+
   if (command[0] == '%' && command[1] == 'B' && parameter[1] == 0) {
     if (parameter[0] == 'D') {
         int arcSec = round(radToArcsec(settings.backlash.axis2));
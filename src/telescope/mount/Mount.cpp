@@ -14,13 +14,23 @@
 #include "home/Home.h"
 #include "library/Library.h"
 #include "limits/Limits.h"
+#include "log/MountLog.h"
+#include "capture/Capture.h"
+#include "ephemeris/Ephemeris.h"
+#include "trajectory/Trajectory.h"
+#include "scenario/Scenario.h"
 #include "park/Park.h"
 #include "pec/Pec.h"
 #include "site/Site.h"
 #include "st4/St4.h"
 #include "status/Status.h"
 
-inline void mountWrapper() { mount.poll(); }
+inline void mountWrapper() {
+  mount.poll();
+  #if MOUNT_LOG != OFF
+    mountLog.tracking(mount.trackingRateAxis1, mount.trackingRateAxis2);
+  #endif
+}
 
 void Mount::init() {
   // confirm the data structure size
@@ -37,22 +47,45 @@ void Mount::init() {
 
   // get the main axes ready
   delay(100);
+  #if defined(AXIS1_SERVO_PRESENT) && AXIS1_MOTOR_ENCODER != OFF
+    motor1.setMotorEncoder(&encMotorAxis1, AXIS1_MOTOR_ENCODER_REVERSE == ON, AXIS1_MOTOR_ENCODER_RATIO, &pidVelocityAxis1, &servoVelocityControlAxis1, AXIS1_POSITION_LOOP_LIMIT);
+  #endif
+  #if defined(AXIS1_STEP_DIR_PRESENT) && AXIS1_ENCODER != OFF
+    motor1.setEncoder(&encAxis1, AXIS1_ENCODER_ORIGIN, AXIS1_ENCODER_REVERSE == ON, AXIS1_ENCODER_RATIO, AXIS1_ENCODER_TRIM_LIMIT, AXIS1_ENCODER_TRIM_TIME);
+  #endif
   if (!axis1.init(&motor1)) { initError.driver = true; DLF("ERR: Axis1, no motion controller!"); }
   axis1.setBacklash(settings.backlash.axis1);
   axis1.setMotionLimitsCheck(false);
   if (AXIS1_POWER_DOWN == ON) axis1.setPowerDownTime(AXIS1_POWER_DOWN_TIME);
+  axis1.setSlewJerkTime(AXIS1_JERK_TIME);
 
   delay(100);
+  #if defined(AXIS2_SERVO_PRESENT) && AXIS2_MOTOR_ENCODER != OFF
+    motor2.setMotorEncoder(&encMotorAxis2, AXIS2_MOTOR_ENCODER_REVERSE == ON, AXIS2_MOTOR_ENCODER_RATIO, &pidVelocityAxis2, &servoVelocityControlAxis2, AXIS2_POSITION_LOOP_LIMIT);
+  #endif
+  #if defined(AXIS2_STEP_DIR_PRESENT) && AXIS2_ENCODER != OFF
+    motor2.setEncoder(&encAxis2, AXIS2_ENCODER_ORIGIN, AXIS2_ENCODER_REVERSE == ON, AXIS2_ENCODER_RATIO, AXIS2_ENCODER_TRIM_LIMIT, AXIS2_ENCODER_TRIM_TIME);
+  #endif
   if (!axis2.init(&motor2)) { initError.driver = true; DLF("ERR: Axis2, no motion controller!"); }
   axis2.setBacklash(settings.backlash.axis2);
   axis2.setMotionLimitsCheck(false);
   if (AXIS2_POWER_DOWN == ON) axis2.setPowerDownTime(AXIS2_POWER_DOWN_TIME);
+  axis2.setSlewJerkTime(AXIS2_JERK_TIME);
+}
+
+bool Mount::calibrateDriversStart() {
+  bool wait = axis1.calibrateDriverStart();
+  if (axis2.calibrateDriverStart()) wait = true;
+  return wait;
+}
+
+void Mount::calibrateDriversFinish() {
+  axis1.calibrateDriverFinish();
+  axis2.calibrateDriverFinish();
 }
 
 void Mount::begin() {
-  axis1.calibrateDriver();
   axis1.enable(MOUNT_ENABLE_IN_STANDBY == ON);
-  axis2.calibrateDriver();
   axis2.enable(MOUNT_ENABLE_IN_STANDBY == ON);
 
   // initialize the critical subsystems
@@ -69,6 +102,14 @@ void Mount::begin() {
   // initialize the other subsystems
   home.init();
   home.reset();
+
+  // absolute encoders on step/dir axes give the position now, no homing or park restore needed
+  #if defined(AXIS1_STEP_DIR_PRESENT) && AXIS1_ENCODER_ABSOLUTE == ON
+    if (!axis1.restoreAbsolutePosition(&encAxis1, AXIS1_ENCODER_REVERSE == ON, AXIS1_ENCODER_RATIO)) { DLF("WRN: Mount, axis1 absolute encoder not ready"); }
+  #endif
+  #if defined(AXIS2_STEP_DIR_PRESENT) && AXIS2_ENCODER_ABSOLUTE == ON
+    if (!axis2.restoreAbsolutePosition(&encAxis2, AXIS2_ENCODER_REVERSE == ON, AXIS2_ENCODER_RATIO)) { DLF("WRN: Mount, axis2 absolute encoder not ready"); }
+  #endif
   limits.init();
   guide.init();
 
@@ -89,6 +130,10 @@ void Mount::begin() {
   library.init();
   park.init();
 
+  #if MOUNT_JOURNAL != OFF
+    journalInit();
+  #endif
+
   #if AXIS1_PEC == ON
     pec.init();
   #endif
@@ -97,15 +142,36 @@ void Mount::begin() {
     st4.init();
   #endif
 
+  #if MOUNT_CAPTURE != OFF
+    mountCapture.init();
+  #endif
+
+  #if EPHEMERIS == ON
+    ephemeris.init();
+  #endif
+
+  #if TRAJECTORY == ON
+    trajectory.init();
+  #endif
+
+  #ifdef MOUNT_SCENARIO
+    scenario.init();
+  #endif
+
   tracking(false);
   trackingAutostart();
 
-  #if ALIGN_MAX_NUM_STARS > 1 && ALIGN_MODEL_MEMORY == ON
+  #if ALIGN_MAX_NUM_STARS > 1 && (ALIGN_MODEL_MEMORY == ON || ALIGN_MODEL_SLOTS != OFF)
     transform.align.modelRead();
   #endif
 
-  VF("MSG: Mount, start tracking monitor task (rate 1000ms priority 6)... ");
-  if (tasks.add(1000, 0, true, 6, mountWrapper, "MntTrk")) { VLF("success"); } else { VLF("FAILED!"); }
+  VF("MSG: Mount, start tracking monitor task (rate "); V(TRACK_COMPENSATION_PERIOD); VF("ms priority 6)... ");
+  trackingHandle = tasks.add(TRACK_COMPENSATION_PERIOD, 0, true, 6, mountWrapper, "MntTrk");
+  if (trackingHandle) { VLF("success"); } else { VLF("FAILED!"); }
+
+  #ifdef WATCHDOG_PRESENT
+    heartbeatHandle = watchdog.heartbeatRegister("MntTrk", TRACK_COMPENSATION_PERIOD + WATCHDOG_HEARTBEAT_MS);
+  #endif
 
   update();
 }
@@ -133,6 +199,16 @@ void Mount::trackingAutostart() {
       if (e == CE_PARKED) return;
     #endif
   } else {
+    #if MOUNT_JOURNAL != OFF
+      if (journalResumeTracking) {
+        if (transform.mountType == ALTAZM && !site.isDateTimeReady()) { VLF("MSG: Mount, resume tracking postponed no date/time"); return; }
+        VLF("MSG: Mount, resume tracking from the position journal");
+        tracking(true);
+        trackingRate = journal.trackingRate;
+        completed = true;
+        return;
+      }
+    #endif
     #if TRACK_AUTOSTART == ON
       if (transform.mountType != ALTAZM || site.isDateTimeReady()) {
         VLF("MSG: Mount, autostart tracking sidereal");
@@ -185,7 +261,7 @@ void Mount::enable(bool state) {
 }
 
 // updates the tracking rates, etc. as appropriate for the mount state
-// called once a second by poll() but available here for immediate action
+// called periodically by poll() but available here for immediate action
 void Mount::update() {
   static int lastStatusFlashMs = 0;
   int statusFlashMs = 0;
@@ -212,6 +288,10 @@ void Mount::update() {
       axis2.setFrequencyBase(siderealToRadF(f2)*SIDEREAL_RATIO_F*site.getSiderealRatio());
     }
 
+    // the drivers can run a lower current while an axis is only tracking
+    axis1.setCurrentProfile(guide.activeAxis1() ? CP_GUIDING : (trackingRateAxis1 != 0.0F ? CP_TRACKING : CP_IDLE));
+    axis2.setCurrentProfile(guide.activeAxis2() ? CP_GUIDING : (trackingRateAxis2 != 0.0F ? CP_TRACKING : CP_IDLE));
+
     f1 = fabs(f1);
     f2 = fabs(f2);
     if (f2 > f1) f1 = f2;
@@ -220,6 +300,8 @@ void Mount::update() {
   } else {
     statusFlashMs = SF_SLEWING;
     axis2.setFrequencyBase(0.0F);
+    axis1.setCurrentProfile(CP_SLEWING);
+    axis2.setCurrentProfile(CP_SLEWING);
   }
 
   if (statusFlashMs != lastStatusFlashMs) {
@@ -227,18 +309,20 @@ void Mount::update() {
     mountStatus.flashRate(statusFlashMs);
     xBusy = statusFlashMs == SF_SLEWING;
   }
+
+  // physical NV writes wait while under goto or guide control, on some platforms they stall step timing
+  nv.holdCommits(xBusy || guide.state != GU_NONE);
 }
 
 void Mount::poll() {
-  #ifdef HAL_NO_DOUBLE_PRECISION
-    #define DiffRange  0.0087266463F         // 30 arc-minutes in radians
-    #define DiffRange2 0.017453292F          // 60 arc-minutes in radians
-  #else
-    #define DiffRange  2.908882086657216e-4L // 1 arc-minute in radians
-    #define DiffRange2 5.817764173314432e-4L // 2 arc-minutes in radians
+  #ifdef WATCHDOG_PRESENT
+    watchdog.heartbeat(heartbeatHandle);
   #endif
 
   if (trackingState == TS_NONE) {
+    #if TRACK_KEYHOLE == ON
+      if (keyholeActive) keyholeEnd();
+    #endif
     trackingRateAxis1 = 0.0F;
     trackingRateAxis2 = 0.0F;
     update();
@@ -252,75 +336,32 @@ void Mount::poll() {
     return;
   }
 
-  // get positions 1 (or 30) arc-min ahead and behind the current
   updatePosition(CR_MOUNT_ALL);
   double altitude = current.a;
   double declination = current.d;
+  Coordinate topocentric = current;
 
-  // on fast processors calculate true coordinate for a little more accuracy
-  #ifndef HAL_SLOW_PROCESSOR
-    transform.mountToTopocentric(&current);
-    if (transform.mountType == ALTAZM) transform.horToEqu(&current);
-  #endif
-
-  Coordinate ahead = current;
-  Coordinate behind = current;
-  Y;
-  ahead.h += DiffRange;
-  behind.h -= DiffRange;
+  // calculate true coordinate for a little more accuracy
+  transform.mountToTopocentric(&topocentric); Y;
+  if (transform.mountType == ALTAZM) transform.horToEqu(&topocentric);
 
-  // create horizon coordinates that would exist ahead and behind the current position
-  if (transform.mountType == ALTAZM) {
-    transform.equToHor(&ahead); Y;
-    transform.equToHor(&behind); Y;
-  }
+  // the topocentric motion, sidereal with any tracking rate offsets applied
+  float rateH = 1.0F - trackingRateOffsetRA;
+  float rateD = trackingRateOffsetDec;
 
-  // apply (optional) pointing model and refraction
-  if (settings.rc == RC_MODEL || settings.rc == RC_MODEL_DUAL) {
-    transform.topocentricToObservedPlace(&ahead); Y;
-    transform.topocentricToObservedPlace(&behind); Y;
-    transform.observedPlaceToMount(&ahead); Y;
-    transform.observedPlaceToMount(&behind); Y;
-  } else if (settings.rc == RC_REFRACTION || settings.rc == RC_REFRACTION_DUAL) {
-    transform.topocentricToObservedPlace(&ahead); Y;
-    transform.topocentricToObservedPlace(&behind); Y;
-  }
+  // mount axis rates from the partial derivatives of (optional) refraction and pointing model at this position
+  bool refraction = settings.rc == RC_REFRACTION || settings.rc == RC_REFRACTION_DUAL || settings.rc == RC_MODEL || settings.rc == RC_MODEL_DUAL;
+  bool model = settings.rc == RC_MODEL || settings.rc == RC_MODEL_DUAL;
+  float rate1, rate2;
+  transform.topocentricToMountRates(&topocentric, &current, refraction, model, rateH, rateD, &rate1, &rate2); Y;
 
   // drop the dual axis if not enabled
-  if (settings.rc != RC_REFRACTION_DUAL && settings.rc != RC_MODEL_DUAL) { behind.d = ahead.d; }
-
-  // apply tracking rate offset to equatorial coordinates
-  float timeInSeconds = radToHrs(DiffRange)*3600.0F;
-  float trackingRateOffsetRadsRA = siderealToRad(trackingRateOffsetRA)*timeInSeconds;
-  float trackingRateOffsetRadsDec = siderealToRad(trackingRateOffsetDec)*timeInSeconds;
-  ahead.h -= trackingRateOffsetRadsRA;
-  behind.h += trackingRateOffsetRadsRA;
-  ahead.d += trackingRateOffsetRadsDec;
-  behind.d -= trackingRateOffsetRadsDec;
-
-  // transfer to variables named appropriately for mount coordinates
-  float aheadAxis1, aheadAxis2, behindAxis1, behindAxis2;
-  if (transform.mountType == ALTAZM) {
-    transform.equToHor(&ahead);
-    aheadAxis1 = ahead.z;
-    aheadAxis2 = ahead.a;
-    behindAxis1 = behind.z;
-    behindAxis2 = behind.a;
-  } else {
-    aheadAxis1 = ahead.h;
-    aheadAxis2 = ahead.d;
-    behindAxis1 = behind.h;
-    behindAxis2 = behind.d;
-  }
+  if (transform.mountType != ALTAZM && settings.rc != RC_REFRACTION_DUAL && settings.rc != RC_MODEL_DUAL) rate2 = rateD;
 
   // calculate the Axis1 tracking rate
-  if (aheadAxis1 < -Deg90 && behindAxis1 > Deg90) aheadAxis1 += Deg360;
-  if (behindAxis1 < -Deg90 && aheadAxis1 > Deg90) behindAxis1 += Deg360;
-  float rate1 = (aheadAxis1 - behindAxis1)/DiffRange2;
   if (fabs(trackingRateAxis1 - rate1) <= 0.005F) trackingRateAxis1 = (trackingRateAxis1*9.0F + rate1)/10.0F; else trackingRateAxis1 = rate1;
 
   // calculate the Axis2 Dec/Alt tracking rate
-  float rate2 = (aheadAxis2 - behindAxis2)/DiffRange2;
   if (current.pierSide == PIER_SIDE_WEST) rate2 = -rate2;
   if (fabs(trackingRateAxis2 - rate2) <= 0.005F) trackingRateAxis2 = (trackingRateAxis2*9.0F + rate2)/10.0F; else trackingRateAxis2 = rate2;
 
@@ -336,6 +377,21 @@ void Mount::poll() {
     trackingRateAxis2 = 0.0F;
   }
 
+  #if TRACK_KEYHOLE == ON
+    // a planned azimuth flip takes over Axis1 for a pass near the zenith, Axis2 keeps its rate from above
+    if (transform.mountType == ALTAZM) {
+      #if GOTO_FEATURE == ON
+        if (keyholeActive && goTo.state != GS_NONE) keyholeEnd();
+      #endif
+      if (!keyholeActive) keyholePlan(&topocentric, rateH);
+      float rate;
+      if (keyholeActive && keyholeRate(&rate)) {
+        trackingRateAxis1 = rate;
+        trackingRateAxis2 = rate2;
+      }
+    }
+  #endif
+
   // stop any movement on motor hardware fault
   if (mount.motorFault()) {
     if (goTo.state > GS_NONE) goTo.abort(); else if (guide.state > GU_NONE) guide.abort();
@@ -358,6 +414,31 @@ float Mount::ztr(float a) {
   return r;
 }
 
+// axis encoder position in motor steps, false if the axis has no encoder or it isn't reading
+bool Mount::encoderSteps(int axisNumber, long *steps) {
+  int32_t count = INT32_MAX;
+  #if defined(AXIS1_STEP_DIR_PRESENT) && AXIS1_ENCODER != OFF
+    if (axisNumber == 1 && encAxis1.ready && !encAxis1.error) {
+      count = encAxis1.read();
+      if (count == INT32_MAX) return false;
+      if (AXIS1_ENCODER_REVERSE == ON) count = -count;
+      *steps = lround(count*AXIS1_ENCODER_RATIO);
+      return true;
+    }
+  #endif
+  #if defined(AXIS2_STEP_DIR_PRESENT) && AXIS2_ENCODER != OFF
+    if (axisNumber == 2 && encAxis2.ready && !encAxis2.error) {
+      count = encAxis2.read();
+      if (count == INT32_MAX) return false;
+      if (AXIS2_ENCODER_REVERSE == ON) count = -count;
+      *steps = lround(count*AXIS2_ENCODER_RATIO);
+      return true;
+    }
+  #endif
+  UNUSED(axisNumber); UNUSED(steps); UNUSED(count);
+  return false;
+}
+
 // update where we are pointing *now*
 // CR_MOUNT for Horizon or Equatorial mount coordinates, depending on mount
 // CR_MOUNT_EQU for Equatorial mount coordinates, depending on mode
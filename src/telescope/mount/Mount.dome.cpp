@@ -0,0 +1,80 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount control, dome geometry model for dome slaving
+
+#include "Mount.h"
+
+#if defined(MOUNT_PRESENT) && DOME_SLAVING == ON
+
+#include "site/Site.h"
+#include "coordinates/Transform.h"
+#include "goto/Goto.h"
+
+// dome azimuth and altitude in radians where the optical axis meets the dome, for a Mount
+// coordinate (h, d) on the given pier side
+void Mount::domeAzimuth(Coordinate *coord, double *azimuth, double *altitude) {
+  double sinLat = site.locationEx.latitude.sine;
+  double cosLat = site.locationEx.latitude.cosine;
+  double sinHA = sin(coord->h), cosHA = cos(coord->h);
+  double sinDec = sin(coord->d), cosDec = cos(coord->d);
+
+  // optical axis direction east, north, and up
+  double vE = -cosDec*sinHA;
+  double vN = sinDec*cosLat - cosDec*cosHA*sinLat;
+  double vU = sinDec*sinLat + cosDec*cosHA*cosLat;
+
+  // where the optical axis starts relative to the dome center in mm, a GEM's is off to one side of the
+  // polar axis along the Dec axis
+  double e = DOME_PIER_OFFSET_E, n = DOME_PIER_OFFSET_N, u = DOME_PIER_OFFSET_UP;
+  if (transform.mountType == GEM) {
+    double offset = coord->pierSide == PIER_SIDE_EAST ? -DOME_GEM_OFFSET : DOME_GEM_OFFSET;
+    e -= offset*cosHA;
+    n += offset*sinHA*sinLat;
+    u -= offset*sinHA*cosLat;
+  }
+
+  // distance along the optical axis to the dome, if the geometry puts the mount outside the dome
+  // just follow the optical axis
+  double b = e*vE + n*vN + u*vU;
+  double c = e*e + n*n + u*u - (double)DOME_RADIUS*DOME_RADIUS;
+  if (c < 0.0) {
+    double t = -b + sqrt(b*b - c);
+    vE = e + t*vE;
+    vN = n + t*vN;
+    vU = u + t*vU;
+  }
+
+  *azimuth = atan2(vE, vN);
+  if (altitude != NULL) *altitude = atan2(vU, sqrt(vE*vE + vN*vN));
+}
+
+// dome azimuth in degrees for the current position and for the goto destination (the current
+// position if no goto is underway) and the dome azimuth rate in degrees per second while tracking
+void Mount::getDome(float *azimuth, float *azimuthTarget, float *rate) {
+  Coordinate position = getMountPosition(CR_MOUNT_ALL);
+  double z, zAhead;
+  domeAzimuth(&position, &z, NULL);
+
+  // a minute of tracking ahead gives the rate the dome has to turn to follow along
+  *rate = 0.0F;
+  if (isTracking() && !isSlewing()) {
+    position.h += siderealToRad(trackingRate)*SIDEREAL_RATIO*60.0;
+    domeAzimuth(&position, &zAhead, NULL);
+    double dz = zAhead - z;
+    if (dz > Deg180) dz -= Deg360; else if (dz < -Deg180) dz += Deg360;
+    *rate = radToDeg(dz)/60.0;
+  }
+
+  *azimuth = NormalizeAzimuth(radToDeg(z));
+  *azimuthTarget = *azimuth;
+
+  // the final destination is known as soon as the goto is accepted so the dome can head there right away
+  if (goTo.state != GS_NONE) {
+    Coordinate target = goTo.getTargetMount();
+    if (transform.mountType == ALTAZM) transform.horToEqu(&target);
+    double zTarget;
+    domeAzimuth(&target, &zTarget, NULL);
+    *azimuthTarget = NormalizeAzimuth(radToDeg(zTarget));
+  }
+}
+
+#endif
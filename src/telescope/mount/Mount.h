@@ -8,6 +8,7 @@
 
 #include "../../lib/axis/Axis.h"
 #include "../../libApp/commands/ProcessCmds.h"
+#include "../../lib/watchdog/Watchdog.h"
 #include "coordinates/Transform.h"
 #include "home/Home.h"
 
@@ -26,8 +27,13 @@ enum RateCompensation: uint8_t {RC_NONE, RC_REFRACTION, RC_REFRACTION_DUAL, RC_M
 #endif
 
 enum TrackingState: uint8_t    {TS_NONE, TS_SIDEREAL};
+enum BacklashCalStage: uint8_t {BCS_NONE, BCS_CLIENT, BCS_TAKEUP, BCS_REVERSE, BCS_FORWARD, BCS_RETURN, BCS_DONE, BCS_FAILED};
 enum CoordReturn: uint8_t      {CR_MOUNT, CR_MOUNT_EQU, CR_MOUNT_ALT, CR_MOUNT_HOR, CR_MOUNT_ALL};
 
+// samples in the zenith keyhole azimuth plan, and the longest time between them in seconds
+#define KEYHOLE_SAMPLES 128
+#define KEYHOLE_SAMPLE_MAX 20.0F
+
 #pragma pack(1)
 #define MountSettingsSize 9
 typedef struct Backlash {
@@ -38,8 +44,32 @@ typedef struct MountSettings {
   RateCompensation rc;
   Backlash backlash;
 } MountSettings;
+
+#define MountJournalEntrySize 27
+typedef struct MountJournalEntry {
+  uint32_t sequence;
+  int32_t axis1Motor;      // motor and instrument coordinate in steps
+  int32_t axis1Instrument;
+  int32_t axis2Motor;
+  int32_t axis2Instrument;
+  float trackingRate;      // in sidereal units, 0 if not tracking
+  uint8_t valid;           // false while slewing, parking, or parked where the position isn't resumed from
+  uint16_t crc;            // of the rest, seeded with the axes steps per measure
+} MountJournalEntry;
 #pragma pack()
 
+typedef struct BacklashCal {
+  BacklashCalStage stage;
+  uint8_t axisNumber;
+  uint8_t handle;
+  uint8_t settle;
+  float saved;             // backlash in radians before the calibration started
+  long start;              // target steps at the start
+  long travel;             // steps moved for each reversal
+  long encoder;            // encoder position in motor steps at the last stop
+  long sum;                // backlash steps summed over the reversals
+} BacklashCal;
+
 extern Axis axis1;
 extern Axis axis2;
 
@@ -48,6 +78,11 @@ class Mount {
     void init();
     void begin();
 
+    // start calibrating the axis drivers, true if they must be left at standstill for MOTOR_CALIBRATE_DRIVER_MS
+    bool calibrateDriversStart();
+    // finish calibrating the axis drivers, call before begin()
+    void calibrateDriversFinish();
+
     bool command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
 
     // get current equatorial position (Native coordinate system)
@@ -88,11 +123,52 @@ class Mount {
     bool syncFromOnStepToEncoders = false;
 
     // updates the tracking rates, etc. as appropriate for the mount state
-    // called once a second by poll() but available here for immediate action
+    // called periodically by poll() but available here for immediate action
     void update();
 
     void poll();
 
+    // start measuring the backlash of axis 1 or 2, with an encoder on the axis the mount does this itself by
+    // moving across two reversals, otherwise backlash compensation on the axis is held off while the client
+    // measures the guide reversal dead time (with a guide camera) and stores it with :$B[R|D]n#
+    CommandError backlashCalibrate(int axisNumber);
+
+    // end any backlash calibration, unless keep is true the backlash set before it started is restored
+    void backlashCalibrateEnd(bool keep);
+
+    // progress of any backlash calibration
+    inline BacklashCalStage backlashCalibrateStage() { return backlashCal.stage; }
+
+    // moves the axis through the backlash calibration
+    void backlashCalibratePoll();
+
+    // axis 1 or 2 encoder position in motor steps, false if the axis has no encoder or it isn't reading
+    bool encoderSteps(int axisNumber, long *steps);
+
+    #if MOUNT_JOURNAL != OFF
+      // resume from the position journal if the power was lost while unparked, then start journaling
+      void journalInit();
+
+      // write the axis positions to the next journal entry, if they changed
+      void journalPoll();
+    #endif
+
+    #if DOME_SLAVING == ON
+      // dome azimuth and altitude in radians where the optical axis meets the dome, for a Mount
+      // coordinate (h, d) on the given pier side
+      void domeAzimuth(Coordinate *coord, double *azimuth, double *altitude = NULL);
+
+      // dome azimuth in degrees for the current position and for the goto destination (the current
+      // position if no goto is underway) and the dome azimuth rate in degrees per second while tracking
+      void getDome(float *azimuth, float *azimuthTarget, float *rate);
+    #endif
+
+    #ifdef MOUNT_BENCHMARK
+      // times the coordinate pipeline function or axis monitor n (see :GXB[n]#)
+      // returns false if unknown otherwise the time per call in microseconds and the (estimated) processor cycles per call
+      bool benchmark(char n, float *us, float *cycles);
+    #endif
+
     float trackingRate = 1.0F;            // in sidereal units 1x = 15 arc-seconds/sidereal second
     float trackingRateAxis1 = 0.0F;       // in sidereal units 1x = 15 arc-seconds/sidereal second
     float trackingRateAxis2 = 0.0F;       // in sidereal units 1x = 15 arc-seconds/sidereal second
@@ -105,6 +181,40 @@ class Mount {
     // alternate tracking rate calculation method
     float ztr(float a);
 
+    // sets and saves the backlash of the axis being calibrated, in radians
+    void backlashCalibrateStore(float value);
+
+    BacklashCal backlashCal = {BCS_NONE, 0, 0, 0, 0.0F, 0, 0, 0, 0};
+
+    #if MOUNT_JOURNAL != OFF
+      // crc of a journal entry, a change to the axes steps per measure leaves the entries invalid
+      uint16_t journalCrc(MountJournalEntry *entry);
+
+      MountJournalEntry journal = {0, 0, 0, 0, 0, 0.0F, false, 0};  // the newest entry
+      uint8_t journalSlot = 0;
+      bool journalResumeTracking = false;
+    #endif
+
+    #if TRACK_KEYHOLE == ON
+      // plans the azimuth flip of a pass near the zenith that's coming up, for the topocentric position and
+      // hour angle rate (in sidereal units) being tracked, within the TRACK_KEYHOLE_RATE/ACCEL limits
+      void keyholePlan(Coordinate *topocentric, float rateH);
+
+      // the Axis1 rate (in sidereal units) to follow the plan, false once past the end of it
+      bool keyholeRate(float *rate);
+
+      // drops any plan and goes back to the usual tracking update rate
+      void keyholeEnd();
+
+      float keyholePath[KEYHOLE_SAMPLES];   // planned azimuth at each sample, relative to keyholeAzimuth
+      double keyholeAzimuth = 0.0;          // mount azimuth at the start of the plan
+      float keyholeStep = 0.0F;             // seconds between samples
+      unsigned long keyholeStartMs = 0;
+      bool keyholeActive = false;
+    #endif
+
+    uint8_t trackingHandle = 0;
+
     // update where we are pointing *now*
     // CR_MOUNT for Horizon or Equatorial mount coordinates, depending on mount
     // CR_MOUNT_EQU for Equatorial mount coordinates, depending on mode
@@ -118,23 +228,87 @@ class Mount {
     Coordinate current;
 
     TrackingState trackingState = TS_NONE;
+
+    #ifdef WATCHDOG_PRESENT
+      uint8_t heartbeatHandle = 0;
+    #endif
 };
 
 #ifdef AXIS1_STEP_DIR_PRESENT
   extern StepDirMotor motor1;
+  #if AXIS1_ENCODER == AB
+    extern Quadrature encAxis1;
+  #elif AXIS1_ENCODER == AB_ESP32
+    extern QuadratureEsp32 encAxis1;
+  #elif AXIS1_ENCODER == AB_STM32
+    extern QuadratureStm32 encAxis1;
+  #elif AXIS1_ENCODER == AB_TEENSY4
+    extern QuadratureTeensy4 encAxis1;
+  #elif AXIS1_ENCODER == CW_CCW
+    extern CwCcw encAxis1;
+  #elif AXIS1_ENCODER == PULSE_DIR
+    extern PulseDir encAxis1;
+  #elif AXIS1_ENCODER == AS37_H39B_B
+    extern As37h39bb encAxis1;
+  #elif AXIS1_ENCODER == SERIAL_BRIDGE
+    extern SerialBridge encAxis1;
+  #endif
 #elif defined(AXIS1_SERVO_PRESENT)
   extern ServoMotor motor1;
+  #if AXIS1_MOTOR_ENCODER != OFF
+    #if AXIS1_MOTOR_ENCODER == AB_ESP32
+      extern QuadratureEsp32 encMotorAxis1;
+    #elif AXIS1_MOTOR_ENCODER == AB_STM32
+      extern QuadratureStm32 encMotorAxis1;
+    #elif AXIS1_MOTOR_ENCODER == AB_TEENSY4
+      extern QuadratureTeensy4 encMotorAxis1;
+    #endif
+    extern Pid pidVelocityAxis1;
+    extern ServoControl servoVelocityControlAxis1;
+  #endif
 #elif defined(AXIS1_ODRIVE_PRESENT)
   extern ODriveMotor motor1;
+#elif defined(AXIS1_TMC_RAMP_PRESENT)
+  extern TmcRampMotor motor1;
 #endif
 extern Axis axis1;
 
 #ifdef AXIS2_STEP_DIR_PRESENT
   extern StepDirMotor motor2;
+  #if AXIS2_ENCODER == AB
+    extern Quadrature encAxis2;
+  #elif AXIS2_ENCODER == AB_ESP32
+    extern QuadratureEsp32 encAxis2;
+  #elif AXIS2_ENCODER == AB_STM32
+    extern QuadratureStm32 encAxis2;
+  #elif AXIS2_ENCODER == AB_TEENSY4
+    extern QuadratureTeensy4 encAxis2;
+  #elif AXIS2_ENCODER == CW_CCW
+    extern CwCcw encAxis2;
+  #elif AXIS2_ENCODER == PULSE_DIR
+    extern PulseDir encAxis2;
+  #elif AXIS2_ENCODER == AS37_H39B_B
+    extern As37h39bb encAxis2;
+  #elif AXIS2_ENCODER == SERIAL_BRIDGE
+    extern SerialBridge encAxis2;
+  #endif
 #elif defined(AXIS2_SERVO_PRESENT)
   extern ServoMotor motor2;
+  #if AXIS2_MOTOR_ENCODER != OFF
+    #if AXIS2_MOTOR_ENCODER == AB_ESP32
+      extern QuadratureEsp32 encMotorAxis2;
+    #elif AXIS2_MOTOR_ENCODER == AB_STM32
+      extern QuadratureStm32 encMotorAxis2;
+    #elif AXIS2_MOTOR_ENCODER == AB_TEENSY4
+      extern QuadratureTeensy4 encMotorAxis2;
+    #endif
+    extern Pid pidVelocityAxis2;
+    extern ServoControl servoVelocityControlAxis2;
+  #endif
 #elif defined(AXIS2_ODRIVE_PRESENT)
   extern ODriveMotor motor2;
+#elif defined(AXIS2_TMC_RAMP_PRESENT)
+  extern TmcRampMotor motor2;
 #endif
 extern Axis axis2;
 
@@ -0,0 +1,83 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount control, position journal in FRAM to resume after a power loss
+
+#include "Mount.h"
+
+#if defined(MOUNT_PRESENT) && MOUNT_JOURNAL != OFF
+
+#include "../../lib/tasks/OnTask.h"
+
+#include "goto/Goto.h"
+#include "limits/Limits.h"
+#include "park/Park.h"
+
+// entries in the ring, the newest with a good crc is used so a write cut short by the power going loses only that entry
+#define JOURNAL_SLOTS 8
+
+void mountJournalWrapper() { mount.journalPoll(); }
+
+void Mount::journalInit() {
+  if (MountJournalEntrySize < sizeof(MountJournalEntry)) { nv.initError = true; DL("ERR: Mount::journalInit(), MountJournalEntrySize error"); }
+
+  bool found = false;
+  if (nv.hasValidKey()) {
+    for (uint8_t i = 0; i < JOURNAL_SLOTS; i++) {
+      MountJournalEntry entry;
+      nv.readBytes(NV_MOUNT_JOURNAL_BASE + i*MountJournalEntrySize, &entry, sizeof(MountJournalEntry));
+      if (entry.crc != journalCrc(&entry)) continue;
+      if (found && (int32_t)(entry.sequence - journal.sequence) <= 0) continue;
+      journal = entry;
+      journalSlot = i;
+      found = true;
+    }
+  }
+
+  // once parked the park position is restored instead, and absolute encoders know where the axes are already
+  if (!found) { VLF("MSG: Mount, position journal empty"); } else
+  if (!journal.valid || park.state != PS_UNPARKED || goTo.absoluteEncodersPresent) { VLF("MSG: Mount, position journal not resumed from"); } else {
+    axis1.resetPositionSteps(journal.axis1Motor);
+    axis1.setInstrumentCoordinateSteps(journal.axis1Instrument);
+    axis2.resetPositionSteps(journal.axis2Motor);
+    axis2.setInstrumentCoordinateSteps(journal.axis2Instrument);
+
+    limits.enabled(true);
+    syncFromOnStepToEncoders = true;
+    journalResumeTracking = journal.trackingRate != 0.0F;
+
+    VF("MSG: Mount, position journal resumed axis1 motor at "); V(journal.axis1Motor);
+    VF(" axis2 motor at "); V(journal.axis2Motor); VLF(" steps");
+  }
+
+  VF("MSG: Mount, start position journal task (rate "); V(1000/MOUNT_JOURNAL); VF("ms priority 7)... ");
+  if (tasks.add(1000/MOUNT_JOURNAL, 0, true, 7, mountJournalWrapper, "MntJrnl")) { VLF("success"); } else { VLF("FAILED!"); }
+}
+
+void Mount::journalPoll() {
+  MountJournalEntry entry;
+  entry.sequence = journal.sequence;
+  entry.axis1Motor = axis1.getMotorPositionSteps();
+  entry.axis1Instrument = axis1.getInstrumentCoordinateSteps();
+  entry.axis2Motor = axis2.getMotorPositionSteps();
+  entry.axis2Instrument = axis2.getInstrumentCoordinateSteps();
+  entry.trackingRate = isTracking() ? trackingRate : 0.0F;
+
+  // steps can be lost during a slew cut short by the power going, so those positions aren't resumed from
+  entry.valid = park.state == PS_UNPARKED && !isSlewing() && !motorFault();
+
+  // while parked or stopped nothing changes, no need to write
+  if (memcmp(&entry, &journal, sizeof(MountJournalEntry) - sizeof(uint16_t)) == 0) return;
+
+  entry.sequence++;
+  entry.crc = journalCrc(&entry);
+  if (++journalSlot >= JOURNAL_SLOTS) journalSlot = 0;
+  nv.updateBytes(NV_MOUNT_JOURNAL_BASE + journalSlot*MountJournalEntrySize, &entry, sizeof(MountJournalEntry));
+  journal = entry;
+}
+
+uint16_t Mount::journalCrc(MountJournalEntry *entry) {
+  float stepsPerMeasure[2] = { (float)axis1.getStepsPerMeasure(), (float)axis2.getStepsPerMeasure() };
+  uint16_t crc = nv.crc16(0xFFFF, (const uint8_t*)stepsPerMeasure, sizeof(stepsPerMeasure));
+  return nv.crc16(crc, (const uint8_t*)entry, sizeof(MountJournalEntry) - sizeof(uint16_t));
+}
+
+#endif
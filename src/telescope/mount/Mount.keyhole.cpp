@@ -0,0 +1,107 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount control, zenith keyhole azimuth planning for alt-az tracking
+
+#include "Mount.h"
+
+#if defined(MOUNT_PRESENT) && TRACK_KEYHOLE == ON
+
+#include "../../lib/tasks/OnTask.h"
+
+#include "coordinates/Transform.h"
+#include "site/Site.h"
+
+// plan passes that come within this zenith distance, starting once this close to transit (in seconds)
+#define KEYHOLE_ZENITH_DISTANCE degToRad(5.0)
+#define KEYHOLE_LEAD ((KEYHOLE_SAMPLES - 1)*KEYHOLE_SAMPLE_MAX/2.0F)
+
+// tracking update period in ms while following a plan
+#define KEYHOLE_PERIOD 100
+
+// time constant in seconds to take out any difference between the plan and where Axis1 is
+#define KEYHOLE_CORRECTION_TIME 10.0F
+
+void Mount::keyholePlan(Coordinate *topocentric, float rateH) {
+  if (current.a < degToRad(80.0) || rateH <= 0.0F) return;
+  if (fabs(site.location.latitude - topocentric->d) > KEYHOLE_ZENITH_DISTANCE) return;
+
+  // seconds until transit, the plan is symmetric about it
+  double radsPerSecond = siderealToRad(rateH)*SIDEREAL_RATIO;
+  double h = topocentric->h;
+  if (h > Deg180) h -= Deg360; else if (h < -Deg180) h += Deg360;
+  float transit = -h/radsPerSecond;
+  if (transit < KEYHOLE_SAMPLE_MAX*2.0F || transit > KEYHOLE_LEAD) return;
+
+  keyholeStep = transit*2.0F/(KEYHOLE_SAMPLES - 1);
+
+  // the mount azimuth the object follows, unwrapped so it's continuous through the flip
+  float target[KEYHOLE_SAMPLES];
+  double last = current.z;
+  keyholeAzimuth = current.z;
+  for (int i = 0; i < KEYHOLE_SAMPLES; i++) {
+    Coordinate sample = *topocentric;
+    sample.h = h + radsPerSecond*keyholeStep*i;
+    transform.equToHor(&sample);
+    transform.topocentricToMount(&sample); Y;
+    double z = sample.z;
+    while (z - last > Deg180) z -= Deg360;
+    while (z - last < -Deg180) z += Deg360;
+    last = z;
+    target[i] = z - keyholeAzimuth;
+  }
+
+  // the path closest to the object with the rate limit is midway between the narrowest upper and lower bounds
+  // that can't change faster than the limit, it meets the object wherever the object is slow enough to follow
+  float limit = siderealToRadF(TRACK_KEYHOLE_RATE)*SIDEREAL_RATIO_F*keyholeStep;
+  for (int i = 0; i < KEYHOLE_SAMPLES; i++) {
+    float upper = target[i], lower = target[i];
+    for (int j = 0; j < KEYHOLE_SAMPLES; j++) {
+      float d = limit*abs(i - j);
+      if (target[j] + d < upper) upper = target[j] + d;
+      if (target[j] - d > lower) lower = target[j] - d;
+    }
+    keyholePath[i] = (upper + lower)/2.0F;
+  }
+
+  // averaging over the time it takes to reach the rate limit keeps within the acceleration limit
+  int k = lround(((float)TRACK_KEYHOLE_RATE/TRACK_KEYHOLE_ACCEL)/keyholeStep);
+  if (k > 0) {
+    for (int i = 0; i < KEYHOLE_SAMPLES; i++) {
+      float sum = 0.0F;
+      int count = 0;
+      for (int j = i - k; j <= i + k; j++) { if (j >= 0 && j < KEYHOLE_SAMPLES) { sum += keyholePath[j]; count++; } }
+      target[i] = sum/count;
+    }
+    for (int i = 0; i < KEYHOLE_SAMPLES; i++) keyholePath[i] = target[i];
+  }
+
+  keyholeStartMs = millis();
+  keyholeActive = true;
+  if (trackingHandle) tasks.setPeriod(trackingHandle, KEYHOLE_PERIOD);
+
+  VF("MSG: Mount, zenith keyhole planned for the next "); V(transit*2.0F); VLF(" seconds");
+}
+
+bool Mount::keyholeRate(float *rate) {
+  float t = (millis() - keyholeStartMs)/1000.0F;
+  int i = floor(t/keyholeStep);
+  if (i < 0 || i >= KEYHOLE_SAMPLES - 1) { keyholeEnd(); return false; }
+
+  // the planned rate over this segment plus a correction toward the planned position
+  float slope = (keyholePath[i + 1] - keyholePath[i])/keyholeStep;
+  float planned = keyholePath[i] + slope*(t - i*keyholeStep);
+  double z = current.z - keyholeAzimuth;
+  while (z - planned > Deg180) z -= Deg360;
+  while (z - planned < -Deg180) z += Deg360;
+  float radsPerSecond = slope + (planned - z)/KEYHOLE_CORRECTION_TIME;
+
+  *rate = radsPerSecond/(siderealToRadF(1.0F)*SIDEREAL_RATIO_F);
+  return true;
+}
+
+void Mount::keyholeEnd() {
+  keyholeActive = false;
+  if (trackingHandle) tasks.setPeriod(trackingHandle, TRACK_COMPENSATION_PERIOD);
+  VLF("MSG: Mount, zenith keyhole done");
+}
+
+#endif
@@ -0,0 +1,59 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount position capture commands
+
+#include "Capture.h"
+
+#if defined(MOUNT_PRESENT) && MOUNT_CAPTURE != OFF
+
+#include "../../../lib/convert/Convert.h"
+
+bool MountCapture::command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError) {
+  *supressFrame = false;
+
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'M') {
+    // :GXM#      Get the range of captures held, the oldest and the next (one past the newest) sequence numbers
+    //            Returns: n,n#
+    if (parameter[1] == 0) {
+      sprintf(reply, "%lu,%lu", (unsigned long)first(), (unsigned long)next());
+      *numericReply = false;
+    } else
+
+    // :GXM[n]#   Get capture with sequence number n
+    //            Returns: s,t,u,p,L,R,D,e# where s is P (pin) or C (command), t the tag, u the micros() count,
+    //            p the microseconds after the last PPS edge (-1 if not synced), L the LAST in hours, R the RA in hours,
+    //            D the Dec in degrees, and e the pier side (E, W, or N)
+    {
+      char *conv_end;
+      unsigned long sequence = strtoul(&parameter[1], &conv_end, 10);
+      if (conv_end == &parameter[1] || *conv_end != 0) { *commandError = CE_PARAM_FORM; return true; }
+      CaptureRecord record;
+      if (!get(sequence, &record)) { *commandError = CE_PARAM_RANGE; return true; }
+
+      Coordinate coord = position(&record);
+      double last = fmod(record.fs/(FRACTIONAL_SEC*3600.0), 24.0);
+      if (last < 0.0) last += 24.0;
+      char l[16], r[16], d[16];
+      sprintF(l, "%1.6f", last);
+      sprintF(r, "%1.6f", radToHrs(coord.r));
+      sprintF(d, "%1.5f", radToDeg(coord.d));
+      char pierSide = coord.pierSide == PIER_SIDE_EAST ? 'E' : coord.pierSide == PIER_SIDE_WEST ? 'W' : 'N';
+      sprintf(reply, "%c,%u,%lu,%ld,%s,%s,%s,%c", record.source, (unsigned int)record.tag, (unsigned long)record.micros,
+                     (long)record.ppsMicros, l, r, d, pierSide);
+      *numericReply = false;
+    }
+  } else
+
+  // :SXMC,[n]# Capture the mount position now, n is a tag (0 to 255) kept with it, for example 1 exposure start and 0 end
+  //            Return: 0 on failure (queue full or bad tag)
+  //                    1 on success
+  if (command[0] == 'S' && command[1] == 'X' && parameter[0] == 'M' && parameter[1] == 'C' && parameter[2] == ',') {
+    char *conv_end;
+    long tag = strtol(&parameter[3], &conv_end, 10);
+    if (conv_end == &parameter[3] || *conv_end != 0 || tag < 0 || tag > 255) { *commandError = CE_PARAM_RANGE; return true; }
+    if (!trigger(tag)) *commandError = CE_0;
+  } else return false;
+
+  return true;
+}
+
+#endif
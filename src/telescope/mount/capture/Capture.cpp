@@ -0,0 +1,105 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount position capture, for marking exposure start and end
+
+#include "Capture.h"
+
+#if defined(MOUNT_PRESENT) && MOUNT_CAPTURE != OFF
+
+#include "../../../lib/tasks/OnTask.h"
+#include "../../../lib/tls/PPS.h"
+
+#include "../Mount.h"
+#include "../site/Site.h"
+
+#if MOUNT_CAPTURE_PIN != OFF
+  IRAM_ATTR void captureIsr() { mountCapture.latch(CS_PIN, digitalRead(MOUNT_CAPTURE_PIN) == HIGH); }
+#endif
+
+void captureWrapper() { mountCapture.poll(); }
+
+void MountCapture::init() {
+  #if MOUNT_CAPTURE_PIN != OFF
+    VLF("MSG: Mount, capture attaching ISR to sense input");
+    pinMode(MOUNT_CAPTURE_PIN, MOUNT_CAPTURE_INIT);
+    #if MOUNT_CAPTURE_SENSE == HIGH
+      attachInterrupt(digitalPinToInterrupt(MOUNT_CAPTURE_PIN), captureIsr, RISING);
+    #elif MOUNT_CAPTURE_SENSE == LOW
+      attachInterrupt(digitalPinToInterrupt(MOUNT_CAPTURE_PIN), captureIsr, FALLING);
+    #elif MOUNT_CAPTURE_SENSE == BOTH
+      attachInterrupt(digitalPinToInterrupt(MOUNT_CAPTURE_PIN), captureIsr, CHANGE);
+    #endif
+  #endif
+
+  VF("MSG: Mount, start capture task (rate 100ms priority 7)... ");
+  if (tasks.add(100, 0, true, 7, captureWrapper, "MntCap")) { VLF("success"); } else { VLF("FAILED!"); }
+}
+
+bool MountCapture::trigger(uint8_t tag) {
+  noInterrupts();
+  uint32_t before = count;
+  latch(CS_COMMAND, tag);
+  bool latched = count != before;
+  interrupts();
+  return latched;
+}
+
+IRAM_ATTR void MountCapture::latch(char source, uint8_t tag) {
+  unsigned long now = micros();
+
+  // a slot isn't reused until its LAST has been filled in
+  if (count - ready >= MOUNT_CAPTURE) { dropped++; return; }
+
+  CaptureRecord *record = &records[count % MOUNT_CAPTURE];
+  record->micros = now;
+  #if TIME_LOCATION_PPS_SENSE != OFF
+    record->ppsMicros = pps.synced ? (long)(now - pps.lastMicros) : -1;
+  #else
+    record->ppsMicros = -1;
+  #endif
+  record->stepsAxis1 = axis1.getInstrumentCoordinateStepsISR();
+  record->stepsAxis2 = axis2.getInstrumentCoordinateStepsISR();
+  record->source = source;
+  record->tag = tag;
+  count++;
+}
+
+void MountCapture::poll() {
+  while (ready != count) {
+    CaptureRecord *record = &records[ready % MOUNT_CAPTURE];
+
+    // LAST now, timed at the middle of the read, then back to when the capture was latched
+    unsigned long t0 = micros();
+    double fs = getFracLASTExact();
+    unsigned long t1 = micros();
+    unsigned long now = t0 + (t1 - t0)/2;
+    record->fs = fs - (double)(long)(now - record->micros)*(FRACTIONAL_SEC*SIDEREAL_RATIO/1000000.0);
+
+    noInterrupts();
+    ready++;
+    interrupts();
+  }
+}
+
+bool MountCapture::get(uint32_t sequence, CaptureRecord *record) {
+  noInterrupts();
+  bool available = sequence >= first() && sequence < ready;
+  if (available) *record = records[sequence % MOUNT_CAPTURE];
+  interrupts();
+  return available;
+}
+
+Coordinate MountCapture::position(CaptureRecord *record) {
+  Coordinate coord = transform.instrumentToMount(axis1.stepsToInstrumentCoordinate(record->stepsAxis1),
+                                                 axis2.stepsToInstrumentCoordinate(record->stepsAxis2));
+  Coordinate native = transform.mountToNative(&coord, false);
+
+  // the hour angle goes with the capture time so RA comes from LAST then, not now
+  native.r = hrsToRad(record->fs/(FRACTIONAL_SEC*3600.0)) - native.h;
+  native.r = fmod(native.r, Deg360);
+  if (native.r < 0.0) native.r += Deg360;
+  return native;
+}
+
+MountCapture mountCapture;
+
+#endif
@@ -0,0 +1,65 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount position capture, for marking exposure start and end
+#pragma once
+
+#include "../../../Common.h"
+
+#if defined(MOUNT_PRESENT) && MOUNT_CAPTURE != OFF
+
+#include "../coordinates/Transform.h"
+
+// capture sources
+#define CS_PIN     'P'  // MOUNT_CAPTURE_PIN edge, the tag is the pin state after the edge
+#define CS_COMMAND 'C'  // :SXMC,n# the tag is n
+
+typedef struct CaptureRecord {
+  unsigned long micros;     // micros() when latched
+  long ppsMicros;           // microseconds after the last PPS edge, or -1 if the PPS isn't synced
+  long stepsAxis1;          // instrument coordinates in steps
+  long stepsAxis2;
+  double fs;                // LAST in fracsec when latched
+  char source;
+  uint8_t tag;
+} CaptureRecord;
+
+// captures are latched in the ISR (or with interrupts off for a command) with just the step counts and
+// the time, a task fills in LAST shortly after and only a read converts to RA/Dec, so the mount loop
+// pays nothing for them.  LAST has microsecond resolution with SIDEREAL_CLOCK_COUNTER ON, otherwise
+// it's good to one sidereal clock tick
+class MountCapture {
+  public:
+    void init();
+
+    bool command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
+
+    // latch a capture now, false if the queue is full
+    bool trigger(uint8_t tag);
+
+    // called from the pin ISR
+    void latch(char source, uint8_t tag);
+
+    // fills in LAST for the new captures
+    void poll();
+
+    // sequence number of the oldest capture still held
+    inline uint32_t first() { uint32_t n = count; return n > MOUNT_CAPTURE ? n - MOUNT_CAPTURE : 0; }
+
+    // sequence number the next ready capture will get
+    inline uint32_t next() { return ready; }
+
+    // copies out the capture with this sequence number, false if it's gone or isn't ready yet
+    bool get(uint32_t sequence, CaptureRecord *record);
+
+    // the native (equatorial) coordinate the mount was at for a capture
+    Coordinate position(CaptureRecord *record);
+
+  private:
+    CaptureRecord records[MOUNT_CAPTURE];
+    volatile uint32_t count = 0;  // captures latched
+    volatile uint32_t ready = 0;  // captures with LAST filled in
+    volatile uint32_t dropped = 0;
+};
+
+extern MountCapture mountCapture;
+
+#endif
@@ -18,7 +18,7 @@
 #if ALIGN_MAX_NUM_STARS > 1
 
 uint8_t modelNumberStars = 0;
-void autoModelWrapper() { transform.align.autoModel(modelNumberStars); }
+void fitPollWrapper() { transform.align.fitPoll(); }
 
 void GeoAlign::init(int8_t mountType, float latitude) {
   modelClear();
@@ -74,8 +74,48 @@ CommandError GeoAlign::addStar(int thisStar, int numberStars, Coordinate *actual
   // just return if we are processing a model or the star count is out of range, this should never happen
   if (autoModelTask != 0 || thisStar < 1 || thisStar > ALIGN_MAX_NUM_STARS || numberStars < 1 || numberStars > ALIGN_MAX_NUM_STARS) return CE_ALIGN_FAIL;
 
-  int i = thisStar - 1;
+  setSample(thisStar - 1, actual, mount);
 
+  // two or more stars and finished
+  if (thisStar >= 2 && thisStar == numberStars) {
+    createModel(numberStars);
+  }
+
+  return CE_NONE;
+}
+
+CommandError GeoAlign::refineStar(Coordinate *actual, Coordinate *mount) {
+  #if ALIGN_LEAST_SQUARES == ON
+    // only a model fit from samples taken this session can be refined
+    if (autoModelTask != 0 || !modelIsReady || modelNumberStars < 2) return CE_ALIGN_FAIL;
+
+    // add the sample, once full it replaces the sample closest to it so sky coverage is kept
+    int i = modelNumberStars;
+    if (i >= ALIGN_MAX_NUM_STARS) {
+      float closest = 0.0F;
+      for (int j = 0; j < ALIGN_MAX_NUM_STARS; j++) {
+        float dh = this->mount[j].h - mount->h;
+        if (dh >  Deg180) dh -= Deg360; else if (dh < -Deg180) dh += Deg360;
+        float dist = sq(dh*cosf(mount->d)) + sq(this->mount[j].d - mount->d);
+        if (j == 0 || dist < closest) { closest = dist; i = j; }
+      }
+    } else modelNumberStars++;
+    setSample(i, actual, mount);
+
+    // start a task to refine the model, the current model stays in use until it is done
+    refineModelBegin();
+    if (!fitStart("AlignR")) return CE_ALIGN_FAIL;
+
+    VF("MSG: Align, refining model with sample "); VL(i + 1);
+    return CE_NONE;
+  #else
+    UNUSED(actual);
+    UNUSED(mount);
+    return CE_ALIGN_FAIL;
+  #endif
+}
+
+void GeoAlign::setSample(int i, Coordinate *actual, Coordinate *mount) {
   this->mount[i].h = mount->h;
   this->mount[i].d = mount->d;
   this->actual[i].h = actual->h;
@@ -104,13 +144,6 @@ CommandError GeoAlign::addStar(int thisStar, int numberStars, Coordinate *actual
     this->actual[i].side = 1;
     this->mount[i].side = 1;
   }
-
-  // two or more stars and finished
-  if (thisStar >= 2 && thisStar == numberStars) {
-    createModel(numberStars);
-  }
-
-  return CE_NONE;
 }
 
 void GeoAlign::createModel(int numberStars) {
@@ -118,7 +151,8 @@ void GeoAlign::createModel(int numberStars) {
 
   // start a task to solve for the model
   modelNumberStars = numberStars;
-  autoModelTask = tasks.add(1, 0, false, 6, autoModelWrapper, "Align");
+  autoModelBegin(numberStars);
+  fitStart("Align");
 }
 
 // returns the correction to be added to the requested RA,Dec to yield the actual RA,Dec that we will arrive at
@@ -178,127 +212,367 @@ void GeoAlign::correct(AlignCoordinate &mount, float sf, float _deo, float _pd,
   *a2r  = (+PZ*mount.sinA1             + PA*mount.cosA1             + DFd + FFd + TFd);
 }
 
-void GeoAlign::doSearch(float sf, int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9) {
-  long l,
+void GeoAlign::searchAdd(float sf, int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9) {
+  if (search.passes >= ALIGN_SEARCH_PASSES) return;
+  AlignSearchPass &pass = search.pass[search.passes++];
+  pass.sf = sf;
+  pass.p[0] = p1; pass.p[1] = p2; pass.p[2] = p3; pass.p[3] = p4; pass.p[4] = p5;
+  pass.p[5] = p6; pass.p[6] = p7; pass.p[7] = p8; pass.p[8] = p9;
+
+  // combinations the pass checks, for the progress estimate
+  unsigned long combinations = 1;
+  for (int k = 0; k < 9; k++) combinations *= pass.p[k]*2 + 1;
+  search.total += combinations;
+}
 
-  _deo_m,_deo_p,
-  _pd_m,_pd_p,
-  _pz_m,_pz_p,
-  _pe_m,_pe_p,
-  _df_m,_df_p,
-  _tf_m,_tf_p,
-  _ff_m,_ff_p,
-  _oh_m,_oh_p,
-  _od_m,_od_p,
-  
-  _deo,_pd,_pz,_pe, _df,_tf,_ff, _ode,_ohe;
+void GeoAlign::searchBegin() {
+  fitStage = AFS_SEARCH;
+  fitStageMs = millis();
+  search.thisPass = 0;
+  search.done = 0;
+  searchPass();
+}
+
+void GeoAlign::searchPass() {
+  AlignSearchPass &pass = search.pass[search.thisPass];
+
+  // set parameter space, odometer order
+  const float best[9] = {best_ohe, best_ode, best_deo, best_pd, best_pz, best_pe, best_df, best_ff, best_tf};
+  const uint8_t width[9] = {pass.p[8], pass.p[7], pass.p[0], pass.p[1], pass.p[2], pass.p[3], pass.p[6], pass.p[5], pass.p[4]};
+  for (int k = 0; k < 9; k++) {
+    long center = round(best[k]/pass.sf);
+    search.lo[k] = center - width[k];
+    search.hi[k] = center + width[k];
+    search.at[k] = search.lo[k];
+  }
+  search.offsetsReady = false;
+}
 
+AlignFitResult GeoAlign::searchStep() {
+  AlignSearchPass &pass = search.pass[search.thisPass];
+  float sf = pass.sf;
   float sf1 = arcsecToRad(sf);
 
-  // search
-  // set Parameter Space
-  _deo_m= -p1 + round(best_deo/sf); _deo_p= p1 + round(best_deo/sf);
-  _pd_m = -p2 + round(best_pd/sf);  _pd_p = p2 + round(best_pd/sf);
-  _pz_m = -p3 + round(best_pz/sf);  _pz_p = p3 + round(best_pz/sf);
-  _pe_m = -p4 + round(best_pe/sf);  _pe_p = p4 + round(best_pe/sf);
-  _tf_m = -p5 + round(best_tf/sf);  _tf_p = p5 + round(best_tf/sf);
-  _ff_m = -p6 + round(best_ff/sf);  _ff_p = p6 + round(best_ff/sf);
-  _df_m = -p7 + round(best_df/sf);  _df_p = p7 + round(best_df/sf);
-  _od_m = -p8 + round(best_ode/sf); _od_p = p8 + round(best_ode/sf);
-  _oh_m = -p9 + round(best_ohe/sf); _oh_p = p9 + round(best_ohe/sf);
-
-  float ma2, ma1;
-  for (_ohe = _oh_m; _ohe <= _oh_p; _ohe++)
-  for (_ode = _od_m; _ode <= _od_p; _ode++) {
-    ode = _ode*sf1;
+  // everything that depends only on the sample and index offsets is found once for each oh, od
+  if (!search.offsetsReady) {
+    ode = search.at[1]*sf1;
     odw = -ode;
-    ohe = _ohe*sf1;
+    ohe = search.at[0]*sf1;
     ohw = ohe;
 
     for (l = 0; l < num; l++) {
-      ma1 = mount[l].ax1;
-      ma2 = mount[l].ax2;
-      
-      if (mount[l].side == -1) // west of the mount
-      {
-        ma1 = ma1 + ohw;
-        ma2 = ma2 + odw;
-      } else
-      if (mount[l].side == 1) // east of the mount, default (fork mounts)
-      {
-        ma1 = ma1 + ohe;
-        ma2 = ma2 + ode;
-      }
+      prepare(mount[l], ohe, ode);
+      termCorrections(l, sf1);
+      base1[l] = actual[l].ax1 - mount[l].ma1;
+      base2[l] = actual[l].ax2 - mount[l].ma2;
+    }
+    search.offsetsReady = true;
+  }
+
+  const float t0 = search.at[2], t1 = search.at[3], t2 = search.at[4], t3 = search.at[5], t4 = search.at[6], t5 = search.at[7], t6 = search.at[8];
+
+  // check the combination for all samples, the corrections are a weighted sum of the per term corrections
+  float sum2 = 0.0F;
+  sum1 = 0.0F;
+  for (l = 0; l < num; l++) {
+    float ma1r = t0*corr1[0][l] + t1*corr1[1][l] + t2*corr1[2][l] + t3*corr1[3][l] + t4*corr1[4][l] + t5*corr1[5][l] + t6*corr1[6][l];
+    float ma2r = t0*corr2[0][l] + t1*corr2[1][l] + t2*corr2[2][l] + t3*corr2[3][l] + t4*corr2[4][l] + t5*corr2[5][l] + t6*corr2[6][l];
+
+    float d1 = base1[l] + ma1r;
+    if (d1 >  Deg180) d1 = d1 - Deg360; else
+    if (d1 < -Deg180) d1 = d1 + Deg360;
+    float d2 = base2[l] + ma2r;
+
+    sum1 = sum1 + sq(d1*weight[l]);
+    sum2 = sum2 + sq(d2);
+  }
+
+  // calculate the standard deviations
+  float a, b;
+  a = sum1/(num - 1); // was sqrt(sum1/(num - 1))
+  b = sum2/(num - 1); // was sqrt(sum1/(num - 1))
+
+  max_dist = sqrtf(a + b); // was sq(a) + sq(b)
+
+  // remember the best fit
+  if (max_dist < best_dist) {
+    best_dist = max_dist;
+    best_deo  = t0*sf;
+    best_pd   = t1*sf;
+    best_pz   = t2*sf;
+    best_pe   = t3*sf;
+
+    best_tf   = t6*sf;
+    best_df   = t4*sf;
+    best_ff   = t5*sf;
+
+    if (pass.p[7] != 0) best_odw = radToArcsec(odw); else best_odw = best_pe/2.0;
+    if (pass.p[7] != 0) best_ode = radToArcsec(ode); else best_ode = -best_pe/2.0;
+    if (pass.p[8] != 0) best_ohw = radToArcsec(ohw);
+    if (pass.p[8] != 0) best_ohe = radToArcsec(ohe);
+  }
+  search.done++;
+
+  // advance the odometer, tf fastest, once oh or od move the working set must be found again
+  int k = 8;
+  while (k >= 0 && ++search.at[k] > search.hi[k]) { search.at[k] = search.lo[k]; k--; }
+  if (k <= 1) search.offsetsReady = false;
+  if (k < 0) {
+    if (++search.thisPass >= search.passes) return AFR_SOLVED;
+    searchPass();
+  }
+
+  return AFR_BUSY;
+}
 
-      mount[l].ma1 = ma1;
-      mount[l].ma2 = ma2;
-      mount[l].sinA1 = sinf(ma1);
-      mount[l].cosA1 = cosf(ma1);
-      mount[l].sinA2 = sinf(ma2);
-      mount[l].cosA2 = cosf(ma2);
-      mount[l].tanA2 = mount[l].sinA2/mount[l].cosA2;
+void GeoAlign::prepare(AlignCoordinate &mount, float ohe, float ode) {
+  float ma1 = mount.ax1;
+  float ma2 = mount.ax2;
+
+  if (mount.side == -1) // west of the mount
+  {
+    ma1 = ma1 + ohe;
+    ma2 = ma2 - ode;
+  } else
+  if (mount.side == 1) // east of the mount, default (fork mounts)
+  {
+    ma1 = ma1 + ohe;
+    ma2 = ma2 + ode;
+  }
+
+  mount.ma1 = ma1;
+  mount.ma2 = ma2;
+  mount.sinA1 = sinf(ma1);
+  mount.cosA1 = cosf(ma1);
+  mount.sinA2 = sinf(ma2);
+  mount.cosA2 = cosf(ma2);
+  mount.tanA2 = mount.sinA2/mount.cosA2;
+}
+
+void GeoAlign::termCorrections(int l, float sf) {
+  for (int k = 0; k < 7; k++) {
+    float e[7] = {0};
+    e[k] = 1.0F;
+    correct(mount[l], sf, e[0], e[1], e[2], e[3], e[4], e[5], e[6], &corr1[k][l], &corr2[k][l]);
+  }
+}
+
+void GeoAlign::sample(int l, AlignCoordinate **mount, AlignCoordinate **actual, float *weight) {
+  #if ALIGN_POINTS_MAX != OFF
+    if (fitPoints) {
+      pointMount.ax1 = points[l].mountAx1;
+      pointMount.ax2 = points[l].mountAx2;
+      pointMount.side = points[l].side;
+      pointActual.ax1 = points[l].actualAx1;
+      pointActual.ax2 = points[l].actualAx2;
+      *mount = &pointMount;
+      *actual = &pointActual;
+      *weight = cosf(pointActual.ax2);
+      return;
     }
+  #endif
+  *mount = &this->mount[l];
+  *actual = &this->actual[l];
+  *weight = this->weight[l];
+}
 
-    for (_deo = _deo_m; _deo <= _deo_p; _deo++)
-    for (_pd = _pd_m; _pd <= _pd_p; _pd++)
-    for (_pz = _pz_m; _pz <= _pz_p; _pz++)
-    for (_pe = _pe_m; _pe <= _pe_p; _pe++)
-    for (_df = _df_m; _df <= _df_p; _df++)
-    for (_ff = _ff_m; _ff <= _ff_p; _ff++)
-    for (_tf = _tf_m; _tf <= _tf_p; _tf++) {
-
-      // check the combinations for all samples
-      for (l = 0; l < num; l++) {
-        float ma1r, ma2r;
-        correct(mount[l], sf1, _deo, _pd, _pz, _pe, _df, _ff, _tf, &ma1r, &ma2r);
-
-        delta[l].ax1 = actual[l].ax1 - (mount[l].ma1 - ma1r);
-        if (delta[l].ax1 >  Deg180) delta[l].ax1 = delta[l].ax1 - Deg360; else
-        if (delta[l].ax1 < -Deg180) delta[l].ax1 = delta[l].ax1 + Deg360;
-        delta[l].ax2 = actual[l].ax2 - (mount[l].ma2 - ma2r);
-        delta[l].side = mount[l].side;
-      }
+void GeoAlign::residual(AlignCoordinate &mount, AlignCoordinate &actual, float weight, const float *x, float *r1, float *r2) {
+  float ma1r, ma2r;
+  prepare(mount, x[8], x[7]);
+  correct(mount, 1.0F, x[0], x[1], x[2], x[3], x[4], x[5], x[6], &ma1r, &ma2r);
 
-      // calculate the standard deviations
-      float a, b;
-
-      sum1 = 0.0;
-      for (l = 0; l < num; l++) sum1 = sum1 + sq(delta[l].ax1*cosf(actual[l].ax2));
-      a = sum1/(num - 1); // was sqrt(sum1/(num - 1))
-
-      sum1 = 0.0;
-      for (l = 0; l < num; l++) sum1 = sum1 + sq(delta[l].ax2);
-      b = sum1/(num - 1); // was sqrt(sum1/(num - 1))
-
-      max_dist = sqrtf(a + b); // was sq(a) + sq(b)
-
-      // remember the best fit
-      if (max_dist < best_dist) {
-        best_dist = max_dist;
-        best_deo  = _deo*sf;
-        best_pd   = _pd*sf;
-        best_pz   = _pz*sf;
-        best_pe   = _pe*sf;
-
-        best_tf   = _tf*sf;
-        best_df   = _df*sf;
-        best_ff   = _ff*sf;
-        
-        if (p8 != 0) best_odw = radToArcsec(odw); else best_odw = best_pe/2.0;
-        if (p8 != 0) best_ode = radToArcsec(ode); else best_ode = -best_pe/2.0;
-        if (p9 != 0) best_ohw = radToArcsec(ohw);
-        if (p9 != 0) best_ohe = radToArcsec(ohe);
-      }
-      
-      Y;
+  float d1 = actual.ax1 - (mount.ma1 - ma1r);
+  if (d1 >  Deg180) d1 = d1 - Deg360; else
+  if (d1 < -Deg180) d1 = d1 + Deg360;
+  *r1 = d1*weight;
+  *r2 = actual.ax2 - (mount.ma2 - ma2r);
+}
+
+float GeoAlign::residualSumSq(const float *x) {
+  float sum = 0.0F;
+  for (int l = 0; l < num; l++) {
+    AlignCoordinate *m, *a;
+    float w, r1, r2;
+    sample(l, &m, &a, &w);
+    residual(*m, *a, w, x, &r1, &r2);
+    sum += sq(r1) + sq(r2);
+  }
+  return sum;
+}
+
+void GeoAlign::leastSquaresBegin(const bool *active) {
+  AlignLeastSquares &s = leastSquares;
+  fitStage = AFS_LEAST_SQUARES;
+  fitStageMs = millis();
+
+  // map the active terms to the rows/columns of the normal equations, none marks a fit that can't be done
+  s.terms = 0;
+  for (int k = 0; k < ALIGN_MODEL_TERMS; k++) if (active[k]) s.index[s.terms++] = k;
+  if (s.terms > num*2) { s.terms = 0; return; }
+
+  // start from the best terms so far, for a new model that is the average Axis1 offset alone
+  s.x[0] = arcsecToRad(best_deo);
+  s.x[1] = arcsecToRad(best_pd);
+  s.x[2] = arcsecToRad(best_pz);
+  s.x[3] = arcsecToRad(best_pe);
+  s.x[4] = arcsecToRad(best_df);
+  s.x[5] = arcsecToRad(best_ff);
+  s.x[6] = arcsecToRad(best_tf);
+  s.x[7] = arcsecToRad(best_ode);
+  s.x[8] = arcsecToRad(best_ohe);
+
+  s.lambda = 0.001F;
+  s.cost = residualSumSq(s.x);
+  s.iteration = 0;
+  s.sample = 0;
+  s.tries = 0;
+  memset(s.A, 0, sizeof(s.A));
+  memset(s.g, 0, sizeof(s.g));
+}
+
+AlignFitResult GeoAlign::leastSquaresStep() {
+  AlignLeastSquares &s = leastSquares;
+  if (s.terms == 0) return AFR_FAILED;
+
+  // accumulate the normal equations J'J and J'r two rows (one sample) at a time
+  if (s.sample < num) {
+    // step for the numerical partials of the corrections with respect to the index offsets
+    const float h = arcsecToRad(60.0F);
+    const float *x = s.x;
+
+    AlignCoordinate *m, *a;
+    float w, r1, r2, c1, c2, c1h, c2h;
+    float j1[ALIGN_MODEL_TERMS], j2[ALIGN_MODEL_TERMS];
+
+    sample(s.sample, &m, &a, &w);
+    residual(*m, *a, w, x, &r1, &r2);
+    correct(*m, 1.0F, x[0], x[1], x[2], x[3], x[4], x[5], x[6], &c1, &c2);
+
+    // the corrections are linear in the geometric terms, so their partials are the corrections for a unit term
+    for (int k = 0; k < 7; k++) {
+      float e[7] = {0};
+      e[k] = 1.0F;
+      correct(*m, 1.0F, e[0], e[1], e[2], e[3], e[4], e[5], e[6], &j1[k], &j2[k]);
+      j1[k] *= w;
+    }
+
+    // the index offsets move the mount coordinate itself
+    prepare(*m, x[8], x[7] + h);
+    correct(*m, 1.0F, x[0], x[1], x[2], x[3], x[4], x[5], x[6], &c1h, &c2h);
+    j1[7] = ((c1h - c1)/h)*w;
+    j2[7] = -m->side + (c2h - c2)/h;
+
+    prepare(*m, x[8] + h, x[7]);
+    correct(*m, 1.0F, x[0], x[1], x[2], x[3], x[4], x[5], x[6], &c1h, &c2h);
+    j1[8] = (-1.0F + (c1h - c1)/h)*w;
+    j2[8] = (c2h - c2)/h;
+
+    for (int i = 0; i < s.terms; i++) {
+      for (int j = 0; j < s.terms; j++) s.A[i][j] += j1[s.index[i]]*j1[s.index[j]] + j2[s.index[i]]*j2[s.index[j]];
+      s.g[i] += j1[s.index[i]]*r1 + j2[s.index[i]]*r2;
+    }
+
+    s.sample++;
+    return AFR_BUSY;
+  }
+
+  // try a damped step, the damping increases each time one doesn't lower the residuals
+  int terms = s.terms;
+  float M[ALIGN_MODEL_TERMS][ALIGN_MODEL_TERMS + 1];
+  for (int i = 0; i < terms; i++) {
+    for (int j = 0; j < terms; j++) M[i][j] = s.A[i][j];
+    M[i][i] += s.lambda*s.A[i][i];
+    M[i][terms] = -s.g[i];
+  }
+
+  // gaussian elimination with partial pivoting
+  for (int c = 0; c < terms; c++) {
+    int pivot = c;
+    for (int i = c + 1; i < terms; i++) if (fabs(M[i][c]) > fabs(M[pivot][c])) pivot = i;
+    if (fabs(M[pivot][c]) < 1.0E-20F) { VLF("MSG: Align, least squares normal equations are singular"); return AFR_FAILED; }
+    if (pivot != c) for (int j = c; j <= terms; j++) { float t = M[c][j]; M[c][j] = M[pivot][j]; M[pivot][j] = t; }
+    for (int i = c + 1; i < terms; i++) {
+      float f = M[i][c]/M[c][c];
+      for (int j = c; j <= terms; j++) M[i][j] -= f*M[c][j];
     }
   }
+
+  float step[ALIGN_MODEL_TERMS];
+  for (int i = terms - 1; i >= 0; i--) {
+    float sum = M[i][terms];
+    for (int j = i + 1; j < terms; j++) sum -= M[i][j]*step[j];
+    step[i] = sum/M[i][i];
+  }
+
+  float xn[ALIGN_MODEL_TERMS];
+  float maxStep = 0.0F;
+  for (int k = 0; k < ALIGN_MODEL_TERMS; k++) xn[k] = s.x[k];
+  for (int i = 0; i < terms; i++) {
+    xn[s.index[i]] += step[i];
+    if (fabs(step[i]) > maxStep) maxStep = fabs(step[i]);
+  }
+
+  float costNew = residualSumSq(xn);
+  if (isnan(costNew)) { VLF("MSG: Align, least squares fit failed"); return AFR_FAILED; }
+  if (costNew < s.cost) {
+    for (int k = 0; k < ALIGN_MODEL_TERMS; k++) s.x[k] = xn[k];
+    s.cost = costNew;
+    s.lambda *= 0.1F;
+    if (maxStep < arcsecToRad(0.01F)) return leastSquaresEnd();
+
+    // on to the next iteration
+    if (++s.iteration >= ALIGN_LEAST_SQUARES_ITERATIONS) { VLF("MSG: Align, least squares fit didn't converge"); return AFR_FAILED; }
+    s.sample = 0;
+    s.tries = 0;
+    memset(s.A, 0, sizeof(s.A));
+    memset(s.g, 0, sizeof(s.g));
+  } else {
+    s.lambda *= 10.0F;
+
+    // no step lowers the residuals any further so we are at the minimum
+    if (++s.tries >= 10) return leastSquaresEnd();
+  }
+
+  return AFR_BUSY;
+}
+
+AlignFitResult GeoAlign::leastSquaresEnd() {
+  AlignLeastSquares &s = leastSquares;
+
+  // the geometric terms must stay in the range the grid search covers
+  for (int k = 0; k < 7; k++) if (fabs(s.x[k]) > degToRadF(10.0F)) { VLF("MSG: Align, least squares fit out of range"); return AFR_FAILED; }
+
+  rms = radToArcsec(sqrtf(s.cost/num));
+  VF("MSG: Align, least squares fit converged in "); V(s.iteration + 1); VF(" iterations, rms ");
+  V(rms); VLF(" arc-sec");
+
+  best_deo = radToArcsec(s.x[0]);
+  best_pd  = radToArcsec(s.x[1]);
+  best_pz  = radToArcsec(s.x[2]);
+  best_pe  = radToArcsec(s.x[3]);
+  best_df  = radToArcsec(s.x[4]);
+  best_ff  = radToArcsec(s.x[5]);
+  best_tf  = radToArcsec(s.x[6]);
+  best_ode = radToArcsec(s.x[7]);
+  best_odw = -best_ode;
+  best_ohe = radToArcsec(s.x[8]);
+  best_ohw = best_ohe;
+
+  return AFR_SOLVED;
 }
 
 void GeoAlign::autoModel(int n) {
+  autoModelBegin(n);
+  AlignFitResult result;
+  do { result = fitStep(); } while (result == AFR_BUSY);
+  fitEnd(result == AFR_SOLVED);
+}
+
+void GeoAlign::autoModelBegin(int n) {
   modelIsReady = false;
 
   VLF("MSG: Align, calculate pointing model start");
+  fitKind = AFK_AUTO;
 
   // how many stars?
   num = n;
@@ -314,6 +588,9 @@ void GeoAlign::autoModel(int n) {
   best_ode  = 0.0F;
   best_ohe  = 0.0F;
 
+  // the weight for Axis1 residuals depends only on the sample
+  for (l = 0; l < num; l++) weight[l] = cosf(actual[l].ax2);
+
   // figure out the average Axis1 offset as a starting point
   ohe = 0;
   float diff;
@@ -335,45 +612,269 @@ void GeoAlign::autoModel(int n) {
   if (num > 2) Do = 1;
 
   // search, this can handle about 9 degrees of polar misalignment, and 4 degrees of cone error
-  //              DoPdPzPeTfFf Df OdOh
-  doSearch(16384,0 ,0,1,1,0, 0, 0,1,1);
-  doSearch( 8192,Do,0,1,1,0, 0, 0,1,1);
-  doSearch( 4096,Do,0,1,1,0, 0, 0,1,1);
-  doSearch( 2048,Do,0,1,1,0, 0, 0,1,1);
-  doSearch( 1024,Do,0,1,1,0, 0, 0,1,1);
-  doSearch(  512,Do,0,1,1,0, 0, 0,1,1);
+  search.passes = 0;
+  search.total = 0;
+  //               DoPdPzPeTfFf Df OdOh
+  searchAdd(16384,0 ,0,1,1,0, 0, 0,1,1);
+  searchAdd( 8192,Do,0,1,1,0, 0, 0,1,1);
+  searchAdd( 4096,Do,0,1,1,0, 0, 0,1,1);
+  searchAdd( 2048,Do,0,1,1,0, 0, 0,1,1);
+  searchAdd( 1024,Do,0,1,1,0, 0, 0,1,1);
+  searchAdd(  512,Do,0,1,1,0, 0, 0,1,1);
   #ifdef HAL_SLOW_PROCESSOR
-    doSearch(256,Do,0,1,1,0, 0, 0,1,1);
-    doSearch(128,Do,0,1,1,0, 0, 0,1,1);
-    doSearch( 64,Do,0,1,1,0, 0, 0,1,1);
+    searchAdd(256,Do,0,1,1,0, 0, 0,1,1);
+    searchAdd(128,Do,0,1,1,0, 0, 0,1,1);
+    searchAdd( 64,Do,0,1,1,0, 0, 0,1,1);
   #else
     if (num > 4) {
-      doSearch(256,Do,1,1,1,0,Ff,Df,1,1);
-      doSearch(128,Do,1,1,1,1,Ff,Df,1,1);
-      doSearch( 64,Do,1,1,1,1,Ff,Df,1,1);
+      searchAdd(256,Do,1,1,1,0,Ff,Df,1,1);
+      searchAdd(128,Do,1,1,1,1,Ff,Df,1,1);
+      searchAdd( 64,Do,1,1,1,1,Ff,Df,1,1);
       #ifdef HAL_FAST_PROCESSOR
-        doSearch( 32,Do,1,1,1,1,Ff,Df,1,1);
-        doSearch( 16,Do,1,1,1,1,Ff,Df,1,1);
-        doSearch(  8,Do,1,1,1,1,Ff,Df,1,1);
+        searchAdd( 32,Do,1,1,1,1,Ff,Df,1,1);
+        searchAdd( 16,Do,1,1,1,1,Ff,Df,1,1);
+        searchAdd(  8,Do,1,1,1,1,Ff,Df,1,1);
         #ifdef HAL_VFAST_PROCESSOR
-          doSearch(  4,Do,1,1,1,1,Ff,Df,1,1);
+          searchAdd(  4,Do,1,1,1,1,Ff,Df,1,1);
         #endif
       #endif
     } else {
-      doSearch(256,Do,0,1,1,0, 0, 0,1,1);
-      doSearch(128,Do,0,1,1,0, 0, 0,1,1);
-      doSearch( 64,Do,0,1,1,0, 0, 0,1,1);
-      doSearch( 32,Do,0,1,1,0, 0, 0,1,1);
+      searchAdd(256,Do,0,1,1,0, 0, 0,1,1);
+      searchAdd(128,Do,0,1,1,0, 0, 0,1,1);
+      searchAdd( 64,Do,0,1,1,0, 0, 0,1,1);
+      searchAdd( 32,Do,0,1,1,0, 0, 0,1,1);
       #ifdef HAL_FAST_PROCESSOR
-        doSearch( 16,Do,0,1,1,0, 0, 0,1,1);
-        doSearch(  8,Do,0,1,1,0, 0, 0,1,1);
+        searchAdd( 16,Do,0,1,1,0, 0, 0,1,1);
+        searchAdd(  8,Do,0,1,1,0, 0, 0,1,1);
         #ifdef HAL_VFAST_PROCESSOR
-          doSearch(  4,Do,0,1,1,0, 0, 0,1,1);
+          searchAdd(  4,Do,0,1,1,0, 0, 0,1,1);
         #endif
       #endif
     }
   #endif
 
+  // least squares first, the search passes are there if it fails
+  #if ALIGN_LEAST_SQUARES == ON
+    bool active[ALIGN_MODEL_TERMS];
+    activeTerms(active);
+    leastSquaresBegin(active);
+  #else
+    searchBegin();
+  #endif
+}
+
+bool GeoAlign::fitStart(const char *name) {
+  autoModelTask = tasks.add(1, 0, true, 6, fitPollWrapper, name);
+  #ifdef TASKS_CORE_AFFINITY
+    // the model fit is long running and self-contained, keep it off the core that runs motion and tracking
+    tasks.setCore(autoModelTask, 1 - xPortGetCoreID());
+  #endif
+  if (autoModelTask == 0) { fitKind = AFK_NONE; return false; }
+  return true;
+}
+
+void GeoAlign::fitPoll() {
+  if (fitKind == AFK_NONE) return;
+
+  // work through the fit in small steps until this slice of time is used up
+  unsigned long start = micros();
+  AlignFitResult result;
+  do { result = fitStep(); } while (result == AFR_BUSY && (long)(micros() - start) < ALIGN_FIT_SLICE_US);
+
+  if (result != AFR_BUSY) fitEnd(result == AFR_SOLVED);
+}
+
+AlignFitResult GeoAlign::fitStep() {
+  if (fitStage == AFS_SEARCH) return searchStep();
+
+  AlignFitResult result = leastSquaresStep();
+  if (result == AFR_FAILED && fitKind == AFK_AUTO) {
+    VLF("MSG: Align, least squares fit failed using grid search");
+    searchBegin();
+    return AFR_BUSY;
+  }
+  return result;
+}
+
+void GeoAlign::fitEnd(bool solved) {
+  switch (fitKind) {
+    case AFK_AUTO:
+      // the grid search always ends with the best terms it found
+      modelFromBest();
+      modelIsReady = true;
+      VLF("MSG: Align, calculate pointing model done");
+    break;
+
+    case AFK_REFINE:
+      if (solved) modelFromBest(); else { VLF("MSG: Align, refine failed keeping the current model"); }
+      VLF("MSG: Align, refine pointing model done");
+    break;
+
+    #if ALIGN_POINTS_MAX != OFF
+      case AFK_POINTS:
+        if (solved) {
+          modelFromBest();
+          modelIsReady = true;
+          // the align stars no longer match the model so it can't be refined from them
+          modelNumberStars = 0;
+          pointsFitState = APF_DONE;
+        } else {
+          VLF("MSG: Align, fit to imported points failed keeping the current model");
+          pointsFitState = APF_FAILED;
+        }
+        fitPoints = false;
+        VLF("MSG: Align, fit pointing model to imported points done");
+      break;
+    #endif
+
+    default: break;
+  }
+
+  fitKind = AFK_NONE;
+  if (autoModelTask != 0) {
+    tasks.setDurationComplete(autoModelTask);
+    autoModelTask = 0;
+  }
+}
+
+bool GeoAlign::fitProgress(int *percent, long *seconds) {
+  if (fitKind == AFK_NONE) return false;
+
+  float done = 0.0F;
+  if (fitStage == AFS_SEARCH) {
+    if (search.total > 0) done = (float)search.done/search.total;
+  } else {
+    // least squares usually converges well inside the iteration limit, so this is pessimistic
+    done = (leastSquares.iteration + (float)leastSquares.sample/(num + 1))/ALIGN_LEAST_SQUARES_ITERATIONS;
+  }
+  if (done > 0.99F) done = 0.99F;
+  *percent = lroundf(done*100.0F);
+
+  // extrapolated from the time taken so far, 0 until there's something to go on
+  float elapsed = (millis() - fitStageMs)/1000.0F;
+  *seconds = done > 0.01F ? lroundf(elapsed*(1.0F - done)/done) : 0;
+  return true;
+}
+
+#if ALIGN_LEAST_SQUARES == ON
+void GeoAlign::refineModelBegin() {
+  VLF("MSG: Align, refine pointing model start");
+  fitKind = AFK_REFINE;
+
+  num = modelNumberStars;
+  for (l = 0; l < num; l++) weight[l] = cosf(actual[l].ax2);
+
+  // seed the fit with the model in use, it then only has to account for the new sample
+  best_deo = radToArcsec(model.doCor);
+  best_pd  = radToArcsec(model.pdCor);
+  best_pz  = radToArcsec(model.azmCor);
+  best_pe  = radToArcsec(model.altCor);
+  best_tf  = radToArcsec(model.tfCor);
+  if (mountType == FORK || mountType == ALTAZM) { best_ff = radToArcsec(model.dfCor); best_df = 0.0F; } else { best_df = radToArcsec(model.dfCor); best_ff = 0.0F; }
+  best_ohe = radToArcsec(model.ax1Cor);
+  best_ohw = best_ohe;
+  best_odw = radToArcsec(model.ax2Cor);
+  best_ode = -best_odw;
+
+  bool active[ALIGN_MODEL_TERMS];
+  activeTerms(active);
+  leastSquaresBegin(active);
+}
+
+void GeoAlign::activeTerms(bool *active) {
+  // fork flex or dec axis flex, as appropriate
+  if (mountType == ALTAZM) { Ff = 0; Df = 0; } else if (mountType == FORK) { Ff = 1; Df = 0; } else { Ff = 0; Df = 1; }
+
+  // the terms the grid search would find, do, pd, pz, pe, df, ff, tf, od, oh
+  bool more = num > 4;
+  active[0] = num > 2;
+  active[1] = more;
+  active[2] = true;
+  active[3] = true;
+  active[4] = more && Df == 1;
+  active[5] = more && Ff == 1;
+  active[6] = more;
+  active[7] = true;
+  active[8] = true;
+}
+#endif
+
+#if ALIGN_POINTS_MAX != OFF
+bool GeoAlign::pointsClear() {
+  if (autoModelTask != 0) return false;
+  pointsCount = 0;
+  pointsFitState = APF_NONE;
+  return true;
+}
+
+bool GeoAlign::pointAdd(Coordinate *actual, Coordinate *mount) {
+  if (autoModelTask != 0 || pointsCount >= ALIGN_POINTS_MAX) return false;
+
+  AlignPoint &point = points[pointsCount];
+  if (mountType == ALTAZM) {
+    transform.equToHor(mount);
+    point.mountAx1 = mount->z;
+    point.mountAx2 = mount->a;
+
+    transform.equToHor(actual);
+    point.actualAx1 = actual->z;
+    point.actualAx2 = actual->a;
+  } else {
+    point.mountAx1 = mount->h;
+    point.mountAx2 = mount->d;
+
+    point.actualAx1 = actual->h;
+    point.actualAx2 = actual->d;
+  }
+  point.side = mount->pierSide == PIER_SIDE_WEST ? -1 : 1;
+
+  pointsCount++;
+  return true;
+}
+
+CommandError GeoAlign::pointsFit() {
+  if (autoModelTask != 0 || pointsCount < 3) return CE_ALIGN_FAIL;
+
+  // the grid search isn't practical for this many points so it's least squares alone
+  pointsFitBegin();
+  if (!fitStart("AlignP")) { fitPoints = false; return CE_ALIGN_FAIL; }
+  return CE_NONE;
+}
+
+void GeoAlign::pointsFitBegin() {
+  VF("MSG: Align, fit pointing model to "); V(pointsCount); VLF(" imported points start");
+  fitKind = AFK_POINTS;
+  pointsFitState = APF_BUSY;
+
+  num = pointsCount;
+  fitPoints = true;
+
+  best_deo = 0.0F;
+  best_pd  = 0.0F;
+  best_pz  = 0.0F;
+  best_pe  = 0.0F;
+  best_tf  = 0.0F;
+  best_ff  = 0.0F;
+  best_df  = 0.0F;
+  best_ode = 0.0F;
+
+  // the average Axis1 offset as a starting point
+  ohe = 0;
+  for (l = 0; l < num; l++) {
+    float diff = points[l].actualAx1 - points[l].mountAx1;
+    if (diff >  Deg180) diff = diff - Deg360;
+    if (diff < -Deg180) diff = diff + Deg360;
+    ohe = ohe + diff;
+  }
+  best_ohe = radToArcsec(ohe/num);
+
+  bool active[ALIGN_MODEL_TERMS];
+  activeTerms(active);
+  leastSquaresBegin(active);
+}
+#endif
+
+void GeoAlign::modelFromBest() {
   // geometric corrections
   model.doCor = arcsecToRad(best_deo);
   model.pdCor = arcsecToRad(best_pd);
@@ -385,13 +886,6 @@ void GeoAlign::autoModel(int n) {
 
   model.ax1Cor = arcsecToRad(best_ohw);
   model.ax2Cor = arcsecToRad(best_odw);
-
-  // update status and exit
-  modelIsReady = true;
-
-  VLF("MSG: Align, calculate pointing model done");
-  tasks.setDurationComplete(autoModelTask);
-  autoModelTask = 0;
 }
 
 void GeoAlign::observedPlaceToMount(Coordinate *coord) {
@@ -412,12 +906,37 @@ void GeoAlign::observedPlaceToMount(Coordinate *coord) {
   if (ax2 >  Deg90) ax2 =  Deg90;
   if (ax2 < -Deg90) ax2 = -Deg90;
 
+  #if ALIGN_CACHE_SIZE > 0
+    float d1, d2;
+    cacheValidate();
+    if (cacheGet(toMountCache, ax1, ax2, p, &d1, &d2)) {
+      ax1 += d1;
+      ax2 += d2;
+    } else {
+      float in1 = ax1, in2 = ax2;
+      observedPlaceToMountCorrect(p, &ax1, &ax2);
+      cachePut(toMountCache, in1, in2, p, ax1 - in1, ax2 - in2);
+    }
+  #else
+    observedPlaceToMountCorrect(p, &ax1, &ax2);
+  #endif
+
+  if (mountType == ALTAZM) {
+    coord->z = ax1;
+    coord->a = ax2;
+  } else {
+    coord->h = ax1;
+    coord->d = ax2;
+  }
+}
+
+void GeoAlign::observedPlaceToMountCorrect(float p, float *ax1, float *ax2) {
   // initial rough guess at instrument coordinate
-  float a1 = ax1;
-  float a2 = ax2;
+  float a1 = *ax1;
+  float a2 = *ax2;
 
   // breaks-down near the poles (limited to > 1' from pole)
-  if (fabs(ax2) < degToRadF(89.98333333F)) {
+  if (fabs(*ax2) < degToRadF(89.98333333F)) {
     for (int pass = 0; pass < 3; pass++) {
       float sinAx2 = sinf(a2);
       float cosAx2 = cosf(a2);
@@ -449,8 +968,8 @@ void GeoAlign::observedPlaceToMount(Coordinate *coord) {
       float ax2c = +model.azmCor*sinAx1                 + model.altCor*cosAx1;
 
       // improved guess at instrument coordinate
-      a1 = ax1 + (ax1c + PDh + DOh + TFh);
-      a2 = ax2 + (ax2c + DFd + TFd);
+      a1 = *ax1 + (ax1c + PDh + DOh + TFh);
+      a2 = *ax2 + (ax2c + DFd + TFd);
     }
   }
 
@@ -458,13 +977,59 @@ void GeoAlign::observedPlaceToMount(Coordinate *coord) {
   a1 = a1 - model.ax1Cor;
   a2 = a2 - model.ax2Cor*-p;
 
+  *ax1 = a1;
+  *ax2 = a2;
+}
+
+// partial derivatives of the mount coordinate (axis1, axis2) with respect to the observed place (axis1, axis2)
+void GeoAlign::observedPlaceToMountJacobian(Coordinate *coord, float j[2][2]) {
+  j[0][0] = 1.0F; j[0][1] = 0.0F;
+  j[1][0] = 0.0F; j[1][1] = 1.0F;
+  if (!modelIsReady) return;
+
+  float p = 1.0F;
+  if (coord->pierSide == PIER_SIDE_WEST) p = -1.0F;
+
+  // instrument coordinate before the index offsets are applied
+  float a1, a2;
   if (mountType == ALTAZM) {
-    coord->z = a1;
-    coord->a = a2;
+    a1 = coord->z;
+    a2 = coord->a;
   } else {
-    coord->h = a1;
-    coord->d = a2;
+    a1 = coord->h;
+    a2 = coord->d;
+  }
+  a1 = a1 + model.ax1Cor;
+  a2 = a2 + model.ax2Cor*-p;
+
+  // no correction is made near the poles
+  if (fabs(a2) >= degToRadF(89.98333333F)) return;
+
+  float sinAx2 = sinf(a2);
+  float cosAx2 = cosf(a2);
+  float sinAx1 = sinf(a1);
+  float cosAx1 = cosf(a1);
+  float secAx2 = 1.0F/cosAx2;
+  float tanAx2 = sinAx2*secAx2;
+
+  // partial derivatives of the axis1 (f1) and axis2 (f2) corrections made in observedPlaceToMount()
+  float f11 = (model.azmCor*sinAx1 + model.altCor*cosAx1)*tanAx2 + model.tfCor*cosLat*cosAx1*secAx2;
+  float f12 = (-model.azmCor*cosAx1 + model.altCor*sinAx1 - model.pdCor*p)*secAx2*secAx2 +
+              (model.doCor*p + model.tfCor*cosLat*sinAx1)*secAx2*tanAx2;
+  float f21 = model.azmCor*cosAx1 - model.altCor*sinAx1 - model.tfCor*cosLat*sinAx1*sinAx2;
+  float f22 = model.tfCor*(cosLat*cosAx1*cosAx2 + sinLat*sinAx2);
+  if (mountType == FORK || mountType == ALTAZM) f21 -= model.dfCor*sinAx1; else {
+    f21 += model.dfCor*cosLat*sinAx1;
+    f22 -= model.dfCor*sinLat*secAx2*secAx2;
   }
+
+  // the instrument coordinate is the solution of a = ax + f(a), so da/dax = (I - df/da)^-1
+  float m11 = 1.0F - f11;
+  float m22 = 1.0F - f22;
+  float det = m11*m22 - f12*f21;
+  if (fabs(det) < 0.1F) return;
+  j[0][0] = m22/det; j[0][1] = f12/det;
+  j[1][0] = f21/det; j[1][1] = m11/det;
 }
 
 void GeoAlign::mountToObservedPlace(Coordinate *coord) {
@@ -488,12 +1053,44 @@ void GeoAlign::mountToObservedPlace(Coordinate *coord) {
   if (ax2 >  Deg90) ax2 =  Deg90;
   if (ax2 < -Deg90) ax2 = -Deg90;
 
+  #if ALIGN_CACHE_SIZE > 0
+    float d1, d2;
+    cacheValidate();
+    if (cacheGet(toObservedCache, ax1, ax2, p, &d1, &d2)) {
+      ax1 += d1;
+      ax2 += d2;
+    } else {
+      float in1 = ax1, in2 = ax2;
+      mountToObservedPlaceCorrect(p, &ax1, &ax2);
+      cachePut(toObservedCache, in1, in2, p, ax1 - in1, ax2 - in2);
+    }
+  #else
+    mountToObservedPlaceCorrect(p, &ax1, &ax2);
+  #endif
+
+  if (ax2 >  Deg90) ax2 =  Deg90;
+  if (ax2 < -Deg90) ax2 = -Deg90;
+
+  if (mountType == ALTAZM) {
+    while (ax1 >  Deg360) ax1 -= Deg360;
+    while (ax1 < -Deg360) ax1 += Deg360;
+    coord->z = ax1;
+    coord->a = ax2;
+  } else {
+    while (ax1 >  Deg180) ax1 -= Deg360;
+    while (ax1 < -Deg180) ax1 += Deg360;
+    coord->h = ax1;
+    coord->d = ax2;
+  }
+}
+
+void GeoAlign::mountToObservedPlaceCorrect(float p, float *ax1, float *ax2) {
   // breaks-down near the Zenith (limited to > 1' from Zenith)
-  if (fabs(ax2) < degToRadF(89.98333333F)) {
-    float sinAx2 = sinf(ax2);
-    float cosAx2 = cosf(ax2);
-    float sinAx1 = sinf(ax1);
-    float cosAx1 = cosf(ax1);
+  if (fabs(*ax2) < degToRadF(89.98333333F)) {
+    float sinAx2 = sinf(*ax2);
+    float cosAx2 = cosf(*ax2);
+    float sinAx1 = sinf(*ax1);
+    float cosAx1 = cosf(*ax1);
 
     // ------------------------------------------------------------
     // misalignment due to tube/optics not being perp. to Alt axis
@@ -520,25 +1117,45 @@ void GeoAlign::mountToObservedPlace(Coordinate *coord) {
     float a1 = -model.azmCor*cosAx1*(sinAx2/cosAx2) + model.altCor*sinAx1*(sinAx2/cosAx2);
     float a2 = +model.azmCor*sinAx1                 + model.altCor*cosAx1;
 
-    ax1 = ax1 - (a1 + PDh + DOh + TFh);
-    ax2 = ax2 - (a2 + DFd + TFd);
+    *ax1 = *ax1 - (a1 + PDh + DOh + TFh);
+    *ax2 = *ax2 - (a2 + DFd + TFd);
   }
+}
 
-  if (ax2 >  Deg90) ax2 =  Deg90;
-  if (ax2 < -Deg90) ax2 = -Deg90;
+#if ALIGN_CACHE_SIZE > 0
+  void GeoAlign::cacheValidate() {
+    if (memcmp(&model, &cacheModel, sizeof(AlignModel)) == 0) return;
+    memcpy(&cacheModel, &model, sizeof(AlignModel));
+    memset(&toMountCache, 0, sizeof(AlignCache));
+    memset(&toObservedCache, 0, sizeof(AlignCache));
+  }
 
-  if (mountType == ALTAZM) {
-    while (ax1 >  Deg360) ax1 -= Deg360;
-    while (ax1 < -Deg360) ax1 += Deg360;
-    coord->z = ax1;
-    coord->a = ax2;
-  } else {
-    while (ax1 >  Deg180) ax1 -= Deg360;
-    while (ax1 < -Deg180) ax1 += Deg360;
-    coord->h = ax1;
-    coord->d = ax2;
+  bool GeoAlign::cacheGet(AlignCache &cache, float ax1, float ax2, float p, float *d1, float *d2) {
+    // not near the poles where the corrections change quickly
+    if (fabs(ax2) > degToRadF(89.9F)) return false;
+
+    long key1 = lroundf(ax1/ALIGN_CACHE_QUANTUM);
+    long key2 = lroundf(ax2/ALIGN_CACHE_QUANTUM);
+    int8_t side = p < 0.0F ? -1 : 1;
+    for (int i = 0; i < ALIGN_CACHE_SIZE; i++) {
+      AlignCacheEntry *e = &cache.entry[i];
+      if (e->side == side && e->key1 == key1 && e->key2 == key2) { *d1 = e->d1; *d2 = e->d2; return true; }
+    }
+    return false;
   }
-}
+
+  void GeoAlign::cachePut(AlignCache &cache, float ax1, float ax2, float p, float d1, float d2) {
+    if (fabs(ax2) > degToRadF(89.9F)) return;
+
+    AlignCacheEntry *e = &cache.entry[cache.next];
+    e->key1 = lroundf(ax1/ALIGN_CACHE_QUANTUM);
+    e->key2 = lroundf(ax2/ALIGN_CACHE_QUANTUM);
+    e->side = p < 0.0F ? -1 : 1;
+    e->d1 = d1;
+    e->d2 = d2;
+    cache.next = (cache.next + 1) % ALIGN_CACHE_SIZE;
+  }
+#endif
 
 #endif
 
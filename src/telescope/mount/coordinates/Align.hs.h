@@ -41,6 +41,29 @@ typedef struct Coordinate {
 
 #if ALIGN_MAX_NUM_STARS > 1
 
+// least squares model fit iteration limit, if it hasn't converged by then the grid search takes over
+#ifndef ALIGN_LEAST_SQUARES_ITERATIONS
+  #define ALIGN_LEAST_SQUARES_ITERATIONS 20
+#endif
+
+// number of terms in the pointing model, in the order do, pd, pz, pe, df, ff, tf, od, oh
+#define ALIGN_MODEL_TERMS 9
+
+// the model fit task works for this long (in microseconds) each time it runs then gives up the processor
+#ifndef ALIGN_FIT_SLICE_US
+  #define ALIGN_FIT_SLICE_US 2000
+#endif
+
+// most grid search passes in a model fit
+#define ALIGN_SEARCH_PASSES 13
+
+// number of recent model evaluations kept for each direction (0 to disable) and the axis coordinate
+// cell size they are keyed on, reuse within a cell is accurate to a small fraction of an arc-second
+#ifndef ALIGN_CACHE_SIZE
+  #define ALIGN_CACHE_SIZE 4
+#endif
+#define ALIGN_CACHE_QUANTUM arcsecToRad(2.0)
+
 // -----------------------------------------------------------------------------------
 // ADVANCED GEOMETRIC ALIGN FOR EQUATORIAL MOUNTS (GOTO ASSIST)
 
@@ -53,6 +76,53 @@ typedef struct AlignCoordinate {
   int side;
 } AlignCoordinate;
 
+enum AlignFitKind: uint8_t {AFK_NONE, AFK_AUTO, AFK_REFINE, AFK_POINTS};
+enum AlignFitStage: uint8_t {AFS_LEAST_SQUARES, AFS_SEARCH};
+enum AlignFitResult: uint8_t {AFR_BUSY, AFR_SOLVED, AFR_FAILED};
+
+// a grid search pass, the step size in arc-seconds and the search half width in steps for each term
+// in the order do, pd, pz, pe, tf, ff, df, od, oh
+typedef struct AlignSearchPass {
+  float sf;
+  uint8_t p[9];
+} AlignSearchPass;
+
+// least squares fit state kept between time slices
+typedef struct AlignLeastSquares {
+  float x[ALIGN_MODEL_TERMS];
+  float A[ALIGN_MODEL_TERMS][ALIGN_MODEL_TERMS];
+  float g[ALIGN_MODEL_TERMS];
+  int index[ALIGN_MODEL_TERMS];
+  int terms;
+  float lambda;
+  float cost;
+  int iteration;
+  int sample;                       // next sample for the normal equations, num once they are complete
+  int tries;                        // damped steps tried this iteration
+} AlignLeastSquares;
+
+// grid search state kept between time slices, the terms are odometer digits in the order
+// oh, od, do, pd, pz, pe, df, ff, tf (innermost)
+typedef struct AlignSearch {
+  AlignSearchPass pass[ALIGN_SEARCH_PASSES];
+  uint8_t passes;
+  uint8_t thisPass;
+  long lo[9], hi[9], at[9];
+  bool offsetsReady;                // the per sample working set is current for the oh, od digits
+  unsigned long done, total;        // combinations checked and in all passes
+} AlignSearch;
+
+#if ALIGN_POINTS_MAX != OFF
+  // an imported point for a large pointing model, just the axis coordinates so many can be held
+  typedef struct AlignPoint {
+    float mountAx1, mountAx2;
+    float actualAx1, actualAx2;
+    int8_t side;
+  } AlignPoint;
+
+  enum AlignPointsFit: uint8_t {APF_NONE, APF_BUSY, APF_DONE, APF_FAILED};
+#endif
+
 #define AlignModelSize 32
 typedef struct AlignModel {
   float ax1Cor;
@@ -65,6 +135,21 @@ typedef struct AlignModel {
   float tfCor;
 } AlignModel;
 
+#if ALIGN_CACHE_SIZE > 0
+  typedef struct AlignCacheEntry {
+    long key1;
+    long key2;
+    int8_t side;                    // 0 if unused
+    float d1;                       // axis1 correction
+    float d2;                       // axis2 correction
+  } AlignCacheEntry;
+
+  typedef struct AlignCache {
+    AlignCacheEntry entry[ALIGN_CACHE_SIZE];
+    uint8_t next;
+  } AlignCache;
+#endif
+
 class GeoAlign
 {
   public:
@@ -80,6 +165,20 @@ class GeoAlign
     // reports if ready for operation
     bool modelReady();
 
+    #if ALIGN_MODEL_SLOTS != OFF
+      // selects pointing model slot (0 to ALIGN_MODEL_SLOTS - 1) and loads its model, the selection is kept
+      // in NV (along with a copy of the model) so it's restored at startup
+      bool modelSlotSelect(uint8_t slot);
+      // gets the selected pointing model slot
+      uint8_t modelSlot();
+      // saves the alignment model to the selected slot
+      void modelSlotWrite();
+      // gets the name of a slot, up to 7 characters
+      bool modelSlotGetName(uint8_t slot, char *name);
+      // names the selected slot, up to 7 characters
+      bool modelSlotSetName(const char *name);
+    #endif
+
     // add a star to an alignment model
     // thisStar: 1 for 1st star, 2 for 2nd star, etc. up to numberStars (at which point the mount model is calculated)
     // numberStars: total number of stars for this align (1 to 9)
@@ -87,23 +186,119 @@ class GeoAlign
     // mount:  equatorial or horizon coordinate (depending on the mount type) for where the star is (in mount coordinates)
     CommandError addStar(int thisStar, int numberStars, Coordinate *actual, Coordinate *mount);
 
+    // add a star to a finished alignment model, the model is then refined from its current terms in the background
+    // actual and mount are as for addStar(), returns CE_ALIGN_FAIL if there is no model from this session to refine
+    CommandError refineStar(Coordinate *actual, Coordinate *mount);
+
     void createModel(int numberStars);
     
     // convert equatorial (h,d) or horizon (a,z) coordinate from observed place to mount
     void observedPlaceToMount(Coordinate *coord);
     // convert equatorial (h,d) or horizon (a,z) coordinate from mount to observed place
     void mountToObservedPlace(Coordinate *coord);
+    // partial derivatives of observedPlaceToMount() with respect to the observed place at this mount coordinate
+    // j[0] is for axis1 and j[1] for axis2, identity if there is no model
+    void observedPlaceToMountJacobian(Coordinate *coord, float j[2][2]);
 
+    // fit the model to n stars all at once rather than in the background (for benchmarking)
     void autoModel(int n);
 
+    // does up to ALIGN_FIT_SLICE_US of work on the model fit in progress, ends the fit task once done
+    void fitPoll();
+    // percent complete and estimated seconds remaining for the model fit in progress, false if there isn't one
+    bool fitProgress(int *percent, long *seconds);
+
+    #if ALIGN_POINTS_MAX != OFF
+      // clears the imported points, returns false if a fit is running
+      bool pointsClear();
+      // adds an imported point, actual and mount are as for addStar()
+      // returns false if the points are full or a fit is running
+      bool pointAdd(Coordinate *actual, Coordinate *mount);
+      // number of imported points
+      inline int pointCount() { return pointsCount; }
+      // start a least squares fit of the pointing model to the imported points in the background, the current
+      // model stays in use unless it succeeds
+      CommandError pointsFit();
+      // rms residual of the last fit in arc-seconds
+      inline float pointsFitRms() { return rms; }
+
+      AlignPointsFit pointsFitState = APF_NONE;
+    #endif
+
     AlignCoordinate mount[ALIGN_MAX_NUM_STARS];
     AlignCoordinate actual[ALIGN_MAX_NUM_STARS];
-    AlignCoordinate delta[ALIGN_MAX_NUM_STARS];
     AlignModel model;
 
   private:
     void correct(AlignCoordinate &mount, float sf, float _deo, float _pd, float _pz, float _pe, float _da, float _ff, float _tf, float *h1, float *d1);
-    void doSearch(float sf, int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9);
+
+    // set up a fit for the n samples an align just took
+    void autoModelBegin(int n);
+    #if ALIGN_LEAST_SQUARES == ON
+      // set up a fit seeded from the current model, including any samples added by refineStar()
+      void refineModelBegin();
+    #endif
+    #if ALIGN_POINTS_MAX != OFF
+      // set up a fit for the imported points
+      void pointsFitBegin();
+    #endif
+    // start the task that runs the fit set up above, returns false if it couldn't be started
+    bool fitStart(const char *name);
+    // one unit of work on the fit
+    AlignFitResult fitStep();
+    // apply the result and end the fit
+    void fitEnd(bool solved);
+
+    // add a grid search pass, sf in arc-seconds and p1 to p9 the half widths as above
+    void searchAdd(float sf, int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9);
+    // start the grid search passes with the best_ terms so far
+    void searchBegin();
+    // set the search range for a pass around the best_ terms
+    void searchPass();
+    // check the combination the search is at and advance to the next
+    AlignFitResult searchStep();
+
+    // store star i for the model fit
+    void setSample(int i, Coordinate *actual, Coordinate *mount);
+    // the model terms fit for the number of samples and mount type
+    void activeTerms(bool *active);
+    // set the model from the best_ terms
+    void modelFromBest();
+
+    // apply the index offsets to a mount coordinate and update its trig terms
+    void prepare(AlignCoordinate &mount, float ohe, float ode);
+    // Gauss-Newton/Levenberg-Marquardt fit of the active model terms starting from the best_ terms so far
+    void leastSquaresBegin(const bool *active);
+    // add a sample to the normal equations or try a damped step, AFR_FAILED if it didn't converge
+    AlignFitResult leastSquaresStep();
+    // range check the fit and set the best_ terms from it
+    AlignFitResult leastSquaresEnd();
+    // corrections for star l from a unit amount of each geometric term (do, pd, pz, pe, df, ff, tf) into corr1/corr2
+    void termCorrections(int l, float sf);
+    // the mount and actual coordinates of fit sample l with its Axis1 residual weight, from the align stars
+    // or the imported points
+    void sample(int l, AlignCoordinate **mount, AlignCoordinate **actual, float *weight);
+    // residuals for a sample with model terms x, ax1 is weighted by cos(ax2) as in the grid search
+    void residual(AlignCoordinate &mount, AlignCoordinate &actual, float weight, const float *x, float *r1, float *r2);
+    // sum of the squared residuals for all stars with model terms x
+    float residualSumSq(const float *x);
+
+    // model corrections to axis coordinate (ax1, ax2) that aren't cached
+    void observedPlaceToMountCorrect(float p, float *ax1, float *ax2);
+    void mountToObservedPlaceCorrect(float p, float *ax1, float *ax2);
+
+    #if ALIGN_CACHE_SIZE > 0
+      // clears the caches if the model has changed since they were filled
+      void cacheValidate();
+      // finds the correction cached for this axis coordinate cell, returns false if there isn't one
+      bool cacheGet(AlignCache &cache, float ax1, float ax2, float p, float *d1, float *d2);
+      // stores the correction for this axis coordinate cell
+      void cachePut(AlignCache &cache, float ax1, float ax2, float p, float d1, float d2);
+
+      AlignCache toMountCache;
+      AlignCache toObservedCache;
+      AlignModel cacheModel;
+    #endif
 
     bool modelIsReady = false;
     int8_t mountType;
@@ -119,7 +314,28 @@ class GeoAlign
     float sum1;
     float max_dist;
 
+    // per sample working set for the model fit, kept as separate arrays so the inner loops run straight through them
+    float corr1[7][ALIGN_MAX_NUM_STARS];  // Axis1 correction for a unit amount of each geometric term
+    float corr2[7][ALIGN_MAX_NUM_STARS];  // Axis2 correction for a unit amount of each geometric term
+    float base1[ALIGN_MAX_NUM_STARS];     // Axis1 residual with the index offsets alone
+    float base2[ALIGN_MAX_NUM_STARS];     // Axis2 residual with the index offsets alone
+    float weight[ALIGN_MAX_NUM_STARS];    // Axis1 residual weight, cos(actual Axis2)
+
     uint8_t autoModelTask = 0;
+
+    AlignFitKind fitKind = AFK_NONE;
+    AlignFitStage fitStage = AFS_LEAST_SQUARES;
+    unsigned long fitStageMs = 0;
+    AlignLeastSquares leastSquares;
+    AlignSearch search;
+
+    #if ALIGN_POINTS_MAX != OFF
+      AlignPoint points[ALIGN_POINTS_MAX];
+      int pointsCount = 0;
+      // the fit runs on the imported points, each is unpacked into the working coordinates as it's used
+      bool fitPoints = false;
+      AlignCoordinate pointMount, pointActual;
+    #endif
 };
 
 #endif
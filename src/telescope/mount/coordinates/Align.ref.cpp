@@ -118,6 +118,10 @@ void GeoAlign::createModel(int numberStars) {
   // start a task to solve for the model
   modelNumberStars = numberStars;
   autoModelTask = tasks.add(1, 0, false, 6, autoModelWrapper, "Align");
+  #ifdef TASKS_CORE_AFFINITY
+    // the model search is long running and self-contained, keep it off the core that runs motion and tracking
+    tasks.setCore(autoModelTask, 1 - xPortGetCoreID());
+  #endif
 }
 
 // returns the correction to be added to the requested RA,Dec to yield the actual RA,Dec that we will arrive at
@@ -444,6 +448,57 @@ void GeoAlign::observedPlaceToMount(Coordinate *coord) {
   }
 }
 
+// partial derivatives of the mount coordinate (axis1, axis2) with respect to the observed place (axis1, axis2)
+void GeoAlign::observedPlaceToMountJacobian(Coordinate *coord, float j[2][2]) {
+  j[0][0] = 1.0F; j[0][1] = 0.0F;
+  j[1][0] = 0.0F; j[1][1] = 1.0F;
+  if (!modelIsReady) return;
+
+  float p = 1.0F;
+  if (coord->pierSide == PIER_SIDE_WEST) p = -1.0F;
+
+  // instrument coordinate before the index offsets are applied
+  float a1, a2;
+  if (mountType == ALTAZM) {
+    a1 = coord->z;
+    a2 = coord->a;
+  } else {
+    a1 = coord->h;
+    a2 = coord->d;
+  }
+  a1 = a1 + model.ax1Cor;
+  a2 = a2 + model.ax2Cor*-p;
+
+  // no correction is made near the poles
+  if (fabs(a2) >= degToRadF(89.98333333F)) return;
+
+  float sinAx2 = sinf(a2);
+  float cosAx2 = cosf(a2);
+  float sinAx1 = sinf(a1);
+  float cosAx1 = cosf(a1);
+  float secAx2 = 1.0F/cosAx2;
+  float tanAx2 = sinAx2*secAx2;
+
+  // partial derivatives of the axis1 (f1) and axis2 (f2) corrections made in observedPlaceToMount()
+  float f11 = (model.azmCor*sinAx1 + model.altCor*cosAx1)*tanAx2 + model.tfCor*cosLat*cosAx1*secAx2;
+  float f12 = (-model.azmCor*cosAx1 + model.altCor*sinAx1 - model.pdCor*p)*secAx2*secAx2 +
+              (model.doCor*p + model.tfCor*cosLat*sinAx1)*secAx2*tanAx2;
+  float f21 = model.azmCor*cosAx1 - model.altCor*sinAx1 - model.tfCor*cosLat*sinAx1*sinAx2;
+  float f22 = model.tfCor*(cosLat*cosAx1*cosAx2 + sinLat*sinAx2);
+  if (mountType == FORK || mountType == ALTAZM) f21 -= model.dfCor*sinAx1; else {
+    f21 += model.dfCor*cosLat*sinAx1;
+    f22 -= model.dfCor*sinLat*secAx2*secAx2;
+  }
+
+  // the instrument coordinate is the solution of a = ax + f(a), so da/dax = (I - df/da)^-1
+  float m11 = 1.0F - f11;
+  float m22 = 1.0F - f22;
+  float det = m11*m22 - f12*f21;
+  if (fabs(det) < 0.1F) return;
+  j[0][0] = m22/det; j[0][1] = f12/det;
+  j[1][0] = f21/det; j[1][1] = m11/det;
+}
+
 void GeoAlign::mountToObservedPlace(Coordinate *coord) {
   if (!modelIsReady) return;
 
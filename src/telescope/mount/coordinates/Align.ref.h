@@ -79,6 +79,20 @@ class GeoAlign
     // reports if ready for operation
     bool modelReady();
 
+    #if ALIGN_MODEL_SLOTS != OFF
+      // selects pointing model slot (0 to ALIGN_MODEL_SLOTS - 1) and loads its model, the selection is kept
+      // in NV (along with a copy of the model) so it's restored at startup
+      bool modelSlotSelect(uint8_t slot);
+      // gets the selected pointing model slot
+      uint8_t modelSlot();
+      // saves the alignment model to the selected slot
+      void modelSlotWrite();
+      // gets the name of a slot, up to 7 characters
+      bool modelSlotGetName(uint8_t slot, char *name);
+      // names the selected slot, up to 7 characters
+      bool modelSlotSetName(const char *name);
+    #endif
+
     // add a star to an alignment model
     // thisStar: 1 for 1st star, 2 for 2nd star, etc. up to numberStars (at which point the mount model is calculated)
     // numberStars: total number of stars for this align (1 to 9)
@@ -92,6 +106,9 @@ class GeoAlign
     void observedPlaceToMount(Coordinate *coord);
     // convert equatorial (h,d) or horizon (a,z) coordinate from mount to observed place
     void mountToObservedPlace(Coordinate *coord);
+    // partial derivatives of observedPlaceToMount() with respect to the observed place at this mount coordinate
+    // j[0] is for axis1 and j[1] for axis2, identity if there is no model
+    void observedPlaceToMountJacobian(Coordinate *coord, float j[2][2]);
 
     void autoModel(int n);
 
@@ -0,0 +1,58 @@
+// -----------------------------------------------------------------------------------
+// GOTO ASSIST NAMED POINTING MODEL SLOTS
+//
+// each slot holds a name and a copy of the alignment model, the selected slot's model is also kept at
+// NV_ALIGN_MODEL_BASE so the usual modelRead() restores it at startup
+
+#include "Transform.h"
+
+#if defined(MOUNT_PRESENT) && ALIGN_MAX_NUM_STARS > 1 && ALIGN_MODEL_SLOTS != OFF
+
+#define AlignModelSlotSize 40
+#define AlignModelSlotNameSize 8
+
+bool GeoAlign::modelSlotSelect(uint8_t slot) {
+  if (slot >= ALIGN_MODEL_SLOTS) return false;
+  if (AlignModelSlotNameSize + AlignModelSize > AlignModelSlotSize) { nv.initError = true; DL("ERR: GeoAlign::modelSlotSelect(), AlignModelSlotSize error"); return false; }
+
+  nv.readBytes(NV_ALIGN_SLOTS_BASE + 1 + slot*AlignModelSlotSize + AlignModelSlotNameSize, &model, AlignModelSize);
+  nv.write(NV_ALIGN_SLOTS_BASE, slot);
+
+  // the active copy is what gets restored at startup, reading it back range checks the terms
+  modelWrite();
+  modelRead();
+  VF("MSG: Mount, align model slot "); V(slot); VLF(" selected");
+  return true;
+}
+
+uint8_t GeoAlign::modelSlot() {
+  uint8_t slot = nv.readUC(NV_ALIGN_SLOTS_BASE);
+  if (slot >= ALIGN_MODEL_SLOTS) slot = 0;
+  return slot;
+}
+
+void GeoAlign::modelSlotWrite() {
+  nv.updateBytes(NV_ALIGN_SLOTS_BASE + 1 + modelSlot()*AlignModelSlotSize + AlignModelSlotNameSize, &model, AlignModelSize);
+}
+
+bool GeoAlign::modelSlotGetName(uint8_t slot, char *name) {
+  if (slot >= ALIGN_MODEL_SLOTS) return false;
+  nv.readBytes(NV_ALIGN_SLOTS_BASE + 1 + slot*AlignModelSlotSize, name, AlignModelSlotNameSize);
+  name[AlignModelSlotNameSize - 1] = 0;
+
+  // an unset slot (or erased NV) has no name
+  for (int i = 0; name[i] != 0; i++) if (name[i] < ' ' || name[i] > '~') { name[0] = 0; break; }
+  return true;
+}
+
+bool GeoAlign::modelSlotSetName(const char *name) {
+  if (strlen(name) > AlignModelSlotNameSize - 1) return false;
+  for (int i = 0; name[i] != 0; i++) if (name[i] < ' ' || name[i] > '~' || name[i] == '#') return false;
+
+  char slotName[AlignModelSlotNameSize] = "";
+  strcpy(slotName, name);
+  nv.updateBytes(NV_ALIGN_SLOTS_BASE + 1 + modelSlot()*AlignModelSlotSize, slotName, AlignModelSlotNameSize);
+  return true;
+}
+
+#endif
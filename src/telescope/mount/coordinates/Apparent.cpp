@@ -0,0 +1,84 @@
+// -----------------------------------------------------------------------------------
+// J2000 mean place to apparent place (precession, nutation, and annual aberration)
+
+#include "Apparent.h"
+
+#if defined(MOUNT_PRESENT) && LIBRARY_APPARENT == ON
+
+#define arcsecToRad(x) ((x)*4.84813681109536e-6)
+
+void Apparent::update(JulianDate julianDate) {
+  // nothing here moves by more than a fraction of an arc-second in a day
+  if (julianDate.day == day) return;
+  day = julianDate.day;
+
+  double T = ((julianDate.day - 2451545.0) + julianDate.hour/24.0)/36525.0;
+
+  // precession, IAU 1976
+  double zeta  = arcsecToRad((2306.2181 + (0.30188 + 0.017998*T)*T)*T);
+  double z     = arcsecToRad((2306.2181 + (1.09468 + 0.018203*T)*T)*T);
+  double theta = arcsecToRad((2004.3109 - (0.42665 + 0.041833*T)*T)*T);
+  double cZeta = cos(zeta), sZeta = sin(zeta);
+  double cZ = cos(z), sZ = sin(z);
+  double cTheta = cos(theta), sTheta = sin(theta);
+  double p[3][3] = {
+    { cZeta*cZ*cTheta - sZeta*sZ, -sZeta*cZ*cTheta - cZeta*sZ, -cZ*sTheta},
+    { cZeta*sZ*cTheta + sZeta*cZ, -sZeta*sZ*cTheta + cZeta*cZ, -sZ*sTheta},
+    { cZeta*sTheta,               -sZeta*sTheta,                cTheta}
+  };
+
+  // nutation, the four largest terms (to about 0.5")
+  double O  = degToRad(125.04452 - 1934.136261*T);
+  double L  = degToRad(280.4665 + 36000.7698*T);
+  double L1 = degToRad(218.3165 + 481267.8813*T);
+  double dPsi = arcsecToRad(-17.20*sin(O) - 1.32*sin(2.0*L) - 0.23*sin(2.0*L1) + 0.21*sin(2.0*O));
+  double dEps = arcsecToRad(9.20*cos(O) + 0.57*cos(2.0*L) + 0.10*cos(2.0*L1) - 0.09*cos(2.0*O));
+  double eps0 = degToRad(23.4392911 - 0.0130042*T);
+  double eps = eps0 + dEps;
+  double cPsi = cos(dPsi), sPsi = sin(dPsi);
+  double cE0 = cos(eps0), sE0 = sin(eps0);
+  double cE = cos(eps), sE = sin(eps);
+  double n[3][3] = {
+    { cPsi,     -sPsi*cE0,                -sPsi*sE0},
+    { sPsi*cE,   cPsi*cE*cE0 + sE*sE0,     cPsi*cE*sE0 - sE*cE0},
+    { sPsi*sE,   cPsi*sE*cE0 - cE*sE0,     cPsi*sE*sE0 + cE*cE0}
+  };
+
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) m[i][j] = n[i][0]*p[0][j] + n[i][1]*p[1][j] + n[i][2]*p[2][j];
+  }
+
+  // annual aberration, Earth moves 90 degrees behind the Sun's longitude at about 20.5"
+  double M = degToRad(357.52911 + 35999.05029*T);
+  double sun = degToRad(280.46646 + 36000.76983*T + 1.914602*sin(M) + 0.019993*sin(2.0*M));
+  double k = arcsecToRad(20.49552);
+  v[0] = k*sin(sun);
+  v[1] = -k*cos(sun)*cE;
+  v[2] = -k*cos(sun)*sE;
+
+  VF("MSG: Apparent, place correction updated for JD "); VL(day);
+}
+
+void Apparent::fromJ2000(double *ra, double *dec) {
+  double u[3] = {cos(*dec)*cos(*ra), cos(*dec)*sin(*ra), sin(*dec)};
+  double w[3];
+  for (int i = 0; i < 3; i++) w[i] = m[i][0]*u[0] + m[i][1]*u[1] + m[i][2]*u[2] + v[i];
+
+  *ra = atan2(w[1], w[0]);
+  if (*ra < 0.0) *ra += Deg360;
+  *dec = atan2(w[2], sqrt(w[0]*w[0] + w[1]*w[1]));
+}
+
+void Apparent::toJ2000(double *ra, double *dec) {
+  double w[3] = {cos(*dec)*cos(*ra) - v[0], cos(*dec)*sin(*ra) - v[1], sin(*dec) - v[2]};
+  double u[3];
+  for (int i = 0; i < 3; i++) u[i] = m[0][i]*w[0] + m[1][i]*w[1] + m[2][i]*w[2];
+
+  *ra = atan2(u[1], u[0]);
+  if (*ra < 0.0) *ra += Deg360;
+  *dec = atan2(u[2], sqrt(u[0]*u[0] + u[1]*u[1]));
+}
+
+Apparent apparent;
+
+#endif
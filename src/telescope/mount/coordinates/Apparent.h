@@ -0,0 +1,30 @@
+// -----------------------------------------------------------------------------------
+// J2000 mean place to apparent place (precession, nutation, and annual aberration)
+#pragma once
+
+#include "../../../Common.h"
+
+#if defined(MOUNT_PRESENT) && LIBRARY_APPARENT == ON
+
+#include "../../../lib/calendars/Calendars.h"
+
+class Apparent {
+  public:
+    // work out the rotation and aberration for this date, they're kept until the date changes
+    void update(JulianDate julianDate);
+
+    // J2000 mean RA/Dec to apparent RA/Dec of date, in radians
+    void fromJ2000(double *ra, double *dec);
+
+    // apparent RA/Dec of date to J2000 mean RA/Dec, in radians
+    void toJ2000(double *ra, double *dec);
+
+  private:
+    double day = 0.0;     // Julian day the matrix is for
+    double m[3][3];       // precession then nutation, J2000 mean to true equator and equinox of date
+    double v[3];          // Earth's velocity in units of c, true equator and equinox of date
+};
+
+extern Apparent apparent;
+
+#endif
@@ -8,11 +8,19 @@
 #include "../../../libApp/weather/Weather.h"
 #include "../../Telescope.h"
 
-extern volatile unsigned long fracLAST;
-
 #define fsToRad(x) ((x)/(13750.98708313976*FRACTIONAL_SEC))
 #define radToFs(x) ((x)*(13750.98708313976*FRACTIONAL_SEC))
 
+// math for the TransformReal type the HAL selects
+static inline float sinT(float x) { return sinf(x); }
+static inline double sinT(double x) { return sin(x); }
+static inline float cosT(float x) { return cosf(x); }
+static inline double cosT(double x) { return cos(x); }
+static inline float sqrtT(float x) { return sqrtf(x); }
+static inline double sqrtT(double x) { return sqrt(x); }
+static inline float atan2T(float y, float x) { return atan2f(y, x); }
+static inline double atan2T(double y, double x) { return atan2(y, x); }
+
 #if DEBUG != OFF
   void Transform::print(Coordinate *coord) {
     VF("(a="); V(radToDeg(coord->a)); VF(", z="); V(radToDeg(coord->z));
@@ -48,6 +56,13 @@ void Transform::init() {
 
   if (mountType == ALTAZM) meridianFlips = false; else meridianFlips = true;
 
+  #ifdef REFRACTION_TABLE
+    // the weather only scales refraction so the table holds the refraction at 1010mb and 10C
+    for (int i = 0; i < REFRACTION_TABLE_SIZE; i++) {
+      refractionTable[i] = trueRefracUnscaled(degToRadF(REFRACTION_TABLE_FIRST + REFRACTION_TABLE_STEP*(i - 1)));
+    }
+  #endif
+
   #if ALIGN_MAX_NUM_STARS > 1
     align.init(mountType, site.location.latitude);
   #endif
@@ -200,61 +215,104 @@ void Transform::mountToInstrument(Coordinate *coord, double *a1, double *a2) {
 }
 
 void Transform::hourAngleToRightAscension(Coordinate *coord, bool native) {
-  noInterrupts();
-  unsigned long fs = fracLAST;
-  interrupts();
+  double fs = getFracLASTExact();
   coord->r = fsToRad(fs) - coord->h;
   if (native) coord->r = backInRads(coord->r);
 }
 
 void Transform::rightAscensionToHourAngle(Coordinate *coord, bool native) {
   if (isnan(coord->r)) return; // NAN flags mount coordinates
-  noInterrupts();
-  unsigned long fs = fracLAST;
-  interrupts();
+  double fs = getFracLASTExact();
   coord->h = fsToRad(fs) - coord->r;
   if (native) coord->h = backInRads2(coord->h);
 }
 
+void Transform::rightAscensionToHourAngleN(Coordinate *coords, int count, bool native) {
+  double fs = getFracLASTExact();
+  double last = fsToRad(fs);
+  for (int i = 0; i < count; i++) {
+    if (isnan(coords[i].r)) continue;
+    coords[i].h = last - coords[i].r;
+    if (native) coords[i].h = backInRads2(coords[i].h);
+  }
+}
+
+void Transform::equToHorN(Coordinate *coords, int count) {
+  for (int i = 0; i < count; i++) equToHor(&coords[i]);
+}
+
+void Transform::equToAltN(Coordinate *coords, int count) {
+  for (int i = 0; i < count; i++) equToAlt(&coords[i]);
+}
+
+void Transform::horToEquN(Coordinate *coords, int count) {
+  for (int i = 0; i < count; i++) horToEqu(&coords[i]);
+}
+
 void Transform::equToHor(Coordinate *coord) {
-  double cosHA  = cos(coord->h);
-  double sinAlt = sin(coord->d)*site.locationEx.latitude.sine + cos(coord->d)*site.locationEx.latitude.cosine*cosHA;  
-  coord->a      = asin(sinAlt);
-  double t1     = sin(coord->h);
-  double t2     = cosHA*site.locationEx.latitude.sine - tan(coord->d)*site.locationEx.latitude.cosine;
+  TransformReal sinLat = site.locationEx.latitude.sine;
+  TransformReal cosLat = site.locationEx.latitude.cosine;
+  TransformReal cosHA  = cosT((TransformReal)coord->h);
+  TransformReal sinDec = sinT((TransformReal)coord->d);
+  TransformReal cosDec = cosT((TransformReal)coord->d);
+  TransformReal sinAlt = sinDec*sinLat + cosDec*cosLat*cosHA;
+  TransformReal t1     = sinT((TransformReal)coord->h)*cosDec;
+  TransformReal t2     = cosHA*sinLat*cosDec - sinDec*cosLat;
+  // atan2 rather than asin keeps full precision near the zenith
+  coord->a             = atan2T(sinAlt, sqrtT(t1*t1 + t2*t2));
   // handle degenerate coordinates near the poles
   if (fabs(coord->d - Deg90) < TenthArcSec) coord->z = 0.0; else
   if (fabs(coord->d + Deg90) < TenthArcSec) coord->z = Deg180; else {
-    coord->z = atan2(t1, t2);
+    coord->z = atan2T(t1, t2);
     coord->z += Deg180;
   }
   if (coord->z > Deg180) coord->z -= Deg360;
 }
 
 void Transform::equToAlt(Coordinate *coord) {
-  double cosHA  = cos(coord->h);
-  double sinAlt = sin(coord->d)*site.locationEx.latitude.sine + cos(coord->d)*site.locationEx.latitude.cosine*cosHA;  
-  coord->a      = asin(sinAlt);
+  TransformReal sinLat = site.locationEx.latitude.sine;
+  TransformReal cosLat = site.locationEx.latitude.cosine;
+  TransformReal cosHA  = cosT((TransformReal)coord->h);
+  TransformReal sinDec = sinT((TransformReal)coord->d);
+  TransformReal cosDec = cosT((TransformReal)coord->d);
+  TransformReal sinAlt = sinDec*sinLat + cosDec*cosLat*cosHA;
+  TransformReal t1     = sinT((TransformReal)coord->h)*cosDec;
+  TransformReal t2     = cosHA*sinLat*cosDec - sinDec*cosLat;
+  coord->a             = atan2T(sinAlt, sqrtT(t1*t1 + t2*t2));
 }
 
 void Transform::horToEqu(Coordinate *coord) { 
-  double cosAzm = cos(coord->z);
-  double sinDec = sin(coord->a)*site.locationEx.latitude.sine + cos(coord->a)*site.locationEx.latitude.cosine*cosAzm;  
-  coord->d      = asin(sinDec); 
-  double t1     = sin(coord->z);
-  double t2     = cosAzm*site.locationEx.latitude.sine - tan(coord->a)*site.locationEx.latitude.cosine;
-  coord->h      = atan2(t1,t2);
-  coord->h     += Deg180;
+  TransformReal sinLat = site.locationEx.latitude.sine;
+  TransformReal cosLat = site.locationEx.latitude.cosine;
+  TransformReal cosAzm = cosT((TransformReal)coord->z);
+  TransformReal sinAlt = sinT((TransformReal)coord->a);
+  TransformReal cosAlt = cosT((TransformReal)coord->a);
+  TransformReal sinDec = sinAlt*sinLat + cosAlt*cosLat*cosAzm;
+  TransformReal t1     = sinT((TransformReal)coord->z)*cosAlt;
+  TransformReal t2     = cosAzm*sinLat*cosAlt - sinAlt*cosLat;
+  // atan2 rather than asin keeps full precision near the poles
+  coord->d             = atan2T(sinDec, sqrtT(t1*t1 + t2*t2));
+  coord->h             = atan2T(t1, t2);
+  coord->h            += Deg180;
   if (coord->h > Deg180) coord->h -= Deg360;
 }
 
 double Transform::trueRefrac(double altitude) {
-  float pressure = 1010.0F;
-  float temperature = 10.0F;
-  if (!isnan(weather.getPressure())) pressure = weather.getPressure();
-  if (!isnan(weather.getTemperature())) temperature = weather.getTemperature();
-  float TPC = (pressure/1010.0F)*(283.0F/(273.0F + temperature));
-  float r   = 2.9670597e-4F*cotf(altitude + 0.0031375594F/(altitude + 0.089186324F))*TPC;
+  #ifdef REFRACTION_TABLE
+    // cubic (Catmull-Rom) interpolation, outside of the table the formula is used
+    float x = (radToDegF(altitude) - REFRACTION_TABLE_FIRST)/REFRACTION_TABLE_STEP;
+    if (x >= 0.0F && x < REFRACTION_TABLE_SIZE - 3) {
+      int i = (int)x;
+      float t = x - i;
+      float p0 = refractionTable[i], p1 = refractionTable[i + 1], p2 = refractionTable[i + 2], p3 = refractionTable[i + 3];
+      return (p1 + 0.5F*t*(p2 - p0 + t*(2.0F*p0 - 5.0F*p1 + 4.0F*p2 - p3 + t*(3.0F*(p1 - p2) + p3 - p0))))*refractionScale();
+    }
+  #endif
+  return trueRefracUnscaled(altitude)*refractionScale();
+}
+
+float Transform::trueRefracUnscaled(float altitude) {
+  float r = 2.9670597e-4F*cotf(altitude + 0.0031375594F/(altitude + 0.089186324F));
   if (r < 0.0F) r = 0.0F;
   return r;
 }
@@ -264,6 +322,100 @@ double Transform::apparentRefrac(double altitude) {
   return trueRefrac(altitude - r);
 }
 
+float Transform::trueRefracRate(double altitude) {
+  float u = altitude + 0.089186324F;
+  float v = altitude + 0.0031375594F/u;
+  if (v <= 0.0F || v >= Deg90) return 0.0F;
+  float sinV = sinf(v);
+  return -2.9670597e-4F*(1.0F - 0.0031375594F/(u*u))/(sinV*sinV)*refractionScale();
+}
+
+void Transform::topocentricToMountRates(Coordinate *topocentric, Coordinate *mount, bool refraction, bool model, float rateH, float rateD, float *rate1, float *rate2) {
+  float j[2][2] = {{1.0F, 0.0F}, {0.0F, 1.0F}};
+
+  // topocentric to observed place, only the altitude is changed by refraction
+  if (mountType == ALTAZM || refraction) {
+    Coordinate horizon = *topocentric;
+    equToHor(&horizon);
+    rotationJacobian(topocentric->h, topocentric->d, j);
+    if (refraction) {
+      float scale = 1.0F + trueRefracRate(horizon.a);
+      j[1][0] *= scale;
+      j[1][1] *= scale;
+      horizon.a += trueRefrac(horizon.a);
+    }
+    if (mountType != ALTAZM) {
+      float r[2][2];
+      rotationJacobian(horizon.z, horizon.a, r);
+      jacobianMultiply(r, j);
+    }
+  }
+
+  // observed place to mount
+  #if ALIGN_MAX_NUM_STARS > 1
+    if (model && mount->pierSide != PIER_SIDE_NONE) {
+      float m[2][2];
+      align.observedPlaceToMountJacobian(mount, m);
+      jacobianMultiply(m, j);
+    }
+  #else
+    (void)(*mount);
+    (void)(model);
+  #endif
+
+  *rate1 = j[0][0]*rateH + j[0][1]*rateD;
+  *rate2 = j[1][0]*rateH + j[1][1]*rateD;
+}
+
+void Transform::rotationJacobian(double x, double y, float j[2][2]) {
+  float sinX = sinf(x);
+  float cosX = cosf(x);
+  float sinY = sinf(y);
+  float cosY = cosf(y);
+  float sinLat = site.locationEx.latitude.sine;
+  float cosLat = site.locationEx.latitude.cosine;
+
+  // same form as used in equToHor() and horToEqu()
+  float sinOutY = sinY*sinLat + cosY*cosLat*cosX;
+  float cosOutY = sqrtf(1.0F - sinOutY*sinOutY);
+  float t2 = cosX*sinLat - (sinY/cosY)*cosLat;
+  float n = sinX*sinX + t2*t2;
+
+  // degenerate near the poles and zenith
+  if (cosOutY < 1.0e-6F || n < 1.0e-12F || fabs(cosY) < 1.0e-6F) {
+    j[0][0] = 1.0F; j[0][1] = 0.0F;
+    j[1][0] = 0.0F; j[1][1] = 1.0F;
+    return;
+  }
+
+  j[0][0] = (cosX*t2 + sinX*sinX*sinLat)/n;
+  j[0][1] = (sinX*cosLat)/(cosY*cosY*n);
+  j[1][0] = -(cosY*cosLat*sinX)/cosOutY;
+  j[1][1] = (cosY*sinLat - sinY*cosLat*cosX)/cosOutY;
+}
+
+void Transform::jacobianMultiply(float a[2][2], float b[2][2]) {
+  float b00 = b[0][0], b01 = b[0][1], b10 = b[1][0], b11 = b[1][1];
+  b[0][0] = a[0][0]*b00 + a[0][1]*b10;
+  b[0][1] = a[0][0]*b01 + a[0][1]*b11;
+  b[1][0] = a[1][0]*b00 + a[1][1]*b10;
+  b[1][1] = a[1][0]*b01 + a[1][1]*b11;
+}
+
+float Transform::refractionScale() {
+  // the scale is worked out again only when Weather reports a big enough change
+  uint8_t change = weather.getChangeCount();
+  if (change != refractionChange) {
+    refractionChange = change;
+    float pressure = weather.getPressure();
+    float temperature = weather.getTemperature();
+    if (isnan(pressure)) pressure = 1010.0F;
+    if (isnan(temperature)) temperature = 10.0F;
+    refractionTPC = (pressure/1010.0F)*(283.0F/(273.0F + temperature));
+  }
+  return refractionTPC;
+}
+
 float Transform::cotf(float n) {
   return 1.0F/tanf(n);
 }
@@ -16,6 +16,22 @@
 // MOUNT      <--> apply pointing model                   <--> OBSERVED    (Transform)
 // OBSERVED   <--> apply refraction                       <--> TOPOCENTRIC (Transform)
 
+// coordinate transform math is done in double precision unless the FPU only supports single precision,
+// the sidereal time and coordinates themselves are always kept in double
+#ifdef HAL_SINGLE_PRECISION_FPU
+  typedef float TransformReal;
+#else
+  typedef double TransformReal;
+#endif
+
+// on slower processors refraction is interpolated from a table
+#ifndef HAL_FAST_PROCESSOR
+  #define REFRACTION_TABLE
+  #define REFRACTION_TABLE_FIRST -1.0F // altitude of the second entry, in degrees
+  #define REFRACTION_TABLE_STEP  0.5F  // in degrees
+  #define REFRACTION_TABLE_SIZE  185   // covers -1 to 91 degrees
+#endif
+
 class Transform {
   public:
     // setup for coordinate transformation
@@ -66,6 +82,13 @@ class Transform {
     // converts from Equatorial (h,d) to Horizon (a,z) coordinates
     void horToEqu(Coordinate *coord);
 
+    // batch versions of the above for an array of count coordinates, shared work (site latitude
+    // trig and the sidereal time) is done once for the whole array
+    void rightAscensionToHourAngleN(Coordinate *coords, int count, bool native);
+    void equToHorN(Coordinate *coords, int count);
+    void equToAltN(Coordinate *coords, int count);
+    void horToEquN(Coordinate *coords, int count);
+
     // refraction at altitude, pressure (millibars), and temperature (celsius)
     // returns amount of refraction at the true altitude
     double trueRefrac(double altitude);
@@ -73,6 +96,14 @@ class Transform {
     // returns the amount of refraction at the apparent altitude
     double apparentRefrac(double altitude);
 
+    // derivative of trueRefrac() with respect to the true altitude
+    float trueRefracRate(double altitude);
+
+    // rates of motion in mount coordinates (rate1 for h or z, rate2 for d or a) for a topocentric motion (rateH, rateD)
+    // topocentric and mount are the same position in each coordinate system, the rates are worked out analytically
+    // from the partial derivatives for refraction (optional) and the pointing model (optional)
+    void topocentricToMountRates(Coordinate *topocentric, Coordinate *mount, bool refraction, bool model, float rateH, float rateD, float *rate1, float *rate2);
+
     #if ALIGN_MAX_NUM_STARS > 1  
       GeoAlign align;
     #endif
@@ -82,6 +113,23 @@ class Transform {
   private:
 
     float cotf(float n);
+
+    // refraction at the true altitude for 1010mb and 10C
+    float trueRefracUnscaled(float altitude);
+    #ifdef REFRACTION_TABLE
+      float refractionTable[REFRACTION_TABLE_SIZE];
+    #endif
+
+    // partial derivatives of the rotation in equToHor() or horToEqu() at x (h or z) and y (d or a)
+    // j[0] is for the output h or z and j[1] for the output d or a
+    void rotationJacobian(double x, double y, float j[2][2]);
+    // b = a*b for 2x2 Jacobians
+    void jacobianMultiply(float a[2][2], float b[2][2]);
+
+    // refraction scale factor for the current pressure and temperature
+    float refractionScale();
+    uint8_t refractionChange = 0;
+    float refractionTPC = 1.0F;  // 1010mb and 10C until the first change
     
     // adjust coordinate back into 0 to 360 "degrees" range (in radians)
     double backInRads(double angle);
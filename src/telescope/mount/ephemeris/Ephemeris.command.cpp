@@ -0,0 +1,43 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount ephemeris commands
+
+#include "Ephemeris.h"
+
+#if defined(MOUNT_PRESENT) && EPHEMERIS == ON
+
+#include "../goto/Goto.h"
+
+bool Ephemeris::command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError) {
+  *supressFrame = false;
+  (void)(reply);
+
+  // body n is 0 Sun, 1 Moon, 2 Mercury, 3 Venus, 4 Mars, 5 Jupiter, 6 Saturn, 7 Uranus, 8 Neptune
+  if ((command[0] == 'L' || command[0] == 'T') && command[1] == 'P' && parameter[0] != 0) {
+    if (parameter[1] != 0 || parameter[0] < '0' || parameter[0] > '8') { *commandError = CE_PARAM_RANGE; return true; }
+    EphemerisBody body = (EphemerisBody)(parameter[0] - '0');
+
+    // :LP[n]#    Set goto target to solar system body n, as it is now
+    //            Return: 0 on failure
+    //                    1 on success
+    if (command[0] == 'L') {
+      #if GOTO_FEATURE == ON
+        Coordinate target = goTo.getGotoTarget();
+        position(body, 0.0, &target.r, &target.d);
+        goTo.setGotoTarget(&target);
+      #else
+        *commandError = CE_CMD_UNKNOWN;
+      #endif
+    } else
+
+    // :TP[n]#    Track solar system body n, the RA/Dec rate offsets follow it until tracking stops or they're changed
+    //            Return: 0 on failure (not tracking or no date/time)
+    //                    1 on success
+    {
+      *commandError = track(body);
+    }
+  } else return false;
+
+  return true;
+}
+
+#endif
@@ -0,0 +1,243 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount ephemeris, Sun, Moon, and planets
+
+#include "Ephemeris.h"
+
+#if defined(MOUNT_PRESENT) && EPHEMERIS == ON
+
+#include "../../../lib/tasks/OnTask.h"
+
+#include "../Mount.h"
+#include "../site/Site.h"
+
+#define EARTH_RADIUS_KM 6378.14
+#define AU_KM           149597870.7
+#define LIGHT_DAYS_AU   0.0057755183
+
+// J2000 elements and rates per century: a (AU), e, I, L, long. of perihelion, long. of node (degrees)
+static const double elements[8][12] = {
+  { 0.38709927, 0.20563593,  7.00497902, 252.25032350,  77.45779628,  48.33076593,
+    0.00000037, 0.00001906, -0.00594749, 149472.67411175, 0.16047689, -0.12534081 },
+  { 0.72333566, 0.00677672,  3.39467605, 181.97909950, 131.60246718,  76.67984255,
+    0.00000390,-0.00004107, -0.00078890, 58517.81538729, 0.00268329, -0.27769418 },
+  { 1.00000261, 0.01671123, -0.00001531, 100.46457166, 102.93768193,   0.0,
+    0.00000562,-0.00004392, -0.01294668, 35999.37244981, 0.32327364,  0.0 },
+  { 1.52371034, 0.09339410,  1.84969142,  -4.55343205, -23.94362959,  49.55953891,
+    0.00001847, 0.00007882, -0.00813131, 19140.30268499, 0.44441088, -0.29257343 },
+  { 5.20288700, 0.04838624,  1.30439695,  34.39644051,  14.72847983, 100.47390909,
+   -0.00011607,-0.00013253, -0.00183714,  3034.74612775, 0.21252668,  0.20469106 },
+  { 9.53667594, 0.05386179,  2.48599187,  49.95424423,  92.59887831, 113.66242448,
+   -0.00125060,-0.00050991,  0.00193609,  1222.49362201,-0.41897216, -0.28867794 },
+  {19.18916464, 0.04725744,  0.77263783, 313.23810451, 170.95427630,  74.01692503,
+   -0.00196176,-0.00004397, -0.00242939,   428.48202785, 0.40805281,  0.04240589 },
+  {30.06992276, 0.00859048,  1.77004347, -55.12002969,  44.96476227, 131.78422574,
+    0.00026291, 0.00005105,  0.00035372,   218.45945325,-0.32241464, -0.01262724 }
+};
+
+// Moon longitude (1e-6 degrees) and distance (m) terms: multiples of D, M, M', F
+typedef struct MoonTermLR { int8_t d, m, mp, f; int32_t l, r; } MoonTermLR;
+static const MoonTermLR moonLR[] = {
+  {0, 0, 1, 0, 6288774,-20905355}, {2, 0,-1, 0, 1274027, -3699111}, {2, 0, 0, 0, 658314, -2955968},
+  {0, 0, 2, 0,  213618,  -569925}, {0, 1, 0, 0, -185116,    48888}, {0, 0, 0, 2,-114332,    -3149},
+  {2, 0,-2, 0,   58793,   246158}, {2,-1,-1, 0,   57066,  -152138}, {2, 0, 1, 0,  53322,  -170733},
+  {2,-1, 0, 0,   45758,  -204586}, {0, 1,-1, 0,  -40923,  -129620}, {1, 0, 0, 0, -34720,   108743},
+  {0, 1, 1, 0,  -30383,   104755}, {2, 0, 0,-2,   15327,    10321}, {0, 0, 1, 2, -12528,        0},
+  {0, 0, 1,-2,   10980,    79661}, {4, 0,-1, 0,   10675,   -34782}, {0, 0, 3, 0,  10034,   -23210},
+  {4, 0,-2, 0,    8548,   -21636}, {2, 1,-1, 0,   -7888,    24208}, {2, 1, 0, 0,  -6766,    30824},
+  {1, 0,-1, 0,   -5163,    -8379}, {1, 1, 0, 0,    4987,   -16675}, {2,-1, 1, 0,   4036,   -12831},
+  {2, 0, 2, 0,    3994,   -10445}, {4, 0, 0, 0,    3861,   -11650}, {2, 0,-3, 0,   3665,    14403},
+  {0, 1,-2, 0,   -2689,    -7003}, {2, 0,-1, 2,   -2602,        0}, {2,-1,-2, 0,   2390,    10056},
+  {1, 0, 1, 0,   -2348,     6322}, {2,-2, 0, 0,    2236,    -9884}
+};
+
+// Moon latitude terms (1e-6 degrees): multiples of D, M, M', F
+typedef struct MoonTermB { int8_t d, m, mp, f; int32_t b; } MoonTermB;
+static const MoonTermB moonB[] = {
+  {0, 0, 0, 1, 5128122}, {0, 0, 1, 1, 280602}, {0, 0, 1,-1, 277693}, {2, 0, 0,-1, 173237}, {2, 0,-1, 1, 55413},
+  {2, 0,-1,-1,   46271}, {2, 0, 0, 1,  32573}, {0, 0, 2, 1,  17198}, {2, 0, 1,-1,   9266}, {0, 0, 2,-1,  8822},
+  {2,-1, 0,-1,    8216}, {2, 0,-2,-1,   4324}, {2, 0, 1, 1,   4200}, {2, 1, 0,-1,  -3359}, {2,-1,-1, 1,  2463},
+  {2,-1, 0, 1,    2211}, {2,-1,-1,-1,   2065}, {0, 1,-1,-1,  -1870}, {4, 0,-1,-1,   1828}, {0, 1, 0, 1, -1794},
+  {0, 0, 0, 3,   -1749}, {0, 1,-1, 1,  -1565}, {1, 0, 0, 1,  -1491}, {0, 1, 1, 1,  -1475}, {0, 1, 1,-1, -1410},
+  {0, 1, 0,-1,   -1344}, {1, 0, 0,-1,  -1335}, {0, 0, 3, 1,   1107}, {4, 0, 0,-1,   1021}, {4, 0,-1, 1,   833}
+};
+
+void ephemerisWrapper() { ephemeris.poll(); }
+
+void Ephemeris::init() {
+  VF("MSG: Mount, start ephemeris task (rate "); V(EPHEMERIS_PERIOD_MS); VF("ms priority 7)... ");
+  if (tasks.add(EPHEMERIS_PERIOD_MS, 0, true, 7, ephemerisWrapper, "Ephem")) { VLF("success"); } else { VLF("FAILED!"); }
+}
+
+void Ephemeris::position(EphemerisBody body, double seconds, double *ra, double *dec) {
+  JulianDate now = site.getDateTime();
+  double T = ((now.day - 2451545.0) + (now.hour*3600.0 + seconds + EPHEMERIS_DELTA_T)/86400.0)/36525.0;
+
+  // nutation (largest terms) and the obliquity of date
+  double omega = degToRad(125.04452 - 1934.136261*T);
+  double sunL = degToRad(280.4665 + 36000.7698*T);
+  double nutationLongitude = arcsecToRad(-17.20*sin(omega) - 1.32*sin(2.0*sunL));
+  double obliquity = degToRad(23.439291 - 0.0130042*T) + arcsecToRad(9.20*cos(omega) + 0.57*cos(2.0*sunL));
+
+  double lambda, beta, distance;
+  if (body == EB_MOON) {
+    moon(T, &lambda, &beta, &distance);
+    lambda = degToRad(lambda) + nutationLongitude;
+    beta = degToRad(beta);
+  } else {
+    double ex, ey, ez;
+    heliocentric(2, T, &ex, &ey, &ez);
+
+    double x = -ex, y = -ey, z = -ez;
+    if (body != EB_SUN) {
+      // once around for light time is plenty at this precision
+      int n = body - EB_MERCURY; if (n >= 2) n++;
+      double px, py, pz;
+      heliocentric(n, T, &px, &py, &pz);
+      double tau = sqrt((px - ex)*(px - ex) + (py - ey)*(py - ey) + (pz - ez)*(pz - ez))*LIGHT_DAYS_AU;
+      heliocentric(n, T - tau/36525.0, &px, &py, &pz);
+      x = px - ex; y = py - ey; z = pz - ez;
+    }
+    distance = sqrt(x*x + y*y + z*z)*AU_KM;
+    lambda = atan2(y, x);
+    beta = atan2(z, sqrt(x*x + y*y));
+
+    // J2000 ecliptic to the ecliptic of date, then annual aberration
+    double precession = degToRad(1.396971*T);
+    double sunLambda = atan2(-ey, -ex) + precession;
+    lambda += precession;
+    double elongation = sunLambda - lambda;
+    lambda += arcsecToRad(-20.4955)*cos(elongation)/cos(beta) + nutationLongitude;
+    beta += arcsecToRad(-20.4955)*sin(elongation)*sin(beta);
+  }
+
+  // ecliptic to equatorial
+  double a = atan2(sin(lambda)*cos(obliquity) - tan(beta)*sin(obliquity), cos(lambda));
+  double d = asin(sin(beta)*cos(obliquity) + cos(beta)*sin(obliquity)*sin(lambda));
+
+  // geocentric to topocentric
+  double latitude = site.location.latitude;
+  double u = atan(0.99664719*tan(latitude));
+  double h = site.location.elevation/(EARTH_RADIUS_KM*1000.0);
+  double rhoSine = 0.99664719*sin(u) + h*sin(latitude);
+  double rhoCosine = cos(u) + h*cos(latitude);
+  double parallax = EARTH_RADIUS_KM/distance;
+  double last = hrsToRad(site.getSiderealTime() + seconds*SIDEREAL_RATIO/3600.0);
+  double ha = last - a;
+  double denominator = cos(d) - rhoCosine*parallax*cos(ha);
+  double deltaA = atan2(-rhoCosine*parallax*sin(ha), denominator);
+  d = atan2((sin(d) - rhoSine*parallax)*cos(deltaA), denominator);
+  a += deltaA;
+
+  a = fmod(a, Deg360); if (a < 0.0) a += Deg360;
+  *ra = a;
+  *dec = d;
+}
+
+CommandError Ephemeris::track(EphemerisBody body) {
+  if (!site.isDateTimeReady()) return CE_0;
+  if (!mount.isTracking()) return CE_0;
+
+  VF("MSG: Mount, ephemeris tracking body "); VL(body);
+  tracking = body;
+  mount.trackingRate = hzToSidereal(SIDEREAL_RATE_HZ);
+  updateRates();
+  return CE_NONE;
+}
+
+void Ephemeris::poll() {
+  if (tracking == EB_NONE) return;
+
+  // stopping or any other rate change ends following the body
+  if (!mount.isTracking() || mount.trackingRateOffsetRA != offsetRA || mount.trackingRateOffsetDec != offsetDec) {
+    VLF("MSG: Mount, ephemeris tracking stopped");
+    tracking = EB_NONE;
+    return;
+  }
+
+  updateRates();
+}
+
+void Ephemeris::updateRates() {
+  // rates for the middle of the period ahead
+  double center = EPHEMERIS_PERIOD_MS/2000.0;
+  double ra1, dec1, ra2, dec2;
+  position(tracking, center - EPHEMERIS_RATE_SPAN/2.0, &ra1, &dec1); Y;
+  position(tracking, center + EPHEMERIS_RATE_SPAN/2.0, &ra2, &dec2); Y;
+
+  double deltaRA = ra2 - ra1;
+  if (deltaRA > Deg180) deltaRA -= Deg360; else if (deltaRA < -Deg180) deltaRA += Deg360;
+
+  // to sidereal units, 1x = 15 arc-seconds/sidereal second
+  double siderealSeconds = EPHEMERIS_RATE_SPAN*SIDEREAL_RATIO;
+  offsetRA = (deltaRA/siderealSeconds)/siderealToRad(1.0);
+  offsetDec = ((dec2 - dec1)/siderealSeconds)/siderealToRad(1.0);
+
+  mount.trackingRateOffsetRA = offsetRA;
+  mount.trackingRateOffsetDec = offsetDec;
+  mount.update();
+}
+
+void Ephemeris::heliocentric(int n, double T, double *x, double *y, double *z) {
+  const double *el = elements[n];
+  double a = el[0] + el[6]*T;
+  double e = el[1] + el[7]*T;
+  double I = degToRad(el[2] + el[8]*T);
+  double L = el[3] + el[9]*T;
+  double w = el[4] + el[10]*T;
+  double node = el[5] + el[11]*T;
+
+  double M = degToRad(fmod(L - w, 360.0));
+  double omega = degToRad(w - node);
+  double O = degToRad(node);
+
+  // Kepler's equation
+  double E = M + e*sin(M);
+  for (int i = 0; i < 5; i++) E -= (E - e*sin(E) - M)/(1.0 - e*cos(E));
+
+  double xp = a*(cos(E) - e);
+  double yp = a*sqrt(1.0 - e*e)*sin(E);
+
+  double cw = cos(omega), sw = sin(omega), cO = cos(O), sO = sin(O), cI = cos(I), sI = sin(I);
+  *x = (cw*cO - sw*sO*cI)*xp + (-sw*cO - cw*sO*cI)*yp;
+  *y = (cw*sO + sw*cO*cI)*xp + (-sw*sO + cw*cO*cI)*yp;
+  *z = (sw*sI)*xp + (cw*sI)*yp;
+}
+
+void Ephemeris::moon(double T, double *lambda, double *beta, double *distance) {
+  double Lp = 218.3164477 + 481267.88123421*T - 0.0015786*T*T;
+  double D  = degToRad(297.8501921 + 445267.1114034*T - 0.0018819*T*T);
+  double M  = degToRad(357.5291092 + 35999.0502909*T - 0.0001536*T*T);
+  double Mp = degToRad(134.9633964 + 477198.8675055*T + 0.0087414*T*T);
+  double F  = degToRad(93.2720950 + 483202.0175233*T - 0.0036539*T*T);
+  double A1 = degToRad(119.75 + 131.849*T);
+  double A2 = degToRad(53.09 + 479264.290*T);
+  double A3 = degToRad(313.45 + 481266.484*T);
+  double E = 1.0 - 0.002516*T - 0.0000074*T*T;
+
+  double sl = 0.0, sr = 0.0, sb = 0.0;
+  for (unsigned int i = 0; i < sizeof(moonLR)/sizeof(moonLR[0]); i++) {
+    const MoonTermLR *t = &moonLR[i];
+    double arg = t->d*D + t->m*M + t->mp*Mp + t->f*F;
+    double k = t->m == 0 ? 1.0 : (abs(t->m) == 1 ? E : E*E);
+    sl += k*t->l*sin(arg);
+    sr += k*t->r*cos(arg);
+  }
+  for (unsigned int i = 0; i < sizeof(moonB)/sizeof(moonB[0]); i++) {
+    const MoonTermB *t = &moonB[i];
+    double arg = t->d*D + t->m*M + t->mp*Mp + t->f*F;
+    double k = t->m == 0 ? 1.0 : (abs(t->m) == 1 ? E : E*E);
+    sb += k*t->b*sin(arg);
+  }
+
+  double LpR = degToRad(Lp);
+  sl += 3958.0*sin(A1) + 1962.0*sin(LpR - F) + 318.0*sin(A2);
+  sb += -2235.0*sin(LpR) + 382.0*sin(A3) + 175.0*sin(A1 - F) + 175.0*sin(A1 + F) + 127.0*sin(LpR - Mp) - 115.0*sin(LpR + Mp);
+
+  *lambda = Lp + sl/1000000.0;
+  *beta = sb/1000000.0;
+  *distance = 385000.56 + sr/1000.0;
+}
+
+Ephemeris ephemeris;
+
+#endif
@@ -0,0 +1,50 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount ephemeris, Sun, Moon, and planets
+#pragma once
+
+#include "../../../Common.h"
+
+#if defined(MOUNT_PRESENT) && EPHEMERIS == ON
+
+#define EPHEMERIS_PERIOD_MS 60000   // how often the tracking rates are worked out again
+#define EPHEMERIS_RATE_SPAN 600.0   // in seconds, positions this far apart give the rates
+#define EPHEMERIS_DELTA_T   69.2    // TT - UT1 in seconds
+
+enum EphemerisBody: uint8_t {EB_SUN, EB_MOON, EB_MERCURY, EB_VENUS, EB_MARS, EB_JUPITER, EB_SATURN, EB_URANUS, EB_NEPTUNE, EB_NONE};
+
+// low precision positions, the planets from Keplerian elements (JPL, good to an arc-minute or so 1800 to 2050) and
+// the Moon from the largest terms of ELP-2000 (Meeus), all for the apparent place and topocentric
+class Ephemeris {
+  public:
+    void init();
+
+    bool command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
+
+    // topocentric apparent RA/Dec (in radians) of a body some seconds from now
+    void position(EphemerisBody body, double seconds, double *ra, double *dec);
+
+    // track a body, the tracking rate offsets follow it until something else changes them
+    CommandError track(EphemerisBody body);
+
+    // works out the tracking rate offsets again
+    void poll();
+
+    // the body being tracked, EB_NONE if none
+    EphemerisBody tracking = EB_NONE;
+
+  private:
+    // heliocentric ecliptic (J2000) position in AU for planet n (0 Mercury ... 7 Neptune, 2 is the Earth-Moon barycenter)
+    void heliocentric(int n, double T, double *x, double *y, double *z);
+
+    // Moon geocentric ecliptic longitude and latitude of date (degrees) and distance (km)
+    void moon(double T, double *lambda, double *beta, double *distance);
+
+    void updateRates();
+
+    float offsetRA = 0.0F;   // the tracking rate offsets last set
+    float offsetDec = 0.0F;
+};
+
+extern Ephemeris ephemeris;
+
+#endif
@@ -17,14 +17,52 @@ bool Goto::command(char *reply, char *command, char *parameter, bool *supressFra
   PrecisionMode precisionMode = PM_HIGH;
 
   if (command[0] == 'A') {
-    // :AW#       Align Write to EEPROM
+    // :AW#       Align Write to EEPROM (and to the selected model slot if ALIGN_MODEL_SLOTS is enabled)
     //            Returns: 1 on success
     if (command[1] == 'W' && parameter[0] == 0) {
       #if ALIGN_MAX_NUM_STARS > 1  
         transform.align.modelWrite();
+        #if ALIGN_MODEL_SLOTS != OFF
+          transform.align.modelSlotWrite();
+        #endif
       #endif
     } else
 
+    #if ALIGN_MAX_NUM_STARS > 1 && ALIGN_MODEL_SLOTS != OFF
+      // :AM#       Get selected pointing model slot
+      //            Returns: n,name#
+      //            where n is the slot (0 to ALIGN_MODEL_SLOTS - 1) and name is up to 7 characters
+      if (command[1] == 'M' && parameter[0] == 0) {
+        char name[8];
+        uint8_t slot = transform.align.modelSlot();
+        transform.align.modelSlotGetName(slot, name);
+        sprintf(reply, "%d,%s", (int)slot, name);
+        *numericReply = false;
+      } else
+
+      // :AM[n]#    Select pointing model slot n (0 to ALIGN_MODEL_SLOTS - 1) and switch to its model
+      //            Return: 0 on failure
+      //                    1 on success
+      if (command[1] == 'M' && parameter[0] >= '0' && parameter[0] <= '9' && parameter[1] == 0) {
+        if (alignActive()) *commandError = CE_ALIGN_FAIL; else
+        if (goTo.state != GS_NONE) *commandError = CE_SLEW_IN_MOTION; else
+        if (!transform.align.modelSlotSelect(parameter[0] - '0')) *commandError = CE_PARAM_RANGE;
+      } else
+
+      // :AML[n]#   Get name of pointing model slot n
+      //            Returns: name#
+      if (command[1] == 'M' && parameter[0] == 'L' && parameter[1] >= '0' && parameter[1] <= '9' && parameter[2] == 0) {
+        if (transform.align.modelSlotGetName(parameter[1] - '0', reply)) *numericReply = false; else *commandError = CE_PARAM_RANGE;
+      } else
+
+      // :AMN[name]# Set name of the selected pointing model slot, up to 7 characters
+      //            Return: 0 on failure
+      //                    1 on success
+      if (command[1] == 'M' && parameter[0] == 'N') {
+        if (!transform.align.modelSlotSetName(&parameter[1])) *commandError = CE_PARAM_FORM;
+      } else
+    #endif
+
     // :A?#       Align status
     //            Returns: mno#
     //            where m is the maximum number of alignment stars
@@ -38,6 +76,22 @@ bool Goto::command(char *reply, char *command, char *parameter, bool *supressFra
       *numericReply = false;
     } else
 
+    // :A?P#      Align pointing model fit progress
+    //            Returns: p,s# while a fit is running, 0 otherwise
+    //            where p is the percent complete and s is the estimated seconds remaining (0 until known)
+    if (command[1] == '?' && parameter[0] == 'P' && parameter[1] == 0) {
+      #if ALIGN_MAX_NUM_STARS > 1
+        int percent;
+        long seconds;
+        if (transform.align.fitProgress(&percent, &seconds)) {
+          sprintf(reply, "%d,%ld", percent, seconds);
+          *numericReply = false;
+        } else *commandError = CE_0;
+      #else
+        *commandError = CE_0;
+      #endif
+    } else
+
     // :A[n]#     Start Telescope Manual Alignment Sequence
     //            This is to initiate a n-star alignment for 1..MAX_NUM_ALIGN_STARS:
     //            1) Before calling this function, the telescope should be in the polar-home position
@@ -97,9 +151,19 @@ bool Goto::command(char *reply, char *command, char *parameter, bool *supressFra
           DLF("ERR: Mount, failed to add align point");
         } else { VLF("MSG: Mount, align point added"); }
       } else {
-      PierSideSelect pps = settings.preferredPierSide;
-      if (!mount.isHome() && PIER_SIDE_SYNC_CHANGE_SIDES == OFF) pps = PSS_SAME_ONLY;
-      e = requestSync(gotoTarget, pps);
+      e = CE_ALIGN_FAIL;
+      #if ALIGN_REFINE == ON
+        // after an align the sync adds a star to refine the model, or falls back to a sync if it can't
+        if (alignDone()) {
+          e = alignRefineStar();
+          if (e == CE_NONE) { VLF("MSG: Mount, align point added for refinement"); }
+        }
+      #endif
+      if (e != CE_NONE) {
+        PierSideSelect pps = settings.preferredPierSide;
+        if (!mount.isHome() && PIER_SIDE_SYNC_CHANGE_SIDES == OFF) pps = PSS_SAME_ONLY;
+        e = requestSync(gotoTarget, pps);
+      }
     }
     if (command[1] == 'M') {
       if (e >= CE_SLEW_ERR_BELOW_HORIZON && e <= CE_SLEW_ERR_UNSPECIFIED) strcpy(reply,"E0");
@@ -304,6 +368,48 @@ bool Goto::command(char *reply, char *command, char *parameter, bool *supressFra
       } else *commandError = CE_CMD_UNKNOWN;
     } else
 
+    #if GOTO_FEATURE == ON && GOTO_QUEUE != OFF
+      // :MQA[h],[d],[s]#  Add a target to the goto queue, RA in hours [h], Dec in degrees [d], dwell in seconds [s]
+      //                   (a dwell of 0 waits for :MQN# before moving on)
+      //                   Returns: 0 on failure (queue full) or 1 on success
+      // :MQC#             Clear the goto queue and stop the sequence (any goto in progress carries on)
+      //                   Returns: 1
+      // :MQS#             Start the sequence at the first target in the goto queue
+      //                   Returns: 0..9, see :MS#
+      // :MQN#             Move on to the next target in the goto queue
+      //                   Returns: 0 if the sequence isn't running or 1 on success
+      // :MQ?#             Get the goto queue status
+      //                   Returns: n,i,r# where n is the number of targets, i the position (1..n), and r 1 if running
+      if (command[1] == 'Q') {
+        if (parameter[0] == 'A') {
+          char *conv_end;
+          double h = strtod(&parameter[1], &conv_end);
+          if (*conv_end != ',') { *commandError = CE_PARAM_FORM; return true; }
+          double d = strtod(conv_end + 1, &conv_end);
+          if (*conv_end != ',') { *commandError = CE_PARAM_FORM; return true; }
+          long dwell = strtol(conv_end + 1, &conv_end, 10);
+          if (*conv_end != 0) { *commandError = CE_PARAM_FORM; return true; }
+          if (h < 0.0 || h >= 24.0 || d < -90.0 || d > 90.0 || dwell < 0 || dwell > 65535) { *commandError = CE_PARAM_RANGE; return true; }
+          if (!queueAdd(hrsToRad(h), degToRad(d), dwell)) *commandError = CE_0;
+        } else
+        if (parameter[0] == 'C' && parameter[1] == 0) queueClear(); else
+        if (parameter[0] == 'S' && parameter[1] == 0) {
+          CommandError e = queueStart();
+          strcpy(reply,"0");
+          if (e >= CE_SLEW_ERR_BELOW_HORIZON && e <= CE_SLEW_ERR_UNSPECIFIED) reply[0] = (char)(e - CE_SLEW_ERR_BELOW_HORIZON) + '1';
+          if (e == CE_SLEW_IN_SLEW) reply[0] = '5';
+          *numericReply = false;
+          *supressFrame = true;
+          *commandError = e;
+        } else
+        if (parameter[0] == 'N' && parameter[1] == 0) { if (queueActive()) queueNext(); else *commandError = CE_0; } else
+        if (parameter[0] == '?' && parameter[1] == 0) {
+          sprintf(reply, "%d,%d,%d", (int)queueLength(), queueActive() ? (int)queuePosition() + 1 : 0, (int)queueActive());
+          *numericReply = false;
+        } else *commandError = CE_PARAM_FORM;
+      } else
+    #endif
+
     // :MS#       Goto the Target Object
     //            Returns:
     //              0=goto is possible
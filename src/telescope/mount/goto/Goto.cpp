@@ -6,6 +6,7 @@
 #if defined(MOUNT_PRESENT)
 
 #include "../../../lib/tasks/OnTask.h"
+#include "../../../lib/counters/Counters.h"
 
 #include "../../Telescope.h"
 #include "../Mount.h"
@@ -18,6 +19,10 @@
 
 #if GOTO_FEATURE == ON
 inline void gotoWrapper() { goTo.poll(); }
+void gotoAxisEventWrapper(Axis *axis, AxisEvent event) { goTo.axisEvent(axis, event); }
+#if GOTO_QUEUE != OFF
+  inline void gotoQueueWrapper() { goTo.queuePoll(); }
+#endif
 #endif
 
 void Goto::init() {
@@ -33,6 +38,8 @@ void Goto::init() {
   // read the settings
   nv.readBytes(NV_MOUNT_GOTO_BASE, &settings, sizeof(GotoSettings));
 
+  abortCounter = counters.add("GtAbort");
+
   // force defaults if needed
   #if MFLIP_PAUSE_HOME_MEMORY != ON
     settings.meridianFlipPause = (MFLIP_PAUSE_HOME_DEFAULT == ON);
@@ -59,11 +66,16 @@ void Goto::init() {
   if (settings.usPerStepCurrent < usPerStepBase/2.0F) settings.usPerStepCurrent = usPerStepBase/2.0F;
   if (settings.usPerStepCurrent > usPerStepBase*2.0F) settings.usPerStepCurrent = usPerStepBase*2.0F;
 
-  if (AXIS1_SYNC_THRESHOLD != OFF || AXIS2_SYNC_THRESHOLD != OFF) absoluteEncodersPresent = true;
+  if (AXIS1_SYNC_THRESHOLD != OFF || AXIS2_SYNC_THRESHOLD != OFF ||
+      AXIS1_ENCODER_ABSOLUTE == ON || AXIS2_ENCODER_ABSOLUTE == ON) absoluteEncodersPresent = true;
   if (AXIS1_HOME_TOLERANCE != 0.0F || AXIS2_HOME_TOLERANCE != 0.0F ||
       AXIS1_TARGET_TOLERANCE != 0.0F || AXIS2_TARGET_TOLERANCE != 0.0F || absoluteEncodersPresent) encodersPresent = true;
 
   updateAccelerationRates();
+
+  #if GOTO_FEATURE == ON
+    Axis::onEvent(gotoAxisEventWrapper);
+  #endif
 }
 
 // goto to equatorial target position (Native coordinate system) using the defaut preferredPierSide
@@ -85,6 +97,11 @@ CommandError Goto::request(Coordinate coords, PierSideSelect pierSideSelect, boo
   if (e == CE_SLEW_IN_SLEW) { abort(); return e; }
   if (e != CE_NONE) return e;
 
+  // plan the route and check it against the limits before anything moves
+  Coordinate current = mount.getMountPosition(CR_MOUNT_HOR);
+  e = planRoute(&current);
+  if (e != CE_NONE) { stage = GG_NONE; return e; }
+
   lastAlignTarget = target;
 
   // handle special case of a tangent arm mount
@@ -115,21 +132,30 @@ CommandError Goto::request(Coordinate coords, PierSideSelect pierSideSelect, boo
       slewDestinationDistDec = degToRad(GOTO_OFFSET);
       if (target.pierSide == PIER_SIDE_WEST) slewDestinationDistDec = -slewDestinationDistDec;
     }
-  }
 
-  // prepare for goto
-  Coordinate current = mount.getMountPosition(CR_MOUNT_HOR);
-  state = GS_GOTO;
-  stage = GG_NEAR_DESTINATION_START;
-  start = current;
-  destination = target;
+    // arriving where the target is leaves nothing to refine unless it's also an approach from one direction
+    #if GOTO_PREDICTIVE == ON
+      if (transform.mountType != ALTAZM && GOTO_OFFSET == 0.0) nearDestinationRefineStages = 0;
+    #endif
+  }
 
-  // add waypoint if needed
-  if (transform.mountType != ALTAZM && MFLIP_SKIP_HOME == OFF && start.pierSide != destination.pierSide) {
-    VLF("MSG: Mount, goto changes pier side, setting waypoint at home");
-    waypoint(&current);
+  // park and home go in one slew, with an optional final low speed approach from one direction
+  parkHomeFast = GOTO_PARK_HOME_FAST == ON && (park.state == PS_PARKING || home.state == HS_HOMING);
+  if (parkHomeFast) {
+    nearDestinationRefineStages = 0;
+    slewDestinationDistHA = 0.0;
+    slewDestinationDistDec = 0.0;
+    if (transform.mountType != ALTAZM && GOTO_PARK_HOME_APPROACH > 0.0) {
+      nearDestinationRefineStages = 1;
+      slewDestinationDistHA = degToRad(GOTO_PARK_HOME_APPROACH);
+      slewDestinationDistDec = degToRad(GOTO_PARK_HOME_APPROACH);
+      if (target.pierSide == PIER_SIDE_WEST) slewDestinationDistDec = -slewDestinationDistDec;
+    }
   }
 
+  // prepare for goto, the route is already set
+  state = GS_GOTO;
+
   // start the goto monitor
   if (taskHandle != 0) tasks.remove(taskHandle);
   taskHandle = tasks.add(0, 0, true, 3, gotoWrapper, "MntGoto");
@@ -146,6 +172,12 @@ CommandError Goto::request(Coordinate coords, PierSideSelect pierSideSelect, boo
     tasks.setPeriodMicros(taskHandle, FRACTIONAL_SEC_US);
     VF("MSG: Mount, goto monitor task set rate "); V(FRACTIONAL_SEC_US); VL("us");
 
+    // the goto monitor is only watched while a goto is underway
+    #ifdef WATCHDOG_PRESENT
+      if (heartbeatHandle == 0) heartbeatHandle = watchdog.heartbeatRegister("MntGoto");
+      watchdog.heartbeat(heartbeatHandle);
+    #endif
+
     mountStatus.sound.alert();
 
   } else { DLF("WRN: Mount, start goto monitor task... FAILED!"); }
@@ -338,7 +370,10 @@ CommandError Goto::setTarget(Coordinate *coords, PierSideSelect pierSideSelect,
 
 // stop any presently active goto
 void Goto::abort() {
-  if (state == GS_GOTO && stage > GG_READY_ABORT) stage = GG_READY_ABORT;
+  if (state == GS_GOTO && stage > GG_READY_ABORT) { stage = GG_READY_ABORT; counters.increment(abortCounter); }
+  #if GOTO_FEATURE == ON && GOTO_QUEUE != OFF
+    if (queueRunning) { VLF("MSG: Mount, goto queue stopped by abort"); queueStop(); }
+  #endif
 }
 
 // general status checks ahead of sync or goto
@@ -388,6 +423,22 @@ CommandError Goto::alignAddStar() {
   return e;
 }
 
+// add a star to a finished alignment (at the current position relative to target) and refine the model
+CommandError Goto::alignRefineStar() {
+  #if ALIGN_MAX_NUM_STARS > 1
+    Coordinate mountPosition = mount.getMountPosition(CR_MOUNT_ALL);
+
+    // update the targets HA and Horizon coords as necessary
+    Coordinate alignTarget = lastAlignTarget;
+    transform.rightAscensionToHourAngle(&alignTarget, true);
+    if (transform.mountType == ALTAZM) transform.equToHor(&alignTarget);
+
+    return transform.align.refineStar(&alignTarget, &mountPosition);
+  #else
+    return CE_ALIGN_FAIL;
+  #endif
+}
+
 // reset the alignment model
 void Goto::alignReset() {
   alignState.currentStar = 0;
@@ -398,6 +449,54 @@ void Goto::alignReset() {
 }
 
 #if GOTO_FEATURE == ON
+// set the start, waypoints, and destination for a goto and check each leg against the limits
+CommandError Goto::planRoute(Coordinate *current) {
+  start = *current;
+  stage = GG_NEAR_DESTINATION_START;
+  destination = target;
+
+  // add waypoint if needed
+  bool flip = transform.mountType != ALTAZM && MFLIP_SKIP_HOME == OFF && start.pierSide != destination.pierSide;
+  if (flip) {
+    VLF("MSG: Mount, goto changes pier side, setting waypoint at home");
+    waypoint(current);
+  }
+
+  CommandError e = validateRoute();
+  if (e == CE_NONE || flip || transform.mountType == ALTAZM) return e;
+
+  // a straight slew that runs into a limit can often go by way of the home position instead
+  stage = GG_WAYPOINT_HOME;
+  destination = home.position;
+  if (validateRoute() == CE_NONE) {
+    VLF("MSG: Mount, goto path blocked, setting waypoint at home");
+    return CE_NONE;
+  }
+  return e;
+}
+
+// check each leg of the planned route against the limits
+CommandError Goto::validateRoute() {
+  Coordinate from = start;
+  Coordinate to;
+  CommandError e;
+
+  // the legs into waypoints are on the starting side of the pier
+  if (stage == GG_WAYPOINT_AVOID) {
+    to = destination;
+    to.pierSide = start.pierSide;
+    if ((e = limits.validatePath(&from, &to)) != CE_NONE) return e;
+    from = to;
+  }
+  if (stage == GG_WAYPOINT_AVOID || stage == GG_WAYPOINT_HOME) {
+    to = home.position;
+    to.pierSide = start.pierSide;
+    if ((e = limits.validatePath(&from, &to)) != CE_NONE) return e;
+    from = to;
+  }
+  return limits.validatePath(&from, &target);
+}
+
 // set any additional destinations required for a goto
 void Goto::waypoint(Coordinate *current) {
   // HA goes from +90...0..-90
@@ -432,8 +531,66 @@ void Goto::waypoint(Coordinate *current) {
   }
 }
 
+#if GOTO_WAYPOINT_BLEND == ON
+// move on to the next destination without stopping once both axes are slowing for the waypoint
+void Goto::waypointBlend() {
+  Coordinate next;
+  if (stage == GG_WAYPOINT_AVOID) next = home.position; else
+  if (stage == GG_WAYPOINT_HOME && !settings.meridianFlipPause) next = target; else return;
+  if (stage == GG_WAYPOINT_HOME && parkHomeFast) {
+    next.h -= slewDestinationDistHA;
+    next.d -= slewDestinationDistDec;
+  }
+
+  if (axis1.isSlewing() && !axis1.autoGotoBraking()) return;
+  if (axis2.isSlewing() && !axis2.autoGotoBraking()) return;
+
+  // an axis that would have to reverse needs the full stop at the waypoint
+  double a1, a2;
+  transform.mountToInstrument(&next, &a1, &a2);
+  if (!waypointContinues(&axis1, a1) || !waypointContinues(&axis2, a2)) return;
+
+  if (stage == GG_WAYPOINT_AVOID) {
+    VLF("MSG: Mount, goto waypoint passed");
+    stage = GG_WAYPOINT_HOME;
+  } else {
+    VLF("MSG: Mount, goto home passed");
+    meridianFlipHome.paused = false;
+    meridianFlipHome.resume = false;
+    stage = GG_NEAR_DESTINATION_START;
+  }
+  destination = next;
+
+  // the limits are monitored as usual along the way
+  if (axis1.isSlewing()) axis1.autoGotoRetarget(a1); else { axis1.setTargetCoordinate(a1); axis1.autoGoto(); }
+  if (axis2.isSlewing()) axis2.autoGotoRetarget(a2); else { axis2.setTargetCoordinate(a2); axis2.autoGoto(); }
+
+  nearTargetTimeoutAxis1 = tasks.deadline(15000);
+  nearTargetTimeoutAxis2 = tasks.deadline(15000);
+}
+
+// returns true if the axis can carry on to value without reversing
+bool Goto::waypointContinues(Axis *axis, double value) {
+  if (!axis->isSlewing()) return true;
+  double position = axis->getInstrumentCoordinate();
+  double distance = axis->getTargetCoordinate() - position;
+  double nextDistance = value - position;
+  return (distance >= 0.0) == (nextDistance >= 0.0) && fabs(nextDistance) >= fabs(distance);
+}
+#endif
+
+// the goto monitor runs right away when either axis stops, rather than on its next pass
+void Goto::axisEvent(Axis *axis, AxisEvent event) {
+  if (taskHandle == 0 || (axis != &axis1 && axis != &axis2)) return;
+  if (event == AE_TARGET_REACHED || event == AE_SLEW_STOP || event == AE_ABORTED) tasks.immediate(taskHandle);
+}
+
 // monitor goto
 void Goto::poll() {
+  #ifdef WATCHDOG_PRESENT
+    watchdog.heartbeat(heartbeatHandle);
+  #endif
+
   if (stage == GG_READY_ABORT) {
     VLF("MSG: Mount, goto abort requested");
     stage = GG_ABORT;
@@ -445,20 +602,24 @@ void Goto::poll() {
 
   // abort any goto that might hang!
   if (axis1.isSlewing()) {
-    if (!axis1.nearTarget()) nearTargetTimeoutAxis1 = millis();
-    if ((long)(millis() - nearTargetTimeoutAxis1) > 15000) {
+    if (!axis1.nearTarget()) nearTargetTimeoutAxis1 = tasks.deadline(15000);
+    if (tasks.expired(nearTargetTimeoutAxis1)) {
       DLF("WRN: Mount, goto axis1 timed out aborting slew!");
       axis1.autoSlewAbort();
     }
   }
   if (axis2.isSlewing()) {
-    if (!axis2.nearTarget()) nearTargetTimeoutAxis2 = millis();
-    if ((long)(millis() - nearTargetTimeoutAxis2) > 15000) {
+    if (!axis2.nearTarget()) nearTargetTimeoutAxis2 = tasks.deadline(15000);
+    if (tasks.expired(nearTargetTimeoutAxis2)) {
       DLF("WRN: Mount, goto axis2 timed out aborting slew!");
       axis2.autoSlewAbort();
     }
   }
 
+  #if GOTO_WAYPOINT_BLEND == ON
+    if (mount.isSlewing()) waypointBlend();
+  #endif
+
   if (!mount.isSlewing()) {
     if (stage == GG_WAYPOINT_AVOID) {
       VLF("MSG: Mount, goto waypoint reached");
@@ -479,15 +640,24 @@ void Goto::poll() {
     } else
 
     if (stage == GG_NEAR_DESTINATION_START) {
+      if (parkHomeFast) stage = GG_NEAR_DESTINATION; else
       if (nearDestinationRefineStages >= 1) {
         VLF("MSG: Mount, goto near destination wait started");
-        nearDestinationTimeout = millis() + GOTO_SETTLE_TIME;
+        nearDestinationTimeout = tasks.deadline(GOTO_SETTLE_TIME);
         stage = GG_NEAR_DESTINATION_WAIT;
+
+        // the refine move direction is known, take up backlash toward it while settling
+        Coordinate refine = target;
+        double a1, a2;
+        transform.mountToInstrument(&refine, &a1, &a2);
+        if (MOUNT_TYPE == ALTAZM) a1 += azimuthTargetCorrection;
+        axis1.setBacklashPreload(a1 > axis1.getInstrumentCoordinate() ? DIR_FORWARD : DIR_REVERSE);
+        axis2.setBacklashPreload(a2 > axis2.getInstrumentCoordinate() ? DIR_FORWARD : DIR_REVERSE);
       } else stage = GG_NEAR_DESTINATION;
     } else
 
     if (stage == GG_NEAR_DESTINATION_WAIT) {
-      if ((long)(millis() - nearDestinationTimeout) > 0) {
+      if (tasks.expired(nearDestinationTimeout)) {
         VLF("MSG: Mount, goto near destination wait done");
         stage = GG_NEAR_DESTINATION;
       }
@@ -516,9 +686,18 @@ void Goto::poll() {
       state = GS_NONE;
       mount.update();
 
+      // restore the full acceleration rates after a coordinated goto
+      #if GOTO_COORDINATED == ON
+        axis1.setSlewAccelerationRate(radsPerSecondPerSecondAxis1);
+        axis2.setSlewAccelerationRate(radsPerSecondPerSecondAxis2);
+      #endif
+
       // kill this monitor
       tasks.setDurationComplete(taskHandle);
       taskHandle = 0;
+      #ifdef WATCHDOG_PRESENT
+        watchdog.heartbeatIdle(heartbeatHandle);
+      #endif
       VLF("MSG: Mount, goto monitor task terminated");
 
       // check if parking and mark as finished or unparked as needed
@@ -544,18 +723,24 @@ void Goto::poll() {
 
   // keep updating the axis targets to match the mount target
   // but allow timeout to stop tracking to guarantee synchronization
-  if (AXIS1_TARGET_TOLERANCE != 0.0F || AXIS2_TARGET_TOLERANCE != 0.0F || !axis1.nearTarget() || !axis2.nearTarget()) nearTargetTimeout = millis();
+  if (AXIS1_TARGET_TOLERANCE != 0.0F || AXIS2_TARGET_TOLERANCE != 0.0F || !axis1.nearTarget() || !axis2.nearTarget()) nearTargetTimeout = tasks.deadline(5000);
 
   if (mount.isTracking()) {
     target.r += siderealToRad(mount.trackingRateOffsetRA)/FRACTIONAL_SEC;
     target.d += siderealToRad(mount.trackingRateOffsetDec)/FRACTIONAL_SEC;
     transform.rightAscensionToHourAngle(&target, false);
     if (stage >= GG_NEAR_DESTINATION_START) {
-      if (millis() - nearTargetTimeout < 5000) {
+      if (!tasks.expired(nearTargetTimeout)) {
         Coordinate nearTarget = target;
         nearTarget.h -= slewDestinationDistHA;
         nearTarget.d -= slewDestinationDistDec;
 
+        #if GOTO_PREDICTIVE == ON
+          // keep aiming where the target will be on arrival
+          long remaining = (long)(arrivalTime - millis());
+          if (remaining > 0 && transform.mountType != ALTAZM) predict(&nearTarget, remaining/1000.0F);
+        #endif
+
         if (transform.mountType == ALTAZM) transform.equToHor(&nearTarget);
 
         double a1, a2;
@@ -569,22 +754,163 @@ void Goto::poll() {
   }
 }
 
+#if GOTO_QUEUE != OFF
+// add a target to the end of the goto queue, returns false if the queue is full
+bool Goto::queueAdd(double r, double d, uint16_t dwell) {
+  if (queueCount >= GOTO_QUEUE) return false;
+  queue[queueCount].r = r;
+  queue[queueCount].d = d;
+  queue[queueCount].dwell = dwell;
+  queueCount++;
+  return true;
+}
+
+// empty the goto queue and end the sequence, a goto in progress carries on
+void Goto::queueClear() {
+  queueStop();
+  queueCount = 0;
+  queueIndex = 0;
+}
+
+// start the sequence at the first target in the goto queue
+CommandError Goto::queueStart() {
+  if (queueRunning) return CE_SLEW_IN_SLEW;
+  if (queueCount == 0) return CE_SLEW_ERR_UNSPECIFIED;
+
+  queueIndex = 0;
+  CommandError e = queueGoto();
+  if (e != CE_NONE) return e;
+
+  queueRunning = true;
+  if (queueTaskHandle == 0) {
+    VF("MSG: Mount, start goto queue monitor task (rate 100ms priority 7)... ");
+    queueTaskHandle = tasks.add(100, 0, true, 7, gotoQueueWrapper, "MntGtoQ");
+    if (queueTaskHandle) { VLF("success"); } else { VLF("FAILED!"); }
+  }
+  return CE_NONE;
+}
+
+// goto the target at the present position in the queue
+CommandError Goto::queueGoto() {
+  VF("MSG: Mount, goto queue target "); VL(queueIndex + 1);
+  gotoTarget.r = queue[queueIndex].r;
+  gotoTarget.d = queue[queueIndex].d;
+  queueArrived = false;
+  queueTrigger = false;
+  return request(gotoTarget, settings.preferredPierSide);
+}
+
+// end the sequence
+void Goto::queueStop() {
+  queueRunning = false;
+  if (queueTaskHandle != 0) {
+    tasks.setDurationComplete(queueTaskHandle);
+    queueTaskHandle = 0;
+  }
+}
+
+// monitor the goto queue sequence
+void Goto::queuePoll() {
+  if (!queueRunning) return;
+
+  // parking or homing takes over the mount
+  if (park.state != PS_UNPARKED || home.state == HS_HOMING) {
+    VLF("MSG: Mount, goto queue stopped by park or home");
+    queueStop();
+    return;
+  }
+
+  if (state != GS_NONE) return;
+
+  if (!queueArrived) {
+    queueArrived = true;
+    queueArrivalTime = millis();
+    queueTrigger = false;
+    return;
+  }
+
+  uint16_t dwell = queue[queueIndex].dwell;
+  if (dwell == 0 ? !queueTrigger : (long)(millis() - queueArrivalTime) < dwell*1000L) return;
+
+  if (++queueIndex >= queueCount) {
+    VLF("MSG: Mount, goto queue done");
+    queueStop();
+    return;
+  }
+
+  CommandError e = queueGoto();
+  if (e != CE_NONE) {
+    DF("WRN: Mount, goto queue stopped, goto failed with error "); DL(e);
+    queueStop();
+  }
+}
+#endif
+
+#if GOTO_COORDINATED == ON || GOTO_PREDICTIVE == ON
+// time in seconds for an axis to slew a distance at the given rate and acceleration
+static float slewTime(float distance, float rate, float accel) {
+  if (rate <= 0.0F || accel <= 0.0F) return 0.0F;
+  if (distance >= rate*rate/accel) return distance/rate + rate/accel;
+  return 2.0F*sqrtf(distance/accel);
+}
+#endif
+
+#if GOTO_PREDICTIVE == ON
+// move a tracked coordinate ahead by the given time in seconds
+void Goto::predict(Coordinate *coord, float seconds) {
+  coord->h += (siderealToRad(1.0) - siderealToRad(mount.trackingRateOffsetRA))*seconds;
+  coord->d += siderealToRad(mount.trackingRateOffsetDec)*seconds;
+}
+#endif
+
 // start slews with approach correction and parking/homing support
 CommandError Goto::startAutoSlew() {
   CommandError e;
 
-  nearTargetTimeoutAxis1 = millis();
-  nearTargetTimeoutAxis2 = millis();
+  nearTargetTimeoutAxis1 = tasks.deadline(15000);
+  nearTargetTimeoutAxis2 = tasks.deadline(15000);
 
   if (stage == GG_NEAR_DESTINATION || stage == GG_DESTINATION) {
     destination.h -= slewDestinationDistHA;
     destination.d -= slewDestinationDistDec;
   }
 
+  float rate1 = radsPerSecondCurrent;
+  if (parkHomeFast) {
+    // the approach is at a tenth of the current rate, everything else at the fastest rate allowed
+    if (stage == GG_DESTINATION) rate1 = radsPerSecondCurrent/10.0F; else {
+      rate1 = (1000000.0F/(usPerStepBase/2.0F))/(float)axis1.getStepsPerMeasure();
+      // not tracking, so the approach offset is only applied here
+      if (stage == GG_NEAR_DESTINATION_START) {
+        destination.h -= slewDestinationDistHA;
+        destination.d -= slewDestinationDistDec;
+      }
+    }
+  }
+  float rate2 = rate1*((float)(AXIS2_SLEW_RATE_PERCENT)/100.0F);
+  #if GOTO_AXIS_RATES == ON
+    if (rate1 > radsPerSecondMaxAxis1) rate1 = radsPerSecondMaxAxis1;
+    if (rate2 > radsPerSecondMaxAxis2) rate2 = radsPerSecondMaxAxis2;
+  #endif
+
   double a1, a2;
   transform.mountToInstrument(&destination, &a1, &a2);
   if (MOUNT_TYPE == ALTAZM) a1 += azimuthTargetCorrection;
 
+  #if GOTO_PREDICTIVE == ON
+    // aim where the target will be once the slower axis gets there
+    arrivalTime = millis();
+    if (stage >= GG_NEAR_DESTINATION_START && mount.isTracking() && park.state != PS_PARKING && transform.mountType != ALTAZM) {
+      float t1 = slewTime(fabs(a1 - axis1.getInstrumentCoordinate()), rate1, radsPerSecondPerSecondAxis1);
+      float t2 = slewTime(fabs(a2 - axis2.getInstrumentCoordinate()), rate2, radsPerSecondPerSecondAxis2);
+      float seconds = t1 > t2 ? t1 : t2;
+      predict(&destination, seconds);
+      transform.mountToInstrument(&destination, &a1, &a2);
+      arrivalTime += lroundf(seconds*1000.0F);
+      VF("MSG: Mount, goto arrival expected in "); V(seconds); VLF(" seconds");
+    }
+  #endif
+
   if (stage == GG_DESTINATION && park.state == PS_PARKING) {
     axis1.setTargetCoordinatePark(a1);
     axis2.setTargetCoordinatePark(a2);
@@ -595,10 +921,34 @@ CommandError Goto::startAutoSlew() {
 
   VF("MSG: Mount, goto target coordinates set (a1="); V(radToDeg(a1)); VF("deg, a2="); V(radToDeg(a2)); VLF(" deg)");
 
-  e = axis1.autoGoto(radsPerSecondCurrent);
-  if (e == CE_NONE) e = axis2.autoGoto(radsPerSecondCurrent*((float)(AXIS2_SLEW_RATE_PERCENT)/100.0F));
+  #if GOTO_COORDINATED == ON
+    // the axis that takes longer leads, the other follows the same profile scaled down by the distance ratio
+    float accel1 = radsPerSecondPerSecondAxis1;
+    float accel2 = radsPerSecondPerSecondAxis2;
+    float d1 = axis1.getTargetDistance();
+    float d2 = axis2.getTargetDistance();
+    if (slewTime(d1, rate1, accel1) >= slewTime(d2, rate2, accel2)) {
+      if (d1 > 0.0F) {
+        float scale = d2/d1;
+        if (rate1*scale < rate2) rate2 = rate1*scale;
+        if (accel1*scale < accel2) accel2 = accel1*scale;
+      }
+    } else {
+      if (d2 > 0.0F) {
+        float scale = d1/d2;
+        if (rate2*scale < rate1) rate1 = rate2*scale;
+        if (accel2*scale < accel1) accel1 = accel2*scale;
+      }
+    }
+    axis1.setSlewAccelerationRate(accel1);
+    axis2.setSlewAccelerationRate(accel2);
+    VF("MSG: Mount, goto coordinated (a1 rate="); V(radToDeg(rate1)); VF("deg/s, a2 rate="); V(radToDeg(rate2)); VLF("deg/s)");
+  #endif
 
-  nearTargetTimeout = millis();
+  e = axis1.autoGoto(rate1);
+  if (e == CE_NONE) e = axis2.autoGoto(rate2);
+
+  nearTargetTimeout = tasks.deadline(5000);
 
   return e;
 }
@@ -615,9 +965,26 @@ void Goto::updateAccelerationRates() {
     float secondsToAccelerate = (degToRadF((float)(5.0F))/radsPerSecondCurrent)*2.0F;
     float secondsToAccelerateAbort = (degToRadF((float)(2.0F))/radsPerSecondCurrent)*2.0F;
   #endif
-  axis1.setSlewAccelerationRate(radsPerSecondCurrent/secondsToAccelerate);
+  radsPerSecondPerSecond = radsPerSecondCurrent/secondsToAccelerate;
+  radsPerSecondPerSecondAxis1 = radsPerSecondPerSecond;
+  radsPerSecondPerSecondAxis2 = radsPerSecondPerSecond;
+
+  #if GOTO_AXIS_RATES == ON
+    // an axis that can't reach the goto rate also accelerates over the same distance to its own limit
+    radsPerSecondMaxAxis1 = axisRateLimit(&axis1);
+    radsPerSecondMaxAxis2 = axisRateLimit(&axis2);
+    float accelDist = degToRadF((float)(SLEW_ACCELERATION_DIST))*2.0F;
+    if (radsPerSecondMaxAxis1*radsPerSecondMaxAxis1/accelDist < radsPerSecondPerSecondAxis1) radsPerSecondPerSecondAxis1 = radsPerSecondMaxAxis1*radsPerSecondMaxAxis1/accelDist;
+    if (radsPerSecondMaxAxis2*radsPerSecondMaxAxis2/accelDist < radsPerSecondPerSecondAxis2) radsPerSecondPerSecondAxis2 = radsPerSecondMaxAxis2*radsPerSecondMaxAxis2/accelDist;
+
+    // guiding and homing slews are held to the limits too
+    axis1.setFrequencyMax(radsPerSecondMaxAxis1);
+    axis2.setFrequencyMax(radsPerSecondMaxAxis2);
+  #endif
+
+  axis1.setSlewAccelerationRate(radsPerSecondPerSecondAxis1);
   axis1.setSlewAccelerationRateAbort(radsPerSecondCurrent/secondsToAccelerateAbort);
-  axis2.setSlewAccelerationRate(radsPerSecondCurrent/secondsToAccelerate);
+  axis2.setSlewAccelerationRate(radsPerSecondPerSecondAxis2);
   axis2.setSlewAccelerationRateAbort(radsPerSecondCurrent/secondsToAccelerateAbort);
 }
 
@@ -635,13 +1002,32 @@ float Goto::usPerStepLowerLimit() {
   float r_us_axis1 = r_us/axis1.getStepsPerStepSlewing();
   float r_us_axis2 = r_us/axis2.getStepsPerStepSlewing();
 
-  // average in axis2 step rate scaling for drives where the reduction ratio isn't equal
-  r_us = (1.0F/(1.0F/r_us_axis1 + 1.0F/r_us_axis2))*2.0F;
+  #if GOTO_AXIS_RATES == ON
+    // each axis is held to its own limit, so only the faster axis limits the goto rate (in axis1 steps)
+    float r_us_axis2_as_axis1 = r_us_axis2*((float)(AXIS2_SLEW_RATE_PERCENT)/100.0F)*((float)axis2.getStepsPerMeasure()/(float)axis1.getStepsPerMeasure());
+    r_us = r_us_axis1 < r_us_axis2_as_axis1 ? r_us_axis1 : r_us_axis2_as_axis1;
+  #else
+    // average in axis2 step rate scaling for drives where the reduction ratio isn't equal
+    r_us = (1.0F/(1.0F/r_us_axis1 + 1.0F/r_us_axis2))*2.0F;
+  #endif
 
   // return rate in us units
   return r_us;
 }
 
+#if GOTO_AXIS_RATES == ON
+// fastest rate for this axis in radians per second
+float Goto::axisRateLimit(Axis *axis) {
+  // the same step rate lower limit as above but for this axis alone
+  float r_us = HAL_MAXRATE_LOWER_LIMIT;
+  #if STEP_WAVE_FORM == PULSE || STEP_WAVE_FORM == DEDGE
+    r_us /= 1.6F;
+  #endif
+  r_us = r_us/axis->getStepsPerStepSlewing();
+  return (1000000.0F/r_us)/(float)axis->getStepsPerMeasure();
+}
+#endif
+
 Goto goTo;
 
 #endif
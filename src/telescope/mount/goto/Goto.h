@@ -7,6 +7,7 @@
 #if defined(MOUNT_PRESENT)
 
 #include "../../../libApp/commands/ProcessCmds.h"
+#include "../../../lib/watchdog/Watchdog.h"
 #include "../coordinates/Transform.h"
 
 enum MeridianFlip: uint8_t     {MF_NEVER, MF_ALWAYS};
@@ -30,6 +31,13 @@ typedef struct GotoSettings {
 } GotoSettings;
 #pragma pack()
 
+// a queued goto target, Native RA/Dec in radians and dwell in seconds (0 waits for the next trigger)
+typedef struct GotoQueueItem {
+  float r;
+  float d;
+  uint16_t dwell;
+} GotoQueueItem;
+
 typedef struct AlignState {
   uint8_t currentStar;
   uint8_t lastStar;
@@ -59,6 +67,9 @@ class Goto {
     // set target equatorial position (Native coordinate system)
     inline void setGotoTarget(Coordinate *coords) { gotoTarget = *coords; }
 
+    // get the goto final destination (Mount coordinate system, eq or hor)
+    inline Coordinate getTargetMount() { return target; }
+
     // checks for valid target and determines pier side (Mount coordinate system)
     CommandError setTarget(Coordinate *coords, PierSideSelect pierSideSelect, bool isGoto = true);
 
@@ -71,6 +82,9 @@ class Goto {
     // add an align star (at the current position relative to target)
     CommandError alignAddStar();
 
+    // add a star to a finished alignment (at the current position relative to target) and refine the model
+    CommandError alignRefineStar();
+
     // reset the alignment model
     void alignReset();
 
@@ -92,9 +106,34 @@ class Goto {
     // returns true if the automatic meridian flip feature is enabled
     inline bool isAutoFlipEnabled() { return settings.meridianFlipAuto; }
 
+    // motion event from an axis, wakes the goto monitor
+    void axisEvent(Axis *axis, AxisEvent event);
+
     // monitor goto
     void poll();
 
+    #if GOTO_FEATURE == ON && GOTO_QUEUE != OFF
+      // add a target to the end of the goto queue, returns false if the queue is full
+      bool queueAdd(double r, double d, uint16_t dwell);
+
+      // empty the goto queue and end the sequence, a goto in progress carries on
+      void queueClear();
+
+      // start the sequence at the first target in the goto queue
+      CommandError queueStart();
+
+      // move on to the next target once at the present one (instead of waiting for the dwell time)
+      inline void queueNext() { queueTrigger = true; }
+
+      // goto queue length, position in the sequence, and if the sequence is running
+      inline uint8_t queueLength() { return queueCount; }
+      inline uint8_t queuePosition() { return queueIndex; }
+      inline bool queueActive() { return queueRunning; }
+
+      // monitor the goto queue sequence
+      void queuePoll();
+    #endif
+
     // for determining goto state
     GotoState state = GS_NONE;
     GotoStage stage = GG_NONE;
@@ -112,11 +151,38 @@ class Goto {
   private:
 
     #if GOTO_FEATURE == ON
+    // set the start, waypoints, and destination for a goto and check each leg against the limits
+    CommandError planRoute(Coordinate *current);
+
+    // check each leg of the planned route against the limits
+    CommandError validateRoute();
+
     // set any additional destinations required for a goto
     void waypoint(Coordinate *current);
 
     // start slews with approach correction and parking/homing support
     CommandError startAutoSlew();
+
+    #if GOTO_QUEUE != OFF
+      // goto the target at the present position in the queue
+      CommandError queueGoto();
+
+      // end the sequence
+      void queueStop();
+    #endif
+
+    #if GOTO_PREDICTIVE == ON
+      // move a tracked coordinate ahead by the given time in seconds
+      void predict(Coordinate *coord, float seconds);
+    #endif
+
+    #if GOTO_WAYPOINT_BLEND == ON
+      // move on to the next destination without stopping once both axes are slowing for the waypoint
+      void waypointBlend();
+
+      // returns true if the axis can carry on to value without reversing
+      bool waypointContinues(Axis *axis, double value);
+    #endif
     #endif
 
     // update acceleration rates for goto and guiding
@@ -125,6 +191,11 @@ class Goto {
     // estimate average microseconds per step lower limit
     float usPerStepLowerLimit();
 
+    #if GOTO_AXIS_RATES == ON
+      // fastest rate for this axis in radians per second
+      float axisRateLimit(Axis *axis);
+    #endif
+
     // get least distance between coordinates
     inline double dist(double a, double b) { if (a > b) return a - b; else return b - a; }
 
@@ -143,18 +214,40 @@ class Goto {
     GotoState  stateAbort           = GS_NONE;
     GotoState  stateLast            = GS_NONE;
     uint8_t    taskHandle           = 0;
+    uint8_t    abortCounter         = 0;
+    #ifdef WATCHDOG_PRESENT
+      uint8_t  heartbeatHandle      = 0;
+    #endif
     int        nearDestinationRefineStages;
-    unsigned long nearTargetTimeout = 0;
-    unsigned long nearTargetTimeoutAxis1 = 0;
-    unsigned long nearTargetTimeoutAxis2 = 0;
-    unsigned long nearDestinationTimeout = 0;
+    bool       parkHomeFast         = false;
+    uint64_t nearTargetTimeout = 0;
+    unsigned long arrivalTime = 0;              // millis() when the current slew is expected to arrive
+    uint64_t nearTargetTimeoutAxis1 = 0;
+    uint64_t nearTargetTimeoutAxis2 = 0;
+    uint64_t nearDestinationTimeout = 0;
 
     MeridianFlipHome meridianFlipHome = {false, false};
 
+    #if GOTO_FEATURE == ON && GOTO_QUEUE != OFF
+      GotoQueueItem queue[GOTO_QUEUE];
+      uint8_t queueCount = 0;
+      uint8_t queueIndex = 0;
+      bool queueRunning = false;
+      volatile bool queueTrigger = false;
+      bool queueArrived = false;
+      unsigned long queueArrivalTime = 0;
+      uint8_t queueTaskHandle = 0;
+    #endif
+
     AlignState alignState = {0, 0};
 
     float      usPerStepBase        = 128.0F;
     float      radsPerSecondCurrent;
+    float      radsPerSecondPerSecond;
+    float      radsPerSecondMaxAxis1 = 0.0F; // per axis limits when GOTO_AXIS_RATES is ON (0 for none)
+    float      radsPerSecondMaxAxis2 = 0.0F;
+    float      radsPerSecondPerSecondAxis1;
+    float      radsPerSecondPerSecondAxis2;
 
     double slewDestinationDistHA = 0.0;
     double slewDestinationDistDec = 0.0;
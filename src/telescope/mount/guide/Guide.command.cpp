@@ -20,6 +20,26 @@ bool Guide::command(char *reply, char *command, char *parameter, bool *supressFr
     *numericReply = false;
   } else
 
+  // :GX9G#     Get the last timed pulse guide, axis and the requested and actual length in microseconds
+  //            Returns: n,n,n#
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == '9' && parameter[1] == 'G' && parameter[2] == 0) {
+    unsigned long requested, actual;
+    uint8_t axis = lastPulse(&requested, &actual);
+    sprintf(reply, "%d,%lu,%lu", (int)axis, requested, actual);
+    *numericReply = false;
+  } else
+
+  // :GX9H#     Get the offset still to be applied on Axis1 and Axis2 in arcseconds, both are 0 once done
+  //            Returns: sn.n,sn.n#
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == '9' && parameter[1] == 'H' && parameter[2] == 0) {
+    char remaining[16];
+    sprintF(reply, "%0.1f", offsetRemaining(1));
+    sprintF(remaining, "%0.1f", offsetRemaining(2));
+    strcat(reply, ",");
+    strcat(reply, remaining);
+    *numericReply = false;
+  } else
+
   // M - Telescope Movement (Guiding) Commands
   if (command[0] == 'M') {
 
@@ -49,6 +69,24 @@ bool Guide::command(char *reply, char *command, char *parameter, bool *supressFr
       } else *commandError = CE_PARAM_FORM;
     } else
 
+    // :MO[sn.n],[sn.n]#  Offset the mount by exact amounts on Axis1 (+ = W) and Axis2 (+ = N) in arcseconds
+    //            superimposed on tracking, use :GX9H# to see when it's finished
+    //            Return: 0 on failure
+    //                    1 on success
+    if (command[1] == 'O') {
+      char *conv_end;
+      float arcsecAxis1 = strtof(parameter, &conv_end);
+      if (conv_end != parameter && *conv_end == ',') {
+        char *axis2Start = conv_end + 1;
+        float arcsecAxis2 = strtof(axis2Start, &conv_end);
+        if (conv_end != axis2Start && *conv_end == 0) {
+          if (fabs(arcsecAxis1) <= 3600.0F && fabs(arcsecAxis2) <= 3600.0F) {
+            *commandError = startOffset(arcsecAxis1, arcsecAxis2);
+          } else *commandError = CE_PARAM_RANGE;
+        } else *commandError = CE_PARAM_FORM;
+      } else *commandError = CE_PARAM_FORM;
+    } else
+
     // :Mw#       Move Telescope West at current guide rate
     //            Returns: Nothing
     if (command[1] == 'w' && parameter[0] == 0) {
@@ -74,9 +112,12 @@ bool Guide::command(char *reply, char *command, char *parameter, bool *supressFr
       *numericReply = false;
     } else
     // :Mp#       Move Telescope for sPiral search at current guide rate
+    // :Mp[n]#    Move Telescope for sPiral search at current guide rate along path n, constant speed 1 for a spiral or 2 for a square
     //            Returns: Nothing
-    if (command[1] == 'p' && parameter[0] == 0) {
-      *commandError = startSpiral(settings.axis1RateSelect, GUIDE_SPIRAL_TIME_LIMIT*1000);
+    if (command[1] == 'p' && (parameter[0] == 0 || ((parameter[0] == '1' || parameter[0] == '2') && parameter[1] == 0))) {
+      SearchPath path = SP_STEPPED;
+      if (parameter[0] == '1') path = SP_SPIRAL; else if (parameter[0] == '2') path = SP_RASTER;
+      *commandError = startSpiral(settings.axis1RateSelect, GUIDE_SPIRAL_TIME_LIMIT*1000, path);
       *numericReply = false;
     } else return false;
   } else
@@ -7,6 +7,7 @@
 
 #include "../../../libApp/commands/ProcessCmds.h"
 #include "../../../lib/tasks/OnTask.h"
+#include "../../../lib/counters/Counters.h"
 
 #include "../../Telescope.h"
 #include "../Mount.h"
@@ -15,6 +16,7 @@
 #include "../park/Park.h"
 #include "../home/Home.h"
 #include "../limits/Limits.h"
+#include "../log/MountLog.h"
 #include "../status/Status.h"
 
 inline void guideWrapper() { guide.poll(); }
@@ -36,9 +38,11 @@ void Guide::init() {
   settings.axis1RateSelect = GR_20X;
   settings.axis2RateSelect = GR_20X;
 
+  pulseCounter = counters.add("GdPulse");
+
   // start guide monitor task
   VF("MSG: Mount, start guide monitor task (rate "); V(FRACTIONAL_SEC_US/2); VF("us priority 3)... ");
-  int taskHandle = tasks.add(0, 0, true, 3, guideWrapper, "MtGuide");
+  taskHandle = tasks.add(0, 0, true, 3, guideWrapper, "MtGuide");
   tasks.setPeriodMicros(taskHandle, FRACTIONAL_SEC_US/2);
   if (taskHandle) { VLF("success"); } else { VLF("FAILED!"); }
 }
@@ -54,9 +58,9 @@ CommandError Guide::startAxis1(GuideAction guideAction, GuideRateSelect rateSele
   guideActionAxis1 = guideAction;
   float rate = rateSelectToRate(rateSelect, 1);
 
-  // unlimited 0 means the maximum period, about 49 days
+  // unlimited 0 never finishes
+  guideFinishTimeAxis1 = guideTimeLimit == 0 ? TASKS_NEVER : tasks.deadline(guideTimeLimit);
   if (guideTimeLimit == 0) guideTimeLimit = 0x1FFFFFFF;
-  guideFinishTimeAxis1 = millis() + guideTimeLimit;
 
   if (rate <= 2) {
     axis1.setPowerDownOverrideTime(300000UL);
@@ -67,10 +71,27 @@ CommandError Guide::startAxis1(GuideAction guideAction, GuideRateSelect rateSele
     state = GU_PULSE_GUIDE;
     if (guideAction == GA_REVERSE) { VF("MSG: Guide, Axis1 rev @"); rateAxis1 = -rate; } else { VF("MSG: Guide, Axis1 fwd @"); rateAxis1 = rate; }
     V(rate); VL("X");
+    counters.increment(pulseCounter);
+    #if GUIDE_PULSE_BLEND == ON
+      if (guideTimeLimit <= GUIDE_PULSE_TIMED_MAX) {
+        rateAxis1 = blendAdd(&blendAxis1, &guideActionAxis1, rateAxis1, rateAxis1*guideTimeLimit);
+        guideFinishTimeAxis1 = TASKS_NEVER;
+        pulseAxis1.timed = false;
+      } else
+    #endif
+    {
+      // a pulse that isn't blended replaces any correction underway
+      blendAxis1.active = false;
+      blendAxis1.remaining = 0.0F;
+      pulseStart(&pulseAxis1, guideAction, rateAxis1, guideTimeLimit);
+    }
     mount.update();
   } else {
     state = GU_GUIDE;
     backlashEnableControl(true);
+    pulseAxis1.timed = false;
+    blendAxis1.active = false;
+    blendAxis1.remaining = 0.0F;
     if (rateSelect != GR_CUSTOM) {
       if (guideAction == GA_REVERSE) rate -= mount.trackingRateAxis1; else rate += mount.trackingRateAxis1;
     }
@@ -95,7 +116,10 @@ void Guide::stopAxis1(GuideAction stopDirection, bool abort) {
       VLF("MSG: Guide, Axis1 stopped");
       guideActionAxis1 = GA_NONE;
       rateAxis1 = 0.0F;
+      blendAxis1.active = false;
+      blendAxis1.remaining = 0.0F;
       mount.update();
+      pulseStop(&pulseAxis1, 1);
     }
   }
 }
@@ -113,9 +137,9 @@ CommandError Guide::startAxis2(GuideAction guideAction, GuideRateSelect rateSele
   float fastestRate = rateSelectToRate(GR_MAX, 2)*((float)(AXIS2_SLEW_RATE_PERCENT)/100.0F);
   if (rate > fastestRate) rate = fastestRate;
 
-  // unlimited 0 means the maximum period, about 49 days
+  // unlimited 0 never finishes
+  guideFinishTimeAxis2 = guideTimeLimit == 0 ? TASKS_NEVER : tasks.deadline(guideTimeLimit);
   if (guideTimeLimit == 0) guideTimeLimit = 0x1FFFFFFF;
-  guideFinishTimeAxis2 = millis() + guideTimeLimit;
 
   if (rate <= 2) {
     axis1.setPowerDownOverrideTime(300000UL);
@@ -127,10 +151,27 @@ CommandError Guide::startAxis2(GuideAction guideAction, GuideRateSelect rateSele
     if (pierSide == PIER_SIDE_WEST) { if (guideAction == GA_FORWARD) guideAction = GA_REVERSE; else guideAction = GA_FORWARD; };
     if (guideAction == GA_REVERSE) { VF("MSG: Guide, Axis2 rev @"); rateAxis2 = -rate; } else { VF("MSG: Guide, Axis2 fwd @"); rateAxis2 = rate; }
     V(rate); VL("X");
+    counters.increment(pulseCounter);
+    #if GUIDE_PULSE_BLEND == ON
+      if (guideTimeLimit <= GUIDE_PULSE_TIMED_MAX) {
+        rateAxis2 = blendAdd(&blendAxis2, &guideActionAxis2, rateAxis2, rateAxis2*guideTimeLimit);
+        guideFinishTimeAxis2 = TASKS_NEVER;
+        pulseAxis2.timed = false;
+      } else
+    #endif
+    {
+      // a pulse that isn't blended replaces any correction underway
+      blendAxis2.active = false;
+      blendAxis2.remaining = 0.0F;
+      pulseStart(&pulseAxis2, guideAction, rateAxis2, guideTimeLimit);
+    }
     mount.update();
   } else {
     state = GU_GUIDE;
     backlashEnableControl(true);
+    pulseAxis2.timed = false;
+    blendAxis2.active = false;
+    blendAxis2.remaining = 0.0F;
     if (rateSelect != GR_CUSTOM) {
       if (guideAction == GA_REVERSE) rate -= mount.trackingRateAxis2; else rate += mount.trackingRateAxis2;
     }
@@ -155,13 +196,66 @@ void Guide::stopAxis2(GuideAction stopDirection, bool abort) {
       VLF("MSG: Guide, Axis2 stopped");
       guideActionAxis2 = GA_NONE;
       rateAxis2 = 0.0F;
+      blendAxis2.active = false;
+      blendAxis2.remaining = 0.0F;
       mount.update();
+      pulseStop(&pulseAxis2, 2);
     }
   }
 }
 
+// start an exact offset in arcseconds on either or both axes (+ is the Axis1 or Axis2 forward direction, W or N)
+// the offset is superimposed on tracking at 2X, the fastest rate that needs no acceleration
+CommandError Guide::startOffset(float arcsecAxis1, float arcsecAxis2) {
+  if (state != GU_NONE && state != GU_PULSE_GUIDE) return CE_SLEW_IN_MOTION;
+  if (arcsecAxis1 == 0.0F && arcsecAxis2 == 0.0F) return CE_NONE;
+
+  GuideAction actionAxis1 = arcsecAxis1 < 0.0F ? GA_REVERSE : GA_FORWARD;
+  GuideAction actionAxis2 = arcsecAxis2 < 0.0F ? GA_REVERSE : GA_FORWARD;
+  CommandError e;
+  if (arcsecAxis1 != 0.0F) { e = validate(1, actionAxis1); if (e != CE_NONE) return e; }
+  if (arcsecAxis2 != 0.0F) { e = validate(2, actionAxis2); if (e != CE_NONE) return e; }
+
+  float rate = rateSelectToRate(GR_2X);
+  float correctionPerArcsec = (float)(arcsecToRad(1000.0)/siderealToRad(1.0));
+
+  axis1.setPowerDownOverrideTime(300000UL);
+  axis2.setPowerDownOverrideTime(300000UL);
+  backlashEnableControl(false);
+  state = GU_PULSE_GUIDE;
+
+  if (arcsecAxis1 != 0.0F) {
+    VF("MSG: Guide, Axis1 offset "); V(arcsecAxis1); VLF("\"");
+    guideActionAxis1 = actionAxis1;
+    guideFinishTimeAxis1 = TASKS_NEVER;
+    pulseAxis1.timed = false;
+    rateAxis1 = blendAdd(&blendAxis1, &guideActionAxis1, actionAxis1 == GA_FORWARD ? rate : -rate, arcsecAxis1*correctionPerArcsec);
+  }
+
+  if (arcsecAxis2 != 0.0F) {
+    VF("MSG: Guide, Axis2 offset "); V(arcsecAxis2); VLF("\"");
+    guideActionAxis2 = actionAxis2;
+    guideFinishTimeAxis2 = TASKS_NEVER;
+    pulseAxis2.timed = false;
+    if (pierSide == PIER_SIDE_WEST) { rate = -rate; arcsecAxis2 = -arcsecAxis2; }
+    rateAxis2 = blendAdd(&blendAxis2, &guideActionAxis2, actionAxis2 == GA_FORWARD ? rate : -rate, arcsecAxis2*correctionPerArcsec);
+  }
+
+  mount.update();
+  return CE_NONE;
+}
+
+// returns the offset (in arcseconds) still to be applied on the specified axis
+float Guide::offsetRemaining(uint8_t axis) {
+  PulseBlend *blend = axis == 1 ? &blendAxis1 : &blendAxis2;
+  if (!blend->active) return 0.0F;
+  float arcsec = blend->remaining/(float)(arcsecToRad(1000.0)/siderealToRad(1.0));
+  if (axis == 2 && pierSide == PIER_SIDE_WEST) arcsec = -arcsec;
+  return arcsec;
+}
+
 // start spiral guide at the specified rate (spiral size is porportional to rate)
-CommandError Guide::startSpiral(GuideRateSelect rateSelect, unsigned long guideTimeLimit) {
+CommandError Guide::startSpiral(GuideRateSelect rateSelect, unsigned long guideTimeLimit, SearchPath path) {
   if (state == GU_SPIRAL_GUIDE) { stop(); return CE_NONE; }
   if (guideActionAxis1 != GA_NONE || guideActionAxis2 != GA_NONE) return CE_SLEW_IN_MOTION;
   CommandError e = validate(0, GA_SPIRAL); if (e != CE_NONE) return e;
@@ -174,10 +268,14 @@ CommandError Guide::startSpiral(GuideRateSelect rateSelect, unsigned long guideT
 
   VF("MSG: guideSpiralStart(), using guide rates to "); V(rateSelectToRate(spiralGuideRateSelect)); VL("X");
 
-  // unlimited 0 means the maximum period, about 49 days
-  if (guideTimeLimit == 0) guideTimeLimit = 0x1FFFFFFF;
+  spiralPath = path;
+  spiralTheta = 0.0F;
+  spiralLeg = 0.0F;
+  spiralLegs = 0;
+  spiralLastTime = micros();
   spiralStartTime = millis();
-  guideFinishTimeAxis1 = spiralStartTime + guideTimeLimit;
+  // unlimited 0 never finishes
+  guideFinishTimeAxis1 = guideTimeLimit == 0 ? TASKS_NEVER : tasks.deadline(guideTimeLimit);
   guideFinishTimeAxis2 = guideFinishTimeAxis1;
 
   // setup and call the polling routine once to start the guides
@@ -203,13 +301,13 @@ CommandError Guide::startHome() {
     state = GU_HOME_GUIDE;
 
     #if AXIS2_TANGENT_ARM == OFF
-      guideFinishTimeAxis1 = millis() + (unsigned long)(GUIDE_HOME_TIME_LIMIT * 1000.0);
+      guideFinishTimeAxis1 = tasks.deadline((unsigned long)(GUIDE_HOME_TIME_LIMIT * 1000.0));
       guideActionAxis1 = GA_HOME;
       axis1.setFrequencySlew(goTo.rate);
       axis1.autoSlewHome();
     #endif
 
-    guideFinishTimeAxis2 = millis() + (unsigned long)(GUIDE_HOME_TIME_LIMIT * 1000.0);
+    guideFinishTimeAxis2 = tasks.deadline((unsigned long)(GUIDE_HOME_TIME_LIMIT * 1000.0));
     guideActionAxis2 = GA_HOME;
     axis2.setFrequencySlew(goTo.rate*((float)(AXIS2_SLEW_RATE_PERCENT)/100.0F));
     axis2.autoSlewHome();
@@ -378,16 +476,46 @@ void Guide::spiralPoll() {
   float fastestRate = rateSelectToRate(GR_MAX, 2)*((float)(AXIS2_SLEW_RATE_PERCENT)/100.0F);
   if (rate > fastestRate) rate = fastestRate;
   
-  // apparaent FOV (in arc-seconds) = rate*15.0*2.0;
-  // current radius assuming movement at 2 seconds per fov
-  double radius = pow(T/6.28318, 1.0/1.74);
+  // time since the last update in seconds
+  unsigned long now = micros();
+  float dt = (now - spiralLastTime)/1000000.0F;
+  spiralLastTime = now;
+
+  // apparaent FOV (in arc-seconds) = rate*15.0*2.0, so 2.0*rate in sidereal seconds
+  float pitch = 2.0F*rate;
+
+  // direction of motion for this moment
+  float directionAxis1, directionAxis2;
+  if (spiralPath == SP_SPIRAL) {
+    // r = b*theta with b set for one field between turns, theta advances so the speed along the path stays at rate
+    float b = pitch/6.28318F;
+    float stretch = sqrtf(1.0F + spiralTheta*spiralTheta);
+    spiralTheta += rate*dt/(b*stretch);
+    stretch = sqrtf(1.0F + spiralTheta*spiralTheta);
+    directionAxis1 = (cosf(spiralTheta) - spiralTheta*sinf(spiralTheta))/stretch;
+    directionAxis2 = (sinf(spiralTheta) + spiralTheta*cosf(spiralTheta))/stretch;
+  } else
+  if (spiralPath == SP_RASTER) {
+    // legs of one, one, two, two, three, three... fields turning 90 degrees after each
+    spiralLeg += rate*dt;
+    while (spiralLeg >= pitch*(spiralLegs/2 + 1)) { spiralLeg -= pitch*(spiralLegs/2 + 1); spiralLegs++; }
+    const int8_t legAxis1[4] = {1, 0, -1, 0};
+    const int8_t legAxis2[4] = {0, 1, 0, -1};
+    directionAxis1 = legAxis1[spiralLegs % 4];
+    directionAxis2 = legAxis2[spiralLegs % 4];
+  } else {
+    // current radius assuming movement at 2 seconds per fov
+    double radius = pow(T/6.28318, 1.0/1.74);
 
-  // current angle in radians
-  float angle = (radius - trunc(radius))*6.28318;
+    // current angle in radians
+    float angle = (radius - trunc(radius))*6.28318;
+    directionAxis1 = cos(angle);
+    directionAxis2 = sin(angle);
+  }
 
   // calculate the Axis rates for this moment (in sidereal X)
-  customRateAxis1 = rate*cos(angle);
-  customRateAxis2 = rate*sin(angle);
+  customRateAxis1 = rate*directionAxis1;
+  customRateAxis2 = rate*directionAxis2;
 
   // add the current tracking rates
   customRateAxis1 += mount.trackingRateAxis1;
@@ -415,12 +543,14 @@ void Guide::poll() {
   // just return if no guide is active
   if (state == GU_NONE) return;
 
+  blendPoll();
+
   // check fast guide completion axis1
   if (guideActionAxis1 == GA_BREAK && rateAxis1 == 0.0F && !axis1.isSlewing()) {
     guideActionAxis1 = GA_NONE;
     mount.update();
   } else {
-    if (guideActionAxis1 > GA_BREAK && (long)(millis() - guideFinishTimeAxis1) >= 0) stopAxis1();
+    if (guideActionAxis1 > GA_BREAK && guideExpired(&pulseAxis1, guideFinishTimeAxis1)) stopAxis1();
   }
 
   // check fast guide completion axis2
@@ -428,7 +558,7 @@ void Guide::poll() {
     guideActionAxis2 = GA_NONE;
     mount.update();
   } else {
-    if (guideActionAxis2 > GA_BREAK && (long)(millis() - guideFinishTimeAxis2) >= 0) stopAxis2();
+    if (guideActionAxis2 > GA_BREAK && guideExpired(&pulseAxis2, guideFinishTimeAxis2)) stopAxis2();
   }
 
   // do spiral guiding, change rates and stop both axes at once
@@ -455,6 +585,97 @@ void Guide::poll() {
   if (guideActionAxis1 == GA_NONE && guideActionAxis2 == GA_NONE) state = GU_NONE;
 }
 
+// mark the start of a pulse guide of timeMs at rate (signed), needs to be just before the rate is applied
+void Guide::pulseStart(PulseTiming *pulse, GuideAction guideAction, float rate, unsigned long timeMs) {
+  if (timeMs > GUIDE_PULSE_TIMED_MAX) { pulse->timed = false; return; }
+
+  // an overrun only carries over to the next pulse in the same direction
+  if (guideAction != pulse->action) pulse->carry = 0;
+  pulse->action = guideAction;
+  pulse->rate = rate;
+  pulse->requested = timeMs*1000UL;
+
+  long length = pulse->requested;
+  #if GUIDE_PULSE_PRECISE == ON
+    length -= pulse->carry;
+    if (length < 0) length = 0;
+    tasks.setPeriodMicros(taskHandle, GUIDE_PULSE_POLL_US);
+  #endif
+
+  pulse->start = micros();
+  pulse->finish = pulse->start + length;
+  pulse->timed = true;
+}
+
+// mark the end of a pulse guide and record its actual length
+void Guide::pulseStop(PulseTiming *pulse, uint8_t axis) {
+  if (!pulse->timed) return;
+  unsigned long now = micros();
+  pulse->timed = false;
+
+  lastPulseAxis = axis;
+  lastPulseRequested = pulse->requested;
+  lastPulseActual = now - pulse->start;
+  VF("MSG: Guide, Axis"); V(axis); VF(" pulse "); V(lastPulseRequested); VF("us requested "); V(lastPulseActual); VLF("us actual");
+  #if MOUNT_LOG != OFF
+    mountLog.guide(axis, pulse->rate, lastPulseRequested, lastPulseActual);
+  #endif
+
+  #if GUIDE_PULSE_PRECISE == ON
+    // pulses cut short don't count, otherwise the next pulse makes up for this one's error
+    if ((long)(now - pulse->finish) >= 0) {
+      pulse->carry += (long)lastPulseActual - (long)lastPulseRequested;
+      if (pulse->carry > GUIDE_PULSE_CARRY_MAX) pulse->carry = GUIDE_PULSE_CARRY_MAX; else
+      if (pulse->carry < -GUIDE_PULSE_CARRY_MAX) pulse->carry = -GUIDE_PULSE_CARRY_MAX;
+    } else pulse->carry = 0;
+
+    if (!pulseAxis1.timed && !pulseAxis2.timed) tasks.setPeriodMicros(taskHandle, FRACTIONAL_SEC_US/2);
+  #endif
+}
+
+// true if the guide time is up
+bool Guide::guideExpired(PulseTiming *pulse, uint64_t finishTime) {
+  #if GUIDE_PULSE_PRECISE == ON
+    if (pulse->timed) return (long)(micros() - pulse->finish) >= 0;
+  #else
+    (void)(pulse);
+  #endif
+  return tasks.expired(finishTime);
+}
+
+// adds a correction (signed, in sidereal x ms) to an axis, rate (signed) is the rate it's requested at, returns the rate to guide at
+float Guide::blendAdd(PulseBlend *blend, GuideAction *guideAction, float rate, float correction) {
+  if (!blendAxis1.active && !blendAxis2.active) blendLastTime = micros();
+
+  // a correction already underway carries on at the same rate, the new pulse only changes how long it lasts
+  blend->remaining += correction;
+  blend->active = true;
+  if (blend->remaining*rate < 0.0F) {
+    *guideAction = (*guideAction == GA_FORWARD) ? GA_REVERSE : GA_FORWARD;
+    return -rate;
+  }
+  return rate;
+}
+
+// works off the corrections, stopping each axis as its correction is used up
+void Guide::blendPoll() {
+  if (!blendAxis1.active && !blendAxis2.active) return;
+
+  unsigned long now = micros();
+  float ms = (now - blendLastTime)/1000.0F;
+  blendLastTime = now;
+
+  // any overshoot is kept so the next correction makes up for it
+  if (blendAxis1.active && guideActionAxis1 > GA_BREAK) {
+    blendAxis1.remaining -= rateAxis1*ms;
+    if (blendAxis1.remaining*rateAxis1 <= 0.0F) { float residual = blendAxis1.remaining; stopAxis1(); blendAxis1.remaining = residual; }
+  }
+  if (blendAxis2.active && guideActionAxis2 > GA_BREAK) {
+    blendAxis2.remaining -= rateAxis2*ms;
+    if (blendAxis2.remaining*rateAxis2 <= 0.0F) { float residual = blendAxis2.remaining; stopAxis2(); blendAxis2.remaining = residual; }
+  }
+}
+
 // enables or disables backlash for the GUIDE_DISABLE_BACKLASH option
 void Guide::backlashEnableControl(bool enable) {
   #if GUIDE_DISABLE_BACKLASH == ON
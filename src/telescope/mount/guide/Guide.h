@@ -19,6 +19,7 @@
 enum GuideState: uint8_t       {GU_NONE, GU_PULSE_GUIDE, GU_GUIDE, GU_SPIRAL_GUIDE, GU_HOME_GUIDE, GU_HOME_GUIDE_ABORT};
 enum GuideRateSelect: uint8_t  {GR_QUARTER, GR_HALF, GR_1X, GR_2X, GR_4X, GR_8X, GR_20X, GR_48X, GR_HALF_MAX, GR_MAX, GR_CUSTOM};
 enum GuideAction: uint8_t      {GA_NONE, GA_BREAK, GA_FORWARD, GA_REVERSE, GA_SPIRAL, GA_HOME };
+enum SearchPath: uint8_t       {SP_STEPPED, SP_SPIRAL, SP_RASTER};
 
 #pragma pack(1)
 #define GuideSettingsSize 3
@@ -29,6 +30,28 @@ typedef struct GuideSettings {
 } GuideSettings;
 #pragma pack()
 
+// pulses up to this long (in ms) are timed in microseconds
+#define GUIDE_PULSE_TIMED_MAX 600000UL
+
+// most overrun (in us) carried into the next pulse
+#define GUIDE_PULSE_CARRY_MAX 50000L
+
+typedef struct PulseTiming {
+  bool timed;
+  GuideAction action;
+  unsigned long start;
+  unsigned long finish;
+  unsigned long requested;
+  long carry;
+  float rate;
+} PulseTiming;
+
+// pulses waiting to be applied on an axis, in sidereal x milliseconds
+typedef struct PulseBlend {
+  bool active;
+  float remaining;
+} PulseBlend;
+
 class Guide {
   public:
     void init();
@@ -49,8 +72,19 @@ class Guide {
     // set abort true to rapidly stop (broken limit, etc)
     void stopAxis2(GuideAction stopDirection = GA_BREAK, bool abort = false);
 
+    // start an exact offset in arcseconds on either or both axes (+ is the Axis1 or Axis2 forward direction, W or N)
+    CommandError startOffset(float arcsecAxis1, float arcsecAxis2);
+
+    // returns the offset (in arcseconds) still to be applied on the specified axis
+    float offsetRemaining(uint8_t axis);
+
+    // returns true if an offset or blended pulse is still being applied
+    inline bool activeOffset() { return blendAxis1.active || blendAxis2.active; }
+
     // start spiral guide at the specified rate (spiral size is porportional to rate)
-    CommandError startSpiral(GuideRateSelect rateSelect, unsigned long guideTimeLimit);
+    // SP_STEPPED is the original spiral, SP_SPIRAL an Archimedean spiral and SP_RASTER a square spiral
+    // both of the latter move at constant speed on the sky with one field (about 2x rate in sidereal seconds) between turns
+    CommandError startSpiral(GuideRateSelect rateSelect, unsigned long guideTimeLimit, SearchPath path = SP_STEPPED);
 
     // start guide home (for use with home switches)
     CommandError startHome();
@@ -58,6 +92,11 @@ class Guide {
     // stop both axes of guide
     void stop();
 
+    // requested and actual length (in us) of the last timed pulse, returns the axis or 0 if none yet
+    inline uint8_t lastPulse(unsigned long *requested, unsigned long *actual) {
+      *requested = lastPulseRequested; *actual = lastPulseActual; return lastPulseAxis;
+    }
+
     // abort both axes of guide
     void abort();
 
@@ -113,6 +152,21 @@ class Guide {
     // start axis2 movement
     void axis2AutoSlew(GuideAction guideAction);
 
+    // mark the start of a pulse guide of timeMs at rate (signed), needs to be just before the rate is applied
+    void pulseStart(PulseTiming *pulse, GuideAction guideAction, float rate, unsigned long timeMs);
+
+    // mark the end of a pulse guide and record its actual length
+    void pulseStop(PulseTiming *pulse, uint8_t axis);
+
+    // true if the guide time is up
+    bool guideExpired(PulseTiming *pulse, uint64_t finishTime);
+
+    // adds a correction (signed, in sidereal x ms) to an axis, rate (signed) is the rate it's requested at, returns the rate to guide at
+    float blendAdd(PulseBlend *blend, GuideAction *guideAction, float rate, float correction);
+
+    // works off the corrections, stopping each axis as its correction is used up
+    void blendPoll();
+
     GuideRateSelect spiralGuideRateSelect = GR_20X;
     
     GuideAction guideActionAxis1 = GA_NONE;
@@ -126,8 +180,28 @@ class Guide {
     float spiralScaleAxis1 = 0.0F;
     unsigned long spiralStartTime = 0;
 
-    unsigned long guideFinishTimeAxis1 = 0;
-    unsigned long guideFinishTimeAxis2 = 0;
+    SearchPath spiralPath = SP_STEPPED;
+    unsigned long spiralLastTime = 0;
+    float spiralTheta = 0.0F;    // SP_SPIRAL angle along the spiral in radians
+    float spiralLeg = 0.0F;      // SP_RASTER distance along this leg in sidereal seconds
+    uint16_t spiralLegs = 0;     // SP_RASTER legs finished
+
+    uint64_t guideFinishTimeAxis1 = 0;
+    uint64_t guideFinishTimeAxis2 = 0;
+
+    PulseTiming pulseAxis1 = { false, GA_NONE, 0, 0, 0, 0, 0.0F };
+    PulseTiming pulseAxis2 = { false, GA_NONE, 0, 0, 0, 0, 0.0F };
+
+    PulseBlend blendAxis1 = { false, 0.0F };
+    PulseBlend blendAxis2 = { false, 0.0F };
+    unsigned long blendLastTime = 0;
+
+    uint8_t lastPulseAxis = 0;
+    unsigned long lastPulseRequested = 0;
+    unsigned long lastPulseActual = 0;
+
+    uint8_t taskHandle = 0;
+    uint8_t pulseCounter = 0;
 
 };
 
@@ -5,8 +5,11 @@
 
 #if defined(MOUNT_PRESENT)
 
+#include "../Mount.h"
 #include "../coordinates/Transform.h"
 #include "../goto/Goto.h"
+#include "../site/Site.h"
+#include "../coordinates/Apparent.h"
 
 char const *ObjectStr[] = {"UNK", "OC", "GC", "PN", "DN", "SG", "EG", "IG", "KNT", "SNR", "GAL", "CN", "STR", "PLA", "CMT", "AST"};
 
@@ -15,6 +18,8 @@ bool Library::command(char *reply, char *command, char *parameter, bool *supress
 
     //   L - Object Library Commands
     if (command[0] == 'L') {
+      load();
+
 
       // :LB#       Find previous catalog object subject to the current constraints
       //            Returns: Nothing
@@ -35,6 +40,15 @@ bool Library::command(char *reply, char *command, char *parameter, bool *supress
         } else *commandError = CE_PARAM_FORM;
       } else 
 
+      // :LF[s]#    Find catalog object by name (in the current catalog) and move to it
+      //            [s] is the object name, for example ":LFM31#"
+      //            Returns: 0 on failure (not found)
+      //                     1 on success
+      if (command[1] == 'F') {
+        if (parameter[0] == 0) *commandError = CE_PARAM_FORM; else
+        if (!findRec(parameter)) *commandError = CE_0;
+      } else 
+
       // :LI#       Get Object Information
       //            Returns: s# (string containing the current target object’s name and object type)
       if (command[1] == 'I' && parameter[0] == 0) {
@@ -54,6 +68,10 @@ bool Library::command(char *reply, char *command, char *parameter, bool *supress
         int i;
         Coordinate target;
         readVars(reply, &i, &target.r, &target.d);
+        #if LIBRARY_APPARENT == ON
+          apparent.update(site.getDateTime());
+          apparent.fromJ2000(&target.r, &target.d);
+        #endif
         goTo.setGotoTarget(&target);
         *numericReply = false;
       } else 
@@ -64,6 +82,10 @@ bool Library::command(char *reply, char *command, char *parameter, bool *supress
         int i;
         Coordinate target;
         readVars(reply, &i, &target.r, &target.d);
+        #if LIBRARY_APPARENT == ON
+          apparent.update(site.getDateTime());
+          apparent.fromJ2000(&target.r, &target.d);
+        #endif
         goTo.setGotoTarget(&target);
 
         char const * objType = ObjectStr[i];
@@ -117,7 +139,11 @@ bool Library::command(char *reply, char *command, char *parameter, bool *supress
         }
 
         Coordinate target = goTo.getGotoTarget();
-        if (firstFreeRec()) writeVars(name, i, target.r, target.d); else *commandError = CE_LIBRARY_FULL;
+        #if LIBRARY_APPARENT == ON
+          apparent.update(site.getDateTime());
+          apparent.toJ2000(&target.r, &target.d);
+        #endif
+        if (!firstFreeRec() || !writeVars(name, i, target.r, target.d)) *commandError = CE_LIBRARY_FULL;
       } else 
 
       // :LN#       Find next catalog object subject to the current constraints
@@ -162,6 +188,32 @@ bool Library::command(char *reply, char *command, char *parameter, bool *supress
         *numericReply = false;
       } else 
 
+      // :LV#       Get number of objects in the current catalog that are between the horizon and overhead limits
+      //            Returns: n#
+      if (command[1] == 'V' && parameter[0] == 0) { 
+        sprintf(reply, "%ld", recCountVisible());
+        *numericReply = false;
+      } else 
+
+      // :Ln#       Move to the catalog object nearest the current position
+      // :Ln[d]#    Move to the catalog object nearest the current position if within d degrees (0 to 180)
+      //            Returns: 0 on failure (none found)
+      //                     1 on success
+      if (command[1] == 'n') {
+        double radius = 180.0;
+        if (parameter[0] != 0) {
+          if (!convert.atof2(parameter, &radius, false)) { *commandError = CE_PARAM_FORM; return true; }
+          if (radius < 0.0 || radius > 180.0) { *commandError = CE_PARAM_RANGE; return true; }
+        }
+        Coordinate current = mount.getMountPosition(CR_MOUNT_EQU);
+        Coordinate position = transform.mountToNative(&current);
+        #if LIBRARY_APPARENT == ON
+          apparent.update(site.getDateTime());
+          apparent.toJ2000(&position.r, &position.d);
+        #endif
+        if (!nearestRec(position.r, position.d, degToRad(radius))) *commandError = CE_0;
+      } else 
+
       // :Lo[n]#    Select Library catalog by catalog number n
       //            Catalog number ranges from 0..14, catalogs 0..6 are user defined, the remainder are reserved
       //            Return: 0 on failure
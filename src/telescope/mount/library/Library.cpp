@@ -6,31 +6,67 @@
 #if defined(MOUNT_PRESENT)
 
 #include "../../Telescope.h"
+#include "../limits/Limits.h"
 
 char const * objectStr[] = {"UNK", "OC", "GC", "PN", "DN", "SG", "EG", "IG", "KNT", "SNR", "GAL", "CN", "STR", "PLA", "CMT", "AST"};
 
+// names that are one of these followed by a number (no leading zero) are stored as the prefix index and number
+// the order is part of the format, add new prefixes at the end (up to 32)
+char const * libraryPrefixStr[] = {"M", "NGC", "IC", "C", "UGC", "PGC", "HIP", "HD", "SAO", "HR", "Sh2-", "B", "Cr",
+                                   "Mel", "Abell", "LDN", "LBN", "vdB", "Tr", "Stock", "Arp", "HCG", "Ced", "PK"};
+#define LIBRARY_PREFIX_COUNT 24
+
+#if LIBRARY_INDEX_SIZE > 0
+  // rebuilt before use so they can live in RAM that isn't zeroed at startup
+  HAL_BULK_DATA libPosIndex_t libraryPosIndex[LIBRARY_INDEX_SIZE];
+  HAL_BULK_DATA libNameIndex_t libraryNameIndex[LIBRARY_INDEX_SIZE];
+#endif
+
 void Library::init() {
   catalog = 0;
 
   byteMin = NV_LIBRARY_DATA_BASE;
-  byteMax = nv.size - 1;
+  byteMax = nv.regionTableBase() - 1;
 
   long byteCount = (byteMax - byteMin) + 1;
   if (byteCount < 0) byteCount = 0;
   if (byteCount > 262143) byteCount = 262143; // maximum 256KB
 
-  recMax = byteCount/rec_size; // maximum number of records
+  recMax = byteCount/LIBRARY_SLOT_SIZE; // maximum number of slots
+  slotMax = recMax;
+
+  #if LIBRARY_FLASH == ON
+    flashInit();
+  #endif
 
   if (recMax == 0) { VLF("WRN: Library::init(); recMax == 0, no library space available"); return; }
 
+  // the library area is checked (and the cache filled) on first use, scanning it here slows startup
+  clearNeeded = !nv.hasValidKey() || recMax < 2;
+  loaded = false;
+  nv.addRegion(byteMin, recMax*LIBRARY_SLOT_SIZE);
+
+  VF("MSG: Mount, library allocated "); V(recMax - 1); VLF(" record slots");
+}
+
+void Library::load() {
+  if (loaded) return;
+  loaded = true;
+  if (recMax == 0) return;
+
   // write default library structure to NV
-  if (!nv.hasValidKey() || nv.isNull(byteMin, byteCount)) {
+  if (clearNeeded || nv.isNull(byteMin, recMax*LIBRARY_SLOT_SIZE)) {
     VLF("MSG: Mount, library clearing NV storage area");
     clearAll();
+  } else {
+    uint8_t header[5];
+    nv.readBytes(byteMin, header, 5);
+    if (header[0] != LIBRARY_CODE_HEADER || header[1] != 'L' || header[2] != 'i' || header[3] != 'b' || header[4] != LIBRARY_FORMAT) {
+      VLF("MSG: Mount, library converting to compact records");
+      convert();
+    }
   }
 
-   VF("MSG: Mount, library allocated "); V(recMax); VLF(" catalog records");
-
   firstRec();
 }
 
@@ -47,9 +83,10 @@ bool Library::setCatalog(int num) {
 // \param code: object classification (0 to 15)
 // \param RA: in radians
 // \param Dec: in radians
-void Library::writeVars(char* name, int code, double RA, double Dec) {
+bool Library::writeVars(char* name, int code, double RA, double Dec) {
   libRec_t work;
-  for (int16_t l = 0; l < 11; l++) work.libRec.name[l] = name[l];
+  memset(work.libRecBytes, 0, rec_size);
+  for (int16_t l = 0; l < 11; l++) { if (name[l] == 0) break; work.libRec.name[l] = name[l]; }
   work.libRec.code = (code | (catalog << 4));
 
   // convert from radians to degrees
@@ -68,7 +105,13 @@ void Library::writeVars(char* name, int code, double RA, double Dec) {
   work.libRec.RA  = r;
   work.libRec.Dec = d;
 
-  writeRec(recPos, work);
+  if (writeRec(recPos, work)) return true;
+
+  // a long name needs two free slots in a row
+  for (long l = 1; l < recMax - 1; l++) {
+    if (isFree(l) && isFree(l + 1)) { recPos = l; return writeRec(recPos, work) != 0; }
+  }
+  return false;
 }
 
 // read data for the current record
@@ -124,14 +167,14 @@ bool Library::nameRec() {
 
   recPos = -1;
   do {
-    recPos++; if (recPos >= recMax) break;
+    recPos++; if (recPos >= slotMax) break;
     work = readRec(recPos);
 
     cat = (int16_t)work.libRec.code >> 4;
 
     if (work.libRec.name[0] == '$' && cat == catalog) break;
-  } while (recPos < recMax);
-  if (recPos >= recMax) { recPos = recMax - 1; return false; }
+  } while (recPos < slotMax);
+  if (recPos >= slotMax) { recPos = slotMax - 1; return false; }
 
   return true;
 }
@@ -148,13 +191,80 @@ bool Library::firstFreeRec() {
 
     cat = (int16_t)work.libRec.code>>4;
   
-    if (cat == 15) break; // unused?
+    if (cat == 15 && isFree(recPos)) break; // unused?
   } while (recPos < recMax);
   if (recPos >= recMax) { recPos = recMax - 1; return false; }
 
   return true;
 }
 
+// move to the record (of this catalog) with this name, if it exists
+bool Library::findRec(const char *name) {
+  if (!indexed) indexBuild();
+
+  char key[12];
+  strncpy(key, name, 11);
+  key[11] = 0;
+  libRec_t work;
+
+  // records in NV come first, then any in flash
+  if (indexAvailable) {
+    #if LIBRARY_INDEX_SIZE > 0
+      if (indexFind(nameIndex, indexCount, 0, nameHash(catalog, key), key)) return true;
+    #endif
+  } else {
+    for (long l = 1; l < recMax; l++) {
+      work = readRec(l);
+      if (work.libRec.name[0] != '$' && (work.libRec.code >> 4) == catalog && strncmp(work.libRec.name, key, 11) == 0) { recPos = l; return true; }
+    }
+  }
+
+  #if LIBRARY_FLASH == ON
+    if (flashSlots != NULL && indexFind(flashNameIndex, flashIndexCount, recMax, nameHash(catalog, key), key)) return true;
+  #endif
+  return false;
+}
+
+// move to the record (of this catalog) nearest the coordinate, if one is within radius
+bool Library::nearestRec(double RA, double Dec, double radius) {
+  if (!indexed) indexBuild();
+
+  // encoded as the records are
+  RA = degRange(radToDeg(RA))/360.0;
+  Dec = radToDeg(Dec);
+  if (Dec > 90.0) Dec = 90.0;
+  if (Dec < -90.0) Dec = -90.0;
+  Dec = (Dec + 90.0)/180.0;
+  uint16_t r = (uint16_t)lround(RA*65536.0);
+  long dl = lround(Dec*65536.0);
+  uint16_t d = dl > 65535L ? 65535 : (uint16_t)dl;
+
+  long best = -1;
+  double bestDistance = radius;
+  libRec_t work;
+
+  if (indexAvailable) {
+    #if LIBRARY_INDEX_SIZE > 0
+      indexNearest(posIndex, indexCount, 0, r, d, &best, &bestDistance);
+    #endif
+  } else {
+    for (long l = 1; l < recMax; l++) {
+      work = readRec(l);
+      if (work.libRec.name[0] == '$' || (work.libRec.code >> 4) != catalog) continue;
+      double distance = recDistance(r, d, work.libRec.RA, work.libRec.Dec);
+      if (distance <= bestDistance) { bestDistance = distance; best = l; }
+    }
+  }
+
+  #if LIBRARY_FLASH == ON
+    if (flashSlots != NULL) indexNearest(flashPosIndex, flashIndexCount, recMax, r, d, &best, &bestDistance);
+  #endif
+
+  if (best < 0) return false;
+  recPos = best;
+  return true;
+}
+
 // move to the previous record, if it exists
 bool Library::prevRec() {
   libRec_t work;
@@ -178,13 +288,13 @@ bool Library::nextRec() {
   int16_t cat;
  
   do {
-    recPos++; if (recPos >= recMax) break;
+    recPos++; if (recPos >= slotMax) break;
     work=readRec(recPos);
 
     cat = (int16_t)work.libRec.code >> 4;
     if (work.libRec.name[0] != '$' && cat == catalog) break;
-  } while (recPos < recMax);
-  if (recPos >= recMax) { recPos = recMax-1; return false; }
+  } while (recPos < slotMax);
+  if (recPos >= slotMax) { recPos = slotMax-1; return false; }
 
   return true;
 }
@@ -197,7 +307,7 @@ bool Library::gotoRec(long num) {
   long r = 0;
   long c = 0;
   
-  for (long l = 0; l < recMax; l++) {
+  for (long l = 0; l < slotMax; l++) {
     work=readRec(l); r = l;
 
     cat = (int16_t)work.libRec.code >> 4;
@@ -215,7 +325,7 @@ long Library::recCount()
   int16_t cat;
   long c = 0;
   
-  for (long l = 0; l < recMax; l++) {
+  for (long l = 0; l < slotMax; l++) {
     work = readRec(l);
 
     cat = (int16_t)work.libRec.code >> 4;
@@ -225,6 +335,35 @@ long Library::recCount()
   return c;
 }
 
+// number of records for this catalog currently between the horizon and overhead limits
+long Library::recCountVisible() {
+  Coordinate coords[LIBRARY_VISIBLE_BATCH];
+  bool visible[LIBRARY_VISIBLE_BATCH];
+  long savedRecPos = recPos;
+  char name[12];
+  int code;
+  int n = 0;
+  long c = 0;
+
+  // records are collected and checked a batch at a time
+  recPos = -1;
+  while (nextRec()) {
+    readVars(name, &code, &coords[n].r, &coords[n].d);
+    if (++n == LIBRARY_VISIBLE_BATCH) {
+      limits.visibleTargets(coords, n, visible);
+      for (int i = 0; i < n; i++) if (visible[i]) c++;
+      n = 0;
+    }
+  }
+  if (n > 0) {
+    limits.visibleTargets(coords, n, visible);
+    for (int i = 0; i < n; i++) if (visible[i]) c++;
+  }
+
+  recPos = savedRecPos;
+  return c;
+}
+
 // actual number of records for this library
 long Library::recCountAll() {
   libRec_t work;
@@ -232,7 +371,7 @@ long Library::recCountAll() {
   int16_t cat;
   long c = 0;
   
-  for (long l = 0; l < recMax; l++) {
+  for (long l = 0; l < slotMax; l++) {
     work = readRec(l);
 
     cat = (int16_t)work.libRec.code >> 4;
@@ -270,33 +409,296 @@ void Library::clearLib() {
 
 // clear library (clear all catalogs)
 void Library::clearAll() {
-  for (long l = 0; l < recMax; l++) clearRec(l);
+  if (recMax < 2) return;
+
+  indexed = false;
+  uint8_t slot[LIBRARY_SLOT_SIZE] = { LIBRARY_CODE_HEADER, 'L', 'i', 'b', LIBRARY_FORMAT, 0, 0, 0 };
+  nv.writeBytes(byteMin, slot, LIBRARY_SLOT_SIZE);
+  for (long l = 1; l < recMax; l++) nv.write(l*LIBRARY_SLOT_SIZE + byteMin, (uint8_t)LIBRARY_CODE_FREE);
 }
 
 // number records available for this library
 long Library::recFreeAll() {
-  return recMax - recCountAll();
+  long c = 0;
+  for (long l = 1; l < recMax; l++) if (isFree(l)) c++;
+  return c;
+}
+
+// number of slots, slot 0 is the format header and the rest hold records as they are kept in NV
+long Library::slotCount() {
+  load();
+  return recMax;
+}
+
+// bulk transfer of count raw slots starting at slot (1 or more), false if out of range
+bool Library::readSlots(long slot, uint8_t *data, int count) {
+  load();
+  if (slot < 1 || count < 1 || slot + count > recMax) return false;
+  nv.readBytes(slot*LIBRARY_SLOT_SIZE + byteMin, data, count*LIBRARY_SLOT_SIZE);
+  return true;
+}
+
+bool Library::writeSlots(long slot, const uint8_t *data, int count) {
+  load();
+  if (slot < 1 || count < 1 || slot + count > recMax) return false;
+
+  // straight into the cache as one block, it goes out with the next commit
+  indexed = false;
+  nv.writeBytes(slot*LIBRARY_SLOT_SIZE + byteMin, (void*)data, count*LIBRARY_SLOT_SIZE);
+  return true;
+}
+
+// rewrite a library of 16 byte records (the earlier format) into slots
+void Library::convert() {
+  long oldMax = (recMax*LIBRARY_SLOT_SIZE)/rec_size;
+  long l = 1;
+  indexed = false;
+
+  // slots are never written past the old record that follows, so one record read ahead is enough
+  libRec_t work, next;
+  nv.readBytes(byteMin, next.libRecBytes, rec_size);
+  for (long k = 0; k < oldMax; k++) {
+    work = next;
+    if (k + 1 < oldMax) nv.readBytes((k + 1)*rec_size + byteMin, next.libRecBytes, rec_size);
+
+    if ((work.libRec.code >> 4) == 15) continue;
+    uint8_t slot[2][LIBRARY_SLOT_SIZE];
+    int slots = encodeRec(&work, slot);
+    if (l + slots > recMax) break;
+    nv.writeBytes(l*LIBRARY_SLOT_SIZE + byteMin, slot, slots*LIBRARY_SLOT_SIZE);
+    l += slots;
+  }
+  for (; l < recMax; l++) nv.write(l*LIBRARY_SLOT_SIZE + byteMin, (uint8_t)LIBRARY_CODE_FREE);
+
+  // the header goes last
+  uint8_t slot[LIBRARY_SLOT_SIZE] = { LIBRARY_CODE_HEADER, 'L', 'i', 'b', LIBRARY_FORMAT, 0, 0, 0 };
+  nv.writeBytes(byteMin, slot, LIBRARY_SLOT_SIZE);
+}
+
+#if LIBRARY_INDEX_SIZE > 0
+  static int comparePosIndex(const void *a, const void *b) {
+    uint16_t d1 = ((const libPosIndex_t*)a)->Dec;
+    uint16_t d2 = ((const libPosIndex_t*)b)->Dec;
+    return (d1 > d2) - (d1 < d2);
+  }
+
+  static int compareNameIndex(const void *a, const void *b) {
+    uint16_t h1 = ((const libNameIndex_t*)a)->hash;
+    uint16_t h2 = ((const libNameIndex_t*)b)->hash;
+    return (h1 > h2) - (h1 < h2);
+  }
+#endif
+
+// fill the name and position indexes from NV, on the first search after a change
+void Library::indexBuild() {
+  indexed = true;
+  indexAvailable = false;
+  indexCount = 0;
+
+  #if LIBRARY_INDEX_SIZE > 0
+    for (long l = 1; l < recMax; l++) {
+      libRec_t work = readRec(l);
+      int16_t cat = work.libRec.code >> 4;
+      if (cat == 15 || work.libRec.name[0] == '$') continue;
+
+      if (indexCount >= LIBRARY_INDEX_SIZE) { VLF("MSG: Mount, library too large to index"); return; }
+      posIndex[indexCount].slot = l;
+      posIndex[indexCount].cat = cat;
+      posIndex[indexCount].RA = work.libRec.RA;
+      posIndex[indexCount].Dec = work.libRec.Dec;
+      nameIndex[indexCount].hash = nameHash(cat, work.libRec.name);
+      nameIndex[indexCount].slot = l;
+      indexCount++;
+    }
+
+    qsort(posIndex, indexCount, sizeof(libPosIndex_t), comparePosIndex);
+    qsort(nameIndex, indexCount, sizeof(libNameIndex_t), compareNameIndex);
+    indexAvailable = true;
+  #endif
+}
+
+// hash of catalog and name (to 11 chars)
+uint16_t Library::nameHash(int cat, const char *name) {
+  uint32_t h = (2166136261UL ^ cat)*16777619UL;
+  for (int l = 0; l < 11 && name[l] != 0; l++) { h ^= (uint8_t)name[l]; h *= 16777619UL; }
+  return (h >> 16) ^ (h & 0xFFFF);
+}
+
+// search a name index for the record (of this catalog) with this hash and name, index slots are offset by base
+bool Library::indexFind(const libNameIndex_t *index, long count, long base, uint16_t hash, const char *key) {
+  long lo = 0, hi = count;
+  while (lo < hi) { long mid = (lo + hi)/2; if (index[mid].hash < hash) lo = mid + 1; else hi = mid; }
+
+  // candidates share the hash, the record settles it
+  for (; lo < count && index[lo].hash == hash; lo++) {
+    libRec_t work = readRec(base + index[lo].slot);
+    if ((work.libRec.code >> 4) == catalog && strncmp(work.libRec.name, key, 11) == 0) { recPos = base + index[lo].slot; return true; }
+  }
+  return false;
+}
+
+// search a position index for the record (of this catalog) nearest the encoded coordinate, index slots are offset by base
+void Library::indexNearest(const libPosIndex_t *index, long count, long base, uint16_t r, uint16_t d, long *best, double *bestDistance) {
+  long lo = 0, hi = count;
+  while (lo < hi) { long mid = (lo + hi)/2; if (index[mid].Dec < d) lo = mid + 1; else hi = mid; }
+
+  // work outward in Dec from the coordinate, the Dec difference alone rules out the rest once it's past the best so far
+  const double decStep = Deg180/65536.0;
+  long i = lo - 1, j = lo;
+  while (i >= 0 || j < count) {
+    if (j < count) {
+      if (((long)index[j].Dec - d)*decStep > *bestDistance) j = count; else {
+        if (index[j].cat == catalog) {
+          double distance = recDistance(r, d, index[j].RA, index[j].Dec);
+          if (distance <= *bestDistance) { *bestDistance = distance; *best = base + index[j].slot; }
+        }
+        j++;
+      }
+    }
+    if (i >= 0) {
+      if (((long)d - index[i].Dec)*decStep > *bestDistance) i = -1; else {
+        if (index[i].cat == catalog) {
+          double distance = recDistance(r, d, index[i].RA, index[i].Dec);
+          if (distance <= *bestDistance) { *bestDistance = distance; *best = base + index[i].slot; }
+        }
+        i--;
+      }
+    }
+  }
+}
+
+// angle between two records coordinates in radians
+double Library::recDistance(uint16_t RA1, uint16_t Dec1, uint16_t RA2, uint16_t Dec2) {
+  double r1 = (RA1/65536.0)*Deg360, d1 = (Dec1/65536.0)*Deg180 - Deg90;
+  double r2 = (RA2/65536.0)*Deg360, d2 = (Dec2/65536.0)*Deg180 - Deg90;
+  double a = sin((d2 - d1)/2.0);
+  double b = sin((r2 - r1)/2.0);
+  double h = a*a + cos(d1)*cos(d2)*b*b;
+  if (h > 1.0) h = 1.0;
+  return 2.0*asin(sqrt(h));
 }
 
 libRec_t Library::readRec(long address) {
   libRec_t work;
-  long l = address*rec_size + byteMin;
-  nv.readBytes(l, (uint8_t*)&work.libRecBytes, 16);
+  memset(work.libRecBytes, 0, rec_size);
+  work.libRec.code = LIBRARY_CODE_FREE;
+  if (address < 0 || address >= slotMax) return work;
+
+  uint8_t slot[LIBRARY_SLOT_SIZE];
+  readSlot(address, slot);
+  work.libRec.code = slot[0];
+  if ((slot[0] >> 4) == 15) return work;
+
+  work.libRec.RA = slot[1] | ((uint16_t)slot[2] << 8);
+  work.libRec.Dec = slot[3] | ((uint16_t)slot[4] << 8);
+
+  uint32_t n = ((uint32_t)slot[5] << 16) | ((uint32_t)slot[6] << 8) | slot[7];
+  if (n & LIBRARY_NAME_NUMBER) {
+    uint8_t prefix = (n >> 18) & 31;
+    char name[18];
+    sprintf(name, "%s%ld", prefix < LIBRARY_PREFIX_COUNT ? libraryPrefixStr[prefix] : "?", (long)(n & LIBRARY_NUMBER_MAX));
+    strncpy(work.libRec.name, name, 11);
+  } else {
+    work.libRec.name[0] = (n >> 14) & 127;
+    work.libRec.name[1] = (n >> 7) & 127;
+    work.libRec.name[2] = n & 127;
+    if ((n & LIBRARY_NAME_LONG) && address + 1 < slotMax) {
+      readSlot(address + 1, slot);
+      if (slot[0] == LIBRARY_CODE_NAME) {
+        uint64_t t = 0;
+        for (int m = 1; m < LIBRARY_SLOT_SIZE; m++) t = (t << 8) | slot[m];
+        for (int m = 0; m < 8; m++) work.libRec.name[3 + m] = (t >> (7*(7 - m))) & 127;
+      }
+    }
+  }
   return work;
 }
 
-void Library::writeRec(long address, libRec_t data) {
-  if (address >= 0 && address < recMax) {
-    long l = address*rec_size + byteMin;
-    for (int m = 0; m < 16; m++) nv.write(l+m, data.libRecBytes[m]);
+void Library::readSlot(long address, uint8_t *slot) {
+  #if LIBRARY_FLASH == ON
+    if (address >= recMax) { memcpy(slot, &flashSlots[(address - recMax)*LIBRARY_SLOT_SIZE], LIBRARY_SLOT_SIZE); return; }
+  #endif
+  nv.readBytes(address*LIBRARY_SLOT_SIZE + byteMin, slot, LIBRARY_SLOT_SIZE);
+}
+
+int Library::writeRec(long address, libRec_t data) {
+  uint8_t slot[2][LIBRARY_SLOT_SIZE];
+  int slots = encodeRec(&data, slot);
+  if (address < 1 || address + slots > recMax) return 0;
+  if (slots == 2 && !isFree(address + 1)) return 0;
+
+  indexed = false;
+  nv.writeBytes(address*LIBRARY_SLOT_SIZE + byteMin, slot, slots*LIBRARY_SLOT_SIZE);
+  return slots;
+}
+
+int Library::encodeRec(libRec_t *data, uint8_t slot[2][LIBRARY_SLOT_SIZE]) {
+  char name[12];
+  memcpy(name, data->libRec.name, 11);
+  name[11] = 0;
+  int len = strlen(name);
+
+  slot[0][0] = data->libRec.code;
+  slot[0][1] = data->libRec.RA & 0xFF;
+  slot[0][2] = data->libRec.RA >> 8;
+  slot[0][3] = data->libRec.Dec & 0xFF;
+  slot[0][4] = data->libRec.Dec >> 8;
+
+  // catalog designations, only when the name reads back exactly the same
+  uint32_t n = 0;
+  for (uint8_t p = 0; p < LIBRARY_PREFIX_COUNT; p++) {
+    int plen = strlen(libraryPrefixStr[p]);
+    if (len <= plen || strncmp(name, libraryPrefixStr[p], plen) != 0) continue;
+    if (name[plen] == '0' && len > plen + 1) continue;
+
+    bool digits = true;
+    for (int m = plen; m < len; m++) if (name[m] < '0' || name[m] > '9') { digits = false; break; }
+    if (!digits || len - plen > 6) continue;
+
+    long number = atol(&name[plen]);
+    if (number > LIBRARY_NUMBER_MAX) continue;
+    n = LIBRARY_NAME_NUMBER | ((uint32_t)p << 18) | number;
+    break;
   }
+
+  // otherwise as 7-bit text, the first 3 characters here and up to 8 more in a continuation slot
+  int slots = 1;
+  if (n == 0) {
+    for (int m = 0; m < 11; m++) if ((uint8_t)name[m] > 127) name[m] = '?';
+    n = ((uint32_t)name[0] << 14) | ((uint32_t)name[1] << 7) | (uint32_t)name[2];
+    if (len > 3) {
+      n |= LIBRARY_NAME_LONG;
+      uint64_t t = 0;
+      for (int m = 3; m < 11; m++) t = (t << 7) | (uint8_t)name[m];
+      slot[1][0] = LIBRARY_CODE_NAME;
+      for (int m = LIBRARY_SLOT_SIZE - 1; m >= 1; m--) { slot[1][m] = t & 0xFF; t >>= 8; }
+      slots = 2;
+    }
+  }
+
+  slot[0][5] = (n >> 16) & 0xFF;
+  slot[0][6] = (n >> 8) & 0xFF;
+  slot[0][7] = n & 0xFF;
+  return slots;
+}
+
+bool Library::isFree(long address) {
+  if (address < 1 || address >= recMax) return false;
+  uint8_t code = nv.read(address*LIBRARY_SLOT_SIZE + byteMin);
+  return (code >> 4) == 15 && code != LIBRARY_CODE_HEADER && code != LIBRARY_CODE_NAME;
 }
 
 void Library::clearRec(long address) {
-  if (address >= 0 && address < recMax) {
-    long l = address*rec_size+byteMin;
-    int code = 15 << 4;
-    nv.write(l + 11, (byte)code); // catalog code 15 = deleted
+  if (address >= 1 && address < recMax) {
+    long l = address*LIBRARY_SLOT_SIZE + byteMin;
+    uint8_t code = nv.read(l);
+    if ((code >> 4) == 15) return;
+    indexed = false;
+
+    // along with the rest of the name, if any
+    if (!(nv.read(l + 5) & 0x80) && (nv.read(l + 5) & 0x40) && address + 1 < recMax &&
+        nv.read(l + LIBRARY_SLOT_SIZE) == LIBRARY_CODE_NAME) nv.write(l + LIBRARY_SLOT_SIZE, (uint8_t)LIBRARY_CODE_FREE);
+    nv.write(l, (uint8_t)LIBRARY_CODE_FREE); // catalog code 15 = deleted
   }
 }
 
@@ -0,0 +1,45 @@
+// -----------------------------------------------------------------------------------
+// telescope celestial object library, prebuilt catalogs in flash
+
+#include "Library.h"
+
+#if defined(MOUNT_PRESENT) && LIBRARY_FLASH == ON
+
+#include <esp_partition.h>
+#include <esp_idf_version.h>
+
+void Library::flashInit() {
+  const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "catalog");
+  if (partition == NULL) { VLF("WRN: Library::flashInit(); no catalog partition"); return; }
+
+  // mapped through the flash cache so records and the index are read as ordinary memory
+  const void *map = NULL;
+  #if ESP_IDF_VERSION_MAJOR >= 5
+    esp_partition_mmap_handle_t handle;
+    esp_err_t result = esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &map, &handle);
+  #else
+    spi_flash_mmap_handle_t handle;
+    esp_err_t result = esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &map, &handle);
+  #endif
+  if (result != ESP_OK) { DLF("ERR: Library::flashInit(); catalog partition map failed"); return; }
+
+  const libFlashHeader_t *header = (const libFlashHeader_t*)map;
+  if (strncmp(header->id, "LibF", 4) != 0 || header->format != LIBRARY_FORMAT) { VLF("WRN: Library::flashInit(); no catalog image in the partition"); return; }
+
+  // index entries hold 16 bit slot numbers
+  uint32_t bytes = sizeof(libFlashHeader_t) + header->slots*LIBRARY_SLOT_SIZE + header->indexCount*(sizeof(libPosIndex_t) + sizeof(libNameIndex_t));
+  if (header->slots > 65536UL || header->indexCount > header->slots || bytes > partition->size) {
+    DLF("ERR: Library::flashInit(); catalog image size error");
+    return;
+  }
+
+  flashSlots = (const uint8_t*)map + sizeof(libFlashHeader_t);
+  flashPosIndex = (const libPosIndex_t*)(flashSlots + header->slots*LIBRARY_SLOT_SIZE);
+  flashNameIndex = (const libNameIndex_t*)(flashPosIndex + header->indexCount);
+  flashIndexCount = header->indexCount;
+  slotMax = recMax + header->slots;
+
+  VF("MSG: Mount, library mapped "); V(header->slots); VLF(" record slots from flash");
+}
+
+#endif
@@ -9,14 +9,33 @@
 #include "../../../lib/convert/Convert.h"
 #include "../../../libApp/commands/ProcessCmds.h"
 
-#if AXIS1_PEC == ON
-  #define NV_LIBRARY_DATA_BASE NV_PEC_BUFFER_BASE + PEC_BUFFER_SIZE_LIMIT
-#else
-  #define NV_LIBRARY_DATA_BASE NV_PEC_BUFFER_BASE + 0
+// the library follows the PEC buffer, horizon mask, focuser TCF tables, pointing model slots, and position journal, if present
+#define NV_LIBRARY_DATA_BASE (NV_MOUNT_JOURNAL_BASE + NV_MOUNT_JOURNAL_SIZE)
+
+// records are kept in 8 byte slots: code, RA, Dec, and a 3 byte name field.  The name field holds
+// either a catalog prefix and number (M31, NGC7000, ...) or up to 3 characters of 7-bit text, a
+// longer name continues in the following slot.  The first slot marks the format.
+#define LIBRARY_SLOT_SIZE     8
+#define LIBRARY_CODE_HEADER   0xFD           // first slot, followed by "Lib" and the format version
+#define LIBRARY_CODE_NAME     0xFE           // continuation slot, 8 more characters of the name
+#define LIBRARY_CODE_FREE     0xF0           // catalog 15, an unused slot
+#define LIBRARY_NAME_NUMBER   0x800000UL     // name field is a 5 bit prefix and an 18 bit number
+#define LIBRARY_NAME_LONG     0x400000UL     // name field text continues in the next slot
+#define LIBRARY_NUMBER_MAX    262143L
+#define LIBRARY_FORMAT        1
+
+// objects indexed in RAM by name and position, beyond this searches fall back to reading every record
+#ifndef LIBRARY_INDEX_SIZE
+  #ifdef HAL_FAST_PROCESSOR
+    #define LIBRARY_INDEX_SIZE 512
+  #else
+    #define LIBRARY_INDEX_SIZE 0
+  #endif
 #endif
 
 #pragma pack(1)
 const int rec_size = 16;
+#define LIBRARY_VISIBLE_BATCH 8
 typedef struct {
   char name[11]; // 11
   byte code;     // 1 (low 4 bits are object class, high are catalog #)
@@ -28,13 +47,46 @@ typedef union {
   libRecBase_t libRec;
   byte libRecBytes[rec_size];
 } libRec_t;
+
+// position index entry, kept sorted by Dec
+typedef struct {
+  uint16_t slot;
+  uint8_t cat;
+  uint16_t RA;
+  uint16_t Dec;
+} libPosIndex_t;
+
+// name index entry, kept sorted by hash
+typedef struct {
+  uint16_t hash;
+  uint16_t slot;
+} libNameIndex_t;
+
+// a catalog image prebuilt into the "catalog" flash partition and read in place: this header, its slots (as
+// in NV), then a position and a name index sorted as above with slots counted from the image's first slot
+// and names hashed as Library::nameHash() does
+typedef struct {
+  char id[4];           // "LibF"
+  uint8_t format;       // LIBRARY_FORMAT
+  uint8_t reserved[3];
+  uint32_t slots;
+  uint32_t indexCount;
+} libFlashHeader_t;
 #pragma pack()
 
+#if LIBRARY_INDEX_SIZE > 0
+  extern libPosIndex_t libraryPosIndex[LIBRARY_INDEX_SIZE];
+  extern libNameIndex_t libraryNameIndex[LIBRARY_INDEX_SIZE];
+#endif
+
 class Library
 {
   public:
     void init();
 
+    // bytes of RAM taken by the position and name index
+    inline uint32_t getIndexBytes() { return LIBRARY_INDEX_SIZE*(sizeof(libPosIndex_t) + sizeof(libNameIndex_t)); }
+
     bool command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
 
     // select catalog by number (0 to 14)
@@ -45,7 +97,8 @@ class Library
     // \param code: object classification (0 to 15)
     // \param RA: in radians
     // \param Dec: in radians
-    void writeVars(char* name, int code, double RA, double Dec);
+    // \return false if a long name didn't find two free slots in a row
+    bool writeVars(char* name, int code, double RA, double Dec);
 
     // read data for the current record
     // \param name: object name (to 12 chars)
@@ -63,6 +116,15 @@ class Library
     // move to the first unused record for this catalog
     bool firstFreeRec();
 
+    // move to the record (of this catalog) with this name, if it exists
+    bool findRec(const char *name);
+
+    // move to the record (of this catalog) nearest the coordinate, if one is within radius
+    // \param RA: in radians
+    // \param Dec: in radians
+    // \param radius: in radians
+    bool nearestRec(double RA, double Dec, double radius);
+
     // move to the previous record, if it exists
     bool prevRec();
 
@@ -75,6 +137,9 @@ class Library
     // actual number of records for this catalog
     long recCount();
 
+    // number of records for this catalog currently between the horizon and overhead limits
+    long recCountVisible();
+
     // actual number of records for this library
     long recCountAll();
 
@@ -90,18 +155,84 @@ class Library
     // number records available for this library
     long recFreeAll();
 
+    // number of slots, slot 0 is the format header and the rest hold records as they are kept in NV
+    long slotCount();
+
+    // bulk transfer of count raw slots starting at slot (1 or more), false if out of range
+    bool readSlots(long slot, uint8_t *data, int count);
+    bool writeSlots(long slot, const uint8_t *data, int count);
+
   private:
-    // currently selected record#   
+    // check the library area and select the first record, once before first use
+    void load();
+
+    // rewrite a library of 16 byte records (the earlier format) into slots
+    void convert();
+
+    // fill the name and position indexes from NV, on the first search after a change
+    void indexBuild();
+
+    // hash of catalog and name (to 11 chars)
+    uint16_t nameHash(int cat, const char *name);
+
+    // search a name index for the record (of this catalog) with this hash and name, index slots are offset by base
+    bool indexFind(const libNameIndex_t *index, long count, long base, uint16_t hash, const char *key);
+
+    // search a position index for the record (of this catalog) nearest the encoded coordinate, index slots are offset by base
+    void indexNearest(const libPosIndex_t *index, long count, long base, uint16_t r, uint16_t d, long *best, double *bestDistance);
+
+    #if LIBRARY_FLASH == ON
+      // map the catalog partition, if it holds an image its slots follow those in NV and are read-only
+      void flashInit();
+
+      const uint8_t *flashSlots = NULL;
+      const libPosIndex_t *flashPosIndex = NULL;
+      const libNameIndex_t *flashNameIndex = NULL;
+      long flashIndexCount = 0;
+    #endif
+
+    // angle between two records coordinates in radians
+    double recDistance(uint16_t RA1, uint16_t Dec1, uint16_t RA2, uint16_t Dec2);
+
+    bool indexed = false;
+    bool indexAvailable = false;
+    #if LIBRARY_INDEX_SIZE > 0
+      // the index is kept outside the object so it can be placed with HAL_BULK_DATA
+      libPosIndex_t *posIndex = libraryPosIndex;
+      libNameIndex_t *nameIndex = libraryNameIndex;
+    #endif
+    int indexCount = 0;
+
+    bool loaded = true;
+    bool clearNeeded = false;
+
+    // currently selected slot#   
     long recPos;            
 
-    // last record#
+    // number of slots in NV
     long recMax;            
 
+    // number of slots including any in flash
+    long slotMax = 0;
+
     // 16 byte record
     libRec_t list;
 
+    // read the slot at address decoded into a 16 byte record, continuation and header slots read as catalog 15
     libRec_t readRec(long address);
-    void writeRec(long address, libRec_t data);
+
+    // read the raw slot at address from NV or flash
+    void readSlot(long address, uint8_t *slot);
+
+    // write a record at address, returns the number of slots used (1 or 2) or 0 if it doesn't fit
+    int writeRec(long address, libRec_t data);
+
+    // encode a record into one or two slots, returns the number of slots
+    int encodeRec(libRec_t *data, uint8_t slot[2][LIBRARY_SLOT_SIZE]);
+
+    // true if the slot at address is unused
+    bool isFree(long address);
+
     void clearRec(long address);
     inline double degRange(double d) { while (d >= 360.0) d -= 360.0; while (d < 0.0)  d += 360.0; return d; }
 
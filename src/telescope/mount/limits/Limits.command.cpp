@@ -44,7 +44,22 @@ bool Limits::command(char *reply, char *command, char *parameter, bool *supressF
         case 'D': sprintf(reply,"%ld",lroundf(radToDegF(axis2.settings.limits.max))); break;       // Dec north or +Alt limit, in degrees
         default: return false;
       }
-    } else return false;
+    } else
+
+    #if HORIZON_MASK != OFF
+      // :GXH[n]#   Get horizon mask at azimuth [n] in degrees (0 to 359)
+      //            Returns: sDD# or N# if there is no mask there
+      if (command[1] == 'X' && parameter[0] == 'H') {
+        char *conv_end;
+        long azimuth = strtol(&parameter[1], &conv_end, 10);
+        if (&parameter[1] == conv_end || *conv_end != 0) { *commandError = CE_PARAM_FORM; return true; }
+        if (azimuth < 0 || azimuth > 359) { *commandError = CE_PARAM_RANGE; return true; }
+        int8_t altitude = getHorizonMask(azimuth);
+        if (altitude == HORIZON_MASK_NONE) strcpy(reply, "N"); else sprintf(reply, "%+02d", (int)altitude);
+        *numericReply = false;
+      } else
+    #endif
+    return false;
   } else
   
   if (command[0] == 'S') {
@@ -98,7 +113,29 @@ bool Limits::command(char *reply, char *command, char *parameter, bool *supressF
         break;
         default: return false;
       }
-    } else return false;
+    } else
+
+    #if HORIZON_MASK != OFF
+      //  :SXH[n],[sDD]#
+      //  :SXH[n],N#
+      //            Set the horizon mask at azimuth [n] in degrees (0 to 359) to altitude [sDD] (-30 to 90) or N for none
+      //            the mask applies to the whole bin (HORIZON_MASK degrees) holding [n]
+      //            Return: 0 on failure or 1 on success
+      if (command[1] == 'X' && parameter[0] == 'H') {
+        char *conv_end;
+        long azimuth = strtol(&parameter[1], &conv_end, 10);
+        if (&parameter[1] == conv_end || *conv_end != ',') { *commandError = CE_PARAM_FORM; return true; }
+        if (azimuth < 0 || azimuth > 359) { *commandError = CE_PARAM_RANGE; return true; }
+        char *value = conv_end + 1;
+        if (value[0] == 'N' && value[1] == 0) setHorizonMask(azimuth, HORIZON_MASK_NONE); else {
+          long altitude = strtol(value, &conv_end, 10);
+          if (value == conv_end || *conv_end != 0) { *commandError = CE_PARAM_FORM; return true; }
+          if (altitude < -30 || altitude > 90) { *commandError = CE_PARAM_RANGE; return true; }
+          setHorizonMask(azimuth, altitude);
+        }
+      } else
+    #endif
+    return false;
   } else return false;
 
   return true;
@@ -30,9 +30,23 @@ void Limits::init() {
 
   constrainMeridianLimits();
 
+  #if HORIZON_MASK != OFF
+    if (!nv.hasValidKey() || nv.isNull(NV_HORIZON_MASK_BASE, NV_HORIZON_MASK_SIZE)) {
+      VLF("MSG: Mount, limits writing default horizon mask to NV");
+      for (int i = 0; i < HORIZON_MASK_BINS; i++) nv.write(NV_HORIZON_MASK_BASE + i, (int8_t)HORIZON_MASK_NONE);
+    }
+    nv.readBytes(NV_HORIZON_MASK_BASE, horizonMask, NV_HORIZON_MASK_SIZE);
+    for (int i = 0; i < HORIZON_MASK_BINS; i++) if (horizonMask[i] < -30 || horizonMask[i] > 90) horizonMask[i] = HORIZON_MASK_NONE;
+    horizonMaskUpdate();
+  #endif
+
   // start limit monitor task
   VF("MSG: Mount, limits start monitor task (rate 100ms priority 2)... ");
   if (tasks.add(100, 0, true, 2, limitsWrapper, "MntLmt")) { VLF("success"); } else { VLF("FAILED!"); }
+
+  #ifdef WATCHDOG_PRESENT
+    heartbeatHandle = watchdog.heartbeatRegister("MntLmt");
+  #endif
 }
 
 // constrain meridian limits to the allowed range
@@ -55,9 +69,42 @@ void Limits::constrainMeridianLimits() {
   }
 }
 
+#if HORIZON_MASK != OFF
+// horizon limit in radians at azimuth z (in radians), the higher of the horizon limit and the mask
+float Limits::horizon(double z) {
+  double azimuth = fmod(radToDeg(z), 360.0);
+  if (azimuth < 0.0) azimuth += 360.0;
+  int bin = (int)(azimuth/HORIZON_MASK);
+  if (bin >= HORIZON_MASK_BINS) bin = 0;
+  if (horizonMask[bin] == HORIZON_MASK_NONE) return settings.altitude.min;
+  float mask = degToRadF(horizonMask[bin]);
+  return mask > settings.altitude.min ? mask : settings.altitude.min;
+}
+
+// set the horizon mask in degrees for the bin holding azimuth (in degrees), HORIZON_MASK_NONE for no mask
+void Limits::setHorizonMask(int azimuth, int8_t altitude) {
+  int bin = azimuth/HORIZON_MASK;
+  horizonMask[bin] = altitude;
+  nv.update(NV_HORIZON_MASK_BASE + bin, altitude);
+  horizonMaskUpdate();
+}
+
+// find the highest mask, above this the azimuth isn't needed
+void Limits::horizonMaskUpdate() {
+  horizonMaskMax = -Deg90;
+  for (int i = 0; i < HORIZON_MASK_BINS; i++) {
+    if (horizonMask[i] != HORIZON_MASK_NONE && degToRadF(horizonMask[i]) > horizonMaskMax) horizonMaskMax = degToRadF(horizonMask[i]);
+  }
+}
+#endif
+
 // target coordinate check ahead of sync, goto, etc.
 CommandError Limits::validateTarget(Coordinate *coords) {
-  if (flt(coords->a, settings.altitude.min)) return CE_SLEW_ERR_BELOW_HORIZON;
+  #if HORIZON_MASK != OFF
+    if (flt(coords->a, horizon(coords->z))) return CE_SLEW_ERR_BELOW_HORIZON;
+  #else
+    if (flt(coords->a, settings.altitude.min)) return CE_SLEW_ERR_BELOW_HORIZON;
+  #endif
   if (fgt(coords->a, settings.altitude.max)) return CE_SLEW_ERR_ABOVE_OVERHEAD;
   if (transform.mountType == ALTAZM) {
     if (flt(coords->z, axis1.settings.limits.min)) return CE_SLEW_ERR_OUTSIDE_LIMITS;
@@ -90,6 +137,70 @@ CommandError Limits::validateTarget(Coordinate *coords) {
   return CE_NONE;
 }
 
+// check one point along a slew path (Mount coordinates with Horizon coordinates) against the limits
+CommandError Limits::validatePathPoint(Coordinate *p) {
+  #if HORIZON_MASK != OFF
+    float horizonLimit = horizon(p->z);
+  #else
+    float horizonLimit = settings.altitude.min;
+  #endif
+  if (flt(p->a, horizonLimit)) { VF("MSG: Mount, validate failed path below the horizon at Az "); V(radToDeg(p->z)); VLF(" deg"); return CE_SLEW_ERR_BELOW_HORIZON; }
+  if (fgt(p->a, settings.altitude.max)) { VLF("MSG: Mount, validate failed path above the overhead limit"); return CE_SLEW_ERR_ABOVE_OVERHEAD; }
+
+  if (transform.mountType != ALTAZM && transform.meridianFlips) {
+    if ((p->pierSide == PIER_SIDE_EAST && p->h < -settings.pastMeridianE) ||
+        (p->pierSide == PIER_SIDE_WEST && p->h > settings.pastMeridianW)) { VLF("MSG: Mount, validate failed path past the meridian limit"); return CE_SLEW_ERR_OUTSIDE_LIMITS; }
+  }
+
+  // the azimuth axis unwraps, so for alt/az only its end points are checked
+  double a1, a2;
+  transform.mountToInstrument(p, &a1, &a2);
+  if (transform.mountType != ALTAZM && (flt(a1, axis1.settings.limits.min) || fgt(a1, axis1.settings.limits.max))) { VLF("MSG: Mount, validate failed path past an axis1 limit"); return CE_SLEW_ERR_OUTSIDE_LIMITS; }
+  if (AXIS2_TANGENT_ARM == OFF && (flt(a2, axis2.settings.limits.min) || fgt(a2, axis2.settings.limits.max))) { VLF("MSG: Mount, validate failed path past an axis2 limit"); return CE_SLEW_ERR_OUTSIDE_LIMITS; }
+  return CE_NONE;
+}
+
+// check the path of a slew between two Mount coordinates against the altitude, meridian, and axis limits
+CommandError Limits::validatePath(Coordinate *from, Coordinate *to) {
+  Coordinate points[LIMITS_PATH_SAMPLES - 1];
+  int count = LIMITS_PATH_SAMPLES - 1;
+
+  // the axes move close to linearly in Mount coordinates, so sample along that line
+  for (int i = 0; i < count; i++) {
+    double f = (i + 1.0)/LIMITS_PATH_SAMPLES;
+    points[i] = *to;
+    if (transform.mountType == ALTAZM) {
+      points[i].z = from->z + (to->z - from->z)*f;
+      points[i].a = from->a + (to->a - from->a)*f;
+    } else {
+      points[i].h = from->h + (to->h - from->h)*f;
+      points[i].d = from->d + (to->d - from->d)*f;
+    }
+  }
+  if (transform.mountType != ALTAZM) transform.equToHorN(points, count);
+
+  // a path that starts out past a limit may move back inside, only running into one along the way fails
+  bool clear = false;
+  for (int i = 0; i < count; i++) {
+    CommandError e = validatePathPoint(&points[i]);
+    if (e == CE_NONE) clear = true; else if (clear) return e;
+  }
+  return CE_NONE;
+}
+
+// horizon and overhead limit check for an array of equatorial coordinates
+void Limits::visibleTargets(Coordinate *coords, int count, bool *visible) {
+  transform.rightAscensionToHourAngleN(coords, count, true);
+  transform.equToAltN(coords, count);
+  for (int i = 0; i < count; i++) {
+    float horizonLimit = settings.altitude.min;
+    #if HORIZON_MASK != OFF
+      if (coords[i].a < horizonMaskMax) { transform.equToHor(&coords[i]); horizonLimit = horizon(coords[i].z); }
+    #endif
+    visible[i] = !flt(coords[i].a, horizonLimit) && !fgt(coords[i].a, settings.altitude.max);
+  }
+}
+
 // true if an error exists
 bool Limits::isError() {
   return initError.nv ||
@@ -175,6 +286,10 @@ void Limits::stopAxis2(GuideAction stopDirection) {
 }
 
 void Limits::poll() {
+  #ifdef WATCHDOG_PRESENT
+    watchdog.heartbeat(heartbeatHandle);
+  #endif
+
   static int autoFlipDelayCycles = 0;
   if (autoFlipDelayCycles > 0) autoFlipDelayCycles--;
 
@@ -184,7 +299,15 @@ void Limits::poll() {
 
   if (limitsEnabled) {
     // overhead and horizon limits
-    if (current.a < settings.altitude.min) error.altitude.min = true; else error.altitude.min = false;
+    float horizonLimit = settings.altitude.min;
+    #if HORIZON_MASK != OFF
+      // the azimuth is only needed when low enough for the mask to matter
+      if (current.a < horizonMaskMax) {
+        if (transform.mountType != ALTAZM) transform.equToHor(&current);
+        horizonLimit = horizon(current.z);
+      }
+    #endif
+    if (current.a < horizonLimit) error.altitude.min = true; else error.altitude.min = false;
     if (current.a > settings.altitude.max) error.altitude.max = true; else error.altitude.max = false;
 
     // meridian limits
@@ -218,6 +341,20 @@ void Limits::poll() {
       } else error.meridian.west = false;
     } else error.meridian.west = false;
 
+    #if LIMIT_MERIDIAN_STEPS == ON
+      // hand Axis1 the meridian limit as a step count, it checks that at its own poll rate while slewing
+      // and the transform is only done here (tracking moves the limit so it's found again each time)
+      if (transform.meridianFlips && autoFlipDelayCycles == 0 &&
+          (current.pierSide == PIER_SIDE_EAST || current.pierSide == PIER_SIDE_WEST)) {
+        Coordinate limit = current;
+        limit.h = current.pierSide == PIER_SIDE_EAST ? -settings.pastMeridianE : settings.pastMeridianW;
+        double a1, a2;
+        transform.mountToInstrument(&limit, &a1, &a2);
+        long steps = axis1.instrumentCoordinateToSteps(a1);
+        if (current.pierSide == PIER_SIDE_EAST) axis1.setMotionLimitsSteps(steps, INT32_MAX); else axis1.setMotionLimitsSteps(INT32_MIN, steps);
+      } else axis1.setMotionLimitsSteps(INT32_MIN, INT32_MAX);
+    #endif
+
     #if AXIS2_TANGENT_ARM == ON
       current.a2 = axis2.getMotorPosition();
     #endif
@@ -287,6 +424,9 @@ void Limits::poll() {
     error.limit.axis2.max = false;
     error.meridian.east = false;
     error.meridian.west = false;
+    #if LIMIT_MERIDIAN_STEPS == ON
+      axis1.setMotionLimitsSteps(INT32_MIN, INT32_MAX);
+    #endif
   }
 
   // min and max limit switches
@@ -6,6 +6,7 @@
 
 #ifdef MOUNT_PRESENT
 
+#include "../../../lib/watchdog/Watchdog.h"
 #include "../guide/Guide.h"
 
 #pragma pack(1)
@@ -22,6 +23,15 @@ typedef struct LimitSettings {
 } LimitSettings;
 #pragma pack()
 
+#ifndef LIMITS_PATH_SAMPLES
+  #define LIMITS_PATH_SAMPLES 12             // points checked along each leg of a goto
+#endif
+
+#if HORIZON_MASK != OFF
+  #define HORIZON_MASK_BINS (360/HORIZON_MASK)
+  #define HORIZON_MASK_NONE -128             // bin has no mask, the horizon limit applies
+#endif
+
 typedef struct MerdianError {
   uint8_t east;
   uint8_t west;
@@ -56,6 +66,23 @@ class Limits {
     // target coordinate check ahead of sync, goto, etc.
     CommandError validateTarget(Coordinate *coords);
 
+    #if HORIZON_MASK != OFF
+      // horizon limit in radians at azimuth z (in radians), the higher of the horizon limit and the mask
+      float horizon(double z);
+
+      // get or set the horizon mask in degrees for the bin holding azimuth (in degrees), HORIZON_MASK_NONE for no mask
+      inline int8_t getHorizonMask(int azimuth) { return horizonMask[azimuth/HORIZON_MASK]; }
+      void setHorizonMask(int azimuth, int8_t altitude);
+    #endif
+
+    // check the path of a slew between two Mount coordinates against the altitude, meridian, and axis limits
+    // the path is sampled along a straight line in Mount coordinates, the end points aren't checked
+    CommandError validatePath(Coordinate *from, Coordinate *to);
+
+    // horizon and overhead limit check for an array of count equatorial (RA, Dec) coordinates
+    // visible[i] is set true if coords[i] is currently between the limits
+    void visibleTargets(Coordinate *coords, int count, bool *visible);
+
     // true if an limit related error is exists
     bool isError();
 
@@ -79,12 +106,27 @@ class Limits {
     LimitSettings settings = { { degToRadF(-10.0F), degToRadF(80.0F) }, degToRadF(15.0F), degToRadF(15.0F) };
 
   private:
+    // check one point along a slew path (Mount coordinates with Horizon coordinates) against the limits
+    CommandError validatePathPoint(Coordinate *p);
+
     void stop();
     void stopAxis1(GuideAction stopDirection = GA_BREAK);
     void stopAxis2(GuideAction stopDirection = GA_BREAK);
 
     bool limitsEnabled = false;
     LimitsError error;
+
+    #if HORIZON_MASK != OFF
+      // find the highest mask, above this the azimuth isn't needed
+      void horizonMaskUpdate();
+
+      int8_t horizonMask[HORIZON_MASK_BINS];
+      float horizonMaskMax = -Deg90;
+    #endif
+
+    #ifdef WATCHDOG_PRESENT
+      uint8_t heartbeatHandle = 0;
+    #endif
 };
 
 extern Limits limits;
@@ -0,0 +1,36 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount guide, PEC, and tracking log commands
+
+#include "MountLog.h"
+
+#if defined(MOUNT_PRESENT) && MOUNT_LOG != OFF
+
+bool MountLog::command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError) {
+  *supressFrame = false;
+
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'L') {
+    // :GXL#      Get the range of log records held, the oldest and the next (one past the newest) sequence numbers
+    //            Returns: n,n#
+    if (parameter[1] == 0) {
+      sprintf(reply, "%lu,%lu", (unsigned long)first(), (unsigned long)next());
+      *numericReply = false;
+    } else
+
+    // :GXL[n]#   Get log record with sequence number n
+    //            Returns: time,type,axis,value,a,b# (see MountLog.h)
+    {
+      char *conv_end;
+      unsigned long sequence = strtoul(&parameter[1], &conv_end, 10);
+      if (conv_end == &parameter[1] || *conv_end != 0) { *commandError = CE_PARAM_FORM; return true; }
+      MountLogRecord record;
+      if (!get(sequence, &record)) { *commandError = CE_PARAM_RANGE; return true; }
+      sprintf(reply, "%lu,%u,%u,%d,%ld,%ld", (unsigned long)record.time, (unsigned int)record.type, (unsigned int)record.axis,
+                     (int)record.value, (long)record.a, (long)record.b);
+      *numericReply = false;
+    }
+  } else return false;
+
+  return true;
+}
+
+#endif
@@ -0,0 +1,46 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount guide, PEC, and tracking log
+
+#include "MountLog.h"
+
+#if defined(MOUNT_PRESENT) && MOUNT_LOG != OFF
+
+// rates to fixed point, clipped to the range of the field
+static int32_t rateToMicro(float rate) {
+  if (rate > 2000.0F) rate = 2000.0F; else if (rate < -2000.0F) rate = -2000.0F;
+  return lroundf(rate*1000000.0F);
+}
+
+void MountLog::guide(uint8_t axis, float rate, unsigned long requested, unsigned long actual) {
+  if (rate > 3.2767F) rate = 3.2767F; else if (rate < -3.2767F) rate = -3.2767F;
+  add(ML_GUIDE, axis, lroundf(rate*10000.0F), requested, actual);
+}
+
+void MountLog::pec(long slot, float rate, uint8_t state) {
+  add(ML_PEC, 1, slot, rateToMicro(rate), state);
+}
+
+void MountLog::tracking(float rateAxis1, float rateAxis2) {
+  add(ML_TRACK, 0, 0, rateToMicro(rateAxis1), rateToMicro(rateAxis2));
+}
+
+bool MountLog::get(uint32_t sequence, MountLogRecord *record) {
+  if (sequence < first() || sequence >= count) return false;
+  *record = records[sequence % MOUNT_LOG];
+  return true;
+}
+
+void MountLog::add(uint8_t type, uint8_t axis, int16_t value, int32_t a, int32_t b) {
+  MountLogRecord *record = &records[count % MOUNT_LOG];
+  record->time = millis();
+  record->type = type;
+  record->axis = axis;
+  record->value = value;
+  record->a = a;
+  record->b = b;
+  count++;
+}
+
+MountLog mountLog;
+
+#endif
@@ -0,0 +1,58 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount guide, PEC, and tracking log
+#pragma once
+
+#include "../../../Common.h"
+
+#if defined(MOUNT_PRESENT) && MOUNT_LOG != OFF
+
+// record types
+#define ML_GUIDE 1  // axis, value = rate (sidereal x 10000), a = requested (us), b = actual (us)
+#define ML_PEC   2  // axis 1, value = slot, a = PEC rate (sidereal x 1000000), b = PEC state
+#define ML_TRACK 3  // axis 0, a = Axis1 rate, b = Axis2 rate (sidereal x 1000000)
+
+#pragma pack(1)
+typedef struct MountLogRecord {
+  uint32_t time;            // millis() when recorded
+  uint8_t type;
+  uint8_t axis;
+  int16_t value;
+  int32_t a;
+  int32_t b;
+} MountLogRecord;
+#pragma pack()
+
+// the log is a ring in RAM holding the last MOUNT_LOG records, each record has a sequence number
+// that counts up from 0 at startup so an export can pick up where the last one left off
+class MountLog {
+  public:
+    bool command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
+
+    // record a finished pulse guide, rate in sidereal X and lengths in microseconds
+    void guide(uint8_t axis, float rate, unsigned long requested, unsigned long actual);
+
+    // record the PEC rate (sidereal X) applied as slot started
+    void pec(long slot, float rate, uint8_t state);
+
+    // record the tracking rates (sidereal X) from the latest update
+    void tracking(float rateAxis1, float rateAxis2);
+
+    // sequence number of the oldest record still held
+    inline uint32_t first() { return count > MOUNT_LOG ? count - MOUNT_LOG : 0; }
+
+    // sequence number the next record will get
+    inline uint32_t next() { return count; }
+
+    // copies out the record with this sequence number, false if it's gone or doesn't exist yet
+    bool get(uint32_t sequence, MountLogRecord *record);
+
+  private:
+    void add(uint8_t type, uint8_t axis, int16_t value, int32_t a, int32_t b);
+
+    MountLogRecord records[MOUNT_LOG];
+    uint32_t count = 0;
+};
+
+extern MountLog mountLog;
+
+#endif
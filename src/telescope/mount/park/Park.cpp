@@ -47,6 +47,10 @@ void Park::init() {
     VF("MSG: Mount, start park signal monitor task (rate 1000ms priority 4)... ");
     if (tasks.add(1000, 0, true, 4, parkSignalWrapper, "ParkSgl")) { VLF("success"); } else { VLF("FAILED!"); }
   #endif
+
+  #if PARK_LOW_POWER != OFF
+    lowPowerInit();
+  #endif
 }
 
 // sets the park position
@@ -220,6 +224,10 @@ CommandError Park::restore(bool withTrackingOn) {
   }
   if (mount.motorFault()) return CE_SLEW_ERR_HARDWARE_FAULT;
 
+  #if PARK_LOW_POWER != OFF
+    wake();
+  #endif
+
   VF("MSG: Mount, unparking "); if (withTrackingOn) { VLF("with tracking sidereal"); } else { VLF("with tracking disabled"); } 
 
   #if AXIS1_PEC == ON
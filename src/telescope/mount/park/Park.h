@@ -52,6 +52,17 @@ class Park {
     // check input pin to initiate park operation
     void signal();
 
+    #if PARK_LOW_POWER != OFF
+      // leave low power (if in it) and restart the idle count, for anything that needs the mount
+      void wake();
+
+      // once parked and idle long enough drop to low power, leave it when woken
+      void lowPowerPoll();
+
+      // true while the drivers are disabled and tasks slowed
+      bool lowPower = false;
+    #endif
+
     ParkState state;
 
     ParkSettings settings = {{0, 0, PIER_SIDE_NONE}, false, PS_UNPARKED, 0};
@@ -60,6 +71,18 @@ class Park {
     uint8_t parkSenseHandle = 0;
     uint8_t parkSignalHandle = 0;
     bool wasTracking = false;
+
+    #if PARK_LOW_POWER != OFF
+      void lowPowerInit();
+      void lowPowerEnter();
+      void lowPowerExit();
+
+      uint8_t lowPowerHandle = 0;
+      unsigned long lowPowerIdleMs = 0;
+      #ifdef ESP32
+        uint32_t lowPowerCpuMhz = 0;
+      #endif
+    #endif
 };
 
 extern Park park;
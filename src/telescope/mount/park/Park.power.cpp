@@ -0,0 +1,123 @@
+// -----------------------------------------------------------------------------------
+// telescope mount control, low power while parked
+
+#include "Park.h"
+
+#if defined(MOUNT_PRESENT) && PARK_LOW_POWER != OFF
+
+#include "../../../lib/tasks/OnTask.h"
+
+#include "../Mount.h"
+#include "../../../lib/sense/Sense.h"
+
+#if defined(ESP32) && OPERATIONAL_MODE == WIFI
+  #include <WiFi.h>
+#endif
+
+// the CPU clock while in low power, WiFi still works at this speed
+#define PARK_LOW_POWER_CPU_MHZ 80
+
+// tasks that run slower while in low power, periods in microseconds
+typedef struct LowPowerTask {
+  const char *name;
+  unsigned long lowPowerPeriod;
+  unsigned long period;
+} LowPowerTask;
+
+static const LowPowerTask lowPowerTask[] = {
+  // the smart hand controller link is found by polling for its tone so leave it alone then
+  #if ST4_INTERFACE == ON && ST4_HAND_CONTROL != ON
+    #if ST4_INTERRUPT == ON
+      {"St4Mntr", 1000000, 100000},
+    #elif defined(HAL_SLOW_PROCESSOR)
+      {"St4Mntr", 100000, 5000},
+    #else
+      {"St4Mntr", 100000, 1700},
+    #endif
+  #endif
+  // dew heater pulses and intervalometer timing are millis() based and only lose some resolution
+  {"AuxPoll", 100000, 20000},
+  {"MntPec", 1000000, 10000},
+  {NULL, 0, 0}
+};
+
+void lowPowerWrapper() { park.lowPowerPoll(); }
+
+// a park sense edge means the mount was moved by hand, wake it so that shows up right away
+static volatile bool lowPowerSenseWake = false;
+static uint8_t lowPowerSenseHandle = 0;
+IRAM_ATTR static void lowPowerSenseEdge() { lowPowerSenseWake = true; tasks.immediate(lowPowerSenseHandle); }
+
+void Park::wake() {
+  lowPowerIdleMs = millis();
+  if (lowPower) lowPowerExit();
+}
+
+void Park::lowPowerPoll() {
+  if (lowPowerSenseWake) { lowPowerSenseWake = false; wake(); }
+
+  if (lowPower) {
+    if (state != PS_PARKED) lowPowerExit();
+    return;
+  }
+
+  if (state != PS_PARKED || mount.isSlewing()) { lowPowerIdleMs = millis(); return; }
+  if ((long)(millis() - lowPowerIdleMs) >= PARK_LOW_POWER*1000L) lowPowerEnter();
+}
+
+void Park::lowPowerEnter() {
+  VLF("MSG: Mount, parked and idle entering low power");
+
+  mount.enable(false);
+
+  for (int i = 0; lowPowerTask[i].name != NULL; i++) {
+    uint8_t handle = tasks.getHandleByName(lowPowerTask[i].name);
+    if (handle) tasks.setPeriodMicros(handle, lowPowerTask[i].lowPowerPeriod);
+  }
+
+  #ifdef ESP32
+    lowPowerCpuMhz = getCpuFrequencyMhz();
+    if (lowPowerCpuMhz > PARK_LOW_POWER_CPU_MHZ) setCpuFrequencyMhz(PARK_LOW_POWER_CPU_MHZ);
+    #if OPERATIONAL_MODE == WIFI
+      WiFi.setSleep(WIFI_PS_MAX_MODEM);
+    #endif
+  #endif
+
+  lowPower = true;
+}
+
+void Park::lowPowerExit() {
+  #ifdef ESP32
+    if (lowPowerCpuMhz > PARK_LOW_POWER_CPU_MHZ) setCpuFrequencyMhz(lowPowerCpuMhz);
+    #if OPERATIONAL_MODE == WIFI
+      WiFi.setSleep(WIFI_PS_MIN_MODEM);
+    #endif
+  #endif
+
+  for (int i = 0; lowPowerTask[i].name != NULL; i++) {
+    uint8_t handle = tasks.getHandleByName(lowPowerTask[i].name);
+    if (handle) tasks.setPeriodMicros(handle, lowPowerTask[i].period);
+  }
+
+  // back to how parking left them
+  if (state == PS_PARKED) mount.enable(MOUNT_ENABLE_IN_STANDBY == ON);
+
+  lowPower = false;
+  lowPowerIdleMs = millis();
+
+  VLF("MSG: Mount, leaving low power");
+}
+
+void Park::lowPowerInit() {
+  lowPowerIdleMs = millis();
+  VF("MSG: Mount, start park low power task (rate 1000ms priority 7)... ");
+  lowPowerHandle = tasks.add(1000, 0, true, 7, lowPowerWrapper, "ParkPwr");
+  if (lowPowerHandle) { VLF("success"); } else { VLF("FAILED!"); }
+  lowPowerSenseHandle = lowPowerHandle;
+
+  #if PARK_SENSE != OFF && PARK_SENSE_PIN != OFF
+    sense.onEdge(parkSenseHandle, lowPowerSenseEdge);
+  #endif
+}
+
+#endif
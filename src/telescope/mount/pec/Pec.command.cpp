@@ -39,7 +39,7 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
       *numericReply = false;
     } else
 
-    // :GXE8#     Get PEC buffer size in seconds
+    // :GXE8#     Get PEC buffer size in slots (seconds unless PEC_SLOT_MS is set)
     //            Returns: n#
     if (parameter[0] == 'E' && parameter[1] == '8') {
       sprintf(reply, "%ld", bufferSize);
@@ -69,13 +69,14 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
       //            Returns: n#
       if (command[1] == 'H' && parameter[0] == 0) {
         long s = lroundf(wormSenseSteps/stepsPerSiderealSecond);
+        long wormRotationSeconds = lround(wormRotationSlots*(PEC_SLOT_MS/1000.0));
         while (s > wormRotationSeconds) s -= wormRotationSeconds;
         while (s < 0) s += wormRotationSeconds;
         sprintf(reply,"%05ld",s);
         *numericReply = false;
       } else
 
-      // :VR[n]#    Read PEC table entry rate adjustment (in steps +/-) for worm segment n (in seconds)
+      // :VR[n]#    Read PEC table entry rate adjustment (in steps +/-) for worm segment n (in slots, seconds unless PEC_SLOT_MS is set)
       //            Returns: sn#
       // :VR#       Read PEC table entry rate adjustment (in steps +/-) for currently playing segment and its rate adjustment (in steps +/-)
       //            Returns: sn,n#
@@ -86,13 +87,13 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
         if (conv_result) {
           if (i >= 0 && i < bufferSize) {
             if (parameter[0] == 0) {
-              i -= 1;
-              if (i < 0) i += wormRotationSeconds;
-              if (i >= wormRotationSeconds) i -= wormRotationSeconds;
-              j = buffer[i];
+              i -= PEC_PLAY_LEAD;
+              if (i < 0) i += wormRotationSlots;
+              if (i >= wormRotationSlots) i -= wormRotationSlots;
+              j = slotValue(i);
               sprintf(reply,"%+04i,%03i", j, i);
             } else {
-              j = buffer[i];
+              j = slotValue(i);
               sprintf(reply,"%+04i", j);
             }
           } else *commandError = CE_PARAM_RANGE;
@@ -102,7 +103,7 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
 
       // :Vr[n]#    Read out RA PEC ten byte frame in hex format starting at worm segment n (in seconds)
       //            Returns: x0x1x2x3x4x5x6x7x8x9# (hex one byte integers)
-      //            Ten rate adjustment factors for 1s worm segments in steps +/- (steps = x0 - 128, etc.)
+      //            Ten rate adjustment factors for worm segments in steps +/- (steps = x0 - 128, etc.), clipped to one byte
       if (command[1] == 'r') {
         int16_t i, j;
         if (convert.atoi2(parameter, &i)) {
@@ -111,7 +112,10 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
             uint8_t b;
             char s[3] = "  ";
             for (j = 0; j < 10; j++) {
-              if (i + j < bufferSize) b = (int)buffer[i + j] + 128; else b = 128;
+              int v = 0;
+              if (i + j < bufferSize) v = slotValue(i + j);
+              if (v < -128) v = -128; else if (v > 127) v = 127;
+              b = v + 128;
               sprintf(s, "%02X", b);
               strcat(reply, s);
             }
@@ -144,26 +148,32 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
   // W - PEC Write
   if (command[0] == 'W') {
     #if AXIS1_PEC == ON
-      // :WR+#      Move PEC Table ahead by one sidereal second
+      #if PEC_HARMONICS != OFF
+        // the harmonic model can only be recorded
+        if (command[1] == 'R') {
+          *commandError = CE_0;
+        } else
+      #else
+      // :WR+#      Move PEC Table ahead by one slot (a sidereal second unless PEC_SLOT_MS is set)
       //            Return: 0 on failure
       //                    1 on success
       if (command[1] == 'R' && parameter[0] == '+' && parameter[1] == 0) {
-        int8_t i = buffer[wormRotationSeconds - 1];
-        memmove(&buffer[1], &buffer[0], wormRotationSeconds - 1);
+        PecValue i = buffer[wormRotationSlots - 1];
+        memmove(&buffer[1], &buffer[0], (wormRotationSlots - 1)*sizeof(PecValue));
         buffer[0] = i;
       } else
 
-      // :WR-#      Move PEC Table back by one sidereal second
+      // :WR-#      Move PEC Table back by one slot
       //            Return: 0 on failure
       //                    1 on success
       if (command[1] == 'R' && parameter[0] == '-' && parameter[1] == 0) {
-        int8_t i = buffer[0];
-        memmove(&buffer[0], &buffer[1], wormRotationSeconds - 1);
-        buffer[wormRotationSeconds - 1] = i;
+        PecValue i = buffer[0];
+        memmove(&buffer[0], &buffer[1], (wormRotationSlots - 1)*sizeof(PecValue));
+        buffer[wormRotationSlots - 1] = i;
       } else
 
-      // :WR[n,sn]# Write PEC table entry for worm segment [n] (in sidereal seconds)
-      // where [sn] is the correction in steps +/- for this 1 second segment
+      // :WR[n,sn]# Write PEC table entry for worm segment [n] (in slots, sidereal seconds unless PEC_SLOT_MS is set)
+      // where [sn] is the correction in steps +/- for this segment
       //            Returns: Nothing
       if (command[1] == 'R') {
         char *parameter2 = strchr(parameter, ',');
@@ -174,7 +184,7 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
           if (convert.atoi2(parameter, &i)) {
             if (i >= 0 && i < bufferSize) {
               if (convert.atoi2(parameter2, &j)) {
-                if (j >= -128 && j <= 127) {
+                if (j >= -PEC_VALUE_MAX - 1 && j <= PEC_VALUE_MAX) {
                   buffer[i] = j;
                   settings.recorded = true;
                 } else *commandError = CE_PARAM_RANGE;
@@ -184,6 +194,7 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
         } else *commandError = CE_PARAM_FORM;
         *numericReply = false;
       } else
+      #endif
     #endif
     return false;
   } else
@@ -195,6 +206,10 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
       // :$QZ+#     Enable RA PEC compensation 
       //            Returns: nothing
       if (parameter[1] == '+') {
+        #if PEC_ADAPTIVE != OFF
+          // learning can start from an empty recording
+          if (settings.state == PEC_NONE) settings.recorded = true;
+        #endif
         if (settings.state == PEC_NONE && settings.recorded) settings.state = PEC_READY_PLAY; else *commandError = CE_0;
         nv.updateBytes(NV_MOUNT_PEC_BASE, &settings, sizeof(PecSettings));
       } else
@@ -215,7 +230,11 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
       // :$QZZ#     Clear the PEC data buffer
       //            Return: Nothing
       if (parameter[1] == 'Z') {
-        for (int i = 0; i < bufferSize; i++) buffer[i] = 0;
+        #if PEC_HARMONICS != OFF
+          memset(&model, 0, sizeof(model));
+        #else
+          for (int i = 0; i < bufferSize; i++) buffer[i] = 0;
+        #endif
         settings.state = PEC_NONE;
         settings.recorded = false;
         nv.updateBytes(NV_MOUNT_PEC_BASE, &settings, sizeof(PecSettings));
@@ -225,7 +244,11 @@ bool Pec::command(char *reply, char *command, char *parameter, bool *supressFram
       if (parameter[1] == '!') {
         settings.recorded = true;
         nv.updateBytes(NV_MOUNT_PEC_BASE, &settings, sizeof(PecSettings));
-        for (int i = 0; i < bufferSize; i++) nv.update(NV_PEC_BUFFER_BASE + i, buffer[i]);
+        #if PEC_HARMONICS != OFF
+          nv.updateBytes(NV_PEC_BUFFER_BASE, &model, sizeof(model));
+        #else
+          nv.updateBytes(NV_PEC_BUFFER_BASE, buffer, bufferSize*sizeof(PecValue));
+        #endif
       } else
     #endif
     // :$QZ?#     Get PEC status
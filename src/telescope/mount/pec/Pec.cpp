@@ -12,6 +12,7 @@
   #include "../../Telescope.h"
   #include "../goto/Goto.h"
   #include "../guide/Guide.h"
+  #include "../log/MountLog.h"
   #include "../park/Park.h"
 
   #if PEC_SENSE == OFF
@@ -35,38 +36,57 @@
     // read the settings
     nv.readBytes(NV_MOUNT_PEC_BASE, &settings, sizeof(PecSettings));
 
+    // a buffer recorded with another slot duration or resolution doesn't apply
+    bool bufferFormatChanged = false;
+    if (settings.bufferFormat != PEC_BUFFER_FORMAT) {
+      VLF("MSG: Mount, PEC buffer format changed, clearing recording");
+      settings.bufferFormat = PEC_BUFFER_FORMAT;
+      settings.recorded = false;
+      settings.state = PEC_NONE;
+      nv.updateBytes(NV_MOUNT_PEC_BASE, &settings, sizeof(PecSettings));
+      bufferFormatChanged = true;
+    }
+
     stepsPerSiderealSecond = (axis1.getStepsPerMeasure()/RAD_DEG_RATIO)/240.0L;
     stepsPerSiderealSecondI = lroundf(stepsPerSiderealSecond);
     stepsPerMicroSecond = (stepsPerSiderealSecond*SIDEREAL_RATIO)/1000000.0L;
-
-    wormRotationSeconds = round(settings.wormRotationSteps/stepsPerSiderealSecond);
-    bufferSize = wormRotationSeconds;
+    stepsPerSlot = stepsPerSiderealSecond*(PEC_SLOT_MS/1000.0L);
+    stepsPerSlotI = lroundf(stepsPerSlot);
+    slotLength = lroundf(FRACTIONAL_SEC*PEC_SLOT_MS);
+
+    wormRotationSlots = round(settings.wormRotationSteps/stepsPerSlot);
+    bufferSize = wormRotationSlots;
+    #if PEC_HARMONICS != OFF
+      long bufferBytes = sizeof(PecHarmonics);
+    #else
+      long bufferBytes = bufferSize*(long)sizeof(PecValue);
+    #endif
 
     if (bufferSize > 0) {
-      if (bufferSize < 61) {
+      if (bufferSize*PEC_SLOT_MS < 61000L) {
         bufferSize = 0;
         initError.value = true;
         DLF("ERR: Pec::init(), invalid bufferSize - PEC disabled");
       } else
-      if (bufferSize + NV_PEC_BUFFER_BASE >= nv.size - 1) {
+      if (bufferBytes > PEC_BUFFER_SIZE_LIMIT || bufferBytes + NV_PEC_BUFFER_BASE >= nv.size - 1) {
         bufferSize = 0;
         initError.value = true;
         DLF("ERR: Pec::init(), bufferSize exceeds available NV - PEC disabled");
-      } else {
-        buffer = (int8_t*)malloc(bufferSize * sizeof(*buffer));
-        if (buffer == NULL) {
+      } else
+      #if PEC_HARMONICS != OFF
+        if (PEC_HARMONIC_ORDER_MAX*2 >= bufferSize) {
+          bufferSize = 0;
+          initError.value = true;
+          DLF("ERR: Pec::init(), too many harmonics for the worm period - PEC disabled");
+        } else
+      #endif
+      {
+        if (!bufferInit(bufferBytes, bufferFormatChanged)) {
           bufferSize = 0;
           initError.value = true;
           VLF("WRN: Pec::init(), bufferSize exceeds available RAM - PEC disabled");
         } else {
-          VF("MSG: Mount, PEC allocated buffer "); V(bufferSize * (long)sizeof(*buffer)); VLF(" bytes");
-
-          bool bufferNeedsInit = true;
-          for (int i = 0; i < bufferSize; i++) {
-            buffer[i] = nv.read(NV_PEC_BUFFER_BASE + i);
-            if (buffer[i] != 0) bufferNeedsInit = false;
-          }
-          if (bufferNeedsInit) for (int i = 0; i < bufferSize; i++) nv.write(NV_PEC_BUFFER_BASE + i, (int8_t)0);
+          nv.addRegion(NV_PEC_BUFFER_BASE, bufferBytes);
 
           if (settings.state > PEC_RECORD) {
             settings.state = PEC_NONE;
@@ -93,7 +113,146 @@
       }
     }
     if (bufferSize <= 0) { bufferSize = 0; settings.state = PEC_NONE; settings.recorded = false; }
-    if (wormRotationSeconds > bufferSize) wormRotationSeconds = bufferSize;
+    if (wormRotationSlots > bufferSize) wormRotationSlots = bufferSize;
+  }
+
+  // allocate the table (or model) and read it from NV, false if there isn't enough RAM
+  bool Pec::bufferInit(long bufferBytes, bool clear) {
+    #if PEC_HARMONICS != OFF
+      // erased NV reads as NaN
+      nv.readBytes(NV_PEC_BUFFER_BASE, &model, bufferBytes);
+      for (int n = 0; n < PEC_HARMONIC_TERMS; n++) {
+        if (isnan(model.a[n]) || isinf(model.a[n]) || isnan(model.b[n]) || isinf(model.b[n])) clear = true;
+      }
+      if (clear) {
+        memset(&model, 0, sizeof(model));
+        nv.updateBytes(NV_PEC_BUFFER_BASE, &model, bufferBytes);
+      }
+      VF("MSG: Mount, PEC harmonic model with "); V(PEC_HARMONIC_TERMS); VLF(" terms");
+    #else
+      buffer = (PecValue*)malloc(bufferSize * sizeof(*buffer));
+      if (buffer == NULL) return false;
+      VF("MSG: Mount, PEC allocated buffer "); V(bufferSize * (long)sizeof(*buffer)); VLF(" bytes");
+
+      bool bufferNeedsInit = true;
+      nv.readBytes(NV_PEC_BUFFER_BASE, buffer, bufferBytes);
+      if (!clear) for (int i = 0; i < bufferSize; i++) if (buffer[i] != 0) { bufferNeedsInit = false; break; }
+      if (bufferNeedsInit) {
+        for (int i = 0; i < bufferSize; i++) buffer[i] = 0;
+        nv.updateBytes(NV_PEC_BUFFER_BASE, buffer, bufferBytes);
+      }
+    #endif
+    return true;
+  }
+
+  #if PEC_ADAPTIVE != OFF
+    // fold the guiding done during the last slot into the PEC data
+    void Pec::learn() {
+      // while playing, guiding is the error PEC hasn't cancelled yet, adding a part of it each worm cycle
+      // is an exponentially weighted average where older corrections fade by (100 - PEC_ADAPTIVE)%
+      float i = accGuideAxis1;
+      if (i < -stepsPerSlot) i = -stepsPerSlot;
+      if (i >  stepsPerSlot) i =  stepsPerSlot;
+      accGuideAxis1 -= i;
+      if (i == 0.0F) return;
+
+      #if PEC_HARMONICS != OFF
+        // spread over the period like a fit of one worm rotation would be
+        harmonicAdd(&model, bufferIndex, i*(1000.0F/PEC_SLOT_MS)*(PEC_ADAPTIVE/100.0F)*2.0F/wormRotationSlots);
+      #else
+        // the rounding carries to the next slot so small corrections aren't lost
+        float v = buffer[bufferIndex] + i*(PEC_ADAPTIVE/100.0F) + learnCarry;
+        long j = lroundf(v);
+        learnCarry = v - j;
+        if (j < -stepsPerSlotI) j = -stepsPerSlotI; else if (j > stepsPerSlotI) j = stepsPerSlotI;
+        if (j < -PEC_VALUE_MAX) j = -PEC_VALUE_MAX; else if (j > PEC_VALUE_MAX) j = PEC_VALUE_MAX;
+        buffer[bufferIndex] = j;
+      #endif
+    }
+  #endif
+
+  #if PEC_ENCODER != OFF
+    // get ready to record from the axis encoder, false if there isn't enough RAM
+    bool Pec::encoderRecordStart() {
+      encoderLastValid = false;
+      encoderSamples = 0;
+      #if PEC_HARMONICS == OFF
+        encoderRecordFree();
+        encoderSums = (float*)malloc(wormRotationSlots*sizeof(float));
+        if (encoderSums == NULL) { DLF("ERR: Pec::encoderRecordStart(), not enough RAM to record from the encoder"); return false; }
+        for (long k = 0; k < wormRotationSlots; k++) encoderSums[k] = 0.0F;
+      #endif
+      VF("MSG: Mount, PEC recording from the axis encoder over "); V(PEC_ENCODER); VLF(" worm rotations");
+      return true;
+    }
+
+    // add how far the axis moved against the motor over the slot just ended to the recording
+    void Pec::encoderRecord() {
+      long encoder;
+      if (!mount.encoderSteps(1, &encoder)) { encoderLastValid = false; return; }
+      long e = encoder - axis1.getMotorPositionSteps();
+      if (!encoderLastValid) { encoderLast = e; encoderLastValid = true; return; }
+
+      // the axis falling behind the motor is the correction PEC needs, stored where playback (running
+      // PEC_PLAY_LEAD slots behind) applies it over the same part of the worm rotation it was measured on
+      float i = encoderLast - e;
+      encoderLast = e;
+      if (i < -stepsPerSlot) i = -stepsPerSlot;
+      if (i >  stepsPerSlot) i =  stepsPerSlot;
+      long k = bufferIndex - 1 - PEC_PLAY_LEAD; while (k < 0) k += wormRotationSlots;
+
+      #if PEC_HARMONICS != OFF
+        harmonicAdd(&sums, k, i*(1000.0F/PEC_SLOT_MS));
+        sumsCount++;
+      #else
+        encoderSums[k] += i;
+      #endif
+      encoderSamples++;
+    }
+
+    // average the recorded rotations into the PEC data
+    bool Pec::encoderRecordEnd() {
+      if (encoderSamples < wormRotationSlots) {
+        DLF("ERR: Pec::encoderRecordEnd(), too few encoder readings for a worm rotation");
+        encoderRecordFree();
+        return false;
+      }
+
+      #if PEC_HARMONICS == OFF
+        // the encoder noise averages out over the rotations, the rounding carries to the next slot
+        float rotations = (float)encoderSamples/wormRotationSlots;
+        float carry = 0.0F;
+        for (long k = 0; k < wormRotationSlots; k++) {
+          float v = encoderSums[k]/rotations + carry;
+          long j = lroundf(v);
+          carry = v - j;
+          if (j < -stepsPerSlotI) j = -stepsPerSlotI; else if (j > stepsPerSlotI) j = stepsPerSlotI;
+          if (j < -PEC_VALUE_MAX) j = -PEC_VALUE_MAX; else if (j > PEC_VALUE_MAX) j = PEC_VALUE_MAX;
+          buffer[k] = j;
+        }
+      #endif
+
+      encoderRecordFree();
+      return true;
+    }
+
+    // release anything the recording holds
+    void Pec::encoderRecordFree() {
+      #if PEC_HARMONICS == OFF
+        if (encoderSums != NULL) { free(encoderSums); encoderSums = NULL; }
+      #endif
+    }
+  #endif
+
+  // correction for slot k, in steps
+  long Pec::slotValue(long k) {
+    #if PEC_HARMONICS != OFF
+      long v = lroundf(harmonicValue(k)*(PEC_SLOT_MS/1000.0F));
+      if (v < -PEC_VALUE_MAX) v = -PEC_VALUE_MAX; else if (v > PEC_VALUE_MAX) v = PEC_VALUE_MAX;
+      return v;
+    #else
+      return buffer[k];
+    #endif
   }
 
   void Pec::poll() {
@@ -145,32 +304,44 @@
     #endif
 
     // handle playing back and recording PEC
-    noInterrupts();
-    unsigned long lastFs = fracLAST;
-    interrupts();
+    unsigned long lastFs = getFracLAST();
 
     // start playing PEC
     if (settings.state == PEC_READY_PLAY) {
-      // makes sure the index is at the start of a second before resuming play
-      if ((long)fmod(wormRotationSteps, stepsPerSiderealSecond) == 0) {
+      // makes sure the index is at the start of a slot before resuming play
+      if ((long)fmod(wormRotationSteps, stepsPerSlot) == 0) {
         VLF("MSG: Mount, PEC started playing");
         settings.state = PEC_PLAY;
-        bufferIndex = lroundf(wormRotationSteps/stepsPerSiderealSecond);
+        bufferIndex = lroundf(wormRotationSteps/stepsPerSlot);
         wormRotationStartTimeFs = lastFs;
+        slotStartFrac = 0;
+        accGuideAxis1 = 0.0L;
       }
     } else
     // start recording PEC
     if (settings.state == PEC_READY_RECORD) {
-      if ((long)fmod(wormRotationSteps, stepsPerSiderealSecond) == 0) {
+      if ((long)fmod(wormRotationSteps, stepsPerSlot) == 0) {
         VF("MSG: Mount, PEC started recording at ");
         settings.state = PEC_RECORD;
-        bufferIndex = lroundf(wormRotationSteps/stepsPerSiderealSecond);
+        bufferIndex = lroundf(wormRotationSteps/stepsPerSlot);
         firstRecording = !settings.recorded;
         wormRotationStartTimeFs = lastFs;
+        slotStartFrac = 0;
         V(wormRotationStartTimeFs);
-        recordStopTimeFs = wormRotationStartTimeFs + (uint32_t)(wormRotationSeconds*(long)FRACTIONAL_SEC);
+        #if PEC_ENCODER != OFF
+          recordStopTimeFs = wormRotationStartTimeFs + (uint32_t)lround(wormRotationSlots*PEC_ENCODER*(slotLength/1000.0));
+        #else
+          recordStopTimeFs = wormRotationStartTimeFs + (uint32_t)lround(wormRotationSlots*(slotLength/1000.0));
+        #endif
+        #if PEC_HARMONICS != OFF
+          memset(&sums, 0, sizeof(sums));
+          sumsCount = 0;
+        #endif
         V(" and stopping at "); VL(recordStopTimeFs);
         accGuideAxis1 = 0.0L;
+        #if PEC_ENCODER != OFF
+          if (!encoderRecordStart()) settings.state = PEC_NONE;
+        #endif
       }
     } else
     // and once the PEC data is all stored, indicate that it's valid and start using it
@@ -178,67 +349,209 @@
       VLF("MSG: Mount, PEC recording complete switched to playing");
       settings.state = PEC_PLAY;
       settings.recorded = true;
-      cleanup();
+      #if PEC_ENCODER != OFF
+        if (!encoderRecordEnd()) { settings.state = PEC_NONE; settings.recorded = !firstRecording; } else
+      #endif
+      #if PEC_HARMONICS != OFF
+        harmonicFit();
+      #else
+        cleanup();
+      #endif
     }
 
     // reset the buffer index to match the worm index
     if (bufferStart && settings.state != PEC_RECORD) {
       bufferIndex = 0;
       wormRotationStartTimeFs = lastFs;
+      slotStartFrac = 0;
     }
 
-    // Increment the PEC index once a second and make it go back to zero when the
+    // Increment the PEC index once a slot and make it go back to zero when the
     // worm finishes a rotation, this code works when crossing zero
-    if (lastFs - wormRotationStartTimeFs >= FRACTIONAL_SEC) { wormRotationStartTimeFs = lastFs; bufferIndex++; }
-    bufferIndex = ((bufferIndex % wormRotationSeconds) + wormRotationSeconds) % wormRotationSeconds;
+    // the slot start moves by exactly one slot length so short slots don't drift against the worm
+    if (slotElapsed(lastFs) >= slotLength) {
+      wormRotationStartTimeFs += slotLength/1000;
+      slotStartFrac += slotLength % 1000;
+      if (slotStartFrac >= 1000) { slotStartFrac -= 1000; wormRotationStartTimeFs++; }
+      bufferIndex++;
+    }
+    bufferIndex = ((bufferIndex % wormRotationSlots) + wormRotationSlots) % wormRotationSlots;
 
     // accumulate guide steps for PEC
     if (guide.rateAxis1 != 0.0F) {
-      if (accGuideStartTime != 0) accGuideAxis1 += stepsPerMicroSecond*(micros() - accGuideStartTime)*guide.rateAxis1;
-      accGuideStartTime = micros();
+      unsigned long now = micros();
+      if (accGuideStartTime != 0) accGuideAxis1 += stepsPerMicroSecond*(now - accGuideStartTime)*guide.rateAxis1;
+      accGuideStartTime = now;
       if (accGuideStartTime == 0) accGuideStartTime = 1;
     } else accGuideStartTime = 0;
 
-    // falls in whenever the pecIndex changes, which is once a sidereal second
+    // falls in whenever the pecIndex changes, which is once a slot
+    float lastRate = rate;
     static long lastBufferIndex = 0;
-    if (bufferIndex != lastBufferIndex) {
+    bool slotChanged = bufferIndex != lastBufferIndex;
+    if (slotChanged) {
       lastBufferIndex = bufferIndex;
 
       // assume no change to tracking rate
       rate = 0.0F;
 
       if (settings.state == PEC_RECORD) {
-        // get guide steps taken from the accumulator
-        int i = round(accGuideAxis1);
+        #if PEC_ENCODER != OFF
+          encoderRecord();
+        #elif PEC_HARMONICS != OFF
+          // all the guide steps taken go into the fit
+          float i = accGuideAxis1;
+          if (i < -stepsPerSlot) i = -stepsPerSlot;
+          if (i >  stepsPerSlot) i =  stepsPerSlot;
+          accGuideAxis1 -= i;
+          harmonicAdd(&sums, bufferIndex, i*(1000.0F/PEC_SLOT_MS));
+          sumsCount++;
+        #else
+          // get guide steps taken from the accumulator
+          long i = lround(accGuideAxis1);
+
+          // stay within +/- one sidereal rate for corrections
+          if (i < -stepsPerSlotI) i = -stepsPerSlotI;
+          if (i >  stepsPerSlotI) i =  stepsPerSlotI;
+
+          // apply weighted average
+          if (!firstRecording) i = (i + (long)buffer[bufferIndex]*2)/3;
+
+          // restrict to valid range and store
+          if (i < -PEC_VALUE_MAX) i = -PEC_VALUE_MAX; else if (i > PEC_VALUE_MAX) i = PEC_VALUE_MAX;
+
+          // remove steps from the accumulator
+          accGuideAxis1 -= i;
+
+          buffer[bufferIndex] = i;
+        #endif
+      }
+
+      #if PEC_ADAPTIVE != OFF
+        if (settings.state == PEC_PLAY) learn();
+      #endif
+
+      #if PEC_INTERPOLATE == OFF && PEC_HARMONICS == OFF
+        if (settings.state == PEC_PLAY) {
+          // adjust about one second before the value was recorded, an estimate of the latency between image acquisition and response
+          // if sending values directly to OnStep from PECprep, etc. be sure to account for this
+          // number of steps ahead or behind for this slot
+          long j = bufferIndex - PEC_PLAY_LEAD; while (j < 0) j += wormRotationSlots;
+          long i = buffer[j];
+          if (i >  stepsPerSlotI) i =  stepsPerSlotI;
+          if (i < -stepsPerSlotI) i = -stepsPerSlotI;
+          rate = i/stepsPerSlot;
+        }
+      #endif
+    }
+
+    #if PEC_HARMONICS != OFF
+      if (settings.state == PEC_PLAY) {
+        float v = harmonicValue(slotPosition(lastFs));
+        if (v >  stepsPerSiderealSecond) v =  stepsPerSiderealSecond;
+        if (v < -stepsPerSiderealSecond) v = -stepsPerSiderealSecond;
+        rate = v/stepsPerSiderealSecond;
+      }
+    #elif PEC_INTERPOLATE != OFF
+      if (settings.state == PEC_PLAY) rate = interpolatedRate(lastFs);
+    #endif
 
-        // stay within +/- one sidereal rate for corrections
-        if (i < -stepsPerSiderealSecondI) i = -stepsPerSiderealSecondI;
-        if (i >  stepsPerSiderealSecondI) i =  stepsPerSiderealSecondI;
+    #if MOUNT_LOG != OFF
+      if (slotChanged) mountLog.pec(bufferIndex, rate, settings.state);
+    #endif
 
-        // apply weighted average
-        if (!firstRecording) i = (i + (int)buffer[bufferIndex]*2)/3;
+    // the mount otherwise picks up the new rate on its next tracking update, up to a second later
+    if (rate != lastRate) mount.update();
+  }
 
-        // restrict to valid range and store
-        if (i < -127) i = -127; else if (i >  127) i = 127;
+  #if PEC_HARMONICS != OFF
+    // correction from the model at slot position t, in steps per sidereal second
+    float Pec::harmonicValue(float t) {
+      float theta = t*(2.0F*(float)Deg180/wormRotationSlots);
+      float c1 = cosf(theta), s1 = sinf(theta);
+
+      // each worm harmonic by rotating the one before it
+      float c = 1.0F, s = 0.0F, v = 0.0F;
+      for (int n = 0; n < PEC_HARMONICS; n++) {
+        float cn = c*c1 - s*s1;
+        s = s*c1 + c*s1;
+        c = cn;
+        v += model.a[n]*c + model.b[n]*s;
+      }
 
-        // remove steps from the accumulator
-        accGuideAxis1 -= i;
+      #if PEC_GEAR_HARMONIC != OFF
+        float g = theta*PEC_GEAR_HARMONIC;
+        v += model.a[PEC_HARMONICS]*cosf(g) + model.b[PEC_HARMONICS]*sinf(g);
+      #endif
+      return v;
+    }
 
-        buffer[bufferIndex] = i;
+    // add each term at slot k times value (in steps per sidereal second) to terms
+    void Pec::harmonicAdd(PecHarmonics *terms, long k, float value) {
+      float theta = k*(2.0F*(float)Deg180/wormRotationSlots);
+      float c1 = cosf(theta), s1 = sinf(theta);
+
+      float c = 1.0F, s = 0.0F;
+      for (int n = 0; n < PEC_HARMONICS; n++) {
+        float cn = c*c1 - s*s1;
+        s = s*c1 + c*s1;
+        c = cn;
+        terms->a[n] += value*c;
+        terms->b[n] += value*s;
       }
 
-      if (settings.state == PEC_PLAY) {
-        // adjust one second before the value was recorded, an estimate of the latency between image acquisition and response
-        // if sending values directly to OnStep from PECprep, etc. be sure to account for this
-        // number of steps ahead or behind for this 1 second slot, up to +/-127
-        int j = bufferIndex - 1; if (j == -1) j += wormRotationSeconds;
-        int i = buffer[j];
-        if (i >  stepsPerSiderealSecondI) i =  stepsPerSiderealSecondI;
-        if (i < -stepsPerSiderealSecondI) i = -stepsPerSiderealSecondI;
-        rate = i/stepsPerSiderealSecond;
+      #if PEC_GEAR_HARMONIC != OFF
+        float g = theta*PEC_GEAR_HARMONIC;
+        terms->a[PEC_HARMONICS] += value*cosf(g);
+        terms->b[PEC_HARMONICS] += value*sinf(g);
+      #endif
+    }
+
+    // fit the model to a completed recording
+    void Pec::harmonicFit() {
+      // samples evenly spaced over the whole worm rotation make the projection the least squares fit,
+      // the mean (drift) is left out and terms above PEC_HARMONICS are the noise a table has to filter
+      VLF("MSG: Mount, PEC fitting harmonic model");
+      if (sumsCount == 0) return;
+      for (int n = 0; n < PEC_HARMONIC_TERMS; n++) {
+        float a = sums.a[n]*2.0F/sumsCount;
+        float b = sums.b[n]*2.0F/sumsCount;
+
+        // apply weighted average, an encoder recording is already averaged over its rotations
+        if (!firstRecording && PEC_ENCODER == OFF) { a = (a + model.a[n]*2.0F)/3.0F; b = (b + model.b[n]*2.0F)/3.0F; }
+        model.a[n] = a;
+        model.b[n] = b;
       }
     }
-  }
+  #endif
+
+  #if PEC_HARMONICS == OFF && PEC_INTERPOLATE != OFF
+    // tracking rate (in x) interpolated between the slots around this moment
+    float Pec::interpolatedRate(uint32_t fs) {
+      // each slot's correction is taken as the rate at its center, with the same lead as step playback
+      float t = slotPosition(fs);
+      long k = (long)floor(t);
+      float f = t - k;
+
+      float p[4];
+      for (int n = 0; n < 4; n++) {
+        long j = k - 1 + n;
+        while (j < 0) j += wormRotationSlots;
+        while (j >= wormRotationSlots) j -= wormRotationSlots;
+        p[n] = buffer[j];
+      }
+
+      #if PEC_INTERPOLATE == LINEAR
+        float v = p[1] + (p[2] - p[1])*f;
+      #else
+        float v = p[1] + 0.5F*f*(p[2] - p[0] + f*(2.0F*p[0] - 5.0F*p[1] + 4.0F*p[2] - p[3] + f*(3.0F*(p[1] - p[2]) + p[3] - p[0])));
+      #endif
+
+      if (v >  stepsPerSlot) v =  stepsPerSlot;
+      if (v < -stepsPerSlot) v = -stepsPerSlot;
+      return v/stepsPerSlot;
+    }
+  #endif
 
   // disable PEC
   void Pec::disable() {
@@ -248,6 +561,9 @@
       VLF("MSG: Mount, PEC recording stopped");
       settings.state = PEC_NONE;
       rate = 0.0F;
+      #if PEC_ENCODER != OFF
+        encoderRecordFree();
+      #endif
     } 
     // get ready to re-index when tracking comes back
     if (settings.state == PEC_PLAY) {
@@ -257,41 +573,42 @@
     } 
   }
 
+  #if PEC_HARMONICS == OFF
   // applies low pass filter to smooth noise in PEC data and linear regression
   void Pec::cleanup() {
     VLF("MSG: Mount, applying low pass filter to PEC data");
     int i,J1,J4,J9,J17;
-    for (int scc = 3; scc < wormRotationSeconds + 3; scc++) {
-      i = buffer[scc % wormRotationSeconds];
+    for (int scc = 3; scc < wormRotationSlots + 3; scc++) {
+      i = buffer[scc % wormRotationSlots];
 
       J1 = lroundf(i*0.01F);
       J4 = lroundf(i*0.04F);
       J9 = lroundf(i*0.09F);
       J17 = lroundf(i*0.17F);
-      buffer[(scc - 4) % wormRotationSeconds] = (buffer[(scc - 4) % wormRotationSeconds]) + J1;
-      buffer[(scc - 3) % wormRotationSeconds] = (buffer[(scc - 3) % wormRotationSeconds]) + J4;
-      buffer[(scc - 2) % wormRotationSeconds] = (buffer[(scc - 2) % wormRotationSeconds]) + J9;
-      buffer[(scc - 1) % wormRotationSeconds] = (buffer[(scc - 1) % wormRotationSeconds]) + J17;
-      buffer[(scc    ) % wormRotationSeconds] = (buffer[(scc    ) % wormRotationSeconds]) - (J17+J17+J9+J9+J4+J4+J1+J1);
-      buffer[(scc + 1) % wormRotationSeconds] = (buffer[(scc + 1) % wormRotationSeconds]) + J17;
-      buffer[(scc + 2) % wormRotationSeconds] = (buffer[(scc + 2) % wormRotationSeconds]) + J9;
-      buffer[(scc + 3) % wormRotationSeconds] = (buffer[(scc + 3) % wormRotationSeconds]) + J4;
-      buffer[(scc + 4) % wormRotationSeconds] = (buffer[(scc + 4) % wormRotationSeconds]) + J1;
+      buffer[(scc - 4) % wormRotationSlots] = (buffer[(scc - 4) % wormRotationSlots]) + J1;
+      buffer[(scc - 3) % wormRotationSlots] = (buffer[(scc - 3) % wormRotationSlots]) + J4;
+      buffer[(scc - 2) % wormRotationSlots] = (buffer[(scc - 2) % wormRotationSlots]) + J9;
+      buffer[(scc - 1) % wormRotationSlots] = (buffer[(scc - 1) % wormRotationSlots]) + J17;
+      buffer[(scc    ) % wormRotationSlots] = (buffer[(scc    ) % wormRotationSlots]) - (J17+J17+J9+J9+J4+J4+J1+J1);
+      buffer[(scc + 1) % wormRotationSlots] = (buffer[(scc + 1) % wormRotationSlots]) + J17;
+      buffer[(scc + 2) % wormRotationSlots] = (buffer[(scc + 2) % wormRotationSlots]) + J9;
+      buffer[(scc + 3) % wormRotationSlots] = (buffer[(scc + 3) % wormRotationSlots]) + J4;
+      buffer[(scc + 4) % wormRotationSlots] = (buffer[(scc + 4) % wormRotationSlots]) + J1;
     }
 
     // linear regression
     VLF("MSG: Mount, applying linear regression to PEC data");
     // the number of steps added should equal the number of steps subtracted (from the cycle)
     // first, determine how far we've moved ahead or backward in steps
-    long stepsSum = 0; for (int scc = 0; scc < wormRotationSeconds; scc++) stepsSum += buffer[scc];
+    long stepsSum = 0; for (int scc = 0; scc < wormRotationSlots; scc++) stepsSum += buffer[scc];
 
     // this is the correction coefficient for a given location in the sequence
-    float Ccf = (float)stepsSum/wormRotationSeconds;
+    float Ccf = (float)stepsSum/wormRotationSlots;
 
     // now, apply the correction to the sequence to make the PEC adjustments null out
     // this process was simulated in a spreadsheet and the roundoff error might leave us at +/- a step which is tacked on at the beginning
     long lp2 = 0; stepsSum = 0; 
-    for (int scc = 0; scc < wormRotationSeconds; scc++) {
+    for (int scc = 0; scc < wormRotationSlots; scc++) {
       // the correction, "now"
       long lp1 = lroundf(-scc*Ccf);
       
@@ -312,6 +629,7 @@
       settings.state = PEC_NONE;
     }
   }
+  #endif
 
 #endif
 
@@ -16,10 +16,48 @@
 
 enum PecState: uint8_t {PEC_NONE, PEC_READY_PLAY, PEC_PLAY, PEC_READY_RECORD, PEC_RECORD};
 
+// slots shorter than a second or interpolated playback use 16 bit corrections (in steps per slot)
+#if PEC_SLOT_MS != 1000 || PEC_INTERPOLATE != OFF || PEC_HARMONICS != OFF
+  typedef int16_t PecValue;
+  #define PEC_VALUE_MAX 32767
+#else
+  typedef int8_t PecValue;
+  #define PEC_VALUE_MAX 127
+#endif
+
+#if PEC_HARMONICS != OFF
+  #define PEC_BUFFER_FORMAT (100 + PEC_HARMONICS + (PEC_GEAR_HARMONIC != OFF ? 13 : 0))
+#elif PEC_SLOT_MS != 1000 || PEC_INTERPOLATE != OFF
+  #define PEC_BUFFER_FORMAT (PEC_SLOT_MS/10)
+#else
+  #define PEC_BUFFER_FORMAT 0
+#endif
+
+// the harmonic model keeps only the coefficients (in steps per sidereal second) of each term
+// in NV instead of a table, the worm harmonics 1 to PEC_HARMONICS then any gear harmonic
+#if PEC_HARMONICS != OFF
+  #if PEC_GEAR_HARMONIC != OFF
+    #define PEC_HARMONIC_TERMS (PEC_HARMONICS + 1)
+    #define PEC_HARMONIC_ORDER_MAX PEC_GEAR_HARMONIC
+  #else
+    #define PEC_HARMONIC_TERMS PEC_HARMONICS
+    #define PEC_HARMONIC_ORDER_MAX PEC_HARMONICS
+  #endif
+
+  typedef struct PecHarmonics {
+    float a[PEC_HARMONIC_TERMS];  // cosine
+    float b[PEC_HARMONIC_TERMS];  // sine
+  } PecHarmonics;
+#endif
+
+// playback runs this many slots ahead of the recording, about one second
+#define PEC_PLAY_LEAD ((1000 + PEC_SLOT_MS/2)/PEC_SLOT_MS)
+
 #pragma pack(1)
 #define PecSettingsSize 6
 typedef struct PecSettings {
   bool recorded:1;
+  uint8_t bufferFormat:7;   // PEC_BUFFER_FORMAT the buffer in NV was recorded with
   PecState state;
   long wormRotationSteps;
 } PecSettings;
@@ -32,11 +70,20 @@ class Pec {
     // tracking rate (in x) due to PEC playing
     float rate = 0.0F;
 
+    // bytes of heap allocated for the PEC table, none if PEC is disabled or the harmonic model is used
+    inline long getBufferBytes() {
+      #if AXIS1_PEC == ON && PEC_HARMONICS == OFF
+        return bufferSize*(long)sizeof(PecValue);
+      #else
+        return 0;
+      #endif
+    }
+
     #if AXIS1_PEC == ON
       void init();
       void poll();
 
-      PecSettings settings = { false, PEC_NONE, PEC_STEPS_PER_WORM_ROTATION };
+      PecSettings settings = { false, PEC_BUFFER_FORMAT, PEC_NONE, PEC_STEPS_PER_WORM_ROTATION };
     #endif
 
   private:
@@ -44,14 +91,63 @@ class Pec {
       // disable PEC
       void disable();
 
-      // applies low pass filter to smooth noise in PEC data and linear regression
-      void cleanup();
+      // allocate the table (or model) and read it from NV, false if there isn't enough RAM
+      bool bufferInit(long bufferBytes, bool clear);
+
+      // correction for slot k, in steps
+      long slotValue(long k);
+
+      #if PEC_ADAPTIVE != OFF
+        // fold the guiding done during the last slot into the PEC data
+        void learn();
+      #endif
+
+      #if PEC_ENCODER != OFF
+        // get ready to record from the axis encoder, false if there isn't enough RAM
+        bool encoderRecordStart();
+
+        // add how far the axis moved against the motor over the slot just ended to the recording
+        void encoderRecord();
+
+        // average the recorded rotations into the PEC data, false if the encoder couldn't be read enough
+        bool encoderRecordEnd();
+
+        // release anything the recording holds
+        void encoderRecordFree();
+      #endif
+
+      // time since the current slot started, in thousandths of a fracsec
+      inline long slotElapsed(uint32_t fs) { return (long)(fs - wormRotationStartTimeFs)*1000L - slotStartFrac; }
+
+      // position in slots that playback is at, each slot's value centered on its index
+      inline float slotPosition(uint32_t fs) { return bufferIndex - PEC_PLAY_LEAD + (float)slotElapsed(fs)/slotLength - 0.5F; }
+
+      #if PEC_HARMONICS != OFF
+        // correction from the model at slot position t, in steps per sidereal second
+        float harmonicValue(float t);
+
+        // add each term at slot k times value (in steps per sidereal second) to terms
+        void harmonicAdd(PecHarmonics *terms, long k, float value);
+
+        // fit the model to a completed recording
+        void harmonicFit();
+      #else
+        // applies low pass filter to smooth noise in PEC data and linear regression
+        void cleanup();
+
+        #if PEC_INTERPOLATE != OFF
+          // tracking rate (in x) interpolated between the slots around this moment
+          float interpolatedRate(uint32_t fs);
+        #endif
+      #endif
     #endif
   
     double    stepsPerSiderealSecond    = 0.0L;
     int       stepsPerSiderealSecondI   = 0;
     double    stepsPerMicroSecond       = 0.0L;
-    long      bufferSize                = 0;      // in bytes
+    double    stepsPerSlot              = 0.0L;
+    int       stepsPerSlotI             = 0;
+    long      bufferSize                = 0;      // in slots
     #if AXIS1_PEC == ON
       uint8_t  monitorHandle            = 0;
       uint8_t  senseHandle              = 0;
@@ -63,15 +159,34 @@ class Pec {
 
       bool     firstRecording           = false;
       uint32_t recordStopTimeFs         = 0;
-      uint32_t wormRotationStartTimeFs  = 0;      // start time of worm rotation sequence, in fracsecs or milliseconds
-      long     wormRotationSeconds      = 0;      // time for a worm rotation, in seconds
+      uint32_t wormRotationStartTimeFs  = 0;      // start time of the current slot, in fracsecs
+      uint16_t slotStartFrac            = 0;      // and thousandths of a fracsec
+      long     slotLength               = 0;      // in thousandths of a fracsec
+      long     wormRotationSlots        = 0;      // time for a worm rotation, in slots
       unsigned long accGuideStartTime   = 0;
 
       double   accGuideAxis1            = 0.0L;
+      #if PEC_ADAPTIVE != OFF
+        float  learnCarry               = 0.0F;   // rounding left over from the last table update
+      #endif
+      #if PEC_ENCODER != OFF
+        bool   encoderLastValid         = false;
+        long   encoderLast              = 0;      // encoder less motor position at the last slot, in steps
+        long   encoderSamples           = 0;      // slots recorded
+        #if PEC_HARMONICS == OFF
+          float* encoderSums            = NULL;   // steps for each slot summed over the rotations recorded
+        #endif
+      #endif
 
       bool     bufferStart              = false;
       long     bufferIndex              = 0;      // index into the pec buffer
-      int8_t*  buffer;
+      #if PEC_HARMONICS != OFF
+        PecHarmonics model;
+        PecHarmonics sums;
+        long     sumsCount              = 0;
+      #else
+        PecValue* buffer;
+      #endif
     #endif
 };
 
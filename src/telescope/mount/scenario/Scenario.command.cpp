@@ -0,0 +1,46 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount scenario runner commands
+
+#include "Scenario.h"
+
+#if defined(MOUNT_PRESENT) && defined(MOUNT_SCENARIO)
+
+#include "../../../lib/convert/Convert.h"
+
+bool Scenario::command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError) {
+  *supressFrame = false;
+
+  // :GXZ[n]#   Get scenario results [n]
+  //            0 = state,scenario,step# where state is 0 idle, 1 running, 2 done, 3 failed
+  //            1 = pointing error rms,max# in arc-seconds
+  //            2 = Axis1 step jitter rms,max,Axis2 step jitter rms,max# in steps per 100ms sample
+  if (command[0] == 'G' && command[1] == 'X' && parameter[0] == 'Z' && parameter[2] == 0) {
+    switch (parameter[1]) {
+      case '0': sprintf(reply, "%d,%d,%d", (int)state, (int)number, (int)step); break;
+      case '1':
+        sprintF(reply, "%0.2f,", rms(&pointingError));
+        sprintF(&reply[strlen(reply)], "%0.2f", pointingError.max);
+      break;
+      case '2':
+        sprintF(reply, "%0.2f,", rms(&jitterAxis1));
+        sprintF(&reply[strlen(reply)], "%0.2f,", jitterAxis1.max);
+        sprintF(&reply[strlen(reply)], "%0.2f,", rms(&jitterAxis2));
+        sprintF(&reply[strlen(reply)], "%0.2f", jitterAxis2.max);
+      break;
+      default: *commandError = CE_PARAM_RANGE; return true;
+    }
+    *numericReply = false;
+  } else
+
+  // :SXZS,[n]#  Start scenario [n], 0 = track, 1 = goto, 2 = guide (see Scenario.h)
+  //            Return: 0 on failure (running already, not tracking, or slewing)
+  //                    1 on success
+  if (command[0] == 'S' && command[1] == 'X' && parameter[0] == 'Z' && parameter[1] == 'S' && parameter[2] == ',') {
+    if (parameter[3] < '0' || parameter[3] > '9' || parameter[4] != 0) { *commandError = CE_PARAM_FORM; return true; }
+    *commandError = start(parameter[3] - '0');
+  } else return false;
+
+  return true;
+}
+
+#endif
@@ -0,0 +1,170 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount scenario runner, scripted track, goto, and guide sequences that measure the motion
+
+#include "Scenario.h"
+
+#if defined(MOUNT_PRESENT) && defined(MOUNT_SCENARIO)
+
+#include "../../../lib/tasks/OnTask.h"
+
+#include "../Mount.h"
+#include "../goto/Goto.h"
+#include "../guide/Guide.h"
+
+// goto scenario offsets from the start in hours of RA and degrees of Dec, the last leg returns
+static const float gotoOffsets[5][2] = { {0.5F, 5.0F}, {0.5F, -5.0F}, {-0.5F, -5.0F}, {-0.5F, 5.0F}, {0.0F, 0.0F} };
+
+void scenarioWrapper() { scenario.poll(); }
+
+void Scenario::init() {
+  VF("MSG: Mount, start scenario task (rate "); V(SCENARIO_PERIOD_MS); VF("ms priority 7)... ");
+  if (tasks.add(SCENARIO_PERIOD_MS, 0, true, 7, scenarioWrapper, "MntScn")) { VLF("success"); } else { VLF("FAILED!"); }
+}
+
+CommandError Scenario::start(uint8_t n) {
+  if (n > 2) return CE_PARAM_RANGE;
+  if (state == SS_RUNNING) return CE_0;
+  if (!mount.isTracking() || mount.isSlewing()) return CE_0;
+  #if GOTO_FEATURE != ON
+    if (n == 1) return CE_0;
+  #endif
+
+  pointingError = {0.0F, 0.0, 0};
+  jitterAxis1 = {0.0F, 0.0, 0};
+  jitterAxis2 = {0.0F, 0.0, 0};
+  stepsValid = false;
+
+  #ifdef TASKS_STATISTICS_ENABLE
+    tasks.clearStatistics(0);
+  #endif
+
+  VF("MSG: Mount, scenario "); V(n); VLF(" started");
+  number = n;
+  step = 0;
+  phase = 0;
+  phaseTime = millis();
+  origin = mount.getPosition();
+  state = SS_RUNNING;
+  return CE_NONE;
+}
+
+void Scenario::poll() {
+  if (state != SS_RUNNING) return;
+
+  if (!mount.isTracking() || mount.motorFault()) { end(SS_FAILED); return; }
+
+  // the step rates only hold still between gotos
+  if (mount.isSlewing()) stepsValid = false; else sampleSteps();
+
+  unsigned long elapsed = millis() - phaseTime;
+  switch (number) {
+    case 0:
+      // tracking holds the Native coordinates still
+      add(&pointingError, distance(&origin));
+      if (elapsed > SCENARIO_TRACK_MS) end(SS_DONE);
+    break;
+
+    case 1:
+      #if GOTO_FEATURE == ON
+        if (phase == 0) {
+          target = goTo.getGotoTarget();
+          target.r = origin.r + hrsToRad(gotoOffsets[step][0]);
+          if (target.r >= Deg360) target.r -= Deg360; else if (target.r < 0.0) target.r += Deg360;
+          target.d = origin.d + degToRad(gotoOffsets[step][1]);
+          goTo.setGotoTarget(&target);
+          if (goTo.request() != CE_NONE) { end(SS_FAILED); return; }
+          phase = 1; phaseTime = millis();
+        } else
+        if (phase == 1) {
+          if (goTo.state != GS_NONE) { if (elapsed > SCENARIO_GOTO_MS) { goTo.abort(); end(SS_FAILED); } return; }
+          phase = 2; phaseTime = millis();
+        } else
+        if (elapsed > SCENARIO_SETTLE_MS) {
+          add(&pointingError, distance(&target));
+          phase = 0;
+          if (++step > 4) end(SS_DONE);
+        }
+      #endif
+    break;
+
+    case 2:
+      if (phase == 0) {
+        target = mount.getPosition();
+        CommandError e;
+        switch (step) {
+          case 0:  e = guide.startAxis2(GA_FORWARD, GR_1X, SCENARIO_GUIDE_MS); break;
+          case 1:  e = guide.startAxis2(GA_REVERSE, GR_1X, SCENARIO_GUIDE_MS); break;
+          case 2:  e = guide.startAxis1(GA_REVERSE, GR_1X, SCENARIO_GUIDE_MS); break;
+          default: e = guide.startAxis1(GA_FORWARD, GR_1X, SCENARIO_GUIDE_MS); break;
+        }
+        if (e != CE_NONE) { end(SS_FAILED); return; }
+        phase = 1; phaseTime = millis();
+      } else
+      if (phase == 1) {
+        if (guide.state != GU_NONE) return;
+        phase = 2; phaseTime = millis();
+      } else
+      if (elapsed > SCENARIO_SETTLE_MS) {
+        // at 1x the main axis moves 15 arc-seconds per sidereal second, anything on the other axis is error
+        Coordinate position = mount.getPosition();
+        double deltaRA = position.r - target.r;
+        if (deltaRA > Deg180) deltaRA -= Deg360; else if (deltaRA < -Deg180) deltaRA += Deg360;
+        float moveRA = radToArcsec(deltaRA);
+        float moveDec = radToArcsec(position.d - target.d);
+        float expected = 15.0F*SIDEREAL_RATIO_F*(SCENARIO_GUIDE_MS/1000.0F);
+        float main, cross;
+        if (step < 2) { main = moveDec; cross = moveRA*cos(target.d); } else { main = moveRA; cross = moveDec; }
+        float error = fabs(main) - expected;
+        add(&pointingError, sqrt(error*error + cross*cross));
+        phase = 0;
+        if (++step > 3) end(SS_DONE);
+      }
+    break;
+  }
+}
+
+void Scenario::sampleSteps() {
+  unsigned long now = micros();
+  long stepsAxis1 = axis1.getMotorPositionSteps();
+  long stepsAxis2 = axis2.getMotorPositionSteps();
+
+  if (stepsValid) {
+    float seconds = (now - lastMicros)/1000000.0F;
+    add(&jitterAxis1, labs(stepsAxis1 - lastStepsAxis1) - axis1.getFrequencySteps()*seconds);
+    add(&jitterAxis2, labs(stepsAxis2 - lastStepsAxis2) - axis2.getFrequencySteps()*seconds);
+  }
+
+  lastStepsAxis1 = stepsAxis1;
+  lastStepsAxis2 = stepsAxis2;
+  lastMicros = now;
+  stepsValid = true;
+}
+
+float Scenario::distance(Coordinate *point) {
+  Coordinate position = mount.getPosition();
+  double deltaRA = position.r - point->r;
+  if (deltaRA > Deg180) deltaRA -= Deg360; else if (deltaRA < -Deg180) deltaRA += Deg360;
+  double a = deltaRA*cos(point->d);
+  double b = position.d - point->d;
+  return radToArcsec(sqrt(a*a + b*b));
+}
+
+void Scenario::add(ScenarioStatistic *statistic, float value) {
+  if (fabs(value) > statistic->max) statistic->max = fabs(value);
+  statistic->sumSquares += (double)value*value;
+  statistic->count++;
+}
+
+void Scenario::end(ScenarioState result) {
+  state = result;
+  if (result == SS_DONE) {
+    VF("MSG: Mount, scenario "); V(number); VF(" done, pointing error rms "); V(rms(&pointingError));
+    VF("\" max "); V(pointingError.max); VF("\" step jitter rms "); V(rms(&jitterAxis1)); VF(","); V(rms(&jitterAxis2)); VLF(" steps");
+  } else {
+    VF("MSG: Mount, scenario "); V(number); VF(" failed at step "); VL(step);
+  }
+}
+
+Scenario scenario;
+
+#endif
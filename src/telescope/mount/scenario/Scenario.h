@@ -0,0 +1,77 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount scenario runner, scripted track, goto, and guide sequences that measure the motion
+#pragma once
+
+#include "../../../Common.h"
+
+#if defined(MOUNT_PRESENT) && defined(MOUNT_SCENARIO)
+
+#include "../coordinates/Transform.h"
+
+#define SCENARIO_PERIOD_MS 100     // how often the position and step counts are sampled
+#define SCENARIO_TRACK_MS  60000   // length of the tracking scenario
+#define SCENARIO_SETTLE_MS 1000    // wait after each goto or guide before measuring
+#define SCENARIO_GUIDE_MS  2000    // length of each 1x guide pulse
+#define SCENARIO_GOTO_MS   300000  // longest a goto can take before the scenario fails
+
+enum ScenarioState: uint8_t {SS_IDLE, SS_RUNNING, SS_DONE, SS_FAILED};
+
+typedef struct ScenarioStatistic {
+  float max;
+  double sumSquares;
+  unsigned long count;
+} ScenarioStatistic;
+
+// the scenarios run on the mount as configured, with no motors attached the axes still count steps so
+// a bare board will do, ends with the pointing error, step timing jitter, and (with TASKS_STATISTICS_ENABLE)
+// task statistics cleared at the start so :GXTS covers just the run
+//
+// 0 = track sidereal for a minute, the error is the drift from the starting position
+// 1 = goto four points 30 minutes of RA and 5 degrees of Dec from the start then back, the error is on arrival
+// 2 = guide 1x north, south, east, and west for 2 seconds each, the error is the move compared to the guide rate
+class Scenario {
+  public:
+    void init();
+
+    bool command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
+
+    // start scenario n, the mount must be tracking and not slewing
+    CommandError start(uint8_t n);
+
+    // steps the running scenario along and samples the position and step counts
+    void poll();
+
+    // rms of a statistic
+    inline float rms(ScenarioStatistic *statistic) { return statistic->count ? sqrt(statistic->sumSquares/statistic->count) : 0.0F; }
+
+    ScenarioState state = SS_IDLE;
+    uint8_t number = 0;
+    uint8_t step = 0;
+
+    ScenarioStatistic pointingError;   // in arc-seconds
+    ScenarioStatistic jitterAxis1;     // in steps per sample period
+    ScenarioStatistic jitterAxis2;
+
+  private:
+    void add(ScenarioStatistic *statistic, float value);
+    void end(ScenarioState result);
+
+    // step counts against the step rates over the last sample period
+    void sampleSteps();
+
+    // the distance from the current position to a point in arc-seconds
+    float distance(Coordinate *point);
+
+    uint8_t phase = 0;
+    unsigned long phaseTime = 0;
+    Coordinate origin;
+    Coordinate target;
+
+    bool stepsValid = false;
+    long lastStepsAxis1, lastStepsAxis2;
+    unsigned long lastMicros;
+};
+
+extern Scenario scenario;
+
+#endif
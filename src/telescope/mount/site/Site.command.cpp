@@ -130,7 +130,29 @@ bool Site::command(char *reply, char *command, char *parameter, bool *supressFra
       //            Return: 0 ready, 1 not ready
       if (parameter[1] == '9') {
         if (dateIsReady && timeIsReady) *commandError = CE_0;
-      } else return false;
+      } else
+
+      // :GX8M#     Get site moved status, the GPS fix is away from the location in use
+      //            Return: 0 not moved, 1 moved
+      if (parameter[1] == 'M') {
+        if (!locationMoved) *commandError = CE_0;
+      } else
+
+      #if TIME_LOCATION_PPS_SENSE != OFF
+        // :GX8P#     Get PPS discipline status
+        //            Returns: s,f,p,e# where s is 0 for no sync, 1 for holdover, 2 for locked, f is the MCU clock
+        //            frequency error in ppm, p the phase offset at the last edge and e the estimated timing error in us
+        if (parameter[1] == 'P') {
+          int state = pps.synced ? (pps.holdover ? 1 : 2) : 0;
+          float ppm = (pps.frequencySubMicros - 16000000L)/16.0F;
+          char f[16];
+          sprintF(f, "%1.3f", ppm);
+          sprintf(reply, "%d,%s,%ld,%ld", state, f, (long)pps.phaseMicros, (long)pps.errorMicros);
+          *numericReply = false;
+        } else
+      #endif
+
+      return false;
 
     } else return false;
   } else
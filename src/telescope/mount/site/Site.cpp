@@ -11,11 +11,54 @@
 #include "../park/Park.h"
 #include "../home/Home.h"
 #include "../limits/Limits.h"
+#include "../goto/Goto.h"
 #include "../Mount.h"
 
 // fractional second sidereal clock (fracsec or millisecond)
-volatile unsigned long fracLAST;
-IRAM_ATTR void clockTickWrapper() { fracLAST++; }
+#if SIDEREAL_CLOCK_COUNTER == ON
+  // LAST is the count at clockStartMicros plus the microseconds since at the sidereal rate, set from the
+  // sidereal period and the PPS disciplined length of a second
+  static uint64_t clockStartMicros = 0;
+  static double clockStartFs = 0.0;
+  static double clockFsPerMicro = FRACTIONAL_SEC/1000000.0;
+  static unsigned long clockPeriod = lround(SIDEREAL_PERIOD);
+  static unsigned long clockPpsPeriod = 16000000UL;
+
+  // the scheduler's 64 bit timebase, read fresh since LAST needs better than the pass snapshot
+  static inline uint64_t clockMicros() { return tasks.micros64(); }
+
+  // start counting again from fs at now, so a new rate applies only from here on
+  static void clockRebase(uint64_t now, double fs) {
+    clockStartMicros = now;
+    clockStartFs = fs;
+    // a fracsec is siderealPeriod/FRACTIONAL_SEC sub-micros (16 per us) and the PPS says how long a second is
+    clockFsPerMicro = (FRACTIONAL_SEC*16.0*16000000.0)/((double)clockPeriod*clockPpsPeriod);
+  }
+
+  double siderealClockFs() {
+    uint64_t now = clockMicros();
+    double fs = clockStartFs + (double)(now - clockStartMicros)*clockFsPerMicro;
+    #if TIME_LOCATION_PPS_SENSE != OFF
+      unsigned long ppsPeriod = pps.periodSubMicros;
+      if (ppsPeriod != clockPpsPeriod) { clockPpsPeriod = ppsPeriod; clockRebase(now, fs); }
+    #endif
+    return fs;
+  }
+
+  static void siderealClockSet(double fs) { clockRebase(clockMicros(), fs); }
+
+  static void siderealClockSetPeriod(unsigned long period) {
+    uint64_t now = clockMicros();
+    double fs = clockStartFs + (double)(now - clockStartMicros)*clockFsPerMicro;
+    clockPeriod = period;
+    clockRebase(now, fs);
+  }
+
+  void clockTickWrapper() { siderealClockFs(); }
+#else
+  volatile unsigned long fracLAST;
+  IRAM_ATTR void clockTickWrapper() { fracLAST++; }
+#endif
 
 #define fsToHours(x) ((x)/(3600.0*FRACTIONAL_SEC))
 #define hoursToFs(x) ((x)*(3600.0*FRACTIONAL_SEC))
@@ -23,6 +66,37 @@ IRAM_ATTR void clockTickWrapper() { fracLAST++; }
 #define daysToFs(x)  ((x)*(86400.0*FRACTIONAL_SEC))
 
 #if TIME_LOCATION_SOURCE == GPS
+  #if GPS_CONTINUOUS == ON
+    // keeps the site time in step with the GPS, it's only stepped while the mount isn't slewing
+    void gpsResync() {
+      static unsigned long resyncTime = 0;
+      if ((long)(millis() - resyncTime) < 0 || !tls.isUpdated() || mount.isSlewing()) return;
+      #if GOTO_FEATURE == ON
+        if (goTo.state != GS_NONE) return;
+      #endif
+      resyncTime = millis() + GPS_RESYNC_MINUTES*60000UL;
+
+      JulianDate gpsTime;
+      tls.get(gpsTime);
+      JulianDate now = site.getDateTime();
+      double error = ((gpsTime.day - now.day)*24.0 + (gpsTime.hour - now.hour))*3600000.0;
+      if (fabs(error) > GPS_RESYNC_MS) {
+        VF("MSG: Mount, site time corrected from GPS by "); V(lround(error)); VLF("ms");
+        site.setDateTime(gpsTime);
+      }
+
+      // flag the site as moved, the location in use isn't changed under a running session
+      double latitude, longitude;
+      float elevation;
+      tls.getSite(latitude, longitude, elevation);
+      double north = degToRad(latitude) - site.location.latitude;
+      double east = (degToRad(longitude) - site.location.longitude)*site.locationEx.latitude.cosine;
+      bool moved = sqrt(north*north + east*east)*6371000.0 > GPS_MOVED_METERS;
+      if (moved && !site.locationMoved) { DLF("WRN: Mount, GPS shows the site has moved"); }
+      site.locationMoved = moved;
+    }
+  #endif
+
   void gpsCheck() {
     if (tls.isReady()) {
       VLF("MSG: Mount, setting site from GPS");
@@ -46,6 +120,11 @@ IRAM_ATTR void clockTickWrapper() { fracLAST++; }
         if (park.state == PS_PARKED) park.restore(false);
       #endif
 
+      #if GPS_CONTINUOUS == ON
+        VF("MSG: Mount, start GPS resync task (rate 5000ms priority 7)... ");
+        if (tasks.add(5000, 0, true, 7, gpsResync, "gpsSync")) { VLF("success"); } else { VLF("FAILED!"); }
+      #endif
+
       VLF("MSG: Mount, stopping GPS monitor task");
       tasks.setDurationComplete(tasks.getHandleByName("gpsChk"));
     } else
@@ -60,6 +139,51 @@ IRAM_ATTR void clockTickWrapper() { fracLAST++; }
   }
 #endif
 
+#if TIME_LOCATION_RTC_ALIGN == ON
+  #define RTC_ALIGN_WINDOW_US 2000    // an edge is only used if it's pinned down to this window
+  #define RTC_ALIGN_TIMEOUT_MS 5000   // give up and keep the whole second time after this long
+
+  // the RTC only gives whole seconds, watch for the next one to start and set the time from that edge
+  void rtcAlign() {
+    static int lastSecond = -1;
+    static unsigned long lastRead = 0;
+    static unsigned long startTime = millis();
+
+    unsigned long t0 = micros();
+    int second = tls.getSecond();
+    unsigned long t1 = micros();
+    if (second < 0 || (long)(millis() - startTime) > RTC_ALIGN_TIMEOUT_MS) {
+      DLF("WRN: Mount, RTC seconds edge not found keeping the whole second time");
+      tasks.setDurationComplete(tasks.getHandleByName("rtcAlgn"));
+      return;
+    }
+
+    if (second != lastSecond && lastSecond >= 0) {
+      // the second started between the last read and this one
+      unsigned long window = t1 - lastRead;
+      unsigned long edge = lastRead + window/2;
+
+      #if TIME_LOCATION_PPS_SENSE != OFF
+        // the SQW pin on the PPS input marks the edge exactly, if it's the edge the seconds count changes on
+        if ((long)(pps.lastMicros - lastRead) >= 0 && (long)(t1 - pps.lastMicros) >= 0) { edge = pps.lastMicros; window = 0; }
+      #endif
+
+      if (window <= RTC_ALIGN_WINDOW_US) {
+        JulianDate jd;
+        tls.get(jd);
+        jd.hour += (micros() - edge)/3600000000.0;
+        site.setDateTime(jd);
+        VF("MSG: Mount, site time aligned to the RTC seconds edge (+/-"); V(window/2); VLF("us)");
+        tasks.setDurationComplete(tasks.getHandleByName("rtcAlgn"));
+        return;
+      }
+    }
+
+    lastSecond = second;
+    lastRead = t0;
+  }
+#endif
+
 #if TIME_LOCATION_SOURCE == NTP
   void ntpCheck() {
     if (tls.isReady()) {
@@ -102,6 +226,10 @@ void Site::init() {
         dateIsReady = true;
         timeIsReady = true;
         VLF("MSG: Mount, site get Date/Time from TLS");
+        #if TIME_LOCATION_RTC_ALIGN == ON
+          VF("MSG: Mount, start RTC seconds edge task (rate 1ms priority 7)... ");
+          if (tasks.add(1, 0, true, 7, rtcAlign, "rtcAlgn")) { VLF("success"); } else { VLF("FAILED!"); }
+        #endif
       } else {
         VLF("MSG: Site, falling back to Date/Time from NV");
         readJD();
@@ -128,14 +256,21 @@ void Site::init() {
 
   setSiderealTime(ut1);
 
-  VF("MSG: Mount, site start sidereal timer task (rate 10ms priority 0)... ");
-  delay(100);
-  // period ms (0=idle), duration ms (0=forever), repeat, priority (highest 0..7 lowest), task_handle
-  taskHandle = tasks.add(0, 0, true, 0, clockTickWrapper, "ClkTick");
-  if (taskHandle) {
-    VLF("success"); 
-    if (!tasks.requestHardwareTimer(taskHandle, 1)) { DLF("WRN: Site::init(), didn't get h/w timer for Clock (using s/w timer)"); }
-  } else { VLF("FAILED!"); }
+  #if SIDEREAL_CLOCK_COUNTER == ON
+    // nothing to tick, the task just keeps the counter and PPS rate current when nothing else reads the clock
+    VF("MSG: Mount, site start sidereal clock task (rate 1000ms priority 7)... ");
+    taskHandle = tasks.add(1000, 0, true, 7, clockTickWrapper, "ClkTick");
+    if (taskHandle) { VLF("success"); } else { VLF("FAILED!"); }
+  #else
+    VF("MSG: Mount, site start sidereal timer task (rate 10ms priority 0)... ");
+    delay(100);
+    // period ms (0=idle), duration ms (0=forever), repeat, priority (highest 0..7 lowest), task_handle
+    taskHandle = tasks.add(0, 0, true, 0, clockTickWrapper, "ClkTick");
+    if (taskHandle) {
+      VLF("success"); 
+      if (!tasks.requestHardwareTimer(taskHandle, 1)) { DLF("WRN: Site::init(), didn't get h/w timer for Clock (using s/w timer)"); }
+    } else { VLF("FAILED!"); }
+  #endif
 
   setSiderealPeriod(SIDEREAL_PERIOD);
 
@@ -194,11 +329,7 @@ void Site::setDateTime(JulianDate julianDate) {
 
 // gets the time in sidereal hours
 double Site::getSiderealTime() {
-  long fs;
-  noInterrupts();
-  fs = fracLAST;
-  interrupts();
-  return rangeHours(fsToHours(fs));
+  return rangeHours(fsToHours(getFracLASTExact()));
 }
 
 // sets the UT time (in hours) that have passed in this Julian Day
@@ -219,15 +350,16 @@ unsigned long Site::getSiderealPeriod() {
 // sets sidereal period, in sub-micro counts per second
 void Site::setSiderealPeriod(unsigned long period) {
   siderealPeriod = period;
-  tasks.setPeriodSubMicros(taskHandle, lround(siderealPeriod/FRACTIONAL_SEC));
+  #if SIDEREAL_CLOCK_COUNTER == ON
+    siderealClockSetPeriod(siderealPeriod);
+  #else
+    tasks.setPeriodSubMicros(taskHandle, lround(siderealPeriod/FRACTIONAL_SEC));
+  #endif
 }
 
 // gets the time in hours that have passed since Julian Day was set (UT1)
 double Site::getTime() {
-  unsigned long cs;
-  noInterrupts();
-  cs = fracLAST;
-  interrupts();
+  unsigned long cs = getFracLAST();
   return fracHOUR + fsToHours((cs - fracSTART)/SIDEREAL_RATIO);
 }
 
@@ -236,9 +368,13 @@ void Site::setLAST(JulianDate julianDate, double time) {
   long fs = lround(hoursToFs(time));
   fracHOUR = julianDate.hour;
   fracSTART = fs;
-  noInterrupts();
-  fracLAST = fs;
-  interrupts();
+  #if SIDEREAL_CLOCK_COUNTER == ON
+    siderealClockSet(fs);
+  #else
+    noInterrupts();
+    fracLAST = fs;
+    interrupts();
+  #endif
 }
 
 // convert julian date/time to local apparent sidereal time
@@ -251,23 +387,26 @@ double Site::julianDateToLAST(JulianDate julianDate) {
 
 // convert julian date/time to greenwich apparent sidereal time
 double Site::julianDateToGAST(JulianDate julianDate) {
-  GregorianDate date;
+  // the parts that only change with the date are worked out once per day
+  if (julianDate.day != epoch.day) {
+    GregorianDate date = calendars.julianDayToGregorian(julianDate);
+    JulianDate julianDay0 = calendars.gregorianToJulianDay(date);
+    double D0 = (julianDay0.day - 2451545.0);
+    epoch.day = julianDate.day;
+    epoch.gmst0 = 6.697374558 + 0.06570982441908*D0;
+    epoch.obliquityCosine = cos(degToRad(23.4393 - 0.0000004*D0));
+  }
 
-  date = calendars.julianDayToGregorian(julianDate);
-  JulianDate julianDay0 = calendars.gregorianToJulianDay(date);
-  double D= (julianDate.day - 2451545.0) + julianDate.hour/24.0;
-  double D0=(julianDay0.day - 2451545.0);
   double H = julianDate.hour;
+  double D = (julianDate.day - 2451545.0) + H/24.0;
   double T = D/36525.0;
-  double gmst = 6.697374558 + 0.06570982441908*D0;
-  gmst = gmst + SIDEREAL_RATIO*H + 0.000026*T*T;
+  double gmst = epoch.gmst0 + SIDEREAL_RATIO*H + 0.000026*T*T;
 
   // equation of the equinoxes
   double O = 125.04  - 0.052954 *D;
   double L = 280.47  + 0.98565  *D;
-  double E = 23.4393 - 0.0000004*D;
   double W = -0.000319*sin(degToRad(O)) - 0.000024*sin(degToRad(2*L));
-  double eqeq = W*cos(degToRad(E));
+  double eqeq = W*epoch.obliquityCosine;
   double gast = gmst + eqeq;
 
   return rangeHours(gast);
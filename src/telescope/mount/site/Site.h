@@ -12,7 +12,19 @@
 #include "../../../lib/tls/Tls.h"
 #include "../../../lib/tls/PPS.h"
 
-extern volatile unsigned long fracLAST;
+// fractional second sidereal clock (LAST in fracsec counts)
+#if SIDEREAL_CLOCK_COUNTER == ON
+  // worked out from the free running microsecond counter, with sub-fracsec resolution
+  double siderealClockFs();
+  inline unsigned long getFracLAST() { return (unsigned long)(uint64_t)siderealClockFs(); }
+  inline double getFracLASTExact() { return siderealClockFs(); }
+#else
+  // counted by the clock tick interrupt
+  extern volatile unsigned long fracLAST;
+  // a 32-bit load is atomic on all supported platforms so the clock tick ISR needn't be held off
+  inline unsigned long getFracLAST() { return fracLAST; }
+  inline double getFracLASTExact() { return getFracLAST(); }
+#endif
 
 typedef struct LatitudeExtras {
   double sine;
@@ -21,6 +33,13 @@ typedef struct LatitudeExtras {
   double sign;
 } Latitude;
 
+// sidereal time terms that only change with the date
+typedef struct EpochContext {
+  double day;             // Julian day these are for
+  double gmst0;           // GMST at 0h UT, in hours
+  double obliquityCosine; // of the ecliptic
+} EpochContext;
+
 typedef struct LocationExtras {
   LatitudeExtras latitude;
   bool ready;
@@ -86,6 +105,9 @@ class Site {
     bool dateIsReady = false;
     bool timeIsReady = false;
 
+    // the GPS fix is more than GPS_MOVED_METERS from the location in use
+    bool locationMoved = false;
+
   private:
     // gets the time in hours that have passed since Julian Day was set (UT1)
     double getTime();
@@ -124,6 +146,9 @@ class Site {
     // convert string in format MM/DD/YY or MM/DD/YYYY to Date (changes only date)
     bool strToDate(char *ymd, GregorianDate *date);
 
+    // sidereal time terms that only change with the date
+    EpochContext epoch = {0.0, 0.0, 1.0};
+
     // the current UT1 date and time
     JulianDate ut1;
     double fracHOUR = 0;
@@ -25,10 +25,21 @@
 
   #include "../../../lib/serial/Serial_Local.h"
 
-  Button st4Axis1Rev(ST4_RA_E_PIN, ST4_INTERFACE_INIT, LOW | HYST(debounceMs));
-  Button st4Axis1Fwd(ST4_RA_W_PIN, ST4_INTERFACE_INIT, LOW | HYST(debounceMs));
-  Button st4Axis2Fwd(ST4_DEC_N_PIN, ST4_INTERFACE_INIT, LOW | HYST(debounceMs));
-  Button st4Axis2Rev(ST4_DEC_S_PIN, ST4_INTERFACE_INIT, LOW | HYST(debounceMs));
+  #if ST4_INTERRUPT == ON
+    uint8_t st4TaskHandle = 0;
+    volatile unsigned long st4EdgeTime = 0;
+
+    // any edge on the guide inputs wakes the monitor task
+    IRAM_ATTR void st4Edge() {
+      st4EdgeTime = micros();
+      tasks.immediate(st4TaskHandle);
+    }
+  #else
+    Button st4Axis1Rev(ST4_RA_E_PIN, ST4_INTERFACE_INIT, LOW | HYST(debounceMs));
+    Button st4Axis1Fwd(ST4_RA_W_PIN, ST4_INTERFACE_INIT, LOW | HYST(debounceMs));
+    Button st4Axis2Fwd(ST4_DEC_N_PIN, ST4_INTERFACE_INIT, LOW | HYST(debounceMs));
+    Button st4Axis2Rev(ST4_DEC_S_PIN, ST4_INTERFACE_INIT, LOW | HYST(debounceMs));
+  #endif
 
   // Single byte guide commands
   #define ccMe 14
@@ -45,7 +56,21 @@
   }
 
   void St4::init() {
-    #ifdef HAL_SLOW_PROCESSOR
+    #if ST4_INTERRUPT == ON
+      // the slow poll only catches an edge that might have been missed
+      VF("MSG: Mount, ST4 start monitor task (on pin change or rate 100ms priority 1)... ");
+      st4TaskHandle = tasks.add(100, 0, true, 1, st4Wrapper, "St4Mntr");
+      if (st4TaskHandle) { VLF("success"); } else { VLF("FAILED!"); }
+
+      pinModeEx(ST4_RA_E_PIN, ST4_INTERFACE_INIT);
+      pinModeEx(ST4_RA_W_PIN, ST4_INTERFACE_INIT);
+      pinModeEx(ST4_DEC_N_PIN, ST4_INTERFACE_INIT);
+      pinModeEx(ST4_DEC_S_PIN, ST4_INTERFACE_INIT);
+      attachInterrupt(digitalPinToInterrupt(ST4_RA_E_PIN), st4Edge, CHANGE);
+      attachInterrupt(digitalPinToInterrupt(ST4_RA_W_PIN), st4Edge, CHANGE);
+      attachInterrupt(digitalPinToInterrupt(ST4_DEC_N_PIN), st4Edge, CHANGE);
+      attachInterrupt(digitalPinToInterrupt(ST4_DEC_S_PIN), st4Edge, CHANGE);
+    #elif defined(HAL_SLOW_PROCESSOR)
       VF("MSG: Mount, ST4 start monitor task (rate 5ms priority 1)... ");
       if (tasks.add(5, 0, true, 1, st4Wrapper, "St4Mntr")) { VLF("success"); } else { VLF("FAILED!"); }
     #else
@@ -60,13 +85,15 @@
   // monitor ST4 port for guiding, basic hand controller, and smart hand controller
   void St4::poll() {
 
-    st4Axis1Rev.poll();
-    static bool shcActive = false;
-    if (!shcActive) {
-      st4Axis1Fwd.poll();
-      st4Axis2Fwd.poll();
-      st4Axis2Rev.poll();
-    }
+    #if ST4_INTERRUPT == OFF
+      st4Axis1Rev.poll();
+      static bool shcActive = false;
+      if (!shcActive) {
+        st4Axis1Fwd.poll();
+        st4Axis2Fwd.poll();
+        st4Axis2Rev.poll();
+      }
+    #endif
 
     #if ST4_HAND_CONTROL == ON
       if (st4Axis1Rev.hasTone()) {
@@ -211,12 +238,24 @@
     #endif
 
     if (axis1.isEnabled()) {
+      #if ST4_INTERRUPT == ON
+        bool axis1Fwd = digitalReadF(ST4_RA_W_PIN) == LOW;
+        bool axis1Rev = digitalReadF(ST4_RA_E_PIN) == LOW;
+        bool axis2Fwd = digitalReadF(ST4_DEC_N_PIN) == LOW;
+        bool axis2Rev = digitalReadF(ST4_DEC_S_PIN) == LOW;
+      #else
+        bool axis1Fwd = st4Axis1Fwd.isDown();
+        bool axis1Rev = st4Axis1Rev.isDown();
+        bool axis2Fwd = st4Axis2Fwd.isDown();
+        bool axis2Rev = st4Axis2Rev.isDown();
+      #endif
+
       // guide E/W
       bool pulseGuiding = GUIDE_SEPARATE_PULSE_RATE == ON && ST4_HAND_CONTROL != ON;
       GuideAction st4GuideActionAxis1 = GA_BREAK;
       static GuideAction lastSt4GuideActionAxis1 = GA_BREAK;
-      if (st4Axis1Fwd.isDown() && st4Axis1Rev.isUp()) st4GuideActionAxis1 = GA_FORWARD;
-      if (st4Axis1Rev.isDown() && st4Axis1Fwd.isUp()) st4GuideActionAxis1 = GA_REVERSE;
+      if (axis1Fwd && !axis1Rev) st4GuideActionAxis1 = GA_FORWARD;
+      if (axis1Rev && !axis1Fwd) st4GuideActionAxis1 = GA_REVERSE;
 
       if (st4GuideActionAxis1 != lastSt4GuideActionAxis1) {
         lastSt4GuideActionAxis1 = st4GuideActionAxis1;
@@ -227,13 +266,16 @@
           #endif
           guide.startAxis1(st4GuideActionAxis1, pulseGuiding ? guide.settings.pulseRateSelect : guide.settings.axis1RateSelect, GUIDE_TIME_LIMIT*1000);
         } else guide.stopAxis1();
+        #if ST4_INTERRUPT == ON
+          VF("MSG: ST4, Axis1 edge to guide "); V(micros() - st4EdgeTime); VLF("us");
+        #endif
       }
 
       // guide N/S
       GuideAction st4GuideActionAxis2 = GA_BREAK;
       static GuideAction lastSt4GuideActionAxis2 = GA_BREAK;
-      if (st4Axis2Fwd.isDown() && st4Axis2Rev.isUp()) st4GuideActionAxis2 = GA_FORWARD;
-      if (st4Axis2Rev.isDown() && st4Axis2Fwd.isUp()) st4GuideActionAxis2 = GA_REVERSE;
+      if (axis2Fwd && !axis2Rev) st4GuideActionAxis2 = GA_FORWARD;
+      if (axis2Rev && !axis2Fwd) st4GuideActionAxis2 = GA_REVERSE;
 
       if (st4GuideActionAxis2 != lastSt4GuideActionAxis2) {
         lastSt4GuideActionAxis2 = st4GuideActionAxis2;
@@ -244,6 +286,9 @@
           #endif
           guide.startAxis2(st4GuideActionAxis2, pulseGuiding ? guide.settings.pulseRateSelect : guide.settings.axis2RateSelect, GUIDE_TIME_LIMIT*1000);
         } else guide.stopAxis2();
+        #if ST4_INTERRUPT == ON
+          VF("MSG: ST4, Axis2 edge to guide "); V(micros() - st4EdgeTime); VLF("us");
+        #endif
       }
 
     }
@@ -0,0 +1,91 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount UDP telemetry
+
+#include "Telemetry.h"
+
+#if defined(MOUNT_PRESENT) && TELEMETRY_RATE != OFF
+
+#include "../../../lib/tasks/OnTask.h"
+#include "../../../lib/convert/Convert.h"
+#include "../Mount.h"
+#include "../coordinates/Transform.h"
+#include "../goto/Goto.h"
+#include "../guide/Guide.h"
+#include "../limits/Limits.h"
+#include "../park/Park.h"
+#include "../../focuser/Focuser.h"
+#include "../../rotator/Rotator.h"
+
+IPAddress telemetryAddress = IPAddress TELEMETRY_IP_ADDR;
+
+void telemetryWrapper() { telemetry.poll(); }
+
+void Telemetry::init() {
+  #if OPERATIONAL_MODE == WIFI
+    if (!wifiManager.init()) { DLF("WRN: Telemetry, no WiFi skipping"); return; }
+  #else
+    if (!ethernetManager.init()) { DLF("WRN: Telemetry, no Ethernet skipping"); return; }
+  #endif
+
+  // sending only, the local port is just where replies (if any) would arrive
+  udp.begin(TELEMETRY_PORT);
+
+  VF("MSG: Telemetry, start UDP task (rate "); V(1000/TELEMETRY_RATE); VF("ms priority 7)... ");
+  handle = tasks.add(1000/TELEMETRY_RATE, 0, true, 7, telemetryWrapper, "Telmtry");
+  if (handle) { VLF("success"); active = true; } else { VLF("FAILED!"); }
+}
+
+void Telemetry::poll() {
+  if (!active) return;
+
+  build();
+
+  if (!udp.beginPacket(telemetryAddress, TELEMETRY_PORT)) return;
+  udp.write((const uint8_t*)buffer, strlen(buffer));
+  udp.endPacket();
+}
+
+void Telemetry::build() {
+  Coordinate position = mount.getMountPosition(CR_MOUNT);
+  position = transform.mountToNative(&position, true);
+
+  uint8_t flags = 0;
+  if (mount.isTracking()) flags |= TF_TRACKING;
+  if (goTo.state != GS_NONE) flags |= TF_GOTO;
+  if (guide.state != GU_NONE) flags |= TF_GUIDING;
+  if (park.state == PS_PARKED) flags |= TF_PARKED;
+  if (park.state == PS_PARKING || park.state == PS_UNPARKING) flags |= TF_PARKING;
+  if (park.state == PS_PARK_FAILED) flags |= TF_PARK_FAILED;
+  if (mount.isHome()) flags |= TF_AT_HOME;
+  if (mount.motorFault()) flags |= TF_MOTOR_FAULT;
+
+  char pierSide = 'N';
+  if (position.pierSide == PIER_SIDE_EAST) pierSide = 'E'; else
+  if (position.pierSide == PIER_SIDE_WEST) pierSide = 'W';
+
+  Formatter packet(buffer, sizeof(buffer));
+  packet.str("$OSX,").uint(sequence++).chr(',');
+  packet.fixed(radToHrs(position.r), 5).chr(',').fixed(radToDeg(position.d), 4).chr(',');
+  packet.fixed(radToDeg(position.a), 4).chr(',').fixed(radToDeg(position.z), 4).chr(',');
+  packet.fixed(radToArcsec(axis1.getFrequency()), 2).chr(',').fixed(radToArcsec(axis2.getFrequency()), 2).chr(',');
+  packet.chr(pierSide).chr(',').hex(flags).chr(',').uint(limits.errorCode());
+
+  #ifdef FOCUSER_PRESENT
+    for (int index = 0; index < FOCUSER_MAX; index++) {
+      float microns;
+      packet.chr(',');
+      if (focuser.getPosition(index, &microns)) packet.fixed(microns, 1);
+    }
+  #endif
+
+  packet.chr(',');
+  #ifdef ROTATOR_PRESENT
+    packet.fixed(rotator.getPosition(), 3);
+  #endif
+
+  packet.chr('\n');
+}
+
+Telemetry telemetry;
+
+#endif
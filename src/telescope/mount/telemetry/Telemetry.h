@@ -0,0 +1,58 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount UDP telemetry
+#pragma once
+
+#include "../../../Common.h"
+
+#if defined(MOUNT_PRESENT) && TELEMETRY_RATE != OFF
+
+#if OPERATIONAL_MODE == WIFI
+  #include "../../../lib/wifi/WifiManager.h"
+  #include <WiFiUdp.h>
+#else
+  #include "../../../lib/ethernet/EthernetManager.h"
+  #include <EthernetUdp.h>
+#endif
+
+// one CSV line per packet, for example:
+// $OSX,1234,5.12345,+41.2690,+45.1234,123.4567,15.04,0.00,E,01,0,1250.0,,12.345
+// sequence, RA (hours), Dec, Alt, Azm (degrees), axis1, axis2 rates (arc-seconds/second), pier side (E, W, or N),
+// state flags (hex, see below), limits error code, up to FOCUSER_MAX focuser positions (microns), rotator (degrees)
+#define TELEMETRY_PACKET_SIZE 160
+
+#define TF_TRACKING    0x01
+#define TF_GOTO        0x02
+#define TF_GUIDING     0x04
+#define TF_PARKED      0x08
+#define TF_PARKING     0x10
+#define TF_PARK_FAILED 0x20
+#define TF_AT_HOME     0x40
+#define TF_MOTOR_FAULT 0x80
+
+class Telemetry {
+  public:
+    // start sending packets at TELEMETRY_RATE per second
+    void init();
+
+    // build and send one packet
+    void poll();
+
+  private:
+    // build the packet in buffer
+    void build();
+
+    #if OPERATIONAL_MODE == WIFI
+      WiFiUDP udp;
+    #else
+      EthernetUDP udp;
+    #endif
+
+    char buffer[TELEMETRY_PACKET_SIZE];
+    uint32_t sequence = 0;
+    bool active = false;
+    uint8_t handle = 0;
+};
+
+extern Telemetry telemetry;
+
+#endif
@@ -0,0 +1,273 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount trajectory, SGP4 satellite propagation from a two-line element set
+
+#include "Sgp4.h"
+
+#if defined(MOUNT_PRESENT) && TRAJECTORY == ON
+
+// WGS72 constants, as the elements are generated with
+#define SGP4_RADIUS_KM  6378.135
+#define SGP4_FLATTENING (1.0/298.26)
+#define SGP4_XKE        0.0743669161331734   // 60/sqrt(radius^3/mu), in per minute
+#define SGP4_J2         0.001082616
+#define SGP4_J3OJ2      (-0.00000253881/0.001082616)
+#define SGP4_J4         (-0.00000165597)
+#define SGP4_X2O3       (2.0/3.0)
+
+bool Sgp4::init(const char *line1, const char *line2) {
+  if (line1[0] != '1' || line2[0] != '2' || !checksum(line1) || !checksum(line2)) return false;
+
+  // epoch year and day of the year with fraction
+  int year = lround(field(line1, 19, 20));
+  year += year < 57 ? 2000 : 1900;
+  double day = field(line1, 21, 32);
+  double january1 = 367.0*year - floor(7.0*year/4.0) + 31.0 + 1721013.5;
+  epoch.day = january1 + floor(day) - 1.0;
+  epoch.hour = (day - floor(day))*24.0;
+
+  // the B* drag term and eccentricity have an assumed decimal point, B* also has an exponent
+  bstar = field(line1, 54, 59)*1.0e-5*pow(10.0, field(line1, 60, 61));
+  inclo = degToRad(field(line2, 9, 16));
+  nodeo = degToRad(field(line2, 18, 25));
+  ecco = field(line2, 27, 33)*1.0e-7;
+  argpo = degToRad(field(line2, 35, 42));
+  mo = degToRad(field(line2, 44, 51));
+  double noKozai = field(line2, 53, 63)*Deg360/1440.0;
+  if (noKozai <= 0.0 || ecco >= 1.0) return false;
+
+  // recover the original mean motion and semi-major axis
+  double cosio = cos(inclo);
+  double cosio2 = cosio*cosio;
+  double eccsq = ecco*ecco;
+  double omeosq = 1.0 - eccsq;
+  double rteosq = sqrt(omeosq);
+  double ak = pow(SGP4_XKE/noKozai, SGP4_X2O3);
+  double d1 = 0.75*SGP4_J2*(3.0*cosio2 - 1.0)/(rteosq*omeosq);
+  double del = d1/(ak*ak);
+  double adel = ak*(1.0 - del*del - del*(1.0/3.0 + 134.0*del*del/81.0));
+  del = d1/(adel*adel);
+  no = noKozai/(1.0 + del);
+
+  // deep space elements need SDP4
+  if (Deg360/no >= 225.0) return false;
+
+  double ao = pow(SGP4_XKE/no, SGP4_X2O3);
+  double sinio = sin(inclo);
+  double po = ao*omeosq;
+  double con42 = 1.0 - 5.0*cosio2;
+  con41 = -con42 - cosio2 - cosio2;
+  double posq = po*po;
+  double rp = ao*(1.0 - ecco);
+
+  // perigee below 220 km uses the simplified drag terms
+  isimp = rp < 220.0/SGP4_RADIUS_KM + 1.0;
+
+  double sfour = 78.0/SGP4_RADIUS_KM + 1.0;
+  double qzms24 = pow((120.0 - 78.0)/SGP4_RADIUS_KM, 4.0);
+  double perigee = (rp - 1.0)*SGP4_RADIUS_KM;
+  if (perigee < 156.0) {
+    sfour = perigee < 98.0 ? 20.0 : perigee - 78.0;
+    qzms24 = pow((120.0 - sfour)/SGP4_RADIUS_KM, 4.0);
+    sfour = sfour/SGP4_RADIUS_KM + 1.0;
+  }
+
+  double pinvsq = 1.0/posq;
+  double tsi = 1.0/(ao - sfour);
+  eta = ao*ecco*tsi;
+  double etasq = eta*eta;
+  double eeta = ecco*eta;
+  double psisq = fabs(1.0 - etasq);
+  double coef = qzms24*pow(tsi, 4.0);
+  double coef1 = coef/pow(psisq, 3.5);
+  double cc2 = coef1*no*(ao*(1.0 + 1.5*etasq + eeta*(4.0 + etasq)) + 0.375*SGP4_J2*tsi/psisq*con41*(8.0 + 3.0*etasq*(8.0 + etasq)));
+  cc1 = bstar*cc2;
+  double cc3 = ecco > 1.0e-4 ? -2.0*coef*tsi*SGP4_J3OJ2*no*sinio/ecco : 0.0;
+  x1mth2 = 1.0 - cosio2;
+  cc4 = 2.0*no*coef1*ao*omeosq*(eta*(2.0 + 0.5*etasq) + ecco*(0.5 + 2.0*etasq) -
+        SGP4_J2*tsi/(ao*psisq)*(-3.0*con41*(1.0 - 2.0*eeta + etasq*(1.5 - 0.5*eeta)) +
+        0.75*x1mth2*(2.0*etasq - eeta*(1.0 + etasq))*cos(2.0*argpo)));
+  cc5 = 2.0*coef1*ao*omeosq*(1.0 + 2.75*(etasq + eeta) + eeta*etasq);
+
+  // secular rates of the mean anomaly, argument of perigee, and node
+  double cosio4 = cosio2*cosio2;
+  double temp1 = 1.5*SGP4_J2*pinvsq*no;
+  double temp2 = 0.5*temp1*SGP4_J2*pinvsq;
+  double temp3 = -0.46875*SGP4_J4*pinvsq*pinvsq*no;
+  mdot = no + 0.5*temp1*rteosq*con41 + 0.0625*temp2*rteosq*(13.0 - 78.0*cosio2 + 137.0*cosio4);
+  argpdot = -0.5*temp1*con42 + 0.0625*temp2*(7.0 - 114.0*cosio2 + 395.0*cosio4) + temp3*(3.0 - 36.0*cosio2 + 49.0*cosio4);
+  double xhdot1 = -temp1*cosio;
+  nodedot = xhdot1 + (0.5*temp2*(4.0 - 19.0*cosio2) + 2.0*temp3*(3.0 - 7.0*cosio2))*cosio;
+
+  omgcof = bstar*cc3*cos(argpo);
+  xmcof = ecco > 1.0e-4 ? -SGP4_X2O3*coef*bstar/eeta : 0.0;
+  nodecf = 3.5*omeosq*xhdot1*cc1;
+  t2cof = 1.5*cc1;
+  double denominator = fabs(cosio + 1.0) > 1.5e-12 ? 1.0 + cosio : 1.5e-12;
+  xlcof = -0.25*SGP4_J3OJ2*sinio*(3.0 + 5.0*cosio)/denominator;
+  aycof = -0.5*SGP4_J3OJ2*sinio;
+  delmo = pow(1.0 + eta*cos(mo), 3.0);
+  sinmao = sin(mo);
+  x7thm1 = 7.0*cosio2 - 1.0;
+
+  if (!isimp) {
+    double cc1sq = cc1*cc1;
+    d2 = 4.0*ao*tsi*cc1sq;
+    double temp = d2*tsi*cc1/3.0;
+    d3 = (17.0*ao + sfour)*temp;
+    d4 = 0.5*temp*ao*tsi*(221.0*ao + 31.0*sfour)*cc1;
+    t3cof = d2 + 2.0*cc1sq;
+    t4cof = 0.25*(3.0*d3 + cc1*(12.0*d2 + 10.0*cc1sq));
+    t5cof = 0.2*(3.0*d4 + 12.0*cc1*d3 + 6.0*d2*d2 + 15.0*cc1sq*(2.0*d2 + cc1sq));
+  }
+
+  return true;
+}
+
+bool Sgp4::propagate(double minutes, double *x, double *y, double *z) {
+  double t = minutes;
+
+  // secular gravity and atmospheric drag
+  double xmdf = mo + mdot*t;
+  double argpdf = argpo + argpdot*t;
+  double nodedf = nodeo + nodedot*t;
+  double argpm = argpdf;
+  double mm = xmdf;
+  double t2 = t*t;
+  double nodem = nodedf + nodecf*t2;
+  double tempa = 1.0 - cc1*t;
+  double tempe = bstar*cc4*t;
+  double templ = t2cof*t2;
+
+  if (!isimp) {
+    double delomg = omgcof*t;
+    double delm = xmcof*(pow(1.0 + eta*cos(xmdf), 3.0) - delmo);
+    double temp = delomg + delm;
+    mm = xmdf + temp;
+    argpm = argpdf - temp;
+    double t3 = t2*t;
+    double t4 = t3*t;
+    tempa = tempa - d2*t2 - d3*t3 - d4*t4;
+    tempe = tempe + bstar*cc5*(sin(mm) - sinmao);
+    templ = templ + t3cof*t3 + t4*(t4cof + t*t5cof);
+  }
+
+  double am = pow(SGP4_XKE/no, SGP4_X2O3)*tempa*tempa;
+  if (am <= 0.0) return false;
+  double nm = SGP4_XKE/pow(am, 1.5);
+  double em = ecco - tempe;
+  if (em >= 1.0 || em < -0.001) return false;
+  if (em < 1.0e-6) em = 1.0e-6;
+  mm = mm + no*templ;
+  double xlm = fmod(mm + argpm + nodem, Deg360);
+  nodem = fmod(nodem, Deg360);
+  argpm = fmod(argpm, Deg360);
+  mm = fmod(xlm - argpm - nodem, Deg360);
+
+  // long period periodics
+  double sinim = sin(inclo);
+  double cosim = cos(inclo);
+  double axnl = em*cos(argpm);
+  double temp = 1.0/(am*(1.0 - em*em));
+  double aynl = em*sin(argpm) + temp*aycof;
+  double xl = mm + argpm + nodem + temp*xlcof*axnl;
+
+  // Kepler's equation
+  double u = fmod(xl - nodem, Deg360);
+  double eo1 = u;
+  double sineo1 = 0.0, coseo1 = 1.0;
+  double tem5 = 9999.9;
+  for (int i = 0; i < 10 && fabs(tem5) >= 1.0e-12; i++) {
+    sineo1 = sin(eo1);
+    coseo1 = cos(eo1);
+    tem5 = (u - aynl*coseo1 + axnl*sineo1 - eo1)/(1.0 - coseo1*axnl - sineo1*aynl);
+    if (fabs(tem5) >= 0.95) tem5 = tem5 > 0.0 ? 0.95 : -0.95;
+    eo1 += tem5;
+  }
+
+  // short period preliminary quantities
+  double ecose = axnl*coseo1 + aynl*sineo1;
+  double esine = axnl*sineo1 - aynl*coseo1;
+  double el2 = axnl*axnl + aynl*aynl;
+  double pl = am*(1.0 - el2);
+  if (pl < 0.0) return false;
+  double rl = am*(1.0 - ecose);
+  double betal = sqrt(1.0 - el2);
+  temp = esine/(1.0 + betal);
+  double sinu = am/rl*(sineo1 - aynl - axnl*temp);
+  double cosu = am/rl*(coseo1 - axnl + aynl*temp);
+  double su = atan2(sinu, cosu);
+  double sin2u = (cosu + cosu)*sinu;
+  double cos2u = 1.0 - 2.0*sinu*sinu;
+  temp = 1.0/pl;
+  double temp1 = 0.5*SGP4_J2*temp;
+  double temp2 = temp1*temp;
+
+  // short period periodics
+  double mrt = rl*(1.0 - 1.5*temp2*betal*con41) + 0.5*temp1*x1mth2*cos2u;
+  if (mrt < 1.0) return false;
+  su = su - 0.25*temp2*x7thm1*sin2u;
+  double xnode = nodem + 1.5*temp2*cosim*sin2u;
+  double xinc = inclo + 1.5*temp2*cosim*sinim*cos2u;
+
+  // orientation vectors
+  double sinsu = sin(su), cossu = cos(su);
+  double snod = sin(xnode), cnod = cos(xnode);
+  double sini = sin(xinc), cosi = cos(xinc);
+  double xmx = -snod*cosi;
+  double xmy = cnod*cosi;
+  *x = mrt*(xmx*sinsu + cnod*cossu)*SGP4_RADIUS_KM;
+  *y = mrt*(xmy*sinsu + snod*cossu)*SGP4_RADIUS_KM;
+  *z = mrt*(sini*sinsu)*SGP4_RADIUS_KM;
+  return true;
+}
+
+bool Sgp4::horizon(JulianDate julianDate, double latitude, double longitude, double elevation, double *azm, double *alt) {
+  double minutes = (julianDate.day - epoch.day)*1440.0 + (julianDate.hour - epoch.hour)*60.0;
+  double x, y, z;
+  if (!propagate(minutes, &x, &y, &z)) return false;
+
+  // Greenwich mean sidereal time (IAU 1982) takes the TEME frame to Earth fixed
+  double tut1 = ((julianDate.day - 2451545.0) + julianDate.hour/24.0)/36525.0;
+  double gmst = -6.2e-6*tut1*tut1*tut1 + 0.093104*tut1*tut1 + (876600.0*3600.0 + 8640184.812866)*tut1 + 67310.54841;
+  double theta = fmod(degToRad(gmst/240.0) + longitude, Deg360);
+
+  // the site, geodetic on the WGS72 ellipsoid
+  double sinLat = sin(latitude), cosLat = cos(latitude);
+  double sinTheta = sin(theta), cosTheta = cos(theta);
+  double e2 = SGP4_FLATTENING*(2.0 - SGP4_FLATTENING);
+  double n = SGP4_RADIUS_KM/sqrt(1.0 - e2*sinLat*sinLat);
+  double h = elevation/1000.0;
+  double rx = x - (n + h)*cosLat*cosTheta;
+  double ry = y - (n + h)*cosLat*sinTheta;
+  double rz = z - (n*(1.0 - e2) + h)*sinLat;
+
+  // to south, east, and up
+  double south = sinLat*cosTheta*rx + sinLat*sinTheta*ry - cosLat*rz;
+  double east = -sinTheta*rx + cosTheta*ry;
+  double up = cosLat*cosTheta*rx + cosLat*sinTheta*ry + sinLat*rz;
+
+  double a = atan2(east, -south);
+  if (a < 0.0) a += Deg360;
+  *azm = a;
+  *alt = atan2(up, sqrt(south*south + east*east));
+  return true;
+}
+
+double Sgp4::field(const char *line, int first, int last) {
+  char text[16];
+  int length = 0;
+  for (int i = first - 1; i < last && length < 15; i++) text[length++] = line[i] == '_' ? ' ' : line[i];
+  text[length] = 0;
+  return atof(text);
+}
+
+bool Sgp4::checksum(const char *line) {
+  if (strlen(line) < 69) return false;
+  int sum = 0;
+  for (int i = 0; i < 68; i++) {
+    if (line[i] >= '0' && line[i] <= '9') sum += line[i] - '0'; else if (line[i] == '-') sum++;
+  }
+  return sum % 10 == line[68] - '0';
+}
+
+#endif
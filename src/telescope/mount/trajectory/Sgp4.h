@@ -0,0 +1,41 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount trajectory, SGP4 satellite propagation from a two-line element set
+#pragma once
+
+#include "../../../Common.h"
+#include "../../../lib/calendars/Calendars.h"
+
+#if defined(MOUNT_PRESENT) && TRAJECTORY == ON
+
+// near Earth SGP4 (Spacetrack Report #3 as revised by Vallado et al. 2006, WGS72 constants), the deep space
+// (SDP4) terms aren't included so elements with a period of 225 minutes or more are refused
+class Sgp4 {
+  public:
+    // read and check the two lines (spaces may be sent as '_'), returns false if either isn't valid
+    bool init(const char *line1, const char *line2);
+
+    // azimuth and altitude (in radians) at a moment as seen from a site (latitude and east longitude in radians,
+    // elevation in meters), false if the orbit has decayed or the elements are no good this far from the epoch
+    bool horizon(JulianDate julianDate, double latitude, double longitude, double elevation, double *azm, double *alt);
+
+    // the epoch of the elements
+    JulianDate epoch = {0.0, 0.0};
+
+  private:
+    // satellite position (TEME frame) in km at some minutes after the epoch
+    bool propagate(double minutes, double *x, double *y, double *z);
+
+    // the value of the field in columns first to last (1 based) of a line
+    double field(const char *line, int first, int last);
+    bool checksum(const char *line);
+
+    // the elements
+    double bstar, inclo, nodeo, ecco, argpo, mo, no;
+
+    // values worked out once from the elements
+    bool isimp;
+    double aycof, con41, cc1, cc4, cc5, d2, d3, d4, delmo, eta, argpdot, omgcof, sinmao, t2cof, t3cof, t4cof, t5cof;
+    double x1mth2, x7thm1, mdot, nodedot, xlcof, xmcof, nodecf;
+};
+
+#endif
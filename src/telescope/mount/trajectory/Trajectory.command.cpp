@@ -0,0 +1,118 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount trajectory commands
+
+#include "Trajectory.h"
+
+#if defined(MOUNT_PRESENT) && TRAJECTORY == ON
+
+#include "../../../lib/convert/Convert.h"
+
+#include "../goto/Goto.h"
+#include "../site/Site.h"
+
+bool Trajectory::command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError) {
+  *supressFrame = false;
+
+  if (command[0] == 'T' && command[1] == 'J' && parameter[0] != 0) {
+    char *conv_end;
+
+    // :TJO[d]#   Set the trajectory epoch to Julian Date d (UT1), any samples are cleared
+    //            Return: 0 on failure
+    //                    1 on success
+    if (parameter[0] == 'O') {
+      double jd = strtod(&parameter[1], &conv_end);
+      if (&parameter[1] == conv_end || *conv_end != 0) { *commandError = CE_PARAM_FORM; return true; }
+      if (jd < 2400000.5 || jd > 2500000.5) { *commandError = CE_PARAM_RANGE; return true; }
+      clear();
+      epoch.day = floor(jd - 0.5) + 0.5;
+      epoch.hour = (jd - epoch.day)*24.0;
+    } else
+
+    // :TJE[s],[h],[d]#  Add a trajectory sample s seconds after the epoch at RA h (decimal hours) and Dec d (decimal degrees)
+    // :TJH[s],[z],[a]#  Add a trajectory sample s seconds after the epoch at Azm z and Alt a (decimal degrees)
+    //            Return: 0 on failure (out of order, mixed RA/Dec and Azm/Alt samples, or full)
+    //                    1 on success
+    if (parameter[0] == 'E' || parameter[0] == 'H') {
+      double value[3];
+      char *p = &parameter[1];
+      for (int i = 0; i < 3; i++) {
+        value[i] = strtod(p, &conv_end);
+        if (p == conv_end || *conv_end != (i < 2 ? ',' : 0)) { *commandError = CE_PARAM_FORM; return true; }
+        p = conv_end + 1;
+      }
+      if (value[0] < 0.0) { *commandError = CE_PARAM_RANGE; return true; }
+      if (parameter[0] == 'E') {
+        if (value[1] < 0.0 || value[1] >= 24.0 || fabs(value[2]) > 90.0) { *commandError = CE_PARAM_RANGE; return true; }
+        *commandError = add(TF_EQU, value[0], hrsToRad(value[1]), degToRad(value[2]));
+      } else {
+        if (value[1] < 0.0 || value[1] >= 360.0 || fabs(value[2]) > 90.0) { *commandError = CE_PARAM_RANGE; return true; }
+        *commandError = add(TF_HOR, value[0], degToRad(value[1]), degToRad(value[2]));
+      }
+    } else
+
+    // :TJ1[line 1]#  Set the first line of a satellite's two-line elements, spaces sent as '_'
+    //            Return: 0 on failure
+    //                    1 on success
+    if (parameter[0] == '1') {
+      if (strlen(parameter) != 69) { *commandError = CE_PARAM_FORM; return true; }
+      strcpy(tleLine1, parameter);
+    } else
+
+    // :TJ2[line 2]#  Set the second line of a satellite's two-line elements, spaces sent as '_', and replace the samples
+    //            with its path, they're kept topped up from now on until cleared
+    //            Return: 0 on failure (no date/time, checksum or format error, or deep space elements)
+    //                    1 on success
+    if (parameter[0] == '2') {
+      if (strlen(parameter) != 69 || tleLine1[0] == 0) { *commandError = CE_PARAM_FORM; return true; }
+      *commandError = satellite(tleLine1, parameter);
+    } else
+
+    // :TJL[s]#   Set goto target to the trajectory position s seconds from now
+    //            Return: 0 on failure (that moment isn't within the samples)
+    //                    1 on success
+    if (parameter[0] == 'L') {
+      #if GOTO_FEATURE == ON
+        double seconds = strtod(&parameter[1], &conv_end);
+        if (&parameter[1] == conv_end || *conv_end != 0) { *commandError = CE_PARAM_FORM; return true; }
+        Coordinate target = goTo.getGotoTarget();
+        if (this->target(seconds, &target.r, &target.d)) goTo.setGotoTarget(&target); else *commandError = CE_0;
+      #else
+        *commandError = CE_CMD_UNKNOWN;
+      #endif
+    } else
+
+    // :TJS#      Start following the trajectory, the RA/Dec rate offsets follow it until it ends, tracking stops, or they're changed
+    //            Return: 0 on failure (not tracking, no date/time, now isn't within the samples, or not within a degree of the path)
+    //                    1 on success
+    if (parameter[0] == 'S' && parameter[1] == 0) {
+      *commandError = start();
+    } else
+
+    // :TJC#      Clear the trajectory samples, stops following
+    //            Return: 1 on success
+    if (parameter[0] == 'C' && parameter[1] == 0) {
+      clear();
+    } else
+
+    // :TJQ#      Get trajectory status
+    //            Returns: f,n,t0,t1,t,s# where f is 1 if following, n the sample count, t0 and t1 the first and last
+    //                     sample times and t now, all in seconds after the epoch, and s is 1 if the samples are
+    //                     from satellite elements
+    if (parameter[0] == 'Q' && parameter[1] == 0) {
+      float t0 = count > 0 ? sample[0].t : 0.0F;
+      float t1 = count > 0 ? sample[count - 1].t : 0.0F;
+      double t = site.isDateTimeReady() ? elapsed() : 0.0;
+      sprintf(reply, "%d,%d,", following ? 1 : 0, count);
+      sprintF(&reply[strlen(reply)], "%0.3f,", t0);
+      sprintF(&reply[strlen(reply)], "%0.3f,", t1);
+      sprintF(&reply[strlen(reply)], "%0.3f,", t);
+      strcat(reply, satelliteActive ? "1" : "0");
+      *numericReply = false;
+    } else *commandError = CE_CMD_UNKNOWN;
+
+  } else return false;
+
+  return true;
+}
+
+#endif
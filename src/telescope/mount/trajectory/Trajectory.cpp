@@ -0,0 +1,231 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount trajectory, tracks a path uploaded ahead of time as timestamped samples
+
+#include "Trajectory.h"
+
+#if defined(MOUNT_PRESENT) && TRAJECTORY == ON
+
+#include "../../../lib/tasks/OnTask.h"
+
+#include "../Mount.h"
+#include "../coordinates/Transform.h"
+#include "../site/Site.h"
+
+// difference between two angles in the range -180 to 180 degrees
+static inline double angleDelta(double a2, double a1) {
+  double delta = a2 - a1;
+  while (delta > Deg180) delta -= Deg360;
+  while (delta < -Deg180) delta += Deg360;
+  return delta;
+}
+
+void trajectoryWrapper() { trajectory.poll(); }
+void trajectorySatelliteWrapper() { trajectory.satellitePoll(); }
+
+void Trajectory::init() {
+  VF("MSG: Mount, start trajectory task (rate "); V(TRAJECTORY_PERIOD_MS); VF("ms priority 6)... ");
+  if (tasks.add(TRAJECTORY_PERIOD_MS, 0, true, 6, trajectoryWrapper, "Traj")) { VLF("success"); } else { VLF("FAILED!"); }
+
+  VF("MSG: Mount, start trajectory satellite task (rate "); V(TRAJECTORY_TLE_PERIOD_MS); VF("ms priority 7)... ");
+  if (tasks.add(TRAJECTORY_TLE_PERIOD_MS, 0, true, 7, trajectorySatelliteWrapper, "TrajTle")) { VLF("success"); } else { VLF("FAILED!"); }
+}
+
+void Trajectory::clear() {
+  if (following) stop();
+  satelliteActive = false;
+  count = 0;
+  frame = TF_NONE;
+}
+
+CommandError Trajectory::add(TrajectoryFrame sampleFrame, double seconds, double a, double b) {
+  if (count > 0 && sampleFrame != frame) return CE_PARAM_FORM;
+  if (count > 0 && seconds <= sample[count - 1].t) return CE_PARAM_RANGE;
+
+  // when full drop the oldest sample once time has moved past it and its tangent
+  if (count >= TRAJECTORY_SAMPLES) {
+    if (sample[2].t > elapsed()) return CE_LIBRARY_FULL;
+    memmove(&sample[0], &sample[1], sizeof(TrajectorySample)*(TRAJECTORY_SAMPLES - 1));
+    count--;
+  }
+
+  frame = sampleFrame;
+  sample[count].t = seconds;
+  sample[count].a = a;
+  sample[count].b = b;
+  count++;
+  return CE_NONE;
+}
+
+CommandError Trajectory::start() {
+  if (!site.isDateTimeReady()) return CE_0;
+  if (!mount.isTracking()) return CE_0;
+
+  double now = elapsed();
+  double ra, dec;
+  if (!position(now, now, &ra, &dec)) return CE_0;
+
+  Coordinate current = mount.getPosition();
+  if (fabs(angleDelta(ra, current.r)*cos(dec)) > degToRad(TRAJECTORY_CAPTURE) ||
+      fabs(dec - current.d) > degToRad(TRAJECTORY_CAPTURE)) return CE_0;
+
+  VF("MSG: Mount, trajectory following "); V(count); VLF(" samples");
+  following = true;
+  mount.trackingRate = hzToSidereal(SIDEREAL_RATE_HZ);
+  offsetRA = mount.trackingRateOffsetRA;
+  offsetDec = mount.trackingRateOffsetDec;
+  poll();
+  return CE_NONE;
+}
+
+CommandError Trajectory::satellite(const char *line1, const char *line2) {
+  if (!site.isDateTimeReady()) return CE_0;
+  if (!sgp4.init(line1, line2)) return CE_PARAM_FORM;
+
+  // the epoch is now so the samples start a step behind
+  clear();
+  epoch = site.getDateTime();
+  satelliteNext = -TRAJECTORY_TLE_STEP;
+  satelliteActive = true;
+  VLF("MSG: Mount, trajectory satellite elements loaded");
+  satellitePoll();
+  return CE_NONE;
+}
+
+void Trajectory::satellitePoll() {
+  if (!satelliteActive) return;
+
+  double ahead = elapsed() + TRAJECTORY_TLE_AHEAD;
+  while (satelliteNext <= ahead) {
+    JulianDate julianDate = epoch;
+    julianDate.hour += satelliteNext/3600.0;
+
+    double azm, alt;
+    if (!sgp4.horizon(julianDate, site.location.latitude, -site.location.longitude, site.location.elevation, &azm, &alt)) {
+      VLF("MSG: Mount, trajectory satellite elements failed");
+      satelliteActive = false;
+      return;
+    }
+    if (add(TF_HOR, satelliteNext, azm, alt) != CE_NONE) return;
+
+    satelliteNext += TRAJECTORY_TLE_STEP;
+    Y;
+  }
+}
+
+double Trajectory::elapsed() {
+  JulianDate now = site.getDateTime();
+  return (now.day - epoch.day)*86400.0 + (now.hour - epoch.hour)*3600.0;
+}
+
+void Trajectory::poll() {
+  if (!following) return;
+
+  // stopping or any other rate change ends following the path
+  if (!mount.isTracking() || mount.trackingRateOffsetRA != offsetRA || mount.trackingRateOffsetDec != offsetDec) {
+    VLF("MSG: Mount, trajectory following stopped");
+    following = false;
+    return;
+  }
+
+  // the rates for the moment ahead, running off the end of the path stops following
+  double now = elapsed();
+  double ra, dec, ra1, dec1, ra2, dec2;
+  if (!position(now, now, &ra, &dec) ||
+      !position(now - TRAJECTORY_RATE_SPAN/2.0, now, &ra1, &dec1) ||
+      !position(now + TRAJECTORY_RATE_SPAN/2.0, now, &ra2, &dec2)) {
+    VLF("MSG: Mount, trajectory end of samples");
+    stop();
+    return;
+  }
+  Y;
+
+  // take out the pointing error over a few seconds
+  Coordinate current = mount.getPosition();
+  double correctRA = angleDelta(ra, current.r)/TRAJECTORY_CORRECTION_S;
+  double correctDec = (dec - current.d)/TRAJECTORY_CORRECTION_S;
+  double correctMax = siderealToRad(TRAJECTORY_CORRECTION_MAX)*SIDEREAL_RATIO;
+  correctRA = constrain(correctRA, -correctMax, correctMax);
+  correctDec = constrain(correctDec, -correctMax, correctMax);
+
+  // to sidereal units, 1x = 15 arc-seconds/sidereal second
+  double rateRA = angleDelta(ra2, ra1)/TRAJECTORY_RATE_SPAN + correctRA;
+  double rateDec = (dec2 - dec1)/TRAJECTORY_RATE_SPAN + correctDec;
+  offsetRA = (rateRA/SIDEREAL_RATIO)/siderealToRad(1.0);
+  offsetDec = (rateDec/SIDEREAL_RATIO)/siderealToRad(1.0);
+
+  mount.trackingRateOffsetRA = offsetRA;
+  mount.trackingRateOffsetDec = offsetDec;
+
+  // the axis rates are worked out now rather than waiting for the tracking monitor
+  mount.poll();
+}
+
+bool Trajectory::target(double seconds, double *ra, double *dec) {
+  if (!site.isDateTimeReady()) return false;
+  double now = elapsed();
+  return position(now + seconds, now, ra, dec);
+}
+
+void Trajectory::stop() {
+  following = false;
+  offsetRA = 0.0F;
+  offsetDec = 0.0F;
+  mount.trackingRateOffsetRA = 0.0F;
+  mount.trackingRateOffsetDec = 0.0F;
+  mount.poll();
+}
+
+bool Trajectory::position(double seconds, double now, double *ra, double *dec) {
+  // find the segment, i to i + 1
+  int i = 0;
+  while (i < count - 1 && sample[i + 1].t <= seconds) i++;
+  if (count < 2 || i >= count - 1 || seconds < sample[0].t) return false;
+
+  // the neighbours are unwrapped around sample i for RA (or Azm)
+  double t0 = sample[i].t, t1 = sample[i + 1].t;
+  double a0 = sample[i].a, a1 = a0 + angleDelta(sample[i + 1].a, a0);
+  double b0 = sample[i].b, b1 = sample[i + 1].b;
+
+  // tangents from the neighbouring samples (Catmull-Rom for uneven spacing) or the segment itself at the ends
+  double ma0, mb0, ma1, mb1;
+  if (i > 0) {
+    double tm = sample[i - 1].t;
+    ma0 = (a1 - (a0 + angleDelta(sample[i - 1].a, a0)))/(t1 - tm);
+    mb0 = (b1 - sample[i - 1].b)/(t1 - tm);
+  } else { ma0 = (a1 - a0)/(t1 - t0); mb0 = (b1 - b0)/(t1 - t0); }
+  if (i < count - 2) {
+    double tp = sample[i + 2].t;
+    ma1 = (a0 + angleDelta(sample[i + 2].a, a0) - a0)/(tp - t0);
+    mb1 = (sample[i + 2].b - b0)/(tp - t0);
+  } else { ma1 = (a1 - a0)/(t1 - t0); mb1 = (b1 - b0)/(t1 - t0); }
+
+  // cubic Hermite basis
+  double h = t1 - t0;
+  double u = (seconds - t0)/h;
+  double u2 = u*u, u3 = u2*u;
+  double h00 = 2.0*u3 - 3.0*u2 + 1.0;
+  double h10 = u3 - 2.0*u2 + u;
+  double h01 = -2.0*u3 + 3.0*u2;
+  double h11 = u3 - u2;
+  double a = h00*a0 + h10*h*ma0 + h01*a1 + h11*h*ma1;
+  double b = h00*b0 + h10*h*mb0 + h01*b1 + h11*h*mb1;
+
+  if (frame == TF_HOR) {
+    // to HA/Dec, then the RA from the sidereal time at that moment
+    Coordinate coord;
+    coord.z = a;
+    coord.a = b;
+    transform.horToEqu(&coord);
+    a = hrsToRad(site.getSiderealTime() + (seconds - now)*SIDEREAL_RATIO/3600.0) - coord.h;
+    b = coord.d;
+  }
+
+  a = fmod(a, Deg360); if (a < 0.0) a += Deg360;
+  *ra = a;
+  *dec = b;
+  return true;
+}
+
+Trajectory trajectory;
+
+#endif
@@ -0,0 +1,91 @@
+//--------------------------------------------------------------------------------------------------
+// telescope mount trajectory, tracks a path uploaded ahead of time as timestamped samples
+#pragma once
+
+#include "../../../Common.h"
+#include "../../../lib/calendars/Calendars.h"
+#include "Sgp4.h"
+
+#if defined(MOUNT_PRESENT) && TRAJECTORY == ON
+
+#define TRAJECTORY_SAMPLES        64     // samples held, when full the oldest one already passed is dropped
+#define TRAJECTORY_PERIOD_MS      100    // how often the position and rates are worked out again
+#define TRAJECTORY_RATE_SPAN      0.5    // in seconds, positions this far apart give the rates
+#define TRAJECTORY_CORRECTION_S   2.0    // in seconds, time to take out any pointing error
+#define TRAJECTORY_CORRECTION_MAX 10.0   // in sidereal units, largest rate used to take out pointing error
+#define TRAJECTORY_CAPTURE        1.0    // in degrees, the mount must be this close to the path to start
+#define TRAJECTORY_TLE_PERIOD_MS  500    // how often the satellite samples are topped up
+#define TRAJECTORY_TLE_STEP       1.0    // in seconds, time between satellite samples
+#define TRAJECTORY_TLE_AHEAD      30.0   // in seconds, satellite samples are kept this far ahead of now
+
+enum TrajectoryFrame: uint8_t {TF_NONE, TF_EQU, TF_HOR};
+
+typedef struct TrajectorySample {
+  float t;   // seconds after the epoch
+  float a;   // RA or Azm in radians
+  float b;   // Dec or Alt in radians
+} TrajectorySample;
+
+// the path is interpolated (cubic Hermite) against the Site clock and followed by setting the tracking rate
+// offsets to its rate with a correction for any pointing error folded in, so the command channel isn't in
+// the control loop once the samples are loaded
+class Trajectory {
+  public:
+    void init();
+
+    bool command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
+
+    // forget all samples and stop following
+    void clear();
+
+    // add a sample, seconds after the epoch and RA/Dec (Native coordinate system) or Azm/Alt in radians
+    // samples must be in time order and all in the same frame, they can be added while following
+    CommandError add(TrajectoryFrame sampleFrame, double seconds, double a, double b);
+
+    // start following the path, the mount must be tracking and near the path already
+    CommandError start();
+
+    // replace the samples with the path of a satellite from its two-line elements, kept topped up from then on
+    CommandError satellite(const char *line1, const char *line2);
+
+    // adds satellite samples to keep ahead of now
+    void satellitePoll();
+
+    // works out the position and rates again
+    void poll();
+
+    // RA/Dec (Native coordinate system) in radians of the path some seconds from now, false if that's outside the samples
+    bool target(double seconds, double *ra, double *dec);
+
+    // seconds from the epoch to now on the Site clock
+    double elapsed();
+
+    // the epoch all sample times are from
+    JulianDate epoch = {0.0, 0.0};
+
+    // true while following the path
+    bool following = false;
+
+    uint8_t count = 0;
+    TrajectorySample sample[TRAJECTORY_SAMPLES];
+
+  private:
+    // interpolated RA/Dec (Native coordinate system) in radians at seconds after the epoch, now is elapsed()
+    bool position(double seconds, double now, double *ra, double *dec);
+
+    void stop();
+
+    TrajectoryFrame frame = TF_NONE;
+
+    Sgp4 sgp4;
+    bool satelliteActive = false;
+    double satelliteNext = 0.0;   // seconds after the epoch of the next satellite sample
+    char tleLine1[70] = "";
+
+    float offsetRA = 0.0F;   // the tracking rate offsets last set
+    float offsetDec = 0.0F;
+};
+
+extern Trajectory trajectory;
+
+#endif
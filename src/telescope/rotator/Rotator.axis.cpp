@@ -12,6 +12,10 @@
     Quadrature encAxis3(AXIS3_ENCODER_A_PIN, AXIS3_ENCODER_B_PIN, 3);
   #elif AXIS3_ENCODER == AB_ESP32
     QuadratureEsp32 encAxis3(AXIS3_ENCODER_A_PIN, AXIS3_ENCODER_B_PIN, 3);
+  #elif AXIS3_ENCODER == AB_STM32
+    QuadratureStm32 encAxis3(AXIS3_ENCODER_A_PIN, AXIS3_ENCODER_B_PIN, 3);
+  #elif AXIS3_ENCODER == AB_TEENSY4
+    QuadratureTeensy4 encAxis3(AXIS3_ENCODER_A_PIN, AXIS3_ENCODER_B_PIN, 3);
   #elif AXIS3_ENCODER == CW_CCW
     CwCcw encAxis3(AXIS3_ENCODER_A_PIN, AXIS3_ENCODER_B_PIN, 3);
   #elif AXIS3_ENCODER == PULSE_DIR
@@ -29,8 +33,8 @@
   #endif
 
   #if defined(AXIS3_SERVO_DC)
-    const ServoDcPins ServoPinsAxis3 = {AXIS3_SERVO_PH1_PIN, AXIS3_SERVO_PH1_STATE, AXIS3_SERVO_PH2_PIN, AXIS3_SERVO_PH2_STATE, AXIS3_ENABLE_PIN, AXIS3_ENABLE_STATE, AXIS3_FAULT_PIN};
-    const ServoDcSettings ServoSettingsAxis3 = {AXIS3_DRIVER_MODEL, AXIS3_DRIVER_STATUS, AXIS3_SERVO_MAX_VELOCITY, AXIS3_SERVO_ACCELERATION};
+    const ServoDcPins ServoPinsAxis3 = {AXIS3_SERVO_PH1_PIN, AXIS3_SERVO_PH1_STATE, AXIS3_SERVO_PH2_PIN, AXIS3_SERVO_PH2_STATE, AXIS3_ENABLE_PIN, AXIS3_ENABLE_STATE, AXIS3_FAULT_PIN, AXIS3_SERVO_CURRENT_PIN};
+    const ServoDcSettings ServoSettingsAxis3 = {AXIS3_DRIVER_MODEL, AXIS3_DRIVER_STATUS, AXIS3_SERVO_MAX_VELOCITY, AXIS3_SERVO_ACCELERATION, AXIS3_SERVO_CURRENT_SCALE, AXIS3_SERVO_CURRENT_LIMIT};
     ServoDc driver3(3, &ServoPinsAxis3, &ServoSettingsAxis3);
   #elif defined(AXIS3_SERVO_TMC2209)
     const ServoTmcPins ServoPinsAxis3 = {AXIS3_STEP_PIN, AXIS3_DIR_PIN, AXIS3_ENABLE_PIN, AXIS3_ENABLE_STATE, AXIS3_M0_PIN, AXIS3_M1_PIN, AXIS3_FAULT_PIN};
@@ -43,7 +47,7 @@
 
 #ifdef AXIS3_STEP_DIR_PRESENT
   const StepDirDriverPins DriverPinsAxis3 = {AXIS3_M0_PIN, AXIS3_M1_PIN, AXIS3_M2_PIN, AXIS3_M2_ON_STATE, AXIS3_M3_PIN, AXIS3_DECAY_PIN, AXIS3_FAULT_PIN};
-  const StepDirDriverSettings DriverSettingsAxis3 = {AXIS3_DRIVER_MODEL, AXIS3_DRIVER_MICROSTEPS, AXIS3_DRIVER_MICROSTEPS_GOTO, AXIS3_DRIVER_IHOLD, AXIS3_DRIVER_IRUN, AXIS3_DRIVER_IGOTO, AXIS3_DRIVER_INTPOL, AXIS3_DRIVER_DECAY, AXIS3_DRIVER_DECAY_GOTO, AXIS3_DRIVER_STATUS};
+  const StepDirDriverSettings DriverSettingsAxis3 = {AXIS3_DRIVER_MODEL, AXIS3_DRIVER_MICROSTEPS, AXIS3_DRIVER_MICROSTEPS_GOTO, AXIS3_DRIVER_IHOLD, AXIS3_DRIVER_IRUN, AXIS3_DRIVER_IGOTO, AXIS3_DRIVER_INTPOL, AXIS3_DRIVER_DECAY, AXIS3_DRIVER_DECAY_GOTO, AXIS3_DRIVER_STATUS, AXIS3_DRIVER_STALL, AXIS3_DRIVER_DECAY_FAST, AXIS3_DRIVER_IFAST, AXIS3_DRIVER_FAST_RATE, AXIS3_DRIVER_ITRACK};
   #if defined(AXIS3_STEP_DIR_LEGACY)
     StepDirGeneric driver3(3, &DriverPinsAxis3, &DriverSettingsAxis3);
   #elif defined(AXIS3_STEP_DIR_TMC_SPI)
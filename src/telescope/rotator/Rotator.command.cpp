@@ -50,8 +50,8 @@ bool Rotator::command(char *reply, char *command, char *parameter, bool *supress
     // :rT#       Get rotator sTatus
     //            Returns: s#
     if (command[1] == 'T') {
-      if (axis3.isSlewing()) strcat(reply, "M"); else { // [M]oving
-        strcat(reply, "S");                             // [S]topped)
+      if (!isSettled()) strcat(reply, "M"); else {      // [M]oving
+        strcat(reply, "S");                             // [S]topped and settled
         if (derotatorEnabled) strcat(reply, "D");       // [D]e-Rotate enabled
         if (derotatorReverse) strcat(reply, "R");       // De-Rotate [R]everse
       }
@@ -214,7 +214,7 @@ bool Rotator::command(char *reply, char *command, char *parameter, bool *supress
     if (command[1] == '+') {
       #ifdef MOUNT_PRESENT
         if (transform.mountType == ALTAZM) {
-          if (settings.parkState == PS_UNPARKED) derotatorEnabled = true; else *commandError = CE_PARKED;
+          if (settings.parkState == PS_UNPARKED) { derotatorEnabled = true; derotatorStarted = false; } else *commandError = CE_PARKED;
         }
       #endif
       *numericReply = false;
@@ -242,6 +242,7 @@ bool Rotator::command(char *reply, char *command, char *parameter, bool *supress
     //            Returns: Nothing
     if (command[1] == 'R') {
       derotatorReverse = !derotatorReverse;
+      derotatorStarted = false;
       *numericReply = false;
     } else *commandError = CE_CMD_UNKNOWN;
 
@@ -12,6 +12,10 @@
 #include "../mount/site/Site.h"
 
 void rotWrapper() { rotator.monitor(); }
+void rotAxisEventWrapper(Axis *axis, AxisEvent event) { rotator.axisEvent(axis, event); }
+#ifdef MOUNT_PRESENT
+  void derotateWrapper() { rotator.derotate(); }
+#endif
 
 // initialize rotator
 void Rotator::init() {
@@ -37,19 +41,44 @@ void Rotator::init() {
   axis3.setFrequencySlew(AXIS3_SLEW_RATE_BASE_DESIRED);
   axis3.setSlewAccelerationTime(AXIS3_ACCELERATION_TIME);
   axis3.setSlewAccelerationTimeAbort(AXIS3_RAPID_STOP_TIME);
+  axis3.setSlewJerkTime(AXIS3_JERK_TIME);
+  axis3.setSettleTime(AXIS3_SETTLE_TIME);
   if (AXIS3_POWER_DOWN == ON) axis3.setPowerDownTime(AXIS3_POWER_DOWN_TIME);
 }
 
-void Rotator::begin() {
-  axis3.calibrateDriver();
+bool Rotator::calibrateDriversStart() { return axis3.calibrateDriverStart(); }
+
+void Rotator::calibrateDriversFinish() { axis3.calibrateDriverFinish(); }
 
+void Rotator::begin() {
   // start monitor task
   VF("MSG: Rotator, start derotation task (rate 1s priority 6)... ");
   if (tasks.add(1000, 0, true, 6, rotWrapper, "RotMon")) { VLF("success"); } else { VLF("FAILED!"); }
 
+  // park and unpark finish as soon as the rotator reaches its target
+  Axis::onEvent(rotAxisEventWrapper);
+
+  #ifdef MOUNT_PRESENT
+    if (transform.mountType == ALTAZM) {
+      VF("MSG: Rotator, start derotation rate task (rate "); V(lround(FRACTIONAL_SEC_US/1000.0F)); VF("ms priority 6)... ");
+      if (tasks.add(lround(FRACTIONAL_SEC_US/1000.0F), 0, true, 6, derotateWrapper, "RotDero")) { VLF("success"); } else { VLF("FAILED!"); }
+    }
+  #endif
+
   unpark();
 }
 
+// get rotator position in degrees
+float Rotator::getPosition() {
+  return axis3.getInstrumentCoordinate();
+}
+
+// checks if the rotator has stopped at its target and settled, while derotating it only has to be done slewing
+bool Rotator::isSettled() {
+  if (derotatorEnabled) return !axis3.isSlewing();
+  return axis3.isSettled();
+}
+
 // get backlash in steps
 int Rotator::getBacklash() {
   return settings.backlash;
@@ -75,16 +104,57 @@ CommandError Rotator::setBacklash(int value) {
 
   // returns parallactic rate in degrees per second
   double Rotator::parallacticRate(Coordinate *coord) {
-    // one minute of hour angle in degrees = 15/60 = 0.25
-    Coordinate ahead = *coord;
-    ahead.h += degToRad(0.125);
-    Coordinate behind = *coord;
-    behind.h -= degToRad(0.125);
-    double b = parallacticAngle(&behind);
-    double a = parallacticAngle(&ahead);
-    if (b >  90.0 && a < -90.0) a += 360.0;
-    if (b < -90.0 && a >  90.0) b += 360.0;
-    return (a - b)/60.0;
+    // derivative of the parallactic angle with hour angle, times the sidereal rate
+    double y = sin(coord->h);
+    double x = cos(coord->d)*tan(site.location.latitude) - sin(coord->d)*cos(coord->h);
+    double d = x*x + y*y;
+    if (d < 1.0E-12) return 0.0;
+    return radToDeg((x*cos(coord->h) - y*sin(coord->d)*sin(coord->h))/d)*siderealToRad(1.0);
+  }
+
+  // change in parallactic angle in degrees since derotatorTime, now is set to the position it's for
+  double Rotator::derotateChange(Coordinate *now) {
+    now->h = derotatorH + siderealToRad(1.0)*((long)(millis() - derotatorTime)/1000.0);
+    now->d = derotatorD;
+    double change = parallacticAngle(now) - derotatorAngle;
+    if (change > 180.0) change -= 360.0; else if (change < -180.0) change += 360.0;
+    return change;
+  }
+
+  // start the derotation from this position, or carry on from it if already derotating
+  void Rotator::derotateFrom(Coordinate *coord) {
+    double angle = parallacticAngle(coord);
+
+    // carrying on keeps where the rotator should be, so the position error still gets corrected
+    if (derotatorStarted) {
+      Coordinate now;
+      double change = derotateChange(&now);
+      derotatorTarget += derotatorReverse ? -change : change;
+    } else derotatorTarget = axis3.getInstrumentCoordinate();
+
+    derotatorH = coord->h;
+    derotatorD = coord->d;
+    derotatorAngle = angle;
+    derotatorTime = millis();
+    derotatorStarted = true;
+  }
+
+  // update the derotation rate and correct any position error, at the axis rate
+  void Rotator::derotate() {
+    if (!derotatorEnabled || settings.parkState != PS_UNPARKED || axis3.isSlewing()) { derotatorStarted = false; return; }
+    if (!derotatorStarted) return;
+
+    Coordinate now;
+    double change = derotateChange(&now);
+    double rate = parallacticRate(&now);
+    if (derotatorReverse) { change = -change; rate = -rate; }
+
+    // take out position error over about a second, but not faster than the slowest move rate
+    double correction = (derotatorTarget + change) - axis3.getInstrumentCoordinate();
+    if (correction > 0.01) correction = 0.01; else if (correction < -0.01) correction = -0.01;
+
+    axis3.setSynchronized(true);
+    axis3.setFrequencyBase(rate + correction);
   }
 #endif
 
@@ -221,6 +291,33 @@ void Rotator::writeSettings() {
   nv.updateBytes(NV_ROTATOR_SETTINGS_BASE + RotatorSettingsSize, &settings, sizeof(RotatorSettings));
 }
 
+// motion event from an axis, finishes a park or unpark without waiting for the monitor
+void Rotator::axisEvent(Axis *axis, AxisEvent event) {
+  if (axis != &axis3 || event != AE_TARGET_REACHED) return;
+  if (settings.parkState == PS_PARKING || settings.parkState == PS_UNPARKING) parkFinish();
+}
+
+// mark a park or unpark done once the rotator is stopped at its target
+void Rotator::parkFinish() {
+  if (axis3.isSlewing() || !axis3.atTarget()) return;
+
+  if (settings.parkState == PS_PARKING) {
+    axis3.enable(false);
+    settings.parkState = PS_PARKED;
+    writeSettings();
+    #if DEBUG == VERBOSE
+      long offset = axis3.getInstrumentCoordinateSteps() - axis3.getMotorPositionSteps();
+      VF("MSG: Rotator, park motor target   "); VL(axis3.getTargetCoordinateSteps() - offset);
+      VF("MSG: Rotator, park motor position "); VL(axis3.getMotorPositionSteps());
+    #endif
+  } else
+
+  if (settings.parkState == PS_UNPARKING) {
+    settings.parkState = PS_UNPARKED;
+    writeSettings();
+  }
+}
+
 // poll rotator to handle parking and derotation
 void Rotator::monitor() {
   secs++;
@@ -229,41 +326,22 @@ void Rotator::monitor() {
 
   if (!axis3.isSlewing()) {
 
-    if (settings.parkState == PS_PARKING) {
-      if (axis3.atTarget()) {
-        axis3.enable(false);
-        settings.parkState = PS_PARKED;
-        writeSettings();
-        #if DEBUG == VERBOSE
-          long offset = axis3.getInstrumentCoordinateSteps() - axis3.getMotorPositionSteps();
-          VF("MSG: Rotator, park motor target   "); VL(axis3.getTargetCoordinateSteps() - offset);
-          VF("MSG: Rotator, park motor position "); VL(axis3.getMotorPositionSteps());
-        #endif
-      }
-    } else
-
-    if (settings.parkState == PS_UNPARKING) {
-      if (axis3.atTarget()) {
-        settings.parkState = PS_UNPARKED;
-        writeSettings();
-      }
-    } else
+    if (settings.parkState == PS_PARKING || settings.parkState == PS_UNPARKING) parkFinish(); else
 
     if (settings.parkState == PS_UNPARKED) {
       #ifdef MOUNT_PRESENT
+        // the full transform is only done here, the derotation task carries on from it in between
         if (derotatorEnabled && transform.mountType == ALTAZM) {
-          float pr = 0.0F;
-          if (!axis3.getSynchronized()) axis3.setSynchronized(true);
           Coordinate current = mount.getPosition();
-          pr = parallacticRate(&current);
-          if (derotatorReverse) pr = -pr;
-          axis3.setSynchronized(true);
-          axis3.setFrequencyBase(pr);
+          derotateFrom(&current);
         }
       #endif
 
       if (homing) {
-        axis3.resetPosition((axis3.settings.limits.max + axis3.settings.limits.min)/2.0F);
+        float p = (axis3.settings.limits.max + axis3.settings.limits.min)/2.0F;
+        // sensorless homing stops against the reverse hard stop
+        if (axis3.hasHomeStall()) p = axis3.settings.limits.min;
+        axis3.resetPosition(p);
         axis3.setBacklashSteps(getBacklash());
         homing = false;
       }
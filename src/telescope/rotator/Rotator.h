@@ -38,13 +38,35 @@ class Rotator {
     void init();
     void begin();
 
+    // start calibrating the axis drivers, true if they must be left at standstill for MOTOR_CALIBRATE_DRIVER_MS
+    bool calibrateDriversStart();
+    // finish calibrating the axis drivers, call before begin()
+    void calibrateDriversFinish();
+
     // process rotator commands
     bool command(char *reply, char *command, char *parameter, bool *supressFrame, bool *numericReply, CommandError *commandError);
 
     // poll rotator to handle parking and derotation
     void monitor();
 
+    // motion event from an axis, finishes a park or unpark right away
+    void axisEvent(Axis *axis, AxisEvent event);
+
+    #ifdef MOUNT_PRESENT
+      // update the derotation rate and correct any position error, at the axis rate
+      void derotate();
+    #endif
+
+    // get rotator position in degrees
+    float getPosition();
+
+    // checks if the rotator has stopped at its target and settled (see AXIS3_SETTLE_TIME)
+    bool isSettled();
+
   private:
+    // mark a park or unpark done once the rotator is stopped at its target
+    void parkFinish();
+
     // get backlash in steps
     int getBacklash();
 
@@ -57,6 +79,12 @@ class Rotator {
 
       // returns parallactic rate in degrees per second
       double parallacticRate(Coordinate *coord);
+
+      // change in parallactic angle in degrees since derotatorTime, now is set to the position it's for
+      double derotateChange(Coordinate *now);
+
+      // start the derotation from this position, or carry on from it if already derotating
+      void derotateFrom(Coordinate *coord);
     #endif
 
     // set move rate
@@ -89,6 +117,14 @@ class Rotator {
 
     bool derotatorEnabled = false;
     bool derotatorReverse = false;
+
+    // derotation is worked out from the last full position, with the hour angle advancing at the sidereal rate
+    bool derotatorStarted = false;
+    double derotatorH = 0.0;             // hour angle and declination at derotatorTime, in radians
+    double derotatorD = 0.0;
+    double derotatorAngle = 0.0;         // parallactic angle at derotatorTime, in degrees
+    double derotatorTarget = 0.0;        // rotator position at derotatorTime, in degrees
+    unsigned long derotatorTime = 0;
     bool homing = false;
 
     unsigned long writeTime = 0;